@@ -24,6 +24,16 @@ struct PotentialCollision
 	const Collider* colliders[2];
 };
 
+// Layer bits present at or below a node, and the layers those colliders are allowed to collide with
+// For internal nodes these are unions over the subtree, so a failed check can prune the whole subtree
+struct CollisionFilter
+{
+	uint32 m_layers = 0;
+	uint32 m_mask = 0;
+
+	bool CanCollideWith(const CollisionFilter& other) const { return ((m_layers & other.m_mask) != 0) && ((other.m_layers & m_mask) != 0); }
+};
+
 ///--------------------------------------------------------------------------------------------------------------------------------------------------
 /// GLOBALS AND STATICS
 ///--------------------------------------------------------------------------------------------------------------------------------------------------
@@ -37,11 +47,14 @@ template <class BoundingVolumeClass>
 class BVHNode
 {
 	template<class BoundingVolumeClass> friend class CollisionScene;
+	friend class QBVH;
 
 public:
 	//-----Public Methods-----
 
 	int		GetPotentialNodeCollisions(PotentialCollision* out_collisions, int limit) const; // Intended to be called on the root node to get total collisions
+	int		GetRaycastCandidates(const Vector3& start, const Vector3& direction, float maxDistance, const Collider** out_colliders, int limit) const;
+	int		GetOverlapCandidates(const BoundingVolumeClass& volume, const Collider** out_colliders, int limit) const;
 	bool	IsLeaf() const;
 	bool	IsRoot() const { return m_parent == nullptr; }
 
@@ -58,10 +71,14 @@ private:
 	// Recursively updates the tree to add/remove the given node
 	BVHNode<BoundingVolumeClass>*	Insert(BVHNode<BoundingVolumeClass>* node); // Returns the root of the tree, in case insert moves it around
 	BVHNode<BoundingVolumeClass>*	RemoveSelf();
-	void	RecalculateBoundingVolume();
+	void	RecalculateBoundingVolume(); // Refits this node and all ancestors
+	void	RefitSelf(); // Refits only this node from its children
+	bool	TryRotate(); // Swaps a child with a grandchild if it shrinks the tree, returns true if a swap was made
+	float	GetSubtreeCost() const; // Sum of the surface areas of all internal nodes at or below this level
+	int		GetDepth() const;
 	int		GetPotentialCollisionsBetween(const BVHNode<BoundingVolumeClass>* other, PotentialCollision* out_collisions, int limit) const;
-	int		GetPotentialCollisionsBetween(const HalfSpaceCollider* halfSpace, PotentialCollision* out_collisions, int limit) const;
-	int		GetPotentialCollisionsBetween(const PlaneCollider* planeCol, PotentialCollision* out_collisions, int limit) const;
+	int		GetPotentialCollisionsBetween(const HalfSpaceCollider* halfSpace, const CollisionFilter& halfSpaceFilter, PotentialCollision* out_collisions, int limit) const;
+	int		GetPotentialCollisionsBetween(const PlaneCollider* planeCol, const CollisionFilter& planeFilter, PotentialCollision* out_collisions, int limit) const;
 
 
 private:
@@ -70,16 +87,18 @@ private:
 	BVHNode*				m_parent = nullptr;
 	BVHNode*				m_children[2];
 	BoundingVolumeClass		m_boundingVolumeWs; // Encompasses all entities at or below this level
+	CollisionFilter			m_filter; // Encompasses all layers at or below this level
 	Entity*					m_entity = nullptr; // Only set on leaf nodes
+	bool					m_needsRefit = false; // Set while the node is queued for a bottom-up refit
 
 };
 
 
 //-------------------------------------------------------------------------------------------------
 template <class BoundingVolumeClass>
-int BVHNode<BoundingVolumeClass>::GetPotentialCollisionsBetween(const PlaneCollider* planeCol, PotentialCollision* out_collisions, int limit) const
+int BVHNode<BoundingVolumeClass>::GetPotentialCollisionsBetween(const PlaneCollider* planeCol, const CollisionFilter& planeFilter, PotentialCollision* out_collisions, int limit) const
 {
-	if (limit == 0 || !m_boundingVolumeWs.Overlaps(planeCol))
+	if (limit == 0 || !m_filter.CanCollideWith(planeFilter) || !m_boundingVolumeWs.Overlaps(planeCol))
 		return 0;
 
 	if (IsLeaf())
@@ -90,12 +109,12 @@ int BVHNode<BoundingVolumeClass>::GetPotentialCollisionsBetween(const PlaneColli
 	}
 
 	// Recurse on our first child
-	int numAdded = m_children[0]->GetPotentialCollisionsBetween(planeCol, out_collisions, limit);
+	int numAdded = m_children[0]->GetPotentialCollisionsBetween(planeCol, planeFilter, out_collisions, limit);
 
 	if (limit > numAdded)
 	{
 		// Recurse on our second child
-		numAdded += m_children[1]->GetPotentialCollisionsBetween(planeCol, out_collisions + numAdded, limit - numAdded);
+		numAdded += m_children[1]->GetPotentialCollisionsBetween(planeCol, planeFilter, out_collisions + numAdded, limit - numAdded);
 	}
 
 	return numAdded;
@@ -104,9 +123,9 @@ int BVHNode<BoundingVolumeClass>::GetPotentialCollisionsBetween(const PlaneColli
 
 //-------------------------------------------------------------------------------------------------
 template <class BoundingVolumeClass>
-int BVHNode<BoundingVolumeClass>::GetPotentialCollisionsBetween(const HalfSpaceCollider* halfSpace, PotentialCollision* out_collisions, int limit) const
+int BVHNode<BoundingVolumeClass>::GetPotentialCollisionsBetween(const HalfSpaceCollider* halfSpace, const CollisionFilter& halfSpaceFilter, PotentialCollision* out_collisions, int limit) const
 {
-	if (limit == 0 || !m_boundingVolumeWs.Overlaps(halfSpace))
+	if (limit == 0 || !m_filter.CanCollideWith(halfSpaceFilter) || !m_boundingVolumeWs.Overlaps(halfSpace))
 		return 0;
 
 	if (IsLeaf())
@@ -117,12 +136,62 @@ int BVHNode<BoundingVolumeClass>::GetPotentialCollisionsBetween(const HalfSpaceC
 	}
 
 	// Recurse on our first child
-	int numAdded = m_children[0]->GetPotentialCollisionsBetween(halfSpace, out_collisions, limit);
+	int numAdded = m_children[0]->GetPotentialCollisionsBetween(halfSpace, halfSpaceFilter, out_collisions, limit);
+
+	if (limit > numAdded)
+	{
+		// Recurse on our second child
+		numAdded += m_children[1]->GetPotentialCollisionsBetween(halfSpace, halfSpaceFilter, out_collisions + numAdded, limit - numAdded);
+	}
+
+	return numAdded;
+}
+
+
+//-------------------------------------------------------------------------------------------------
+template <class BoundingVolumeClass>
+int BVHNode<BoundingVolumeClass>::GetRaycastCandidates(const Vector3& start, const Vector3& direction, float maxDistance, const Collider** out_colliders, int limit) const
+{
+	if (limit == 0 || !m_boundingVolumeWs.IntersectsRay(start, direction, maxDistance))
+		return 0;
+
+	if (IsLeaf())
+	{
+		out_colliders[0] = m_entity->collider;
+		return 1;
+	}
+
+	// Recurse on our first child
+	int numAdded = m_children[0]->GetRaycastCandidates(start, direction, maxDistance, out_colliders, limit);
 
 	if (limit > numAdded)
 	{
 		// Recurse on our second child
-		numAdded += m_children[1]->GetPotentialCollisionsBetween(halfSpace, out_collisions + numAdded, limit - numAdded);
+		numAdded += m_children[1]->GetRaycastCandidates(start, direction, maxDistance, out_colliders + numAdded, limit - numAdded);
+	}
+
+	return numAdded;
+}
+
+
+//-------------------------------------------------------------------------------------------------
+template <class BoundingVolumeClass>
+int BVHNode<BoundingVolumeClass>::GetOverlapCandidates(const BoundingVolumeClass& volume, const Collider** out_colliders, int limit) const
+{
+	if (limit == 0 || !m_boundingVolumeWs.Overlaps(volume))
+		return 0;
+
+	if (IsLeaf())
+	{
+		out_colliders[0] = m_entity->collider;
+		return 1;
+	}
+
+	int numAdded = m_children[0]->GetOverlapCandidates(volume, out_colliders, limit);
+
+	if (limit > numAdded)
+	{
+		numAdded += m_children[1]->GetOverlapCandidates(volume, out_colliders + numAdded, limit - numAdded);
 	}
 
 	return numAdded;
@@ -198,6 +267,10 @@ int BVHNode<BoundingVolumeClass>::GetPotentialNodeCollisions(PotentialCollision*
 	if (limit == 0 || IsLeaf())
 		return 0;
 
+	// If nothing in this subtree is allowed to collide with anything else in it, there's no pairs to find
+	if (!m_filter.CanCollideWith(m_filter))
+		return 0;
+
 	// Check for collisions between our children
 	// The way the hierarchy is built, all non-leafs will always have 2 non-null children
 	int numAdded = m_children[0]->GetPotentialCollisionsBetween(m_children[1], out_collisions, limit);
@@ -222,7 +295,7 @@ int BVHNode<BoundingVolumeClass>::GetPotentialNodeCollisions(PotentialCollision*
 template <class BoundingVolumeClass>
 int BVHNode<BoundingVolumeClass>::GetPotentialCollisionsBetween(const BVHNode<BoundingVolumeClass>* other, PotentialCollision* out_collisions, int limit) const
 {
-	if (limit == 0 || !m_boundingVolumeWs.Overlaps(other->m_boundingVolumeWs))
+	if (limit == 0 || !m_filter.CanCollideWith(other->m_filter) || !m_boundingVolumeWs.Overlaps(other->m_boundingVolumeWs))
 		return 0;
 
 	// These two nodes overlap - if they're leaves, then the two entities could overlap
@@ -379,7 +452,7 @@ void BVHNode<BoundingVolumeClass>::RecalculateBoundingVolume()
 	ASSERT_OR_DIE(!IsLeaf(), "Leaf nodes should not be recalculated!");
 	ASSERT_OR_DIE(this != m_parent, "We are our own parent!");
 
-	m_boundingVolumeWs = BoundingVolumeClass(m_children[0]->m_boundingVolumeWs, m_children[1]->m_boundingVolumeWs);
+	RefitSelf();
 	if (m_parent != nullptr)
 	{
 		m_parent->RecalculateBoundingVolume();
@@ -387,6 +460,103 @@ void BVHNode<BoundingVolumeClass>::RecalculateBoundingVolume()
 }
 
 
+//-------------------------------------------------------------------------------------------------
+template <class BoundingVolumeClass>
+void BVHNode<BoundingVolumeClass>::RefitSelf()
+{
+	m_boundingVolumeWs = BoundingVolumeClass(m_children[0]->m_boundingVolumeWs, m_children[1]->m_boundingVolumeWs);
+	m_filter.m_layers = m_children[0]->m_filter.m_layers | m_children[1]->m_filter.m_layers;
+	m_filter.m_mask = m_children[0]->m_filter.m_mask | m_children[1]->m_filter.m_mask;
+}
+
+
+//-------------------------------------------------------------------------------------------------
+template <class BoundingVolumeClass>
+bool BVHNode<BoundingVolumeClass>::TryRotate()
+{
+	if (IsLeaf())
+		return false;
+
+	// Swapping one of our children with one of our grandchildren (under the other child) only changes the volume of that other child
+	// So pick the swap that shrinks that child the most, if any
+	float bestSavings = 0.f;
+	BVHNode<BoundingVolumeClass>* bestChild = nullptr;
+	BVHNode<BoundingVolumeClass>* bestGrandchild = nullptr;
+
+	for (int iChild = 0; iChild < 2; ++iChild)
+	{
+		BVHNode<BoundingVolumeClass>* child = m_children[iChild];
+		BVHNode<BoundingVolumeClass>* otherChild = m_children[1 - iChild];
+
+		if (otherChild->IsLeaf())
+			continue;
+
+		float currArea = otherChild->m_boundingVolumeWs.GetSurfaceArea();
+
+		for (int iGrandchild = 0; iGrandchild < 2; ++iGrandchild)
+		{
+			// Child would take this grandchild's place, so the other child would then bound the child and the remaining grandchild
+			BVHNode<BoundingVolumeClass>* remainingGrandchild = otherChild->m_children[1 - iGrandchild];
+			BoundingVolumeClass newVolume(child->m_boundingVolumeWs, remainingGrandchild->m_boundingVolumeWs);
+
+			float savings = currArea - newVolume.GetSurfaceArea();
+			if (savings > bestSavings)
+			{
+				bestSavings = savings;
+				bestChild = child;
+				bestGrandchild = otherChild->m_children[iGrandchild];
+			}
+		}
+	}
+
+	if (bestChild == nullptr)
+		return false;
+
+	BVHNode<BoundingVolumeClass>* grandchildParent = bestGrandchild->m_parent;
+	int childIndex = (m_children[0] == bestChild ? 0 : 1);
+	int grandchildIndex = (grandchildParent->m_children[0] == bestGrandchild ? 0 : 1);
+
+	m_children[childIndex] = bestGrandchild;
+	bestGrandchild->m_parent = this;
+
+	grandchildParent->m_children[grandchildIndex] = bestChild;
+	bestChild->m_parent = grandchildParent;
+
+	grandchildParent->RefitSelf();
+	RefitSelf();
+
+	return true;
+}
+
+
+//-------------------------------------------------------------------------------------------------
+template <class BoundingVolumeClass>
+float BVHNode<BoundingVolumeClass>::GetSubtreeCost() const
+{
+	if (IsLeaf())
+		return 0.f;
+
+	return m_boundingVolumeWs.GetSurfaceArea() + m_children[0]->GetSubtreeCost() + m_children[1]->GetSubtreeCost();
+}
+
+
+//-------------------------------------------------------------------------------------------------
+template <class BoundingVolumeClass>
+int BVHNode<BoundingVolumeClass>::GetDepth() const
+{
+	int depth = 0;
+	const BVHNode<BoundingVolumeClass>* curr = m_parent;
+
+	while (curr != nullptr)
+	{
+		depth++;
+		curr = curr->m_parent;
+	}
+
+	return depth;
+}
+
+
 ///--------------------------------------------------------------------------------------------------------------------------------------------------
 /// C FUNCTIONS
 ///--------------------------------------------------------------------------------------------------------------------------------------------------
@@ -10,6 +10,7 @@
 #include "Engine/Collision/BoundingVolumeHierarchy/BoundingVolume.h"
 #include "Engine/Collision/Collider.h"
 #include "Engine/Core/EngineCommon.h"
+#include "Engine/Core/Entity.h"
 #include "Engine/Core/Rgba.h"
 #include "Engine/Math/MathUtils.h"
 #include "Engine/Math/Transform.h"
@@ -31,6 +32,26 @@
 /// C FUNCTIONS
 ///--------------------------------------------------------------------------------------------------------------------------------------------------
 
+//-------------------------------------------------------------------------------------------------
+BoundingVolumeSphere MakeBoundingSphereForCollider(const Collider* collider)
+{
+	switch (collider->GetTypeIndex())
+	{
+	case SphereCollider::TYPE_INDEX:		return BoundingVolumeSphere(*ColliderCast<SphereCollider>(collider));
+	case CapsuleCollider::TYPE_INDEX:		return BoundingVolumeSphere(*ColliderCast<CapsuleCollider>(collider));
+	case BoxCollider::TYPE_INDEX:			return BoundingVolumeSphere(*ColliderCast<BoxCollider>(collider));
+	case CylinderCollider::TYPE_INDEX:		return BoundingVolumeSphere(*ColliderCast<CylinderCollider>(collider));
+	case ConvexHullCollider::TYPE_INDEX:	return BoundingVolumeSphere(*ColliderCast<ConvexHullCollider>(collider));
+	case VoxelGridCollider::TYPE_INDEX:		return BoundingVolumeSphere(*ColliderCast<VoxelGridCollider>(collider));
+	case TriangleMeshCollider::TYPE_INDEX:	return BoundingVolumeSphere(*ColliderCast<TriangleMeshCollider>(collider));
+	case CompoundCollider::TYPE_INDEX:		return BoundingVolumeSphere(*ColliderCast<CompoundCollider>(collider));
+	default:
+		ERROR_AND_DIE("Cannot make bounding sphere for collider type: %s", collider->GetTypeAsString());
+		break;
+	}
+}
+
+
 ///--------------------------------------------------------------------------------------------------------------------------------------------------
 /// CLASS IMPLEMENTATIONS
 ///--------------------------------------------------------------------------------------------------------------------------------------------------
@@ -110,6 +131,41 @@ BoundingVolumeSphere::BoundingVolumeSphere(const BoxCollider& colBox)
 }
 
 
+//-------------------------------------------------------------------------------------------------
+BoundingVolumeSphere::BoundingVolumeSphere(const VoxelGridCollider& voxelCol)
+{
+	// Bounds the whole grid rather than just the occupied cells, the grid is static so this is only made once
+	AABB3 boundsLs = voxelCol.GetBoundsLs();
+	const Transform& transform = voxelCol.m_entity->transform;
+
+	m_center = transform.TransformPosition(boundsLs.GetCenter());
+	m_radius = 0.5f * boundsLs.GetDimensions().GetLength() * transform.scale.x;
+}
+
+
+//-------------------------------------------------------------------------------------------------
+BoundingVolumeSphere::BoundingVolumeSphere(const TriangleMeshCollider& meshCol)
+{
+	AABB3 boundsLs = meshCol.GetBoundsLs();
+	const Transform& transform = meshCol.m_entity->transform;
+
+	m_center = transform.TransformPosition(boundsLs.GetCenter());
+	m_radius = 0.5f * boundsLs.GetDimensions().GetLength() * transform.scale.x;
+}
+
+
+//-------------------------------------------------------------------------------------------------
+BoundingVolumeSphere::BoundingVolumeSphere(const CompoundCollider& compoundCol)
+{
+	BoundingVolumeSphere boundsLs = compoundCol.GetBoundsLs();
+	const Transform& transform = compoundCol.m_entity->transform;
+	float maxScale = Max(Abs(transform.scale.x), Max(Abs(transform.scale.y), Abs(transform.scale.z)));
+
+	m_center = transform.TransformPosition(boundsLs.m_center);
+	m_radius = boundsLs.m_radius * maxScale;
+}
+
+
 //-------------------------------------------------------------------------------------------------
 BoundingVolumeSphere::BoundingVolumeSphere(const CapsuleCollider& capsuleCol)
 {
@@ -138,26 +194,11 @@ BoundingVolumeSphere::BoundingVolumeSphere(const CylinderCollider& cylinderCol)
 //-------------------------------------------------------------------------------------------------
 BoundingVolumeSphere::BoundingVolumeSphere(const ConvexHullCollider& polyCol)
 {
-	Polyhedron polyWs = polyCol.GetDataInWorldSpace();
-	int numVerts = polyWs.GetNumVertices();
-
-	Vector3 avgPos = Vector3::ZERO;
-	for (int iVert = 0; iVert < numVerts; ++iVert)
-	{
-		avgPos += polyWs.GetVertexPosition(iVert);
-	}
+	// Shapes keep a sphere around their vertex average, so the hull never needs transforming here
+	Sphere sphereWs = polyCol.GetBoundingSphereWs();
 
-	avgPos /= (float)numVerts;
-
-	float maxDistSqr = -1.0f;
-	for (int iVert = 0; iVert < numVerts; ++iVert)
-	{
-		float distSqr = (avgPos - polyWs.GetVertexPosition(iVert)).GetLengthSquared();
-		maxDistSqr = Max(maxDistSqr, distSqr);
-	}
-
-	m_center = avgPos;
-	m_radius = Sqrt(maxDistSqr);
+	m_center = sphereWs.m_center;
+	m_radius = sphereWs.m_radius;
 }
 
 
@@ -212,6 +253,30 @@ bool BoundingVolumeSphere::Overlaps(const PlaneCollider* planeCol) const
 }
 
 
+//-------------------------------------------------------------------------------------------------
+bool BoundingVolumeSphere::IntersectsRay(const Vector3& start, const Vector3& direction, float maxDistance) const
+{
+	Vector3 toCenter = m_center - start;
+	float t = DotProduct(toCenter, direction);
+	float distanceSquared = toCenter.GetLengthSquared() - t * t;
+	float radiusSquared = m_radius * m_radius;
+
+	if (distanceSquared > radiusSquared)
+		return false;
+
+	// Check the ray is inside the sphere at some point between the start and max distance
+	float halfChord = sqrtf(radiusSquared - distanceSquared);
+	return (t + halfChord >= 0.f && t - halfChord <= maxDistance);
+}
+
+
+//-------------------------------------------------------------------------------------------------
+float BoundingVolumeSphere::GetSurfaceArea() const
+{
+	return 4.f * PI * m_radius * m_radius;
+}
+
+
 //-------------------------------------------------------------------------------------------------
 float BoundingVolumeSphere::GetGrowth(const BoundingVolumeSphere& other) const
 {
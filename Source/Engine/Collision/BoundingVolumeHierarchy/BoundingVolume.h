@@ -19,12 +19,16 @@
 ///--------------------------------------------------------------------------------------------------------------------------------------------------
 class BoxCollider;
 class CapsuleCollider;
+class Collider;
+class CompoundCollider;
 class CylinderCollider;
 class HalfSpaceCollider;
 class PlaneCollider;
 class ConvexHullCollider;
 class SphereCollider;
 class Transform;
+class VoxelGridCollider;
+class TriangleMeshCollider;
 
 ///--------------------------------------------------------------------------------------------------------------------------------------------------
 /// GLOBALS AND STATICS
@@ -48,6 +52,9 @@ public:
 	BoundingVolumeSphere(const CapsuleCollider& capsuleCol);
 	BoundingVolumeSphere(const CylinderCollider& cylinderCol);
 	BoundingVolumeSphere(const ConvexHullCollider& polyCol);
+	BoundingVolumeSphere(const VoxelGridCollider& voxelCol);
+	BoundingVolumeSphere(const TriangleMeshCollider& meshCol);
+	BoundingVolumeSphere(const CompoundCollider& compoundCol);
 
 	BoundingVolumeSphere	GetTransformApplied(const Transform& transform);
 	void					DebugRender() const;
@@ -55,8 +62,11 @@ public:
 	bool					Overlaps(const BoundingVolumeSphere& sphere) const;
 	bool					Overlaps(const HalfSpaceCollider* halfspace) const;
 	bool					Overlaps(const PlaneCollider* planeCol) const;
+	bool					IntersectsRay(const Vector3& start, const Vector3& direction, float maxDistance) const; // Direction must be normalized
 	float					GetSize() const { return m_radius; }
 	float					GetGrowth(const BoundingVolumeSphere& other) const;
+	float					GetSurfaceArea() const; // Used as the SAH cost of a node
+	Vector3					GetCenter() const { return m_center; }
 
 
 private:
@@ -67,3 +77,4 @@ private:
 ///--------------------------------------------------------------------------------------------------------------------------------------------------
 /// C FUNCTIONS
 ///--------------------------------------------------------------------------------------------------------------------------------------------------
+BoundingVolumeSphere MakeBoundingSphereForCollider(const Collider* collider); // For bounded colliders only
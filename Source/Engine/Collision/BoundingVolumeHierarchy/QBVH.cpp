@@ -0,0 +1,328 @@
+///--------------------------------------------------------------------------------------------------------------------------------------------------
+/// Author: Andrew Chase
+/// Date Created: October 18th, 2026
+/// Description:
+///--------------------------------------------------------------------------------------------------------------------------------------------------
+
+///--------------------------------------------------------------------------------------------------------------------------------------------------
+/// INCLUDES
+///--------------------------------------------------------------------------------------------------------------------------------------------------
+#include "Engine/Collision/BoundingVolumeHierarchy/QBVH.h"
+#include "Engine/Core/EngineCommon.h"
+#include "Engine/Core/Entity.h"
+#include <xmmintrin.h>
+
+///--------------------------------------------------------------------------------------------------------------------------------------------------
+/// DEFINES
+///--------------------------------------------------------------------------------------------------------------------------------------------------
+
+///--------------------------------------------------------------------------------------------------------------------------------------------------
+/// ENUMS, TYPEDEFS, STRUCTS, FORWARD DECLARATIONS
+///--------------------------------------------------------------------------------------------------------------------------------------------------
+
+///--------------------------------------------------------------------------------------------------------------------------------------------------
+/// GLOBALS AND STATICS
+///--------------------------------------------------------------------------------------------------------------------------------------------------
+
+///--------------------------------------------------------------------------------------------------------------------------------------------------
+/// C FUNCTIONS
+///--------------------------------------------------------------------------------------------------------------------------------------------------
+
+//-------------------------------------------------------------------------------------------------
+// Returns a bit for each child whose bounds overlap the sphere
+static int GetSphereOverlapMask(const QBVHNode& node, const Vector3& center, float radius)
+{
+	__m128 dx = _mm_sub_ps(_mm_loadu_ps(node.m_centerX), _mm_set1_ps(center.x));
+	__m128 dy = _mm_sub_ps(_mm_loadu_ps(node.m_centerY), _mm_set1_ps(center.y));
+	__m128 dz = _mm_sub_ps(_mm_loadu_ps(node.m_centerZ), _mm_set1_ps(center.z));
+	__m128 distanceSquared = _mm_add_ps(_mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy)), _mm_mul_ps(dz, dz));
+
+	__m128 radiusSum = _mm_add_ps(_mm_loadu_ps(node.m_radius), _mm_set1_ps(radius));
+	int mask = _mm_movemask_ps(_mm_cmplt_ps(distanceSquared, _mm_mul_ps(radiusSum, radiusSum)));
+
+	return mask & ((1 << node.m_numChildren) - 1);
+}
+
+
+//-------------------------------------------------------------------------------------------------
+// Returns a bit for each child whose bounds the ray passes through before maxDistance
+static int GetRayHitMask(const QBVHNode& node, const Vector3& start, const Vector3& direction, float maxDistance)
+{
+	__m128 toCenterX = _mm_sub_ps(_mm_loadu_ps(node.m_centerX), _mm_set1_ps(start.x));
+	__m128 toCenterY = _mm_sub_ps(_mm_loadu_ps(node.m_centerY), _mm_set1_ps(start.y));
+	__m128 toCenterZ = _mm_sub_ps(_mm_loadu_ps(node.m_centerZ), _mm_set1_ps(start.z));
+
+	// Distance along the ray to the point closest to each center
+	__m128 t = _mm_add_ps(_mm_add_ps(_mm_mul_ps(toCenterX, _mm_set1_ps(direction.x)), _mm_mul_ps(toCenterY, _mm_set1_ps(direction.y))), _mm_mul_ps(toCenterZ, _mm_set1_ps(direction.z)));
+	__m128 toCenterLengthSquared = _mm_add_ps(_mm_add_ps(_mm_mul_ps(toCenterX, toCenterX), _mm_mul_ps(toCenterY, toCenterY)), _mm_mul_ps(toCenterZ, toCenterZ));
+	__m128 distanceSquared = _mm_sub_ps(toCenterLengthSquared, _mm_mul_ps(t, t));
+
+	__m128 radius = _mm_loadu_ps(node.m_radius);
+	__m128 radiusSquared = _mm_mul_ps(radius, radius);
+	__m128 hits = _mm_cmple_ps(distanceSquared, radiusSquared);
+
+	// Half the length of the ray inside each sphere, to get the entry and exit distances
+	__m128 halfChord = _mm_sqrt_ps(_mm_max_ps(_mm_sub_ps(radiusSquared, distanceSquared), _mm_setzero_ps()));
+	hits = _mm_and_ps(hits, _mm_cmpge_ps(_mm_add_ps(t, halfChord), _mm_setzero_ps()));
+	hits = _mm_and_ps(hits, _mm_cmple_ps(_mm_sub_ps(t, halfChord), _mm_set1_ps(maxDistance)));
+
+	return _mm_movemask_ps(hits) & ((1 << node.m_numChildren) - 1);
+}
+
+
+///--------------------------------------------------------------------------------------------------------------------------------------------------
+/// CLASS IMPLEMENTATIONS
+///--------------------------------------------------------------------------------------------------------------------------------------------------
+
+//-------------------------------------------------------------------------------------------------
+void QBVH::Build(const BVHNode<BoundingVolumeSphere>* root)
+{
+	Clear();
+
+	if (root == nullptr)
+		return;
+
+	if (root->IsLeaf())
+	{
+		// Still need a node to hold the bounds
+		m_nodes.push_back(QBVHNode());
+		m_nodes[0].m_numChildren = 1;
+		SetChild(0, 0, root, -1);
+	}
+	else
+	{
+		BuildNode(root);
+	}
+}
+
+
+//-------------------------------------------------------------------------------------------------
+void QBVH::Clear()
+{
+	m_nodes.clear();
+	m_leafColliders.clear();
+	m_leafVolumes.clear();
+	m_leafFilters.clear();
+}
+
+
+//-------------------------------------------------------------------------------------------------
+int QBVH::FindAllPotentialCollisions(PotentialCollision* out_collisions, int limit) const
+{
+	if (m_nodes.size() == 0)
+		return 0;
+
+	int numFound = 0;
+	int numLeaves = (int)m_leafColliders.size();
+
+	// Only take leaves after each query leaf, so each pair is found once
+	for (int leafIndex = 0; leafIndex < numLeaves && numFound < limit; ++leafIndex)
+	{
+		numFound += GetPotentialCollisionsInNode(0, m_leafColliders[leafIndex], m_leafVolumes[leafIndex], m_leafFilters[leafIndex], leafIndex + 1, out_collisions + numFound, limit - numFound);
+	}
+
+	return numFound;
+}
+
+
+//-------------------------------------------------------------------------------------------------
+int QBVH::GetPotentialCollisionsWith(const Collider* collider, const BoundingVolumeSphere& volume, const CollisionFilter& filter, PotentialCollision* out_collisions, int limit) const
+{
+	if (m_nodes.size() == 0)
+		return 0;
+
+	return GetPotentialCollisionsInNode(0, collider, volume, filter, 0, out_collisions, limit);
+}
+
+
+//-------------------------------------------------------------------------------------------------
+int QBVH::GetRaycastCandidates(const Vector3& start, const Vector3& direction, float maxDistance, const Collider** out_colliders, int limit) const
+{
+	if (m_nodes.size() == 0)
+		return 0;
+
+	return GetRaycastCandidatesInNode(0, start, direction, maxDistance, out_colliders, limit);
+}
+
+
+//-------------------------------------------------------------------------------------------------
+int QBVH::GetOverlapCandidates(const BoundingVolumeSphere& volume, const Collider** out_colliders, int limit) const
+{
+	if (m_nodes.size() == 0)
+		return 0;
+
+	return GetOverlapCandidatesInNode(0, volume, out_colliders, limit);
+}
+
+
+//-------------------------------------------------------------------------------------------------
+int QBVH::BuildNode(const BVHNode<BoundingVolumeSphere>* binaryNode)
+{
+	// Pull grandchildren up until all four slots are filled, opening the largest internal node each time
+	const BVHNode<BoundingVolumeSphere>* children[4] = { binaryNode->m_children[0], binaryNode->m_children[1], nullptr, nullptr };
+	int numChildren = 2;
+
+	while (numChildren < 4)
+	{
+		int childToOpen = -1;
+		float largestArea = -1.f;
+
+		for (int childIndex = 0; childIndex < numChildren; ++childIndex)
+		{
+			if (!children[childIndex]->IsLeaf() && children[childIndex]->m_boundingVolumeWs.GetSurfaceArea() > largestArea)
+			{
+				largestArea = children[childIndex]->m_boundingVolumeWs.GetSurfaceArea();
+				childToOpen = childIndex;
+			}
+		}
+
+		if (childToOpen == -1)
+			break;
+
+		const BVHNode<BoundingVolumeSphere>* opened = children[childToOpen];
+		children[childToOpen] = opened->m_children[0];
+		children[numChildren++] = opened->m_children[1];
+	}
+
+	int nodeIndex = (int)m_nodes.size();
+	m_nodes.push_back(QBVHNode());
+	m_nodes[nodeIndex].m_numChildren = numChildren;
+
+	for (int childIndex = 0; childIndex < numChildren; ++childIndex)
+	{
+		// Recursing adds to m_nodes, so don't hold a reference to our node across it
+		int childReference = (children[childIndex]->IsLeaf() ? -1 : BuildNode(children[childIndex]));
+		SetChild(nodeIndex, childIndex, children[childIndex], childReference);
+	}
+
+	return nodeIndex;
+}
+
+
+//-------------------------------------------------------------------------------------------------
+// Pass a negative child reference for leaves, they'll be assigned their leaf index here
+void QBVH::SetChild(int nodeIndex, int slotIndex, const BVHNode<BoundingVolumeSphere>* binaryNode, int childReference)
+{
+	if (childReference < 0)
+	{
+		int leafIndex = (int)m_leafColliders.size();
+		m_leafColliders.push_back(binaryNode->m_entity->collider);
+		m_leafVolumes.push_back(binaryNode->m_boundingVolumeWs);
+		m_leafFilters.push_back(binaryNode->m_filter);
+
+		childReference = -(leafIndex + 1);
+	}
+
+	QBVHNode& node = m_nodes[nodeIndex];
+	node.m_centerX[slotIndex] = binaryNode->m_boundingVolumeWs.m_center.x;
+	node.m_centerY[slotIndex] = binaryNode->m_boundingVolumeWs.m_center.y;
+	node.m_centerZ[slotIndex] = binaryNode->m_boundingVolumeWs.m_center.z;
+	node.m_radius[slotIndex] = binaryNode->m_boundingVolumeWs.m_radius;
+	node.m_layers[slotIndex] = binaryNode->m_filter.m_layers;
+	node.m_masks[slotIndex] = binaryNode->m_filter.m_mask;
+	node.m_children[slotIndex] = childReference;
+
+	// Empty slots still get loaded, so keep them initialized - they're masked out of every test
+	for (int emptyIndex = node.m_numChildren; emptyIndex < 4; ++emptyIndex)
+	{
+		node.m_centerX[emptyIndex] = 0.f;
+		node.m_centerY[emptyIndex] = 0.f;
+		node.m_centerZ[emptyIndex] = 0.f;
+		node.m_radius[emptyIndex] = 0.f;
+	}
+}
+
+
+//-------------------------------------------------------------------------------------------------
+int QBVH::GetPotentialCollisionsInNode(int nodeIndex, const Collider* collider, const BoundingVolumeSphere& volume, const CollisionFilter& filter, int minLeafIndex, PotentialCollision* out_collisions, int limit) const
+{
+	const QBVHNode& node = m_nodes[nodeIndex];
+	int hitMask = GetSphereOverlapMask(node, volume.m_center, volume.m_radius);
+	int numFound = 0;
+
+	for (int childIndex = 0; childIndex < node.m_numChildren && numFound < limit; ++childIndex)
+	{
+		if ((hitMask & (1 << childIndex)) == 0)
+			continue;
+
+		CollisionFilter childFilter;
+		childFilter.m_layers = node.m_layers[childIndex];
+		childFilter.m_mask = node.m_masks[childIndex];
+
+		if (!filter.CanCollideWith(childFilter))
+			continue;
+
+		int childReference = node.m_children[childIndex];
+
+		if (childReference >= 0)
+		{
+			numFound += GetPotentialCollisionsInNode(childReference, collider, volume, filter, minLeafIndex, out_collisions + numFound, limit - numFound);
+		}
+		else if (-(childReference + 1) >= minLeafIndex)
+		{
+			out_collisions[numFound].colliders[0] = collider;
+			out_collisions[numFound].colliders[1] = m_leafColliders[-(childReference + 1)];
+			numFound++;
+		}
+	}
+
+	return numFound;
+}
+
+
+//-------------------------------------------------------------------------------------------------
+int QBVH::GetRaycastCandidatesInNode(int nodeIndex, const Vector3& start, const Vector3& direction, float maxDistance, const Collider** out_colliders, int limit) const
+{
+	const QBVHNode& node = m_nodes[nodeIndex];
+	int hitMask = GetRayHitMask(node, start, direction, maxDistance);
+	int numFound = 0;
+
+	for (int childIndex = 0; childIndex < node.m_numChildren && numFound < limit; ++childIndex)
+	{
+		if ((hitMask & (1 << childIndex)) == 0)
+			continue;
+
+		int childReference = node.m_children[childIndex];
+
+		if (childReference >= 0)
+		{
+			numFound += GetRaycastCandidatesInNode(childReference, start, direction, maxDistance, out_colliders + numFound, limit - numFound);
+		}
+		else
+		{
+			out_colliders[numFound] = m_leafColliders[-(childReference + 1)];
+			numFound++;
+		}
+	}
+
+	return numFound;
+}
+
+
+//-------------------------------------------------------------------------------------------------
+int QBVH::GetOverlapCandidatesInNode(int nodeIndex, const BoundingVolumeSphere& volume, const Collider** out_colliders, int limit) const
+{
+	const QBVHNode& node = m_nodes[nodeIndex];
+	int hitMask = GetSphereOverlapMask(node, volume.m_center, volume.m_radius);
+	int numFound = 0;
+
+	for (int childIndex = 0; childIndex < node.m_numChildren && numFound < limit; ++childIndex)
+	{
+		if ((hitMask & (1 << childIndex)) == 0)
+			continue;
+
+		int childReference = node.m_children[childIndex];
+
+		if (childReference >= 0)
+		{
+			numFound += GetOverlapCandidatesInNode(childReference, volume, out_colliders + numFound, limit - numFound);
+		}
+		else
+		{
+			out_colliders[numFound] = m_leafColliders[-(childReference + 1)];
+			numFound++;
+		}
+	}
+
+	return numFound;
+}
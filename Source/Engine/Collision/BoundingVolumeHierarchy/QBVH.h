@@ -0,0 +1,85 @@
+///--------------------------------------------------------------------------------------------------------------------------------------------------
+/// Author: Andrew Chase
+/// Date Created: October 18th, 2026
+/// Description: 4-wide BVH collapsed from a binary BVHNode tree, for testing four children at once with SSE
+///--------------------------------------------------------------------------------------------------------------------------------------------------
+#pragma once
+
+///--------------------------------------------------------------------------------------------------------------------------------------------------
+/// INCLUDES
+///--------------------------------------------------------------------------------------------------------------------------------------------------
+#include "Engine/Collision/BoundingVolumeHierarchy/BoundingVolume.h"
+#include "Engine/Collision/BoundingVolumeHierarchy/BVHNode.h"
+#include <vector>
+
+///--------------------------------------------------------------------------------------------------------------------------------------------------
+/// DEFINES
+///--------------------------------------------------------------------------------------------------------------------------------------------------
+
+///--------------------------------------------------------------------------------------------------------------------------------------------------
+/// ENUMS, TYPEDEFS, STRUCTS, FORWARD DECLARATIONS
+///--------------------------------------------------------------------------------------------------------------------------------------------------
+
+// Child bounds are stored SoA so all four can be loaded into one register per component
+struct QBVHNode
+{
+	float	m_centerX[4];
+	float	m_centerY[4];
+	float	m_centerZ[4];
+	float	m_radius[4];
+	uint32	m_layers[4];
+	uint32	m_masks[4];
+	int		m_children[4]; // Node index if >= 0, otherwise a leaf index encoded as -(index + 1)
+	int		m_numChildren = 0;
+};
+
+///--------------------------------------------------------------------------------------------------------------------------------------------------
+/// GLOBALS AND STATICS
+///--------------------------------------------------------------------------------------------------------------------------------------------------
+
+///--------------------------------------------------------------------------------------------------------------------------------------------------
+/// CLASS DECLARATIONS
+///--------------------------------------------------------------------------------------------------------------------------------------------------
+
+//-------------------------------------------------------------------------------------------------
+// Read-only snapshot of a tree - rebuild it whenever the source tree changes
+class QBVH
+{
+public:
+	//-----Public Methods-----
+
+	void	Build(const BVHNode<BoundingVolumeSphere>* root);
+	void	Clear();
+	bool	IsEmpty() const { return m_leafColliders.size() == 0; }
+	int		GetNumLeaves() const { return (int)m_leafColliders.size(); }
+
+	int		FindAllPotentialCollisions(PotentialCollision* out_collisions, int limit) const;
+	int		GetPotentialCollisionsWith(const Collider* collider, const BoundingVolumeSphere& volume, const CollisionFilter& filter, PotentialCollision* out_collisions, int limit) const; // collider will be colliders[0] in each
+	int		GetRaycastCandidates(const Vector3& start, const Vector3& direction, float maxDistance, const Collider** out_colliders, int limit) const; // Direction must be normalized
+	int		GetOverlapCandidates(const BoundingVolumeSphere& volume, const Collider** out_colliders, int limit) const;
+
+
+private:
+	//-----Private Methods-----
+
+	int		BuildNode(const BVHNode<BoundingVolumeSphere>* binaryNode);
+	void	SetChild(int nodeIndex, int slotIndex, const BVHNode<BoundingVolumeSphere>* binaryNode, int childReference);
+	int		GetPotentialCollisionsInNode(int nodeIndex, const Collider* collider, const BoundingVolumeSphere& volume, const CollisionFilter& filter, int minLeafIndex, PotentialCollision* out_collisions, int limit) const;
+	int		GetRaycastCandidatesInNode(int nodeIndex, const Vector3& start, const Vector3& direction, float maxDistance, const Collider** out_colliders, int limit) const;
+	int		GetOverlapCandidatesInNode(int nodeIndex, const BoundingVolumeSphere& volume, const Collider** out_colliders, int limit) const;
+
+
+private:
+	//-----Private Data-----
+
+	std::vector<QBVHNode>				m_nodes; // Root is always index 0
+	std::vector<const Collider*>		m_leafColliders;
+	std::vector<BoundingVolumeSphere>	m_leafVolumes;
+	std::vector<CollisionFilter>		m_leafFilters;
+
+};
+
+
+///--------------------------------------------------------------------------------------------------------------------------------------------------
+/// C FUNCTIONS
+///--------------------------------------------------------------------------------------------------------------------------------------------------
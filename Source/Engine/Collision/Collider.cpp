@@ -11,7 +11,11 @@
 #include "Engine/Core/EngineCommon.h"
 #include "Engine/Core/Entity.h"
 #include "Engine/Core/Rgba.h"
+#include "Engine/Math/MathUtils.h"
+#include "Engine/Render/Mesh/MeshBuilder.h"
 #include "Engine/Render/Debug/DebugRenderSystem.h"
+#include <algorithm>
+#include <map>
 
 ///--------------------------------------------------------------------------------------------------------------------------------------------------
 /// DEFINES
@@ -28,6 +32,32 @@ RTTI_TYPE_DEFINE(BoxCollider);
 RTTI_TYPE_DEFINE(CapsuleCollider);
 RTTI_TYPE_DEFINE(CylinderCollider);
 RTTI_TYPE_DEFINE(ConvexHullCollider);
+RTTI_TYPE_DEFINE(VoxelGridCollider);
+RTTI_TYPE_DEFINE(TriangleMeshCollider);
+RTTI_TYPE_DEFINE(CompoundCollider);
+
+// Vertex positions quantized to the weld tolerance, for finding duplicates
+struct WeldKey
+{
+	int x;
+	int y;
+	int z;
+
+	bool operator<(const WeldKey& other) const
+	{
+		if (x != other.x) return x < other.x;
+		if (y != other.y) return y < other.y;
+		return z < other.z;
+	}
+};
+
+struct TriangleMeshEdge
+{
+	int minVertex;
+	int maxVertex;
+	int triangleIndex;
+	int edgeIndex;
+};
 
 ///--------------------------------------------------------------------------------------------------------------------------------------------------
 /// GLOBALS AND STATICS
@@ -39,13 +69,32 @@ const DebugRenderOptions Collider::DEFAULT_COLLIDER_RENDER_OPTIONS = DebugRender
 /// C FUNCTIONS
 ///--------------------------------------------------------------------------------------------------------------------------------------------------
 
+//-------------------------------------------------------------------------------------------------
+// Touching counts, since flat triangles have flat bounds
+static bool DoAABB3sTouch(const AABB3& a, const AABB3& b)
+{
+	return (a.mins.x <= b.maxs.x && a.maxs.x >= b.mins.x)
+		&& (a.mins.y <= b.maxs.y && a.maxs.y >= b.mins.y)
+		&& (a.mins.z <= b.maxs.z && a.maxs.z >= b.mins.z);
+}
+
+
+//-------------------------------------------------------------------------------------------------
+static void StretchAABB3ToIncludePoint(AABB3& bounds, const Vector3& point)
+{
+	bounds.mins = Vector3(Min(bounds.mins.x, point.x), Min(bounds.mins.y, point.y), Min(bounds.mins.z, point.z));
+	bounds.maxs = Vector3(Max(bounds.maxs.x, point.x), Max(bounds.maxs.y, point.y), Max(bounds.maxs.z, point.z));
+}
+
 ///--------------------------------------------------------------------------------------------------------------------------------------------------
 /// CLASS IMPLEMENTATIONS
 ///--------------------------------------------------------------------------------------------------------------------------------------------------
 
 //-------------------------------------------------------------------------------------------------
-Collider::Collider(Entity* owningEntity)
+Collider::Collider(Entity* owningEntity, int typeIndex)
 	: m_entity(owningEntity)
+	, m_typeIndex(typeIndex)
+	, m_isPooled(ColliderPool::ClaimAllocation(this))
 {
 }
 
@@ -77,7 +126,7 @@ RigidBody* Collider::GetOwnerRigidBody() const
 
 //-------------------------------------------------------------------------------------------------
 SphereCollider::SphereCollider(Entity* owningEntity, const Sphere& sphereLs)
-	: TypedCollider(owningEntity, sphereLs)
+	: TypedCollider(owningEntity, sphereLs, TYPE_INDEX)
 {
 }
 
@@ -105,7 +154,7 @@ Sphere SphereCollider::GetDataInWorldSpace() const
 
 //-------------------------------------------------------------------------------------------------
 HalfSpaceCollider::HalfSpaceCollider(Entity* owningEntity, const Plane3& planeLs)
-	: TypedCollider(owningEntity, planeLs)
+	: TypedCollider(owningEntity, planeLs, TYPE_INDEX)
 {
 }
 
@@ -136,7 +185,7 @@ Plane3 HalfSpaceCollider::GetDataInWorldSpace() const
 
 //-------------------------------------------------------------------------------------------------
 BoxCollider::BoxCollider(Entity* owningEntity, const OBB3& boxLs)
-	: TypedCollider(owningEntity, boxLs)
+	: TypedCollider(owningEntity, boxLs, TYPE_INDEX)
 {
 }
 
@@ -167,7 +216,7 @@ OBB3 BoxCollider::GetDataInWorldSpace() const
 
 //-------------------------------------------------------------------------------------------------
 CapsuleCollider::CapsuleCollider(Entity* owningEntity, const Capsule3& capsuleLs)
-	: TypedCollider(owningEntity, capsuleLs)
+	: TypedCollider(owningEntity, capsuleLs, TYPE_INDEX)
 {
 }
 
@@ -197,7 +246,7 @@ Capsule3 CapsuleCollider::GetDataInWorldSpace() const
 
 //-------------------------------------------------------------------------------------------------
 PlaneCollider::PlaneCollider(Entity* owningEntity, const Plane3& planeLs)
-	: TypedCollider(owningEntity, planeLs)
+	: TypedCollider(owningEntity, planeLs, TYPE_INDEX)
 {
 }
 
@@ -228,7 +277,7 @@ Plane3 PlaneCollider::GetDataInWorldSpace() const
 
 //-------------------------------------------------------------------------------------------------
 CylinderCollider::CylinderCollider(Entity* owningEntity, const Cylinder& cylinderLs)
-	: TypedCollider(owningEntity, cylinderLs)
+	: TypedCollider(owningEntity, cylinderLs, TYPE_INDEX)
 {
 }
 
@@ -258,8 +307,18 @@ Cylinder CylinderCollider::GetDataInWorldSpace() const
 
 //-------------------------------------------------------------------------------------------------
 ConvexHullCollider::ConvexHullCollider(Entity* owningEntity, const Polyhedron& hullLs)
-	: TypedCollider(owningEntity, hullLs)
+	: Collider(owningEntity, TYPE_INDEX)
+	, m_shape(ConvexHullShape::Create(hullLs))
+{
+}
+
+
+//-------------------------------------------------------------------------------------------------
+ConvexHullCollider::ConvexHullCollider(Entity* owningEntity, const R<ConvexHullShape>& shape)
+	: Collider(owningEntity, TYPE_INDEX)
+	, m_shape(shape)
 {
+	ASSERT_OR_DIE(m_shape.IsValid(), "Convex hull collider needs a shape!");
 }
 
 
@@ -271,7 +330,7 @@ void ConvexHullCollider::ShowDebug()
 		DebugRenderOptions options = DEFAULT_COLLIDER_RENDER_OPTIONS;
 		options.m_parentTransform = &m_entity->transform;
 
-		DebugDrawPolyhedron(m_dataLs, options);
+		DebugDrawPolyhedron(m_shape->GetHullLs(), options);
 	}
 }
 
@@ -280,8 +339,724 @@ void ConvexHullCollider::ShowDebug()
 Polyhedron ConvexHullCollider::GetDataInWorldSpace() const
 {
 	Polyhedron polyWs;
+	GetDataInWorldSpace(polyWs);
+
+	return polyWs;
+}
+
+
+//-------------------------------------------------------------------------------------------------
+void ConvexHullCollider::GetDataInWorldSpace(Polyhedron& out_polyWs) const
+{
 	Matrix4 toWorld = m_entity->transform.GetModelMatrix();
-	m_dataLs.GetTransformed(toWorld, polyWs);
+	m_shape->GetHullLs().GetTransformed(toWorld, out_polyWs);
+}
+
+
+//-------------------------------------------------------------------------------------------------
+// Conservative for non-uniform scale, but never needs the hull transformed
+Sphere ConvexHullCollider::GetBoundingSphereWs() const
+{
+	const Sphere& sphereLs = m_shape->GetBoundingSphereLs();
+	Vector3 scale = m_entity->transform.scale;
+	float maxScale = Max(Abs(scale.x), Max(Abs(scale.y), Abs(scale.z)));
+
+	return Sphere(m_entity->transform.TransformPosition(sphereLs.m_center), sphereLs.m_radius * maxScale);
+}
+
+
+//-------------------------------------------------------------------------------------------------
+VoxelGridCollider::VoxelGridCollider(Entity* owningEntity, const IntVector3& dimensions, float cellSize)
+	: Collider(owningEntity, TYPE_INDEX)
+	, m_dimensions(dimensions)
+	, m_cellSize(cellSize)
+{
+	ASSERT_OR_DIE(dimensions.x > 0 && dimensions.y > 0 && dimensions.z > 0, "Voxel grid needs at least one cell!");
+	ASSERT_OR_DIE(cellSize > 0.f, "Voxel grid cell size must be positive!");
+
+	int numCells = dimensions.x * dimensions.y * dimensions.z;
+	m_occupancy.resize((numCells + 31) / 32, 0U);
+}
+
+
+//-------------------------------------------------------------------------------------------------
+void VoxelGridCollider::ShowDebug()
+{
+	if (m_debugRenderHandle == INVALID_DEBUG_RENDER_OBJECT_HANDLE)
+	{
+		DebugRenderOptions options = DEFAULT_COLLIDER_RENDER_OPTIONS;
+		options.m_parentTransform = &m_entity->transform;
+
+		m_debugRenderHandle = DebugDrawBox(OBB3(GetBoundsLs()), options);
+	}
+}
+
+
+//-------------------------------------------------------------------------------------------------
+void VoxelGridCollider::SetCellOccupied(const IntVector3& cellCoords, bool isOccupied)
+{
+	ASSERT_RETURN(cellCoords.x >= 0 && cellCoords.y >= 0 && cellCoords.z >= 0 && cellCoords.x < m_dimensions.x && cellCoords.y < m_dimensions.y && cellCoords.z < m_dimensions.z,
+		NO_RETURN_VAL, "Voxel cell (%i, %i, %i) is out of bounds!", cellCoords.x, cellCoords.y, cellCoords.z);
+
+	int cellIndex = GetCellIndex(cellCoords.x, cellCoords.y, cellCoords.z);
+	uint32 bit = (1U << (cellIndex & 31));
+	uint32& word = m_occupancy[cellIndex >> 5];
+
+	bool wasOccupied = ((word & bit) != 0);
+	if (wasOccupied == isOccupied)
+		return;
+
+	if (isOccupied)
+	{
+		word |= bit;
+		m_numOccupiedCells++;
+	}
+	else
+	{
+		word &= ~bit;
+		m_numOccupiedCells--;
+	}
+}
+
+
+//-------------------------------------------------------------------------------------------------
+bool VoxelGridCollider::IsCellOccupied(int x, int y, int z) const
+{
+	if (x < 0 || y < 0 || z < 0 || x >= m_dimensions.x || y >= m_dimensions.y || z >= m_dimensions.z)
+		return false;
+
+	int cellIndex = GetCellIndex(x, y, z);
+	return (m_occupancy[cellIndex >> 5] & (1U << (cellIndex & 31))) != 0;
+}
+
+
+//-------------------------------------------------------------------------------------------------
+AABB3 VoxelGridCollider::GetCellBoundsLs(const IntVector3& cellCoords) const
+{
+	Vector3 mins = Vector3((float)cellCoords.x, (float)cellCoords.y, (float)cellCoords.z) * m_cellSize;
+	return AABB3(mins, mins + Vector3(m_cellSize));
+}
+
+
+//-------------------------------------------------------------------------------------------------
+AABB3 VoxelGridCollider::GetBoundsLs() const
+{
+	Vector3 maxs = Vector3((float)m_dimensions.x, (float)m_dimensions.y, (float)m_dimensions.z) * m_cellSize;
+	return AABB3(Vector3::ZERO, maxs);
+}
+
+
+//-------------------------------------------------------------------------------------------------
+bool VoxelGridCollider::GetCellRangeOverlapping(const AABB3& boundsLs, IntVector3& out_minCoords, IntVector3& out_maxCoords) const
+{
+	float iCellSize = 1.0f / m_cellSize;
+
+	out_minCoords.x = Max(Floor(boundsLs.mins.x * iCellSize), 0);
+	out_minCoords.y = Max(Floor(boundsLs.mins.y * iCellSize), 0);
+	out_minCoords.z = Max(Floor(boundsLs.mins.z * iCellSize), 0);
+	out_maxCoords.x = Min(Floor(boundsLs.maxs.x * iCellSize), m_dimensions.x - 1);
+	out_maxCoords.y = Min(Floor(boundsLs.maxs.y * iCellSize), m_dimensions.y - 1);
+	out_maxCoords.z = Min(Floor(boundsLs.maxs.z * iCellSize), m_dimensions.z - 1);
+
+	return (out_minCoords.x <= out_maxCoords.x && out_minCoords.y <= out_maxCoords.y && out_minCoords.z <= out_maxCoords.z);
+}
+
+
+//-------------------------------------------------------------------------------------------------
+TriangleMeshCollider::TriangleMeshCollider(Entity* owningEntity, const MeshBuilder& mb)
+	: Collider(owningEntity, TYPE_INDEX)
+{
+	ASSERT_OR_DIE(!mb.IsBuilding(), "MeshBuilder needs to finish building before making a collider from it!");
+	ASSERT_OR_DIE(mb.GetDrawInstruction().m_topology == TOPOLOGY_TRIANGLE_LIST, "TriangleMeshCollider only supports triangle lists!");
+
+	uint32 numVertices = mb.GetVertexCount();
+	std::vector<Vector3> positionsLs(numVertices);
+
+	for (uint32 vertexIndex = 0; vertexIndex < numVertices; ++vertexIndex)
+	{
+		positionsLs[vertexIndex] = mb.GetVertex(vertexIndex).m_position;
+	}
+
+	std::vector<uint32> indices;
+	if (mb.GetDrawInstruction().m_useIndices)
+	{
+		uint32 numIndices = mb.GetIndexCount();
+		indices.resize(numIndices);
+
+		for (uint32 indexIndex = 0; indexIndex < numIndices; ++indexIndex)
+		{
+			indices[indexIndex] = mb.GetIndex(indexIndex);
+		}
+	}
+	else
+	{
+		indices.resize(numVertices);
+
+		for (uint32 vertexIndex = 0; vertexIndex < numVertices; ++vertexIndex)
+		{
+			indices[vertexIndex] = vertexIndex;
+		}
+	}
+
+	BuildFromTriangleList(positionsLs, indices);
+}
+
+
+//-------------------------------------------------------------------------------------------------
+TriangleMeshCollider::TriangleMeshCollider(Entity* owningEntity, const std::vector<Vector3>& positionsLs, const std::vector<uint32>& indices)
+	: Collider(owningEntity, TYPE_INDEX)
+{
+	BuildFromTriangleList(positionsLs, indices);
+}
+
+
+//-------------------------------------------------------------------------------------------------
+void TriangleMeshCollider::ShowDebug()
+{
+	if (m_debugRenderHandle == INVALID_DEBUG_RENDER_OBJECT_HANDLE)
+	{
+		DebugRenderOptions options = DEFAULT_COLLIDER_RENDER_OPTIONS;
+		options.m_parentTransform = &m_entity->transform;
+
+		m_debugRenderHandle = DebugDrawBox(OBB3(GetBoundsLs()), options);
+	}
+}
+
+
+//-------------------------------------------------------------------------------------------------
+Triangle3 TriangleMeshCollider::GetTriangleLs(int triangleIndex) const
+{
+	const TriangleMeshTriangle& triangle = m_triangles[triangleIndex];
+	return Triangle3(m_verticesLs[triangle.m_vertexIndices[0]], m_verticesLs[triangle.m_vertexIndices[1]], m_verticesLs[triangle.m_vertexIndices[2]]);
+}
+
+
+//-------------------------------------------------------------------------------------------------
+Triangle3 TriangleMeshCollider::GetTriangleWs(int triangleIndex) const
+{
+	const TriangleMeshTriangle& triangle = m_triangles[triangleIndex];
+	const Transform& transform = m_entity->transform;
+
+	return Triangle3(
+		transform.TransformPosition(m_verticesLs[triangle.m_vertexIndices[0]]),
+		transform.TransformPosition(m_verticesLs[triangle.m_vertexIndices[1]]),
+		transform.TransformPosition(m_verticesLs[triangle.m_vertexIndices[2]]));
+}
+
+
+//-------------------------------------------------------------------------------------------------
+AABB3 TriangleMeshCollider::GetBoundsLs() const
+{
+	if (m_nodes.size() == 0)
+	{
+		return AABB3(Vector3::ZERO, Vector3::ZERO);
+	}
+
+	return m_nodes[0].m_boundsLs;
+}
+
+
+//-------------------------------------------------------------------------------------------------
+void TriangleMeshCollider::GetTrianglesOverlapping(const AABB3& boundsLs, std::vector<int>& out_triangleIndices) const
+{
+	out_triangleIndices.clear();
+
+	if (m_nodes.size() == 0)
+		return;
+
+	int nodeStack[64];
+	int stackSize = 0;
+	nodeStack[stackSize++] = 0;
+
+	while (stackSize > 0)
+	{
+		const TriangleMeshBVHNode& node = m_nodes[nodeStack[--stackSize]];
+
+		if (!DoAABB3sTouch(node.m_boundsLs, boundsLs))
+			continue;
+
+		if (node.m_numTriangles > 0)
+		{
+			for (int i = 0; i < node.m_numTriangles; ++i)
+			{
+				out_triangleIndices.push_back(node.m_firstChildOrTriangle + i);
+			}
+		}
+		else
+		{
+			ASSERT_OR_DIE(stackSize + 2 <= 64, "Triangle mesh BVH is too deep!");
+			nodeStack[stackSize++] = node.m_firstChildOrTriangle + 1;
+			nodeStack[stackSize++] = node.m_firstChildOrTriangle;
+		}
+	}
+}
+
+
+//-------------------------------------------------------------------------------------------------
+void TriangleMeshCollider::BuildFromTriangleList(const std::vector<Vector3>& positionsLs, const std::vector<uint32>& indices)
+{
+	ASSERT_OR_DIE(indices.size() % 3 == 0, "Triangle list index count isn't a multiple of 3!");
+
+	std::vector<int> remap;
+	WeldVertices(positionsLs, remap);
+
+	int numInputTriangles = (int)indices.size() / 3;
+	m_triangles.reserve(numInputTriangles);
+
+	for (int inputIndex = 0; inputIndex < numInputTriangles; ++inputIndex)
+	{
+		TriangleMeshTriangle triangle;
+		for (int i = 0; i < 3; ++i)
+		{
+			triangle.m_vertexIndices[i] = remap[indices[3 * inputIndex + i]];
+		}
+
+		const Vector3& a = m_verticesLs[triangle.m_vertexIndices[0]];
+		const Vector3& b = m_verticesLs[triangle.m_vertexIndices[1]];
+		const Vector3& c = m_verticesLs[triangle.m_vertexIndices[2]];
+		Vector3 normal = CrossProduct(b - a, c - a);
+
+		// Slivers and triangles that welded down to a line can't produce a sensible normal
+		float normalLength = normal.GetLength();
+		if (normalLength < 1e-8f)
+			continue;
+
+		triangle.m_normalLs = normal / normalLength;
+		m_triangles.push_back(triangle);
+	}
+
+	ComputeActiveEdges();
+	BuildBVH();
+}
+
+
+//-------------------------------------------------------------------------------------------------
+void TriangleMeshCollider::WeldVertices(const std::vector<Vector3>& positionsLs, std::vector<int>& out_remap)
+{
+	// Builders duplicate vertices per face for flat normals/uvs, so share them back up or adjacency can't be found
+	const float weldTolerance = 1e-4f;
+	std::map<WeldKey, int> weldedIndices;
+
+	int numVertices = (int)positionsLs.size();
+	out_remap.resize(numVertices);
+
+	for (int vertexIndex = 0; vertexIndex < numVertices; ++vertexIndex)
+	{
+		const Vector3& position = positionsLs[vertexIndex];
+
+		WeldKey key;
+		key.x = RoundToNearestInt(position.x / weldTolerance);
+		key.y = RoundToNearestInt(position.y / weldTolerance);
+		key.z = RoundToNearestInt(position.z / weldTolerance);
+
+		std::map<WeldKey, int>::iterator itr = weldedIndices.find(key);
+		if (itr != weldedIndices.end())
+		{
+			out_remap[vertexIndex] = itr->second;
+		}
+		else
+		{
+			int weldedIndex = (int)m_verticesLs.size();
+			m_verticesLs.push_back(position);
+			weldedIndices[key] = weldedIndex;
+			out_remap[vertexIndex] = weldedIndex;
+		}
+	}
+}
+
+
+//-------------------------------------------------------------------------------------------------
+// An edge only needs to generate contacts if it's convex, since anything hitting a flat or concave edge
+// will hit one of the adjacent faces first - letting those edges produce contacts is what causes
+// shapes to bump on seams when sliding across the mesh
+void TriangleMeshCollider::ComputeActiveEdges()
+{
+	int numTriangles = (int)m_triangles.size();
+
+	std::vector<TriangleMeshEdge> edges;
+	edges.reserve(3 * numTriangles);
+
+	for (int triangleIndex = 0; triangleIndex < numTriangles; ++triangleIndex)
+	{
+		const TriangleMeshTriangle& triangle = m_triangles[triangleIndex];
+
+		for (int edgeIndex = 0; edgeIndex < 3; ++edgeIndex)
+		{
+			int startVertex = triangle.m_vertexIndices[edgeIndex];
+			int endVertex = triangle.m_vertexIndices[(edgeIndex + 1) % 3];
+
+			TriangleMeshEdge edge;
+			edge.minVertex = Min(startVertex, endVertex);
+			edge.maxVertex = Max(startVertex, endVertex);
+			edge.triangleIndex = triangleIndex;
+			edge.edgeIndex = edgeIndex;
+			edges.push_back(edge);
+		}
+	}
+
+	std::sort(edges.begin(), edges.end(), [](const TriangleMeshEdge& a, const TriangleMeshEdge& b)
+	{
+		if (a.minVertex != b.minVertex) return a.minVertex < b.minVertex;
+		return a.maxVertex < b.maxVertex;
+	});
+
+	int numEdges = (int)edges.size();
+	int groupStart = 0;
+
+	while (groupStart < numEdges)
+	{
+		int groupEnd = groupStart + 1;
+		while (groupEnd < numEdges && edges[groupEnd].minVertex == edges[groupStart].minVertex && edges[groupEnd].maxVertex == edges[groupStart].maxVertex)
+		{
+			groupEnd++;
+		}
+
+		int groupSize = groupEnd - groupStart;
+		bool isActive = true; // Boundary and non-manifold edges stay active
+
+		if (groupSize == 2)
+		{
+			const TriangleMeshTriangle& triangleA = m_triangles[edges[groupStart].triangleIndex];
+			const TriangleMeshTriangle& triangleB = m_triangles[edges[groupStart + 1].triangleIndex];
+
+			// Vertex of B not on the shared edge, convex if it's below A's plane by more than a sliver of an angle
+			int oppositeVertex = triangleB.m_vertexIndices[(edges[groupStart + 1].edgeIndex + 2) % 3];
+			float distanceFromA = DotProduct(m_verticesLs[oppositeVertex] - m_verticesLs[edges[groupStart].minVertex], triangleA.m_normalLs);
+			bool isFlat = (DotProduct(triangleA.m_normalLs, triangleB.m_normalLs) > 0.9999f);
+
+			isActive = (distanceFromA < 0.f && !isFlat);
+		}
+
+		for (int i = groupStart; i < groupEnd; ++i)
+		{
+			TriangleMeshTriangle& triangle = m_triangles[edges[i].triangleIndex];
+
+			if (isActive)
+			{
+				triangle.m_activeEdgeFlags |= (uint8)(1 << edges[i].edgeIndex);
+			}
+			else
+			{
+				triangle.m_activeEdgeFlags &= (uint8)~(1 << edges[i].edgeIndex);
+			}
+		}
+
+		groupStart = groupEnd;
+	}
+}
+
+
+//-------------------------------------------------------------------------------------------------
+void TriangleMeshCollider::BuildBVH()
+{
+	m_nodes.clear();
+
+	if (m_triangles.size() == 0)
+		return;
+
+	m_nodes.reserve(2 * m_triangles.size());
+	m_nodes.push_back(TriangleMeshBVHNode());
+
+	int maxDepth = BuildBVHNode(0, 0, (int)m_triangles.size());
+	ASSERT_RECOVERABLE(maxDepth < 32, "Triangle mesh BVH ended up really deep?");
+}
+
+
+//-------------------------------------------------------------------------------------------------
+// Median split along the longest axis of the centroids, returns the depth of the subtree
+int TriangleMeshCollider::BuildBVHNode(int nodeIndex, int firstTriangle, int numTriangles)
+{
+	AABB3 bounds = AABB3(Vector3(FLT_MAX), Vector3(-FLT_MAX));
+	AABB3 centroidBounds = bounds;
+
+	for (int triangleIndex = firstTriangle; triangleIndex < firstTriangle + numTriangles; ++triangleIndex)
+	{
+		Triangle3 triangleLs = GetTriangleLs(triangleIndex);
+		StretchAABB3ToIncludePoint(bounds, triangleLs.m_a);
+		StretchAABB3ToIncludePoint(bounds, triangleLs.m_b);
+		StretchAABB3ToIncludePoint(bounds, triangleLs.m_c);
+		StretchAABB3ToIncludePoint(centroidBounds, (triangleLs.m_a + triangleLs.m_b + triangleLs.m_c) / 3.f);
+	}
+
+	m_nodes[nodeIndex].m_boundsLs = bounds;
+
+	if (numTriangles <= MAX_TRIANGLES_PER_LEAF)
+	{
+		m_nodes[nodeIndex].m_firstChildOrTriangle = firstTriangle;
+		m_nodes[nodeIndex].m_numTriangles = numTriangles;
+		return 1;
+	}
+
+	Vector3 centroidDimensions = centroidBounds.GetDimensions();
+	int splitAxis = 0;
+	if (centroidDimensions.y > centroidDimensions.data[splitAxis]) { splitAxis = 1; }
+	if (centroidDimensions.z > centroidDimensions.data[splitAxis]) { splitAxis = 2; }
+
+	int numLeft = numTriangles / 2;
+	std::vector<TriangleMeshTriangle>::iterator first = m_triangles.begin() + firstTriangle;
+	const std::vector<Vector3>& verticesLs = m_verticesLs;
+
+	std::nth_element(first, first + numLeft, first + numTriangles, [&verticesLs, splitAxis](const TriangleMeshTriangle& a, const TriangleMeshTriangle& b)
+	{
+		float aSum = verticesLs[a.m_vertexIndices[0]].data[splitAxis] + verticesLs[a.m_vertexIndices[1]].data[splitAxis] + verticesLs[a.m_vertexIndices[2]].data[splitAxis];
+		float bSum = verticesLs[b.m_vertexIndices[0]].data[splitAxis] + verticesLs[b.m_vertexIndices[1]].data[splitAxis] + verticesLs[b.m_vertexIndices[2]].data[splitAxis];
+		return aSum < bSum;
+	});
+
+	// Children are adjacent so only the left index needs to be stored
+	int leftIndex = (int)m_nodes.size();
+	m_nodes.push_back(TriangleMeshBVHNode());
+	m_nodes.push_back(TriangleMeshBVHNode());
+
+	m_nodes[nodeIndex].m_firstChildOrTriangle = leftIndex;
+	m_nodes[nodeIndex].m_numTriangles = 0;
+
+	int leftDepth = BuildBVHNode(leftIndex, firstTriangle, numLeft);
+	int rightDepth = BuildBVHNode(leftIndex + 1, firstTriangle + numLeft, numTriangles - numLeft);
+
+	return Max(leftDepth, rightDepth) + 1;
+}
+
+
+//-------------------------------------------------------------------------------------------------
+CompoundCollider::CompoundCollider(Entity* owningEntity)
+	: Collider(owningEntity, TYPE_INDEX)
+{
+}
+
+
+//-------------------------------------------------------------------------------------------------
+CompoundCollider::~CompoundCollider()
+{
+	HideDebug();
+
+	for (CompoundChild& child : m_children)
+	{
+		SAFE_DELETE(child.m_collider);
+		SAFE_DELETE(child.m_entity);
+	}
+
+	m_children.clear();
+}
+
+
+//-------------------------------------------------------------------------------------------------
+void CompoundCollider::ShowDebug()
+{
+	UpdateChildTransforms();
+
+	for (CompoundChild& child : m_children)
+	{
+		child.m_collider->ShowDebug();
+	}
+}
+
+
+//-------------------------------------------------------------------------------------------------
+void CompoundCollider::HideDebug()
+{
+	for (CompoundChild& child : m_children)
+	{
+		child.m_collider->HideDebug();
+	}
+
+	Collider::HideDebug();
+}
+
+
+//-------------------------------------------------------------------------------------------------
+BoundingVolumeSphere CompoundCollider::GetBoundsLs() const
+{
+	if (m_nodes.size() == 0)
+	{
+		return BoundingVolumeSphere(Sphere(Vector3::ZERO, 0.f));
+	}
+
+	return m_nodes[0].m_boundsLs;
+}
+
+
+//-------------------------------------------------------------------------------------------------
+// Planes are unbounded so they just check each child, everything else walks the tree with its bounds
+int CompoundCollider::GetChildrenOverlapping(const Collider* other, int* out_childIndices, int limit) const
+{
+	if (m_nodes.size() == 0 || limit <= 0)
+		return 0;
+
+	const Transform& transform = m_entity->transform;
+	int numFound = 0;
+
+	// Conservative for non-uniform scale, same as ConvexHullCollider::GetBoundingSphereWs()
+	Vector3 scale = transform.scale;
+	float maxScale = Max(Abs(scale.x), Max(Abs(scale.y), Abs(scale.z)));
+	float minScale = Min(Abs(scale.x), Min(Abs(scale.y), Abs(scale.z)));
+
+	if ((other->GetTypeIndex() == HalfSpaceCollider::TYPE_INDEX) || (other->GetTypeIndex() == PlaneCollider::TYPE_INDEX))
+	{
+		int numChildren = (int)m_children.size();
+		for (int childIndex = 0; childIndex < numChildren && numFound < limit; ++childIndex)
+		{
+			BoundingVolumeSphere childBoundsWs = BoundingVolumeSphere(Sphere(transform.TransformPosition(m_children[childIndex].m_boundsLs.m_center), m_children[childIndex].m_boundsLs.m_radius * maxScale));
+
+			bool overlaps = ((other->GetTypeIndex() == HalfSpaceCollider::TYPE_INDEX) ? childBoundsWs.Overlaps(ColliderCast<HalfSpaceCollider>(other)) : childBoundsWs.Overlaps(ColliderCast<PlaneCollider>(other)));
+			if (overlaps)
+			{
+				out_childIndices[numFound++] = childIndex;
+			}
+		}
+
+		return numFound;
+	}
+
+	BoundingVolumeSphere otherBoundsWs = MakeBoundingSphereForCollider(other);
+	BoundingVolumeSphere otherBoundsLs = BoundingVolumeSphere(Sphere(transform.InverseTransformPosition(otherBoundsWs.m_center), otherBoundsWs.m_radius / minScale));
+
+	int nodeStack[2 * MAX_CHILDREN];
+	int stackSize = 0;
+	nodeStack[stackSize++] = 0;
+
+	while (stackSize > 0 && numFound < limit)
+	{
+		const CompoundColliderNode& node = m_nodes[nodeStack[--stackSize]];
+
+		if (!node.m_boundsLs.Overlaps(otherBoundsLs))
+			continue;
+
+		if (node.m_isLeaf)
+		{
+			out_childIndices[numFound++] = node.m_leftNodeOrChild;
+		}
+		else
+		{
+			nodeStack[stackSize++] = node.m_leftNodeOrChild + 1;
+			nodeStack[stackSize++] = node.m_leftNodeOrChild;
+		}
+	}
+
+	return numFound;
+}
+
+
+//-------------------------------------------------------------------------------------------------
+// Children's entities aren't parented to the compound's since colliders read their scale directly from their
+// own transform, so put them in world space instead
+void CompoundCollider::UpdateChildTransforms()
+{
+	const Transform& transform = m_entity->transform;
+	Quaternion worldRotation = transform.GetWorldRotation();
+
+	for (CompoundChild& child : m_children)
+	{
+		Transform& childTransform = child.m_entity->transform;
+		childTransform.position = transform.TransformPosition(child.m_localTransform.position);
+		childTransform.rotation = worldRotation * child.m_localTransform.rotation;
+		childTransform.scale = transform.scale * child.m_localTransform.scale;
+
+		child.m_entity->rigidBody = m_entity->rigidBody;
+	}
+}
+
+
+//-------------------------------------------------------------------------------------------------
+Entity* CompoundCollider::CreateChildEntity(const Transform& localTransform)
+{
+	Entity* childEntity = new Entity();
+	childEntity->transform = localTransform;
+
+	return childEntity;
+}
+
+
+//-------------------------------------------------------------------------------------------------
+void CompoundCollider::AddChildInternal(Collider* child, Entity* childEntity, const Transform& localTransform)
+{
+	ASSERT_OR_DIE(!child->IsOfType<CompoundCollider>(), "Compound colliders can't be nested!");
+	ASSERT_OR_DIE(!child->IsOfType<HalfSpaceCollider>() && !child->IsOfType<PlaneCollider>(), "Compound colliders can't have unbounded children!");
+	ASSERT_OR_DIE((int)m_children.size() < MAX_CHILDREN, "Too many children in compound collider!");
+
+	childEntity->collider = child;
+	child->m_friction = m_friction;
+	child->m_restitution = m_restitution;
+
+	// The child entity is still in the compound's space at this point, so this is the local bounds
+	CompoundChild compoundChild;
+	compoundChild.m_collider = child;
+	compoundChild.m_entity = childEntity;
+	compoundChild.m_localTransform = localTransform;
+	compoundChild.m_boundsLs = MakeBoundingSphereForCollider(child);
+
+	m_children.push_back(compoundChild);
+	BuildTree();
+
+	if (m_entity != nullptr)
+	{
+		UpdateChildTransforms();
+	}
+}
+
+
+//-------------------------------------------------------------------------------------------------
+void CompoundCollider::BuildTree()
+{
+	m_nodes.clear();
+
+	int numChildren = (int)m_children.size();
+	if (numChildren == 0)
+		return;
+
+	int childIndices[MAX_CHILDREN];
+	for (int childIndex = 0; childIndex < numChildren; ++childIndex)
+	{
+		childIndices[childIndex] = childIndex;
+	}
+
+	m_nodes.reserve(2 * numChildren - 1);
+	m_nodes.push_back(CompoundColliderNode());
+	BuildTreeNode(0, childIndices, numChildren);
+}
+
+
+//-------------------------------------------------------------------------------------------------
+// Median split along the longest axis of the child centers
+void CompoundCollider::BuildTreeNode(int nodeIndex, int* childIndices, int numChildren)
+{
+	if (numChildren == 1)
+	{
+		m_nodes[nodeIndex].m_boundsLs = m_children[childIndices[0]].m_boundsLs;
+		m_nodes[nodeIndex].m_leftNodeOrChild = childIndices[0];
+		m_nodes[nodeIndex].m_isLeaf = true;
+		return;
+	}
+
+	Vector3 mins = Vector3(FLT_MAX);
+	Vector3 maxs = Vector3(-FLT_MAX);
+	for (int i = 0; i < numChildren; ++i)
+	{
+		Vector3 center = m_children[childIndices[i]].m_boundsLs.m_center;
+		mins = Vector3(Min(mins.x, center.x), Min(mins.y, center.y), Min(mins.z, center.z));
+		maxs = Vector3(Max(maxs.x, center.x), Max(maxs.y, center.y), Max(maxs.z, center.z));
+	}
+
+	Vector3 extents = maxs - mins;
+	int splitAxis = 0;
+	if (extents.y > extents.data[splitAxis]) { splitAxis = 1; }
+	if (extents.z > extents.data[splitAxis]) { splitAxis = 2; }
+
+	int numLeft = numChildren / 2;
+	const std::vector<CompoundChild>& children = m_children;
+	std::nth_element(childIndices, childIndices + numLeft, childIndices + numChildren, [&children, splitAxis](int a, int b)
+	{
+		return children[a].m_boundsLs.m_center.data[splitAxis] < children[b].m_boundsLs.m_center.data[splitAxis];
+	});
+
+	int leftIndex = (int)m_nodes.size();
+	m_nodes.push_back(CompoundColliderNode());
+	m_nodes.push_back(CompoundColliderNode());
+
+	BuildTreeNode(leftIndex, childIndices, numLeft);
+	BuildTreeNode(leftIndex + 1, childIndices + numLeft, numChildren - numLeft);
 
-	return polyWs; // TODO: Don't return this
+	m_nodes[nodeIndex].m_boundsLs = BoundingVolumeSphere(m_nodes[leftIndex].m_boundsLs, m_nodes[leftIndex + 1].m_boundsLs);
+	m_nodes[nodeIndex].m_leftNodeOrChild = leftIndex;
+	m_nodes[nodeIndex].m_isLeaf = false;
 }
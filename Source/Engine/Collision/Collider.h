@@ -8,25 +8,67 @@
 ///--------------------------------------------------------------------------------------------------------------------------------------------------
 /// INCLUDES
 ///--------------------------------------------------------------------------------------------------------------------------------------------------
+#include "Engine/Collision/BoundingVolumeHierarchy/BoundingVolume.h"
+#include "Engine/Collision/ColliderPool.h"
+#include "Engine/Collision/ConvexHullShape.h"
 #include "Engine/Core/EngineCommon.h"
 #include "Engine/Math/Capsule3.h"
 #include "Engine/Math/Cylinder.h"
+#include "Engine/Math/IntVector3.h"
 #include "Engine/Math/OBB3.h"
 #include "Engine/Math/Polyhedron.h"
 #include "Engine/Math/Sphere.h"
 #include "Engine/Math/Transform.h"
+#include "Engine/Math/Triangle3.h"
 #include "Engine/Render/Debug/DebugRenderObject.h"
+#include <vector>
 
 ///--------------------------------------------------------------------------------------------------------------------------------------------------
 /// DEFINES
 ///--------------------------------------------------------------------------------------------------------------------------------------------------
+#define MAX_COLLISION_LAYERS (32)
+#define COLLISION_LAYER_MASK_ALL (0xFFFFFFFF)
 
 ///--------------------------------------------------------------------------------------------------------------------------------------------------
 /// ENUMS, TYPEDEFS, STRUCTS, FORWARD DECLARATIONS
 ///--------------------------------------------------------------------------------------------------------------------------------------------------
 class Entity;
+class MeshBuilder;
 class RigidBody;
 
+// Triangle in a TriangleMeshCollider, indexing into the collider's welded vertices
+struct TriangleMeshTriangle
+{
+	int		m_vertexIndices[3];
+	Vector3 m_normalLs;
+	uint8	m_activeEdgeFlags = 0; // Bit i set if the edge from vertex i to vertex (i + 1) % 3 can produce contacts, internal edges can't
+};
+
+// One shape in a CompoundCollider, placed relative to the compound's entity
+struct CompoundChild
+{
+	Collider*				m_collider = nullptr;
+	Entity*					m_entity = nullptr; // Owned by the compound, kept in world space and shares the compound's rigidbody
+	Transform				m_localTransform;
+	BoundingVolumeSphere	m_boundsLs; // In the compound's space
+};
+
+// Node in a CompoundCollider's bounds tree, leaves hold exactly one child
+struct CompoundColliderNode
+{
+	BoundingVolumeSphere	m_boundsLs;
+	int						m_leftNodeOrChild = 0; // Index of the left node (right is the next one) if internal, otherwise the child index
+	bool					m_isLeaf = false;
+};
+
+// Flattened BVH node, children of an internal node are always adjacent
+struct TriangleMeshBVHNode
+{
+	AABB3	m_boundsLs;
+	int		m_firstChildOrTriangle = 0; // Index of the left child if internal, otherwise the first triangle
+	int		m_numTriangles = 0; // Zero for internal nodes
+};
+
 ///--------------------------------------------------------------------------------------------------------------------------------------------------
 /// GLOBALS AND STATICS
 ///--------------------------------------------------------------------------------------------------------------------------------------------------
@@ -42,12 +84,15 @@ public:
 	//-----Public Methods-----
 	RTTI_BASE_CLASS(Collider);
 
-	Collider() {}
-	Collider(Entity* owningEntity);
+	Collider(int typeIndex) : m_typeIndex(typeIndex), m_isPooled(ColliderPool::ClaimAllocation(this)) {}
+	Collider(Entity* owningEntity, int typeIndex);
+	virtual ~Collider() {}
 
 	virtual void	ShowDebug() = 0;
 	virtual void	HideDebug();
-	virtual int		GetTypeIndex() const = 0;
+	int				GetTypeIndex() const { return m_typeIndex; } // Not virtual, narrowphase dispatch reads this for every pair
+	ColliderHandle	GetHandle() const { return ColliderPool::GetHandle(this); }
+	bool			IsPooled() const { return m_isPooled; } // False for colliders on the stack, held by value, or too big for their type's slots
 
 	bool			OwnerHasRigidBody() const;
 	RigidBody*		GetOwnerRigidBody() const;
@@ -57,9 +102,12 @@ public:
 	//-----Public Data-----
 
 	Entity*					m_entity = nullptr;	// This entity doesn't need a rigidbody! It just means do the collision detection, but no correction
+	bool					m_isTrigger = false; // If true, this collider only reports overlap enter/stay/exit events and never generates contacts
 	bool					m_ignoreFriction = false; // If true, friction won't be calculated regardless of what the value of friction is on either collider.
 	float					m_friction = 0.3f;
 	float					m_restitution = 0.f;
+	uint32					m_collisionLayer = 0; // Index of the layer this collider is on, in [0, MAX_COLLISION_LAYERS)
+	uint32					m_collisionMask = COLLISION_LAYER_MASK_ALL; // One bit per layer this collider is allowed to collide with
 
 
 protected:
@@ -67,6 +115,8 @@ protected:
 
 	static const DebugRenderOptions DEFAULT_COLLIDER_RENDER_OPTIONS;
 	DebugRenderObjectHandle m_debugRenderHandle = INVALID_DEBUG_RENDER_OBJECT_HANDLE;
+	int						m_typeIndex = -1; // The concrete class's TYPE_INDEX
+	bool					m_isPooled = false; // Only pooled colliders have a slot header in front of them
 
 };
 
@@ -78,8 +128,8 @@ class TypedCollider : public Collider
 public:
 	//-----Public Methods-----
 
-	TypedCollider() {}
-	TypedCollider(Entity* owningEntity, const T& dataLs);
+	TypedCollider(int typeIndex) : Collider(typeIndex) {}
+	TypedCollider(Entity* owningEntity, const T& dataLs, int typeIndex);
 
 	virtual T GetDataInWorldSpace() const = 0;
 
@@ -94,8 +144,8 @@ protected:
 
 //-------------------------------------------------------------------------------------------------
 template <typename T>
-TypedCollider<T>::TypedCollider(Entity* owningEntity, const T& dataLs)
-	: Collider(owningEntity)
+TypedCollider<T>::TypedCollider(Entity* owningEntity, const T& dataLs, int typeIndex)
+	: Collider(owningEntity, typeIndex)
 	, m_dataLs(dataLs)
 {
 }
@@ -107,13 +157,13 @@ class HalfSpaceCollider : public TypedCollider<Plane3>
 public:
 	//-----Public Methods-----
 	RTTI_DERIVED_CLASS(HalfSpaceCollider);
+	COLLIDER_POOLED_CLASS(HalfSpaceCollider);
 
-	HalfSpaceCollider() {}
+	HalfSpaceCollider() : TypedCollider(TYPE_INDEX) {}
 	HalfSpaceCollider(Entity* owningEntity, const Plane3& planeLs);
 
 	virtual void	ShowDebug() override;
 	virtual Plane3	GetDataInWorldSpace() const override;
-	virtual int		GetTypeIndex() const { return TYPE_INDEX; }
 
 
 public:
@@ -134,13 +184,13 @@ class PlaneCollider : public TypedCollider<Plane3>
 public:
 	//-----Public Methods-----
 	RTTI_DERIVED_CLASS(PlaneCollider);
+	COLLIDER_POOLED_CLASS(PlaneCollider);
 
-	PlaneCollider() {}
+	PlaneCollider() : TypedCollider(TYPE_INDEX) {}
 	PlaneCollider(Entity* owningEntity, const Plane3& planeLs);
 
 	virtual void	ShowDebug() override;
 	virtual Plane3	GetDataInWorldSpace() const override;
-	virtual int		GetTypeIndex() const { return TYPE_INDEX; }
 
 
 public:
@@ -161,13 +211,13 @@ class SphereCollider : public TypedCollider<Sphere>
 public:
 	//-----Public Methods-----
 	RTTI_DERIVED_CLASS(SphereCollider);
+	COLLIDER_POOLED_CLASS(SphereCollider);
 
-	SphereCollider() {}
+	SphereCollider() : TypedCollider(TYPE_INDEX) {}
 	SphereCollider(Entity* owningEntity, const Sphere& sphereLs);
 
 	virtual void		ShowDebug() override;
 	virtual Sphere	GetDataInWorldSpace() const override;
-	virtual int			GetTypeIndex() const { return TYPE_INDEX; }
 
 
 public:
@@ -188,13 +238,13 @@ class CapsuleCollider : public TypedCollider<Capsule3>
 public:
 	//-----Public Methods-----
 	RTTI_DERIVED_CLASS(CapsuleCollider);
+	COLLIDER_POOLED_CLASS(CapsuleCollider);
 
-	CapsuleCollider() {}
+	CapsuleCollider() : TypedCollider(TYPE_INDEX) {}
 	CapsuleCollider(Entity* owningEntity, const Capsule3& capsuleLs);
 
 	virtual void		ShowDebug() override;
 	virtual Capsule3	GetDataInWorldSpace() const override;
-	virtual int			GetTypeIndex() const { return TYPE_INDEX; }
 
 
 public:
@@ -215,13 +265,13 @@ class BoxCollider : public TypedCollider<OBB3>
 public:
 	//-----Public Methods-----
 	RTTI_DERIVED_CLASS(BoxCollider);
+	COLLIDER_POOLED_CLASS(BoxCollider);
 
-	BoxCollider() {}
+	BoxCollider() : TypedCollider(TYPE_INDEX) {}
 	BoxCollider(Entity* owningEntity, const OBB3& boxLs);
 
 	virtual void	ShowDebug() override;
 	virtual OBB3	GetDataInWorldSpace() const override;
-	virtual int		GetTypeIndex() const { return TYPE_INDEX; }
 
 
 public:
@@ -242,13 +292,13 @@ class CylinderCollider : public TypedCollider<Cylinder>
 public:
 	//-----Public Methods-----
 	RTTI_DERIVED_CLASS(CylinderCollider);
+	COLLIDER_POOLED_CLASS(CylinderCollider);
 
-	CylinderCollider() {}
+	CylinderCollider() : TypedCollider(TYPE_INDEX) {}
 	CylinderCollider(Entity* owningEntity, const Cylinder& cylinderLs);
 
 	virtual void		ShowDebug() override;
 	virtual Cylinder	GetDataInWorldSpace() const override;
-	virtual int			GetTypeIndex() const { return TYPE_INDEX; }
 
 
 public:
@@ -264,18 +314,24 @@ private:
 
 
 //-------------------------------------------------------------------------------------------------
-class ConvexHullCollider : public TypedCollider<Polyhedron>
+// The hull itself lives in a shared ConvexHullShape, so instances of the same shape only cost a pointer
+class ConvexHullCollider : public Collider
 {
 public:
 	//-----Public Methods-----
 	RTTI_DERIVED_CLASS(ConvexHullCollider);
+	COLLIDER_POOLED_CLASS(ConvexHullCollider);
 
-	ConvexHullCollider() {}
-	ConvexHullCollider(Entity* owningEntity, const Polyhedron& hullLs);
+	ConvexHullCollider() : Collider(TYPE_INDEX) {}
+	ConvexHullCollider(Entity* owningEntity, const Polyhedron& hullLs); // Makes a shape only this collider uses
+	ConvexHullCollider(Entity* owningEntity, const R<ConvexHullShape>& shape);
 
-	virtual void		ShowDebug() override;
-	virtual Polyhedron	GetDataInWorldSpace() const override;
-	virtual int			GetTypeIndex() const { return TYPE_INDEX; }
+	virtual void				ShowDebug() override;
+	Polyhedron					GetDataInWorldSpace() const;
+	void						GetDataInWorldSpace(Polyhedron& out_polyWs) const; // Reuses out_polyWs's storage
+	const Polyhedron&			GetHullLs() const { return m_shape->GetHullLs(); }
+	const R<ConvexHullShape>&	GetShape() const { return m_shape; }
+	Sphere						GetBoundingSphereWs() const;
 
 
 public:
@@ -287,9 +343,188 @@ public:
 private:
 	//-----Private Data-----
 
+	R<ConvexHullShape> m_shape;
+
+};
+
+
+//-------------------------------------------------------------------------------------------------
+// Static grid of solid cells, one bit each, collided against directly instead of being split into boxes
+// Cell (0, 0, 0) has its min corner at the local origin, matching the meshes QEFLoader builds
+// The owning entity's transform should have uniform scale
+class VoxelGridCollider : public Collider
+{
+public:
+	//-----Public Methods-----
+	RTTI_DERIVED_CLASS(VoxelGridCollider);
+	COLLIDER_POOLED_CLASS(VoxelGridCollider);
+
+	VoxelGridCollider() : Collider(TYPE_INDEX) {}
+	VoxelGridCollider(Entity* owningEntity, const IntVector3& dimensions, float cellSize);
+
+	virtual void	ShowDebug() override;
+
+	void			SetCellOccupied(const IntVector3& cellCoords, bool isOccupied);
+	bool			IsCellOccupied(int x, int y, int z) const; // Out of bounds cells are empty
+	bool			IsCellOccupied(const IntVector3& cellCoords) const { return IsCellOccupied(cellCoords.x, cellCoords.y, cellCoords.z); }
+	IntVector3		GetDimensions() const { return m_dimensions; }
+	float			GetCellSize() const { return m_cellSize; }
+	int				GetNumOccupiedCells() const { return m_numOccupiedCells; }
+	AABB3			GetCellBoundsLs(const IntVector3& cellCoords) const;
+	AABB3			GetBoundsLs() const;
+	bool			GetCellRangeOverlapping(const AABB3& boundsLs, IntVector3& out_minCoords, IntVector3& out_maxCoords) const; // Inclusive, false if entirely outside the grid
+
+
+public:
+	//-----Public Data-----
+
+	static constexpr int TYPE_INDEX = 7;
+
+
+private:
+	//-----Private Methods-----
+
+	int				GetCellIndex(int x, int y, int z) const { return (m_dimensions.x * m_dimensions.z * y) + (m_dimensions.x * z) + x; } // Same order QEF files use
+
+
+private:
+	//-----Private Data-----
+
+	IntVector3				m_dimensions = IntVector3::ZERO;
+	float					m_cellSize = 1.f;
+	std::vector<uint32>		m_occupancy; // One bit per cell, 32 cells per word
+	int						m_numOccupiedCells = 0;
+
+};
+
+
+//-------------------------------------------------------------------------------------------------
+// Arbitrary triangle soup for static level geometry, with its own BVH over the triangles
+// Triangles are one-sided, things behind a face won't be pushed through it
+// The owning entity's transform should have uniform scale
+class TriangleMeshCollider : public Collider
+{
+public:
+	//-----Public Methods-----
+	RTTI_DERIVED_CLASS(TriangleMeshCollider);
+	COLLIDER_POOLED_CLASS(TriangleMeshCollider);
+
+	TriangleMeshCollider() : Collider(TYPE_INDEX) {}
+	TriangleMeshCollider(Entity* owningEntity, const MeshBuilder& mb); // Builder must have finished building a triangle list
+	TriangleMeshCollider(Entity* owningEntity, const std::vector<Vector3>& positionsLs, const std::vector<uint32>& indices);
+
+	virtual void				ShowDebug() override;
+
+	int							GetNumTriangles() const { return (int)m_triangles.size(); }
+	const TriangleMeshTriangle& GetTriangle(int triangleIndex) const { return m_triangles[triangleIndex]; }
+	Triangle3					GetTriangleLs(int triangleIndex) const;
+	Triangle3					GetTriangleWs(int triangleIndex) const;
+	AABB3						GetBoundsLs() const;
+	void						GetTrianglesOverlapping(const AABB3& boundsLs, std::vector<int>& out_triangleIndices) const; // Clears the list first
+
+
+public:
+	//-----Public Data-----
+
+	static constexpr int TYPE_INDEX = 8;
+	static constexpr int MAX_TRIANGLES_PER_LEAF = 4;
+
+
+private:
+	//-----Private Methods-----
+
+	void						BuildFromTriangleList(const std::vector<Vector3>& positionsLs, const std::vector<uint32>& indices);
+	void						WeldVertices(const std::vector<Vector3>& positionsLs, std::vector<int>& out_remap);
+	void						ComputeActiveEdges();
+	void						BuildBVH();
+	int							BuildBVHNode(int nodeIndex, int firstTriangle, int numTriangles);
+
+
+private:
+	//-----Private Data-----
+
+	std::vector<Vector3>				m_verticesLs;
+	std::vector<TriangleMeshTriangle>	m_triangles; // Sorted so each leaf's triangles are contiguous
+	std::vector<TriangleMeshBVHNode>	m_nodes; // Root is index 0
+
 };
 
 
+//-------------------------------------------------------------------------------------------------
+// Several shapes acting as one collider, so multi-part objects are a single leaf in the scene's broadphase
+// Children are only expanded when the compound's bounds overlap something, using a small tree over the child bounds
+// Contacts from children use the compound's rigidbody, but the child's own friction and restitution
+class CompoundCollider : public Collider
+{
+public:
+	//-----Public Methods-----
+	RTTI_DERIVED_CLASS(CompoundCollider);
+	COLLIDER_POOLED_CLASS(CompoundCollider);
+
+	CompoundCollider() : Collider(TYPE_INDEX) {}
+	CompoundCollider(Entity* owningEntity);
+	virtual ~CompoundCollider();
+
+	virtual void			ShowDebug() override;
+	virtual void			HideDebug() override;
+
+	template <typename ColliderType, typename ShapeType>
+	ColliderType*			AddChild(const ShapeType& shapeLs, const Transform& localTransform); // Shape is in the child's space, the compound owns the result
+
+	int						GetNumChildren() const { return (int)m_children.size(); }
+	const Collider*			GetChild(int childIndex) const { return m_children[childIndex].m_collider; }
+	BoundingVolumeSphere	GetBoundsLs() const;
+	int						GetChildrenOverlapping(const Collider* other, int* out_childIndices, int limit) const;
+	void					UpdateChildTransforms(); // The CollisionScene calls this once a step, call it yourself after moving the compound to use its children before the next step
+
+
+public:
+	//-----Public Data-----
+
+	static constexpr int TYPE_INDEX = 9;
+	static constexpr int MAX_CHILDREN = 64;
+
+
+private:
+	//-----Private Methods-----
+
+	Entity*					CreateChildEntity(const Transform& localTransform);
+	void					AddChildInternal(Collider* child, Entity* childEntity, const Transform& localTransform);
+	void					BuildTree();
+	void					BuildTreeNode(int nodeIndex, int* childIndices, int numChildren);
+
+
+private:
+	//-----Private Data-----
+
+	std::vector<CompoundChild>			m_children;
+	std::vector<CompoundColliderNode>	m_nodes; // Root is index 0
+
+};
+
+
+//-------------------------------------------------------------------------------------------------
+template <typename ColliderType, typename ShapeType>
+ColliderType* CompoundCollider::AddChild(const ShapeType& shapeLs, const Transform& localTransform)
+{
+	Entity* childEntity = CreateChildEntity(localTransform);
+	ColliderType* child = new ColliderType(childEntity, shapeLs);
+	AddChildInternal(child, childEntity, localTransform);
+
+	return child;
+}
+
+
 ///--------------------------------------------------------------------------------------------------------------------------------------------------
 /// C FUNCTIONS
 ///--------------------------------------------------------------------------------------------------------------------------------------------------
+
+//-------------------------------------------------------------------------------------------------
+// For code that already knows the type from GetTypeIndex(), like the collision matrix, skipping GetAsType()'s virtual lookup
+template <typename ColliderType>
+const ColliderType* ColliderCast(const Collider* collider)
+{
+	ASSERT_OR_DIE(collider->GetTypeIndex() == ColliderType::TYPE_INDEX, "Collider cast to the wrong type!");
+	return static_cast<const ColliderType*>(collider);
+}
+
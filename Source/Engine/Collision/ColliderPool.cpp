@@ -0,0 +1,243 @@
+///--------------------------------------------------------------------------------------------------------------------------------------------------
+/// Author: Andrew Chase
+/// Date Created: October 18th, 2026
+/// Description:
+///--------------------------------------------------------------------------------------------------------------------------------------------------
+
+///--------------------------------------------------------------------------------------------------------------------------------------------------
+/// INCLUDES
+///--------------------------------------------------------------------------------------------------------------------------------------------------
+#include "Engine/Collision/Collider.h"
+#include "Engine/Collision/ColliderPool.h"
+#include "Engine/Core/EngineCommon.h"
+#include <new>
+
+///--------------------------------------------------------------------------------------------------------------------------------------------------
+/// DEFINES
+///--------------------------------------------------------------------------------------------------------------------------------------------------
+#define SLOT_HEADER_SIZE (16) // Keeps the collider after it 16-byte aligned
+
+///--------------------------------------------------------------------------------------------------------------------------------------------------
+/// ENUMS, TYPEDEFS, STRUCTS, FORWARD DECLARATIONS
+///--------------------------------------------------------------------------------------------------------------------------------------------------
+
+// Sits right before every collider allocated through a pool, including the heap fallback
+struct ColliderSlotHeader
+{
+	int		m_typeIndex = -1; // -1 for heap allocations
+	int		m_slotIndex = -1;
+	uint32	m_generation = 0; // Bumped on every free, so old handles to the slot go stale
+	uint32	m_isLive = 0;
+};
+
+static_assert(sizeof(ColliderSlotHeader) <= SLOT_HEADER_SIZE, "Collider slot header doesn't fit!");
+
+///--------------------------------------------------------------------------------------------------------------------------------------------------
+/// GLOBALS AND STATICS
+///--------------------------------------------------------------------------------------------------------------------------------------------------
+static thread_local const void* s_unclaimedPoolSlot = nullptr; // Set by Allocate(), taken by the collider constructed there
+
+///--------------------------------------------------------------------------------------------------------------------------------------------------
+/// C FUNCTIONS
+///--------------------------------------------------------------------------------------------------------------------------------------------------
+
+//-------------------------------------------------------------------------------------------------
+static ColliderSlotHeader* GetSlotHeader(const void* memory)
+{
+	return reinterpret_cast<ColliderSlotHeader*>((uint8*)memory - SLOT_HEADER_SIZE);
+}
+
+
+//-------------------------------------------------------------------------------------------------
+// Colliders have a single inheritance chain rooted at Collider, so the collider starts right at the slot's storage
+static Collider* GetColliderFromSlot(uint8* slot)
+{
+	return reinterpret_cast<Collider*>(slot + SLOT_HEADER_SIZE);
+}
+
+///--------------------------------------------------------------------------------------------------------------------------------------------------
+/// CLASS IMPLEMENTATIONS
+///--------------------------------------------------------------------------------------------------------------------------------------------------
+
+//-------------------------------------------------------------------------------------------------
+void* ColliderPool::Allocate(int typeIndex, size_t classSize, size_t requestedSize)
+{
+	if (typeIndex >= 0 && typeIndex < NUM_COLLIDER_TYPES && requestedSize == classSize)
+	{
+		void* memory = GetPool(typeIndex).AllocateSlot(typeIndex, classSize);
+		s_unclaimedPoolSlot = memory;
+
+		return memory;
+	}
+
+	// Subclasses of a pooled class don't fit its slots
+	uint8* memory = (uint8*)::operator new(SLOT_HEADER_SIZE + requestedSize);
+	new (memory) ColliderSlotHeader();
+
+	return memory + SLOT_HEADER_SIZE;
+}
+
+
+//-------------------------------------------------------------------------------------------------
+void ColliderPool::Free(void* memory)
+{
+	if (memory == nullptr)
+		return;
+
+	ColliderSlotHeader* header = GetSlotHeader(memory);
+
+	if (header->m_typeIndex < 0)
+	{
+		::operator delete(header);
+	}
+	else
+	{
+		GetPool(header->m_typeIndex).FreeSlot((uint8*)header);
+	}
+}
+
+
+//-------------------------------------------------------------------------------------------------
+ColliderHandle ColliderPool::GetHandle(const Collider* collider)
+{
+	ColliderHandle handle;
+
+	// Colliders that weren't allocated from a slot have no header to read
+	if (collider != nullptr && collider->IsPooled())
+	{
+		const ColliderSlotHeader* header = GetSlotHeader(collider);
+
+		if (header->m_typeIndex >= 0)
+		{
+			handle.m_typeIndex = header->m_typeIndex;
+			handle.m_slotIndex = header->m_slotIndex;
+			handle.m_generation = header->m_generation;
+		}
+	}
+
+	return handle;
+}
+
+
+//-------------------------------------------------------------------------------------------------
+Collider* ColliderPool::GetCollider(const ColliderHandle& handle)
+{
+	if (!handle.IsValid())
+		return nullptr;
+
+	ColliderPool& pool = GetPool(handle.m_typeIndex);
+	std::lock_guard<std::mutex> lock(pool.m_mutex);
+
+	if (handle.m_slotIndex >= pool.m_numSlots)
+		return nullptr;
+
+	uint8* slot = pool.GetSlot(handle.m_slotIndex);
+	const ColliderSlotHeader* header = reinterpret_cast<const ColliderSlotHeader*>(slot);
+
+	if (header->m_isLive == 0 || header->m_generation != handle.m_generation)
+		return nullptr;
+
+	return GetColliderFromSlot(slot);
+}
+
+
+//-------------------------------------------------------------------------------------------------
+int ColliderPool::GetNumLiveColliders(int typeIndex)
+{
+	return GetPool(typeIndex).m_numLiveColliders;
+}
+
+
+//-------------------------------------------------------------------------------------------------
+// The pooled operator new returns straight into the collider's constructors on the same thread, so the
+// Collider base constructor sees its own slot here. Anything else (stack, members, heap fallback) doesn't match
+bool ColliderPool::ClaimAllocation(const Collider* collider)
+{
+	if (s_unclaimedPoolSlot != collider)
+		return false;
+
+	s_unclaimedPoolSlot = nullptr;
+	return true;
+}
+
+
+//-------------------------------------------------------------------------------------------------
+ColliderPool::~ColliderPool()
+{
+	for (uint8* chunk : m_chunks)
+	{
+		::operator delete(chunk);
+	}
+
+	m_chunks.clear();
+}
+
+
+//-------------------------------------------------------------------------------------------------
+ColliderPool& ColliderPool::GetPool(int typeIndex)
+{
+	static ColliderPool s_pools[NUM_COLLIDER_TYPES];
+
+	ASSERT_OR_DIE(typeIndex >= 0 && typeIndex < NUM_COLLIDER_TYPES, "Invalid collider type index!");
+	return s_pools[typeIndex];
+}
+
+
+//-------------------------------------------------------------------------------------------------
+uint8* ColliderPool::GetSlot(int slotIndex) const
+{
+	return m_chunks[slotIndex / SLOTS_PER_CHUNK] + (slotIndex % SLOTS_PER_CHUNK) * m_slotStride;
+}
+
+
+//-------------------------------------------------------------------------------------------------
+void* ColliderPool::AllocateSlot(int typeIndex, size_t classSize)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	size_t slotStride = ((SLOT_HEADER_SIZE + classSize + 15) / 16) * 16;
+	ASSERT_OR_DIE(m_slotStride == 0 || m_slotStride == slotStride, "Two collider classes share a type index!");
+	m_slotStride = slotStride;
+
+	if (m_freeSlots.size() == 0)
+	{
+		uint8* chunk = (uint8*)::operator new(m_slotStride * SLOTS_PER_CHUNK);
+		m_chunks.push_back(chunk);
+
+		// Pushed backwards so the chunk fills front to back
+		for (int chunkSlotIndex = SLOTS_PER_CHUNK - 1; chunkSlotIndex >= 0; --chunkSlotIndex)
+		{
+			ColliderSlotHeader* header = new (chunk + chunkSlotIndex * m_slotStride) ColliderSlotHeader();
+			header->m_typeIndex = typeIndex;
+			header->m_slotIndex = m_numSlots + chunkSlotIndex;
+
+			m_freeSlots.push_back(header->m_slotIndex);
+		}
+
+		m_numSlots += SLOTS_PER_CHUNK;
+	}
+
+	int slotIndex = m_freeSlots.back();
+	m_freeSlots.pop_back();
+
+	uint8* slot = GetSlot(slotIndex);
+	reinterpret_cast<ColliderSlotHeader*>(slot)->m_isLive = 1;
+	m_numLiveColliders++;
+
+	return slot + SLOT_HEADER_SIZE;
+}
+
+
+//-------------------------------------------------------------------------------------------------
+void ColliderPool::FreeSlot(uint8* slot)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	ColliderSlotHeader* header = reinterpret_cast<ColliderSlotHeader*>(slot);
+	ASSERT_OR_DIE(header->m_isLive != 0, "Collider freed twice!");
+
+	header->m_isLive = 0;
+	header->m_generation++;
+	m_freeSlots.push_back(header->m_slotIndex);
+	m_numLiveColliders--;
+}
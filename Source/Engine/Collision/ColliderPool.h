@@ -0,0 +1,104 @@
+///--------------------------------------------------------------------------------------------------------------------------------------------------
+/// Author: Andrew Chase
+/// Date Created: October 18th, 2026
+/// Description: Per-type contiguous storage for colliders, with handles that stay valid across other colliders being freed
+///--------------------------------------------------------------------------------------------------------------------------------------------------
+#pragma once
+
+///--------------------------------------------------------------------------------------------------------------------------------------------------
+/// INCLUDES
+///--------------------------------------------------------------------------------------------------------------------------------------------------
+#include "Engine/Collision/CollisionDetector.h"
+#include "Engine/Core/EngineCommon.h"
+#include <mutex>
+#include <vector>
+
+///--------------------------------------------------------------------------------------------------------------------------------------------------
+/// DEFINES
+///--------------------------------------------------------------------------------------------------------------------------------------------------
+
+// Put in each concrete collider class so new/delete go through that type's pool
+// Subclasses of a pooled class with a different size fall back to the heap
+#define COLLIDER_POOLED_CLASS(CLASS)																		\
+static void* operator new(size_t size) { return ColliderPool::Allocate(CLASS::TYPE_INDEX, sizeof(CLASS), size); }	\
+static void operator delete(void* memory) { ColliderPool::Free(memory); }
+
+///--------------------------------------------------------------------------------------------------------------------------------------------------
+/// ENUMS, TYPEDEFS, STRUCTS, FORWARD DECLARATIONS
+///--------------------------------------------------------------------------------------------------------------------------------------------------
+class Collider;
+
+// Identifies a collider by its pool slot, going stale (rather than dangling) once that collider is deleted
+struct ColliderHandle
+{
+	int		m_typeIndex = -1;
+	int		m_slotIndex = -1;
+	uint32	m_generation = 0;
+
+	bool IsValid() const { return m_typeIndex >= 0; }
+	bool operator==(const ColliderHandle& other) const { return m_typeIndex == other.m_typeIndex && m_slotIndex == other.m_slotIndex && m_generation == other.m_generation; }
+	bool operator!=(const ColliderHandle& other) const { return !(*this == other); }
+};
+
+///--------------------------------------------------------------------------------------------------------------------------------------------------
+/// GLOBALS AND STATICS
+///--------------------------------------------------------------------------------------------------------------------------------------------------
+
+///--------------------------------------------------------------------------------------------------------------------------------------------------
+/// CLASS DECLARATIONS
+///--------------------------------------------------------------------------------------------------------------------------------------------------
+
+//-------------------------------------------------------------------------------------------------
+// One pool per collider type index, each a list of fixed-size chunks so colliders never move once created
+// Each slot is a small header followed by the collider itself
+class ColliderPool
+{
+public:
+	//-----Public Methods-----
+
+	static void*		Allocate(int typeIndex, size_t classSize, size_t requestedSize);
+	static void			Free(void* memory);
+
+	static ColliderHandle	GetHandle(const Collider* collider); // Invalid handle if the collider isn't pooled
+	static Collider*		GetCollider(const ColliderHandle& handle); // nullptr if the collider was deleted
+	static int				GetNumLiveColliders(int typeIndex);
+
+	static bool			ClaimAllocation(const Collider* collider); // For Collider's constructor, true if this thread's last Allocate() was a pool slot at this address
+
+
+public:
+	//-----Public Data-----
+
+	static constexpr int SLOTS_PER_CHUNK = 256;
+
+
+private:
+	//-----Private Methods-----
+
+	ColliderPool() {}
+	~ColliderPool();
+	ColliderPool(const ColliderPool& copy) = delete;
+
+	static ColliderPool&	GetPool(int typeIndex);
+
+	uint8*				GetSlot(int slotIndex) const;
+	void*				AllocateSlot(int typeIndex, size_t classSize);
+	void				FreeSlot(uint8* slot);
+
+
+private:
+	//-----Private Data-----
+
+	size_t				m_slotStride = 0;
+	std::vector<uint8*> m_chunks;
+	std::vector<int>	m_freeSlots; // Used as a stack, so recently freed (still cached) slots are reused first
+	int					m_numSlots = 0;
+	int					m_numLiveColliders = 0;
+	mutable std::mutex	m_mutex;
+
+};
+
+
+///--------------------------------------------------------------------------------------------------------------------------------------------------
+/// C FUNCTIONS
+///--------------------------------------------------------------------------------------------------------------------------------------------------
@@ -17,27 +17,226 @@
 #include "Engine/Math/MathUtils.h"
 #include "Engine/Math/Matrix3.h"
 #include "Engine/Math/SAT.h"
+#include <xmmintrin.h>
 
 ///--------------------------------------------------------------------------------------------------------------------------------------------------
 /// DEFINES
 ///--------------------------------------------------------------------------------------------------------------------------------------------------
+#define MAX_MANIFOLD_POINTS (4)
+#define MAX_MANIFOLD_CANDIDATES (32)
 
 ///--------------------------------------------------------------------------------------------------------------------------------------------------
 /// ENUMS, TYPEDEFS, STRUCTS, FORWARD DECLARATIONS
 ///--------------------------------------------------------------------------------------------------------------------------------------------------
 
+// Candidate contact point for a face manifold, before it's reduced and turned into a Contact
+struct ManifoldPoint
+{
+	Vector3 position;
+	Vector3 normal;
+	float	penetration;
+};
+
+// Four boxes in world space, one per lane
+struct BoxLanes
+{
+	__m128 center[3];
+	__m128 axes[3][3]; // [Box axis][Component]
+	__m128 extents[3];
+};
+
+// Which part of a triangle a closest point landed on
+enum TriangleFeature
+{
+	TRIANGLE_FEATURE_FACE,
+	TRIANGLE_FEATURE_EDGE_AB,
+	TRIANGLE_FEATURE_EDGE_BC,
+	TRIANGLE_FEATURE_EDGE_CA,
+	TRIANGLE_FEATURE_VERTEX_A,
+	TRIANGLE_FEATURE_VERTEX_B,
+	TRIANGLE_FEATURE_VERTEX_C
+};
+
+//-------------------------------------------------------------------------------------------------
+// World space convex core of a collider with a radius swept around it (spheres are points, capsules are segments)
+// Only used for boolean overlap queries through GJK, so no contact data is ever built from it
+// Hulls stay in local space - the direction is brought into the hull's space and only the winning vertex is transformed out
+class ConvexCoreWs
+{
+public:
+	//-----Public Methods-----
+
+	ConvexCoreWs(const Collider* collider);
+	ConvexCoreWs(const OBB3& boxWs);
+	ConvexCoreWs(const Triangle3& triangleWs);
+	void GetSupportPoint(const Vector3& direction, Vector3& out_point) const;
+
+
+public:
+	//-----Public Data-----
+
+	float		m_radius = 0.f;
+
+
+private:
+	//-----Private Data-----
+
+	int			m_typeIndex = -1;
+	Vector3		m_points[8];
+	int			m_numPoints = 0;
+	Cylinder	m_cylinderWs;
+
+	const Polyhedron*	m_hullLs = nullptr;
+	Matrix4				m_hullToWorld;
+	Matrix3				m_hullDirectionToLocal; // Transpose of the linear part of m_hullToWorld, so support directions map correctly under scale
+
+};
+
+
+//-------------------------------------------------------------------------------------------------
+// Per-thread containers the contact functions reuse instead of building their own each pair
+// They only grow, so once every shape in the scene has been through once the narrowphase stops allocating
+// Only leaf contact functions may use these - nothing that holds them can call back into GenerateContacts
+struct NarrowphaseScratch
+{
+	Polyhedron				m_hullsWs[2];
+	std::vector<Vector3>	m_pointsWs;
+	std::vector<Vector3>	m_frontPoints;
+	std::vector<Vector3>	m_backPoints;
+	std::vector<float>		m_frontDistances;
+	std::vector<float>		m_backDistances;
+	std::vector<int>		m_triangleIndices;
+	std::vector<Vector3>	m_clipVertices[2];
+};
+
+
+//-------------------------------------------------------------------------------------------------
+ConvexCoreWs::ConvexCoreWs(const Collider* collider)
+	: m_typeIndex(collider->GetTypeIndex())
+{
+	switch (m_typeIndex)
+	{
+	case SphereCollider::TYPE_INDEX:
+	{
+		Sphere sphereWs = ColliderCast<SphereCollider>(collider)->GetDataInWorldSpace();
+		m_points[0] = sphereWs.m_center;
+		m_numPoints = 1;
+		m_radius = sphereWs.m_radius;
+	}
+		break;
+	case CapsuleCollider::TYPE_INDEX:
+	{
+		Capsule3 capsuleWs = ColliderCast<CapsuleCollider>(collider)->GetDataInWorldSpace();
+		m_points[0] = capsuleWs.start;
+		m_points[1] = capsuleWs.end;
+		m_numPoints = 2;
+		m_radius = capsuleWs.radius;
+	}
+		break;
+	case BoxCollider::TYPE_INDEX:
+	{
+		OBB3 boxWs = ColliderCast<BoxCollider>(collider)->GetDataInWorldSpace();
+		boxWs.GetPoints(m_points);
+		m_numPoints = 8;
+	}
+		break;
+	case CylinderCollider::TYPE_INDEX:
+		m_cylinderWs = ColliderCast<CylinderCollider>(collider)->GetDataInWorldSpace();
+		break;
+	case ConvexHullCollider::TYPE_INDEX:
+	{
+		const ConvexHullCollider* hullCol = ColliderCast<ConvexHullCollider>(collider);
+		m_hullLs = &hullCol->GetHullLs();
+		m_hullToWorld = hullCol->m_entity->transform.GetModelMatrix();
+		m_hullDirectionToLocal = m_hullToWorld.GetMatrix3Part().GetTranspose();
+	}
+		break;
+	default:
+		ERROR_AND_DIE("Cannot make a convex core for collider type: %s", collider->GetTypeAsString());
+		break;
+	}
+}
+
+
+//-------------------------------------------------------------------------------------------------
+// For shapes that aren't colliders themselves, like voxel grid cells
+ConvexCoreWs::ConvexCoreWs(const OBB3& boxWs)
+	: m_typeIndex(BoxCollider::TYPE_INDEX)
+{
+	boxWs.GetPoints(m_points);
+	m_numPoints = 8;
+}
+
+
+//-------------------------------------------------------------------------------------------------
+ConvexCoreWs::ConvexCoreWs(const Triangle3& triangleWs)
+	: m_typeIndex(TriangleMeshCollider::TYPE_INDEX)
+{
+	m_points[0] = triangleWs.m_a;
+	m_points[1] = triangleWs.m_b;
+	m_points[2] = triangleWs.m_c;
+	m_numPoints = 3;
+}
+
+
+//-------------------------------------------------------------------------------------------------
+void ConvexCoreWs::GetSupportPoint(const Vector3& direction, Vector3& out_point) const
+{
+	if (m_typeIndex == CylinderCollider::TYPE_INDEX)
+	{
+		m_cylinderWs.GetSupportPoint(direction, out_point);
+	}
+	else if (m_typeIndex == ConvexHullCollider::TYPE_INDEX)
+	{
+		Vector3 pointLs;
+		m_hullLs->GetSupportPoint(m_hullDirectionToLocal * direction, pointLs);
+		out_point = m_hullToWorld.TransformPosition(pointLs);
+	}
+	else
+	{
+		int bestIndex = 0;
+		float bestDot = DotProduct(m_points[0], direction);
+
+		for (int iPoint = 1; iPoint < m_numPoints; ++iPoint)
+		{
+			float dot = DotProduct(m_points[iPoint], direction);
+			if (dot > bestDot)
+			{
+				bestDot = dot;
+				bestIndex = iPoint;
+			}
+		}
+
+		out_point = m_points[bestIndex];
+	}
+}
+
+
 ///--------------------------------------------------------------------------------------------------------------------------------------------------
 /// GLOBALS AND STATICS
 ///--------------------------------------------------------------------------------------------------------------------------------------------------
+static thread_local NarrowphaseScratch s_narrowphaseScratch;
+
 GenerateContactsFunction CollisionDetector::s_colliderMatrix[NUM_COLLIDER_TYPES][NUM_COLLIDER_TYPES] =
 {
-	{ nullptr, nullptr, &CollisionDetector::GenerateContacts_HalfSpaceSphere,	&CollisionDetector::GenerateContacts_HalfSpaceCapsule,	&CollisionDetector::GenerateContacts_HalfSpaceBox,	&CollisionDetector::GenerateContacts_HalfSpaceCylinder, &CollisionDetector::GenerateContacts_HalfSpaceHull },
-	{ nullptr, nullptr, &CollisionDetector::GenerateContacts_PlaneSphere,		&CollisionDetector::GenerateContacts_PlaneCapsule,		&CollisionDetector::GenerateContacts_PlaneBox,		&CollisionDetector::GenerateContacts_PlaneCylinder,		&CollisionDetector::GenerateContacts_PlaneHull },
-	{ nullptr, nullptr,	&CollisionDetector::GenerateContacts_SphereSphere,		&CollisionDetector::GenerateContacts_SphereCapsule,		&CollisionDetector::GenerateContacts_SphereBox,		&CollisionDetector::GenerateContacts_SphereCylinder,	&CollisionDetector::GenerateContacts_SphereHull },
-	{ nullptr, nullptr, nullptr,												&CollisionDetector::GenerateContacts_CapsuleCapsule,	&CollisionDetector::GenerateContacts_CapsuleBox,	&CollisionDetector::GenerateContacts_CapsuleCylinder,	&CollisionDetector::GenerateContacts_CapsuleHull },
-	{ nullptr, nullptr, nullptr,												nullptr,												&CollisionDetector::GenerateContacts_BoxBox,		nullptr,												&CollisionDetector::GenerateContacts_BoxHull },
-	{ nullptr, nullptr, nullptr,												nullptr,												nullptr,											nullptr,												nullptr },
-	{ nullptr, nullptr, nullptr,												nullptr,												nullptr,											nullptr,												&CollisionDetector::GenerateContacts_HullHull }
+	{ nullptr, nullptr, &CollisionDetector::GenerateContacts_HalfSpaceSphere,	&CollisionDetector::GenerateContacts_HalfSpaceCapsule,	&CollisionDetector::GenerateContacts_HalfSpaceBox,	&CollisionDetector::GenerateContacts_HalfSpaceCylinder, &CollisionDetector::GenerateContacts_HalfSpaceHull,	nullptr,	nullptr,	&CollisionDetector::GenerateContacts_AnyCompound },
+	{ nullptr, nullptr, &CollisionDetector::GenerateContacts_PlaneSphere,		&CollisionDetector::GenerateContacts_PlaneCapsule,		&CollisionDetector::GenerateContacts_PlaneBox,		&CollisionDetector::GenerateContacts_PlaneCylinder,		&CollisionDetector::GenerateContacts_PlaneHull,	nullptr,	nullptr,	&CollisionDetector::GenerateContacts_AnyCompound },
+	{ nullptr, nullptr,	&CollisionDetector::GenerateContacts_SphereSphere,		&CollisionDetector::GenerateContacts_SphereCapsule,		&CollisionDetector::GenerateContacts_SphereBox,		&CollisionDetector::GenerateContacts_SphereCylinder,	&CollisionDetector::GenerateContacts_SphereHull,	&CollisionDetector::GenerateContacts_SphereVoxelGrid,	&CollisionDetector::GenerateContacts_SphereTriangleMesh,	&CollisionDetector::GenerateContacts_AnyCompound },
+	{ nullptr, nullptr, nullptr,												&CollisionDetector::GenerateContacts_CapsuleCapsule,	&CollisionDetector::GenerateContacts_CapsuleBox,	&CollisionDetector::GenerateContacts_CapsuleCylinder,	&CollisionDetector::GenerateContacts_CapsuleHull,	&CollisionDetector::GenerateContacts_CapsuleVoxelGrid,	&CollisionDetector::GenerateContacts_CapsuleTriangleMesh,	&CollisionDetector::GenerateContacts_AnyCompound },
+	{ nullptr, nullptr, nullptr,												nullptr,												&CollisionDetector::GenerateContacts_BoxBox,		nullptr,												&CollisionDetector::GenerateContacts_BoxHull,	&CollisionDetector::GenerateContacts_BoxVoxelGrid,	&CollisionDetector::GenerateContacts_BoxTriangleMesh,	&CollisionDetector::GenerateContacts_AnyCompound },
+	{ nullptr, nullptr, nullptr,												nullptr,												nullptr,											nullptr,												nullptr,											nullptr,	nullptr,	&CollisionDetector::GenerateContacts_AnyCompound },
+	{ nullptr, nullptr, nullptr,												nullptr,												nullptr,											nullptr,												&CollisionDetector::GenerateContacts_HullHull,	&CollisionDetector::GenerateContacts_HullVoxelGrid,	&CollisionDetector::GenerateContacts_HullTriangleMesh,	&CollisionDetector::GenerateContacts_AnyCompound },
+	{ nullptr, nullptr, nullptr,												nullptr,												nullptr,											nullptr,												nullptr,											nullptr,	nullptr,	&CollisionDetector::GenerateContacts_AnyCompound },
+	{ nullptr, nullptr, nullptr,												nullptr,												nullptr,											nullptr,												nullptr,											nullptr,	nullptr,	&CollisionDetector::GenerateContacts_AnyCompound },
+	{ nullptr, nullptr, nullptr,												nullptr,												nullptr,											nullptr,												nullptr,											nullptr,	nullptr,	&CollisionDetector::GenerateContacts_AnyCompound }
+};
+
+// Keyed lower type index first same as the matrix, though the scene buckets pairs in either order
+const GenerateContactsBatchKernel CollisionDetector::s_batchKernels[NUM_BATCH_KERNELS] =
+{
+	{ SphereCollider::TYPE_INDEX,	SphereCollider::TYPE_INDEX,	&CollisionDetector::GenerateContactsBatch_SphereSphere },
+	{ SphereCollider::TYPE_INDEX,	BoxCollider::TYPE_INDEX,	&CollisionDetector::GenerateContactsBatch_SphereBox },
+	{ BoxCollider::TYPE_INDEX,		BoxCollider::TYPE_INDEX,	&CollisionDetector::GenerateContactsBatch_BoxBox }
 };
 
 ///--------------------------------------------------------------------------------------------------------------------------------------------------
@@ -82,2022 +281,3797 @@ static void FillOutColliderInfo(Contact* contact, const Collider* a, const Colli
 	contact->friction = CalculateFrictionBetween(a, b);
 }
 
-///--------------------------------------------------------------------------------------------------------------------------------------------------
-/// CLASS IMPLEMENTATIONS
-///--------------------------------------------------------------------------------------------------------------------------------------------------
 
 //-------------------------------------------------------------------------------------------------
-int CollisionDetector::GenerateContacts_SphereSphere(const Collider* a, const Collider* b, Contact* out_contacts, int limit)
+static float GetSignedAreaAboutNormal(const Vector3& a, const Vector3& b, const Vector3& c, const Vector3& normal)
 {
-	const SphereCollider* aSphereCol = a->GetAsType<SphereCollider>();
-	const SphereCollider* bSphereCol = b->GetAsType<SphereCollider>();
-
-	ASSERT_OR_DIE(aSphereCol != nullptr && bSphereCol != nullptr, "Colliders not the right type!");
-
-	if (limit <= 0)
-		return 0;
-
-	Sphere aSphere = aSphereCol->GetDataInWorldSpace();
-	Sphere bSphere = bSphereCol->GetDataInWorldSpace();
-
-	Vector3 bToA = aSphere.m_center - bSphere.m_center;
-	float distanceSquared = bToA.GetLengthSquared();
-
-	if (distanceSquared >= (aSphere.m_radius + bSphere.m_radius) * (aSphere.m_radius + bSphere.m_radius))
-	{
-		return 0;
-	}
-
-	float distance = bToA.Normalize();
+	return 0.5f * DotProduct(CrossProduct(b - a, c - a), normal);
+}
 
-	out_contacts->position = bSphere.m_center + 0.5f * distance * bToA;			// Contact position is the midpoint between the centers
-	out_contacts->normal = bToA;												// Orientation is set up s.t adding the normal to A would resolve the collision, -normal to B
-	out_contacts->penetration = (aSphere.m_radius + bSphere.m_radius) - distance;	// Pen is the overlap
-	FillOutColliderInfo(out_contacts, aSphereCol, bSphereCol);
 
-	out_contacts->CheckValuesAreReasonable();
-	return 1;
+//-------------------------------------------------------------------------------------------------
+static void SwapManifoldPoints(ManifoldPoint* points, int indexA, int indexB)
+{
+	ManifoldPoint temp = points[indexA];
+	points[indexA] = points[indexB];
+	points[indexB] = temp;
 }
 
 
 //-------------------------------------------------------------------------------------------------
-int CollisionDetector::GenerateContacts(const Collider* a, const Collider* b, Contact* out_contacts, int limit)
+// Keeps at most MAX_MANIFOLD_POINTS points, moving them to the front and returning how many were kept
+// Always keeps the deepest point, then greedily picks the points that span the most area so the manifold still supports the body
+// Each extra point costs resolver iterations, and beyond 4 they rarely add stability
+static int ReduceManifoldPoints(ManifoldPoint* points, int numPoints, const Vector3& normal)
 {
-	if (limit <= 0)
-		return 0;
+	if (numPoints <= MAX_MANIFOLD_POINTS)
+		return numPoints;
 
-	int firstIndex = a->GetTypeIndex();
-	int secondIndex = b->GetTypeIndex();
+	// Deepest
+	int bestIndex = 0;
+	for (int i = 1; i < numPoints; ++i)
+	{
+		if (points[i].penetration > points[bestIndex].penetration)
+		{
+			bestIndex = i;
+		}
+	}
+	SwapManifoldPoints(points, 0, bestIndex);
 
-	if (firstIndex > secondIndex)
+	// Farthest from the deepest
+	float bestValue = -1.f;
+	for (int i = 1; i < numPoints; ++i)
 	{
-		int temp = firstIndex;
-		firstIndex = secondIndex;
-		secondIndex = temp;
+		float distanceSquared = (points[i].position - points[0].position).GetLengthSquared();
+		if (distanceSquared > bestValue)
+		{
+			bestValue = distanceSquared;
+			bestIndex = i;
+		}
+	}
+	SwapManifoldPoints(points, 1, bestIndex);
 
-		const Collider* tempPtr = a;
-		a = b;
-		b = tempPtr;
+	// Largest triangle with the first two, on either side
+	bestValue = -1.f;
+	float bestSignedArea = 0.f;
+	for (int i = 2; i < numPoints; ++i)
+	{
+		float signedArea = GetSignedAreaAboutNormal(points[0].position, points[1].position, points[i].position, normal);
+		if (Abs(signedArea) > bestValue)
+		{
+			bestValue = Abs(signedArea);
+			bestSignedArea = signedArea;
+			bestIndex = i;
+		}
 	}
+	SwapManifoldPoints(points, 2, bestIndex);
 
-	//ASSERT_OR_DIE(s_colliderMatrix[firstIndex][secondIndex] != nullptr, "Collision matrix missing an entry!");
+	// Point that adds the most area outside the triangle
+	// Flip the normal if needed so points outside an edge have negative area for that edge
+	Vector3 windingNormal = (bestSignedArea >= 0.f ? normal : -1.0f * normal);
 
-	if (s_colliderMatrix[firstIndex][secondIndex] != nullptr)
+	bestValue = 0.f;
+	bestIndex = -1;
+	for (int i = 3; i < numPoints; ++i)
 	{
-		return (this->*s_colliderMatrix[firstIndex][secondIndex])(a, b, out_contacts, limit);
+		const Vector3& point = points[i].position;
+		float areaOutside = -1.0f * GetSignedAreaAboutNormal(points[0].position, points[1].position, point, windingNormal);
+		areaOutside = Max(areaOutside, -1.0f * GetSignedAreaAboutNormal(points[1].position, points[2].position, point, windingNormal));
+		areaOutside = Max(areaOutside, -1.0f * GetSignedAreaAboutNormal(points[2].position, points[0].position, point, windingNormal));
+
+		if (areaOutside > bestValue)
+		{
+			bestValue = areaOutside;
+			bestIndex = i;
+		}
 	}
 
-	return 0;
+	// Everything left is inside the triangle, so a 4th point adds nothing
+	if (bestIndex == -1)
+		return 3;
+
+	SwapManifoldPoints(points, 3, bestIndex);
+	return MAX_MANIFOLD_POINTS;
 }
 
 
+
 //-------------------------------------------------------------------------------------------------
-int CollisionDetector::GenerateContacts_HalfSpaceSphere(const Collider* a, const Collider* b, Contact* out_contacts, int limit)
+static int GetDeepestManifoldPointIndex(const ManifoldPoint* points, int numPoints)
 {
-	const HalfSpaceCollider* aHalfspaceCol = a->GetAsType<HalfSpaceCollider>();
-	const SphereCollider* bSphereCol = b->GetAsType<SphereCollider>();
-
-	ASSERT_OR_DIE(aHalfspaceCol != nullptr && bSphereCol != nullptr, "Colliders not the right type!");
+	int deepestIndex = 0;
+	for (int i = 1; i < numPoints; ++i)
+	{
+		if (points[i].penetration > points[deepestIndex].penetration)
+		{
+			deepestIndex = i;
+		}
+	}
 
-	if (limit <= 0)
-		return 0;
+	return deepestIndex;
+}
 
-	Plane3 planeWs = aHalfspaceCol->GetDataInWorldSpace();
-	Sphere sphereWs = bSphereCol->GetDataInWorldSpace();
 
-	float distance = planeWs.GetDistanceFromPlane(sphereWs.m_center) - sphereWs.m_radius;
-	
-	// Sphere too far in front of plane; its radius isn't enough to intersect the plane
-	if (distance >= 0)
-		return 0;
+//-------------------------------------------------------------------------------------------------
+// Merges points at the same spot with the same normal (neighboring cells often produce these)
+// Once full, the points so far are reduced to the manifold they would end up as, so later cells or triangles can still extend it
+static void AddManifoldCandidate(ManifoldPoint* points, int& inout_numPoints, int maxPoints, const ManifoldPoint& candidate)
+{
+	for (int i = 0; i < inout_numPoints; ++i)
+	{
+		if ((points[i].position - candidate.position).GetLengthSquared() < 1e-6f && DotProduct(points[i].normal, candidate.normal) > 0.999f)
+		{
+			points[i].penetration = Max(points[i].penetration, candidate.penetration);
+			return;
+		}
+	}
 
-	out_contacts->normal = planeWs.m_normal;
-	out_contacts->penetration = -distance;
-	out_contacts->position = planeWs.GetProjectedPointOntoPlane(sphereWs.m_center);
-	FillOutColliderInfo(out_contacts, bSphereCol, aHalfspaceCol);
+	if (inout_numPoints >= maxPoints)
+	{
+		ASSERT_OR_DIE(maxPoints > MAX_MANIFOLD_POINTS, "Candidate buffer can't hold more than a manifold!");
+		inout_numPoints = ReduceManifoldPoints(points, inout_numPoints, points[GetDeepestManifoldPointIndex(points, inout_numPoints)].normal);
+	}
 
-	out_contacts->CheckValuesAreReasonable();
-	return 1;
+	points[inout_numPoints++] = candidate;
 }
 
 
 //-------------------------------------------------------------------------------------------------
-int CollisionDetector::GenerateContacts_HalfSpaceBox(const Collider* a, const Collider* b, Contact* out_contacts, int limit)
+static ManifoldPoint MakeVoxelManifoldPointWs(const Transform& gridTransform, const Vector3& positionLs, const Vector3& normalLs, float penetrationLs)
 {
-	const HalfSpaceCollider* aHalfSpaceCol = a->GetAsType<HalfSpaceCollider>();
-	const BoxCollider* bBoxCollider = b->GetAsType<BoxCollider>();
-	ASSERT_OR_DIE(aHalfSpaceCol != nullptr && bBoxCollider != nullptr, "Colliders are of wrong type!");
+	ManifoldPoint point;
+	point.position = gridTransform.TransformPosition(positionLs);
+	point.normal = gridTransform.TransformDirection(normalLs).GetNormalized();
+	point.penetration = penetrationLs * gridTransform.scale.x;
 
-	if (limit <= 0)
-		return 0;
+	return point;
+}
 
-	Plane3 planeWs = aHalfSpaceCol->GetDataInWorldSpace();
-	OBB3 boxWs = bBoxCollider->GetDataInWorldSpace();
 
-	Vector3 boxVertsWs[8];
-	boxWs.GetPoints(boxVertsWs);
+//-------------------------------------------------------------------------------------------------
+// Distance to push a point inside a solid cell out through its nearest face, along with that face's normal
+// Faces shared with another solid cell are skipped so nothing gets pushed sideways into the next cell over,
+// unless the cell is completely buried and there's no other choice
+static float GetVoxelCellPushOut(const VoxelGridCollider* grid, const IntVector3& cellCoords, const Vector3& pointLs, Vector3& out_normalLs)
+{
+	AABB3 cellLs = grid->GetCellBoundsLs(cellCoords);
 
-	int numContactsAdded = 0;
-	Contact* contactToFill = out_contacts;
+	float bestExposedDepth = FLT_MAX;
+	float bestAnyDepth = FLT_MAX;
+	Vector3 bestExposedNormal = Vector3::ZERO;
+	Vector3 bestAnyNormal = Vector3::ZERO;
 
-	for (int i = 0; i < 8; ++i)
+	for (int axis = 0; axis < 3; ++axis)
 	{
-		float distance = planeWs.GetDistanceFromPlane(boxVertsWs[i]);
-
-		if (distance < 0.f)
+		for (int sign = -1; sign <= 1; sign += 2)
 		{
-			//contactToFill->position = 0.5f * (boxVertsWs[i] + planeWs.GetProjectedPointOntoPlane(boxVertsWs[i])); // Position is half way between the box vertex and the plane
-			contactToFill->position = boxVertsWs[i]; // Position is half way between the box vertex and the plane
-			contactToFill->normal = planeWs.m_normal;
-			contactToFill->penetration = Abs(distance);
-			FillOutColliderInfo(contactToFill, bBoxCollider, aHalfSpaceCol);
-			
-			contactToFill->CheckValuesAreReasonable();
-			numContactsAdded++;
+			float depth = (sign > 0 ? cellLs.maxs.data[axis] - pointLs.data[axis] : pointLs.data[axis] - cellLs.mins.data[axis]);
 
-			if (numContactsAdded < limit)
+			Vector3 normal = Vector3::ZERO;
+			normal.data[axis] = (float)sign;
+
+			IntVector3 neighborCoords = cellCoords;
+			neighborCoords.data[axis] += sign;
+
+			if (depth < bestAnyDepth)
 			{
-				contactToFill = &out_contacts[numContactsAdded];
+				bestAnyDepth = depth;
+				bestAnyNormal = normal;
 			}
-			else
+
+			if (depth < bestExposedDepth && !grid->IsCellOccupied(neighborCoords))
 			{
-				break;
+				bestExposedDepth = depth;
+				bestExposedNormal = normal;
 			}
 		}
 	}
 
-	return numContactsAdded;
+	if (bestExposedDepth < FLT_MAX)
+	{
+		out_normalLs = bestExposedNormal;
+		return bestExposedDepth;
+	}
+
+	out_normalLs = bestAnyNormal;
+	return bestAnyDepth;
 }
 
 
 //-------------------------------------------------------------------------------------------------
-int CollisionDetector::GenerateContacts_HalfSpaceCylinder(const Collider* a, const Collider* b, Contact* out_contacts, int limit)
+// Sphere against one solid cell, in grid space
+// Components of the normal that point into a solid neighbor are dropped, since that face is internal - this is what keeps
+// shapes from catching on the seams between cells when sliding across a flat run of them
+static bool GetSphereVoxelCellContactLs(const VoxelGridCollider* grid, const IntVector3& cellCoords, const Vector3& centerLs, float radiusLs, Vector3& out_positionLs, Vector3& out_normalLs, float& out_penetrationLs)
 {
-	const HalfSpaceCollider* aHalfSpaceCol = a->GetAsType<HalfSpaceCollider>();
-	const CylinderCollider* bCylinderCol = b->GetAsType<CylinderCollider>();
-	ASSERT_OR_DIE(aHalfSpaceCol != nullptr && bCylinderCol != nullptr, "Colliders are of wrong type!");
-
-	if (limit <= 0)
-		return 0;
-
-	const Plane3 planeWs = aHalfSpaceCol->GetDataInWorldSpace();
-	const Cylinder cylinderWs = bCylinderCol->GetDataInWorldSpace();
+	AABB3 cellLs = grid->GetCellBoundsLs(cellCoords);
+	Vector3 closestPointLs = Clamp(centerLs, cellLs.mins, cellLs.maxs);
+	Vector3 cellToCenter = centerLs - closestPointLs;
 
-	int numContactsAdded = 0;
-	Contact* contactToFill = out_contacts;
+	bool centerIsInside = (cellToCenter.GetLengthSquared() == 0.f);
 
-	for (int i = 0; i < 2; ++i)
+	if (!centerIsInside)
 	{
-		Vector3 endPoint = (i == 0 ? cylinderWs.m_bottom : cylinderWs.m_top);
-		Vector3 spineDir = (i == 0 ? (cylinderWs.m_bottom - cylinderWs.m_top) : (cylinderWs.m_top - cylinderWs.m_bottom));
-		spineDir.Normalize();
-
-		// Get the vector from the end point to the plane
-		Vector3 projectedEndPoint = planeWs.GetProjectedPointOntoPlane(endPoint);
-		Vector3 endPointToPlane = projectedEndPoint - endPoint;
-
-		// Project onto the spine vector
-		float dot = DotProduct(spineDir, endPointToPlane);
-
-		// Get the projection of the endPointToPlane onto the disc of the cylinder
-		Vector3 discVector = endPointToPlane - spineDir * dot;
-		discVector.SafeNormalize(discVector); // In the case the cylinder is aligned with the normal of the plane, this vector will be 0 - that's fine, this will return the end point as the contact point
-
-		// In the case that the end point is below the plane, make sure we go the other direction
-		// to get the lower "edge" of the cylinder disc
-		if (DotProduct(discVector, planeWs.m_normal) > 0.f)
-		{
-			discVector *= -1.0f;
-		}
-
-		Vector3 contactPos = endPoint + discVector * cylinderWs.m_radius;
-		float pen = planeWs.GetDistanceFromPlane(contactPos);
-		if (pen < 0.f)
+		for (int axis = 0; axis < 3; ++axis)
 		{
-			// Contact!
-			contactToFill->position = contactPos;
-			contactToFill->normal = planeWs.m_normal;
-			contactToFill->penetration = Abs(pen);
-			FillOutColliderInfo(contactToFill, bCylinderCol, aHalfSpaceCol);
+			if (cellToCenter.data[axis] == 0.f)
+				continue;
 
-			contactToFill->CheckValuesAreReasonable();
-			numContactsAdded++;
+			IntVector3 neighborCoords = cellCoords;
+			neighborCoords.data[axis] += (cellToCenter.data[axis] > 0.f ? 1 : -1);
 
-			if (numContactsAdded < limit)
+			if (grid->IsCellOccupied(neighborCoords))
 			{
-				contactToFill = &out_contacts[numContactsAdded];
-			}
-			else
-			{
-				break;
+				cellToCenter.data[axis] = 0.f;
 			}
 		}
-	}
 
-	return numContactsAdded;
-}
+		float distance = cellToCenter.GetLength();
+
+		// Only touching internal faces, the neighboring cells will handle it
+		if (distance == 0.f || distance >= radiusLs)
+			return false;
+
+		out_normalLs = cellToCenter / distance;
+		out_positionLs = centerLs - cellToCenter;
+		out_penetrationLs = radiusLs - distance;
+		return true;
+	}
+
+	float depth = GetVoxelCellPushOut(grid, cellCoords, centerLs, out_normalLs);
+	out_positionLs = centerLs + depth * out_normalLs;
+	out_penetrationLs = depth + radiusLs;
+
+	return true;
+}
 
 
 //-------------------------------------------------------------------------------------------------
-int CollisionDetector::GenerateContacts_HalfSpaceHull(const Collider* a, const Collider* b, Contact* out_contacts, int limit)
+// Alternates projecting between the two shapes, which converges on the closest points since both are convex
+static Vector3 GetPointOnSegmentClosestToAABB(const Vector3& start, const Vector3& end, const AABB3& bounds)
 {
-	const HalfSpaceCollider* aHalfSpaceCol = a->GetAsType<HalfSpaceCollider>();
-	const ConvexHullCollider* bPolyCollider = b->GetAsType<ConvexHullCollider>();
-	ASSERT_OR_DIE(aHalfSpaceCol != nullptr && bPolyCollider != nullptr, "Colliders are of wrong type!");
+	Vector3 direction = end - start;
+	float lengthSquared = direction.GetLengthSquared();
+	Vector3 segmentPoint = 0.5f * (start + end);
 
-	if (limit <= 0)
-		return 0;
+	for (int iteration = 0; iteration < 4; ++iteration)
+	{
+		Vector3 boxPoint = Clamp(segmentPoint, bounds.mins, bounds.maxs);
+		float t = (lengthSquared > 0.f ? Clamp(DotProduct(boxPoint - start, direction) / lengthSquared, 0.f, 1.f) : 0.f);
+		segmentPoint = start + t * direction;
+	}
 
-	Plane3 planeWs = aHalfSpaceCol->GetDataInWorldSpace();
-	Polyhedron polyWs = bPolyCollider->GetDataInWorldSpace();
+	return segmentPoint;
+}
 
-	int numContactsAdded = 0;
-	Contact* contactToFill = out_contacts;
-	int numVerts = polyWs.GetNumVertices();
 
-	for (int iVert = 0; iVert < numVerts; ++iVert)
-	{
-		Vector3 vertex = polyWs.GetVertexPosition(iVert);
-		float distance = planeWs.GetDistanceFromPlane(vertex);
+//-------------------------------------------------------------------------------------------------
+// A lattice corner is on the surface if it touches both solid and empty cells
+static bool IsVoxelCornerOnSurface(const VoxelGridCollider* grid, int x, int y, int z)
+{
+	bool touchesSolid = false;
+	bool touchesEmpty = false;
 
-		if (distance < 0.f)
+	for (int cellY = y - 1; cellY <= y; ++cellY)
+	{
+		for (int cellZ = z - 1; cellZ <= z; ++cellZ)
 		{
-			contactToFill->position = vertex;
-			contactToFill->normal = planeWs.m_normal;
-			contactToFill->penetration = Abs(distance);
-			FillOutColliderInfo(contactToFill, bPolyCollider, aHalfSpaceCol);
-			contactToFill->CheckValuesAreReasonable();
-			numContactsAdded++;
-
-			if (numContactsAdded < limit)
-			{
-				contactToFill = &out_contacts[numContactsAdded];
-			}
-			else
+			for (int cellX = x - 1; cellX <= x; ++cellX)
 			{
-				break;
+				if (grid->IsCellOccupied(cellX, cellY, cellZ))
+				{
+					touchesSolid = true;
+				}
+				else
+				{
+					touchesEmpty = true;
+				}
 			}
 		}
 	}
 
-	return numContactsAdded;
+	return touchesSolid && touchesEmpty;
 }
 
 
 //-------------------------------------------------------------------------------------------------
-int CollisionDetector::GenerateContacts_SphereBox(const Collider* a, const Collider* b, Contact* out_contacts, int limit)
+// Adds a contact for each vertex of a shape that's inside a solid cell
+static void AddVoxelVertexContacts(const VoxelGridCollider* grid, const Vector3* verticesWs, int numVertices, ManifoldPoint* points, int& inout_numPoints)
 {
-	const SphereCollider* aSphereCol = a->GetAsType<SphereCollider>();
-	const BoxCollider* bBoxCol = b->GetAsType<BoxCollider>();
-	ASSERT_OR_DIE(aSphereCol != nullptr && bBoxCol != nullptr, "Colliders are of wrong type!");
+	const Transform& gridTransform = grid->m_entity->transform;
+	float iCellSize = 1.0f / grid->GetCellSize();
 
-	if (limit <= 0)
-		return 0;
+	for (int iVertex = 0; iVertex < numVertices; ++iVertex)
+	{
+		Vector3 vertexLs = gridTransform.InverseTransformPosition(verticesWs[iVertex]);
+		IntVector3 cellCoords(Floor(vertexLs.x * iCellSize), Floor(vertexLs.y * iCellSize), Floor(vertexLs.z * iCellSize));
 
-	Sphere sphereWs = aSphereCol->GetDataInWorldSpace();
-	OBB3 boxWs = bBoxCol->GetDataInWorldSpace();
+		if (!grid->IsCellOccupied(cellCoords))
+			continue;
 
-	Vector3 sphereCenterRel = boxWs.TransformPositionIntoSpace(sphereWs.m_center);
+		Vector3 normalLs;
+		float depth = GetVoxelCellPushOut(grid, cellCoords, vertexLs, normalLs);
 
-	// Early out check
-	if (Abs(sphereCenterRel.x) - sphereWs.m_radius >= boxWs.extents.x ||
-		Abs(sphereCenterRel.y) - sphereWs.m_radius >= boxWs.extents.y ||
-		Abs(sphereCenterRel.z) - sphereWs.m_radius >= boxWs.extents.z)
+		AddManifoldCandidate(points, inout_numPoints, MAX_MANIFOLD_CANDIDATES, MakeVoxelManifoldPointWs(gridTransform, vertexLs, normalLs, depth));
+	}
+}
+
+
+//-------------------------------------------------------------------------------------------------
+static bool GetShapeBoundsInGridSpace(const VoxelGridCollider* grid, const Vector3* verticesWs, int numVertices, IntVector3& out_minCoords, IntVector3& out_maxCoords)
+{
+	const Transform& gridTransform = grid->m_entity->transform;
+
+	AABB3 boundsLs;
+	boundsLs.mins = Vector3(FLT_MAX);
+	boundsLs.maxs = Vector3(-FLT_MAX);
+
+	for (int iVertex = 0; iVertex < numVertices; ++iVertex)
 	{
-		return 0;
+		Vector3 vertexLs = gridTransform.InverseTransformPosition(verticesWs[iVertex]);
+		boundsLs.mins = Vector3(Min(boundsLs.mins.x, vertexLs.x), Min(boundsLs.mins.y, vertexLs.y), Min(boundsLs.mins.z, vertexLs.z));
+		boundsLs.maxs = Vector3(Max(boundsLs.maxs.x, vertexLs.x), Max(boundsLs.maxs.y, vertexLs.y), Max(boundsLs.maxs.z, vertexLs.z));
 	}
 
-	// Get the closest point on the box to the sphere
-	Vector3 closestPointRel = Clamp(sphereCenterRel, -1.0f * boxWs.extents, boxWs.extents);
-	Vector3 closestPointWs = boxWs.TransformPositionOutOfSpace(closestPointRel);
+	return grid->GetCellRangeOverlapping(boundsLs, out_minCoords, out_maxCoords);
+}
 
-	// Get the distance from the sphere to the box point
-	Vector3 sphereToBox = closestPointWs - sphereWs.m_center;
-	float distanceSquared = sphereToBox.GetLengthSquared();
-	float radiusSquared = sphereWs.m_radius * sphereWs.m_radius;
 
-	if (AreMostlyEqual(distanceSquared, radiusSquared))
+//-------------------------------------------------------------------------------------------------
+// Reduces points gathered from many cells or triangles to a manifold and writes out the contacts, normals pointing toward the shape
+static int FinishGatheredContacts(const Collider* shapeCol, const Collider* staticCol, ManifoldPoint* points, int numPoints, Contact* out_contacts, int limit)
+{
+	if (numPoints == 0)
 		return 0;
 
-	// Create the contact
-	out_contacts->position = closestPointWs;
-	out_contacts->normal = sphereToBox;
-	float distance = out_contacts->normal.SafeNormalize(Vector3::Y_AXIS);
-	out_contacts->penetration = sphereWs.m_radius - distance;
-	FillOutColliderInfo(out_contacts, bBoxCol, aSphereCol);
+	numPoints = ReduceManifoldPoints(points, numPoints, points[GetDeepestManifoldPointIndex(points, numPoints)].normal);
+	int numContacts = Min(numPoints, limit);
 
-	out_contacts->CheckValuesAreReasonable();
-	return 1;
+	for (int i = 0; i < numContacts; ++i)
+	{
+		out_contacts[i].position = points[i].position;
+		out_contacts[i].normal = points[i].normal;
+		out_contacts[i].penetration = points[i].penetration;
+		FillOutColliderInfo(&out_contacts[i], shapeCol, staticCol);
+		out_contacts[i].CheckValuesAreReasonable();
+	}
+
+	return numContacts;
 }
 
 
 //-------------------------------------------------------------------------------------------------
-int CollisionDetector::GenerateContacts_SphereCylinder(const Collider* a, const Collider* b, Contact* out_contacts, int limit)
+// Corners of the world AABB around the core and its radius, found from its support points
+static void GetConvexCoreBoundsCornersWs(const ConvexCoreWs& core, Vector3 out_cornersWs[8])
 {
-	if (limit <= 0)
-		return 0;
+	Vector3 extremesWs[6];
+	for (int axis = 0; axis < 3; ++axis)
+	{
+		Vector3 direction = Vector3::ZERO;
+		direction.data[axis] = 1.f;
+		core.GetSupportPoint(direction, extremesWs[2 * axis]);
+		core.GetSupportPoint(-1.0f * direction, extremesWs[2 * axis + 1]);
 
-	int numContacts = 0;
-	const SphereCollider* aSphereCol = a->GetAsType<SphereCollider>();
-	const CylinderCollider* bCylinderCol = b->GetAsType<CylinderCollider>();
-	ASSERT_OR_DIE(aSphereCol != nullptr && bCylinderCol != nullptr, "Colliders are of wrong type!");
+		extremesWs[2 * axis] += direction * core.m_radius;
+		extremesWs[2 * axis + 1] -= direction * core.m_radius;
+	}
 
-	const Sphere sphereWs = aSphereCol->GetDataInWorldSpace();
-	const Cylinder cylinderWs = bCylinderCol->GetDataInWorldSpace();
+	OBB3(AABB3(Vector3(extremesWs[1].x, extremesWs[3].y, extremesWs[5].z), Vector3(extremesWs[0].x, extremesWs[2].y, extremesWs[4].z))).GetPoints(out_cornersWs);
+}
 
-	Vector3 bottomToSphere = (sphereWs.m_center - cylinderWs.m_bottom);
 
-	Vector3 cylSpine = (cylinderWs.m_top - cylinderWs.m_bottom);
-	float height = cylSpine.Normalize();
-	float dot = DotProduct(bottomToSphere, cylSpine);
-	Vector3 discVector = bottomToSphere - cylSpine * dot;
+//-------------------------------------------------------------------------------------------------
+static bool IsOverlappingVoxelGrid(const Collider* shapeCol, const VoxelGridCollider* gridCol)
+{
+	ConvexCoreWs shapeCore(shapeCol);
 
-	bool sphereVertical = (discVector.GetLengthSquared() < cylinderWs.m_radius * cylinderWs.m_radius);
-	float verticalPen = FLT_MAX;
-	Vector3 verticalNormal = Vector3::ZERO;
-	Vector3 verticalContactPos = Vector3::ZERO;
+	Vector3 cornersWs[8];
+	GetConvexCoreBoundsCornersWs(shapeCore, cornersWs);
 
-	if (sphereVertical)
-	{
-		Plane3 topPlane(cylSpine, cylinderWs.m_top);
-		Plane3 bottomPlane(-1.0f * cylSpine, cylinderWs.m_bottom);
-		float topDist = topPlane.GetDistanceFromPlane(sphereWs.m_center);
-		float bottomDist = bottomPlane.GetDistanceFromPlane(sphereWs.m_center);
+	IntVector3 minCoords, maxCoords;
+	if (!GetShapeBoundsInGridSpace(gridCol, cornersWs, 8, minCoords, maxCoords))
+		return false;
 
-		if (Abs(topDist) < Abs(bottomDist))
-		{
-			verticalNormal = cylSpine;
-			verticalPen = sphereWs.m_radius - topDist;
-			verticalContactPos = topPlane.GetProjectedPointOntoPlane(sphereWs.m_center);
-		}
-		else
+	const Transform& gridTransform = gridCol->m_entity->transform;
+	Quaternion gridRotation = gridTransform.GetWorldRotation();
+	Vector3 cellExtentsWs = Vector3(0.5f * gridCol->GetCellSize() * gridTransform.scale.x);
+
+	for (int y = minCoords.y; y <= maxCoords.y; ++y)
+	{
+		for (int z = minCoords.z; z <= maxCoords.z; ++z)
 		{
-			verticalNormal = -1.0f * cylSpine;
-			verticalPen = sphereWs.m_radius - bottomDist;
-			verticalContactPos = bottomPlane.GetProjectedPointOntoPlane(sphereWs.m_center);
+			for (int x = minCoords.x; x <= maxCoords.x; ++x)
+			{
+				IntVector3 cellCoords(x, y, z);
+				if (!gridCol->IsCellOccupied(cellCoords))
+					continue;
+
+				Vector3 cellCenterWs = gridTransform.TransformPosition(gridCol->GetCellBoundsLs(cellCoords).GetCenter());
+				ConvexCoreWs cellCore(OBB3(cellCenterWs, cellExtentsWs, gridRotation));
+
+				GJKSolver3D<ConvexCoreWs, ConvexCoreWs> solver(shapeCore, cellCore);
+				if (!solver.Solve())
+					continue;
+
+				float separation = solver.GetSeparationDistance();
+				if (separation <= 0.f || separation < shapeCore.m_radius)
+					return true;
+			}
 		}
 	}
 
-	bool sphereHorizontal = (dot > 0.f && dot < height);
-	float horizontalPen = FLT_MAX;
-	Vector3 horizontalNormal = Vector3::ZERO;
-	Vector3 closestSpinePt;
+	return false;
+}
 
-	if (sphereHorizontal)
+
+
+//-------------------------------------------------------------------------------------------------
+// Triangles whose bounds touch the given world points, expanded by a world space margin
+static void GetMeshTrianglesNearPoints(const TriangleMeshCollider* meshCol, const Vector3* pointsWs, int numPoints, float marginWs, std::vector<int>& out_triangleIndices)
+{
+	const Transform& meshTransform = meshCol->m_entity->transform;
+
+	AABB3 boundsLs;
+	boundsLs.mins = Vector3(FLT_MAX);
+	boundsLs.maxs = Vector3(-FLT_MAX);
+
+	for (int iPoint = 0; iPoint < numPoints; ++iPoint)
 	{
-		float distanceToSpine = FindNearestPoint(sphereWs.m_center, cylinderWs.m_bottom, cylinderWs.m_top, closestSpinePt);
-		horizontalNormal = (sphereWs.m_center - closestSpinePt) / distanceToSpine;
-		ASSERT_OR_DIE(AreMostlyEqual(horizontalNormal.GetLength(), 1.0f), "My trick didn't work!");
-		horizontalPen = (sphereWs.m_radius + cylinderWs.m_radius) - distanceToSpine;
+		Vector3 pointLs = meshTransform.InverseTransformPosition(pointsWs[iPoint]);
+		boundsLs.mins = Vector3(Min(boundsLs.mins.x, pointLs.x), Min(boundsLs.mins.y, pointLs.y), Min(boundsLs.mins.z, pointLs.z));
+		boundsLs.maxs = Vector3(Max(boundsLs.maxs.x, pointLs.x), Max(boundsLs.maxs.y, pointLs.y), Max(boundsLs.maxs.z, pointLs.z));
 	}
 
-	bool hasHorizontalPen = (horizontalPen > 0.f && horizontalPen < FLT_MAX);
-	bool hasVerticalPen = (verticalPen > 0.f && verticalPen < FLT_MAX);
+	Vector3 marginLs = Vector3(marginWs / meshTransform.scale.x);
+	boundsLs.mins -= marginLs;
+	boundsLs.maxs += marginLs;
 
-	if (hasHorizontalPen && hasVerticalPen)
+	meshCol->GetTrianglesOverlapping(boundsLs, out_triangleIndices);
+}
+
+
+//-------------------------------------------------------------------------------------------------
+static Vector3 GetTriangleNormalWs(const TriangleMeshCollider* meshCol, int triangleIndex)
+{
+	return meshCol->m_entity->transform.TransformDirection(meshCol->GetTriangle(triangleIndex).m_normalLs).GetNormalized();
+}
+
+
+//-------------------------------------------------------------------------------------------------
+// Voronoi region search from Real-Time Collision Detection, 5.1.5
+static Vector3 GetClosestPointOnTriangle(const Vector3& point, const Triangle3& triangle, TriangleFeature& out_feature)
+{
+	const Vector3& a = triangle.m_a;
+	const Vector3& b = triangle.m_b;
+	const Vector3& c = triangle.m_c;
+
+	Vector3 ab = b - a;
+	Vector3 ac = c - a;
+	Vector3 ap = point - a;
+
+	float d1 = DotProduct(ab, ap);
+	float d2 = DotProduct(ac, ap);
+	if (d1 <= 0.f && d2 <= 0.f)
 	{
-		// Sphere center is inside the cylinder, so push either vertically or horizontally, depending on which has less of a correction
-		if (verticalPen < horizontalPen)
-		{
-			out_contacts->position = verticalContactPos;
-			out_contacts->penetration = verticalPen;
-			out_contacts->normal = verticalNormal;
-			FillOutColliderInfo(out_contacts, aSphereCol, bCylinderCol);
-			numContacts++;
-		}
-		else
-		{
-			out_contacts->position = sphereWs.m_center - sphereWs.m_radius * horizontalNormal;
-			out_contacts->penetration = horizontalPen;
-			out_contacts->normal = horizontalNormal;
-			FillOutColliderInfo(out_contacts, aSphereCol, bCylinderCol);
-			numContacts++;
-		}
+		out_feature = TRIANGLE_FEATURE_VERTEX_A;
+		return a;
 	}
-	else if (hasVerticalPen)
+
+	Vector3 bp = point - b;
+	float d3 = DotProduct(ab, bp);
+	float d4 = DotProduct(ac, bp);
+	if (d3 >= 0.f && d4 <= d3)
 	{
-		// Sphere is overlapping a disc face, so push normal to the face
-		out_contacts->position = verticalContactPos;
-		out_contacts->penetration = verticalPen;
-		out_contacts->normal = verticalNormal;
-		FillOutColliderInfo(out_contacts, aSphereCol, bCylinderCol);
-		numContacts++;
+		out_feature = TRIANGLE_FEATURE_VERTEX_B;
+		return b;
 	}
-	else if (hasHorizontalPen)
+
+	float vc = d1 * d4 - d3 * d2;
+	if (vc <= 0.f && d1 >= 0.f && d3 <= 0.f)
 	{
-		// Sphere is overlapping the cylinder sides, so push outward
-		out_contacts->position = closestSpinePt + horizontalNormal * cylinderWs.m_radius;
-		out_contacts->penetration = horizontalPen;
-		out_contacts->normal = horizontalNormal;
-		FillOutColliderInfo(out_contacts, aSphereCol, bCylinderCol);
-		numContacts++;
+		out_feature = TRIANGLE_FEATURE_EDGE_AB;
+		return a + (d1 / (d1 - d3)) * ab;
 	}
-	else
+
+	Vector3 cp = point - c;
+	float d5 = DotProduct(ab, cp);
+	float d6 = DotProduct(ac, cp);
+	if (d6 >= 0.f && d5 <= d6)
 	{
-		// Sphere isn't overlapping the sides or the top/bottom faces, so check if it's overlapping an edge
-		Vector3 edgePoint = cylinderWs.GetFurthestEdgePointInDirection(bottomToSphere);
-		Vector3 edgeToSphere = sphereWs.m_center - edgePoint;
-		
-		if (edgeToSphere.GetLengthSquared() < sphereWs.m_radius * sphereWs.m_radius)
-		{
-			out_contacts->position = edgePoint;
-			out_contacts->penetration = sphereWs.m_radius - edgeToSphere.Normalize();
-			out_contacts->normal = edgeToSphere;
-			FillOutColliderInfo(out_contacts, aSphereCol, bCylinderCol);
-			numContacts++;
-		}
+		out_feature = TRIANGLE_FEATURE_VERTEX_C;
+		return c;
 	}
 
-	if (numContacts > 0)
+	float vb = d5 * d2 - d1 * d6;
+	if (vb <= 0.f && d2 >= 0.f && d6 <= 0.f)
 	{
-		out_contacts->CheckValuesAreReasonable();
+		out_feature = TRIANGLE_FEATURE_EDGE_CA;
+		return a + (d2 / (d2 - d6)) * ac;
 	}
 
-	return numContacts;
+	float va = d3 * d6 - d5 * d4;
+	if (va <= 0.f && (d4 - d3) >= 0.f && (d5 - d6) >= 0.f)
+	{
+		out_feature = TRIANGLE_FEATURE_EDGE_BC;
+		return b + ((d4 - d3) / ((d4 - d3) + (d5 - d6))) * (c - b);
+	}
+
+	float iDenom = 1.0f / (va + vb + vc);
+	out_feature = TRIANGLE_FEATURE_FACE;
+	return a + (vb * iDenom) * ab + (vc * iDenom) * ac;
 }
 
 
 //-------------------------------------------------------------------------------------------------
-int CollisionDetector::GenerateContacts_SphereHull(const Collider* a, const Collider* b, Contact* out_contacts, int limit)
+static bool IsTriangleFeatureActive(uint8 activeEdgeFlags, TriangleFeature feature)
 {
-	if (limit <= 0)
-		return 0;
+	switch (feature)
+	{
+	case TRIANGLE_FEATURE_FACE:		return true; break;
+	case TRIANGLE_FEATURE_EDGE_AB:	return (activeEdgeFlags & 1) != 0; break;
+	case TRIANGLE_FEATURE_EDGE_BC:	return (activeEdgeFlags & 2) != 0; break;
+	case TRIANGLE_FEATURE_EDGE_CA:	return (activeEdgeFlags & 4) != 0; break;
+	case TRIANGLE_FEATURE_VERTEX_A:	return (activeEdgeFlags & 5) != 0; break;
+	case TRIANGLE_FEATURE_VERTEX_B:	return (activeEdgeFlags & 3) != 0; break;
+	case TRIANGLE_FEATURE_VERTEX_C:	return (activeEdgeFlags & 6) != 0; break;
+	default:
+		ERROR_RETURN(true, "Bad triangle feature?");
+		break;
+	}
+}
 
-	int numContacts = 0;
-	const SphereCollider* aSphereCol = a->GetAsType<SphereCollider>();
-	const ConvexHullCollider* bHullCol = b->GetAsType<ConvexHullCollider>();
-	ASSERT_OR_DIE(aSphereCol != nullptr && bHullCol != nullptr, "Colliders are of wrong type!");
 
-	const Sphere sphereWs = aSphereCol->GetDataInWorldSpace();
-	const Polyhedron polyWs = bHullCol->GetDataInWorldSpace();
+//-------------------------------------------------------------------------------------------------
+// Sphere against a one-sided triangle, in world space
+// Touching an internal edge or vertex uses the face normal instead, since those would otherwise push
+// sideways on a seam that can't really be hit
+static bool GetSphereTriangleContact(const Vector3& centerWs, float radiusWs, const Triangle3& triangleWs, const Vector3& normalWs, uint8 activeEdgeFlags, ManifoldPoint& out_point)
+{
+	float planeDistance = DotProduct(centerWs - triangleWs.m_a, normalWs);
+	if (planeDistance < 0.f)
+		return false;
 
-	Vector3 hullPt;
-	float dist = FindNearestPoint(sphereWs.m_center, polyWs, hullPt);
+	TriangleFeature feature;
+	Vector3 closestPtWs = GetClosestPointOnTriangle(centerWs, triangleWs, feature);
+	Vector3 triangleToCenter = centerWs - closestPtWs;
+	float distance = triangleToCenter.GetLength();
 
-	if (dist <= 0.f)
+	if (distance >= radiusWs)
+		return false;
+
+	out_point.position = closestPtWs;
+
+	if (feature == TRIANGLE_FEATURE_FACE || distance < 1e-6f || !IsTriangleFeatureActive(activeEdgeFlags, feature))
 	{
-		// Deep contact
-		int numFaces = polyWs.GetNumFaces();
-		float minPen = -1.f;
-		Vector3 normal = Vector3::ZERO;
+		out_point.normal = normalWs;
+		out_point.penetration = radiusWs - planeDistance;
+		return (out_point.penetration > 0.f);
+	}
 
-		for (int iFace = 0; iFace < numFaces; ++iFace)
-		{
-			const Plane3 plane = polyWs.GetFaceSupportPlane(iFace);
-			float pen = -1.0f * plane.GetDistanceFromPlane(sphereWs.m_center);
+	out_point.normal = triangleToCenter / distance;
+	out_point.penetration = radiusWs - distance;
+	return true;
+}
 
-			if (pen > 0.f && (minPen < 0.f || pen < minPen))
-			{
-				minPen = pen;
-				normal = plane.m_normal;
-			}
-		}
 
-		ASSERT_OR_DIE(minPen > 0.f, "Deep contact not found!");
-		out_contacts[0].position = (sphereWs.m_center - (sphereWs.m_radius - minPen) * normal);
-		out_contacts[0].normal = normal;
-		out_contacts[0].penetration = minPen;
-		FillOutColliderInfo(&out_contacts[0], aSphereCol, bHullCol);
-		out_contacts[0].CheckValuesAreReasonable();
-		numContacts++;
-	}
-	else if (dist < sphereWs.m_radius)
+//-------------------------------------------------------------------------------------------------
+static void ProjectHullOntoAxis(const Polyhedron& hull, const Vector3& axis, float& out_min, float& out_max)
+{
+	out_min = FLT_MAX;
+	out_max = -FLT_MAX;
+
+	int numVertices = hull.GetNumVertices();
+	for (int iVertex = 0; iVertex < numVertices; ++iVertex)
 	{
-		// Shallow contact
-		out_contacts[0].position = hullPt;
-		out_contacts[0].normal = (sphereWs.m_center - hullPt) / dist;
-		out_contacts[0].penetration = sphereWs.m_radius - dist;
-		FillOutColliderInfo(&out_contacts[0], aSphereCol, bHullCol);
-		out_contacts[0].CheckValuesAreReasonable();
-		numContacts++;
+		float projection = DotProduct(hull.GetVertexPosition(iVertex), axis);
+		out_min = Min(out_min, projection);
+		out_max = Max(out_max, projection);
 	}
-
-	return numContacts;
 }
 
 
 //-------------------------------------------------------------------------------------------------
-static inline float TransformToAxis(const BoxCollider* box, const Vector3 &axis)
+// Clips a convex polygon to the prism over the triangle, keeping what's inside all three side planes
+// The polygon is clipped in place, using the scratch list for the other side of each pass, and both just grow to fit
+static void ClipPolygonToTriangle(const Triangle3& triangleWs, const Vector3& normalWs, std::vector<Vector3>& inout_vertices, std::vector<Vector3>& scratchVertices)
 {
-	OBB3 boxWs = box->GetDataInWorldSpace();
-	Matrix3 boxBasis = Matrix3(boxWs.rotation);
-	ASSERT_REASONABLE(boxBasis);
-	ASSERT_REASONABLE(axis);
+	for (int iEdge = 0; iEdge < 3 && inout_vertices.size() > 0; ++iEdge)
+	{
+		const Vector3& edgeStart = triangleWs.m_points[iEdge];
+		const Vector3& edgeEnd = triangleWs.m_points[(iEdge + 1) % 3];
+		Plane3 sidePlane(CrossProduct(edgeEnd - edgeStart, normalWs).GetNormalized(), edgeStart);
 
-	return
-		boxWs.extents.x * Abs(DotProduct(axis, boxBasis.iBasis)) +
-		boxWs.extents.y * Abs(DotProduct(axis, boxBasis.jBasis)) +
-		boxWs.extents.z * Abs(DotProduct(axis, boxBasis.kBasis));
-}
+		int numInput = (int)inout_vertices.size();
+		scratchVertices.clear();
 
-/*
- * This function checks if the two boxes overlap
- * along the given axis, returning the ammount of overlap.
- * The final parameter toCentre
- * is used to pass in the vector between the boxes centre
- * points, to avoid having to recalculate it each time.
- */
-static inline float GetPenetrationOnAxis(const BoxCollider* a, const BoxCollider* b, const Vector3 &axis, const Vector3 &aToB)
-{
-	ASSERT_REASONABLE(axis);
-	ASSERT_REASONABLE(aToB);
-	ASSERT_OR_DIE(AreMostlyEqual(axis.GetLength(), 1.0f), "Axis not unit!");
+		for (int iCurr = 0; iCurr < numInput; ++iCurr)
+		{
+			const Vector3& curr = inout_vertices[iCurr];
+			const Vector3& prev = inout_vertices[(iCurr == 0 ? numInput - 1 : iCurr - 1)];
+			float currDistance = sidePlane.GetDistanceFromPlane(curr);
+			float prevDistance = sidePlane.GetDistanceFromPlane(prev);
 
-	// Project the half-size of one onto axis
-	float oneProject = TransformToAxis(a, axis);
-	float twoProject = TransformToAxis(b, axis);
+			if ((currDistance <= 0.f) != (prevDistance <= 0.f))
+			{
+				float t = prevDistance / (prevDistance - currDistance);
+				scratchVertices.push_back(prev + t * (curr - prev));
+			}
 
-	// Project this onto the axis
-	float distance = Abs(DotProduct(aToB, axis));
+			if (currDistance <= 0.f)
+			{
+				scratchVertices.push_back(curr);
+			}
+		}
 
-	// Return the overlap (i.e. positive indicates
-	// overlap, negative indicates separation).
-	return oneProject + twoProject - distance;
+		inout_vertices.swap(scratchVertices);
+	}
 }
 
 
 //-------------------------------------------------------------------------------------------------
-// Returns true to signal we haven't found a gap yet and to keep checking axes
-static inline bool CheckAxis(const BoxCollider* a, const BoxCollider* b, Vector3 axis, const Vector3& toCentre, unsigned index, float& out_smallestPen, unsigned &out_smallestIndex)
+// SAT between a convex hull and a one-sided triangle, adding manifold candidates for any overlap
+// Every axis is checked for separation, but only axes that push the hull out the front of the triangle
+// can be chosen, and edge axes only from active edges - otherwise boxes slide into the seams between triangles
+static void AddHullTriangleContacts(const Polyhedron& hullWs, const Vector3& hullCenterWs, const Triangle3& triangleWs, const Vector3& normalWs, uint8 activeEdgeFlags, ManifoldPoint* points, int& inout_numPoints)
 {
-	// Make sure we have a normalized axis, and don't check almost parallel axes
-	if (AreMostlyEqual(axis.GetLengthSquared(), 0.f)) 
-		return true;
+	if (DotProduct(hullCenterWs - triangleWs.m_a, normalWs) < 0.f)
+		return;
+
+	float hullMin, hullMax;
+	ProjectHullOntoAxis(hullWs, normalWs, hullMin, hullMax);
+
+	// Triangle face axis, the preferred one
+	float triangleFacePen = DotProduct(triangleWs.m_a, normalWs) - hullMin;
+	if (triangleFacePen <= 0.f)
+		return;
+
+	float bestPen = triangleFacePen;
+	int bestHullFace = -1;
+	int bestTriangleEdge = -1;
+	int bestHullEdge = -1;
+	Vector3 bestAxis = normalWs;
+
+	// Hull face axes
+	int numFaces = hullWs.GetNumFaces();
+	for (int iFace = 0; iFace < numFaces; ++iFace)
+	{
+		Plane3 facePlane = hullWs.GetFaceSupportPlane(iFace);
 
-	axis.Normalize();
-	float penetration = GetPenetrationOnAxis(a, b, axis, toCentre);
+		float minTriangleDistance = Min(facePlane.GetDistanceFromPlane(triangleWs.m_a), Min(facePlane.GetDistanceFromPlane(triangleWs.m_b), facePlane.GetDistanceFromPlane(triangleWs.m_c)));
+		float pen = -1.0f * minTriangleDistance;
 
-	if (penetration < 0.f) 
-		return false;
+		if (pen <= 0.f)
+			return;
 
-	if (penetration < out_smallestPen) 
+		// Small bias so faces that tie with the triangle face don't flip back and forth
+		if (DotProduct(facePlane.m_normal, normalWs) < 0.f && pen < 0.95f * bestPen)
+		{
+			bestPen = pen;
+			bestHullFace = iFace;
+			bestAxis = -1.0f * facePlane.m_normal;
+		}
+	}
+
+	// Edge/edge axes
+	Vector3 triangleCenterWs = (triangleWs.m_a + triangleWs.m_b + triangleWs.m_c) / 3.f;
+	int numHullEdges = hullWs.GetNumEdges();
+
+	for (int iTriangleEdge = 0; iTriangleEdge < 3; ++iTriangleEdge)
 	{
-		out_smallestPen = penetration;
-		out_smallestIndex = index;
+		Vector3 triangleEdge = triangleWs.m_points[(iTriangleEdge + 1) % 3] - triangleWs.m_points[iTriangleEdge];
+		bool isEdgeActive = ((activeEdgeFlags & (1 << iTriangleEdge)) != 0);
+
+		for (int iHullEdge = 0; iHullEdge < numHullEdges; ++iHullEdge)
+		{
+			Vector3 axis = CrossProduct(triangleEdge, hullWs.GetEdgeDirection(iHullEdge));
+			float axisLength = axis.GetLength();
+
+			if (axisLength < 1e-6f)
+				continue;
+
+			axis /= axisLength;
+			if (DotProduct(axis, hullCenterWs - triangleCenterWs) < 0.f)
+			{
+				axis *= -1.0f;
+			}
+
+			float edgeHullMin, edgeHullMax;
+			ProjectHullOntoAxis(hullWs, axis, edgeHullMin, edgeHullMax);
+			float triangleMax = Max(DotProduct(triangleWs.m_a, axis), Max(DotProduct(triangleWs.m_b, axis), DotProduct(triangleWs.m_c, axis)));
+			float pen = triangleMax - edgeHullMin;
+
+			if (pen <= 0.f)
+				return;
+
+			if (isEdgeActive && DotProduct(axis, normalWs) >= 0.f && pen < 0.95f * bestPen)
+			{
+				bestPen = pen;
+				bestHullFace = -1;
+				bestTriangleEdge = iTriangleEdge;
+				bestHullEdge = iHullEdge;
+				bestAxis = axis;
+			}
+		}
 	}
 
-	return true;
+	if (bestTriangleEdge != -1)
+	{
+		LineSegment3 hullEdge = hullWs.GetEdgeSegment(bestHullEdge);
+
+		Vector3 trianglePt, hullPt;
+		FindNearestPoints(triangleWs.m_points[bestTriangleEdge], triangleWs.m_points[(bestTriangleEdge + 1) % 3], hullEdge.m_a, hullEdge.m_b, trianglePt, hullPt);
+
+		ManifoldPoint point;
+		point.position = 0.5f * (trianglePt + hullPt);
+		point.normal = bestAxis;
+		point.penetration = bestPen;
+		AddManifoldCandidate(points, inout_numPoints, MAX_MANIFOLD_CANDIDATES, point);
+	}
+	else if (bestHullFace != -1)
+	{
+		// Hull face is the reference, clip the triangle to it
+		Plane3 refPlane = hullWs.GetFaceSupportPlane(bestHullFace);
+
+		std::vector<Vector3>& clippedVertices = s_narrowphaseScratch.m_clipVertices[0];
+		clippedVertices.assign(triangleWs.m_points, triangleWs.m_points + 3);
+		hullWs.ClipPolygonToFace(bestHullFace, clippedVertices, s_narrowphaseScratch.m_clipVertices[1]);
+
+		int numClipped = (int)clippedVertices.size();
+		for (int iVertex = 0; iVertex < numClipped; ++iVertex)
+		{
+			float distance = refPlane.GetDistanceFromPlane(clippedVertices[iVertex]);
+			if (distance >= 0.f)
+				continue;
+
+			ManifoldPoint point;
+			point.position = refPlane.GetProjectedPointOntoPlane(clippedVertices[iVertex]);
+			point.normal = bestAxis;
+			point.penetration = -1.0f * distance;
+			AddManifoldCandidate(points, inout_numPoints, MAX_MANIFOLD_CANDIDATES, point);
+		}
+	}
+	else
+	{
+		// Triangle is the reference, clip the hull face most facing it to the triangle
+		int iIncidentFace = hullWs.GetIndexOfFaceMostInDirection(-1.0f * normalWs);
+		std::vector<Vector3>& clippedVertices = s_narrowphaseScratch.m_clipVertices[0];
+		hullWs.GetAllVerticesInFace(iIncidentFace, clippedVertices);
+		ClipPolygonToTriangle(triangleWs, normalWs, clippedVertices, s_narrowphaseScratch.m_clipVertices[1]);
+
+		int numClipped = (int)clippedVertices.size();
+		for (int iVertex = 0; iVertex < numClipped; ++iVertex)
+		{
+			float distance = DotProduct(clippedVertices[iVertex] - triangleWs.m_a, normalWs);
+			if (distance >= 0.f)
+				continue;
+
+			ManifoldPoint point;
+			point.position = clippedVertices[iVertex] - distance * normalWs;
+			point.normal = normalWs;
+			point.penetration = -1.0f * distance;
+			AddManifoldCandidate(points, inout_numPoints, MAX_MANIFOLD_CANDIDATES, point);
+		}
+	}
 }
 
 
 //-------------------------------------------------------------------------------------------------
-static int CreateFaceVertexContact(const BoxCollider* faceCol, const BoxCollider* vertexCol, const Vector3 &aToB, Contact* out_contact, const int bestAxisIndex, int limit)
+static int GenerateContacts_HullTriangleMeshInternal(const Collider* a, const TriangleMeshCollider* meshCol, const Polyhedron& hullWs, Contact* out_contacts, int limit)
 {
-	// This method is called when we know that a vertex from
-	// box two is in contact with box one.
-	OBB3 one = faceCol->GetDataInWorldSpace();
-	OBB3 two = vertexCol->GetDataInWorldSpace();
-	ASSERT_REASONABLE(one);
-	ASSERT_REASONABLE(two);
+	int numVertices = hullWs.GetNumVertices();
+	if (numVertices == 0)
+		return 0;
 
-	// We know which axis the collision is on (i.e. best),
-	// but we need to work out which of the two faces on
-	// this axis.
-	Vector3 normal = Matrix3(one.rotation).columnVectors[bestAxisIndex];
-	if (DotProduct(normal, aToB) > 0.f)
+	std::vector<Vector3>& hullVertsWs = s_narrowphaseScratch.m_pointsWs;
+	hullVertsWs.resize(numVertices);
+
+	for (int iVertex = 0; iVertex < numVertices; ++iVertex)
 	{
-		normal = normal * -1.0f;
+		hullVertsWs[iVertex] = hullWs.GetVertexPosition(iVertex);
 	}
 
-	ASSERT_OR_DIE(AreMostlyEqual(normal.GetLength(), 1.0f), "Normal not unit!");
+	std::vector<int>& triangleIndices = s_narrowphaseScratch.m_triangleIndices;
+	GetMeshTrianglesNearPoints(meshCol, hullVertsWs.data(), numVertices, 0.f, triangleIndices);
+	int numTriangles = (int)triangleIndices.size();
 
+	Vector3 hullCenterWs = hullWs.GetCenter();
+	ManifoldPoint points[MAX_MANIFOLD_CANDIDATES];
+	int numPoints = 0;
 
-	Vector3 vertexOffsetOne = one.extents;
-	if (DotProduct(one.GetRightVector(), normal) > 0.f) { vertexOffsetOne.x = -vertexOffsetOne.x; }
-	if (DotProduct(one.GetUpVector(), normal) > 0.f) { vertexOffsetOne.y = -vertexOffsetOne.y; }
-	if (DotProduct(one.GetForwardVector(), normal) > 0.f) { vertexOffsetOne.z = -vertexOffsetOne.z; }
+	for (int i = 0; i < numTriangles; ++i)
+	{
+		int triangleIndex = triangleIndices[i];
+		Triangle3 triangleWs = meshCol->GetTriangleWs(triangleIndex);
+		Vector3 normalWs = GetTriangleNormalWs(meshCol, triangleIndex);
 
-	Plane3 plane(normal, Matrix3(one.rotation) * vertexOffsetOne + one.center);
+		AddHullTriangleContacts(hullWs, hullCenterWs, triangleWs, normalWs, meshCol->GetTriangle(triangleIndex).m_activeEdgeFlags, points, numPoints);
+	}
 
-	Vector3 points[8];
-	two.GetPoints(points);
+	return FinishGatheredContacts(a, meshCol, points, numPoints, out_contacts, limit);
+}
 
-	int numContactsAdded = 0;
-	for (int i = 0; i < 8; ++i)
-	{
-		float distance = plane.GetDistanceFromPlane(points[i]);
 
-		if (distance > 0.f && one.ContainsWorldSpacePoint(points[i]))
-		{
-			out_contact->normal = normal;
-			out_contact->penetration = distance;
-			out_contact->position = points[i]; 
-			FillOutColliderInfo(out_contact, faceCol, vertexCol);
+//-------------------------------------------------------------------------------------------------
+static bool IsOverlappingTriangleMesh(const Collider* shapeCol, const TriangleMeshCollider* meshCol)
+{
+	ConvexCoreWs shapeCore(shapeCol);
 
-			out_contact->CheckValuesAreReasonable();
-			out_contact++;
+	Vector3 cornersWs[8];
+	GetConvexCoreBoundsCornersWs(shapeCore, cornersWs);
 
-			numContactsAdded++;
+	std::vector<int>& triangleIndices = s_narrowphaseScratch.m_triangleIndices;
+	GetMeshTrianglesNearPoints(meshCol, cornersWs, 8, 0.f, triangleIndices);
+	int numTriangles = (int)triangleIndices.size();
 
-			if (numContactsAdded >= limit)
-				break;
-		}
-	}
+	for (int i = 0; i < numTriangles; ++i)
+	{
+		ConvexCoreWs triangleCore(meshCol->GetTriangleWs(triangleIndices[i]));
 
-	return numContactsAdded;
+		GJKSolver3D<ConvexCoreWs, ConvexCoreWs> solver(shapeCore, triangleCore);
+		if (!solver.Solve())
+			continue;
 
-	// Single vertex version - just finds the vertex most in the direction of the normal, and uses the axis pen as the amount of pen
+		float separation = solver.GetSeparationDistance();
+		if (separation <= 0.f || separation < shapeCore.m_radius)
+			return true;
+	}
 
-	/*Vector3 vertexOffset = two.extents;
-	if (DotProduct(two.GetRightVector(), normal) < 0.f)	{ vertexOffset.x = -vertexOffset.x; }
-	if (DotProduct(two.GetUpVector(), normal) < 0.f)		{ vertexOffset.y = -vertexOffset.y; }
-	if (DotProduct(two.GetForwardVector(), normal) < 0.f)	{ vertexOffset.z = -vertexOffset.z; }
+	return false;
+}
 
-	// Create the contact data
-	out_contact->normal = normal;
-	out_contact->penetration = pen;
-	out_contact->position = (Matrix3(two.rotation) * vertexOffset) + two.center; // Convert from vertex box space to world space
-	FillOutColliderInfo(out_contact, faceCol, vertexCol);*/
 
+//-------------------------------------------------------------------------------------------------
+static inline __m128 DotProduct4(const __m128* a, const __m128* b)
+{
+	return _mm_add_ps(_mm_add_ps(_mm_mul_ps(a[0], b[0]), _mm_mul_ps(a[1], b[1])), _mm_mul_ps(a[2], b[2]));
 }
 
 
 //-------------------------------------------------------------------------------------------------
-// Regarding useOne param: if this is true, and the contact point is outside
-// the edge (in the case of an edge-face contact) then
-// we use one's midpoint, otherwise we use two's.
-static inline Vector3 CalculateEdgeEdgeContactPosition(const Vector3& ptOnEdgeOne, const Vector3& oneAxis, float oneSize, const Vector3& ptOnEdgeTwo, const Vector3& twoAxis, float twoSize, bool useOne)
+static inline void CrossProduct4(const __m128* a, const __m128* b, __m128* out_cross)
 {
-	ASSERT_REASONABLE(ptOnEdgeOne);
+	out_cross[0] = _mm_sub_ps(_mm_mul_ps(a[1], b[2]), _mm_mul_ps(a[2], b[1]));
+	out_cross[1] = _mm_sub_ps(_mm_mul_ps(a[2], b[0]), _mm_mul_ps(a[0], b[2]));
+	out_cross[2] = _mm_sub_ps(_mm_mul_ps(a[0], b[1]), _mm_mul_ps(a[1], b[0]));
+}
 
-	Vector3 toSt, cOne, cTwo;
-	float dpStaOne, dpStaTwo, dpOneTwo, smOne, smTwo;
-	float denom, mua, mub;
 
-	smOne = oneAxis.GetLengthSquared();
-	smTwo = twoAxis.GetLengthSquared();
-	dpOneTwo = DotProduct(twoAxis, oneAxis);
+//-------------------------------------------------------------------------------------------------
+static inline __m128 Abs4(__m128 value)
+{
+	return _mm_andnot_ps(_mm_set1_ps(-0.f), value);
+}
 
-	toSt = ptOnEdgeOne - ptOnEdgeTwo;
-	dpStaOne = DotProduct(oneAxis, toSt);
-	dpStaTwo = DotProduct(twoAxis, toSt);
 
-	denom = smOne * smTwo - dpOneTwo * dpOneTwo;
+//-------------------------------------------------------------------------------------------------
+// Unused lanes are left zeroed
+static void GatherBoxLanes(const Collider* const* boxColliders, int numLanes, OBB3* out_boxesWs, BoxLanes& out_lanes)
+{
+	float center[3][4] = {};
+	float axes[3][3][4] = {};
+	float extents[3][4] = {};
 
-	// Zero denominator indicates parallel lines
-	if (Abs(denom) < 0.0001f) {
-		return useOne ? ptOnEdgeOne : ptOnEdgeTwo;
-	}
+	for (int laneIndex = 0; laneIndex < numLanes; ++laneIndex)
+	{
+		const OBB3& boxWs = out_boxesWs[laneIndex] = ColliderCast<BoxCollider>(boxColliders[laneIndex])->GetDataInWorldSpace();
+		Matrix3 basis(boxWs.rotation);
 
-	mua = (dpOneTwo * dpStaTwo - smTwo * dpStaOne) / denom;
-	mub = (smOne * dpStaTwo - dpOneTwo * dpStaOne) / denom;
+		for (int component = 0; component < 3; ++component)
+		{
+			center[component][laneIndex] = boxWs.center.data[component];
+			extents[component][laneIndex] = boxWs.extents.data[component];
 
-	// If either of the edges has the nearest point out
-	// of bounds, then the edges aren't crossed, we have
-	// an edge-face contact. Our point is on the edge, which
-	// we know from the useOne parameter.
-	if (mua > oneSize ||
-		mua < -oneSize ||
-		mub > twoSize ||
-		mub < -twoSize)
-	{
-		return useOne ? ptOnEdgeOne : ptOnEdgeTwo;
+			for (int axisIndex = 0; axisIndex < 3; ++axisIndex)
+			{
+				axes[axisIndex][component][laneIndex] = basis.columnVectors[axisIndex].data[component];
+			}
+		}
 	}
-	else
+
+	for (int component = 0; component < 3; ++component)
 	{
-		cOne = ptOnEdgeOne + oneAxis * mua;
-		cTwo = ptOnEdgeTwo + twoAxis * mub;
+		out_lanes.center[component] = _mm_loadu_ps(center[component]);
+		out_lanes.extents[component] = _mm_loadu_ps(extents[component]);
 
-		return cOne * 0.5 + cTwo * 0.5;
+		for (int axisIndex = 0; axisIndex < 3; ++axisIndex)
+		{
+			out_lanes.axes[axisIndex][component] = _mm_loadu_ps(axes[axisIndex][component]);
+		}
 	}
 }
 
-// This preprocessor definition is only used as a convenience
-// in the boxAndBox contact generation method.
-#define CHECK_OVERLAP(axis, index) \
-    if (!CheckAxis(aBoxCol, bBoxCol, (axis), aToB, (index), pen, best)) return 0;
 
-int CollisionDetector::GenerateContacts_BoxBox(const Collider* a, const Collider* b, Contact* out_contacts, int limit)
+//-------------------------------------------------------------------------------------------------
+// Picks a where the mask is set, b elsewhere
+static inline __m128 Select4(__m128 mask, __m128 a, __m128 b)
 {
-	const BoxCollider* aBoxCol = a->GetAsType<BoxCollider>();
-	const BoxCollider* bBoxCol = b->GetAsType<BoxCollider>();
-	ASSERT_OR_DIE(aBoxCol != nullptr && bBoxCol != nullptr, "Colliders are of wrong type!");
+	return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b));
+}
 
-	if (limit <= 0)
-		return 0;
 
-	OBB3 aBox = aBoxCol->GetDataInWorldSpace();
-	OBB3 bBox = bBoxCol->GetDataInWorldSpace();
-	ASSERT_REASONABLE(aBox);
-	ASSERT_REASONABLE(bBox);
+//-------------------------------------------------------------------------------------------------
+// CheckAxis() from the scalar box-box test, 4 pairs at a time
+// Same operation order and tie-breaking, so the separation and best axis match the scalar path bit for bit
+// Lanes that were already separated keep updating, but their results are never read
+static void CheckAxisLanes(const __m128* axis, float axisIndex, const BoxLanes& a, const BoxLanes& b, const __m128* aToB, __m128& inout_isSeparated, __m128& inout_smallestPen, __m128& inout_smallestIndex)
+{
+	// Don't check almost parallel axes
+	__m128 lengthSquared = DotProduct4(axis, axis);
+	__m128 isAxisValid = _mm_cmpgt_ps(lengthSquared, _mm_set1_ps(DEFAULT_EPSILON));
 
-	Matrix3 aBasis(aBox.GetRightVector(), aBox.GetUpVector(), aBox.GetForwardVector());
-	Matrix3 bBasis(bBox.GetRightVector(), bBox.GetUpVector(), bBox.GetForwardVector());
-	ASSERT_REASONABLE(aBasis);
-	ASSERT_REASONABLE(bBasis);
+	__m128 oneOverLength = _mm_div_ps(_mm_set1_ps(1.f), _mm_sqrt_ps(lengthSquared));
+	__m128 unitAxis[3] = { _mm_mul_ps(axis[0], oneOverLength), _mm_mul_ps(axis[1], oneOverLength), _mm_mul_ps(axis[2], oneOverLength) };
 
-	Vector3 aToB = bBox.center - aBox.center;
-	ASSERT_REASONABLE(aToB);
+	__m128 aProjection = _mm_add_ps(_mm_add_ps(
+		_mm_mul_ps(a.extents[0], Abs4(DotProduct4(unitAxis, a.axes[0]))),
+		_mm_mul_ps(a.extents[1], Abs4(DotProduct4(unitAxis, a.axes[1])))),
+		_mm_mul_ps(a.extents[2], Abs4(DotProduct4(unitAxis, a.axes[2]))));
 
-	// We start assuming there is no contact
-	float pen = FLT_MAX;
-	unsigned best = 0xffffff;
+	__m128 bProjection = _mm_add_ps(_mm_add_ps(
+		_mm_mul_ps(b.extents[0], Abs4(DotProduct4(unitAxis, b.axes[0]))),
+		_mm_mul_ps(b.extents[1], Abs4(DotProduct4(unitAxis, b.axes[1])))),
+		_mm_mul_ps(b.extents[2], Abs4(DotProduct4(unitAxis, b.axes[2]))));
 
-	// Now we check each axes, returning if it gives us
-	// a separating axis, and keeping track of the axis with
-	// the smallest penetration otherwise.
-	CHECK_OVERLAP(aBasis.columnVectors[0], 0);
-	CHECK_OVERLAP(aBasis.columnVectors[1], 1);
-	CHECK_OVERLAP(aBasis.columnVectors[2], 2);
+	__m128 distance = Abs4(DotProduct4(aToB, unitAxis));
+	__m128 penetration = _mm_sub_ps(_mm_add_ps(aProjection, bProjection), distance);
 
-	CHECK_OVERLAP(bBasis.columnVectors[0], 3);
-	CHECK_OVERLAP(bBasis.columnVectors[1], 4);
-	CHECK_OVERLAP(bBasis.columnVectors[2], 5);
+	inout_isSeparated = _mm_or_ps(inout_isSeparated, _mm_and_ps(isAxisValid, _mm_cmplt_ps(penetration, _mm_setzero_ps())));
 
-	// Store the best axis-major, in case we run into almost
-	// parallel edge collisions later
-	unsigned int bestSingleAxis = best;
+	__m128 isSmaller = _mm_and_ps(isAxisValid, _mm_cmplt_ps(penetration, inout_smallestPen));
+	inout_smallestPen = Select4(isSmaller, penetration, inout_smallestPen);
+	inout_smallestIndex = Select4(isSmaller, _mm_set1_ps(axisIndex), inout_smallestIndex);
+}
 
-	CHECK_OVERLAP(CrossProduct(aBasis.columnVectors[0], bBasis.columnVectors[0]), 6);
-	CHECK_OVERLAP(CrossProduct(aBasis.columnVectors[0], bBasis.columnVectors[1]), 7);
-	CHECK_OVERLAP(CrossProduct(aBasis.columnVectors[0], bBasis.columnVectors[2]), 8);
-	CHECK_OVERLAP(CrossProduct(aBasis.columnVectors[1], bBasis.columnVectors[0]), 9);
-	CHECK_OVERLAP(CrossProduct(aBasis.columnVectors[1], bBasis.columnVectors[1]), 10);
-	CHECK_OVERLAP(CrossProduct(aBasis.columnVectors[1], bBasis.columnVectors[2]), 11);
-	CHECK_OVERLAP(CrossProduct(aBasis.columnVectors[2], bBasis.columnVectors[0]), 12);
-	CHECK_OVERLAP(CrossProduct(aBasis.columnVectors[2], bBasis.columnVectors[1]), 13);
-	CHECK_OVERLAP(CrossProduct(aBasis.columnVectors[2], bBasis.columnVectors[2]), 14);
 
-	// Make sure we've got a result.
-	ASSERT_OR_DIE(best != 0xffffff, "No best index found!");
+///--------------------------------------------------------------------------------------------------------------------------------------------------
+/// CLASS IMPLEMENTATIONS
+///--------------------------------------------------------------------------------------------------------------------------------------------------
 
-	// We now know there's a collision, and we know which
-	// of the axes gave the smallest penetration. We now
-	// can deal with it in different ways depending on
-	// the case.
-	if (best < 3)
-	{
-		// We've vertices of box two on a face of box one.
-		return CreateFaceVertexContact(aBoxCol, bBoxCol, aToB, out_contacts, best, limit);
-	}
-	else if (best < 6)
+//-------------------------------------------------------------------------------------------------
+int CollisionDetector::GenerateContacts_SphereSphere(const Collider* a, const Collider* b, Contact* out_contacts, int limit)
+{
+	const SphereCollider* aSphereCol = ColliderCast<SphereCollider>(a);
+	const SphereCollider* bSphereCol = ColliderCast<SphereCollider>(b);
+
+	ASSERT_OR_DIE(aSphereCol != nullptr && bSphereCol != nullptr, "Colliders not the right type!");
+
+	if (limit <= 0)
+		return 0;
+
+	Sphere aSphere = aSphereCol->GetDataInWorldSpace();
+	Sphere bSphere = bSphereCol->GetDataInWorldSpace();
+
+	Vector3 bToA = aSphere.m_center - bSphere.m_center;
+	float distanceSquared = bToA.GetLengthSquared();
+
+	if (distanceSquared >= (aSphere.m_radius + bSphere.m_radius) * (aSphere.m_radius + bSphere.m_radius))
 	{
-		// We've got vertices of box one on a face of box two.
-		// We use the same algorithm as above, but swap around
-		// one and two (and therefore also the vector between their
-		// centers).
-		return CreateFaceVertexContact(bBoxCol, aBoxCol, aToB*-1.0f, out_contacts, best - 3, limit);
+		return 0;
 	}
-	else
-	{
-		// We've got an edge-edge contact. Find out which axes
-		best -= 6;
-		int oneAxisIndex = best / 3;
-		int twoAxisIndex = best % 3;
-		Vector3 oneAxis = aBasis.columnVectors[oneAxisIndex];
-		Vector3 twoAxis = bBasis.columnVectors[twoAxisIndex];
-		Vector3 axis = CrossProduct(oneAxis, twoAxis);
-		axis.Normalize();
 
-		// The axis should point from box one to box two.
-		bool flippedAxis = false;
-		if (DotProduct(axis, aToB) > 0.f)
-		{
-			axis = axis * -1.0f;
-			flippedAxis = true;
-		}
+	float distance = bToA.Normalize();
 
-		// We have the axes, but not the edges: each axis has 4 edges parallel
-		// to it, we need to find which of the 4 for each object. We do
-		// that by finding the point in the centers of the edge. We know
-		// its component in the direction of the box's collision axis is zero
-		// (its a mid-point) and we determine which of the extremes in each
-		// of the other axes is closest.
-		Vector3 ptOnOneEdgeLs = aBox.extents;
-		Vector3 ptOnTwoEdgeLs = bBox.extents;
-		for (int i = 0; i < 3; i++)
-		{
-			if (i == oneAxisIndex)
-			{
-				ptOnOneEdgeLs.data[i] = 0.f;
-			}
-			else if (DotProduct(aBasis.columnVectors[i], axis) > 0.f)
-			{
-				ptOnOneEdgeLs.data[i] = -ptOnOneEdgeLs.data[i];
-			}
+	out_contacts->position = bSphere.m_center + 0.5f * distance * bToA;			// Contact position is the midpoint between the centers
+	out_contacts->normal = bToA;												// Orientation is set up s.t adding the normal to A would resolve the collision, -normal to B
+	out_contacts->penetration = (aSphere.m_radius + bSphere.m_radius) - distance;	// Pen is the overlap
+	FillOutColliderInfo(out_contacts, aSphereCol, bSphereCol);
 
-			if (i == twoAxisIndex)
-			{
-				ptOnTwoEdgeLs.data[i] = 0.f;
-			}
-			else if (DotProduct(bBasis.columnVectors[i], axis) < 0.f)
-			{
-				ptOnTwoEdgeLs.data[i] = -ptOnTwoEdgeLs.data[i];
-			}
-		}
+	out_contacts->CheckValuesAreReasonable();
+	return 1;
+}
 
-		// Move them into world coordinates (they are already oriented
-		// correctly, since they have been derived from the axes).
-		Vector3 ptOnOneEdgeWs = (aBasis * ptOnOneEdgeLs) + aBox.center;
-		Vector3 ptOnTwoEdgeWs = (bBasis * ptOnTwoEdgeLs) + bBox.center;
 
-		// So we have a point and a direction for the colliding edges.
-		// We need to find out point of closest approach of the two
-		// line-segments.
-		Vector3 vertex = CalculateEdgeEdgeContactPosition(
-			ptOnOneEdgeWs, oneAxis, aBox.extents.data[oneAxisIndex],
-			ptOnTwoEdgeWs, twoAxis, bBox.extents.data[twoAxisIndex],
-			bestSingleAxis > 2
-		);
+//-------------------------------------------------------------------------------------------------
+int CollisionDetector::GenerateContacts(const Collider* a, const Collider* b, Contact* out_contacts, int limit)
+{
+	if (limit <= 0)
+		return 0;
 
-		// We can fill the contact.
-		out_contacts->penetration = pen;
-		out_contacts->normal = axis;
-		out_contacts->position = vertex;
-		FillOutColliderInfo(out_contacts, aBoxCol, bBoxCol);
+	int firstIndex = a->GetTypeIndex();
+	int secondIndex = b->GetTypeIndex();
 
-		out_contacts->CheckValuesAreReasonable();
-		return 1;
+	if (firstIndex > secondIndex)
+	{
+		int temp = firstIndex;
+		firstIndex = secondIndex;
+		secondIndex = temp;
+
+		const Collider* tempPtr = a;
+		a = b;
+		b = tempPtr;
+	}
+
+	//ASSERT_OR_DIE(s_colliderMatrix[firstIndex][secondIndex] != nullptr, "Collision matrix missing an entry!");
+
+	if (s_colliderMatrix[firstIndex][secondIndex] != nullptr)
+	{
+		return (this->*s_colliderMatrix[firstIndex][secondIndex])(a, b, out_contacts, limit);
 	}
 
 	return 0;
 }
 
-#undef CHECK_OVERLAP
 
 //-------------------------------------------------------------------------------------------------
-static int GenerateContacts_HullHullInternal(const Collider* a, const Collider* b, const Polyhedron& aHullWs, const Polyhedron& bHullWs, Contact* out_contacts, int limit)
+bool CollisionDetector::AreOverlapping(const Collider* a, const Collider* b) const
 {
-	int numContacts = 0;
-	SATResult_HullHull result;
-	bool hasOverlap = SAT::GetMinPenAxis(aHullWs, bHullWs, result);
+	// Same ordering as the collider matrix, so planes and half spaces always end up as a
+	if (a->GetTypeIndex() > b->GetTypeIndex())
+	{
+		const Collider* temp = a;
+		a = b;
+		b = temp;
+	}
 
-	if (hasOverlap)
+	// Compounds are the highest type index so they're always b, and overlap if any child does
+	if (b->GetTypeIndex() == CompoundCollider::TYPE_INDEX)
 	{
-		if (result.m_isFaceAxis)
+		const CompoundCollider* bCompoundCol = ColliderCast<CompoundCollider>(b);
+
+		int childIndices[CompoundCollider::MAX_CHILDREN];
+		int numChildren = bCompoundCol->GetChildrenOverlapping(a, childIndices, CompoundCollider::MAX_CHILDREN);
+
+		for (int i = 0; i < numChildren; ++i)
 		{
-			// Face/face collision, clip incident to the reference face
-			bool aIsRef = (result.m_iFaceOrEdgeA != -1);
-			const Polyhedron& refHull = (aIsRef ? aHullWs : bHullWs);
-			const Polyhedron& incHull = (aIsRef ? bHullWs : aHullWs);
-			int iRefFace = (aIsRef ? result.m_iFaceOrEdgeA : result.m_iFaceOrEdgeB);
+			if (AreOverlapping(a, bCompoundCol->GetChild(childIndices[i])))
+				return true;
+		}
 
-			Plane3 refPlane = refHull.GetFaceSupportPlane(iRefFace);
-			int iIncFace = incHull.GetIndexOfFaceMostInDirection(-1.0f * refPlane.m_normal);
+		return false;
+	}
 
-			Polygon3 incFacePoly;
-			incHull.GetFace(iIncFace, incFacePoly);
-			refHull.ClipFaceToFace(iRefFace, incFacePoly);
+	bool aIsHalfSpace = (a->GetTypeIndex() == HalfSpaceCollider::TYPE_INDEX);
+	bool aIsPlane = (a->GetTypeIndex() == PlaneCollider::TYPE_INDEX);
 
-			int numVerts = (int)incFacePoly.GetNumVertices();
-			int maxContacts = Min(numVerts, limit);
-			int iVertex = 0;
-			while (iVertex < numVerts && numContacts < maxContacts) // while there's still vertices to check and we still have room for more contacts
-			{
-				Vector3 incVertex = incFacePoly.m_vertices[iVertex];
-				float pen = -1.0f * refPlane.GetDistanceFromPlane(incVertex);
+	// Voxel grids aren't convex, so check against each solid cell the shape could touch instead
+	if (b->GetTypeIndex() == VoxelGridCollider::TYPE_INDEX)
+	{
+		if (aIsHalfSpace || aIsPlane || (a->GetTypeIndex() == VoxelGridCollider::TYPE_INDEX))
+			return false;
 
-				if (pen > 0.f)
-				{
-					out_contacts[numContacts].penetration = pen;
-					out_contacts[numContacts].normal = refPlane.m_normal;
-					out_contacts[numContacts].position = refPlane.GetProjectedPointOntoPlane(incVertex);
-					FillOutColliderInfo(&out_contacts[numContacts], (aIsRef ? b : a), (aIsRef ? a : b));
-					out_contacts[numContacts].CheckValuesAreReasonable();
+		return IsOverlappingVoxelGrid(a, ColliderCast<VoxelGridCollider>(b));
+	}
 
-					numContacts++;
-				}
+	// Same for triangle meshes, check each triangle near the shape
+	if (b->GetTypeIndex() == TriangleMeshCollider::TYPE_INDEX)
+	{
+		if (aIsHalfSpace || aIsPlane || (a->GetTypeIndex() == VoxelGridCollider::TYPE_INDEX) || (a->GetTypeIndex() == TriangleMeshCollider::TYPE_INDEX))
+			return false;
 
-				iVertex++;
-			}
-		}
-		else
-		{
-			const LineSegment3 aEdge = aHullWs.GetEdgeSegment(result.m_iFaceOrEdgeA);
-			const LineSegment3 bEdge = bHullWs.GetEdgeSegment(result.m_iFaceOrEdgeB);
+		return IsOverlappingTriangleMesh(a, ColliderCast<TriangleMeshCollider>(b));
+	}
 
-			Vector3 aPt, bPt;
-			float distance = FindNearestPoints(aEdge, bEdge, aPt, bPt);
+	if (aIsHalfSpace || aIsPlane)
+	{
+		// Infinite planes overlapping each other isn't meaningful
+		if ((b->GetTypeIndex() == HalfSpaceCollider::TYPE_INDEX) || (b->GetTypeIndex() == PlaneCollider::TYPE_INDEX))
+			return false;
 
-			Vector3 normal = CrossProduct(aEdge.m_b - aEdge.m_a, bEdge.m_b - bEdge.m_a).GetNormalized();
-			Vector3 outOfA = aPt - aHullWs.GetCenter();
-			if (DotProduct(outOfA, normal) > 0.f)
-			{
-				normal *= -1.0f;
-			}
+		Plane3 planeWs = (aIsHalfSpace ? ColliderCast<HalfSpaceCollider>(a)->GetDataInWorldSpace() : ColliderCast<PlaneCollider>(a)->GetDataInWorldSpace());
+		ConvexCoreWs coreB(b);
 
-			out_contacts[0].penetration = distance;
-			out_contacts[0].normal = normal;
-			out_contacts[0].position = 0.5f * (aPt + bPt);
-			FillOutColliderInfo(&out_contacts[0], a, b);
-			out_contacts[0].CheckValuesAreReasonable();
+		Vector3 backPt;
+		coreB.GetSupportPoint(-1.0f * planeWs.m_normal, backPt);
+		float minDistance = planeWs.GetDistanceFromPlane(backPt) - coreB.m_radius;
 
-			numContacts = 1;
+		if (aIsHalfSpace)
+		{
+			return (minDistance < 0.f);
 		}
-	}
 
-	return numContacts;
-}
+		// Plane needs the shape to straddle it
+		Vector3 frontPt;
+		coreB.GetSupportPoint(planeWs.m_normal, frontPt);
+		float maxDistance = planeWs.GetDistanceFromPlane(frontPt) + coreB.m_radius;
 
+		return (minDistance < 0.f && maxDistance > 0.f);
+	}
 
-//-------------------------------------------------------------------------------------------------
-int CollisionDetector::GenerateContacts_BoxHull(const Collider* a, const Collider* b, Contact* out_contacts, int limit)
-{
-	if (limit <= 0)
-		return 0;
+	// Spheres are common enough for triggers to skip GJK entirely
+	if ((a->GetTypeIndex() == SphereCollider::TYPE_INDEX) && (b->GetTypeIndex() == SphereCollider::TYPE_INDEX))
+	{
+		return DoSpheresOverlap(ColliderCast<SphereCollider>(a)->GetDataInWorldSpace(), ColliderCast<SphereCollider>(b)->GetDataInWorldSpace());
+	}
 
-	const BoxCollider* aBoxCol = a->GetAsType<BoxCollider>();
-	const ConvexHullCollider* bHullCol = b->GetAsType<ConvexHullCollider>();
-	ASSERT_OR_DIE(aBoxCol != nullptr && bHullCol != nullptr, "Colliders are of wrong type!");
+	ConvexCoreWs coreA(a);
+	ConvexCoreWs coreB(b);
 
-	const OBB3 aBoxWs = aBoxCol->GetDataInWorldSpace();
-	const Polyhedron aHullWs = OBB3(aBoxWs);
-	const Polyhedron bHullWs = bHullCol->GetDataInWorldSpace();
+	GJKSolver3D<ConvexCoreWs, ConvexCoreWs> solver(coreA, coreB);
+	if (!solver.Solve())
+		return false;
 
-	return GenerateContacts_HullHullInternal(a, b, aHullWs, bHullWs, out_contacts, limit);
+	// Separation is zero when the cores themselves intersect
+	float separation = solver.GetSeparationDistance();
+	return (separation <= 0.f || separation < coreA.m_radius + coreB.m_radius);
 }
 
 
 //-------------------------------------------------------------------------------------------------
-int CollisionDetector::GenerateContacts_HullHull(const Collider* a, const Collider* b, Contact* out_contacts, int limit)
+int CollisionDetector::GenerateContacts_HalfSpaceSphere(const Collider* a, const Collider* b, Contact* out_contacts, int limit)
 {
+	const HalfSpaceCollider* aHalfspaceCol = ColliderCast<HalfSpaceCollider>(a);
+	const SphereCollider* bSphereCol = ColliderCast<SphereCollider>(b);
+
+	ASSERT_OR_DIE(aHalfspaceCol != nullptr && bSphereCol != nullptr, "Colliders not the right type!");
+
 	if (limit <= 0)
 		return 0;
 
-	const ConvexHullCollider* aHullCol = a->GetAsType<ConvexHullCollider>();
-	const ConvexHullCollider* bHullCol = b->GetAsType<ConvexHullCollider>();
-	ASSERT_OR_DIE(aHullCol != nullptr && bHullCol != nullptr, "Colliders are of wrong type!");
+	Plane3 planeWs = aHalfspaceCol->GetDataInWorldSpace();
+	Sphere sphereWs = bSphereCol->GetDataInWorldSpace();
 
-	const Polyhedron aHullWs = aHullCol->GetDataInWorldSpace();
-	const Polyhedron bHullWs = bHullCol->GetDataInWorldSpace();
+	float distance = planeWs.GetDistanceFromPlane(sphereWs.m_center) - sphereWs.m_radius;
+	
+	// Sphere too far in front of plane; its radius isn't enough to intersect the plane
+	if (distance >= 0)
+		return 0;
 
-	return GenerateContacts_HullHullInternal(a, b, aHullWs, bHullWs, out_contacts, limit);
+	out_contacts->normal = planeWs.m_normal;
+	out_contacts->penetration = -distance;
+	out_contacts->position = planeWs.GetProjectedPointOntoPlane(sphereWs.m_center);
+	FillOutColliderInfo(out_contacts, bSphereCol, aHalfspaceCol);
+
+	out_contacts->CheckValuesAreReasonable();
+	return 1;
 }
 
 
 //-------------------------------------------------------------------------------------------------
-int CollisionDetector::GenerateContacts_HalfSpaceCapsule(const Collider* a, const Collider* b, Contact* out_contacts, int limit)
+int CollisionDetector::GenerateContacts_HalfSpaceBox(const Collider* a, const Collider* b, Contact* out_contacts, int limit)
 {
-	const HalfSpaceCollider* aHalfSpaceCol = a->GetAsType<HalfSpaceCollider>();
-	const CapsuleCollider* bCapsuleCol = b->GetAsType<CapsuleCollider>();
-	ASSERT_OR_DIE(aHalfSpaceCol != nullptr && bCapsuleCol != nullptr, "Colliders are of wrong type!");
-	
+	const HalfSpaceCollider* aHalfSpaceCol = ColliderCast<HalfSpaceCollider>(a);
+	const BoxCollider* bBoxCollider = ColliderCast<BoxCollider>(b);
+	ASSERT_OR_DIE(aHalfSpaceCol != nullptr && bBoxCollider != nullptr, "Colliders are of wrong type!");
+
 	if (limit <= 0)
 		return 0;
 
 	Plane3 planeWs = aHalfSpaceCol->GetDataInWorldSpace();
-	Capsule3 capsuleWs = bCapsuleCol->GetDataInWorldSpace();
+	OBB3 boxWs = bBoxCollider->GetDataInWorldSpace();
 
-	float startDistance = planeWs.GetDistanceFromPlane(capsuleWs.start) - capsuleWs.radius;
-	float endDistance = planeWs.GetDistanceFromPlane(capsuleWs.end) - capsuleWs.radius;
+	Vector3 boxVertsWs[8];
+	boxWs.GetPoints(boxVertsWs);
 
-	if (startDistance >= 0.f && endDistance >= 0.f)
-		return 0;
+	int numContactsAdded = 0;
+	Contact* contactToFill = out_contacts;
 
-	int numAdded = 0;
-	Contact* contactToFill = &out_contacts[0];
-	if (startDistance < 0.f)
+	for (int i = 0; i < 8; ++i)
 	{
-		contactToFill->normal = planeWs.m_normal;
-		contactToFill->penetration = -startDistance;
-		contactToFill->position = capsuleWs.start - capsuleWs.radius * contactToFill->normal;
-		FillOutColliderInfo(contactToFill, bCapsuleCol, aHalfSpaceCol);
-		contactToFill->CheckValuesAreReasonable();
-		numAdded++;
-		contactToFill = &out_contacts[numAdded];
-
-		if (limit == 1)
-			return 1;
-	}
+		float distance = planeWs.GetDistanceFromPlane(boxVertsWs[i]);
 
-	if (endDistance < 0.f)
-	{
-		contactToFill->normal = planeWs.m_normal;
-		contactToFill->penetration = -endDistance;
-		contactToFill->position = capsuleWs.end - capsuleWs.radius * contactToFill->normal;
-		FillOutColliderInfo(contactToFill, bCapsuleCol, aHalfSpaceCol);
-		contactToFill->CheckValuesAreReasonable();
-		numAdded++;
+		if (distance < 0.f)
+		{
+			//contactToFill->position = 0.5f * (boxVertsWs[i] + planeWs.GetProjectedPointOntoPlane(boxVertsWs[i])); // Position is half way between the box vertex and the plane
+			contactToFill->position = boxVertsWs[i]; // Position is half way between the box vertex and the plane
+			contactToFill->normal = planeWs.m_normal;
+			contactToFill->penetration = Abs(distance);
+			FillOutColliderInfo(contactToFill, bBoxCollider, aHalfSpaceCol);
+			
+			contactToFill->CheckValuesAreReasonable();
+			numContactsAdded++;
+
+			if (numContactsAdded < limit)
+			{
+				contactToFill = &out_contacts[numContactsAdded];
+			}
+			else
+			{
+				break;
+			}
+		}
 	}
 
-	return numAdded;
+	return numContactsAdded;
 }
 
 
 //-------------------------------------------------------------------------------------------------
-int CollisionDetector::GenerateContacts_SphereCapsule(const Collider* a, const Collider* b, Contact* out_contacts, int limit)
+int CollisionDetector::GenerateContacts_HalfSpaceCylinder(const Collider* a, const Collider* b, Contact* out_contacts, int limit)
 {
-	const SphereCollider* aSphereCol = a->GetAsType<SphereCollider>();
-	const CapsuleCollider* bCapsuleCol = b->GetAsType<CapsuleCollider>();
-	ASSERT_OR_DIE(aSphereCol != nullptr && bCapsuleCol != nullptr, "Colliders are of wrong type!");
+	const HalfSpaceCollider* aHalfSpaceCol = ColliderCast<HalfSpaceCollider>(a);
+	const CylinderCollider* bCylinderCol = ColliderCast<CylinderCollider>(b);
+	ASSERT_OR_DIE(aHalfSpaceCol != nullptr && bCylinderCol != nullptr, "Colliders are of wrong type!");
 
 	if (limit <= 0)
 		return 0;
 
-	Sphere sphereWs = aSphereCol->GetDataInWorldSpace();
-	Capsule3 capsuleWs = bCapsuleCol->GetDataInWorldSpace();
+	const Plane3 planeWs = aHalfSpaceCol->GetDataInWorldSpace();
+	const Cylinder cylinderWs = bCylinderCol->GetDataInWorldSpace();
 
-	Vector3 closestCapsulePointWs;
-	float distance = FindNearestPoint(sphereWs.m_center, capsuleWs.start, capsuleWs.end, closestCapsulePointWs);
-	float overlap = (sphereWs.m_radius + capsuleWs.radius) - distance;
+	int numContactsAdded = 0;
+	Contact* contactToFill = out_contacts;
 
-	if (overlap > 0.f)
+	for (int i = 0; i < 2; ++i)
 	{
-		out_contacts->normal = (sphereWs.m_center - closestCapsulePointWs) / distance;
-		out_contacts->penetration = overlap;
-		out_contacts->position = 0.5f * (closestCapsulePointWs + sphereWs.m_center);
-		FillOutColliderInfo(out_contacts, aSphereCol, bCapsuleCol);
-		out_contacts->CheckValuesAreReasonable();
-
-		return 1;
-	}
-
-	return 0;
-}
+		Vector3 endPoint = (i == 0 ? cylinderWs.m_bottom : cylinderWs.m_top);
+		Vector3 spineDir = (i == 0 ? (cylinderWs.m_bottom - cylinderWs.m_top) : (cylinderWs.m_top - cylinderWs.m_bottom));
+		spineDir.Normalize();
 
+		// Get the vector from the end point to the plane
+		Vector3 projectedEndPoint = planeWs.GetProjectedPointOntoPlane(endPoint);
+		Vector3 endPointToPlane = projectedEndPoint - endPoint;
 
-//-------------------------------------------------------------------------------------------------
-int CollisionDetector::GenerateContacts_CapsuleCapsule(const Collider* a, const Collider* b, Contact* out_contacts, int limit)
-{
-	const CapsuleCollider* aCapsuleCol = a->GetAsType<CapsuleCollider>();
-	const CapsuleCollider* bCapsuleCol = b->GetAsType<CapsuleCollider>();
-	ASSERT_OR_DIE(aCapsuleCol != nullptr && bCapsuleCol != nullptr, "Colliders are of wrong type!");
+		// Project onto the spine vector
+		float dot = DotProduct(spineDir, endPointToPlane);
 
-	if (limit <= 0)
-		return 0;
+		// Get the projection of the endPointToPlane onto the disc of the cylinder
+		Vector3 discVector = endPointToPlane - spineDir * dot;
+		discVector.SafeNormalize(discVector); // In the case the cylinder is aligned with the normal of the plane, this vector will be 0 - that's fine, this will return the end point as the contact point
 
-	Capsule3 capsuleA = aCapsuleCol->GetDataInWorldSpace();
-	Capsule3 capsuleB = bCapsuleCol->GetDataInWorldSpace();
+		// In the case that the end point is below the plane, make sure we go the other direction
+		// to get the lower "edge" of the cylinder disc
+		if (DotProduct(discVector, planeWs.m_normal) > 0.f)
+		{
+			discVector *= -1.0f;
+		}
 
-	Vector3 ptOnA, ptOnB;
-	float distance = FindNearestPoints(capsuleA.start, capsuleA.end, capsuleB.start, capsuleB.end, ptOnA, ptOnB);
-	float overlap = (capsuleA.radius + capsuleB.radius) - distance;
+		Vector3 contactPos = endPoint + discVector * cylinderWs.m_radius;
+		float pen = planeWs.GetDistanceFromPlane(contactPos);
+		if (pen < 0.f)
+		{
+			// Contact!
+			contactToFill->position = contactPos;
+			contactToFill->normal = planeWs.m_normal;
+			contactToFill->penetration = Abs(pen);
+			FillOutColliderInfo(contactToFill, bCylinderCol, aHalfSpaceCol);
 
-	if (overlap > 0.f)
-	{
-		out_contacts->normal = (ptOnA - ptOnB) / distance;
-		out_contacts->penetration = overlap;
-		out_contacts->position = 0.5f * (ptOnA + ptOnB);
-		FillOutColliderInfo(out_contacts, aCapsuleCol, bCapsuleCol);
-		out_contacts->CheckValuesAreReasonable();
+			contactToFill->CheckValuesAreReasonable();
+			numContactsAdded++;
 
-		return 1;
+			if (numContactsAdded < limit)
+			{
+				contactToFill = &out_contacts[numContactsAdded];
+			}
+			else
+			{
+				break;
+			}
+		}
 	}
 
-	return 0;
+	return numContactsAdded;
 }
 
 
 //-------------------------------------------------------------------------------------------------
-static bool GetMinPlanePen(const OBB3& box, const Capsule3& capsule, float* out_pens, Vector3* out_positions, Vector3& out_normal)
+int CollisionDetector::GenerateContacts_HalfSpaceHull(const Collider* a, const Collider* b, Contact* out_contacts, int limit)
 {
-	out_pens[0] = FLT_MAX;
-	out_pens[1] = FLT_MAX;
+	const HalfSpaceCollider* aHalfSpaceCol = ColliderCast<HalfSpaceCollider>(a);
+	const ConvexHullCollider* bPolyCollider = ColliderCast<ConvexHullCollider>(b);
+	ASSERT_OR_DIE(aHalfSpaceCol != nullptr && bPolyCollider != nullptr, "Colliders are of wrong type!");
 
-	Vector3 startLs = box.TransformPositionIntoSpace(capsule.start);
-	Vector3 endLs = box.TransformPositionIntoSpace(capsule.end);
+	if (limit <= 0)
+		return 0;
 
-	float radius = capsule.radius;
-	Vector3 extents = box.extents;
+	Plane3 planeWs = aHalfSpaceCol->GetDataInWorldSpace();
+	Polyhedron& polyWs = s_narrowphaseScratch.m_hullsWs[0];
+	bPolyCollider->GetDataInWorldSpace(polyWs);
 
-	// Idea
-	// For each axis, see if the end point is "in the tube" of that axis (i.e. for x, make sure we're within the y and x extents - it's ok if we're to the left or right though, that's along the tube)
-	// If we are, that qualifies to be a face contact, so calculate the amount of push needed to correct out either side of the box for that axis
-	// At the end, take the min pen and that normal, making sure you use the right sign
-	Vector3 pens[2];
-	Vector3 signs[2];
+	int numContactsAdded = 0;
+	Contact* contactToFill = out_contacts;
+	int numVerts = polyWs.GetNumVertices();
 
-	// For each end point...
-	for (int i = 0; i < 2; ++i)
+	for (int iVert = 0; iVert < numVerts; ++iVert)
 	{
-		Vector3 endPoint = (i == 0 ? startLs : endLs);
+		Vector3 vertex = polyWs.GetVertexPosition(iVert);
+		float distance = planeWs.GetDistanceFromPlane(vertex);
 
-		// For each axis
-		for (int j = 0; j < 3; ++j)
+		if (distance < 0.f)
 		{
-			// Check the other 2 components to see if we're "in the tube"
-			bool inLateralBounds = true;
-			for (int k = 0; k < 3; ++k)
-			{
-				if (k == j)
-					continue;
-
-				if (endPoint.data[k] > extents.data[k] || endPoint.data[k] < -extents.data[k])
-				{
-					inLateralBounds = false;
-					break;
-				}
-			}
+			contactToFill->position = vertex;
+			contactToFill->normal = planeWs.m_normal;
+			contactToFill->penetration = Abs(distance);
+			FillOutColliderInfo(contactToFill, bPolyCollider, aHalfSpaceCol);
+			contactToFill->CheckValuesAreReasonable();
+			numContactsAdded++;
 
-			// If we're in the tube
-			if (inLateralBounds)
+			if (numContactsAdded < limit)
 			{
-				float posPen = extents.data[j] - endPoint.data[j] + radius;
-				float negPen = extents.data[j] + endPoint.data[j] + radius;
-
-				// See which direction along the tube is the shorter correction
-				if (posPen < negPen)
-				{
-					pens[i].data[j] = posPen;
-					signs[i].data[j] = 1.f;
-				}
-				else
-				{
-					pens[i].data[j] = negPen;
-					signs[i].data[j] = -1.f;
-				}
+				contactToFill = &out_contacts[numContactsAdded];
 			}
 			else
 			{
-				// Not in the tube - can't make a face contact on this axis (it'd be an edge contact at that point)
-				pens[i].data[j] = FLT_MAX;
+				break;
 			}
 		}
 	}
 
-	// Determine the best local normal for each end point
-	Vector3 normalsLs[2];
-	for (int i = 0; i < 2; ++i)
-	{
-		normalsLs[i] = Vector3::ZERO;
+	return numContactsAdded;
+}
 
-		const Vector3& axisPens = pens[i];
-		float minPen = Min(axisPens.x, axisPens.y, axisPens.z);
 
-		// If the min pen is negative, then this capsule's "sphere" is completely outside a face
-		// so it has no overlap
-		if (minPen < 0.f)
-			continue;
+//-------------------------------------------------------------------------------------------------
+int CollisionDetector::GenerateContacts_SphereBox(const Collider* a, const Collider* b, Contact* out_contacts, int limit)
+{
+	const SphereCollider* aSphereCol = ColliderCast<SphereCollider>(a);
+	const BoxCollider* bBoxCol = ColliderCast<BoxCollider>(b);
+	ASSERT_OR_DIE(aSphereCol != nullptr && bBoxCol != nullptr, "Colliders are of wrong type!");
 
-		for (int j = 0; j < 3; ++j)
-		{
-			if (minPen == axisPens.data[j])
-			{
-				normalsLs[i].data[j] = 1.f * signs[i].data[j];
-				out_pens[i] = minPen;
-				break;
-			}
-		}
-	}
+	if (limit <= 0)
+		return 0;
 
-	// If the endpoints find 2 different best faces, the capsule must be intersecting an edge
-	// Instead, just generate an edgepoint
-	float normalDot = DotProduct(normalsLs[0], normalsLs[1]);
-	if ((out_pens[0] < FLT_MAX && out_pens[1] < FLT_MAX) && AreMostlyEqual(normalDot, 0.f))
-	{
-		return false;
-	}
-	else if (AreMostlyEqual(normalDot, -1.f))
-	{
-		// The best normals are opposite sides of the cube haha
-		// Might be ok to just arbitrarily pick a way to push, as it might not matter that much at this point ("You shouldn't be here!")
-		ERROR_AND_DIE("Ha, capsule is stuck isn't it");
-	}
+	Sphere sphereWs = aSphereCol->GetDataInWorldSpace();
+	OBB3 boxWs = bBoxCol->GetDataInWorldSpace();
 
-	// Start and/or end could be valid contacts, but at this point they share a normal, so either once can calculate it
-	if (out_pens[0] < FLT_MAX)
-	{
-		Matrix3 basis(box.rotation);
-		out_normal = normalsLs[0].x * basis.columnVectors[0] + normalsLs[0].y * basis.columnVectors[1] + normalsLs[0].z * basis.columnVectors[2];
-		out_positions[0] = capsule.start - out_normal * radius;
-	}
+	// The basis is a rotation, so project onto its axes rather than inverting it (GenerateContactsBatch_SphereBox matches this)
+	Matrix3 boxBasis(boxWs.rotation);
+	Vector3 boxToSphere = sphereWs.m_center - boxWs.center;
+	Vector3 sphereCenterRel = Vector3(DotProduct(boxToSphere, boxBasis.iBasis), DotProduct(boxToSphere, boxBasis.jBasis), DotProduct(boxToSphere, boxBasis.kBasis));
 
-	if (out_pens[1] < FLT_MAX)
+	// Early out check
+	if (Abs(sphereCenterRel.x) - sphereWs.m_radius >= boxWs.extents.x ||
+		Abs(sphereCenterRel.y) - sphereWs.m_radius >= boxWs.extents.y ||
+		Abs(sphereCenterRel.z) - sphereWs.m_radius >= boxWs.extents.z)
 	{
-		Matrix3 basis(box.rotation);
-		out_normal = normalsLs[1].x * basis.columnVectors[0] + normalsLs[1].y * basis.columnVectors[1] + normalsLs[1].z * basis.columnVectors[2];
-		out_positions[1] = capsule.end - out_normal * radius;
+		return 0;
 	}
 
-	return (out_pens[0] < FLT_MAX || out_pens[1] < FLT_MAX);
-}
-
+	// Get the closest point on the box to the sphere
+	Vector3 closestPointRel = Clamp(sphereCenterRel, -1.0f * boxWs.extents, boxWs.extents);
+	Vector3 closestPointWs = (boxBasis * closestPointRel) + boxWs.center;
 
-//-------------------------------------------------------------------------------------------------
-static bool GetMinEdgePen(const OBB3& box, const Capsule3& capsule, float& out_pen, Vector3& out_normal, Vector3& out_position)
-{
-	out_pen = FLT_MAX;
+	// Get the distance from the sphere to the box point
+	Vector3 sphereToBox = closestPointWs - sphereWs.m_center;
+	float distanceSquared = sphereToBox.GetLengthSquared();
+	float radiusSquared = sphereWs.m_radius * sphereWs.m_radius;
+
+	if (AreMostlyEqual(distanceSquared, radiusSquared))
+		return 0;
+
+	// Create the contact
+	out_contacts->position = closestPointWs;
+	out_contacts->normal = sphereToBox;
+	float distance = out_contacts->normal.SafeNormalize(Vector3::Y_AXIS);
+	out_contacts->penetration = sphereWs.m_radius - distance;
+	FillOutColliderInfo(out_contacts, bBoxCol, aSphereCol);
+
+	out_contacts->CheckValuesAreReasonable();
+	return 1;
+}
+
+
+//-------------------------------------------------------------------------------------------------
+int CollisionDetector::GenerateContacts_SphereCylinder(const Collider* a, const Collider* b, Contact* out_contacts, int limit)
+{
+	if (limit <= 0)
+		return 0;
+
+	int numContacts = 0;
+	const SphereCollider* aSphereCol = ColliderCast<SphereCollider>(a);
+	const CylinderCollider* bCylinderCol = ColliderCast<CylinderCollider>(b);
+	ASSERT_OR_DIE(aSphereCol != nullptr && bCylinderCol != nullptr, "Colliders are of wrong type!");
+
+	const Sphere sphereWs = aSphereCol->GetDataInWorldSpace();
+	const Cylinder cylinderWs = bCylinderCol->GetDataInWorldSpace();
+
+	Vector3 bottomToSphere = (sphereWs.m_center - cylinderWs.m_bottom);
+
+	Vector3 cylSpine = (cylinderWs.m_top - cylinderWs.m_bottom);
+	float height = cylSpine.Normalize();
+	float dot = DotProduct(bottomToSphere, cylSpine);
+	Vector3 discVector = bottomToSphere - cylSpine * dot;
+
+	bool sphereVertical = (discVector.GetLengthSquared() < cylinderWs.m_radius * cylinderWs.m_radius);
+	float verticalPen = FLT_MAX;
+	Vector3 verticalNormal = Vector3::ZERO;
+	Vector3 verticalContactPos = Vector3::ZERO;
+
+	if (sphereVertical)
+	{
+		Plane3 topPlane(cylSpine, cylinderWs.m_top);
+		Plane3 bottomPlane(-1.0f * cylSpine, cylinderWs.m_bottom);
+		float topDist = topPlane.GetDistanceFromPlane(sphereWs.m_center);
+		float bottomDist = bottomPlane.GetDistanceFromPlane(sphereWs.m_center);
+
+		if (Abs(topDist) < Abs(bottomDist))
+		{
+			verticalNormal = cylSpine;
+			verticalPen = sphereWs.m_radius - topDist;
+			verticalContactPos = topPlane.GetProjectedPointOntoPlane(sphereWs.m_center);
+		}
+		else
+		{
+			verticalNormal = -1.0f * cylSpine;
+			verticalPen = sphereWs.m_radius - bottomDist;
+			verticalContactPos = bottomPlane.GetProjectedPointOntoPlane(sphereWs.m_center);
+		}
+	}
+
+	bool sphereHorizontal = (dot > 0.f && dot < height);
+	float horizontalPen = FLT_MAX;
+	Vector3 horizontalNormal = Vector3::ZERO;
+	Vector3 closestSpinePt;
+
+	if (sphereHorizontal)
+	{
+		float distanceToSpine = FindNearestPoint(sphereWs.m_center, cylinderWs.m_bottom, cylinderWs.m_top, closestSpinePt);
+		horizontalNormal = (sphereWs.m_center - closestSpinePt) / distanceToSpine;
+		ASSERT_OR_DIE(AreMostlyEqual(horizontalNormal.GetLength(), 1.0f), "My trick didn't work!");
+		horizontalPen = (sphereWs.m_radius + cylinderWs.m_radius) - distanceToSpine;
+	}
+
+	bool hasHorizontalPen = (horizontalPen > 0.f && horizontalPen < FLT_MAX);
+	bool hasVerticalPen = (verticalPen > 0.f && verticalPen < FLT_MAX);
+
+	if (hasHorizontalPen && hasVerticalPen)
+	{
+		// Sphere center is inside the cylinder, so push either vertically or horizontally, depending on which has less of a correction
+		if (verticalPen < horizontalPen)
+		{
+			out_contacts->position = verticalContactPos;
+			out_contacts->penetration = verticalPen;
+			out_contacts->normal = verticalNormal;
+			FillOutColliderInfo(out_contacts, aSphereCol, bCylinderCol);
+			numContacts++;
+		}
+		else
+		{
+			out_contacts->position = sphereWs.m_center - sphereWs.m_radius * horizontalNormal;
+			out_contacts->penetration = horizontalPen;
+			out_contacts->normal = horizontalNormal;
+			FillOutColliderInfo(out_contacts, aSphereCol, bCylinderCol);
+			numContacts++;
+		}
+	}
+	else if (hasVerticalPen)
+	{
+		// Sphere is overlapping a disc face, so push normal to the face
+		out_contacts->position = verticalContactPos;
+		out_contacts->penetration = verticalPen;
+		out_contacts->normal = verticalNormal;
+		FillOutColliderInfo(out_contacts, aSphereCol, bCylinderCol);
+		numContacts++;
+	}
+	else if (hasHorizontalPen)
+	{
+		// Sphere is overlapping the cylinder sides, so push outward
+		out_contacts->position = closestSpinePt + horizontalNormal * cylinderWs.m_radius;
+		out_contacts->penetration = horizontalPen;
+		out_contacts->normal = horizontalNormal;
+		FillOutColliderInfo(out_contacts, aSphereCol, bCylinderCol);
+		numContacts++;
+	}
+	else
+	{
+		// Sphere isn't overlapping the sides or the top/bottom faces, so check if it's overlapping an edge
+		Vector3 edgePoint = cylinderWs.GetFurthestEdgePointInDirection(bottomToSphere);
+		Vector3 edgeToSphere = sphereWs.m_center - edgePoint;
+		
+		if (edgeToSphere.GetLengthSquared() < sphereWs.m_radius * sphereWs.m_radius)
+		{
+			out_contacts->position = edgePoint;
+			out_contacts->penetration = sphereWs.m_radius - edgeToSphere.Normalize();
+			out_contacts->normal = edgeToSphere;
+			FillOutColliderInfo(out_contacts, aSphereCol, bCylinderCol);
+			numContacts++;
+		}
+	}
+
+	if (numContacts > 0)
+	{
+		out_contacts->CheckValuesAreReasonable();
+	}
+
+	return numContacts;
+}
+
+
+//-------------------------------------------------------------------------------------------------
+int CollisionDetector::GenerateContacts_SphereHull(const Collider* a, const Collider* b, Contact* out_contacts, int limit)
+{
+	if (limit <= 0)
+		return 0;
+
+	int numContacts = 0;
+	const SphereCollider* aSphereCol = ColliderCast<SphereCollider>(a);
+	const ConvexHullCollider* bHullCol = ColliderCast<ConvexHullCollider>(b);
+	ASSERT_OR_DIE(aSphereCol != nullptr && bHullCol != nullptr, "Colliders are of wrong type!");
+
+	const Sphere sphereWs = aSphereCol->GetDataInWorldSpace();
+	Polyhedron& polyWs = s_narrowphaseScratch.m_hullsWs[0];
+	bHullCol->GetDataInWorldSpace(polyWs);
+
+	Vector3 hullPt;
+	float dist = FindNearestPoint(sphereWs.m_center, polyWs, hullPt);
+
+	if (dist <= 0.f)
+	{
+		// Deep contact
+		int numFaces = polyWs.GetNumFaces();
+		float minPen = -1.f;
+		Vector3 normal = Vector3::ZERO;
+
+		for (int iFace = 0; iFace < numFaces; ++iFace)
+		{
+			const Plane3 plane = polyWs.GetFaceSupportPlane(iFace);
+			float pen = -1.0f * plane.GetDistanceFromPlane(sphereWs.m_center);
+
+			if (pen > 0.f && (minPen < 0.f || pen < minPen))
+			{
+				minPen = pen;
+				normal = plane.m_normal;
+			}
+		}
+
+		ASSERT_OR_DIE(minPen > 0.f, "Deep contact not found!");
+		out_contacts[0].position = (sphereWs.m_center - (sphereWs.m_radius - minPen) * normal);
+		out_contacts[0].normal = normal;
+		out_contacts[0].penetration = minPen;
+		FillOutColliderInfo(&out_contacts[0], aSphereCol, bHullCol);
+		out_contacts[0].CheckValuesAreReasonable();
+		numContacts++;
+	}
+	else if (dist < sphereWs.m_radius)
+	{
+		// Shallow contact
+		out_contacts[0].position = hullPt;
+		out_contacts[0].normal = (sphereWs.m_center - hullPt) / dist;
+		out_contacts[0].penetration = sphereWs.m_radius - dist;
+		FillOutColliderInfo(&out_contacts[0], aSphereCol, bHullCol);
+		out_contacts[0].CheckValuesAreReasonable();
+		numContacts++;
+	}
+
+	return numContacts;
+}
+
+
+//-------------------------------------------------------------------------------------------------
+static inline float TransformToAxis(const BoxCollider* box, const Vector3 &axis)
+{
+	OBB3 boxWs = box->GetDataInWorldSpace();
+	Matrix3 boxBasis = Matrix3(boxWs.rotation);
+	ASSERT_REASONABLE(boxBasis);
+	ASSERT_REASONABLE(axis);
+
+	return
+		boxWs.extents.x * Abs(DotProduct(axis, boxBasis.iBasis)) +
+		boxWs.extents.y * Abs(DotProduct(axis, boxBasis.jBasis)) +
+		boxWs.extents.z * Abs(DotProduct(axis, boxBasis.kBasis));
+}
+
+/*
+ * This function checks if the two boxes overlap
+ * along the given axis, returning the ammount of overlap.
+ * The final parameter toCentre
+ * is used to pass in the vector between the boxes centre
+ * points, to avoid having to recalculate it each time.
+ */
+static inline float GetPenetrationOnAxis(const BoxCollider* a, const BoxCollider* b, const Vector3 &axis, const Vector3 &aToB)
+{
+	ASSERT_REASONABLE(axis);
+	ASSERT_REASONABLE(aToB);
+	ASSERT_OR_DIE(AreMostlyEqual(axis.GetLength(), 1.0f), "Axis not unit!");
+
+	// Project the half-size of one onto axis
+	float oneProject = TransformToAxis(a, axis);
+	float twoProject = TransformToAxis(b, axis);
+
+	// Project this onto the axis
+	float distance = Abs(DotProduct(aToB, axis));
+
+	// Return the overlap (i.e. positive indicates
+	// overlap, negative indicates separation).
+	return oneProject + twoProject - distance;
+}
+
+
+//-------------------------------------------------------------------------------------------------
+// Returns true to signal we haven't found a gap yet and to keep checking axes
+static inline bool CheckAxis(const BoxCollider* a, const BoxCollider* b, Vector3 axis, const Vector3& toCentre, unsigned index, float& out_smallestPen, unsigned &out_smallestIndex)
+{
+	// Make sure we have a normalized axis, and don't check almost parallel axes
+	if (AreMostlyEqual(axis.GetLengthSquared(), 0.f)) 
+		return true;
+
+	axis.Normalize();
+	float penetration = GetPenetrationOnAxis(a, b, axis, toCentre);
+
+	if (penetration < 0.f) 
+		return false;
+
+	if (penetration < out_smallestPen) 
+	{
+		out_smallestPen = penetration;
+		out_smallestIndex = index;
+	}
+
+	return true;
+}
+
+
+//-------------------------------------------------------------------------------------------------
+static int CreateFaceVertexContact(const BoxCollider* faceCol, const BoxCollider* vertexCol, const Vector3 &aToB, Contact* out_contact, const int bestAxisIndex, int limit)
+{
+	// This method is called when we know that a vertex from
+	// box two is in contact with box one.
+	OBB3 one = faceCol->GetDataInWorldSpace();
+	OBB3 two = vertexCol->GetDataInWorldSpace();
+	ASSERT_REASONABLE(one);
+	ASSERT_REASONABLE(two);
+
+	// We know which axis the collision is on (i.e. best),
+	// but we need to work out which of the two faces on
+	// this axis.
+	Vector3 normal = Matrix3(one.rotation).columnVectors[bestAxisIndex];
+	if (DotProduct(normal, aToB) > 0.f)
+	{
+		normal = normal * -1.0f;
+	}
+
+	ASSERT_OR_DIE(AreMostlyEqual(normal.GetLength(), 1.0f), "Normal not unit!");
+
+
+	Vector3 vertexOffsetOne = one.extents;
+	if (DotProduct(one.GetRightVector(), normal) > 0.f) { vertexOffsetOne.x = -vertexOffsetOne.x; }
+	if (DotProduct(one.GetUpVector(), normal) > 0.f) { vertexOffsetOne.y = -vertexOffsetOne.y; }
+	if (DotProduct(one.GetForwardVector(), normal) > 0.f) { vertexOffsetOne.z = -vertexOffsetOne.z; }
+
+	Plane3 plane(normal, Matrix3(one.rotation) * vertexOffsetOne + one.center);
+
+	Vector3 points[8];
+	two.GetPoints(points);
+
+	ManifoldPoint manifoldPoints[8];
+	int numManifoldPoints = 0;
+	for (int i = 0; i < 8; ++i)
+	{
+		float distance = plane.GetDistanceFromPlane(points[i]);
+
+		if (distance > 0.f && one.ContainsWorldSpacePoint(points[i]))
+		{
+			manifoldPoints[numManifoldPoints].position = points[i];
+			manifoldPoints[numManifoldPoints].normal = normal;
+			manifoldPoints[numManifoldPoints].penetration = distance;
+			numManifoldPoints++;
+		}
+	}
+
+	// Deep overlaps can put more than a face's worth of vertices inside
+	numManifoldPoints = ReduceManifoldPoints(manifoldPoints, numManifoldPoints, normal);
+
+	int numContactsAdded = Min(numManifoldPoints, limit);
+	for (int i = 0; i < numContactsAdded; ++i)
+	{
+		out_contact->normal = normal;
+		out_contact->penetration = manifoldPoints[i].penetration;
+		out_contact->position = manifoldPoints[i].position;
+		FillOutColliderInfo(out_contact, faceCol, vertexCol);
+
+		out_contact->CheckValuesAreReasonable();
+		out_contact++;
+	}
+
+	return numContactsAdded;
+
+	// Single vertex version - just finds the vertex most in the direction of the normal, and uses the axis pen as the amount of pen
+
+	/*Vector3 vertexOffset = two.extents;
+	if (DotProduct(two.GetRightVector(), normal) < 0.f)	{ vertexOffset.x = -vertexOffset.x; }
+	if (DotProduct(two.GetUpVector(), normal) < 0.f)		{ vertexOffset.y = -vertexOffset.y; }
+	if (DotProduct(two.GetForwardVector(), normal) < 0.f)	{ vertexOffset.z = -vertexOffset.z; }
+
+	// Create the contact data
+	out_contact->normal = normal;
+	out_contact->penetration = pen;
+	out_contact->position = (Matrix3(two.rotation) * vertexOffset) + two.center; // Convert from vertex box space to world space
+	FillOutColliderInfo(out_contact, faceCol, vertexCol);*/
+
+}
+
+
+//-------------------------------------------------------------------------------------------------
+// Regarding useOne param: if this is true, and the contact point is outside
+// the edge (in the case of an edge-face contact) then
+// we use one's midpoint, otherwise we use two's.
+static inline Vector3 CalculateEdgeEdgeContactPosition(const Vector3& ptOnEdgeOne, const Vector3& oneAxis, float oneSize, const Vector3& ptOnEdgeTwo, const Vector3& twoAxis, float twoSize, bool useOne)
+{
+	ASSERT_REASONABLE(ptOnEdgeOne);
+
+	Vector3 toSt, cOne, cTwo;
+	float dpStaOne, dpStaTwo, dpOneTwo, smOne, smTwo;
+	float denom, mua, mub;
+
+	smOne = oneAxis.GetLengthSquared();
+	smTwo = twoAxis.GetLengthSquared();
+	dpOneTwo = DotProduct(twoAxis, oneAxis);
+
+	toSt = ptOnEdgeOne - ptOnEdgeTwo;
+	dpStaOne = DotProduct(oneAxis, toSt);
+	dpStaTwo = DotProduct(twoAxis, toSt);
+
+	denom = smOne * smTwo - dpOneTwo * dpOneTwo;
+
+	// Zero denominator indicates parallel lines
+	if (Abs(denom) < 0.0001f) {
+		return useOne ? ptOnEdgeOne : ptOnEdgeTwo;
+	}
+
+	mua = (dpOneTwo * dpStaTwo - smTwo * dpStaOne) / denom;
+	mub = (smOne * dpStaTwo - dpOneTwo * dpStaOne) / denom;
+
+	// If either of the edges has the nearest point out
+	// of bounds, then the edges aren't crossed, we have
+	// an edge-face contact. Our point is on the edge, which
+	// we know from the useOne parameter.
+	if (mua > oneSize ||
+		mua < -oneSize ||
+		mub > twoSize ||
+		mub < -twoSize)
+	{
+		return useOne ? ptOnEdgeOne : ptOnEdgeTwo;
+	}
+	else
+	{
+		cOne = ptOnEdgeOne + oneAxis * mua;
+		cTwo = ptOnEdgeTwo + twoAxis * mub;
+
+		return cOne * 0.5 + cTwo * 0.5;
+	}
+}
+
+
+//-------------------------------------------------------------------------------------------------
+// Builds the contacts once the SAT has found the axis of least penetration, shared by the scalar and batched box-box tests
+static int CreateBoxBoxContacts(const BoxCollider* aBoxCol, const BoxCollider* bBoxCol, const OBB3& aBox, const OBB3& bBox, const Matrix3& aBasis, const Matrix3& bBasis, const Vector3& aToB, unsigned best, float pen, unsigned bestSingleAxis, Contact* out_contacts, int limit)
+{
+	// We now know there's a collision, and we know which
+	// of the axes gave the smallest penetration. We now
+	// can deal with it in different ways depending on
+	// the case.
+	if (best < 3)
+	{
+		// We've vertices of box two on a face of box one.
+		return CreateFaceVertexContact(aBoxCol, bBoxCol, aToB, out_contacts, best, limit);
+	}
+	else if (best < 6)
+	{
+		// We've got vertices of box one on a face of box two.
+		// We use the same algorithm as above, but swap around
+		// one and two (and therefore also the vector between their
+		// centers).
+		return CreateFaceVertexContact(bBoxCol, aBoxCol, aToB*-1.0f, out_contacts, best - 3, limit);
+	}
+	else
+	{
+		// We've got an edge-edge contact. Find out which axes
+		best -= 6;
+		int oneAxisIndex = best / 3;
+		int twoAxisIndex = best % 3;
+		Vector3 oneAxis = aBasis.columnVectors[oneAxisIndex];
+		Vector3 twoAxis = bBasis.columnVectors[twoAxisIndex];
+		Vector3 axis = CrossProduct(oneAxis, twoAxis);
+		axis.Normalize();
+
+		// The axis should point from box one to box two.
+		bool flippedAxis = false;
+		if (DotProduct(axis, aToB) > 0.f)
+		{
+			axis = axis * -1.0f;
+			flippedAxis = true;
+		}
+
+		// We have the axes, but not the edges: each axis has 4 edges parallel
+		// to it, we need to find which of the 4 for each object. We do
+		// that by finding the point in the centers of the edge. We know
+		// its component in the direction of the box's collision axis is zero
+		// (its a mid-point) and we determine which of the extremes in each
+		// of the other axes is closest.
+		Vector3 ptOnOneEdgeLs = aBox.extents;
+		Vector3 ptOnTwoEdgeLs = bBox.extents;
+		for (int i = 0; i < 3; i++)
+		{
+			if (i == oneAxisIndex)
+			{
+				ptOnOneEdgeLs.data[i] = 0.f;
+			}
+			else if (DotProduct(aBasis.columnVectors[i], axis) > 0.f)
+			{
+				ptOnOneEdgeLs.data[i] = -ptOnOneEdgeLs.data[i];
+			}
+
+			if (i == twoAxisIndex)
+			{
+				ptOnTwoEdgeLs.data[i] = 0.f;
+			}
+			else if (DotProduct(bBasis.columnVectors[i], axis) < 0.f)
+			{
+				ptOnTwoEdgeLs.data[i] = -ptOnTwoEdgeLs.data[i];
+			}
+		}
+
+		// Move them into world coordinates (they are already oriented
+		// correctly, since they have been derived from the axes).
+		Vector3 ptOnOneEdgeWs = (aBasis * ptOnOneEdgeLs) + aBox.center;
+		Vector3 ptOnTwoEdgeWs = (bBasis * ptOnTwoEdgeLs) + bBox.center;
+
+		// So we have a point and a direction for the colliding edges.
+		// We need to find out point of closest approach of the two
+		// line-segments.
+		Vector3 vertex = CalculateEdgeEdgeContactPosition(
+			ptOnOneEdgeWs, oneAxis, aBox.extents.data[oneAxisIndex],
+			ptOnTwoEdgeWs, twoAxis, bBox.extents.data[twoAxisIndex],
+			bestSingleAxis > 2
+		);
+
+		// We can fill the contact.
+		out_contacts->penetration = pen;
+		out_contacts->normal = axis;
+		out_contacts->position = vertex;
+		FillOutColliderInfo(out_contacts, aBoxCol, bBoxCol);
+
+		out_contacts->CheckValuesAreReasonable();
+		return 1;
+	}
+
+	return 0;
+}
+
+// This preprocessor definition is only used as a convenience
+// in the boxAndBox contact generation method.
+#define CHECK_OVERLAP(axis, index) \
+    if (!CheckAxis(aBoxCol, bBoxCol, (axis), aToB, (index), pen, best)) return 0;
+
+int CollisionDetector::GenerateContacts_BoxBox(const Collider* a, const Collider* b, Contact* out_contacts, int limit)
+{
+	const BoxCollider* aBoxCol = ColliderCast<BoxCollider>(a);
+	const BoxCollider* bBoxCol = ColliderCast<BoxCollider>(b);
+	ASSERT_OR_DIE(aBoxCol != nullptr && bBoxCol != nullptr, "Colliders are of wrong type!");
+
+	if (limit <= 0)
+		return 0;
+
+	OBB3 aBox = aBoxCol->GetDataInWorldSpace();
+	OBB3 bBox = bBoxCol->GetDataInWorldSpace();
+	ASSERT_REASONABLE(aBox);
+	ASSERT_REASONABLE(bBox);
+
+	Matrix3 aBasis(aBox.GetRightVector(), aBox.GetUpVector(), aBox.GetForwardVector());
+	Matrix3 bBasis(bBox.GetRightVector(), bBox.GetUpVector(), bBox.GetForwardVector());
+	ASSERT_REASONABLE(aBasis);
+	ASSERT_REASONABLE(bBasis);
+
+	Vector3 aToB = bBox.center - aBox.center;
+	ASSERT_REASONABLE(aToB);
+
+	// We start assuming there is no contact
+	float pen = FLT_MAX;
+	unsigned best = 0xffffff;
+
+	// Now we check each axes, returning if it gives us
+	// a separating axis, and keeping track of the axis with
+	// the smallest penetration otherwise.
+	CHECK_OVERLAP(aBasis.columnVectors[0], 0);
+	CHECK_OVERLAP(aBasis.columnVectors[1], 1);
+	CHECK_OVERLAP(aBasis.columnVectors[2], 2);
+
+	CHECK_OVERLAP(bBasis.columnVectors[0], 3);
+	CHECK_OVERLAP(bBasis.columnVectors[1], 4);
+	CHECK_OVERLAP(bBasis.columnVectors[2], 5);
+
+	// Store the best axis-major, in case we run into almost
+	// parallel edge collisions later
+	unsigned int bestSingleAxis = best;
+
+	CHECK_OVERLAP(CrossProduct(aBasis.columnVectors[0], bBasis.columnVectors[0]), 6);
+	CHECK_OVERLAP(CrossProduct(aBasis.columnVectors[0], bBasis.columnVectors[1]), 7);
+	CHECK_OVERLAP(CrossProduct(aBasis.columnVectors[0], bBasis.columnVectors[2]), 8);
+	CHECK_OVERLAP(CrossProduct(aBasis.columnVectors[1], bBasis.columnVectors[0]), 9);
+	CHECK_OVERLAP(CrossProduct(aBasis.columnVectors[1], bBasis.columnVectors[1]), 10);
+	CHECK_OVERLAP(CrossProduct(aBasis.columnVectors[1], bBasis.columnVectors[2]), 11);
+	CHECK_OVERLAP(CrossProduct(aBasis.columnVectors[2], bBasis.columnVectors[0]), 12);
+	CHECK_OVERLAP(CrossProduct(aBasis.columnVectors[2], bBasis.columnVectors[1]), 13);
+	CHECK_OVERLAP(CrossProduct(aBasis.columnVectors[2], bBasis.columnVectors[2]), 14);
+
+	// Make sure we've got a result.
+	ASSERT_OR_DIE(best != 0xffffff, "No best index found!");
+
+	return CreateBoxBoxContacts(aBoxCol, bBoxCol, aBox, bBox, aBasis, bBasis, aToB, best, pen, bestSingleAxis, out_contacts, limit);
+}
+
+#undef CHECK_OVERLAP
+
+//-------------------------------------------------------------------------------------------------
+static int GenerateContacts_HullHullInternal(const Collider* a, const Collider* b, const Polyhedron& aHullWs, const Polyhedron& bHullWs, Contact* out_contacts, int limit)
+{
+	int numContacts = 0;
+	SATResult_HullHull result;
+	bool hasOverlap = SAT::GetMinPenAxis(aHullWs, bHullWs, result);
+
+	if (hasOverlap)
+	{
+		if (result.m_isFaceAxis)
+		{
+			// Face/face collision, clip incident to the reference face
+			bool aIsRef = (result.m_iFaceOrEdgeA != -1);
+			const Polyhedron& refHull = (aIsRef ? aHullWs : bHullWs);
+			const Polyhedron& incHull = (aIsRef ? bHullWs : aHullWs);
+			int iRefFace = (aIsRef ? result.m_iFaceOrEdgeA : result.m_iFaceOrEdgeB);
+
+			Plane3 refPlane = refHull.GetFaceSupportPlane(iRefFace);
+			int iIncFace = incHull.GetIndexOfFaceMostInDirection(-1.0f * refPlane.m_normal);
+
+			// Scratch vectors rather than fixed buffers, so hulls with faces of any size work
+			std::vector<Vector3>& clippedVertices = s_narrowphaseScratch.m_clipVertices[0];
+			incHull.GetAllVerticesInFace(iIncFace, clippedVertices);
+			refHull.ClipPolygonToFace(iRefFace, clippedVertices, s_narrowphaseScratch.m_clipVertices[1]);
+			int numClipped = (int)clippedVertices.size();
+
+			// Clipped faces can have many vertices, so gather them all and only keep the ones that matter
+			// The candidate buffer reduces itself when full, so vertices past it still get a say
+			ManifoldPoint manifoldPoints[MAX_MANIFOLD_CANDIDATES];
+			int numManifoldPoints = 0;
+
+			for (int iVertex = 0; iVertex < numClipped; ++iVertex)
+			{
+				Vector3 incVertex = clippedVertices[iVertex];
+				float pen = -1.0f * refPlane.GetDistanceFromPlane(incVertex);
+
+				if (pen > 0.f)
+				{
+					ManifoldPoint point;
+					point.position = refPlane.GetProjectedPointOntoPlane(incVertex);
+					point.normal = refPlane.m_normal;
+					point.penetration = pen;
+					AddManifoldCandidate(manifoldPoints, numManifoldPoints, MAX_MANIFOLD_CANDIDATES, point);
+				}
+			}
+
+			numManifoldPoints = ReduceManifoldPoints(manifoldPoints, numManifoldPoints, refPlane.m_normal);
+			numContacts = Min(numManifoldPoints, limit);
+
+			for (int iContact = 0; iContact < numContacts; ++iContact)
+			{
+				out_contacts[iContact].penetration = manifoldPoints[iContact].penetration;
+				out_contacts[iContact].normal = refPlane.m_normal;
+				out_contacts[iContact].position = manifoldPoints[iContact].position;
+				FillOutColliderInfo(&out_contacts[iContact], (aIsRef ? b : a), (aIsRef ? a : b));
+				out_contacts[iContact].CheckValuesAreReasonable();
+			}
+		}
+		else
+		{
+			const LineSegment3 aEdge = aHullWs.GetEdgeSegment(result.m_iFaceOrEdgeA);
+			const LineSegment3 bEdge = bHullWs.GetEdgeSegment(result.m_iFaceOrEdgeB);
+
+			Vector3 aPt, bPt;
+			float distance = FindNearestPoints(aEdge, bEdge, aPt, bPt);
+
+			Vector3 normal = CrossProduct(aEdge.m_b - aEdge.m_a, bEdge.m_b - bEdge.m_a).GetNormalized();
+			Vector3 outOfA = aPt - aHullWs.GetCenter();
+			if (DotProduct(outOfA, normal) > 0.f)
+			{
+				normal *= -1.0f;
+			}
+
+			out_contacts[0].penetration = distance;
+			out_contacts[0].normal = normal;
+			out_contacts[0].position = 0.5f * (aPt + bPt);
+			FillOutColliderInfo(&out_contacts[0], a, b);
+			out_contacts[0].CheckValuesAreReasonable();
+
+			numContacts = 1;
+		}
+	}
+
+	return numContacts;
+}
+
+
+//-------------------------------------------------------------------------------------------------
+int CollisionDetector::GenerateContacts_BoxHull(const Collider* a, const Collider* b, Contact* out_contacts, int limit)
+{
+	if (limit <= 0)
+		return 0;
+
+	const BoxCollider* aBoxCol = ColliderCast<BoxCollider>(a);
+	const ConvexHullCollider* bHullCol = ColliderCast<ConvexHullCollider>(b);
+	ASSERT_OR_DIE(aBoxCol != nullptr && bHullCol != nullptr, "Colliders are of wrong type!");
+
+	const OBB3 aBoxWs = aBoxCol->GetDataInWorldSpace();
+	Polyhedron& aHullWs = s_narrowphaseScratch.m_hullsWs[0];
+	aHullWs.SetFromBox(aBoxWs);
+	Polyhedron& bHullWs = s_narrowphaseScratch.m_hullsWs[1];
+	bHullCol->GetDataInWorldSpace(bHullWs);
+
+	return GenerateContacts_HullHullInternal(a, b, aHullWs, bHullWs, out_contacts, limit);
+}
+
+
+//-------------------------------------------------------------------------------------------------
+int CollisionDetector::GenerateContacts_HullHull(const Collider* a, const Collider* b, Contact* out_contacts, int limit)
+{
+	if (limit <= 0)
+		return 0;
+
+	const ConvexHullCollider* aHullCol = ColliderCast<ConvexHullCollider>(a);
+	const ConvexHullCollider* bHullCol = ColliderCast<ConvexHullCollider>(b);
+	ASSERT_OR_DIE(aHullCol != nullptr && bHullCol != nullptr, "Colliders are of wrong type!");
+
+	Polyhedron& aHullWs = s_narrowphaseScratch.m_hullsWs[0];
+	aHullCol->GetDataInWorldSpace(aHullWs);
+	Polyhedron& bHullWs = s_narrowphaseScratch.m_hullsWs[1];
+	bHullCol->GetDataInWorldSpace(bHullWs);
+
+	return GenerateContacts_HullHullInternal(a, b, aHullWs, bHullWs, out_contacts, limit);
+}
+
+
+//-------------------------------------------------------------------------------------------------
+int CollisionDetector::GenerateContacts_HalfSpaceCapsule(const Collider* a, const Collider* b, Contact* out_contacts, int limit)
+{
+	const HalfSpaceCollider* aHalfSpaceCol = ColliderCast<HalfSpaceCollider>(a);
+	const CapsuleCollider* bCapsuleCol = ColliderCast<CapsuleCollider>(b);
+	ASSERT_OR_DIE(aHalfSpaceCol != nullptr && bCapsuleCol != nullptr, "Colliders are of wrong type!");
+	
+	if (limit <= 0)
+		return 0;
+
+	Plane3 planeWs = aHalfSpaceCol->GetDataInWorldSpace();
+	Capsule3 capsuleWs = bCapsuleCol->GetDataInWorldSpace();
+
+	float startDistance = planeWs.GetDistanceFromPlane(capsuleWs.start) - capsuleWs.radius;
+	float endDistance = planeWs.GetDistanceFromPlane(capsuleWs.end) - capsuleWs.radius;
+
+	if (startDistance >= 0.f && endDistance >= 0.f)
+		return 0;
+
+	int numAdded = 0;
+	Contact* contactToFill = &out_contacts[0];
+	if (startDistance < 0.f)
+	{
+		contactToFill->normal = planeWs.m_normal;
+		contactToFill->penetration = -startDistance;
+		contactToFill->position = capsuleWs.start - capsuleWs.radius * contactToFill->normal;
+		FillOutColliderInfo(contactToFill, bCapsuleCol, aHalfSpaceCol);
+		contactToFill->CheckValuesAreReasonable();
+		numAdded++;
+		contactToFill = &out_contacts[numAdded];
+
+		if (limit == 1)
+			return 1;
+	}
+
+	if (endDistance < 0.f)
+	{
+		contactToFill->normal = planeWs.m_normal;
+		contactToFill->penetration = -endDistance;
+		contactToFill->position = capsuleWs.end - capsuleWs.radius * contactToFill->normal;
+		FillOutColliderInfo(contactToFill, bCapsuleCol, aHalfSpaceCol);
+		contactToFill->CheckValuesAreReasonable();
+		numAdded++;
+	}
+
+	return numAdded;
+}
+
+
+//-------------------------------------------------------------------------------------------------
+int CollisionDetector::GenerateContacts_SphereCapsule(const Collider* a, const Collider* b, Contact* out_contacts, int limit)
+{
+	const SphereCollider* aSphereCol = ColliderCast<SphereCollider>(a);
+	const CapsuleCollider* bCapsuleCol = ColliderCast<CapsuleCollider>(b);
+	ASSERT_OR_DIE(aSphereCol != nullptr && bCapsuleCol != nullptr, "Colliders are of wrong type!");
+
+	if (limit <= 0)
+		return 0;
+
+	Sphere sphereWs = aSphereCol->GetDataInWorldSpace();
+	Capsule3 capsuleWs = bCapsuleCol->GetDataInWorldSpace();
+
+	Vector3 closestCapsulePointWs;
+	float distance = FindNearestPoint(sphereWs.m_center, capsuleWs.start, capsuleWs.end, closestCapsulePointWs);
+	float overlap = (sphereWs.m_radius + capsuleWs.radius) - distance;
+
+	if (overlap > 0.f)
+	{
+		out_contacts->normal = (sphereWs.m_center - closestCapsulePointWs) / distance;
+		out_contacts->penetration = overlap;
+		out_contacts->position = 0.5f * (closestCapsulePointWs + sphereWs.m_center);
+		FillOutColliderInfo(out_contacts, aSphereCol, bCapsuleCol);
+		out_contacts->CheckValuesAreReasonable();
+
+		return 1;
+	}
+
+	return 0;
+}
+
+
+//-------------------------------------------------------------------------------------------------
+int CollisionDetector::GenerateContacts_CapsuleCapsule(const Collider* a, const Collider* b, Contact* out_contacts, int limit)
+{
+	const CapsuleCollider* aCapsuleCol = ColliderCast<CapsuleCollider>(a);
+	const CapsuleCollider* bCapsuleCol = ColliderCast<CapsuleCollider>(b);
+	ASSERT_OR_DIE(aCapsuleCol != nullptr && bCapsuleCol != nullptr, "Colliders are of wrong type!");
+
+	if (limit <= 0)
+		return 0;
+
+	Capsule3 capsuleA = aCapsuleCol->GetDataInWorldSpace();
+	Capsule3 capsuleB = bCapsuleCol->GetDataInWorldSpace();
+
+	Vector3 ptOnA, ptOnB;
+	float distance = FindNearestPoints(capsuleA.start, capsuleA.end, capsuleB.start, capsuleB.end, ptOnA, ptOnB);
+	float overlap = (capsuleA.radius + capsuleB.radius) - distance;
+
+	if (overlap > 0.f)
+	{
+		out_contacts->normal = (ptOnA - ptOnB) / distance;
+		out_contacts->penetration = overlap;
+		out_contacts->position = 0.5f * (ptOnA + ptOnB);
+		FillOutColliderInfo(out_contacts, aCapsuleCol, bCapsuleCol);
+		out_contacts->CheckValuesAreReasonable();
+
+		return 1;
+	}
+
+	return 0;
+}
+
+
+//-------------------------------------------------------------------------------------------------
+static bool GetMinPlanePen(const OBB3& box, const Capsule3& capsule, float* out_pens, Vector3* out_positions, Vector3& out_normal)
+{
+	out_pens[0] = FLT_MAX;
+	out_pens[1] = FLT_MAX;
+
+	Vector3 startLs = box.TransformPositionIntoSpace(capsule.start);
+	Vector3 endLs = box.TransformPositionIntoSpace(capsule.end);
+
+	float radius = capsule.radius;
+	Vector3 extents = box.extents;
+
+	// Idea
+	// For each axis, see if the end point is "in the tube" of that axis (i.e. for x, make sure we're within the y and x extents - it's ok if we're to the left or right though, that's along the tube)
+	// If we are, that qualifies to be a face contact, so calculate the amount of push needed to correct out either side of the box for that axis
+	// At the end, take the min pen and that normal, making sure you use the right sign
+	Vector3 pens[2];
+	Vector3 signs[2];
+
+	// For each end point...
+	for (int i = 0; i < 2; ++i)
+	{
+		Vector3 endPoint = (i == 0 ? startLs : endLs);
+
+		// For each axis
+		for (int j = 0; j < 3; ++j)
+		{
+			// Check the other 2 components to see if we're "in the tube"
+			bool inLateralBounds = true;
+			for (int k = 0; k < 3; ++k)
+			{
+				if (k == j)
+					continue;
+
+				if (endPoint.data[k] > extents.data[k] || endPoint.data[k] < -extents.data[k])
+				{
+					inLateralBounds = false;
+					break;
+				}
+			}
+
+			// If we're in the tube
+			if (inLateralBounds)
+			{
+				float posPen = extents.data[j] - endPoint.data[j] + radius;
+				float negPen = extents.data[j] + endPoint.data[j] + radius;
+
+				// See which direction along the tube is the shorter correction
+				if (posPen < negPen)
+				{
+					pens[i].data[j] = posPen;
+					signs[i].data[j] = 1.f;
+				}
+				else
+				{
+					pens[i].data[j] = negPen;
+					signs[i].data[j] = -1.f;
+				}
+			}
+			else
+			{
+				// Not in the tube - can't make a face contact on this axis (it'd be an edge contact at that point)
+				pens[i].data[j] = FLT_MAX;
+			}
+		}
+	}
+
+	// Determine the best local normal for each end point
+	Vector3 normalsLs[2];
+	for (int i = 0; i < 2; ++i)
+	{
+		normalsLs[i] = Vector3::ZERO;
+
+		const Vector3& axisPens = pens[i];
+		float minPen = Min(axisPens.x, axisPens.y, axisPens.z);
+
+		// If the min pen is negative, then this capsule's "sphere" is completely outside a face
+		// so it has no overlap
+		if (minPen < 0.f)
+			continue;
+
+		for (int j = 0; j < 3; ++j)
+		{
+			if (minPen == axisPens.data[j])
+			{
+				normalsLs[i].data[j] = 1.f * signs[i].data[j];
+				out_pens[i] = minPen;
+				break;
+			}
+		}
+	}
+
+	// If the endpoints find 2 different best faces, the capsule must be intersecting an edge
+	// Instead, just generate an edgepoint
+	float normalDot = DotProduct(normalsLs[0], normalsLs[1]);
+	if ((out_pens[0] < FLT_MAX && out_pens[1] < FLT_MAX) && AreMostlyEqual(normalDot, 0.f))
+	{
+		return false;
+	}
+	else if (AreMostlyEqual(normalDot, -1.f))
+	{
+		// The best normals are opposite sides of the cube haha
+		// Might be ok to just arbitrarily pick a way to push, as it might not matter that much at this point ("You shouldn't be here!")
+		ERROR_AND_DIE("Ha, capsule is stuck isn't it");
+	}
+
+	// Start and/or end could be valid contacts, but at this point they share a normal, so either once can calculate it
+	if (out_pens[0] < FLT_MAX)
+	{
+		Matrix3 basis(box.rotation);
+		out_normal = normalsLs[0].x * basis.columnVectors[0] + normalsLs[0].y * basis.columnVectors[1] + normalsLs[0].z * basis.columnVectors[2];
+		out_positions[0] = capsule.start - out_normal * radius;
+	}
+
+	if (out_pens[1] < FLT_MAX)
+	{
+		Matrix3 basis(box.rotation);
+		out_normal = normalsLs[1].x * basis.columnVectors[0] + normalsLs[1].y * basis.columnVectors[1] + normalsLs[1].z * basis.columnVectors[2];
+		out_positions[1] = capsule.end - out_normal * radius;
+	}
+
+	return (out_pens[0] < FLT_MAX || out_pens[1] < FLT_MAX);
+}
+
+
+//-------------------------------------------------------------------------------------------------
+static bool GetMinEdgePen(const OBB3& box, const Capsule3& capsule, float& out_pen, Vector3& out_normal, Vector3& out_position)
+{
+	out_pen = FLT_MAX;
 
 	Edge3 edges[12];
 	box.GetEdges(edges);
 
-	for (int i = 0; i < 12; ++i)
+	for (int i = 0; i < 12; ++i)
+	{
+		const Edge3& edge = edges[i];
+
+		// Get the distance between the closest points on the box edge and the capsule's spine
+		Vector3 capsulePt, boxPt;
+		float distance = FindNearestPoints(capsule.start, capsule.end, edge.m_start, edge.m_end, capsulePt, boxPt);
+
+		// Get these in the box's local space to check Voronoi regions
+		// Only consider edge overlap if the capsule closest point either
+		// 1. Is inside the box
+		// 2. Is in the voronoi region adjacent to the edge
+		// This prevents bad cases of overlapping edges across the box and pushing the wrong way
+		Vector3 capsulePtLs = box.TransformPositionIntoSpace(capsulePt);
+		Vector3 boxPtLs = box.TransformPositionIntoSpace(boxPt);
+		const Vector3& extents = box.extents;
+		bool boxContainsCapsulePt = (Abs(capsulePtLs.x) < extents.x) && (Abs(capsulePtLs.y) < extents.y) && (Abs(capsulePtLs.z) < extents.z);
+
+		bool isInCorrectVoronoiRegion = true;
+		if (!boxContainsCapsulePt)
+		{
+			for (int j = 0; j < 3; ++j)
+			{
+				// If the box point is at an extent...
+				if (AreMostlyEqual(Abs(boxPtLs.data[j]), extents.data[j]))
+				{
+					// Ensure we're outside of them in that direction
+					// i.e. "If the point is on the max x, make sure we're farther out on x, if the box point is on negative z, make sure we're below that"
+					if ((boxPtLs.data[j] > 0.f && boxPtLs.data[j] > capsulePtLs.data[j]) || (boxPtLs.data[j] < 0.f && boxPtLs.data[j] < capsulePtLs.data[j]))
+					{
+						isInCorrectVoronoiRegion = false;
+						break;
+					}
+				}
+				else
+				{
+					// Technically the below should never fail....due to how the distance calculation finds the end points
+					if (Abs(capsulePtLs.data[j] > extents.data[j]))
+					{
+						isInCorrectVoronoiRegion = false;
+						break;
+					}
+				}
+			}
+		}
+
+		if (boxContainsCapsulePt || isInCorrectVoronoiRegion)
+		{
+			float sign = (box.ContainsWorldSpacePoint(capsulePt) ? 1.0f : -1.0f);
+			float pen = sign * distance + capsule.radius;
+			if (pen > 0.f && pen < out_pen)
+			{
+				out_pen = pen;
+				out_normal = (-1.f * sign) * (capsulePt - boxPt) / distance;
+				out_position = capsulePt - out_normal * distance;
+			}
+		}
+	}
+
+	return (out_pen < FLT_MAX);
+}
+
+
+//-------------------------------------------------------------------------------------------------
+int CollisionDetector::GenerateContacts_CapsuleBox(const Collider* a, const Collider* b, Contact* out_contacts, int limit)
+{
+	const CapsuleCollider* aCapsuleCol = ColliderCast<CapsuleCollider>(a);
+	const BoxCollider* bBoxCol = ColliderCast<BoxCollider>(b);
+	ASSERT_OR_DIE(aCapsuleCol != nullptr && bBoxCol != nullptr, "Colliders are of wrong type!");
+
+	if (limit <= 0)
+		return 0;
+
+	Capsule3 capsuleWs = aCapsuleCol->GetDataInWorldSpace();
+	OBB3 boxWs = bBoxCol->GetDataInWorldSpace();
+
+	float facePens[2];
+	Vector3 faceNormal;
+	Vector3 faceContactPos[2];
+	bool hasFaceOverlap = GetMinPlanePen(boxWs, capsuleWs, facePens, faceContactPos, faceNormal);
+
+	float edgePen = FLT_MAX;
+	Vector3 edgeNormal = Vector3::ZERO;
+	Vector3 edgePos = Vector3::ZERO;
+	bool hasEdgeOverlap = GetMinEdgePen(boxWs, capsuleWs, edgePen, edgeNormal, edgePos);
+
+	// If we have face overlap but no edge overlap *or* the face overlap has less pen than the edge, make face contacts
+	int numContactsAdded = 0;
+
+	if (hasFaceOverlap)
+	{
+		if (facePens[0] < FLT_MAX)
+		{
+			out_contacts->normal = faceNormal;
+			out_contacts->penetration = facePens[0];
+			out_contacts->position = faceContactPos[0];
+			FillOutColliderInfo(out_contacts, aCapsuleCol, bBoxCol);
+			out_contacts->CheckValuesAreReasonable();
+			out_contacts++;
+			numContactsAdded++;
+		}
+
+		if (facePens[1] < FLT_MAX && numContactsAdded < limit)
+		{
+			out_contacts->normal = faceNormal;
+			out_contacts->penetration = facePens[1];
+			out_contacts->position = faceContactPos[1];
+			FillOutColliderInfo(out_contacts, aCapsuleCol, bBoxCol);
+			out_contacts->CheckValuesAreReasonable();
+			out_contacts++;
+			numContactsAdded++;
+		}
+	}
+
+	if (hasEdgeOverlap)
+	{
+		out_contacts->normal = edgeNormal;
+		out_contacts->penetration = edgePen;
+		out_contacts->position = edgePos;
+		FillOutColliderInfo(out_contacts, aCapsuleCol, bBoxCol);
+		out_contacts->CheckValuesAreReasonable();
+
+		numContactsAdded++;
+	}
+
+	return numContactsAdded;
+}
+
+
+//-------------------------------------------------------------------------------------------------
+int CollisionDetector::GenerateContacts_CapsuleCylinder(const Collider* a, const Collider* b, Contact* out_contacts, int limit)
+{
+	if (limit <= 0)
+		return 0;
+
+	int numContacts = 0;
+	const CapsuleCollider* aCapsuleCol = ColliderCast<CapsuleCollider>(a);
+	const CylinderCollider* bCylinderCol = ColliderCast<CylinderCollider>(b);
+	ASSERT_OR_DIE(aCapsuleCol != nullptr && bCylinderCol != nullptr, "Colliders are of wrong type!");
+
+	Capsule3 capsuleWs = aCapsuleCol->GetDataInWorldSpace();
+	Cylinder cylinderWs = bCylinderCol->GetDataInWorldSpace();
+
+	LineSegment3 capsuleSpine(capsuleWs.start, capsuleWs.end);
+
+	GJKSolver3D<LineSegment3, Cylinder> solver(capsuleSpine, cylinderWs);
+	bool foundSolution = solver.Solve();
+
+	if (foundSolution)
+	{
+		float separation = solver.GetSeparationDistance();
+		if (separation <= 0.f)
+		{
+
+		}
+		else if (separation < capsuleWs.radius)
+		{
+			Vector3 capsulePt = solver.GetClosestPointOnA();
+			Vector3 cylinderPt = solver.GetClosestPointOnB();
+			Vector3 normal = solver.GetSeparationNormal();
+
+			out_contacts[0].normal = normal;
+			out_contacts[0].penetration = capsuleWs.radius - separation;
+			out_contacts[0].position = cylinderPt;
+			FillOutColliderInfo(&out_contacts[0], aCapsuleCol, bCylinderCol);
+			out_contacts[0].CheckValuesAreReasonable();
+
+			numContacts = 1;
+		}
+	}
+
+	return numContacts;
+}
+
+
+//-------------------------------------------------------------------------------------------------
+int CollisionDetector::GenerateContacts_CapsuleHull(const Collider* a, const Collider* b, Contact* out_contacts, int limit)
+{
+	if (limit <= 0)
+		return 0;
+
+	int numContacts = 0;
+	const CapsuleCollider* aCapsuleCol = ColliderCast<CapsuleCollider>(a);
+	const ConvexHullCollider* bHullCol = ColliderCast<ConvexHullCollider>(b);
+	ASSERT_OR_DIE(aCapsuleCol != nullptr && bHullCol != nullptr, "Colliders are of wrong type!");
+
+	Capsule3 capsuleWs = aCapsuleCol->GetDataInWorldSpace();
+	Polyhedron& polyWs = s_narrowphaseScratch.m_hullsWs[0];
+	bHullCol->GetDataInWorldSpace(polyWs);
+
+	LineSegment3 capSpine(capsuleWs.start, capsuleWs.end);
+	Vector3 closestPtOnSpine, closestPtOnHull;
+	float dist = FindNearestPoints(capSpine, polyWs, closestPtOnSpine, closestPtOnHull);
+
+	if (dist <= 0.f)
+	{
+		// Deep contact - use SAT to find the best axis
+		SATResult_CapsuleHull result;
+		bool areOverlapping = SAT::GetMinPenAxis(capsuleWs, polyWs, result);
+		ASSERT_OR_DIE(areOverlapping, "Found an axis of separation?");
+
+		if (result.m_isFaceAxis)
+		{
+			// Clip capsule segment to the face
+			LineSegment3 clippedSpine = capSpine;
+			polyWs.ClipEdgeToFace(result.m_iFaceOrEdge, clippedSpine);
+			Plane3 facePlane = polyWs.GetFaceSupportPlane(result.m_iFaceOrEdge);
+
+			int maxContacts = Min(limit, 2);
+			for (int iContact = 0; iContact < maxContacts; ++iContact)
+			{
+				Vector3 endPoint = (iContact == 0 ? clippedSpine.m_a : clippedSpine.m_b);
+				float pen = capsuleWs.radius - facePlane.GetDistanceFromPlane(endPoint);
+
+				if (pen >= 0.f)
+				{
+					out_contacts[numContacts].position = facePlane.GetProjectedPointOntoPlane(endPoint);
+					out_contacts[numContacts].normal = facePlane.m_normal;
+					out_contacts[numContacts].penetration = pen;
+					FillOutColliderInfo(&out_contacts[numContacts], aCapsuleCol, bHullCol);
+					out_contacts[numContacts].CheckValuesAreReasonable();
+					numContacts++;
+				}
+			}
+		}
+		else
+		{
+			// Find closest points between the capsule spine and the edge
+			LineSegment3 hullEdge = polyWs.GetEdgeSegment(result.m_iFaceOrEdge);
+			dist = FindNearestPoints(capSpine, hullEdge, closestPtOnSpine, closestPtOnHull);
+
+			Vector3 normal = result.m_axis;
+
+			// Keep axis pointing towards capsule
+			if (DotProduct(polyWs.GetCenter() - capsuleWs.GetCenter(), normal) > 0.f)
+			{
+				normal *= -1.0f;
+			}
+
+			out_contacts[0].position = 0.5f * (closestPtOnSpine + closestPtOnHull); // Position contact halfway between capsule and hull
+			out_contacts[0].normal = normal;
+			out_contacts[0].penetration = result.m_pen;
+			FillOutColliderInfo(&out_contacts[0], aCapsuleCol, bHullCol);
+			out_contacts[0].CheckValuesAreReasonable();
+			numContacts = 1;
+		}
+	}
+	else if (dist < capsuleWs.radius)
+	{
+		// Shallow contact - check if it's with an edge or a face
+		Vector3 normalFromGJK = (closestPtOnSpine - closestPtOnHull).GetNormalized();
+		int faceIndex = polyWs.GetIndexOfFaceMostInDirection(normalFromGJK);
+
+		if (AreMostlyEqual(DotProduct(normalFromGJK, polyWs.GetFaceNormal(faceIndex)), 1.0f))
+		{
+			// Shallow contact on face - we can generate 2 contacts!
+			LineSegment3 clippedSpine = capSpine;
+			polyWs.ClipEdgeToFace(faceIndex, clippedSpine);
+			Plane3 facePlane = polyWs.GetFaceSupportPlane(faceIndex);
+
+			int maxContacts = Min(limit, 2);
+			for (int iContact = 0; iContact < maxContacts; ++iContact)
+			{
+				Vector3 endPoint = (iContact == 0 ? clippedSpine.m_a : clippedSpine.m_b);
+				float pen = capsuleWs.radius - facePlane.GetDistanceFromPlane(endPoint);
+
+				if (pen >= 0.f)
+				{
+					out_contacts[numContacts].position = facePlane.GetProjectedPointOntoPlane(endPoint);
+					out_contacts[numContacts].normal = facePlane.m_normal;
+					out_contacts[numContacts].penetration = pen;
+					FillOutColliderInfo(&out_contacts[numContacts], aCapsuleCol, bHullCol);
+					out_contacts[numContacts].CheckValuesAreReasonable();
+					numContacts++;
+				}
+			}
+		}
+		else
+		{
+			// Shallow contact on edge
+			out_contacts[0].position = closestPtOnHull;
+			out_contacts[0].normal = normalFromGJK; // I don't divide by distance to avoid propagating error
+			out_contacts[0].penetration = capsuleWs.radius - dist;
+			FillOutColliderInfo(&out_contacts[0], aCapsuleCol, bHullCol);
+			out_contacts[0].CheckValuesAreReasonable();
+			numContacts = 1;
+		}
+	}
+
+	return numContacts;
+}
+
+
+//-------------------------------------------------------------------------------------------------
+int CollisionDetector::GenerateContacts_PlaneSphere(const Collider* a, const Collider* b, Contact* out_contacts, int limit)
+{
+	const PlaneCollider* aPlaneCol = ColliderCast<PlaneCollider>(a);
+	const SphereCollider* bSphereCol = ColliderCast<SphereCollider>(b);
+	ASSERT_OR_DIE(aPlaneCol != nullptr && bSphereCol != nullptr, "Colliders are of wrong type!");
+
+	if (limit <= 0)
+		return 0;
+
+	Plane3 planeWs = aPlaneCol->GetDataInWorldSpace();
+	Sphere sphereWs = bSphereCol->GetDataInWorldSpace();
+
+	float distance = planeWs.GetDistanceFromPlane(sphereWs.m_center);
+
+	// Sphere too far in front of plane; its radius isn't enough to intersect the plane
+	if (Abs(distance) >= sphereWs.m_radius)
+		return 0;
+
+	// Find the direction to push the sphere
+	if (distance > 0.f)
+	{
+		out_contacts->normal = planeWs.m_normal;
+		out_contacts->penetration = sphereWs.m_radius - distance;
+	}
+	else
+	{
+		out_contacts->normal = -1.f * planeWs.m_normal;
+		out_contacts->penetration = sphereWs.m_radius - Abs(distance);
+	}
+
+	out_contacts->position = planeWs.GetProjectedPointOntoPlane(sphereWs.m_center);
+	FillOutColliderInfo(out_contacts, bSphereCol, aPlaneCol);
+
+	out_contacts->CheckValuesAreReasonable();
+	return 1;
+}
+
+
+//-------------------------------------------------------------------------------------------------
+int CollisionDetector::GenerateContacts_PlaneCapsule(const Collider* a, const Collider* b, Contact* out_contacts, int limit)
+{
+	const PlaneCollider* aPlaneCol = ColliderCast<PlaneCollider>(a);
+	const CapsuleCollider* bCapsuleCol = ColliderCast<CapsuleCollider>(b);
+	ASSERT_OR_DIE(aPlaneCol != nullptr && bCapsuleCol != nullptr, "Capsules are of wrong type!");
+
+	if (limit <= 0)
+		return 0;
+
+	Plane3 planeWs = aPlaneCol->GetDataInWorldSpace();
+	Capsule3 capsuleWs = bCapsuleCol->GetDataInWorldSpace();
+
+	float startDistance = planeWs.GetDistanceFromPlane(capsuleWs.start);
+	float endDistance = planeWs.GetDistanceFromPlane(capsuleWs.end);
+	bool startCloser = Abs(startDistance) < Abs(endDistance);
+	bool bisected = (startDistance > 0.f && endDistance < 0.f) || (startDistance < 0.f && endDistance > 0.f);
+
+	Vector3 normal = Vector3::ZERO;
+	if (bisected)
+	{
+		// Push out the direction of least correction
+		if (startCloser)
+		{
+			normal = (startDistance < 0.f ? planeWs.m_normal : -1.0f * planeWs.m_normal);
+		}
+		else
+		{
+			normal = (endDistance < 0.f ? planeWs.m_normal : -1.0f * planeWs.m_normal);
+		}
+	}
+	else
+	{
+		// Both endpoints are on the same side, so they both have the same normal direction
+		normal = (startDistance > 0.f ? planeWs.m_normal : -1.0f * planeWs.m_normal);
+	}
+
+	// Just for convenience
+	planeWs.m_normal = normal;
+
+	int numAdded = 0;
+	if (Abs(startDistance) < capsuleWs.radius || (bisected && startCloser))
+	{
+		out_contacts->normal = normal;
+		out_contacts->penetration = (planeWs.IsPointInFront(capsuleWs.start) ? (capsuleWs.radius - Abs(startDistance)) : (capsuleWs.radius + Abs(startDistance)));
+		out_contacts->position = capsuleWs.start - normal * capsuleWs.radius;
+		FillOutColliderInfo(out_contacts, bCapsuleCol, aPlaneCol);
+		out_contacts->CheckValuesAreReasonable();
+		numAdded++;
+		out_contacts++;
+
+		if (limit == 1)
+			return 1;
+	}
+
+	if (Abs(endDistance) < capsuleWs.radius || (bisected && !startCloser))
+	{
+		out_contacts->normal = normal;
+		out_contacts->penetration = (planeWs.IsPointInFront(capsuleWs.end) ? (capsuleWs.radius - Abs(endDistance)) : (capsuleWs.radius + Abs(endDistance)));
+		out_contacts->position = capsuleWs.end - normal * capsuleWs.radius;
+		FillOutColliderInfo(out_contacts, bCapsuleCol, aPlaneCol);
+		out_contacts->CheckValuesAreReasonable();
+		numAdded++;
+	}
+
+	return numAdded;
+}
+
+
+//-------------------------------------------------------------------------------------------------
+int CollisionDetector::GenerateContacts_PlaneBox(const Collider* a, const Collider* b, Contact* out_contacts, int limit)
+{
+	const PlaneCollider* aPlaneCol = ColliderCast<PlaneCollider>(a);
+	const BoxCollider* bBoxCol = ColliderCast<BoxCollider>(b);
+	ASSERT_OR_DIE(aPlaneCol != nullptr && bBoxCol != nullptr, "Colliders are of wrong type!");
+
+	if (limit <= 0)
+		return 0;
+
+	Plane3 planeWs = aPlaneCol->GetDataInWorldSpace();
+	OBB3 boxWs = bBoxCol->GetDataInWorldSpace();
+
+	Vector3 boxVertsWs[8];
+	boxWs.GetPoints(boxVertsWs);
+
+	int numContactsAdded = 0;
+	Contact* contactToFill = out_contacts;
+
+	int pointsBehind[8];
+	int pointsInFront[8];
+	int numBehind = 0;
+	int numInFront = 0;
+	float maxFrontDistance = 0.f;
+	float maxBehindDistance = 0.f;
+
+	for (int i = 0; i < 8; ++i)
+	{
+		float distance = planeWs.GetDistanceFromPlane(boxVertsWs[i]);
+
+		if (distance < 0.f)
+		{
+			pointsBehind[numBehind++] = i;
+			maxBehindDistance = Max(Abs(distance), maxBehindDistance);
+		}
+		else if (distance > 0.f)
+		{
+			pointsInFront[numInFront++] = i;
+			maxFrontDistance = Max(Abs(distance), maxFrontDistance);
+		}
+	}
+
+	// If all the points are on one side, there's no collision
+	if (numBehind == 0 || numInFront == 0)
+	{
+		return 0;
+	}
+
+	const int* penPoints;
+	int numPenPoints;
+	float normalSign = 1.0f;
+
+	if (maxFrontDistance < maxBehindDistance)
+	{
+		penPoints = pointsInFront;
+		numPenPoints = numInFront;
+		normalSign *= -1.0f;
+	}
+	else
+	{
+		penPoints = pointsBehind;
+		numPenPoints = numBehind;
+	}
+
+	for (int iPenPoint = 0; iPenPoint < numPenPoints; ++iPenPoint)
+	{
+		Vector3 point = boxVertsWs[penPoints[iPenPoint]];
+
+		contactToFill->position = point;
+		contactToFill->normal = normalSign * planeWs.m_normal;
+		contactToFill->penetration = Abs(planeWs.GetDistanceFromPlane(point));
+		FillOutColliderInfo(contactToFill, bBoxCol, aPlaneCol);
+
+		contactToFill->CheckValuesAreReasonable();
+		numContactsAdded++;
+
+		if (numContactsAdded < limit)
+		{
+			contactToFill = &out_contacts[numContactsAdded];
+		}
+		else
+		{
+			break;
+		}
+	}
+
+	return numContactsAdded;
+}
+
+
+//-------------------------------------------------------------------------------------------------
+int CollisionDetector::GenerateContacts_PlaneCylinder(const Collider* a, const Collider* b, Contact* out_contacts, int limit)
+{
+	const PlaneCollider* aPlaneCol = ColliderCast<PlaneCollider>(a);
+	const CylinderCollider* bCylinderCol = ColliderCast<CylinderCollider>(b);
+	ASSERT_OR_DIE(aPlaneCol != nullptr && bCylinderCol != nullptr, "Colliders are of wrong type!");
+
+	if (limit <= 0)
+		return 0;
+
+	const Plane3 planeWs = aPlaneCol->GetDataInWorldSpace();
+	const Cylinder cylinderWs = bCylinderCol->GetDataInWorldSpace();
+
+	int numContactsAdded = 0;
+	Contact* contactToFill = out_contacts;
+
+	bool limitToTop = true;
+	Vector3 frontTopPointWs = cylinderWs.GetFurthestEdgePointInDirection(planeWs.m_normal, &limitToTop);
+	Vector3 backTopPointWs = cylinderWs.GetFurthestEdgePointInDirection(-1.0f * planeWs.m_normal, &limitToTop);
+
+	limitToTop = false;
+	Vector3 frontBottomPointWs = cylinderWs.GetFurthestEdgePointInDirection(planeWs.m_normal, &limitToTop);
+	Vector3 backBottomPointWs = cylinderWs.GetFurthestEdgePointInDirection(-1.0f * planeWs.m_normal, &limitToTop);
+
+	// If the points are on the same side of the plane, there's no intersection
+	float frontTopDist = planeWs.GetDistanceFromPlane(frontTopPointWs);
+	float backTopDist = planeWs.GetDistanceFromPlane(backTopPointWs);
+	float frontBottomDist = planeWs.GetDistanceFromPlane(frontBottomPointWs);
+	float backBottomDist = planeWs.GetDistanceFromPlane(backBottomPointWs);
+
+	// Check top face intersecting
+	bool topIntersection = (frontTopDist * backTopDist < 0.f);
+	bool bottomIntersection = (frontBottomDist * backBottomDist < 0.f);
+
+	if (topIntersection && !bottomIntersection)
 	{
-		const Edge3& edge = edges[i];
+		if (Abs(frontTopDist) < Abs(backTopDist))
+		{
+			// Push against the plane normal to correct
+			contactToFill->position = frontTopPointWs;
+			contactToFill->normal = -1.0f * planeWs.m_normal;
+			contactToFill->penetration = Abs(frontTopDist);
+		}
+		else
+		{
+			// Push towards the plane normal to correct
+			contactToFill->position = backTopPointWs;
+			contactToFill->normal = planeWs.m_normal;
+			contactToFill->penetration = Abs(backTopDist);
+		}
 
-		// Get the distance between the closest points on the box edge and the capsule's spine
-		Vector3 capsulePt, boxPt;
-		float distance = FindNearestPoints(capsule.start, capsule.end, edge.m_start, edge.m_end, capsulePt, boxPt);
+		FillOutColliderInfo(contactToFill, bCylinderCol, aPlaneCol);
 
-		// Get these in the box's local space to check Voronoi regions
-		// Only consider edge overlap if the capsule closest point either
-		// 1. Is inside the box
-		// 2. Is in the voronoi region adjacent to the edge
-		// This prevents bad cases of overlapping edges across the box and pushing the wrong way
-		Vector3 capsulePtLs = box.TransformPositionIntoSpace(capsulePt);
-		Vector3 boxPtLs = box.TransformPositionIntoSpace(boxPt);
-		const Vector3& extents = box.extents;
-		bool boxContainsCapsulePt = (Abs(capsulePtLs.x) < extents.x) && (Abs(capsulePtLs.y) < extents.y) && (Abs(capsulePtLs.z) < extents.z);
+		contactToFill->CheckValuesAreReasonable();
+		numContactsAdded++;
+	}
+	else if (!topIntersection && bottomIntersection)
+	{
+		if (Abs(frontBottomDist) < Abs(backBottomDist))
+		{
+			// Push against the plane normal to correct
+			contactToFill->position = frontBottomPointWs;
+			contactToFill->normal = -1.0f * planeWs.m_normal;
+			contactToFill->penetration = Abs(frontBottomDist);
+		}
+		else
+		{
+			// Push towards the plane normal to correct
+			contactToFill->position = backBottomPointWs;
+			contactToFill->normal = planeWs.m_normal;
+			contactToFill->penetration = Abs(backBottomDist);
+		}
 
-		bool isInCorrectVoronoiRegion = true;
-		if (!boxContainsCapsulePt)
+		FillOutColliderInfo(contactToFill, bCylinderCol, aPlaneCol);
+
+		contactToFill->CheckValuesAreReasonable();
+		numContactsAdded++;
+	}
+	else if (topIntersection && bottomIntersection)
+	{
+		// Make sure we don't push the cylinder into a bad state
+		// This occurs if the top want to correct the opposite direction the bottom wants
+
+		// If both are wanting to go to the same side of the plane, no problem!
+		bool topWantsFront = Abs(backTopDist) < Abs(frontTopDist);
+		bool bottomWantsFront = Abs(backBottomDist) < Abs(frontBottomDist);
+
+		if (topWantsFront == bottomWantsFront)
 		{
-			for (int j = 0; j < 3; ++j)
+			Vector3 normal = (topWantsFront ? planeWs.m_normal : -1.0f * planeWs.m_normal);
+
+			if (topWantsFront)
 			{
-				// If the box point is at an extent...
-				if (AreMostlyEqual(Abs(boxPtLs.data[j]), extents.data[j]))
+				contactToFill->position = backTopPointWs;
+				contactToFill->normal = normal;
+				contactToFill->penetration = Abs(backTopDist);
+				FillOutColliderInfo(contactToFill, bCylinderCol, aPlaneCol);
+				contactToFill->CheckValuesAreReasonable();
+				numContactsAdded++;
+
+				if (numContactsAdded < limit) { contactToFill = &out_contacts[numContactsAdded]; }
+				else
 				{
-					// Ensure we're outside of them in that direction
-					// i.e. "If the point is on the max x, make sure we're farther out on x, if the box point is on negative z, make sure we're below that"
-					if ((boxPtLs.data[j] > 0.f && boxPtLs.data[j] > capsulePtLs.data[j]) || (boxPtLs.data[j] < 0.f && boxPtLs.data[j] < capsulePtLs.data[j]))
-					{
-						isInCorrectVoronoiRegion = false;
-						break;
-					}
+					return numContactsAdded;
+				}
+
+				contactToFill->position = backBottomPointWs;
+				contactToFill->normal = normal;
+				contactToFill->penetration = Abs(backBottomDist);
+				FillOutColliderInfo(contactToFill, bCylinderCol, aPlaneCol);
+				contactToFill->CheckValuesAreReasonable();
+				numContactsAdded++;
+			}
+			else
+			{
+				contactToFill->position = frontTopPointWs;
+				contactToFill->normal = normal;
+				contactToFill->penetration = Abs(frontTopDist);
+				FillOutColliderInfo(contactToFill, bCylinderCol, aPlaneCol);
+				contactToFill->CheckValuesAreReasonable();
+				numContactsAdded++;
+
+				if (numContactsAdded < limit) { contactToFill = &out_contacts[numContactsAdded]; }
+				else
+				{
+					return numContactsAdded;
 				}
+
+				contactToFill->position = frontBottomPointWs;
+				contactToFill->normal = normal;
+				contactToFill->penetration = Abs(frontBottomDist);
+				FillOutColliderInfo(contactToFill, bCylinderCol, aPlaneCol);
+				contactToFill->CheckValuesAreReasonable();
+				numContactsAdded++;
+			}
+		}
+		else
+		{
+			// Conflict - whoever has the min distance gets the say, and the other has to just go along with it
+			Vector3 topContactPos, bottomContactPos;
+			float topPen, bottomPen;
+			Vector3 normal;
+
+			float minDist = Min(frontBottomDist, backBottomDist, frontTopDist, backTopDist);
+
+			if (minDist == frontBottomDist || minDist == frontTopDist)
+			{
+				// Push backwards
+				normal = -1.0f * planeWs.m_normal;
+
+				bottomContactPos = frontBottomPointWs;
+				bottomPen = Abs(frontBottomDist);
+
+				topContactPos = frontTopPointWs;
+				topPen = Abs(frontTopDist);
+			}
+			else
+			{
+				// Push forward
+				normal = planeWs.m_normal;
+
+				bottomContactPos = backBottomPointWs;
+				bottomPen = Abs(backBottomDist);
+
+				topContactPos = backTopPointWs;
+				topPen = Abs(backTopDist);
+			}
+
+			contactToFill->position = topContactPos;
+			contactToFill->normal = normal;
+			contactToFill->penetration = topPen;
+			FillOutColliderInfo(contactToFill, bCylinderCol, aPlaneCol);
+			contactToFill->CheckValuesAreReasonable();
+			numContactsAdded++;
+
+			if (numContactsAdded < limit) { contactToFill = &out_contacts[numContactsAdded]; }
+			else
+			{
+				return numContactsAdded;
+			}
+
+			contactToFill->position = bottomContactPos;
+			contactToFill->normal = normal;
+			contactToFill->penetration = bottomPen;
+			FillOutColliderInfo(contactToFill, bCylinderCol, aPlaneCol);
+			contactToFill->CheckValuesAreReasonable();
+			numContactsAdded++;
+		}
+	}
+	else
+	{
+		float maxDist = Max(frontBottomDist, backBottomDist, frontTopDist, backTopDist);
+		float minDist = Min(frontBottomDist, backBottomDist, frontTopDist, backTopDist);
+
+		if (minDist * maxDist < 0.f)
+		{
+			// If the min pen is closer to the plane than max, it's shorter to push with the normal
+			bool pushInFrontOfPlane = Abs(minDist) < Abs(maxDist);
+			Vector3 normal = pushInFrontOfPlane ? planeWs.m_normal : -1.0f * planeWs.m_normal;
+			bool isTopFace = (pushInFrontOfPlane ? (minDist == backTopDist) : (maxDist == frontTopDist));
+
+			// Shorter to push the cylinder in front of the plane
+			// Determine if the top or bottom of the cylinder is behind the plane
+			if (isTopFace)
+			{
+				contactToFill->position = backTopPointWs;
+				contactToFill->normal = normal;
+				contactToFill->penetration = Abs(backTopDist);
+				FillOutColliderInfo(contactToFill, bCylinderCol, aPlaneCol);
+				contactToFill->CheckValuesAreReasonable();
+				numContactsAdded++;
+
+				if (numContactsAdded < limit) { contactToFill = &out_contacts[numContactsAdded]; }
 				else
 				{
-					// Technically the below should never fail....due to how the distance calculation finds the end points
-					if (Abs(capsulePtLs.data[j] > extents.data[j]))
-					{
-						isInCorrectVoronoiRegion = false;
-						break;
-					}
+					return numContactsAdded;
+				}
+
+				// In case the cylinder spine is parallel to the plane normal, the two edge points would be the endpoint itself
+				if (!AreMostlyEqual(backTopPointWs, frontTopPointWs))
+				{
+					contactToFill->position = frontTopPointWs;
+					contactToFill->normal = normal;
+					contactToFill->penetration = Abs(frontTopDist);
+					FillOutColliderInfo(contactToFill, bCylinderCol, aPlaneCol);
+					contactToFill->CheckValuesAreReasonable();
+					numContactsAdded++;
+				}
+			}
+			else
+			{
+				contactToFill->position = backBottomPointWs;
+				contactToFill->normal = normal;
+				contactToFill->penetration = Abs(backBottomDist);
+				FillOutColliderInfo(contactToFill, bCylinderCol, aPlaneCol);
+				contactToFill->CheckValuesAreReasonable();
+				numContactsAdded++;
+
+				if (numContactsAdded < limit) { contactToFill = &out_contacts[numContactsAdded]; }
+				else
+				{
+					return numContactsAdded;
 				}
-			}
-		}
 
-		if (boxContainsCapsulePt || isInCorrectVoronoiRegion)
-		{
-			float sign = (box.ContainsWorldSpacePoint(capsulePt) ? 1.0f : -1.0f);
-			float pen = sign * distance + capsule.radius;
-			if (pen > 0.f && pen < out_pen)
-			{
-				out_pen = pen;
-				out_normal = (-1.f * sign) * (capsulePt - boxPt) / distance;
-				out_position = capsulePt - out_normal * distance;
+				// In case the cylinder spine is parallel to the plane normal, the two edge points would be the endpoint itself
+				if (!AreMostlyEqual(backBottomPointWs, frontBottomPointWs))
+				{
+					contactToFill->position = frontBottomPointWs;
+					contactToFill->normal = normal;
+					contactToFill->penetration = Abs(frontBottomDist);
+					FillOutColliderInfo(contactToFill, bCylinderCol, aPlaneCol);
+					contactToFill->CheckValuesAreReasonable();
+					numContactsAdded++;
+				}
 			}
 		}
 	}
 
-	return (out_pen < FLT_MAX);
+	return numContactsAdded;
 }
 
 
 //-------------------------------------------------------------------------------------------------
-int CollisionDetector::GenerateContacts_CapsuleBox(const Collider* a, const Collider* b, Contact* out_contacts, int limit)
+int CollisionDetector::GenerateContacts_PlaneHull(const Collider* a, const Collider* b, Contact* out_contacts, int limit)
 {
-	const CapsuleCollider* aCapsuleCol = a->GetAsType<CapsuleCollider>();
-	const BoxCollider* bBoxCol = b->GetAsType<BoxCollider>();
-	ASSERT_OR_DIE(aCapsuleCol != nullptr && bBoxCol != nullptr, "Colliders are of wrong type!");
+	const PlaneCollider* aPlaneCol = ColliderCast<PlaneCollider>(a);
+	const ConvexHullCollider* bHullCol = ColliderCast<ConvexHullCollider>(b);
+	ASSERT_OR_DIE(aPlaneCol != nullptr && bHullCol != nullptr, "Colliders are of wrong type!");
 
 	if (limit <= 0)
 		return 0;
 
-	Capsule3 capsuleWs = aCapsuleCol->GetDataInWorldSpace();
-	OBB3 boxWs = bBoxCol->GetDataInWorldSpace();
-
-	float facePens[2];
-	Vector3 faceNormal;
-	Vector3 faceContactPos[2];
-	bool hasFaceOverlap = GetMinPlanePen(boxWs, capsuleWs, facePens, faceContactPos, faceNormal);
+	Plane3 planeWs = aPlaneCol->GetDataInWorldSpace();
+	Polyhedron& polyWs = s_narrowphaseScratch.m_hullsWs[0];
+	bHullCol->GetDataInWorldSpace(polyWs);
 
-	float edgePen = FLT_MAX;
-	Vector3 edgeNormal = Vector3::ZERO;
-	Vector3 edgePos = Vector3::ZERO;
-	bool hasEdgeOverlap = GetMinEdgePen(boxWs, capsuleWs, edgePen, edgeNormal, edgePos);
+	// Keep track of which points are in front/behind the plane
+	std::vector<Vector3>& frontPts = s_narrowphaseScratch.m_frontPoints;
+	std::vector<Vector3>& backPts = s_narrowphaseScratch.m_backPoints;
+	frontPts.clear();
+	backPts.clear();
+	
+	// And distances for the sake of sorting
+	std::vector<float>& frontDists = s_narrowphaseScratch.m_frontDistances;
+	std::vector<float>& backDists = s_narrowphaseScratch.m_backDistances;
+	frontDists.clear();
+	backDists.clear();
 
-	// If we have face overlap but no edge overlap *or* the face overlap has less pen than the edge, make face contacts
-	int numContactsAdded = 0;
+	// ...and the "worst" we've seen on each side
+	float maxFrontDist = -1.f;
+	float maxBackDist = -1.f;
 
-	if (hasFaceOverlap)
+	int numVerts = polyWs.GetNumVertices();
+	for (int iVert = 0; iVert < numVerts; ++iVert)
 	{
-		if (facePens[0] < FLT_MAX)
+		Vector3 vert = polyWs.GetVertexPosition(iVert);
+		float dist = planeWs.GetDistanceFromPlane(vert);
+
+		bool inFront = (dist >= 0.f);
+
+		dist = Abs(dist);
+		std::vector<Vector3>& points = (inFront ? frontPts : backPts);
+		std::vector<float>& distances = (inFront ? frontDists : backDists);
+		float& maxDist = (inFront ? maxFrontDist : maxBackDist);
+		maxDist = Max(maxDist, dist);
+
+		// Insert the point in the right array, sorted by descending distance
+		int index = -1;
+		for (int i = 0; i < (int)distances.size(); ++i)
 		{
-			out_contacts->normal = faceNormal;
-			out_contacts->penetration = facePens[0];
-			out_contacts->position = faceContactPos[0];
-			FillOutColliderInfo(out_contacts, aCapsuleCol, bBoxCol);
-			out_contacts->CheckValuesAreReasonable();
-			out_contacts++;
-			numContactsAdded++;
+			if (dist > distances[i])
+			{
+				index = i;
+				break;
+			}
 		}
 
-		if (facePens[1] < FLT_MAX && numContactsAdded < limit)
+		if (index >= 0)
 		{
-			out_contacts->normal = faceNormal;
-			out_contacts->penetration = facePens[1];
-			out_contacts->position = faceContactPos[1];
-			FillOutColliderInfo(out_contacts, aCapsuleCol, bBoxCol);
-			out_contacts->CheckValuesAreReasonable();
-			out_contacts++;
-			numContactsAdded++;
+			points.insert(points.begin() + index, vert);
+			distances.insert(distances.begin() + index, dist);
+		}
+		else
+		{
+			points.push_back(vert);
+			distances.push_back(dist);
 		}
 	}
 
-	if (hasEdgeOverlap)
-	{
-		out_contacts->normal = edgeNormal;
-		out_contacts->penetration = edgePen;
-		out_contacts->position = edgePos;
-		FillOutColliderInfo(out_contacts, aCapsuleCol, bBoxCol);
-		out_contacts->CheckValuesAreReasonable();
+	// If we're not intersecting the plane, don't do anything
+	if (frontPts.size() == 0 || backPts.size() == 0)
+		return 0;
 
-		numContactsAdded++;
+	// Choose to generate contacts on the side that's closer to the plane
+	bool pushBehindPlane = (maxFrontDist < maxBackDist);
+	const std::vector<Vector3>& positions = (pushBehindPlane ? frontPts : backPts);
+	const std::vector<float>& pens = (pushBehindPlane ? frontDists : backDists);
+	Vector3 normal = (pushBehindPlane ? -1.0f * planeWs.m_normal : planeWs.m_normal);
+
+	int numContacts = Min((int)positions.size(), limit);
+	for (int iContact = 0; iContact < numContacts; ++iContact)
+	{
+		out_contacts[iContact].position = positions[iContact];
+		out_contacts[iContact].normal = normal;
+		out_contacts[iContact].penetration = pens[iContact];
+		FillOutColliderInfo(&out_contacts[iContact], bHullCol, aPlaneCol);
+		out_contacts[iContact].CheckValuesAreReasonable();
 	}
 
-	return numContactsAdded;
+	return numContacts;
 }
 
 
 //-------------------------------------------------------------------------------------------------
-int CollisionDetector::GenerateContacts_CapsuleCylinder(const Collider* a, const Collider* b, Contact* out_contacts, int limit)
+int CollisionDetector::GenerateContacts_SphereVoxelGrid(const Collider* a, const Collider* b, Contact* out_contacts, int limit)
 {
+	const SphereCollider* aSphereCol = ColliderCast<SphereCollider>(a);
+	const VoxelGridCollider* bGridCol = ColliderCast<VoxelGridCollider>(b);
+	ASSERT_OR_DIE(aSphereCol != nullptr && bGridCol != nullptr, "Colliders are of wrong type!");
+
 	if (limit <= 0)
 		return 0;
 
-	int numContacts = 0;
-	const CapsuleCollider* aCapsuleCol = a->GetAsType<CapsuleCollider>();
-	const CylinderCollider* bCylinderCol = b->GetAsType<CylinderCollider>();
-	ASSERT_OR_DIE(aCapsuleCol != nullptr && bCylinderCol != nullptr, "Colliders are of wrong type!");
-
-	Capsule3 capsuleWs = aCapsuleCol->GetDataInWorldSpace();
-	Cylinder cylinderWs = bCylinderCol->GetDataInWorldSpace();
+	const Transform& gridTransform = bGridCol->m_entity->transform;
+	Sphere sphereWs = aSphereCol->GetDataInWorldSpace();
+	Vector3 centerLs = gridTransform.InverseTransformPosition(sphereWs.m_center);
+	float radiusLs = sphereWs.m_radius / gridTransform.scale.x;
 
-	LineSegment3 capsuleSpine(capsuleWs.start, capsuleWs.end);
+	IntVector3 minCoords, maxCoords;
+	if (!bGridCol->GetCellRangeOverlapping(AABB3(centerLs - Vector3(radiusLs), centerLs + Vector3(radiusLs)), minCoords, maxCoords))
+		return 0;
 
-	GJKSolver3D<LineSegment3, Cylinder> solver(capsuleSpine, cylinderWs);
-	bool foundSolution = solver.Solve();
+	ManifoldPoint points[MAX_MANIFOLD_CANDIDATES];
+	int numPoints = 0;
 
-	if (foundSolution)
+	for (int y = minCoords.y; y <= maxCoords.y; ++y)
 	{
-		float separation = solver.GetSeparationDistance();
-		if (separation <= 0.f)
-		{
-
-		}
-		else if (separation < capsuleWs.radius)
+		for (int z = minCoords.z; z <= maxCoords.z; ++z)
 		{
-			Vector3 capsulePt = solver.GetClosestPointOnA();
-			Vector3 cylinderPt = solver.GetClosestPointOnB();
-			Vector3 normal = solver.GetSeparationNormal();
-
-			out_contacts[0].normal = normal;
-			out_contacts[0].penetration = capsuleWs.radius - separation;
-			out_contacts[0].position = cylinderPt;
-			FillOutColliderInfo(&out_contacts[0], aCapsuleCol, bCylinderCol);
-			out_contacts[0].CheckValuesAreReasonable();
+			for (int x = minCoords.x; x <= maxCoords.x; ++x)
+			{
+				IntVector3 cellCoords(x, y, z);
+				if (!bGridCol->IsCellOccupied(cellCoords))
+					continue;
 
-			numContacts = 1;
+				Vector3 positionLs, normalLs;
+				float penetrationLs;
+				if (GetSphereVoxelCellContactLs(bGridCol, cellCoords, centerLs, radiusLs, positionLs, normalLs, penetrationLs))
+				{
+					AddManifoldCandidate(points, numPoints, MAX_MANIFOLD_CANDIDATES, MakeVoxelManifoldPointWs(gridTransform, positionLs, normalLs, penetrationLs));
+				}
+			}
 		}
 	}
 
-	return numContacts;
+	return FinishGatheredContacts(a, bGridCol, points, numPoints, out_contacts, limit);
 }
 
 
 //-------------------------------------------------------------------------------------------------
-int CollisionDetector::GenerateContacts_CapsuleHull(const Collider* a, const Collider* b, Contact* out_contacts, int limit)
+int CollisionDetector::GenerateContacts_CapsuleVoxelGrid(const Collider* a, const Collider* b, Contact* out_contacts, int limit)
 {
+	const CapsuleCollider* aCapsuleCol = ColliderCast<CapsuleCollider>(a);
+	const VoxelGridCollider* bGridCol = ColliderCast<VoxelGridCollider>(b);
+	ASSERT_OR_DIE(aCapsuleCol != nullptr && bGridCol != nullptr, "Colliders are of wrong type!");
+
 	if (limit <= 0)
 		return 0;
 
-	int numContacts = 0;
-	const CapsuleCollider* aCapsuleCol = a->GetAsType<CapsuleCollider>();
-	const ConvexHullCollider* bHullCol = b->GetAsType<ConvexHullCollider>();
-	ASSERT_OR_DIE(aCapsuleCol != nullptr && bHullCol != nullptr, "Colliders are of wrong type!");
-
+	const Transform& gridTransform = bGridCol->m_entity->transform;
 	Capsule3 capsuleWs = aCapsuleCol->GetDataInWorldSpace();
-	Polyhedron polyWs = bHullCol->GetDataInWorldSpace();
-
-	LineSegment3 capSpine(capsuleWs.start, capsuleWs.end);
-	Vector3 closestPtOnSpine, closestPtOnHull;
-	float dist = FindNearestPoints(capSpine, polyWs, closestPtOnSpine, closestPtOnHull);
-
-	if (dist <= 0.f)
-	{
-		// Deep contact - use SAT to find the best axis
-		SATResult_CapsuleHull result;
-		bool areOverlapping = SAT::GetMinPenAxis(capsuleWs, polyWs, result);
-		ASSERT_OR_DIE(areOverlapping, "Found an axis of separation?");
-
-		if (result.m_isFaceAxis)
-		{
-			// Clip capsule segment to the face
-			LineSegment3 clippedSpine = capSpine;
-			polyWs.ClipEdgeToFace(result.m_iFaceOrEdge, clippedSpine);
-			Plane3 facePlane = polyWs.GetFaceSupportPlane(result.m_iFaceOrEdge);
-
-			int maxContacts = Min(limit, 2);
-			for (int iContact = 0; iContact < maxContacts; ++iContact)
-			{
-				Vector3 endPoint = (iContact == 0 ? clippedSpine.m_a : clippedSpine.m_b);
-				float pen = capsuleWs.radius - facePlane.GetDistanceFromPlane(endPoint);
+	Vector3 startLs = gridTransform.InverseTransformPosition(capsuleWs.start);
+	Vector3 endLs = gridTransform.InverseTransformPosition(capsuleWs.end);
+	float radiusLs = capsuleWs.radius / gridTransform.scale.x;
 
-				if (pen >= 0.f)
-				{
-					out_contacts[numContacts].position = facePlane.GetProjectedPointOntoPlane(endPoint);
-					out_contacts[numContacts].normal = facePlane.m_normal;
-					out_contacts[numContacts].penetration = pen;
-					FillOutColliderInfo(&out_contacts[numContacts], aCapsuleCol, bHullCol);
-					out_contacts[numContacts].CheckValuesAreReasonable();
-					numContacts++;
-				}
-			}
-		}
-		else
-		{
-			// Find closest points between the capsule spine and the edge
-			LineSegment3 hullEdge = polyWs.GetEdgeSegment(result.m_iFaceOrEdge);
-			dist = FindNearestPoints(capSpine, hullEdge, closestPtOnSpine, closestPtOnHull);
+	AABB3 boundsLs;
+	boundsLs.mins = Vector3(Min(startLs.x, endLs.x), Min(startLs.y, endLs.y), Min(startLs.z, endLs.z)) - Vector3(radiusLs);
+	boundsLs.maxs = Vector3(Max(startLs.x, endLs.x), Max(startLs.y, endLs.y), Max(startLs.z, endLs.z)) + Vector3(radiusLs);
 
-			Vector3 normal = result.m_axis;
+	IntVector3 minCoords, maxCoords;
+	if (!bGridCol->GetCellRangeOverlapping(boundsLs, minCoords, maxCoords))
+		return 0;
 
-			// Keep axis pointing towards capsule
-			if (DotProduct(polyWs.GetCenter() - capsuleWs.GetCenter(), normal) > 0.f)
-			{
-				normal *= -1.0f;
-			}
+	ManifoldPoint points[MAX_MANIFOLD_CANDIDATES];
+	int numPoints = 0;
 
-			out_contacts[0].position = 0.5f * (closestPtOnSpine + closestPtOnHull); // Position contact halfway between capsule and hull
-			out_contacts[0].normal = normal;
-			out_contacts[0].penetration = result.m_pen;
-			FillOutColliderInfo(&out_contacts[0], aCapsuleCol, bHullCol);
-			out_contacts[0].CheckValuesAreReasonable();
-			numContacts = 1;
-		}
-	}
-	else if (dist < capsuleWs.radius)
+	for (int y = minCoords.y; y <= maxCoords.y; ++y)
 	{
-		// Shallow contact - check if it's with an edge or a face
-		Vector3 normalFromGJK = (closestPtOnSpine - closestPtOnHull).GetNormalized();
-		int faceIndex = polyWs.GetIndexOfFaceMostInDirection(normalFromGJK);
-
-		if (AreMostlyEqual(DotProduct(normalFromGJK, polyWs.GetFaceNormal(faceIndex)), 1.0f))
+		for (int z = minCoords.z; z <= maxCoords.z; ++z)
 		{
-			// Shallow contact on face - we can generate 2 contacts!
-			LineSegment3 clippedSpine = capSpine;
-			polyWs.ClipEdgeToFace(faceIndex, clippedSpine);
-			Plane3 facePlane = polyWs.GetFaceSupportPlane(faceIndex);
-
-			int maxContacts = Min(limit, 2);
-			for (int iContact = 0; iContact < maxContacts; ++iContact)
+			for (int x = minCoords.x; x <= maxCoords.x; ++x)
 			{
-				Vector3 endPoint = (iContact == 0 ? clippedSpine.m_a : clippedSpine.m_b);
-				float pen = capsuleWs.radius - facePlane.GetDistanceFromPlane(endPoint);
-
-				if (pen >= 0.f)
-				{
-					out_contacts[numContacts].position = facePlane.GetProjectedPointOntoPlane(endPoint);
-					out_contacts[numContacts].normal = facePlane.m_normal;
-					out_contacts[numContacts].penetration = pen;
-					FillOutColliderInfo(&out_contacts[numContacts], aCapsuleCol, bHullCol);
-					out_contacts[numContacts].CheckValuesAreReasonable();
-					numContacts++;
-				}
-			}
-		}
-		else
-		{
-			// Shallow contact on edge
-			out_contacts[0].position = closestPtOnHull;
-			out_contacts[0].normal = normalFromGJK; // I don't divide by distance to avoid propagating error
-			out_contacts[0].penetration = capsuleWs.radius - dist;
-			FillOutColliderInfo(&out_contacts[0], aCapsuleCol, bHullCol);
-			out_contacts[0].CheckValuesAreReasonable();
-			numContacts = 1;
+				IntVector3 cellCoords(x, y, z);
+				if (!bGridCol->IsCellOccupied(cellCoords))
+					continue;
+
+				// Treat it as a sphere at the part of the segment nearest this cell
+				Vector3 centerLs = GetPointOnSegmentClosestToAABB(startLs, endLs, bGridCol->GetCellBoundsLs(cellCoords));
+
+				Vector3 positionLs, normalLs;
+				float penetrationLs;
+				if (GetSphereVoxelCellContactLs(bGridCol, cellCoords, centerLs, radiusLs, positionLs, normalLs, penetrationLs))
+				{
+					AddManifoldCandidate(points, numPoints, MAX_MANIFOLD_CANDIDATES, MakeVoxelManifoldPointWs(gridTransform, positionLs, normalLs, penetrationLs));
+				}
+			}
 		}
 	}
 
-	return numContacts;
+	return FinishGatheredContacts(a, bGridCol, points, numPoints, out_contacts, limit);
 }
 
 
 //-------------------------------------------------------------------------------------------------
-int CollisionDetector::GenerateContacts_PlaneSphere(const Collider* a, const Collider* b, Contact* out_contacts, int limit)
+// Box vertices inside solid cells, plus surface corners of the grid poking into the box
+int CollisionDetector::GenerateContacts_BoxVoxelGrid(const Collider* a, const Collider* b, Contact* out_contacts, int limit)
 {
-	const PlaneCollider* aPlaneCol = a->GetAsType<PlaneCollider>();
-	const SphereCollider* bSphereCol = b->GetAsType<SphereCollider>();
-	ASSERT_OR_DIE(aPlaneCol != nullptr && bSphereCol != nullptr, "Colliders are of wrong type!");
+	const BoxCollider* aBoxCol = ColliderCast<BoxCollider>(a);
+	const VoxelGridCollider* bGridCol = ColliderCast<VoxelGridCollider>(b);
+	ASSERT_OR_DIE(aBoxCol != nullptr && bGridCol != nullptr, "Colliders are of wrong type!");
 
 	if (limit <= 0)
 		return 0;
 
-	Plane3 planeWs = aPlaneCol->GetDataInWorldSpace();
-	Sphere sphereWs = bSphereCol->GetDataInWorldSpace();
-
-	float distance = planeWs.GetDistanceFromPlane(sphereWs.m_center);
+	OBB3 boxWs = aBoxCol->GetDataInWorldSpace();
+	Vector3 boxVertsWs[8];
+	boxWs.GetPoints(boxVertsWs);
 
-	// Sphere too far in front of plane; its radius isn't enough to intersect the plane
-	if (Abs(distance) >= sphereWs.m_radius)
+	IntVector3 minCoords, maxCoords;
+	if (!GetShapeBoundsInGridSpace(bGridCol, boxVertsWs, 8, minCoords, maxCoords))
 		return 0;
 
-	// Find the direction to push the sphere
-	if (distance > 0.f)
-	{
-		out_contacts->normal = planeWs.m_normal;
-		out_contacts->penetration = sphereWs.m_radius - distance;
-	}
-	else
+	ManifoldPoint points[MAX_MANIFOLD_CANDIDATES];
+	int numPoints = 0;
+
+	AddVoxelVertexContacts(bGridCol, boxVertsWs, 8, points, numPoints);
+
+	const Transform& gridTransform = bGridCol->m_entity->transform;
+	Matrix3 boxBasis(boxWs.GetRightVector(), boxWs.GetUpVector(), boxWs.GetForwardVector());
+
+	for (int y = minCoords.y; y <= maxCoords.y + 1; ++y)
 	{
-		out_contacts->normal = -1.f * planeWs.m_normal;
-		out_contacts->penetration = sphereWs.m_radius - Abs(distance);
-	}
+		for (int z = minCoords.z; z <= maxCoords.z + 1; ++z)
+		{
+			for (int x = minCoords.x; x <= maxCoords.x + 1; ++x)
+			{
+				if (!IsVoxelCornerOnSurface(bGridCol, x, y, z))
+					continue;
 
-	out_contacts->position = planeWs.GetProjectedPointOntoPlane(sphereWs.m_center);
-	FillOutColliderInfo(out_contacts, bSphereCol, aPlaneCol);
+				Vector3 cornerWs = gridTransform.TransformPosition(Vector3((float)x, (float)y, (float)z) * bGridCol->GetCellSize());
+				Vector3 cornerBoxSpace = boxWs.TransformPositionIntoSpace(cornerWs);
 
-	out_contacts->CheckValuesAreReasonable();
-	return 1;
+				// Push out through the nearest box face
+				float bestDepth = FLT_MAX;
+				int bestAxis = -1;
+				for (int axis = 0; axis < 3; ++axis)
+				{
+					float depth = boxWs.extents.data[axis] - Abs(cornerBoxSpace.data[axis]);
+					if (depth < bestDepth)
+					{
+						bestDepth = depth;
+						bestAxis = axis;
+					}
+				}
+
+				if (bestDepth <= 0.f)
+					continue;
+
+				Vector3 outOfBoxFace = boxBasis.columnVectors[bestAxis] * (cornerBoxSpace.data[bestAxis] > 0.f ? 1.f : -1.f);
+
+				ManifoldPoint point;
+				point.position = cornerWs;
+				point.normal = -1.0f * outOfBoxFace;
+				point.penetration = bestDepth;
+				AddManifoldCandidate(points, numPoints, MAX_MANIFOLD_CANDIDATES, point);
+			}
+		}
+	}
+
+	return FinishGatheredContacts(a, bGridCol, points, numPoints, out_contacts, limit);
 }
 
 
 //-------------------------------------------------------------------------------------------------
-int CollisionDetector::GenerateContacts_PlaneCapsule(const Collider* a, const Collider* b, Contact* out_contacts, int limit)
+// Same approach as boxes, hull vertices inside solid cells plus surface corners of the grid inside the hull
+int CollisionDetector::GenerateContacts_HullVoxelGrid(const Collider* a, const Collider* b, Contact* out_contacts, int limit)
 {
-	const PlaneCollider* aPlaneCol = a->GetAsType<PlaneCollider>();
-	const CapsuleCollider* bCapsuleCol = b->GetAsType<CapsuleCollider>();
-	ASSERT_OR_DIE(aPlaneCol != nullptr && bCapsuleCol != nullptr, "Capsules are of wrong type!");
+	const ConvexHullCollider* aHullCol = ColliderCast<ConvexHullCollider>(a);
+	const VoxelGridCollider* bGridCol = ColliderCast<VoxelGridCollider>(b);
+	ASSERT_OR_DIE(aHullCol != nullptr && bGridCol != nullptr, "Colliders are of wrong type!");
 
 	if (limit <= 0)
 		return 0;
 
-	Plane3 planeWs = aPlaneCol->GetDataInWorldSpace();
-	Capsule3 capsuleWs = bCapsuleCol->GetDataInWorldSpace();
-
-	float startDistance = planeWs.GetDistanceFromPlane(capsuleWs.start);
-	float endDistance = planeWs.GetDistanceFromPlane(capsuleWs.end);
-	bool startCloser = Abs(startDistance) < Abs(endDistance);
-	bool bisected = (startDistance > 0.f && endDistance < 0.f) || (startDistance < 0.f && endDistance > 0.f);
+	Polyhedron& hullWs = s_narrowphaseScratch.m_hullsWs[0];
+	aHullCol->GetDataInWorldSpace(hullWs);
+	int numVertices = hullWs.GetNumVertices();
+	std::vector<Vector3>& hullVertsWs = s_narrowphaseScratch.m_pointsWs;
+	hullVertsWs.resize(numVertices);
 
-	Vector3 normal = Vector3::ZERO;
-	if (bisected)
-	{
-		// Push out the direction of least correction
-		if (startCloser)
-		{
-			normal = (startDistance < 0.f ? planeWs.m_normal : -1.0f * planeWs.m_normal);
-		}
-		else
-		{
-			normal = (endDistance < 0.f ? planeWs.m_normal : -1.0f * planeWs.m_normal);
-		}
-	}
-	else
+	for (int iVertex = 0; iVertex < numVertices; ++iVertex)
 	{
-		// Both endpoints are on the same side, so they both have the same normal direction
-		normal = (startDistance > 0.f ? planeWs.m_normal : -1.0f * planeWs.m_normal);
+		hullVertsWs[iVertex] = hullWs.GetVertexPosition(iVertex);
 	}
 
-	// Just for convenience
-	planeWs.m_normal = normal;
+	IntVector3 minCoords, maxCoords;
+	if (numVertices == 0 || !GetShapeBoundsInGridSpace(bGridCol, hullVertsWs.data(), numVertices, minCoords, maxCoords))
+		return 0;
 
-	int numAdded = 0;
-	if (Abs(startDistance) < capsuleWs.radius || (bisected && startCloser))
-	{
-		out_contacts->normal = normal;
-		out_contacts->penetration = (planeWs.IsPointInFront(capsuleWs.start) ? (capsuleWs.radius - Abs(startDistance)) : (capsuleWs.radius + Abs(startDistance)));
-		out_contacts->position = capsuleWs.start - normal * capsuleWs.radius;
-		FillOutColliderInfo(out_contacts, bCapsuleCol, aPlaneCol);
-		out_contacts->CheckValuesAreReasonable();
-		numAdded++;
-		out_contacts++;
+	ManifoldPoint points[MAX_MANIFOLD_CANDIDATES];
+	int numPoints = 0;
 
-		if (limit == 1)
-			return 1;
-	}
+	AddVoxelVertexContacts(bGridCol, hullVertsWs.data(), numVertices, points, numPoints);
 
-	if (Abs(endDistance) < capsuleWs.radius || (bisected && !startCloser))
+	const Transform& gridTransform = bGridCol->m_entity->transform;
+	int numFaces = hullWs.GetNumFaces();
+
+	for (int y = minCoords.y; y <= maxCoords.y + 1; ++y)
 	{
-		out_contacts->normal = normal;
-		out_contacts->penetration = (planeWs.IsPointInFront(capsuleWs.end) ? (capsuleWs.radius - Abs(endDistance)) : (capsuleWs.radius + Abs(endDistance)));
-		out_contacts->position = capsuleWs.end - normal * capsuleWs.radius;
-		FillOutColliderInfo(out_contacts, bCapsuleCol, aPlaneCol);
-		out_contacts->CheckValuesAreReasonable();
-		numAdded++;
+		for (int z = minCoords.z; z <= maxCoords.z + 1; ++z)
+		{
+			for (int x = minCoords.x; x <= maxCoords.x + 1; ++x)
+			{
+				if (!IsVoxelCornerOnSurface(bGridCol, x, y, z))
+					continue;
+
+				Vector3 cornerWs = gridTransform.TransformPosition(Vector3((float)x, (float)y, (float)z) * bGridCol->GetCellSize());
+
+				// Inside if behind every face, push out through the nearest one
+				float bestDepth = FLT_MAX;
+				Vector3 bestFaceNormal = Vector3::ZERO;
+				for (int iFace = 0; iFace < numFaces && bestDepth > 0.f; ++iFace)
+				{
+					Plane3 facePlane = hullWs.GetFaceSupportPlane(iFace);
+					float depth = -1.0f * facePlane.GetDistanceFromPlane(cornerWs);
+
+					if (depth < bestDepth)
+					{
+						bestDepth = depth;
+						bestFaceNormal = facePlane.m_normal;
+					}
+				}
+
+				if (bestDepth <= 0.f)
+					continue;
+
+				ManifoldPoint point;
+				point.position = cornerWs;
+				point.normal = -1.0f * bestFaceNormal;
+				point.penetration = bestDepth;
+				AddManifoldCandidate(points, numPoints, MAX_MANIFOLD_CANDIDATES, point);
+			}
+		}
 	}
 
-	return numAdded;
+	return FinishGatheredContacts(a, bGridCol, points, numPoints, out_contacts, limit);
 }
 
 
 //-------------------------------------------------------------------------------------------------
-int CollisionDetector::GenerateContacts_PlaneBox(const Collider* a, const Collider* b, Contact* out_contacts, int limit)
+int CollisionDetector::GenerateContacts_SphereTriangleMesh(const Collider* a, const Collider* b, Contact* out_contacts, int limit)
 {
-	const PlaneCollider* aPlaneCol = a->GetAsType<PlaneCollider>();
-	const BoxCollider* bBoxCol = b->GetAsType<BoxCollider>();
-	ASSERT_OR_DIE(aPlaneCol != nullptr && bBoxCol != nullptr, "Colliders are of wrong type!");
+	const SphereCollider* aSphereCol = ColliderCast<SphereCollider>(a);
+	const TriangleMeshCollider* bMeshCol = ColliderCast<TriangleMeshCollider>(b);
+	ASSERT_OR_DIE(aSphereCol != nullptr && bMeshCol != nullptr, "Colliders are of wrong type!");
 
 	if (limit <= 0)
 		return 0;
 
-	Plane3 planeWs = aPlaneCol->GetDataInWorldSpace();
-	OBB3 boxWs = bBoxCol->GetDataInWorldSpace();
-
-	Vector3 boxVertsWs[8];
-	boxWs.GetPoints(boxVertsWs);
+	Sphere sphereWs = aSphereCol->GetDataInWorldSpace();
 
-	int numContactsAdded = 0;
-	Contact* contactToFill = out_contacts;
+	std::vector<int>& triangleIndices = s_narrowphaseScratch.m_triangleIndices;
+	GetMeshTrianglesNearPoints(bMeshCol, &sphereWs.m_center, 1, sphereWs.m_radius, triangleIndices);
+	int numTriangles = (int)triangleIndices.size();
 
-	std::vector<int> pointsBehind;
-	std::vector<int> pointsInFront;
-	float maxFrontDistance = 0.f;
-	float maxBehindDistance = 0.f;
+	ManifoldPoint points[MAX_MANIFOLD_CANDIDATES];
+	int numPoints = 0;
 
-	for (int i = 0; i < 8; ++i)
+	for (int i = 0; i < numTriangles; ++i)
 	{
-		float distance = planeWs.GetDistanceFromPlane(boxVertsWs[i]);
+		int triangleIndex = triangleIndices[i];
 
-		if (distance < 0.f)
+		ManifoldPoint point;
+		if (GetSphereTriangleContact(sphereWs.m_center, sphereWs.m_radius, bMeshCol->GetTriangleWs(triangleIndex), GetTriangleNormalWs(bMeshCol, triangleIndex), bMeshCol->GetTriangle(triangleIndex).m_activeEdgeFlags, point))
 		{
-			pointsBehind.push_back(i);
-			maxBehindDistance = Max(Abs(distance), maxBehindDistance);
-		}
-		else if (distance > 0.f)
-		{
-			pointsInFront.push_back(i);
-			maxFrontDistance = Max(Abs(distance), maxFrontDistance);
+			AddManifoldCandidate(points, numPoints, MAX_MANIFOLD_CANDIDATES, point);
 		}
 	}
 
-	// If all the points are on one side, there's no collision
-	if (pointsBehind.size() == 0 || pointsInFront.size() == 0)
-	{
-		return 0;
-	}
+	return FinishGatheredContacts(a, bMeshCol, points, numPoints, out_contacts, limit);
+}
 
-	std::vector<int>* penPoints;
-	float normalSign = 1.0f;
 
-	if (maxFrontDistance < maxBehindDistance)
-	{
-		penPoints = &pointsInFront;
-		normalSign *= -1.0f;
-	}
-	else
-	{
-		penPoints = &pointsBehind;
-	}
+//-------------------------------------------------------------------------------------------------
+// Treated as spheres at both ends plus one at the part of the segment closest to each triangle, so
+// capsules lying flat get a contact at each end
+int CollisionDetector::GenerateContacts_CapsuleTriangleMesh(const Collider* a, const Collider* b, Contact* out_contacts, int limit)
+{
+	const CapsuleCollider* aCapsuleCol = ColliderCast<CapsuleCollider>(a);
+	const TriangleMeshCollider* bMeshCol = ColliderCast<TriangleMeshCollider>(b);
+	ASSERT_OR_DIE(aCapsuleCol != nullptr && bMeshCol != nullptr, "Colliders are of wrong type!");
 
-	for (int pointIndex : *penPoints)
-	{
-		Vector3 point = boxVertsWs[pointIndex];
+	if (limit <= 0)
+		return 0;
 
-		contactToFill->position = point;
-		contactToFill->normal = normalSign * planeWs.m_normal;
-		contactToFill->penetration = Abs(planeWs.GetDistanceFromPlane(point));
-		FillOutColliderInfo(contactToFill, bBoxCol, aPlaneCol);
+	Capsule3 capsuleWs = aCapsuleCol->GetDataInWorldSpace();
+	Vector3 segmentPointsWs[2] = { capsuleWs.start, capsuleWs.end };
 
-		contactToFill->CheckValuesAreReasonable();
-		numContactsAdded++;
+	std::vector<int>& triangleIndices = s_narrowphaseScratch.m_triangleIndices;
+	GetMeshTrianglesNearPoints(bMeshCol, segmentPointsWs, 2, capsuleWs.radius, triangleIndices);
+	int numTriangles = (int)triangleIndices.size();
 
-		if (numContactsAdded < limit)
+	ManifoldPoint points[MAX_MANIFOLD_CANDIDATES];
+	int numPoints = 0;
+
+	for (int i = 0; i < numTriangles; ++i)
+	{
+		int triangleIndex = triangleIndices[i];
+		Triangle3 triangleWs = bMeshCol->GetTriangleWs(triangleIndex);
+		Vector3 normalWs = GetTriangleNormalWs(bMeshCol, triangleIndex);
+		uint8 activeEdgeFlags = bMeshCol->GetTriangle(triangleIndex).m_activeEdgeFlags;
+
+		// Alternate projecting between the segment and triangle to converge on the closest points
+		Vector3 closestOnSegmentWs = 0.5f * (capsuleWs.start + capsuleWs.end);
+		for (int iteration = 0; iteration < 4; ++iteration)
 		{
-			contactToFill = &out_contacts[numContactsAdded];
+			TriangleFeature feature;
+			Vector3 closestOnTriangleWs = GetClosestPointOnTriangle(closestOnSegmentWs, triangleWs, feature);
+			FindNearestPoint(closestOnTriangleWs, capsuleWs.start, capsuleWs.end, closestOnSegmentWs);
 		}
-		else
+
+		Vector3 sphereCentersWs[3] = { capsuleWs.start, capsuleWs.end, closestOnSegmentWs };
+		for (int iSphere = 0; iSphere < 3; ++iSphere)
 		{
-			break;
+			ManifoldPoint point;
+			if (GetSphereTriangleContact(sphereCentersWs[iSphere], capsuleWs.radius, triangleWs, normalWs, activeEdgeFlags, point))
+			{
+				AddManifoldCandidate(points, numPoints, MAX_MANIFOLD_CANDIDATES, point);
+			}
 		}
 	}
 
-	return numContactsAdded;
+	return FinishGatheredContacts(a, bMeshCol, points, numPoints, out_contacts, limit);
 }
 
 
 //-------------------------------------------------------------------------------------------------
-int CollisionDetector::GenerateContacts_PlaneCylinder(const Collider* a, const Collider* b, Contact* out_contacts, int limit)
+int CollisionDetector::GenerateContacts_BoxTriangleMesh(const Collider* a, const Collider* b, Contact* out_contacts, int limit)
 {
-	const PlaneCollider* aPlaneCol = a->GetAsType<PlaneCollider>();
-	const CylinderCollider* bCylinderCol = b->GetAsType<CylinderCollider>();
-	ASSERT_OR_DIE(aPlaneCol != nullptr && bCylinderCol != nullptr, "Colliders are of wrong type!");
+	const BoxCollider* aBoxCol = ColliderCast<BoxCollider>(a);
+	const TriangleMeshCollider* bMeshCol = ColliderCast<TriangleMeshCollider>(b);
+	ASSERT_OR_DIE(aBoxCol != nullptr && bMeshCol != nullptr, "Colliders are of wrong type!");
 
 	if (limit <= 0)
 		return 0;
 
-	const Plane3 planeWs = aPlaneCol->GetDataInWorldSpace();
-	const Cylinder cylinderWs = bCylinderCol->GetDataInWorldSpace();
+	Polyhedron& aHullWs = s_narrowphaseScratch.m_hullsWs[0];
+	aHullWs.SetFromBox(aBoxCol->GetDataInWorldSpace());
+	return GenerateContacts_HullTriangleMeshInternal(a, bMeshCol, aHullWs, out_contacts, limit);
+}
 
-	int numContactsAdded = 0;
-	Contact* contactToFill = out_contacts;
 
-	bool limitToTop = true;
-	Vector3 frontTopPointWs = cylinderWs.GetFurthestEdgePointInDirection(planeWs.m_normal, &limitToTop);
-	Vector3 backTopPointWs = cylinderWs.GetFurthestEdgePointInDirection(-1.0f * planeWs.m_normal, &limitToTop);
+//-------------------------------------------------------------------------------------------------
+int CollisionDetector::GenerateContacts_HullTriangleMesh(const Collider* a, const Collider* b, Contact* out_contacts, int limit)
+{
+	const ConvexHullCollider* aHullCol = ColliderCast<ConvexHullCollider>(a);
+	const TriangleMeshCollider* bMeshCol = ColliderCast<TriangleMeshCollider>(b);
+	ASSERT_OR_DIE(aHullCol != nullptr && bMeshCol != nullptr, "Colliders are of wrong type!");
 
-	limitToTop = false;
-	Vector3 frontBottomPointWs = cylinderWs.GetFurthestEdgePointInDirection(planeWs.m_normal, &limitToTop);
-	Vector3 backBottomPointWs = cylinderWs.GetFurthestEdgePointInDirection(-1.0f * planeWs.m_normal, &limitToTop);
+	if (limit <= 0)
+		return 0;
 
-	// If the points are on the same side of the plane, there's no intersection
-	float frontTopDist = planeWs.GetDistanceFromPlane(frontTopPointWs);
-	float backTopDist = planeWs.GetDistanceFromPlane(backTopPointWs);
-	float frontBottomDist = planeWs.GetDistanceFromPlane(frontBottomPointWs);
-	float backBottomDist = planeWs.GetDistanceFromPlane(backBottomPointWs);
+	Polyhedron& aHullWs = s_narrowphaseScratch.m_hullsWs[0];
+	aHullCol->GetDataInWorldSpace(aHullWs);
+	return GenerateContacts_HullTriangleMeshInternal(a, bMeshCol, aHullWs, out_contacts, limit);
+}
 
-	// Check top face intersecting
-	bool topIntersection = (frontTopDist * backTopDist < 0.f);
-	bool bottomIntersection = (frontBottomDist * backBottomDist < 0.f);
 
-	if (topIntersection && !bottomIntersection)
-	{
-		if (Abs(frontTopDist) < Abs(backTopDist))
-		{
-			// Push against the plane normal to correct
-			contactToFill->position = frontTopPointWs;
-			contactToFill->normal = -1.0f * planeWs.m_normal;
-			contactToFill->penetration = Abs(frontTopDist);
-		}
-		else
-		{
-			// Push towards the plane normal to correct
-			contactToFill->position = backTopPointWs;
-			contactToFill->normal = planeWs.m_normal;
-			contactToFill->penetration = Abs(backTopDist);
-		}
+//-------------------------------------------------------------------------------------------------
+// Expands the compound into the children near a and collides against each, so this works for any a - including another compound
+// Only reads the children, the scene refreshes their transforms before the narrowphase so this is safe to run from jobs
+int CollisionDetector::GenerateContacts_AnyCompound(const Collider* a, const Collider* b, Contact* out_contacts, int limit)
+{
+	const CompoundCollider* bCompoundCol = ColliderCast<CompoundCollider>(b);
+	ASSERT_OR_DIE(bCompoundCol != nullptr, "Colliders are of wrong type!");
 
-		FillOutColliderInfo(contactToFill, bCylinderCol, aPlaneCol);
+	if (limit <= 0)
+		return 0;
 
-		contactToFill->CheckValuesAreReasonable();
-		numContactsAdded++;
+	int childIndices[CompoundCollider::MAX_CHILDREN];
+	int numChildren = bCompoundCol->GetChildrenOverlapping(a, childIndices, CompoundCollider::MAX_CHILDREN);
+
+	int numContacts = 0;
+	for (int i = 0; i < numChildren && numContacts < limit; ++i)
+	{
+		numContacts += GenerateContacts(a, bCompoundCol->GetChild(childIndices[i]), out_contacts + numContacts, limit - numContacts);
 	}
-	else if (!topIntersection && bottomIntersection)
+
+	return numContacts;
+}
+
+
+//-------------------------------------------------------------------------------------------------
+int CollisionDetector::GetBatchIndex(const Collider* a, const Collider* b)
+{
+	int firstIndex = Min(a->GetTypeIndex(), b->GetTypeIndex());
+	int secondIndex = Max(a->GetTypeIndex(), b->GetTypeIndex());
+
+	for (int batchIndex = 0; batchIndex < NUM_BATCH_KERNELS; ++batchIndex)
 	{
-		if (Abs(frontBottomDist) < Abs(backBottomDist))
-		{
-			// Push against the plane normal to correct
-			contactToFill->position = frontBottomPointWs;
-			contactToFill->normal = -1.0f * planeWs.m_normal;
-			contactToFill->penetration = Abs(frontBottomDist);
-		}
-		else
+		if (s_batchKernels[batchIndex].m_firstTypeIndex == firstIndex && s_batchKernels[batchIndex].m_secondTypeIndex == secondIndex)
 		{
-			// Push towards the plane normal to correct
-			contactToFill->position = backBottomPointWs;
-			contactToFill->normal = planeWs.m_normal;
-			contactToFill->penetration = Abs(backBottomDist);
+			return batchIndex;
 		}
+	}
 
-		FillOutColliderInfo(contactToFill, bCylinderCol, aPlaneCol);
+	return -1;
+}
+
+
+//-------------------------------------------------------------------------------------------------
+int CollisionDetector::GenerateContactsBatch(int batchIndex, const Collider* const* aColliders, const Collider* const* bColliders, int numPairs, Contact* out_contacts, int limit)
+{
+	ASSERT_OR_DIE(batchIndex >= 0 && batchIndex < NUM_BATCH_KERNELS, "Invalid batch index!");
+
+	if (limit <= 0 || numPairs <= 0)
+		return 0;
+
+	return (this->*s_batchKernels[batchIndex].m_function)(aColliders, bColliders, numPairs, out_contacts, limit);
+}
+
+
+//-------------------------------------------------------------------------------------------------
+// Overlap test is done 4 pairs at a time, contacts are then built per lane exactly as GenerateContacts_SphereSphere does
+int CollisionDetector::GenerateContactsBatch_SphereSphere(const Collider* const* aColliders, const Collider* const* bColliders, int numPairs, Contact* out_contacts, int limit)
+{
+	int numContacts = 0;
 
-		contactToFill->CheckValuesAreReasonable();
-		numContactsAdded++;
-	}
-	else if (topIntersection && bottomIntersection)
+	for (int firstPairIndex = 0; firstPairIndex < numPairs && numContacts < limit; firstPairIndex += 4)
 	{
-		// Make sure we don't push the cylinder into a bad state
-		// This occurs if the top want to correct the opposite direction the bottom wants
+		int numLanes = Min(numPairs - firstPairIndex, 4);
 
-		// If both are wanting to go to the same side of the plane, no problem!
-		bool topWantsFront = Abs(backTopDist) < Abs(frontTopDist);
-		bool bottomWantsFront = Abs(backBottomDist) < Abs(frontBottomDist);
+		Sphere aSpheres[4];
+		Sphere bSpheres[4];
+		float aCenters[3][4] = {};
+		float bCenters[3][4] = {};
+		float aRadii[4] = {};
+		float bRadii[4] = {};
 
-		if (topWantsFront == bottomWantsFront)
+		for (int laneIndex = 0; laneIndex < numLanes; ++laneIndex)
 		{
-			Vector3 normal = (topWantsFront ? planeWs.m_normal : -1.0f * planeWs.m_normal);
+			aSpheres[laneIndex] = aColliders[firstPairIndex + laneIndex]->GetAsType<SphereCollider>()->GetDataInWorldSpace();
+			bSpheres[laneIndex] = bColliders[firstPairIndex + laneIndex]->GetAsType<SphereCollider>()->GetDataInWorldSpace();
 
-			if (topWantsFront)
+			for (int component = 0; component < 3; ++component)
 			{
-				contactToFill->position = backTopPointWs;
-				contactToFill->normal = normal;
-				contactToFill->penetration = Abs(backTopDist);
-				FillOutColliderInfo(contactToFill, bCylinderCol, aPlaneCol);
-				contactToFill->CheckValuesAreReasonable();
-				numContactsAdded++;
+				aCenters[component][laneIndex] = aSpheres[laneIndex].m_center.data[component];
+				bCenters[component][laneIndex] = bSpheres[laneIndex].m_center.data[component];
+			}
 
-				if (numContactsAdded < limit) { contactToFill = &out_contacts[numContactsAdded]; }
-				else
-				{
-					return numContactsAdded;
-				}
+			aRadii[laneIndex] = aSpheres[laneIndex].m_radius;
+			bRadii[laneIndex] = bSpheres[laneIndex].m_radius;
+		}
 
-				contactToFill->position = backBottomPointWs;
-				contactToFill->normal = normal;
-				contactToFill->penetration = Abs(backBottomDist);
-				FillOutColliderInfo(contactToFill, bCylinderCol, aPlaneCol);
-				contactToFill->CheckValuesAreReasonable();
-				numContactsAdded++;
-			}
-			else
-			{
-				contactToFill->position = frontTopPointWs;
-				contactToFill->normal = normal;
-				contactToFill->penetration = Abs(frontTopDist);
-				FillOutColliderInfo(contactToFill, bCylinderCol, aPlaneCol);
-				contactToFill->CheckValuesAreReasonable();
-				numContactsAdded++;
+		// Same operation order as the scalar path, so the overlap decision matches bit for bit
+		__m128 bToAX = _mm_sub_ps(_mm_loadu_ps(aCenters[0]), _mm_loadu_ps(bCenters[0]));
+		__m128 bToAY = _mm_sub_ps(_mm_loadu_ps(aCenters[1]), _mm_loadu_ps(bCenters[1]));
+		__m128 bToAZ = _mm_sub_ps(_mm_loadu_ps(aCenters[2]), _mm_loadu_ps(bCenters[2]));
+		__m128 distanceSquared = _mm_add_ps(_mm_add_ps(_mm_mul_ps(bToAX, bToAX), _mm_mul_ps(bToAY, bToAY)), _mm_mul_ps(bToAZ, bToAZ));
+		__m128 radiusSum = _mm_add_ps(_mm_loadu_ps(aRadii), _mm_loadu_ps(bRadii));
 
-				if (numContactsAdded < limit) { contactToFill = &out_contacts[numContactsAdded]; }
-				else
-				{
-					return numContactsAdded;
-				}
+		int laneMask = (1 << numLanes) - 1;
+		int hitMask = _mm_movemask_ps(_mm_cmplt_ps(distanceSquared, _mm_mul_ps(radiusSum, radiusSum))) & laneMask;
 
-				contactToFill->position = frontBottomPointWs;
-				contactToFill->normal = normal;
-				contactToFill->penetration = Abs(frontBottomDist);
-				FillOutColliderInfo(contactToFill, bCylinderCol, aPlaneCol);
-				contactToFill->CheckValuesAreReasonable();
-				numContactsAdded++;
-			}
-		}
-		else
+		if (hitMask == 0)
+			continue;
+
+		float bToAs[3][4];
+		_mm_storeu_ps(bToAs[0], bToAX);
+		_mm_storeu_ps(bToAs[1], bToAY);
+		_mm_storeu_ps(bToAs[2], bToAZ);
+
+		for (int laneIndex = 0; laneIndex < numLanes && numContacts < limit; ++laneIndex)
 		{
-			// Conflict - whoever has the min distance gets the say, and the other has to just go along with it
-			Vector3 topContactPos, bottomContactPos;
-			float topPen, bottomPen;
-			Vector3 normal;
+			if ((hitMask & (1 << laneIndex)) == 0)
+				continue;
 
-			float minDist = Min(frontBottomDist, backBottomDist, frontTopDist, backTopDist);
+			const Sphere& aSphere = aSpheres[laneIndex];
+			const Sphere& bSphere = bSpheres[laneIndex];
+			Vector3 bToA = Vector3(bToAs[0][laneIndex], bToAs[1][laneIndex], bToAs[2][laneIndex]);
+			float distance = bToA.Normalize();
 
-			if (minDist == frontBottomDist || minDist == frontTopDist)
-			{
-				// Push backwards
-				normal = -1.0f * planeWs.m_normal;
+			Contact* contact = &out_contacts[numContacts];
+			contact->position = bSphere.m_center + 0.5f * distance * bToA;
+			contact->normal = bToA;
+			contact->penetration = (aSphere.m_radius + bSphere.m_radius) - distance;
+			FillOutColliderInfo(contact, aColliders[firstPairIndex + laneIndex], bColliders[firstPairIndex + laneIndex]);
 
-				bottomContactPos = frontBottomPointWs;
-				bottomPen = Abs(frontBottomDist);
+			contact->CheckValuesAreReasonable();
+			numContacts++;
+		}
+	}
 
-				topContactPos = frontTopPointWs;
-				topPen = Abs(frontTopDist);
-			}
-			else
-			{
-				// Push forward
-				normal = planeWs.m_normal;
+	return numContacts;
+}
 
-				bottomContactPos = backBottomPointWs;
-				bottomPen = Abs(backBottomDist);
 
-				topContactPos = backTopPointWs;
-				topPen = Abs(backTopDist);
-			}
+//-------------------------------------------------------------------------------------------------
+// Box-space transform, early out, clamp and distance run 4 pairs at a time, contacts are then built per lane exactly as GenerateContacts_SphereBox does
+int CollisionDetector::GenerateContactsBatch_SphereBox(const Collider* const* aColliders, const Collider* const* bColliders, int numPairs, Contact* out_contacts, int limit)
+{
+	int numContacts = 0;
 
-			contactToFill->position = topContactPos;
-			contactToFill->normal = normal;
-			contactToFill->penetration = topPen;
-			FillOutColliderInfo(contactToFill, bCylinderCol, aPlaneCol);
-			contactToFill->CheckValuesAreReasonable();
-			numContactsAdded++;
+	for (int firstPairIndex = 0; firstPairIndex < numPairs && numContacts < limit; firstPairIndex += 4)
+	{
+		int numLanes = Min(numPairs - firstPairIndex, 4);
+		int laneMask = (1 << numLanes) - 1;
 
-			if (numContactsAdded < limit) { contactToFill = &out_contacts[numContactsAdded]; }
-			else
+		const Collider* sphereColliders[4];
+		const Collider* boxColliders[4];
+		Sphere spheres[4];
+		float sphereCenters[3][4] = {};
+		float sphereRadii[4] = {};
+
+		for (int laneIndex = 0; laneIndex < numLanes; ++laneIndex)
+		{
+			// The scene buckets each pair in whichever order the broadphase found it
+			const Collider* a = aColliders[firstPairIndex + laneIndex];
+			const Collider* b = bColliders[firstPairIndex + laneIndex];
+			bool isSphereFirst = (a->GetTypeIndex() == SphereCollider::TYPE_INDEX);
+
+			sphereColliders[laneIndex] = (isSphereFirst ? a : b);
+			boxColliders[laneIndex] = (isSphereFirst ? b : a);
+			spheres[laneIndex] = ColliderCast<SphereCollider>(sphereColliders[laneIndex])->GetDataInWorldSpace();
+
+			for (int component = 0; component < 3; ++component)
 			{
-				return numContactsAdded;
+				sphereCenters[component][laneIndex] = spheres[laneIndex].m_center.data[component];
 			}
 
-			contactToFill->position = bottomContactPos;
-			contactToFill->normal = normal;
-			contactToFill->penetration = bottomPen;
-			FillOutColliderInfo(contactToFill, bCylinderCol, aPlaneCol);
-			contactToFill->CheckValuesAreReasonable();
-			numContactsAdded++;
+			sphereRadii[laneIndex] = spheres[laneIndex].m_radius;
 		}
-	}
-	else
-	{
-		float maxDist = Max(frontBottomDist, backBottomDist, frontTopDist, backTopDist);
-		float minDist = Min(frontBottomDist, backBottomDist, frontTopDist, backTopDist);
 
-		if (minDist * maxDist < 0.f)
+		OBB3 boxes[4];
+		BoxLanes boxLanes;
+		GatherBoxLanes(boxColliders, numLanes, boxes, boxLanes);
+
+		__m128 sphereCenter[3];
+		__m128 boxToSphere[3];
+		for (int component = 0; component < 3; ++component)
 		{
-			// If the min pen is closer to the plane than max, it's shorter to push with the normal
-			bool pushInFrontOfPlane = Abs(minDist) < Abs(maxDist);
-			Vector3 normal = pushInFrontOfPlane ? planeWs.m_normal : -1.0f * planeWs.m_normal;
-			bool isTopFace = (pushInFrontOfPlane ? (minDist == backTopDist) : (maxDist == frontTopDist));
+			sphereCenter[component] = _mm_loadu_ps(sphereCenters[component]);
+			boxToSphere[component] = _mm_sub_ps(sphereCenter[component], boxLanes.center[component]);
+		}
 
-			// Shorter to push the cylinder in front of the plane
-			// Determine if the top or bottom of the cylinder is behind the plane
-			if (isTopFace)
-			{
-				contactToFill->position = backTopPointWs;
-				contactToFill->normal = normal;
-				contactToFill->penetration = Abs(backTopDist);
-				FillOutColliderInfo(contactToFill, bCylinderCol, aPlaneCol);
-				contactToFill->CheckValuesAreReasonable();
-				numContactsAdded++;
+		// Same operation order as the scalar path, so the early out and contact values match bit for bit
+		__m128 radius = _mm_loadu_ps(sphereRadii);
+		__m128 isSeparated = _mm_setzero_ps();
+		__m128 closestPointRel[3];
 
-				if (numContactsAdded < limit) { contactToFill = &out_contacts[numContactsAdded]; }
-				else
-				{
-					return numContactsAdded;
-				}
+		for (int axisIndex = 0; axisIndex < 3; ++axisIndex)
+		{
+			__m128 sphereCenterRel = DotProduct4(boxToSphere, boxLanes.axes[axisIndex]);
+			__m128 extent = boxLanes.extents[axisIndex];
 
-				// In case the cylinder spine is parallel to the plane normal, the two edge points would be the endpoint itself
-				if (!AreMostlyEqual(backTopPointWs, frontTopPointWs))
-				{
-					contactToFill->position = frontTopPointWs;
-					contactToFill->normal = normal;
-					contactToFill->penetration = Abs(frontTopDist);
-					FillOutColliderInfo(contactToFill, bCylinderCol, aPlaneCol);
-					contactToFill->CheckValuesAreReasonable();
-					numContactsAdded++;
-				}
-			}
-			else
-			{
-				contactToFill->position = backBottomPointWs;
-				contactToFill->normal = normal;
-				contactToFill->penetration = Abs(backBottomDist);
-				FillOutColliderInfo(contactToFill, bCylinderCol, aPlaneCol);
-				contactToFill->CheckValuesAreReasonable();
-				numContactsAdded++;
+			isSeparated = _mm_or_ps(isSeparated, _mm_cmpge_ps(_mm_sub_ps(Abs4(sphereCenterRel), radius), extent));
+			closestPointRel[axisIndex] = _mm_max_ps(_mm_min_ps(sphereCenterRel, extent), _mm_xor_ps(extent, _mm_set1_ps(-0.f)));
+		}
 
-				if (numContactsAdded < limit) { contactToFill = &out_contacts[numContactsAdded]; }
-				else
-				{
-					return numContactsAdded;
-				}
+		if ((_mm_movemask_ps(isSeparated) & laneMask) == laneMask)
+			continue;
 
-				// In case the cylinder spine is parallel to the plane normal, the two edge points would be the endpoint itself
-				if (!AreMostlyEqual(backBottomPointWs, frontBottomPointWs))
-				{
-					contactToFill->position = frontBottomPointWs;
-					contactToFill->normal = normal;
-					contactToFill->penetration = Abs(frontBottomDist);
-					FillOutColliderInfo(contactToFill, bCylinderCol, aPlaneCol);
-					contactToFill->CheckValuesAreReasonable();
-					numContactsAdded++;
-				}
-			}
+		float closestPointsWs[3][4];
+		float sphereToBoxes[3][4];
+		__m128 sphereToBox[3];
+
+		for (int component = 0; component < 3; ++component)
+		{
+			__m128 closestPointWs = _mm_add_ps(_mm_add_ps(_mm_add_ps(
+				_mm_mul_ps(boxLanes.axes[0][component], closestPointRel[0]),
+				_mm_mul_ps(boxLanes.axes[1][component], closestPointRel[1])),
+				_mm_mul_ps(boxLanes.axes[2][component], closestPointRel[2])),
+				boxLanes.center[component]);
+
+			sphereToBox[component] = _mm_sub_ps(closestPointWs, sphereCenter[component]);
+
+			_mm_storeu_ps(closestPointsWs[component], closestPointWs);
+			_mm_storeu_ps(sphereToBoxes[component], sphereToBox[component]);
+		}
+
+		// Skip grazing contacts, same as the AreMostlyEqual() check in the scalar path
+		__m128 distanceSquared = DotProduct4(sphereToBox, sphereToBox);
+		__m128 radiusSquared = _mm_mul_ps(radius, radius);
+		__m128 isGrazing = _mm_cmple_ps(Abs4(_mm_sub_ps(radiusSquared, distanceSquared)), _mm_set1_ps(DEFAULT_EPSILON));
+		int hitMask = ~_mm_movemask_ps(_mm_or_ps(isSeparated, isGrazing)) & laneMask;
+
+		for (int laneIndex = 0; laneIndex < numLanes && numContacts < limit; ++laneIndex)
+		{
+			if ((hitMask & (1 << laneIndex)) == 0)
+				continue;
+
+			Contact* contact = &out_contacts[numContacts];
+			contact->position = Vector3(closestPointsWs[0][laneIndex], closestPointsWs[1][laneIndex], closestPointsWs[2][laneIndex]);
+			contact->normal = Vector3(sphereToBoxes[0][laneIndex], sphereToBoxes[1][laneIndex], sphereToBoxes[2][laneIndex]);
+			float distance = contact->normal.SafeNormalize(Vector3::Y_AXIS);
+			contact->penetration = spheres[laneIndex].m_radius - distance;
+			FillOutColliderInfo(contact, boxColliders[laneIndex], sphereColliders[laneIndex]);
+
+			contact->CheckValuesAreReasonable();
+			numContacts++;
 		}
 	}
 
-	return numContactsAdded;
+	return numContacts;
 }
 
 
 //-------------------------------------------------------------------------------------------------
-int CollisionDetector::GenerateContacts_PlaneHull(const Collider* a, const Collider* b, Contact* out_contacts, int limit)
+// Runs the 15 SAT axes 4 pairs at a time, then builds contacts for the overlapping lanes from the batched SAT result
+// through the same CreateBoxBoxContacts() as GenerateContacts_BoxBox, so the output is identical to the scalar path
+int CollisionDetector::GenerateContactsBatch_BoxBox(const Collider* const* aColliders, const Collider* const* bColliders, int numPairs, Contact* out_contacts, int limit)
 {
-	const PlaneCollider* aPlaneCol = a->GetAsType<PlaneCollider>();
-	const ConvexHullCollider* bHullCol = b->GetAsType<ConvexHullCollider>();
-	ASSERT_OR_DIE(aPlaneCol != nullptr && bHullCol != nullptr, "Colliders are of wrong type!");
-
-	if (limit <= 0)
-		return 0;
+	int numContacts = 0;
 
-	Plane3 planeWs = aPlaneCol->GetDataInWorldSpace();
-	Polyhedron polyWs = bHullCol->GetDataInWorldSpace();
+	for (int firstPairIndex = 0; firstPairIndex < numPairs && numContacts < limit; firstPairIndex += 4)
+	{
+		int numLanes = Min(numPairs - firstPairIndex, 4);
+		int laneMask = (1 << numLanes) - 1;
+
+		OBB3 aBoxes[4];
+		OBB3 bBoxes[4];
+		BoxLanes aLanes;
+		BoxLanes bLanes;
+		GatherBoxLanes(aColliders + firstPairIndex, numLanes, aBoxes, aLanes);
+		GatherBoxLanes(bColliders + firstPairIndex, numLanes, bBoxes, bLanes);
+
+		__m128 aToB[3];
+		for (int component = 0; component < 3; ++component)
+		{
+			aToB[component] = _mm_sub_ps(bLanes.center[component], aLanes.center[component]);
+		}
 
-	// Keep track of which points are in front/behind the plane
-	std::vector<Vector3> frontPts;
-	std::vector<Vector3> backPts;
-	
-	// And distances for the sake of sorting
-	std::vector<float> frontDists;
-	std::vector<float> backDists;
+		__m128 isSeparated = _mm_setzero_ps();
+		__m128 smallestPen = _mm_set1_ps(FLT_MAX);
+		__m128 smallestIndex = _mm_setzero_ps();
 
-	// ...and the "worst" we've seen on each side
-	float maxFrontDist = -1.f;
-	float maxBackDist = -1.f;
+		// Same axis order as the scalar path, so ties pick the same axis
+		for (int axisIndex = 0; axisIndex < 3; ++axisIndex)
+		{
+			CheckAxisLanes(aLanes.axes[axisIndex], (float)axisIndex, aLanes, bLanes, aToB, isSeparated, smallestPen, smallestIndex);
+		}
 
-	int numVerts = polyWs.GetNumVertices();
-	for (int iVert = 0; iVert < numVerts; ++iVert)
-	{
-		Vector3 vert = polyWs.GetVertexPosition(iVert);
-		float dist = planeWs.GetDistanceFromPlane(vert);
+		for (int axisIndex = 0; axisIndex < 3; ++axisIndex)
+		{
+			CheckAxisLanes(bLanes.axes[axisIndex], (float)(axisIndex + 3), aLanes, bLanes, aToB, isSeparated, smallestPen, smallestIndex);
+		}
 
-		bool inFront = (dist >= 0.f);
+		// Face axes reject the most, so skip the edges when every lane is already apart
+		if ((_mm_movemask_ps(isSeparated) & laneMask) == laneMask)
+			continue;
 
-		dist = Abs(dist);
-		std::vector<Vector3>& points = (inFront ? frontPts : backPts);
-		std::vector<float>& distances = (inFront ? frontDists : backDists);
-		float& maxDist = (inFront ? maxFrontDist : maxBackDist);
-		maxDist = Max(maxDist, dist);
+		__m128 bestSingleAxis = smallestIndex;
 
-		// Insert the point in the right array, sorted by descending distance
-		int index = -1;
-		for (int i = 0; i < (int)distances.size(); ++i)
+		for (int aAxisIndex = 0; aAxisIndex < 3; ++aAxisIndex)
 		{
-			if (dist > distances[i])
+			for (int bAxisIndex = 0; bAxisIndex < 3; ++bAxisIndex)
 			{
-				index = i;
-				break;
+				__m128 edgeAxis[3];
+				CrossProduct4(aLanes.axes[aAxisIndex], bLanes.axes[bAxisIndex], edgeAxis);
+				CheckAxisLanes(edgeAxis, (float)(6 + 3 * aAxisIndex + bAxisIndex), aLanes, bLanes, aToB, isSeparated, smallestPen, smallestIndex);
 			}
 		}
 
-		if (index >= 0)
-		{
-			points.insert(points.begin() + index, vert);
-			distances.insert(distances.begin() + index, dist);
-		}
-		else
-		{
-			points.push_back(vert);
-			distances.push_back(dist);
-		}
-	}
+		int hitMask = ~_mm_movemask_ps(isSeparated) & laneMask;
+		if (hitMask == 0)
+			continue;
 
-	// If we're not intersecting the plane, don't do anything
-	if (frontPts.size() == 0 || backPts.size() == 0)
-		return 0;
+		float pens[4];
+		float bestIndices[4];
+		float bestSingleAxes[4];
+		_mm_storeu_ps(pens, smallestPen);
+		_mm_storeu_ps(bestIndices, smallestIndex);
+		_mm_storeu_ps(bestSingleAxes, bestSingleAxis);
 
-	// Choose to generate contacts on the side that's closer to the plane
-	bool pushBehindPlane = (maxFrontDist < maxBackDist);
-	const std::vector<Vector3>& positions = (pushBehindPlane ? frontPts : backPts);
-	const std::vector<float>& pens = (pushBehindPlane ? frontDists : backDists);
-	Vector3 normal = (pushBehindPlane ? -1.0f * planeWs.m_normal : planeWs.m_normal);
+		for (int laneIndex = 0; laneIndex < numLanes && numContacts < limit; ++laneIndex)
+		{
+			if ((hitMask & (1 << laneIndex)) == 0)
+				continue;
 
-	int numContacts = Min((int)positions.size(), limit);
-	for (int iContact = 0; iContact < numContacts; ++iContact)
-	{
-		out_contacts[iContact].position = positions[iContact];
-		out_contacts[iContact].normal = normal;
-		out_contacts[iContact].penetration = pens[iContact];
-		FillOutColliderInfo(&out_contacts[iContact], bHullCol, aPlaneCol);
-		out_contacts[iContact].CheckValuesAreReasonable();
+			const BoxCollider* aBoxCol = ColliderCast<BoxCollider>(aColliders[firstPairIndex + laneIndex]);
+			const BoxCollider* bBoxCol = ColliderCast<BoxCollider>(bColliders[firstPairIndex + laneIndex]);
+			const OBB3& aBox = aBoxes[laneIndex];
+			const OBB3& bBox = bBoxes[laneIndex];
+			Vector3 aToBLane = bBox.center - aBox.center;
+
+			numContacts += CreateBoxBoxContacts(aBoxCol, bBoxCol, aBox, bBox, Matrix3(aBox.rotation), Matrix3(bBox.rotation), aToBLane,
+				(unsigned)bestIndices[laneIndex], pens[laneIndex], (unsigned)bestSingleAxes[laneIndex], out_contacts + numContacts, limit - numContacts);
+		}
 	}
 
 	return numContacts;
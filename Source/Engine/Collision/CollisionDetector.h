@@ -12,7 +12,7 @@
 ///--------------------------------------------------------------------------------------------------------------------------------------------------
 /// DEFINES
 ///--------------------------------------------------------------------------------------------------------------------------------------------------
-#define NUM_COLLIDER_TYPES (7)
+#define NUM_COLLIDER_TYPES (10)
 
 ///--------------------------------------------------------------------------------------------------------------------------------------------------
 /// ENUMS, TYPEDEFS, STRUCTS, FORWARD DECLARATIONS
@@ -21,6 +21,15 @@ class Collider;
 class Contact;
 class CollisionDetector;
 typedef int(CollisionDetector::*GenerateContactsFunction)(const Collider* a, const Collider* b, Contact* out_contacts, int limit);
+typedef int(CollisionDetector::*GenerateContactsBatchFunction)(const Collider* const* aColliders, const Collider* const* bColliders, int numPairs, Contact* out_contacts, int limit);
+
+// Kernel that runs a whole bucket of pairs of one type pair at once
+struct GenerateContactsBatchKernel
+{
+	int								m_firstTypeIndex;
+	int								m_secondTypeIndex;
+	GenerateContactsBatchFunction	m_function;
+};
 
 
 class CapsuleCollider;
@@ -44,6 +53,16 @@ public:
 	//-----Public Methods-----
 
 	int GenerateContacts(const Collider* a, const Collider* b, Contact* out_contacts, int limit);
+	bool AreOverlapping(const Collider* a, const Collider* b) const; // Boolean test only, no manifold - for triggers
+	int GenerateContactsBatch(int batchIndex, const Collider* const* aColliders, const Collider* const* bColliders, int numPairs, Contact* out_contacts, int limit); // Pairs must all be the type pair for batchIndex
+
+	static int GetBatchIndex(const Collider* a, const Collider* b); // -1 if the pair has no batched kernel, so should go through GenerateContacts
+
+
+public:
+	//-----Public Data-----
+
+	static constexpr int NUM_BATCH_KERNELS = 3;
 
 
 private:
@@ -69,27 +88,48 @@ private:
 	int GenerateContacts_SphereBox(const Collider* a, const Collider* b, Contact* out_contacts, int limit);
 	int GenerateContacts_SphereCylinder(const Collider* a, const Collider* b, Contact* out_contacts, int limit);
 	int GenerateContacts_SphereHull(const Collider* a, const Collider* b, Contact* out_contacts, int limit);
+	int GenerateContacts_SphereVoxelGrid(const Collider* a, const Collider* b, Contact* out_contacts, int limit);
+	int GenerateContacts_SphereTriangleMesh(const Collider* a, const Collider* b, Contact* out_contacts, int limit);
 
 	// [3][X]
 	int GenerateContacts_CapsuleCapsule(const Collider* a, const Collider* b, Contact* out_contacts, int limit);
 	int GenerateContacts_CapsuleBox(const Collider* a, const Collider* b, Contact* out_contacts, int limit);
 	int GenerateContacts_CapsuleCylinder(const Collider* a, const Collider* b, Contact* out_contacts, int limit);
 	int GenerateContacts_CapsuleHull(const Collider* a, const Collider* b, Contact* out_contacts, int limit);
+	int GenerateContacts_CapsuleVoxelGrid(const Collider* a, const Collider* b, Contact* out_contacts, int limit);
+	int GenerateContacts_CapsuleTriangleMesh(const Collider* a, const Collider* b, Contact* out_contacts, int limit);
 
 	// [4][X]
 	int GenerateContacts_BoxBox(const Collider* a, const Collider* b, Contact* out_contacts, int limit);
 	int GenerateContacts_BoxHull(const Collider* a, const Collider* b, Contact* out_contacts, int limit);
+	int GenerateContacts_BoxVoxelGrid(const Collider* a, const Collider* b, Contact* out_contacts, int limit);
+	int GenerateContacts_BoxTriangleMesh(const Collider* a, const Collider* b, Contact* out_contacts, int limit);
 
 	// [5][X]
 
 	// [6][X]
 	int GenerateContacts_HullHull(const Collider* a, const Collider* b, Contact* out_contacts, int limit);
+	int GenerateContacts_HullVoxelGrid(const Collider* a, const Collider* b, Contact* out_contacts, int limit);
+	int GenerateContacts_HullTriangleMesh(const Collider* a, const Collider* b, Contact* out_contacts, int limit);
+
+	// [7][X]
+
+	// [8][X]
+
+	// [X][9]
+	int GenerateContacts_AnyCompound(const Collider* a, const Collider* b, Contact* out_contacts, int limit);
+
+	// Batched, same output as the functions above
+	int GenerateContactsBatch_SphereSphere(const Collider* const* aColliders, const Collider* const* bColliders, int numPairs, Contact* out_contacts, int limit);
+	int GenerateContactsBatch_SphereBox(const Collider* const* aColliders, const Collider* const* bColliders, int numPairs, Contact* out_contacts, int limit);
+	int GenerateContactsBatch_BoxBox(const Collider* const* aColliders, const Collider* const* bColliders, int numPairs, Contact* out_contacts, int limit);
 
 
 private:
 	//-----Private Data-----
 
 	static GenerateContactsFunction s_colliderMatrix[NUM_COLLIDER_TYPES][NUM_COLLIDER_TYPES];
+	static const GenerateContactsBatchKernel s_batchKernels[NUM_BATCH_KERNELS];
 
 };
 
@@ -8,15 +8,22 @@
 ///--------------------------------------------------------------------------------------------------------------------------------------------------
 /// INCLUDES
 ///--------------------------------------------------------------------------------------------------------------------------------------------------
+#include <algorithm>
 #include <vector>
 #include "Engine/Collision/BoundingVolumeHierarchy/BVHNode.h"
+#include "Engine/Collision/BoundingVolumeHierarchy/QBVH.h"
 #include "Engine/Collision/CollisionDetector.h"
 #include "Engine/Collision/Contact.h"
 #include "Engine/Collision/ContactResolver.h"
 #include "Engine/Core/DevConsole.h"
 #include "Engine/Core/Entity.h"
+#include "Engine/Event/EventSystem.h"
+#include "Engine/Job/JobSystem.h"
 #include "Engine/Math/MathUtils.h"
+#include "Engine/Physics/RigidBody/RigidBody.h"
 #include "Engine/Render/Debug/DebugRenderSystem.h"
+#include "Engine/Time/Time.h"
+#include "Engine/Utility/EngineUtils.h"
 
 ///--------------------------------------------------------------------------------------------------------------------------------------------------
 /// DEFINES
@@ -35,6 +42,57 @@ enum CollisionDebugBit : uint32
 
 typedef uint32 CollisionDebugFlags;
 
+enum TriggerEventType
+{
+	TRIGGER_EVENT_ENTER,
+	TRIGGER_EVENT_STAY,
+	TRIGGER_EVENT_EXIT
+};
+
+struct TriggerPair
+{
+	const Collider* trigger = nullptr;
+	const Collider* other = nullptr;
+
+	bool operator<(const TriggerPair& other_pair) const		{ return (trigger != other_pair.trigger ? trigger < other_pair.trigger : other < other_pair.other); }
+	bool operator==(const TriggerPair& other_pair) const	{ return (trigger == other_pair.trigger && other == other_pair.other); }
+};
+
+struct TriggerEvent
+{
+	const Collider*		trigger = nullptr;
+	const Collider*		other = nullptr;
+	TriggerEventType	type = TRIGGER_EVENT_ENTER;
+};
+
+// Everything the scene carries from one step to the next, so restoring it and stepping again plays out exactly the same
+// Pair order depends on the tree shape, so the dynamic tree is stored node for node rather than rebuilt
+// Entities are referred to by the order they were added to the scene rather than by pointer, so a snapshot can be
+// written out as bytes and restored into any scene that had the same entities added in the same order
+template <class BoundingVolumeClass>
+struct CollisionSceneSnapshot
+{
+	void WriteToBytes(std::vector<uint8>& out_bytes) const; // Appends, raw copies of the arrays so only readable by the same build
+	bool ReadFromBytes(const uint8* bytes, size_t numBytes, size_t& inout_offset);
+
+	int									m_numEntities = 0; // Only used to check the snapshot still matches the scene
+	std::vector<int>					m_leafEntityIndices; // Dynamic leaves in the scene's current order, which builds and rebuilds shuffle
+	std::vector<BoundingVolumeClass>	m_leafVolumes;
+	std::vector<int>					m_treeLayout; // Pre-order, entity index for leaves and -1 for internal nodes
+	std::vector<BoundingVolumeClass>	m_internalVolumes; // Pre-order, internal nodes only
+	std::vector<int>					m_triggerPairs; // Entity indices, trigger then other for each pair
+	float								m_bvhBaselineCost = -1.f;
+	int									m_stepsSinceQualityCheck = 0;
+};
+
+// Wall time spent in each collision phase, summed over every step since the last reset
+struct CollisionStepTimings
+{
+	double m_broadphaseSeconds = 0.0; // Tree update and pair finding
+	double m_narrowphaseSeconds = 0.0; // Contact generation
+	double m_solveSeconds = 0.0; // Contact resolution, every substep included
+};
+
 ///--------------------------------------------------------------------------------------------------------------------------------------------------
 /// GLOBALS AND STATICS
 ///--------------------------------------------------------------------------------------------------------------------------------------------------
@@ -54,19 +112,54 @@ public:
 	~CollisionScene<BoundingVolumeClass>();
 
 	void AddEntity(Entity* entity);
+	void AddEntities(const std::vector<Entity*>& entities); // Builds the trees once for all entities, for level loads
 	void RemoveEntity(Entity* entity);
+	void RemoveAllEntities();
 
 	void DoCollisionStep(float deltaSeconds);
+	void DetectContacts(); // DoCollisionStep() in parts, for a PhysicsScene that substeps: detect, then substep, then finish
+	void ResolveContactsSubstep(float substepSeconds, bool isFirstSubstep);
+	void FinishCollisionStep();
 	void SetDebugFlags(CollisionDebugFlags flags);
 
+	void SetLayersCanCollide(uint32 layerA, uint32 layerB, bool canCollide);
+	bool CanLayersCollide(uint32 layerA, uint32 layerB) const;
+
+	const std::vector<TriggerEvent>& GetTriggerEvents() const { return m_triggerEvents; }
+
+	void RebuildBVH();
+	void RebuildStaticBVH(); // Call if static entities were moved, as the static tree is never refit
+	void SetBVHRotationBudget(int rotationsPerStep) { m_bvhRotationBudget = rotationsPerStep; }
+	void SetBVHRebuildCostRatio(float costRatio) { m_bvhRebuildCostRatio = costRatio; }
+	void SetContactSolverMode(ContactSolverMode mode) { m_resolver.SetSolverMode(mode); }
+	ContactSolverMode GetContactSolverMode() const { return m_resolver.GetSolverMode(); }
+	void SetCollisionLimits(int maxPotentialCollisions, int maxContacts); // Per step caps, anything past them is dropped with a warning
+	int GetNumPotentialCollisions() const { return m_numPotentialCollisions; } // From the last step
+	int GetNumContacts() const { return m_numNewContacts; } // From the last step
+	const CollisionStepTimings& GetStepTimings() const { return m_stepTimings; }
+	void ResetStepTimings() { m_stepTimings = CollisionStepTimings(); }
+	float GetBVHCost() const;
+	int FindAllPotentialCollisions(PotentialCollision* out_collisions, int limit) const; // Full broadphase without the per-step limit, for profiling
+	int GetRaycastCandidates(const Vector3& start, const Vector3& direction, float maxDistance, const Collider** out_colliders, int limit) const; // Colliders whose bounds the ray hits, in no particular order
+	int GetOverlapCandidates(const BoundingVolumeClass& volume, const Collider** out_colliders, int limit) const; // Colliders whose bounds overlap the volume, planes and half spaces included
+	void BuildQBVH(QBVH& out_qbvh) const { out_qbvh.Build(m_boundingTreeRoot); } // Snapshot of the dynamic tree for read-only queries
+
+	void SaveSnapshot(CollisionSceneSnapshot<BoundingVolumeClass>& out_snapshot) const;
+	bool RestoreSnapshot(const CollisionSceneSnapshot<BoundingVolumeClass>& snapshot); // Returns false if entities were added or removed since the save
+
 
 private:
 	//-----Private Methods-----
 
 	void UpdateBVH();
+	void ReclassifyEntities();
+	void RefitQueuedNodes();
+	void CheckBVHQuality();
 	void PerformBroadphase();
+	int GetPotentialCollisionsWithStatic(PotentialCollision* out_collisions, int limit) const;
 	void GenerateContacts();
 	void ResolveContacts(float deltaSeconds);
+	void UpdateTriggerEvents();
 
 	void ShowDebugColliders();
 	void HideDebugColliders();
@@ -75,44 +168,135 @@ private:
 	void DebugDrawContacts() const;
 
 	void UpdateNode(BVHNode<BoundingVolumeClass>* node, const BoundingVolumeClass& newVolume);
-	BVHNode<BoundingVolumeClass>* GetAndEraseLeafNodeForEntity(Entity* entity);
+	void QueueAncestorsForRefit(BVHNode<BoundingVolumeClass>* leaf);
+	bool IsSmallMotion(const BoundingVolumeClass& oldVolume, const BoundingVolumeClass& newVolume) const;
+	BVHNode<BoundingVolumeClass>* BuildBVH(BVHNode<BoundingVolumeClass>** leaves, int numLeaves);
+	BVHNode<BoundingVolumeClass>* BuildBVHSubtree(BVHNode<BoundingVolumeClass>** leaves, int numLeaves) const;
+	int PartitionLeavesSAH(BVHNode<BoundingVolumeClass>** leaves, int numLeaves) const;
+	BVHNode<BoundingVolumeClass>* MakeLeafNodeForEntity(Entity* entity) const;
+	void DeleteInternalNodes(BVHNode<BoundingVolumeClass>* node);
+	void InsertDynamicLeaf(BVHNode<BoundingVolumeClass>* node);
+	void UnlinkDynamicLeaf(BVHNode<BoundingVolumeClass>* node);
+	void DeleteStaticTree();
+	BVHNode<BoundingVolumeClass>* GetAndEraseLeafNodeForEntity(Entity* entity, std::vector<BVHNode<BoundingVolumeClass>*>& leaves);
+	bool IsEntityStatic(const Entity* entity) const;
 	BoundingVolumeClass MakeBoundingVolumeForCollider(const Collider* primitive) const;
+	CollisionFilter MakeCollisionFilterForCollider(const Collider* collider) const;
+	void BuildEntityIndexLookup() const;
+	int LookupEntityIndex(const Entity* entity) const;
+	void AppendNodeToSnapshot(const BVHNode<BoundingVolumeClass>* node, CollisionSceneSnapshot<BoundingVolumeClass>& out_snapshot) const;
+	BVHNode<BoundingVolumeClass>* RestoreNodeFromSnapshot(const CollisionSceneSnapshot<BoundingVolumeClass>& snapshot, int& layoutIndex, int& internalIndex);
 
 
 private:
 	//-----Private Static Data
 
-	static constexpr int MAX_POTENTIAL_COLLISION_COUNT = 50;
-	static constexpr int MAX_CONTACT_COUNT = 100;
+	static constexpr int DEFAULT_MAX_POTENTIAL_COLLISIONS = 50;
+	static constexpr int DEFAULT_MAX_CONTACTS = 100;
+	static constexpr int BVH_QUALITY_CHECK_INTERVAL = 60; // In steps
+	static constexpr int BVH_BUILD_NUM_BINS = 16;
+	static constexpr int BVH_BUILD_MIN_LEAVES_PER_JOB = 512; // Smaller builds aren't worth splitting across threads
 
 
 private:
 	//-----Private Data-----
 
-	BVHNode<BoundingVolumeClass>*				m_boundingTreeRoot = nullptr;
+	std::vector<Entity*>						m_entities; // Every entity in the order it was added, snapshots refer to entities by their index in here
+
+	BVHNode<BoundingVolumeClass>*				m_boundingTreeRoot = nullptr; // Dynamic entities only
 	std::vector<BVHNode<BoundingVolumeClass>*>	m_leaves;  // Optimization, faster search
 
+	// Static entities are kept out of the dynamic tree, as they never need to be updated or tested against each other
+	BVHNode<BoundingVolumeClass>*				m_staticTreeRoot = nullptr;
+	std::vector<BVHNode<BoundingVolumeClass>*>	m_staticLeaves;
+	bool										m_isStaticTreeDirty = false; // Set when ReclassifyEntities() moves leaves, rebuilt right after
+	uint32										m_lastStaticChangeCount = 0; // RigidBody::GetStaticChangeCount() at the last reclassify
+	QBVH										m_staticQBVH; // Static tree collapsed to 4-wide nodes, this is what actually gets queried
+
+	// Tree maintenance
+	struct RefitEntry { BVHNode<BoundingVolumeClass>* node; int depth; };
+	std::vector<BVHNode<BoundingVolumeClass>*>	m_leavesToRefit;
+	std::vector<RefitEntry>						m_nodesToRefit;
+	float										m_bvhRefitMotionFraction = 0.5f; // Leaves moving less than this fraction of their size get refit in place instead of reinserted
+	int											m_bvhRotationBudget = 16; // Max tree rotations per step
+	float										m_bvhRebuildCostRatio = 1.5f; // Rebuild once the tree cost grows past this ratio of the cost after the last rebuild
+	float										m_bvhBaselineCost = -1.f; // Negative when there's no rebuild to compare against
+	int											m_stepsSinceQualityCheck = 0;
+
 	std::vector<HalfSpaceCollider*>				m_halfSpaces;
 	std::vector<PlaneCollider*>					m_planes;
 
-	PotentialCollision							m_potentialCollisions[MAX_POTENTIAL_COLLISION_COUNT];
+	std::vector<PotentialCollision>				m_potentialCollisions; // Sized to m_maxPotentialCollisions
 	int											m_numPotentialCollisions = 0;
+	int											m_maxPotentialCollisions = DEFAULT_MAX_POTENTIAL_COLLISIONS;
 
 	int											m_numNewContacts = 0;
-	Contact*									m_newContacts = nullptr;
+	std::vector<Contact>						m_newContacts; // Sized to m_maxContacts
+	int											m_maxContacts = DEFAULT_MAX_CONTACTS;
+
+	std::vector<TriggerPair>					m_currTriggerPairs;
+	std::vector<TriggerPair>					m_prevTriggerPairs;
+	std::vector<TriggerEvent>					m_triggerEvents; // Events from the last step, also sent out batched in a single "collision-trigger-events" event
+
+	uint32										m_layerMatrix[MAX_COLLISION_LAYERS]; // One row per layer, one bit per layer it can collide with
 
 	CollisionDetector							m_detector;
+	std::vector<const Collider*>				m_batchedColliders[CollisionDetector::NUM_BATCH_KERNELS][2]; // Pairs bucketed by type pair in GenerateContacts, sized to m_maxPotentialCollisions
+	int											m_numBatchedPairs[CollisionDetector::NUM_BATCH_KERNELS] = {};
+	std::vector<const Collider*>				m_unbatchedColliders[2]; // Pairs without a kernel, run through the collider matrix grouped by type pair, sized to m_maxPotentialCollisions
+	std::vector<int>							m_unbatchedTypePairs; // Matrix entry of each unbatched pair, lower type index first
+	std::vector<int>							m_unbatchedOrder; // Unbatched pair indices sorted by type pair
 
 	int											m_defaultNumVelocityIterations = 20;
 	int											m_defaultNumPenetrationIterations = 20;
 	ContactResolver								m_resolver;
 
+	CollisionStepTimings						m_stepTimings;
+
+	// Snapshots, kept around so saving and restoring every step doesn't allocate once warmed up
+	mutable std::vector<std::pair<const Entity*, int>>	m_entityIndexLookup; // Sorted by entity
+	std::vector<BVHNode<BoundingVolumeClass>*>			m_leavesByEntityIndex;
+	std::vector<uint8>									m_snapshotSeenEntities; // For checking a snapshot's entity indices are unique
+
 	// Debug
 	CollisionDebugFlags							m_debugFlags = 0;
 
 };
 
 
+//-------------------------------------------------------------------------------------------------
+template <class BoundingVolumeClass>
+void CollisionSceneSnapshot<BoundingVolumeClass>::WriteToBytes(std::vector<uint8>& out_bytes) const
+{
+	AppendBytes(out_bytes, m_numEntities);
+	AppendVectorBytes(out_bytes, m_leafEntityIndices);
+	AppendVectorBytes(out_bytes, m_leafVolumes);
+	AppendVectorBytes(out_bytes, m_treeLayout);
+	AppendVectorBytes(out_bytes, m_internalVolumes);
+	AppendVectorBytes(out_bytes, m_triggerPairs);
+	AppendBytes(out_bytes, m_bvhBaselineCost);
+	AppendBytes(out_bytes, m_stepsSinceQualityCheck);
+}
+
+
+//-------------------------------------------------------------------------------------------------
+// Returns false if the bytes ran out partway, RestoreSnapshot() checks the contents against the scene
+template <class BoundingVolumeClass>
+bool CollisionSceneSnapshot<BoundingVolumeClass>::ReadFromBytes(const uint8* bytes, size_t numBytes, size_t& inout_offset)
+{
+	bool success = ReadBytes(bytes, numBytes, inout_offset, m_numEntities);
+	success = success && ReadVectorBytes(bytes, numBytes, inout_offset, m_leafEntityIndices);
+	success = success && ReadVectorBytes(bytes, numBytes, inout_offset, m_leafVolumes);
+	success = success && ReadVectorBytes(bytes, numBytes, inout_offset, m_treeLayout);
+	success = success && ReadVectorBytes(bytes, numBytes, inout_offset, m_internalVolumes);
+	success = success && ReadVectorBytes(bytes, numBytes, inout_offset, m_triggerPairs);
+	success = success && ReadBytes(bytes, numBytes, inout_offset, m_bvhBaselineCost);
+	success = success && ReadBytes(bytes, numBytes, inout_offset, m_stepsSinceQualityCheck);
+
+	return success && (m_leafEntityIndices.size() == m_leafVolumes.size());
+}
+
+
 //-------------------------------------------------------------------------------------------------
 template <class BoundingVolumeClass>
 void CollisionScene<BoundingVolumeClass>::SetDebugFlags(CollisionDebugFlags flags)
@@ -130,6 +314,33 @@ void CollisionScene<BoundingVolumeClass>::SetDebugFlags(CollisionDebugFlags flag
 }
 
 
+//-------------------------------------------------------------------------------------------------
+template <class BoundingVolumeClass>
+void CollisionScene<BoundingVolumeClass>::SetCollisionLimits(int maxPotentialCollisions, int maxContacts)
+{
+	ASSERT_OR_DIE(maxPotentialCollisions > 0 && maxContacts > 0, "Collision limits must be positive!");
+
+	m_maxPotentialCollisions = maxPotentialCollisions;
+	m_maxContacts = maxContacts;
+
+	m_potentialCollisions.resize(m_maxPotentialCollisions);
+	m_newContacts.resize(m_maxContacts);
+	m_numPotentialCollisions = Min(m_numPotentialCollisions, m_maxPotentialCollisions);
+	m_numNewContacts = Min(m_numNewContacts, m_maxContacts);
+
+	for (int batchIndex = 0; batchIndex < CollisionDetector::NUM_BATCH_KERNELS; ++batchIndex)
+	{
+		m_batchedColliders[batchIndex][0].resize(m_maxPotentialCollisions);
+		m_batchedColliders[batchIndex][1].resize(m_maxPotentialCollisions);
+	}
+
+	m_unbatchedColliders[0].resize(m_maxPotentialCollisions);
+	m_unbatchedColliders[1].resize(m_maxPotentialCollisions);
+	m_unbatchedTypePairs.resize(m_maxPotentialCollisions);
+	m_unbatchedOrder.resize(m_maxPotentialCollisions);
+}
+
+
 //-------------------------------------------------------------------------------------------------
 template <class BoundingVolumeClass>
 void CollisionScene<BoundingVolumeClass>::HideDebugColliders()
@@ -139,6 +350,11 @@ void CollisionScene<BoundingVolumeClass>::HideDebugColliders()
 		leaf->m_entity->collider->HideDebug();
 	}
 
+	for (BVHNode<BoundingVolumeClass>* leaf : m_staticLeaves)
+	{
+		leaf->m_entity->collider->HideDebug();
+	}
+
 	for (HalfSpaceCollider* halfSpace : m_halfSpaces)
 	{
 		halfSpace->HideDebug();
@@ -160,6 +376,11 @@ void CollisionScene<BoundingVolumeClass>::ShowDebugColliders()
 		leaf->m_entity->collider->ShowDebug();
 	}
 
+	for (BVHNode<BoundingVolumeClass>* leaf : m_staticLeaves)
+	{
+		leaf->m_entity->collider->ShowDebug();
+	}
+
 	for (HalfSpaceCollider* halfSpace : m_halfSpaces)
 	{
 		halfSpace->ShowDebug();
@@ -175,11 +396,12 @@ void CollisionScene<BoundingVolumeClass>::ShowDebugColliders()
 template <class BoundingVolumeClass>
 CollisionScene<BoundingVolumeClass>::CollisionScene()
 {
-	m_newContacts = (Contact*)malloc(sizeof(Contact) * MAX_CONTACT_COUNT);
+	SetCollisionLimits(DEFAULT_MAX_POTENTIAL_COLLISIONS, DEFAULT_MAX_CONTACTS);
 
-	for (int i = 0; i < MAX_CONTACT_COUNT; ++i)
+	// All layers collide with each other by default
+	for (int i = 0; i < MAX_COLLISION_LAYERS; ++i)
 	{
-		m_newContacts[i] = Contact();
+		m_layerMatrix[i] = COLLISION_LAYER_MASK_ALL;
 	}
 }
 
@@ -215,34 +437,52 @@ BoundingVolumeClass CollisionScene<BoundingVolumeClass>::MakeBoundingVolumeForCo
 	{
 	case SphereCollider::TYPE_INDEX:
 	{
-		const SphereCollider* sphereCol = collider->GetAsType<SphereCollider>();
+		const SphereCollider* sphereCol = ColliderCast<SphereCollider>(collider);
 		return BoundingVolumeClass(*sphereCol);
 	}
 		break;
 	case CapsuleCollider::TYPE_INDEX:
 	{
-		const CapsuleCollider* capsuleCol = collider->GetAsType<CapsuleCollider>();
+		const CapsuleCollider* capsuleCol = ColliderCast<CapsuleCollider>(collider);
 		return BoundingVolumeClass(*capsuleCol);
 	}
 		break;
 	case BoxCollider::TYPE_INDEX:
 	{
-		const BoxCollider* boxCol = collider->GetAsType<BoxCollider>();
+		const BoxCollider* boxCol = ColliderCast<BoxCollider>(collider);
 		return BoundingVolumeClass(*boxCol);
 	}
 		break;
 	case CylinderCollider::TYPE_INDEX:
 	{
-		const CylinderCollider* cylinderCol = collider->GetAsType<CylinderCollider>();
+		const CylinderCollider* cylinderCol = ColliderCast<CylinderCollider>(collider);
 		return BoundingVolumeClass(*cylinderCol);
 	}
 		break;
 	case ConvexHullCollider::TYPE_INDEX:
 	{
-		const ConvexHullCollider* polyCol = collider->GetAsType<ConvexHullCollider>();
+		const ConvexHullCollider* polyCol = ColliderCast<ConvexHullCollider>(collider);
 		return BoundingVolumeClass(*polyCol);
 	}
 		break;
+	case VoxelGridCollider::TYPE_INDEX:
+	{
+		const VoxelGridCollider* voxelCol = ColliderCast<VoxelGridCollider>(collider);
+		return BoundingVolumeClass(*voxelCol);
+	}
+		break;
+	case TriangleMeshCollider::TYPE_INDEX:
+	{
+		const TriangleMeshCollider* meshCol = ColliderCast<TriangleMeshCollider>(collider);
+		return BoundingVolumeClass(*meshCol);
+	}
+		break;
+	case CompoundCollider::TYPE_INDEX:
+	{
+		const CompoundCollider* compoundCol = ColliderCast<CompoundCollider>(collider);
+		return BoundingVolumeClass(*compoundCol);
+	}
+		break;
 	default:
 		ERROR_AND_DIE("Cannot make bounding volume for collider type: %s", collider->GetTypeAsString());
 		break;
@@ -252,267 +492,1408 @@ BoundingVolumeClass CollisionScene<BoundingVolumeClass>::MakeBoundingVolumeForCo
 
 //-------------------------------------------------------------------------------------------------
 template <class BoundingVolumeClass>
-void CollisionScene<BoundingVolumeClass>::UpdateBVH()
+CollisionFilter CollisionScene<BoundingVolumeClass>::MakeCollisionFilterForCollider(const Collider* collider) const
 {
-	// For each node, check if the entity's bounding volume changed a significant amount. If so, update it
-	for (BVHNode<BoundingVolumeClass>* node : m_leaves)
-	{
-		BoundingVolumeClass currVolumeWs = MakeBoundingVolumeForCollider(node->m_entity->collider);
+	ASSERT_OR_DIE(collider->m_collisionLayer < MAX_COLLISION_LAYERS, "Collider layer out of range!");
 
-		if (!AreMostlyEqual(node->m_boundingVolumeWs, currVolumeWs))
-		{
-			UpdateNode(node, currVolumeWs);
-		}
-	}
+	// The collider's own mask can only narrow what the scene's layer matrix allows
+	CollisionFilter filter;
+	filter.m_layers = (1U << collider->m_collisionLayer);
+	filter.m_mask = collider->m_collisionMask & m_layerMatrix[collider->m_collisionLayer];
+
+	return filter;
 }
 
 
 //-------------------------------------------------------------------------------------------------
 template <class BoundingVolumeClass>
-void CollisionScene<BoundingVolumeClass>::PerformBroadphase()
+void CollisionScene<BoundingVolumeClass>::SetLayersCanCollide(uint32 layerA, uint32 layerB, bool canCollide)
 {
-	m_numPotentialCollisions = 0;
+	ASSERT_OR_DIE(layerA < MAX_COLLISION_LAYERS && layerB < MAX_COLLISION_LAYERS, "Layer out of range!");
 
-	for (HalfSpaceCollider* halfSpace : m_halfSpaces)
+	// Keep the matrix symmetric - leaf filters pick up the change on the next UpdateBVH()
+	if (canCollide)
 	{
-		m_numPotentialCollisions += m_boundingTreeRoot->GetPotentialCollisionsBetween(halfSpace, m_potentialCollisions + m_numPotentialCollisions, MAX_POTENTIAL_COLLISION_COUNT - m_numPotentialCollisions);
+		m_layerMatrix[layerA] |= (1U << layerB);
+		m_layerMatrix[layerB] |= (1U << layerA);
+	}
+	else
+	{
+		m_layerMatrix[layerA] &= ~(1U << layerB);
+		m_layerMatrix[layerB] &= ~(1U << layerA);
+	}
+}
 
-		if (m_numPotentialCollisions == MAX_POTENTIAL_COLLISION_COUNT)
-			break;
+
+//-------------------------------------------------------------------------------------------------
+template <class BoundingVolumeClass>
+bool CollisionScene<BoundingVolumeClass>::CanLayersCollide(uint32 layerA, uint32 layerB) const
+{
+	ASSERT_OR_DIE(layerA < MAX_COLLISION_LAYERS && layerB < MAX_COLLISION_LAYERS, "Layer out of range!");
+	return (m_layerMatrix[layerA] & (1U << layerB)) != 0;
+}
+
+
+//-------------------------------------------------------------------------------------------------
+template <class BoundingVolumeClass>
+void CollisionScene<BoundingVolumeClass>::UpdateBVH()
+{
+	ReclassifyEntities();
+
+	if (m_isStaticTreeDirty)
+	{
+		RebuildStaticBVH();
 	}
 
-	if (m_numPotentialCollisions < MAX_POTENTIAL_COLLISION_COUNT)
+	// For each node, check if the entity's bounding volume changed a significant amount. If so, update it
+	for (BVHNode<BoundingVolumeClass>* node : m_leaves)
 	{
-		for (PlaneCollider* plane : m_planes)
+		Collider* collider = node->m_entity->collider;
+
+		// Layers or masks may have been changed on the collider, or the layer matrix on the scene
+		CollisionFilter currFilter = MakeCollisionFilterForCollider(collider);
+		bool filterChanged = (currFilter.m_layers != node->m_filter.m_layers || currFilter.m_mask != node->m_filter.m_mask);
+		node->m_filter = currFilter;
+
+		// Done here on the main thread so the narrowphase only ever reads compound children
+		if (collider->IsOfType<CompoundCollider>())
 		{
-			m_numPotentialCollisions += m_boundingTreeRoot->GetPotentialCollisionsBetween(plane, m_potentialCollisions + m_numPotentialCollisions, MAX_POTENTIAL_COLLISION_COUNT - m_numPotentialCollisions);
+			collider->GetAsType<CompoundCollider>()->UpdateChildTransforms();
+		}
 
-			if (m_numPotentialCollisions == MAX_POTENTIAL_COLLISION_COUNT)
-				break;
+		BoundingVolumeClass currVolumeWs = MakeBoundingVolumeForCollider(collider);
+
+		if (!AreMostlyEqual(node->m_boundingVolumeWs, currVolumeWs))
+		{
+			// Small motions keep the leaf where it is and refit upwards, as reinserting things that move together just thrashes the tree
+			if (IsSmallMotion(node->m_boundingVolumeWs, currVolumeWs))
+			{
+				node->m_boundingVolumeWs = currVolumeWs;
+				m_leavesToRefit.push_back(node);
+			}
+			else
+			{
+				UpdateNode(node, currVolumeWs);
+			}
+		}
+		else if (filterChanged)
+		{
+			m_leavesToRefit.push_back(node);
 		}
 	}
 
-	if (m_numPotentialCollisions < MAX_POTENTIAL_COLLISION_COUNT)
+	// Queue after all reinserts are done, since those delete and create internal nodes
+	for (BVHNode<BoundingVolumeClass>* leaf : m_leavesToRefit)
 	{
-		m_numPotentialCollisions += m_boundingTreeRoot->GetPotentialNodeCollisions(m_potentialCollisions + m_numPotentialCollisions, MAX_POTENTIAL_COLLISION_COUNT - m_numPotentialCollisions);
+		QueueAncestorsForRefit(leaf);
 	}
 
-	if (m_numPotentialCollisions == MAX_POTENTIAL_COLLISION_COUNT)
-	{
-		ConsoleWarningf("Collision scene hit the limit for number of potential collisions per frame at: %i", m_numPotentialCollisions);
-	}
+	m_leavesToRefit.clear();
+	RefitQueuedNodes();
+	CheckBVHQuality();
 }
 
 
 //-------------------------------------------------------------------------------------------------
+// Which tree an entity goes in is decided when it's added, but game code can change a body's mass afterwards
+// Only entities with a body can flip, so static entities without one are skipped without touching their body
+// Bodies count every flip, so nothing is checked on the steps where none happened
 template <class BoundingVolumeClass>
-void CollisionScene<BoundingVolumeClass>::GenerateContacts()
+void CollisionScene<BoundingVolumeClass>::ReclassifyEntities()
 {
-	m_numNewContacts = 0;
+	uint32 staticChangeCount = RigidBody::GetStaticChangeCount();
+	if (staticChangeCount == m_lastStaticChangeCount)
+		return;
 
-	for (int i = 0; i < m_numPotentialCollisions; ++i)
+	m_lastStaticChangeCount = staticChangeCount;
+
+	for (int iLeaf = (int)m_leaves.size() - 1; iLeaf >= 0; --iLeaf)
 	{
-		if (m_numNewContacts >= MAX_CONTACT_COUNT)
-		{
-			ConsoleWarningf("CollisionDetector ran out of room for contacts!");
-			return;
-		}
+		BVHNode<BoundingVolumeClass>* node = m_leaves[iLeaf];
 
-		PotentialCollision& collision = m_potentialCollisions[i];
+		if (!IsEntityStatic(node->m_entity))
+			continue;
 
-		const Collider* a = collision.colliders[0];
-		const Collider* b = collision.colliders[1];
+		m_leaves.erase(m_leaves.begin() + iLeaf);
+		UnlinkDynamicLeaf(node);
 
-		// Don't generate contacts between colliders without bodies, sleeping bodies, or static bodies
-		// At least 1 collider needs to be an awake, movable entity to make the work here worth it
-		// Otherwise we're generating contacts we're dong nothing with
-		// This will need to be updated when overlap volumes come into play...
-		bool aDoesntNeedContacts = a->m_entity->rigidBody == nullptr || !a->m_entity->rigidBody->IsAwake() || a->m_entity->rigidBody->IsStatic();
-		bool bDoesntNeedContacts = b->m_entity->rigidBody == nullptr || !b->m_entity->rigidBody->IsAwake() || b->m_entity->rigidBody->IsStatic();
+		m_staticLeaves.push_back(node);
+		m_isStaticTreeDirty = true;
+	}
 
-		if (!(aDoesntNeedContacts && bDoesntNeedContacts))
-		{
-			m_numNewContacts += m_detector.GenerateContacts(a, b, &m_newContacts[m_numNewContacts], MAX_CONTACT_COUNT - m_numNewContacts);
-		}
+	for (int iLeaf = (int)m_staticLeaves.size() - 1; iLeaf >= 0; --iLeaf)
+	{
+		BVHNode<BoundingVolumeClass>* node = m_staticLeaves[iLeaf];
+
+		if (node->m_entity->rigidBody == nullptr || IsEntityStatic(node->m_entity))
+			continue;
+
+		// The static tree references the leaf, so it has to come down now rather than at the rebuild
+		DeleteStaticTree();
+		m_staticLeaves.erase(m_staticLeaves.begin() + iLeaf);
+		m_isStaticTreeDirty = true;
+
+		// The static tree is never refit, so the volume may be stale
+		node->m_boundingVolumeWs = MakeBoundingVolumeForCollider(node->m_entity->collider);
+		node->m_filter = MakeCollisionFilterForCollider(node->m_entity->collider);
+		InsertDynamicLeaf(node);
 	}
 }
 
 
 //-------------------------------------------------------------------------------------------------
 template <class BoundingVolumeClass>
-void CollisionScene<BoundingVolumeClass>::ResolveContacts(float deltaSeconds)
+bool CollisionScene<BoundingVolumeClass>::IsSmallMotion(const BoundingVolumeClass& oldVolume, const BoundingVolumeClass& newVolume) const
 {
-	if (m_numNewContacts > 0)
-	{	
-		m_resolver.SetMaxVelocityIterations(Min(m_defaultNumVelocityIterations, 2 * m_numNewContacts));
-		m_resolver.SetMaxPenetrationIterations(Min(m_defaultNumPenetrationIterations, 2 * m_numNewContacts));
-		m_resolver.ResolveContacts(m_newContacts, m_numNewContacts, deltaSeconds);
-	}
+	float change = (newVolume.GetCenter() - oldVolume.GetCenter()).GetLength() + Abs(newVolume.GetSize() - oldVolume.GetSize());
+	return (change < m_bvhRefitMotionFraction * oldVolume.GetSize());
 }
 
 
 //-------------------------------------------------------------------------------------------------
 template <class BoundingVolumeClass>
-void CollisionScene<BoundingVolumeClass>::DebugDrawBoundingVolumeHierarchy() const
+void CollisionScene<BoundingVolumeClass>::QueueAncestorsForRefit(BVHNode<BoundingVolumeClass>* leaf)
 {
-	if (m_boundingTreeRoot != nullptr)
+	BVHNode<BoundingVolumeClass>* curr = leaf->m_parent;
+	int depth = leaf->GetDepth() - 1;
+
+	// Once we hit a queued node, everything above it is already queued too
+	while (curr != nullptr && !curr->m_needsRefit)
 	{
-		m_boundingTreeRoot->DebugRender();
+		curr->m_needsRefit = true;
+		m_nodesToRefit.push_back({ curr, depth });
+
+		curr = curr->m_parent;
+		depth--;
 	}
 }
 
 
 //-------------------------------------------------------------------------------------------------
 template <class BoundingVolumeClass>
-void CollisionScene<BoundingVolumeClass>::DebugDrawLeafBoundingVolumes() const
+void CollisionScene<BoundingVolumeClass>::RefitQueuedNodes()
 {
-	for (BVHNode<BoundingVolumeClass>* leaf : m_leaves)
+	// Deepest first, so each node is refit after all of its queued descendants
+	std::sort(m_nodesToRefit.begin(), m_nodesToRefit.end(), [](const RefitEntry& a, const RefitEntry& b) { return a.depth > b.depth; });
+
+	int rotationsLeft = m_bvhRotationBudget;
+	for (RefitEntry& entry : m_nodesToRefit)
 	{
-		leaf->m_boundingVolumeWs.DebugRender();
+		BVHNode<BoundingVolumeClass>* node = entry.node;
+		node->RefitSelf();
+		node->m_needsRefit = false;
+
+		// Rotations only touch this node and its children, which have all been refit already
+		if (rotationsLeft > 0 && node->TryRotate())
+		{
+			rotationsLeft--;
+		}
 	}
+
+	m_nodesToRefit.clear();
 }
 
 
 //-------------------------------------------------------------------------------------------------
 template <class BoundingVolumeClass>
-CollisionScene<BoundingVolumeClass>::~CollisionScene()
+float CollisionScene<BoundingVolumeClass>::GetBVHCost() const
 {
-	ASSERT_OR_DIE(m_boundingTreeRoot == nullptr, "Tree wasn't cleaned up before deleting!");
-	ASSERT_OR_DIE(m_leaves.size() == 0, "Levaes weren't cleaned up properly!");
+	if (m_boundingTreeRoot == nullptr || m_boundingTreeRoot->IsLeaf())
+		return 0.f;
+
+	// SAH cost relative to the root, per leaf so adding/removing entities doesn't skew it much
+	float rootArea = m_boundingTreeRoot->m_boundingVolumeWs.GetSurfaceArea();
+	if (rootArea <= 0.f)
+		return 0.f;
+
+	return m_boundingTreeRoot->GetSubtreeCost() / (rootArea * (float)m_leaves.size());
 }
 
 
 //-------------------------------------------------------------------------------------------------
 template <class BoundingVolumeClass>
-void CollisionScene<BoundingVolumeClass>::AddEntity(Entity* entity)
+void CollisionScene<BoundingVolumeClass>::CheckBVHQuality()
 {
-	ASSERT_OR_DIE(entity != nullptr, "Null entity!");
-	ASSERT_OR_DIE(entity->collider != nullptr, "Null collider!");
+	m_stepsSinceQualityCheck++;
+	if (m_stepsSinceQualityCheck < BVH_QUALITY_CHECK_INTERVAL)
+		return;
 
-	if (entity->collider->IsOfType<HalfSpaceCollider>())
-	{
-		m_halfSpaces.push_back(entity->collider->GetAsType<HalfSpaceCollider>());
-	}
-	else if (entity->collider->IsOfType<PlaneCollider>())
-	{
-		m_planes.push_back(entity->collider->GetAsType<PlaneCollider>());
-	}
-	else
-	{
-		BoundingVolumeClass boundingVolume = MakeBoundingVolumeForCollider(entity->collider);
-		BVHNode<BoundingVolumeClass>* node = new BVHNode<BoundingVolumeClass>(boundingVolume);
-		node->m_entity = entity;
+	m_stepsSinceQualityCheck = 0;
 
-		if (m_boundingTreeRoot != nullptr)
-		{
-			BVHNode<BoundingVolumeClass>* newRoot = m_boundingTreeRoot->Insert(node);
-			if (newRoot != nullptr)
-			{
-				m_boundingTreeRoot = newRoot;
-			}
-		}
-		else
-		{
-			m_boundingTreeRoot = node;
-		}
+	if (m_boundingTreeRoot == nullptr || m_boundingTreeRoot->IsLeaf())
+		return;
 
-		m_leaves.push_back(node);
+	// The tree so far was built purely by insertions, so get a good one to compare against
+	if (m_bvhBaselineCost < 0.f || GetBVHCost() > m_bvhRebuildCostRatio * m_bvhBaselineCost)
+	{
+		RebuildBVH();
 	}
+}
 
-	// Ensure we create the debug draw for the collider
-	if (AreBitsSet(m_debugFlags, COLLISION_DEBUG_COLLIDERS))
+
+//-------------------------------------------------------------------------------------------------
+template <class BoundingVolumeClass>
+void CollisionScene<BoundingVolumeClass>::RebuildBVH()
+{
+	if (m_boundingTreeRoot != nullptr)
 	{
-		entity->collider->ShowDebug();
+		DeleteInternalNodes(m_boundingTreeRoot);
+		m_boundingTreeRoot = nullptr;
 	}
+
+	if (m_leaves.size() == 0)
+		return;
+
+	m_boundingTreeRoot = BuildBVH(m_leaves.data(), (int)m_leaves.size());
+	m_bvhBaselineCost = GetBVHCost();
 }
 
 
 //-------------------------------------------------------------------------------------------------
 template <class BoundingVolumeClass>
-void CollisionScene<BoundingVolumeClass>::RemoveEntity(Entity* entity)
+void CollisionScene<BoundingVolumeClass>::RebuildStaticBVH()
 {
-	ASSERT_OR_DIE(entity != nullptr, "Null entity!");
-	ASSERT_OR_DIE(entity->collider != nullptr, "Null collider!");
+	m_isStaticTreeDirty = false;
+	DeleteStaticTree();
 
-	if (entity->collider->IsOfType<HalfSpaceCollider>())
-	{
-		for (int i = 0; i < m_halfSpaces.size(); ++i)
-		{
-			if (m_halfSpaces[i] == entity->collider)
-			{
-				m_halfSpaces.erase(m_halfSpaces.begin() + i);
-				break;
-			}
-		}
-	}
-	else if (entity->collider->IsOfType<PlaneCollider>())
+	if (m_staticLeaves.size() == 0)
+		return;
+
+	// Static entities aren't tracked per step, so pick up any changes now
+	for (BVHNode<BoundingVolumeClass>* leaf : m_staticLeaves)
 	{
-		for (int i = 0; i < m_planes.size(); ++i)
+		Collider* collider = leaf->m_entity->collider;
+		if (collider->IsOfType<CompoundCollider>())
 		{
-			if (m_planes[i] == entity->collider)
-			{
-				m_planes.erase(m_planes.begin() + i);
-				break;
-			}
+			collider->GetAsType<CompoundCollider>()->UpdateChildTransforms();
 		}
-	}
-	else
-	{
-		BVHNode<BoundingVolumeClass>* node = GetAndEraseLeafNodeForEntity(entity);
-
-		if (node != m_boundingTreeRoot)
-		{
-			BVHNode<BoundingVolumeClass>* newRoot = node->RemoveSelf();
-			if (newRoot != nullptr)
-			{
-				m_boundingTreeRoot = newRoot;
-			}
 
-			SAFE_DELETE(node);
-		}
-		else
-		{
-			SAFE_DELETE(m_boundingTreeRoot);
-		}
+		leaf->m_boundingVolumeWs = MakeBoundingVolumeForCollider(collider);
+		leaf->m_filter = MakeCollisionFilterForCollider(collider);
 	}
+
+	m_staticTreeRoot = BuildBVH(m_staticLeaves.data(), (int)m_staticLeaves.size());
+	m_staticQBVH.Build(m_staticTreeRoot);
 }
 
 
 //-------------------------------------------------------------------------------------------------
 template <class BoundingVolumeClass>
-void CollisionScene<BoundingVolumeClass>::DoCollisionStep(float deltaSeconds)
+void CollisionScene<BoundingVolumeClass>::SaveSnapshot(CollisionSceneSnapshot<BoundingVolumeClass>& out_snapshot) const
 {
-	// Ensure the BVH is up to date, then get the potential collisions
-	UpdateBVH();
-	PerformBroadphase();
-	GenerateContacts();
-	ResolveContacts(deltaSeconds);
+	BuildEntityIndexLookup();
+	out_snapshot.m_numEntities = (int)m_entities.size();
 
-	// Debug
-	if (AreBitsSet(m_debugFlags, COLLISION_DEBUG_CONTACTS))
+	// Assigning into the existing vectors reuses their memory, so saving every step doesn't allocate once warmed up
+	out_snapshot.m_leafEntityIndices.resize(m_leaves.size());
+	out_snapshot.m_leafVolumes.resize(m_leaves.size());
+
+	for (int iLeaf = 0; iLeaf < (int)m_leaves.size(); ++iLeaf)
 	{
-		DebugDrawContacts();
+		out_snapshot.m_leafEntityIndices[iLeaf] = LookupEntityIndex(m_leaves[iLeaf]->m_entity);
+		out_snapshot.m_leafVolumes[iLeaf] = m_leaves[iLeaf]->m_boundingVolumeWs;
 	}
 
-	if (AreBitsSet(m_debugFlags, COLLISION_DEBUG_BOUNDING_VOLUMES))
+	out_snapshot.m_treeLayout.clear();
+	out_snapshot.m_internalVolumes.clear();
+
+	if (m_boundingTreeRoot != nullptr)
 	{
-		DebugDrawBoundingVolumeHierarchy();
+		AppendNodeToSnapshot(m_boundingTreeRoot, out_snapshot);
 	}
-	else if (AreBitsSet(m_debugFlags, COLLISION_DEBUG_LEAF_BOUNDING_VOLUMES))
+
+	out_snapshot.m_triggerPairs.resize(2 * m_prevTriggerPairs.size());
+
+	for (int iPair = 0; iPair < (int)m_prevTriggerPairs.size(); ++iPair)
 	{
-		DebugDrawLeafBoundingVolumes();
+		out_snapshot.m_triggerPairs[2 * iPair] = LookupEntityIndex(m_prevTriggerPairs[iPair].trigger->m_entity);
+		out_snapshot.m_triggerPairs[2 * iPair + 1] = LookupEntityIndex(m_prevTriggerPairs[iPair].other->m_entity);
 	}
+
+	out_snapshot.m_bvhBaselineCost = m_bvhBaselineCost;
+	out_snapshot.m_stepsSinceQualityCheck = m_stepsSinceQualityCheck;
 }
 
 
 //-------------------------------------------------------------------------------------------------
 template <class BoundingVolumeClass>
-void CollisionScene<BoundingVolumeClass>::UpdateNode(BVHNode<BoundingVolumeClass>* node, const BoundingVolumeClass& newVolume)
+bool CollisionScene<BoundingVolumeClass>::RestoreSnapshot(const CollisionSceneSnapshot<BoundingVolumeClass>& snapshot)
 {
-	if (node->m_parent != nullptr)
+	int numEntities = (int)m_entities.size();
+	ASSERT_RETURN(snapshot.m_numEntities == numEntities, false, "Snapshot has %i entities but the scene has %i!", snapshot.m_numEntities, numEntities);
+	ASSERT_RETURN(snapshot.m_leafEntityIndices.size() == m_leaves.size(), false, "Snapshot has %i dynamic entities but the scene has %i!", (int)snapshot.m_leafEntityIndices.size(), (int)m_leaves.size());
+
+	// Only the order can differ, the leaf nodes themselves live as long as their entities are in the scene
+	BuildEntityIndexLookup();
+	m_leavesByEntityIndex.assign(numEntities, nullptr);
+
+	for (BVHNode<BoundingVolumeClass>* leaf : m_leaves)
 	{
-		// Remove the node from the tree, recursively updating bounding volumes
-		BVHNode<BoundingVolumeClass>* newRoot = node->RemoveSelf();
+		m_leavesByEntityIndex[LookupEntityIndex(leaf->m_entity)] = leaf;
+	}
+
+	ASSERT_RETURN(snapshot.m_leafVolumes.size() == snapshot.m_leafEntityIndices.size(), false, "Snapshot has %i leaf volumes for %i leaves!", (int)snapshot.m_leafVolumes.size(), (int)snapshot.m_leafEntityIndices.size());
+
+	// Everything is checked before the live tree is touched, so a bad snapshot leaves the scene as it was
+	// Each dynamic entity has to show up exactly once, or a leaf would end up under two parents or outside the tree
+	m_snapshotSeenEntities.assign(numEntities, 0);
+	for (int entityIndex : snapshot.m_leafEntityIndices)
+	{
+		ASSERT_RETURN(entityIndex >= 0 && entityIndex < numEntities && m_leavesByEntityIndex[entityIndex] != nullptr, false, "Snapshot references an entity that isn't dynamic in this scene!");
+		ASSERT_RETURN(m_snapshotSeenEntities[entityIndex] == 0, false, "Snapshot lists entity %i as a leaf twice!", entityIndex);
+		m_snapshotSeenEntities[entityIndex] = 1;
+	}
+
+	// Dry run of the pre-order parse in RestoreNodeFromSnapshot(), it has to consume the whole layout and nothing past it
+	m_snapshotSeenEntities.assign(numEntities, 0);
+	int numInternalNodes = 0;
+	int numOpenSlots = (snapshot.m_treeLayout.size() > 0 ? 1 : 0);
+
+	for (int entityIndex : snapshot.m_treeLayout)
+	{
+		ASSERT_RETURN(numOpenSlots > 0, false, "Snapshot tree closes before the end of its layout!");
+		numOpenSlots--;
+
+		if (entityIndex == -1)
+		{
+			numInternalNodes++;
+			numOpenSlots += 2;
+			continue;
+		}
+
+		ASSERT_RETURN(entityIndex >= 0 && entityIndex < numEntities && m_leavesByEntityIndex[entityIndex] != nullptr, false, "Snapshot tree references an entity that isn't dynamic in this scene!");
+		ASSERT_RETURN(m_snapshotSeenEntities[entityIndex] == 0, false, "Snapshot tree has entity %i in it twice!", entityIndex);
+		m_snapshotSeenEntities[entityIndex] = 1;
+	}
+
+	ASSERT_RETURN(numOpenSlots == 0, false, "Snapshot tree layout ends partway through the tree!");
+
+	int expectedLayoutSize = (m_leaves.size() > 0 ? 2 * (int)m_leaves.size() - 1 : 0);
+	ASSERT_RETURN((int)snapshot.m_treeLayout.size() == expectedLayoutSize && numInternalNodes == (int)snapshot.m_internalVolumes.size(), false, "Snapshot tree doesn't match its leaves!");
+
+	ASSERT_RETURN(snapshot.m_triggerPairs.size() % 2 == 0, false, "Snapshot has half a trigger pair!");
+	for (int entityIndex : snapshot.m_triggerPairs)
+	{
+		ASSERT_RETURN(entityIndex >= 0 && entityIndex < numEntities, false, "Snapshot references an entity that isn't in this scene!");
+	}
+
+	if (m_boundingTreeRoot != nullptr)
+	{
+		DeleteInternalNodes(m_boundingTreeRoot);
+		m_boundingTreeRoot = nullptr;
+	}
+
+	for (int iLeaf = 0; iLeaf < (int)m_leaves.size(); ++iLeaf)
+	{
+		m_leaves[iLeaf] = m_leavesByEntityIndex[snapshot.m_leafEntityIndices[iLeaf]];
+		m_leaves[iLeaf]->m_boundingVolumeWs = snapshot.m_leafVolumes[iLeaf];
+	}
+
+	if (snapshot.m_treeLayout.size() > 0)
+	{
+		int layoutIndex = 0;
+		int internalIndex = 0;
+		m_boundingTreeRoot = RestoreNodeFromSnapshot(snapshot, layoutIndex, internalIndex);
+		m_boundingTreeRoot->m_parent = nullptr;
+	}
+
+	m_prevTriggerPairs.resize(snapshot.m_triggerPairs.size() / 2);
+
+	for (int iPair = 0; iPair < (int)m_prevTriggerPairs.size(); ++iPair)
+	{
+		m_prevTriggerPairs[iPair].trigger = m_entities[snapshot.m_triggerPairs[2 * iPair]]->collider;
+		m_prevTriggerPairs[iPair].other = m_entities[snapshot.m_triggerPairs[2 * iPair + 1]]->collider;
+	}
+
+	// Pairs are ordered by pointer, which won't match the saved order if the snapshot came from another run
+	std::sort(m_prevTriggerPairs.begin(), m_prevTriggerPairs.end());
+
+	m_bvhBaselineCost = snapshot.m_bvhBaselineCost;
+	m_stepsSinceQualityCheck = snapshot.m_stepsSinceQualityCheck;
+
+	return true;
+}
+
+
+//-------------------------------------------------------------------------------------------------
+// Sorted pairs rather than a map, so rebuilding it every save doesn't allocate once warmed up
+template <class BoundingVolumeClass>
+void CollisionScene<BoundingVolumeClass>::BuildEntityIndexLookup() const
+{
+	m_entityIndexLookup.resize(m_entities.size());
+
+	for (int entityIndex = 0; entityIndex < (int)m_entities.size(); ++entityIndex)
+	{
+		m_entityIndexLookup[entityIndex] = std::make_pair(static_cast<const Entity*>(m_entities[entityIndex]), entityIndex);
+	}
+
+	std::sort(m_entityIndexLookup.begin(), m_entityIndexLookup.end());
+}
+
+
+//-------------------------------------------------------------------------------------------------
+// Only valid right after BuildEntityIndexLookup()
+template <class BoundingVolumeClass>
+int CollisionScene<BoundingVolumeClass>::LookupEntityIndex(const Entity* entity) const
+{
+	auto itr = std::lower_bound(m_entityIndexLookup.begin(), m_entityIndexLookup.end(), std::make_pair(entity, 0));
+	ASSERT_OR_DIE(itr != m_entityIndexLookup.end() && itr->first == entity, "Entity isn't in the collision scene!");
+
+	return itr->second;
+}
+
+
+//-------------------------------------------------------------------------------------------------
+template <class BoundingVolumeClass>
+void CollisionScene<BoundingVolumeClass>::AppendNodeToSnapshot(const BVHNode<BoundingVolumeClass>* node, CollisionSceneSnapshot<BoundingVolumeClass>& out_snapshot) const
+{
+	if (node->IsLeaf())
+	{
+		out_snapshot.m_treeLayout.push_back(LookupEntityIndex(node->m_entity));
+		return;
+	}
+
+	out_snapshot.m_treeLayout.push_back(-1);
+	out_snapshot.m_internalVolumes.push_back(node->m_boundingVolumeWs);
+
+	AppendNodeToSnapshot(node->m_children[0], out_snapshot);
+	AppendNodeToSnapshot(node->m_children[1], out_snapshot);
+}
+
+
+//-------------------------------------------------------------------------------------------------
+// Volumes are copied rather than refit, as refitting could round differently than whatever built the saved tree
+template <class BoundingVolumeClass>
+BVHNode<BoundingVolumeClass>* CollisionScene<BoundingVolumeClass>::RestoreNodeFromSnapshot(const CollisionSceneSnapshot<BoundingVolumeClass>& snapshot, int& layoutIndex, int& internalIndex)
+{
+	int entityIndex = snapshot.m_treeLayout[layoutIndex++];
+
+	if (entityIndex != -1)
+		return m_leavesByEntityIndex[entityIndex];
+
+	BVHNode<BoundingVolumeClass>* node = new BVHNode<BoundingVolumeClass>(snapshot.m_internalVolumes[internalIndex++]);
+	node->m_children[0] = RestoreNodeFromSnapshot(snapshot, layoutIndex, internalIndex);
+	node->m_children[1] = RestoreNodeFromSnapshot(snapshot, layoutIndex, internalIndex);
+	node->m_children[0]->m_parent = node;
+	node->m_children[1]->m_parent = node;
+
+	// Filters aren't saved since they're just unions of the leaf filters
+	node->m_filter.m_layers = node->m_children[0]->m_filter.m_layers | node->m_children[1]->m_filter.m_layers;
+	node->m_filter.m_mask = node->m_children[0]->m_filter.m_mask | node->m_children[1]->m_filter.m_mask;
+
+	return node;
+}
+
+
+//-------------------------------------------------------------------------------------------------
+template <class BoundingVolumeClass>
+void CollisionScene<BoundingVolumeClass>::DeleteInternalNodes(BVHNode<BoundingVolumeClass>* node)
+{
+	node->m_parent = nullptr;
+
+	if (node->IsLeaf())
+		return;
+
+	DeleteInternalNodes(node->m_children[0]);
+	DeleteInternalNodes(node->m_children[1]);
+
+	node->m_children[0] = nullptr;
+	node->m_children[1] = nullptr;
+	delete node;
+}
+
+
+//-------------------------------------------------------------------------------------------------
+// Also adds it to m_leaves
+template <class BoundingVolumeClass>
+void CollisionScene<BoundingVolumeClass>::InsertDynamicLeaf(BVHNode<BoundingVolumeClass>* node)
+{
+	if (m_boundingTreeRoot != nullptr)
+	{
+		BVHNode<BoundingVolumeClass>* newRoot = m_boundingTreeRoot->Insert(node);
+		if (newRoot != nullptr)
+		{
+			m_boundingTreeRoot = newRoot;
+		}
+	}
+	else
+	{
+		m_boundingTreeRoot = node;
+	}
+
+	m_leaves.push_back(node);
+}
+
+
+//-------------------------------------------------------------------------------------------------
+// Takes the leaf out of the tree without deleting it, the caller takes it out of m_leaves
+template <class BoundingVolumeClass>
+void CollisionScene<BoundingVolumeClass>::UnlinkDynamicLeaf(BVHNode<BoundingVolumeClass>* node)
+{
+	if (node != m_boundingTreeRoot)
+	{
+		BVHNode<BoundingVolumeClass>* newRoot = node->RemoveSelf();
+		if (newRoot != nullptr)
+		{
+			m_boundingTreeRoot = newRoot;
+		}
+	}
+	else
+	{
+		m_boundingTreeRoot = nullptr;
+		m_bvhBaselineCost = -1.f;
+	}
+}
+
+
+//-------------------------------------------------------------------------------------------------
+// Leaves are kept, RebuildStaticBVH() puts them back in a new tree
+template <class BoundingVolumeClass>
+void CollisionScene<BoundingVolumeClass>::DeleteStaticTree()
+{
+	if (m_staticTreeRoot != nullptr)
+	{
+		DeleteInternalNodes(m_staticTreeRoot);
+		m_staticTreeRoot = nullptr;
+		m_staticQBVH.Clear();
+	}
+}
+
+
+//-------------------------------------------------------------------------------------------------
+// Reorders the leaves, which is fine as the leaf lists have no meaningful order
+template <class BoundingVolumeClass>
+BVHNode<BoundingVolumeClass>* CollisionScene<BoundingVolumeClass>::BuildBVH(BVHNode<BoundingVolumeClass>** leaves, int numLeaves)
+{
+	int numThreads = (g_jobSystem != nullptr ? g_jobSystem->GetNumWorkerThreads() + 1 : 1);
+
+	if (numThreads == 1 || numLeaves < 2 * BVH_BUILD_MIN_LEAVES_PER_JOB)
+		return BuildBVHSubtree(leaves, numLeaves);
+
+	// Split the top of the tree here until there's enough independent subtrees to keep every thread busy
+	struct SubtreeTask
+	{
+		BVHNode<BoundingVolumeClass>**	leaves;
+		int								numLeaves;
+		BVHNode<BoundingVolumeClass>*	parent;
+		int								childIndex;
+		BVHNode<BoundingVolumeClass>*	root;
+	};
+
+	std::vector<SubtreeTask> tasks;
+	std::vector<BVHNode<BoundingVolumeClass>*> topNodes;
+	tasks.push_back({ leaves, numLeaves, nullptr, 0, nullptr });
+
+	int targetNumTasks = 4 * numThreads;
+	while ((int)tasks.size() < targetNumTasks)
+	{
+		// Always split the biggest remaining task
+		int largestIndex = 0;
+		for (int taskIndex = 1; taskIndex < (int)tasks.size(); ++taskIndex)
+		{
+			if (tasks[taskIndex].numLeaves > tasks[largestIndex].numLeaves)
+			{
+				largestIndex = taskIndex;
+			}
+		}
+
+		SubtreeTask task = tasks[largestIndex];
+		if (task.numLeaves < 2 * BVH_BUILD_MIN_LEAVES_PER_JOB)
+			break;
+
+		tasks[largestIndex] = tasks.back();
+		tasks.pop_back();
+
+		int numLeft = PartitionLeavesSAH(task.leaves, task.numLeaves);
+
+		BVHNode<BoundingVolumeClass>* node = new BVHNode<BoundingVolumeClass>();
+		node->m_parent = task.parent;
+		if (task.parent != nullptr)
+		{
+			task.parent->m_children[task.childIndex] = node;
+		}
+
+		topNodes.push_back(node);
+		tasks.push_back({ task.leaves, numLeft, node, 0, nullptr });
+		tasks.push_back({ task.leaves + numLeft, task.numLeaves - numLeft, node, 1, nullptr });
+	}
+
+	g_jobSystem->ParallelFor((int)tasks.size(), 1, [this, &tasks](int startIndex, int endIndex)
+	{
+		for (int taskIndex = startIndex; taskIndex < endIndex; ++taskIndex)
+		{
+			tasks[taskIndex].root = BuildBVHSubtree(tasks[taskIndex].leaves, tasks[taskIndex].numLeaves);
+		}
+	});
+
+	for (SubtreeTask& task : tasks)
+	{
+		task.parent->m_children[task.childIndex] = task.root;
+		task.root->m_parent = task.parent;
+	}
+
+	// Top nodes were made parents first, so going backwards refits them bottom up
+	for (int nodeIndex = (int)topNodes.size() - 1; nodeIndex >= 0; --nodeIndex)
+	{
+		topNodes[nodeIndex]->RefitSelf();
+	}
+
+	return topNodes[0];
+}
+
+
+//-------------------------------------------------------------------------------------------------
+// Only reads the scene, so this is safe to call on multiple threads with separate leaf ranges
+template <class BoundingVolumeClass>
+BVHNode<BoundingVolumeClass>* CollisionScene<BoundingVolumeClass>::BuildBVHSubtree(BVHNode<BoundingVolumeClass>** leaves, int numLeaves) const
+{
+	if (numLeaves == 1)
+		return leaves[0];
+
+	int numLeft = PartitionLeavesSAH(leaves, numLeaves);
+
+	BVHNode<BoundingVolumeClass>* node = new BVHNode<BoundingVolumeClass>();
+	node->m_children[0] = BuildBVHSubtree(leaves, numLeft);
+	node->m_children[1] = BuildBVHSubtree(leaves + numLeft, numLeaves - numLeft);
+	node->m_children[0]->m_parent = node;
+	node->m_children[1]->m_parent = node;
+	node->RefitSelf();
+
+	return node;
+}
+
+
+//-------------------------------------------------------------------------------------------------
+// Binned SAH - buckets the leaves by center along the widest axis, and splits between the buckets
+// where (surface area * leaf count) summed over both sides is lowest. Returns the number of leaves on the left
+template <class BoundingVolumeClass>
+int CollisionScene<BoundingVolumeClass>::PartitionLeavesSAH(BVHNode<BoundingVolumeClass>** leaves, int numLeaves) const
+{
+	Vector3 mins = leaves[0]->m_boundingVolumeWs.GetCenter();
+	Vector3 maxs = mins;
+
+	for (int iLeaf = 1; iLeaf < numLeaves; ++iLeaf)
+	{
+		Vector3 center = leaves[iLeaf]->m_boundingVolumeWs.GetCenter();
+		for (int iAxis = 0; iAxis < 3; ++iAxis)
+		{
+			mins.data[iAxis] = Min(mins.data[iAxis], center.data[iAxis]);
+			maxs.data[iAxis] = Max(maxs.data[iAxis], center.data[iAxis]);
+		}
+	}
+
+	Vector3 extents = maxs - mins;
+	int axis = (extents.x >= extents.y && extents.x >= extents.z ? 0 : (extents.y >= extents.z ? 1 : 2));
+	float axisMin = mins.data[axis];
+	float axisExtent = extents.data[axis];
+
+	auto getBinIndex = [axis, axisMin, axisExtent](const BVHNode<BoundingVolumeClass>* leaf)
+	{
+		float t = (leaf->m_boundingVolumeWs.GetCenter().data[axis] - axisMin) / axisExtent;
+		return Clamp((int)(t * BVH_BUILD_NUM_BINS), 0, BVH_BUILD_NUM_BINS - 1);
+	};
+
+	int bestBin = -1;
+	if (numLeaves > 2 && axisExtent > 0.f)
+	{
+		BoundingVolumeClass binVolumes[BVH_BUILD_NUM_BINS];
+		int binCounts[BVH_BUILD_NUM_BINS] = {};
+
+		for (int iLeaf = 0; iLeaf < numLeaves; ++iLeaf)
+		{
+			int binIndex = getBinIndex(leaves[iLeaf]);
+			const BoundingVolumeClass& leafVolume = leaves[iLeaf]->m_boundingVolumeWs;
+
+			binVolumes[binIndex] = (binCounts[binIndex] == 0 ? leafVolume : BoundingVolumeClass(binVolumes[binIndex], leafVolume));
+			binCounts[binIndex]++;
+		}
+
+		// Cost of everything right of each split, swept in from the right
+		float rightCosts[BVH_BUILD_NUM_BINS];
+		BoundingVolumeClass rightVolume;
+		int rightCount = 0;
+
+		for (int binIndex = BVH_BUILD_NUM_BINS - 1; binIndex > 0; --binIndex)
+		{
+			if (binCounts[binIndex] > 0)
+			{
+				rightVolume = (rightCount == 0 ? binVolumes[binIndex] : BoundingVolumeClass(rightVolume, binVolumes[binIndex]));
+				rightCount += binCounts[binIndex];
+			}
+
+			rightCosts[binIndex] = (rightCount > 0 ? rightVolume.GetSurfaceArea() * (float)rightCount : 0.f);
+		}
+
+		// Sweep in from the left, splitting after each bin
+		float bestCost = FLT_MAX;
+		BoundingVolumeClass leftVolume;
+		int leftCount = 0;
+
+		for (int binIndex = 0; binIndex < BVH_BUILD_NUM_BINS - 1; ++binIndex)
+		{
+			if (binCounts[binIndex] > 0)
+			{
+				leftVolume = (leftCount == 0 ? binVolumes[binIndex] : BoundingVolumeClass(leftVolume, binVolumes[binIndex]));
+				leftCount += binCounts[binIndex];
+			}
+
+			if (leftCount == 0 || leftCount == numLeaves)
+				continue;
+
+			float cost = leftVolume.GetSurfaceArea() * (float)leftCount + rightCosts[binIndex + 1];
+			if (cost < bestCost)
+			{
+				bestCost = cost;
+				bestBin = binIndex;
+			}
+		}
+	}
+
+	if (bestBin >= 0)
+	{
+		BVHNode<BoundingVolumeClass>** split = std::partition(leaves, leaves + numLeaves, [&getBinIndex, bestBin](const BVHNode<BoundingVolumeClass>* leaf) { return getBinIndex(leaf) <= bestBin; });
+		return (int)(split - leaves);
+	}
+
+	// Everything is stacked on top of each other, or too few to bin - just split down the middle
+	int numLeft = numLeaves / 2;
+	std::nth_element(leaves, leaves + numLeft, leaves + numLeaves, [axis](const BVHNode<BoundingVolumeClass>* a, const BVHNode<BoundingVolumeClass>* b)
+	{
+		return a->m_boundingVolumeWs.GetCenter().data[axis] < b->m_boundingVolumeWs.GetCenter().data[axis];
+	});
+
+	return numLeft;
+}
+
+
+//-------------------------------------------------------------------------------------------------
+template <class BoundingVolumeClass>
+BVHNode<BoundingVolumeClass>* CollisionScene<BoundingVolumeClass>::MakeLeafNodeForEntity(Entity* entity) const
+{
+	BoundingVolumeClass boundingVolume = MakeBoundingVolumeForCollider(entity->collider);
+	BVHNode<BoundingVolumeClass>* node = new BVHNode<BoundingVolumeClass>(boundingVolume);
+	node->m_entity = entity;
+	node->m_filter = MakeCollisionFilterForCollider(entity->collider);
+
+	return node;
+}
+
+
+//-------------------------------------------------------------------------------------------------
+template <class BoundingVolumeClass>
+int CollisionScene<BoundingVolumeClass>::FindAllPotentialCollisions(PotentialCollision* out_collisions, int limit) const
+{
+	if (m_boundingTreeRoot == nullptr)
+		return 0;
+
+	int numFound = m_boundingTreeRoot->GetPotentialNodeCollisions(out_collisions, limit);
+
+	if (numFound < limit)
+	{
+		numFound += GetPotentialCollisionsWithStatic(out_collisions + numFound, limit - numFound);
+	}
+
+	return numFound;
+}
+
+
+//-------------------------------------------------------------------------------------------------
+template <class BoundingVolumeClass>
+int CollisionScene<BoundingVolumeClass>::GetPotentialCollisionsWithStatic(PotentialCollision* out_collisions, int limit) const
+{
+	if (m_staticQBVH.IsEmpty())
+		return 0;
+
+	// Static is almost always the larger tree, so it's cheaper to send each dynamic leaf down it than to walk both
+	int numFound = 0;
+	for (int leafIndex = 0; leafIndex < (int)m_leaves.size() && numFound < limit; ++leafIndex)
+	{
+		const BVHNode<BoundingVolumeClass>* leaf = m_leaves[leafIndex];
+		numFound += m_staticQBVH.GetPotentialCollisionsWith(leaf->m_entity->collider, leaf->m_boundingVolumeWs, leaf->m_filter, out_collisions + numFound, limit - numFound);
+	}
+
+	return numFound;
+}
+
+
+//-------------------------------------------------------------------------------------------------
+template <class BoundingVolumeClass>
+int CollisionScene<BoundingVolumeClass>::GetRaycastCandidates(const Vector3& start, const Vector3& direction, float maxDistance, const Collider** out_colliders, int limit) const
+{
+	int numFound = 0;
+
+	if (m_boundingTreeRoot != nullptr)
+	{
+		numFound += m_boundingTreeRoot->GetRaycastCandidates(start, direction, maxDistance, out_colliders, limit);
+	}
+
+	if (numFound < limit)
+	{
+		numFound += m_staticQBVH.GetRaycastCandidates(start, direction, maxDistance, out_colliders + numFound, limit - numFound);
+	}
+
+	return numFound;
+}
+
+
+//-------------------------------------------------------------------------------------------------
+template <class BoundingVolumeClass>
+int CollisionScene<BoundingVolumeClass>::GetOverlapCandidates(const BoundingVolumeClass& volume, const Collider** out_colliders, int limit) const
+{
+	int numFound = 0;
+
+	for (HalfSpaceCollider* halfSpace : m_halfSpaces)
+	{
+		if (numFound < limit && volume.Overlaps(halfSpace))
+		{
+			out_colliders[numFound++] = halfSpace;
+		}
+	}
+
+	for (PlaneCollider* plane : m_planes)
+	{
+		if (numFound < limit && volume.Overlaps(plane))
+		{
+			out_colliders[numFound++] = plane;
+		}
+	}
+
+	if (m_boundingTreeRoot != nullptr && numFound < limit)
+	{
+		numFound += m_boundingTreeRoot->GetOverlapCandidates(volume, out_colliders + numFound, limit - numFound);
+	}
+
+	if (numFound < limit)
+	{
+		numFound += m_staticQBVH.GetOverlapCandidates(volume, out_colliders + numFound, limit - numFound);
+	}
+
+	return numFound;
+}
+
+
+//-------------------------------------------------------------------------------------------------
+template <class BoundingVolumeClass>
+void CollisionScene<BoundingVolumeClass>::PerformBroadphase()
+{
+	m_numPotentialCollisions = 0;
+
+	if (m_boundingTreeRoot == nullptr)
+		return;
+
+	for (HalfSpaceCollider* halfSpace : m_halfSpaces)
+	{
+		CollisionFilter halfSpaceFilter = MakeCollisionFilterForCollider(halfSpace);
+		m_numPotentialCollisions += m_boundingTreeRoot->GetPotentialCollisionsBetween(halfSpace, halfSpaceFilter, m_potentialCollisions.data() + m_numPotentialCollisions, m_maxPotentialCollisions - m_numPotentialCollisions);
+
+		if (m_numPotentialCollisions == m_maxPotentialCollisions)
+			break;
+	}
+
+	if (m_numPotentialCollisions < m_maxPotentialCollisions)
+	{
+		for (PlaneCollider* plane : m_planes)
+		{
+			CollisionFilter planeFilter = MakeCollisionFilterForCollider(plane);
+			m_numPotentialCollisions += m_boundingTreeRoot->GetPotentialCollisionsBetween(plane, planeFilter, m_potentialCollisions.data() + m_numPotentialCollisions, m_maxPotentialCollisions - m_numPotentialCollisions);
+
+			if (m_numPotentialCollisions == m_maxPotentialCollisions)
+				break;
+		}
+	}
+
+	if (m_numPotentialCollisions < m_maxPotentialCollisions)
+	{
+		m_numPotentialCollisions += m_boundingTreeRoot->GetPotentialNodeCollisions(m_potentialCollisions.data() + m_numPotentialCollisions, m_maxPotentialCollisions - m_numPotentialCollisions);
+	}
+
+	// Dynamic against static only - static entities never need to be checked against each other or the planes
+	if (m_numPotentialCollisions < m_maxPotentialCollisions)
+	{
+		m_numPotentialCollisions += GetPotentialCollisionsWithStatic(m_potentialCollisions.data() + m_numPotentialCollisions, m_maxPotentialCollisions - m_numPotentialCollisions);
+	}
+
+	if (m_numPotentialCollisions == m_maxPotentialCollisions)
+	{
+		ConsoleWarningf("Collision scene hit the limit for number of potential collisions per frame at: %i", m_numPotentialCollisions);
+	}
+}
+
+
+//-------------------------------------------------------------------------------------------------
+template <class BoundingVolumeClass>
+void CollisionScene<BoundingVolumeClass>::GenerateContacts()
+{
+	m_numNewContacts = 0;
+	m_currTriggerPairs.clear();
+
+	int numUnbatchedPairs = 0;
+	for (int i = 0; i < m_numPotentialCollisions; ++i)
+	{
+		PotentialCollision& collision = m_potentialCollisions[i];
+
+		const Collider* a = collision.colliders[0];
+		const Collider* b = collision.colliders[1];
+
+		// Triggers only need a boolean overlap test, and still need to report regardless of sleeping/static bodies
+		if (a->m_isTrigger || b->m_isTrigger)
+		{
+			// Triggers don't report overlapping other triggers
+			if (!(a->m_isTrigger && b->m_isTrigger) && m_detector.AreOverlapping(a, b))
+			{
+				TriggerPair pair;
+				pair.trigger = (a->m_isTrigger ? a : b);
+				pair.other = (a->m_isTrigger ? b : a);
+				m_currTriggerPairs.push_back(pair);
+			}
+
+			continue;
+		}
+
+		// Don't generate contacts between colliders without bodies, sleeping bodies, or static bodies
+		// At least 1 collider needs to be an awake, movable entity to make the work here worth it
+		// Otherwise we're generating contacts we're dong nothing with
+		bool aDoesntNeedContacts = a->m_entity->rigidBody == nullptr || !a->m_entity->rigidBody->IsAwake() || a->m_entity->rigidBody->IsStatic();
+		bool bDoesntNeedContacts = b->m_entity->rigidBody == nullptr || !b->m_entity->rigidBody->IsAwake() || b->m_entity->rigidBody->IsStatic();
+
+		if (aDoesntNeedContacts && bDoesntNeedContacts)
+			continue;
+
+		// Type pairs with a batched kernel are bucketed and run together after everything else
+		int batchIndex = CollisionDetector::GetBatchIndex(a, b);
+		if (batchIndex >= 0)
+		{
+			int& numInBatch = m_numBatchedPairs[batchIndex];
+			m_batchedColliders[batchIndex][0][numInBatch] = a;
+			m_batchedColliders[batchIndex][1][numInBatch] = b;
+			numInBatch++;
+		}
+		else
+		{
+			int typeA = a->GetTypeIndex();
+			int typeB = b->GetTypeIndex();
+
+			m_unbatchedColliders[0][numUnbatchedPairs] = a;
+			m_unbatchedColliders[1][numUnbatchedPairs] = b;
+			m_unbatchedTypePairs[numUnbatchedPairs] = Min(typeA, typeB) * NUM_COLLIDER_TYPES + Max(typeA, typeB);
+			numUnbatchedPairs++;
+		}
+	}
+
+	// Counting sort by type pair, stable so pairs keep their broadphase order within a group
+	// Each matrix function then runs over all of its pairs back to back, reading colliders out of the same couple of pools
+	int typePairStarts[NUM_COLLIDER_TYPES * NUM_COLLIDER_TYPES + 1] = {};
+	for (int pairIndex = 0; pairIndex < numUnbatchedPairs; ++pairIndex)
+	{
+		typePairStarts[m_unbatchedTypePairs[pairIndex] + 1]++;
+	}
+
+	for (int typePair = 0; typePair < NUM_COLLIDER_TYPES * NUM_COLLIDER_TYPES; ++typePair)
+	{
+		typePairStarts[typePair + 1] += typePairStarts[typePair];
+	}
+
+	for (int pairIndex = 0; pairIndex < numUnbatchedPairs; ++pairIndex)
+	{
+		m_unbatchedOrder[typePairStarts[m_unbatchedTypePairs[pairIndex]]++] = pairIndex;
+	}
+
+	bool outOfContacts = false;
+	for (int orderIndex = 0; orderIndex < numUnbatchedPairs; ++orderIndex)
+	{
+		if (m_numNewContacts >= m_maxContacts)
+		{
+			ConsoleWarningf("CollisionDetector ran out of room for contacts!");
+			outOfContacts = true;
+			break;
+		}
+
+		int pairIndex = m_unbatchedOrder[orderIndex];
+		m_numNewContacts += m_detector.GenerateContacts(m_unbatchedColliders[0][pairIndex], m_unbatchedColliders[1][pairIndex], m_newContacts.data() + m_numNewContacts, m_maxContacts - m_numNewContacts);
+	}
+
+	for (int batchIndex = 0; batchIndex < CollisionDetector::NUM_BATCH_KERNELS; ++batchIndex)
+	{
+		m_numNewContacts += m_detector.GenerateContactsBatch(batchIndex, m_batchedColliders[batchIndex][0].data(), m_batchedColliders[batchIndex][1].data(), m_numBatchedPairs[batchIndex], m_newContacts.data() + m_numNewContacts, m_maxContacts - m_numNewContacts);
+		m_numBatchedPairs[batchIndex] = 0;
+	}
+
+	if (!outOfContacts && m_numNewContacts >= m_maxContacts)
+	{
+		ConsoleWarningf("CollisionDetector ran out of room for contacts!");
+	}
+}
+
+
+//-------------------------------------------------------------------------------------------------
+template <class BoundingVolumeClass>
+void CollisionScene<BoundingVolumeClass>::ResolveContacts(float deltaSeconds)
+{
+	if (m_numNewContacts > 0)
+	{	
+		m_resolver.SetMaxVelocityIterations(Min(m_defaultNumVelocityIterations, 2 * m_numNewContacts));
+		m_resolver.SetMaxPenetrationIterations(Min(m_defaultNumPenetrationIterations, 2 * m_numNewContacts));
+		uint64 startHPC = GetPerformanceCounter();
+		m_resolver.ResolveContacts(m_newContacts.data(), m_numNewContacts, deltaSeconds);
+		m_stepTimings.m_solveSeconds += TimeSystem::PerformanceCountToSeconds(GetPerformanceCounter() - startHPC);
+	}
+}
+
+
+//-------------------------------------------------------------------------------------------------
+template <class BoundingVolumeClass>
+void CollisionScene<BoundingVolumeClass>::UpdateTriggerEvents()
+{
+	m_triggerEvents.clear();
+
+	std::sort(m_currTriggerPairs.begin(), m_currTriggerPairs.end());
+	m_currTriggerPairs.erase(std::unique(m_currTriggerPairs.begin(), m_currTriggerPairs.end()), m_currTriggerPairs.end());
+
+	// Both lists are sorted, so walk them together to find what started, continued, and stopped
+	int currIndex = 0;
+	int prevIndex = 0;
+	int numCurr = (int)m_currTriggerPairs.size();
+	int numPrev = (int)m_prevTriggerPairs.size();
+
+	while (currIndex < numCurr || prevIndex < numPrev)
+	{
+		TriggerEvent triggerEvent;
+
+		if (prevIndex >= numPrev || (currIndex < numCurr && m_currTriggerPairs[currIndex] < m_prevTriggerPairs[prevIndex]))
+		{
+			triggerEvent.trigger = m_currTriggerPairs[currIndex].trigger;
+			triggerEvent.other = m_currTriggerPairs[currIndex].other;
+			triggerEvent.type = TRIGGER_EVENT_ENTER;
+			currIndex++;
+		}
+		else if (currIndex >= numCurr || m_prevTriggerPairs[prevIndex] < m_currTriggerPairs[currIndex])
+		{
+			triggerEvent.trigger = m_prevTriggerPairs[prevIndex].trigger;
+			triggerEvent.other = m_prevTriggerPairs[prevIndex].other;
+			triggerEvent.type = TRIGGER_EVENT_EXIT;
+			prevIndex++;
+		}
+		else
+		{
+			triggerEvent.trigger = m_currTriggerPairs[currIndex].trigger;
+			triggerEvent.other = m_currTriggerPairs[currIndex].other;
+			triggerEvent.type = TRIGGER_EVENT_STAY;
+			currIndex++;
+			prevIndex++;
+		}
+
+		m_triggerEvents.push_back(triggerEvent);
+	}
+
+	m_prevTriggerPairs.swap(m_currTriggerPairs);
+
+	// One event for the whole step instead of one per pair
+	if (m_triggerEvents.size() > 0)
+	{
+		NamedProperties args;
+		args.Set("trigger-events", (void*)m_triggerEvents.data());
+		args.Set("trigger-event-count", (int)m_triggerEvents.size());
+
+		FireEvent("collision-trigger-events", args);
+	}
+}
+
+
+//-------------------------------------------------------------------------------------------------
+template <class BoundingVolumeClass>
+void CollisionScene<BoundingVolumeClass>::DebugDrawBoundingVolumeHierarchy() const
+{
+	if (m_boundingTreeRoot != nullptr)
+	{
+		m_boundingTreeRoot->DebugRender();
+	}
+
+	if (m_staticTreeRoot != nullptr)
+	{
+		m_staticTreeRoot->DebugRender();
+	}
+}
+
+
+//-------------------------------------------------------------------------------------------------
+template <class BoundingVolumeClass>
+void CollisionScene<BoundingVolumeClass>::DebugDrawLeafBoundingVolumes() const
+{
+	for (BVHNode<BoundingVolumeClass>* leaf : m_leaves)
+	{
+		leaf->m_boundingVolumeWs.DebugRender();
+	}
+
+	for (BVHNode<BoundingVolumeClass>* leaf : m_staticLeaves)
+	{
+		leaf->m_boundingVolumeWs.DebugRender();
+	}
+}
+
+
+//-------------------------------------------------------------------------------------------------
+template <class BoundingVolumeClass>
+CollisionScene<BoundingVolumeClass>::~CollisionScene()
+{
+	ASSERT_OR_DIE(m_boundingTreeRoot == nullptr, "Tree wasn't cleaned up before deleting!");
+	ASSERT_OR_DIE(m_leaves.size() == 0, "Levaes weren't cleaned up properly!");
+	ASSERT_OR_DIE(m_staticLeaves.size() == 0, "Static leaves weren't cleaned up properly!");
+}
+
+
+//-------------------------------------------------------------------------------------------------
+template <class BoundingVolumeClass>
+void CollisionScene<BoundingVolumeClass>::AddEntity(Entity* entity)
+{
+	ASSERT_OR_DIE(entity != nullptr, "Null entity!");
+	ASSERT_OR_DIE(entity->collider != nullptr, "Null collider!");
+
+	m_entities.push_back(entity);
+
+	if (entity->collider->IsOfType<HalfSpaceCollider>())
+	{
+		m_halfSpaces.push_back(entity->collider->GetAsType<HalfSpaceCollider>());
+	}
+	else if (entity->collider->IsOfType<PlaneCollider>())
+	{
+		m_planes.push_back(entity->collider->GetAsType<PlaneCollider>());
+	}
+	else if (IsEntityStatic(entity))
+	{
+		// Rebuilt now so queries see it before the next step - AddEntities() only builds once for many
+		m_staticLeaves.push_back(MakeLeafNodeForEntity(entity));
+		RebuildStaticBVH();
+	}
+	else
+	{
+		InsertDynamicLeaf(MakeLeafNodeForEntity(entity));
+	}
+
+	// Ensure we create the debug draw for the collider
+	if (AreBitsSet(m_debugFlags, COLLISION_DEBUG_COLLIDERS))
+	{
+		entity->collider->ShowDebug();
+	}
+}
+
+
+//-------------------------------------------------------------------------------------------------
+template <class BoundingVolumeClass>
+void CollisionScene<BoundingVolumeClass>::AddEntities(const std::vector<Entity*>& entities)
+{
+	bool addedDynamic = false;
+	bool addedStatic = false;
+
+	for (Entity* entity : entities)
+	{
+		ASSERT_OR_DIE(entity != nullptr, "Null entity!");
+		ASSERT_OR_DIE(entity->collider != nullptr, "Null collider!");
+
+		if (entity->collider->IsOfType<HalfSpaceCollider>() || entity->collider->IsOfType<PlaneCollider>())
+		{
+			AddEntity(entity);
+			continue;
+		}
+
+		m_entities.push_back(entity);
+
+		if (IsEntityStatic(entity))
+		{
+			m_staticLeaves.push_back(MakeLeafNodeForEntity(entity));
+			addedStatic = true;
+		}
+		else
+		{
+			m_leaves.push_back(MakeLeafNodeForEntity(entity));
+			addedDynamic = true;
+		}
+
+		if (AreBitsSet(m_debugFlags, COLLISION_DEBUG_COLLIDERS))
+		{
+			entity->collider->ShowDebug();
+		}
+	}
+
+	// Build the trees from scratch, including anything that was already in them
+	if (addedDynamic)
+	{
+		RebuildBVH();
+	}
+
+	if (addedStatic)
+	{
+		RebuildStaticBVH();
+	}
+}
+
+
+//-------------------------------------------------------------------------------------------------
+template <class BoundingVolumeClass>
+void CollisionScene<BoundingVolumeClass>::RemoveAllEntities()
+{
+	if (m_boundingTreeRoot != nullptr)
+	{
+		DeleteInternalNodes(m_boundingTreeRoot);
+		m_boundingTreeRoot = nullptr;
+	}
+
+	DeleteStaticTree();
+
+	for (BVHNode<BoundingVolumeClass>* leaf : m_leaves)
+	{
+		delete leaf;
+	}
+
+	for (BVHNode<BoundingVolumeClass>* leaf : m_staticLeaves)
+	{
+		delete leaf;
+	}
+
+	m_entities.clear();
+	m_leaves.clear();
+	m_staticLeaves.clear();
+	m_halfSpaces.clear();
+	m_planes.clear();
+	m_prevTriggerPairs.clear();
+
+	m_isStaticTreeDirty = false;
+	m_bvhBaselineCost = -1.f;
+}
+
+
+//-------------------------------------------------------------------------------------------------
+template <class BoundingVolumeClass>
+void CollisionScene<BoundingVolumeClass>::RemoveEntity(Entity* entity)
+{
+	ASSERT_OR_DIE(entity != nullptr, "Null entity!");
+	ASSERT_OR_DIE(entity->collider != nullptr, "Null collider!");
+
+	m_entities.erase(std::remove(m_entities.begin(), m_entities.end(), entity), m_entities.end());
+
+	// Drop any overlaps involving this collider without sending exits, as it won't exist to receive them
+	const Collider* collider = entity->collider;
+	m_prevTriggerPairs.erase(std::remove_if(m_prevTriggerPairs.begin(), m_prevTriggerPairs.end(),
+		[collider](const TriggerPair& pair) { return pair.trigger == collider || pair.other == collider; }), m_prevTriggerPairs.end());
+
+	if (entity->collider->IsOfType<HalfSpaceCollider>())
+	{
+		for (int i = 0; i < m_halfSpaces.size(); ++i)
+		{
+			if (m_halfSpaces[i] == entity->collider)
+			{
+				m_halfSpaces.erase(m_halfSpaces.begin() + i);
+				break;
+			}
+		}
+	}
+	else if (entity->collider->IsOfType<PlaneCollider>())
+	{
+		for (int i = 0; i < m_planes.size(); ++i)
+		{
+			if (m_planes[i] == entity->collider)
+			{
+				m_planes.erase(m_planes.begin() + i);
+				break;
+			}
+		}
+	}
+	else if (BVHNode<BoundingVolumeClass>* staticNode = GetAndEraseLeafNodeForEntity(entity, m_staticLeaves))
+	{
+		// The old tree references the leaf, so it comes down first - rebuilt straight away so queries don't miss the rest of the static geometry
+		DeleteStaticTree();
+		SAFE_DELETE(staticNode);
+		RebuildStaticBVH();
+	}
+	else
+	{
+		BVHNode<BoundingVolumeClass>* node = GetAndEraseLeafNodeForEntity(entity, m_leaves);
+		ASSERT_OR_DIE(node != nullptr, "Entity isn't in the collision scene!");
+
+		UnlinkDynamicLeaf(node);
+		SAFE_DELETE(node);
+	}
+}
+
+
+//-------------------------------------------------------------------------------------------------
+template <class BoundingVolumeClass>
+void CollisionScene<BoundingVolumeClass>::DoCollisionStep(float deltaSeconds)
+{
+	DetectContacts();
+	ResolveContacts(deltaSeconds);
+	FinishCollisionStep();
+}
+
+
+//-------------------------------------------------------------------------------------------------
+template <class BoundingVolumeClass>
+void CollisionScene<BoundingVolumeClass>::DetectContacts()
+{
+	// Ensure the BVH is up to date, then get the potential collisions
+	uint64 startHPC = GetPerformanceCounter();
+	UpdateBVH();
+	PerformBroadphase();
+
+	uint64 broadphaseEndHPC = GetPerformanceCounter();
+	GenerateContacts();
+
+	m_stepTimings.m_broadphaseSeconds += TimeSystem::PerformanceCountToSeconds(broadphaseEndHPC - startHPC);
+	m_stepTimings.m_narrowphaseSeconds += TimeSystem::PerformanceCountToSeconds(GetPerformanceCounter() - broadphaseEndHPC);
+}
+
+
+//-------------------------------------------------------------------------------------------------
+// Reuses the contacts from DetectContacts() for every substep, the resolver re-evaluates them as the bodies move
+template <class BoundingVolumeClass>
+void CollisionScene<BoundingVolumeClass>::ResolveContactsSubstep(float substepSeconds, bool isFirstSubstep)
+{
+	uint64 startHPC = GetPerformanceCounter();
+
+	if (isFirstSubstep)
+	{
+		m_resolver.BeginSubsteps(m_newContacts.data(), m_numNewContacts);
+	}
+
+	if (m_numNewContacts > 0)
+	{
+		m_resolver.ResolveContactsSubstep(m_newContacts.data(), m_numNewContacts, substepSeconds);
+	}
+
+	m_stepTimings.m_solveSeconds += TimeSystem::PerformanceCountToSeconds(GetPerformanceCounter() - startHPC);
+}
+
+
+//-------------------------------------------------------------------------------------------------
+template <class BoundingVolumeClass>
+void CollisionScene<BoundingVolumeClass>::FinishCollisionStep()
+{
+	UpdateTriggerEvents();
+
+	// Debug
+	if (AreBitsSet(m_debugFlags, COLLISION_DEBUG_CONTACTS))
+	{
+		DebugDrawContacts();
+	}
+
+	if (AreBitsSet(m_debugFlags, COLLISION_DEBUG_BOUNDING_VOLUMES))
+	{
+		DebugDrawBoundingVolumeHierarchy();
+	}
+	else if (AreBitsSet(m_debugFlags, COLLISION_DEBUG_LEAF_BOUNDING_VOLUMES))
+	{
+		DebugDrawLeafBoundingVolumes();
+	}
+}
+
+
+//-------------------------------------------------------------------------------------------------
+template <class BoundingVolumeClass>
+void CollisionScene<BoundingVolumeClass>::UpdateNode(BVHNode<BoundingVolumeClass>* node, const BoundingVolumeClass& newVolume)
+{
+	if (node->m_parent != nullptr)
+	{
+		// Remove the node from the tree, recursively updating bounding volumes
+		BVHNode<BoundingVolumeClass>* newRoot = node->RemoveSelf();
 		if (newRoot != nullptr)
 		{
 			m_boundingTreeRoot = newRoot;
@@ -537,16 +1918,16 @@ void CollisionScene<BoundingVolumeClass>::UpdateNode(BVHNode<BoundingVolumeClass
 
 //-------------------------------------------------------------------------------------------------
 template <class BoundingVolumeClass>
-BVHNode<BoundingVolumeClass>* CollisionScene<BoundingVolumeClass>::GetAndEraseLeafNodeForEntity(Entity* entity)
+BVHNode<BoundingVolumeClass>* CollisionScene<BoundingVolumeClass>::GetAndEraseLeafNodeForEntity(Entity* entity, std::vector<BVHNode<BoundingVolumeClass>*>& leaves)
 {
 	BVHNode<BoundingVolumeClass>* node = nullptr;
 
-	for (int i = 0; i < (int)m_leaves.size(); ++i)
+	for (int i = 0; i < (int)leaves.size(); ++i)
 	{
-		if (m_leaves[i]->m_entity == entity)
+		if (leaves[i]->m_entity == entity)
 		{
-			node = m_leaves[i];
-			m_leaves.erase(m_leaves.begin() + i);
+			node = leaves[i];
+			leaves.erase(leaves.begin() + i);
 			break;
 		}
 	}
@@ -554,6 +1935,14 @@ BVHNode<BoundingVolumeClass>* CollisionScene<BoundingVolumeClass>::GetAndEraseLe
 	return node;
 }
 
+
+//-------------------------------------------------------------------------------------------------
+template <class BoundingVolumeClass>
+bool CollisionScene<BoundingVolumeClass>::IsEntityStatic(const Entity* entity) const
+{
+	return (entity->rigidBody == nullptr || entity->rigidBody->IsStatic());
+}
+
 ///--------------------------------------------------------------------------------------------------------------------------------------------------
 /// C FUNCTIONS
 ///--------------------------------------------------------------------------------------------------------------------------------------------------
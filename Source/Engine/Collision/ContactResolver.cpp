@@ -11,13 +11,17 @@
 #include "Engine/Collision/ContactResolver.h"
 #include "Engine/Core/DevConsole.h"
 #include "Engine/Core/EngineCommon.h"
+#include "Engine/Job/JobSystem.h"
 #include "Engine/Math/MathUtils.h"
 #include "Engine/Math/Quaternion.h"
 #include "Engine/Physics/RigidBody/RigidBody.h"
+#include <algorithm>
+#include <atomic>
 
 ///--------------------------------------------------------------------------------------------------------------------------------------------------
 /// DEFINES
 ///--------------------------------------------------------------------------------------------------------------------------------------------------
+#define NO_HEAP_KEY (-FLT_MAX)
 
 ///--------------------------------------------------------------------------------------------------------------------------------------------------
 /// ENUMS, TYPEDEFS, STRUCTS, FORWARD DECLARATIONS
@@ -104,6 +108,14 @@ static void ResolveContactPenetration(Contact* contact, Vector3* out_linearChang
 	// Loop through again calculating and applying the changes
 	for (unsigned i = 0; i < 2; i++) if (contact->bodies[i])
 	{
+		// Static bodies never move - skipping them also means contacts that only share a static body never touch the same data
+		if (contact->bodies[i]->IsStatic())
+		{
+			out_linearChanges[i] = Vector3::ZERO;
+			out_angularChanges[i] = Vector3::ZERO;
+			continue;
+		}
+
 		float sign = (i == 0 ? 1.0f : -1.0f);
 
 		// Calculate the amount of linear movement from both the linear and angular components
@@ -351,8 +363,16 @@ static void ResolveContactVelocity(Contact* contact, Vector3* out_linearDeltaVel
 		ASSERT_REASONABLE(out_angularDeltaVelocities[0]);
 
 		// Apply them
-		contact->bodies[0]->AddWorldVelocity(out_linearDeltaVelocities[0]);
-		contact->bodies[0]->AddWorldAngularVelocityRadians(out_angularDeltaVelocities[0]);
+		if (contact->bodies[0]->IsStatic())
+		{
+			out_linearDeltaVelocities[0] = Vector3::ZERO;
+			out_angularDeltaVelocities[0] = Vector3::ZERO;
+		}
+		else
+		{
+			contact->bodies[0]->AddWorldVelocity(out_linearDeltaVelocities[0]);
+			contact->bodies[0]->AddWorldAngularVelocityRadians(out_angularDeltaVelocities[0]);
+		}
 	}
 
 	// Calculate second bodies velocities
@@ -374,96 +394,160 @@ static void ResolveContactVelocity(Contact* contact, Vector3* out_linearDeltaVel
 		ASSERT_REASONABLE(out_angularDeltaVelocities[1]);
 
 		// Apply them
-		contact->bodies[1]->AddWorldVelocity(out_linearDeltaVelocities[1]);
-		contact->bodies[1]->AddWorldAngularVelocityRadians(out_angularDeltaVelocities[1]);
+		if (contact->bodies[1]->IsStatic())
+		{
+			out_linearDeltaVelocities[1] = Vector3::ZERO;
+			out_angularDeltaVelocities[1] = Vector3::ZERO;
+		}
+		else
+		{
+			contact->bodies[1]->AddWorldVelocity(out_linearDeltaVelocities[1]);
+			contact->bodies[1]->AddWorldAngularVelocityRadians(out_angularDeltaVelocities[1]);
+		}
 	}
 }
 
 
 //-------------------------------------------------------------------------------------------------
-static void UpdateContactPenetrations(Contact* contacts, int numContacts, Vector3* linearChanges, Vector3* angularChanges, Contact* resolvedContact)
+static void UpdateContactPenetration(Contact* contact, const Vector3* linearChanges, const Vector3* angularChanges, const Contact* resolvedContact)
 {
-	// For each contact
-	for (int contactIndex = 0; contactIndex < numContacts; ++contactIndex)
-	{
-		Contact* contact = &contacts[contactIndex];
+	contact->CheckValuesAreReasonable();
 
-		contact->CheckValuesAreReasonable();
+	// Check each body in the contact
+	for (int bodyIndex = 0; bodyIndex < 2; ++bodyIndex)
+	{
+		RigidBody* body = contact->bodies[bodyIndex];
+		if (body == nullptr)
+			continue;
 
-		// Check each body in the contact
-		for (int bodyIndex = 0; bodyIndex < 2; ++bodyIndex)
+		// Find if this contact shares a body with the contact we just resolved
+		for (int resolvedBodyIndex = 0; resolvedBodyIndex < 2; ++resolvedBodyIndex)
 		{
-			RigidBody* body = contact->bodies[bodyIndex];
-			if (body == nullptr)
-				continue;
+			RigidBody* resolvedBody = resolvedContact->bodies[resolvedBodyIndex];
 
-			// Find if this contact shares a body with the contact we just resolved
-			for (int resolvedBodyIndex = 0; resolvedBodyIndex < 2; ++resolvedBodyIndex)
+			if (body == resolvedBody)
 			{
-				RigidBody* resolvedBody = resolvedContact->bodies[resolvedBodyIndex];
+				// If so, find and update the new penetration for this contact
+				Vector3 deltaPosition = linearChanges[resolvedBodyIndex] + CrossProduct(angularChanges[resolvedBodyIndex], contact->bodyToContact[bodyIndex]);
+				ASSERT_REASONABLE(deltaPosition);
 
-				if (body == resolvedBody)
-				{
-					// If so, find and update the new penetration for this contact
-					Vector3 deltaPosition = linearChanges[resolvedBodyIndex] + CrossProduct(angularChanges[resolvedBodyIndex], contact->bodyToContact[bodyIndex]);
-					ASSERT_REASONABLE(deltaPosition);
-
-					float sign = (bodyIndex == 1 ? 1.f : -1.0f); // If we're body A, any movement along this normal would reduce this penetration, so negative sign. If we're body B, any movement along the normal makes the penetration worse.
-					contact->penetration += sign * DotProduct(deltaPosition, contact->normal);
+				float sign = (bodyIndex == 1 ? 1.f : -1.0f); // If we're body A, any movement along this normal would reduce this penetration, so negative sign. If we're body B, any movement along the normal makes the penetration worse.
+				contact->penetration += sign * DotProduct(deltaPosition, contact->normal);
 
-					// TODO: Is this needed?
-					contact->position += deltaPosition;
-					contact->bodyToContact[0] = contact->position - contact->bodies[0]->transform->position;
-					if (contact->bodies[1] != nullptr)
-					{
-						contact->bodyToContact[1] = contact->position - contact->bodies[1]->transform->position;
-					}
+				// TODO: Is this needed?
+				contact->position += deltaPosition;
+				contact->bodyToContact[0] = contact->position - contact->bodies[0]->transform->position;
+				if (contact->bodies[1] != nullptr)
+				{
+					contact->bodyToContact[1] = contact->position - contact->bodies[1]->transform->position;
 				}
 			}
 		}
-
-		contact->CheckValuesAreReasonable();
 	}
+
+	contact->CheckValuesAreReasonable();
 }
 
 
 //-------------------------------------------------------------------------------------------------
-static void UpdateContactVelocities(Contact* contacts, int numContacts, Vector3* linearVelocityChanges, Vector3* angularVelocityChanges, Contact* resolvedContact, float deltaSeconds)
+static void UpdateContactPenetrations(Contact* contacts, int numContacts, Vector3* linearChanges, Vector3* angularChanges, Contact* resolvedContact)
 {
-	// For each contact
 	for (int contactIndex = 0; contactIndex < numContacts; ++contactIndex)
 	{
-		Contact* contact = &contacts[contactIndex];
-		contact->CheckValuesAreReasonable();
+		UpdateContactPenetration(&contacts[contactIndex], linearChanges, angularChanges, resolvedContact);
+	}
+}
 
-		// Check each body in the contact
-		for (int bodyIndex = 0; bodyIndex < 2; ++bodyIndex)
+
+//-------------------------------------------------------------------------------------------------
+static void UpdateContactVelocity(Contact* contact, const Vector3* linearVelocityChanges, const Vector3* angularVelocityChanges, const Contact* resolvedContact, float deltaSeconds)
+{
+	contact->CheckValuesAreReasonable();
+
+	// Check each body in the contact
+	for (int bodyIndex = 0; bodyIndex < 2; ++bodyIndex)
+	{
+		RigidBody* body = contact->bodies[bodyIndex];
+		if (body == nullptr)
+			continue;
+
+		// Find if this contact shares a body with the contact we just resolved
+		for (int resolvedBodyIndex = 0; resolvedBodyIndex < 2; ++resolvedBodyIndex)
 		{
-			RigidBody* body = contact->bodies[bodyIndex];
-			if (body == nullptr)
-				continue;
+			RigidBody* resolvedBody = resolvedContact->bodies[resolvedBodyIndex];
 
-			// Find if this contact shares a body with the contact we just resolved
-			for (int resolvedBodyIndex = 0; resolvedBodyIndex < 2; ++resolvedBodyIndex)
+			if (body == resolvedBody)
 			{
-				RigidBody* resolvedBody = resolvedContact->bodies[resolvedBodyIndex];
-
-				if (body == resolvedBody)
-				{
-					// If so, find and update the new penetration for this contact
-					Vector3 deltaVelocityWs = linearVelocityChanges[resolvedBodyIndex] + CrossProduct(angularVelocityChanges[resolvedBodyIndex], contact->bodyToContact[bodyIndex]);
-					float sign = (bodyIndex == 1 ? -1.f : 1.f); // From the perspective of A
-					
-					Vector3 deltaVelocityContactSpace = contact->contactToWorld.GetTranspose() * deltaVelocityWs;
-					contact->closingVelocityContactSpace += sign * deltaVelocityContactSpace;
-
-					// Recalculate the desired velocity
-					contact->CalculateDesiredVelocityInContactSpace(deltaSeconds);
-				}
+				// If so, find and update the new penetration for this contact
+				Vector3 deltaVelocityWs = linearVelocityChanges[resolvedBodyIndex] + CrossProduct(angularVelocityChanges[resolvedBodyIndex], contact->bodyToContact[bodyIndex]);
+				float sign = (bodyIndex == 1 ? -1.f : 1.f); // From the perspective of A
+				
+				Vector3 deltaVelocityContactSpace = contact->contactToWorld.GetTranspose() * deltaVelocityWs;
+				contact->closingVelocityContactSpace += sign * deltaVelocityContactSpace;
+
+				// Recalculate the desired velocity
+				contact->CalculateDesiredVelocityInContactSpace(deltaSeconds);
 			}
 		}
+	}
 
-		contact->CheckValuesAreReasonable();
+	contact->CheckValuesAreReasonable();
+}
+
+
+//-------------------------------------------------------------------------------------------------
+static void UpdateContactVelocities(Contact* contacts, int numContacts, Vector3* linearVelocityChanges, Vector3* angularVelocityChanges, Contact* resolvedContact, float deltaSeconds)
+{
+	for (int contactIndex = 0; contactIndex < numContacts; ++contactIndex)
+	{
+		UpdateContactVelocity(&contacts[contactIndex], linearVelocityChanges, angularVelocityChanges, resolvedContact, deltaSeconds);
+	}
+}
+
+
+//-------------------------------------------------------------------------------------------------
+// Same selection as the linear scans below - resolvable, over epsilon, and the largest value wins
+static float GetPenetrationHeapKey(const Contact& contact, float penetrationEpsilon)
+{
+	return ((contact.ShouldBeResolved() && contact.penetration > penetrationEpsilon) ? contact.penetration : NO_HEAP_KEY);
+}
+
+
+//-------------------------------------------------------------------------------------------------
+static float GetVelocityHeapKey(const Contact& contact, float velocityEpsilon)
+{
+	return ((contact.ShouldBeResolved() && contact.desiredDeltaVelocityAlongNormal > velocityEpsilon) ? contact.desiredDeltaVelocityAlongNormal : NO_HEAP_KEY);
+}
+
+
+//-------------------------------------------------------------------------------------------------
+static bool CompareContactBodyLinks(const ContactBodyLink& a, const ContactBodyLink& b)
+{
+	if (a.m_body != b.m_body)
+	{
+		return std::less<RigidBody*>()(a.m_body, b.m_body);
+	}
+
+	return a.m_contactIndex < b.m_contactIndex;
+}
+
+
+//-------------------------------------------------------------------------------------------------
+// Only wakes dynamic bodies, so contacts sharing a static body can run side by side
+static void MatchAwakeStateDynamicOnly(Contact* contact)
+{
+	if (contact->bodies[1] == nullptr)
+		return;
+
+	for (int bodyIndex = 0; bodyIndex < 2; ++bodyIndex)
+	{
+		RigidBody* body = contact->bodies[bodyIndex];
+		RigidBody* otherBody = contact->bodies[1 - bodyIndex];
+
+		if (!body->IsStatic() && !body->IsAwake() && otherBody->IsAwake())
+		{
+			body->SetIsAwake(true);
+		}
 	}
 }
 
@@ -552,6 +636,604 @@ static void ResolveVelocities(Contact* contacts, int numContacts, int numIterati
 void ContactResolver::ResolveContacts(Contact* contacts, int numContacts, float deltaSeconds)
 {
 	PrepareContacts(contacts, numContacts, deltaSeconds);
-	ResolveVelocities(contacts, numContacts, m_maxVelocityIterations, m_velocityEpsilon, deltaSeconds);
-	ResolvePenetrations(contacts, numContacts, m_maxPenetrationIterations, m_penetrationEpsilon);
+
+	if (m_solverMode == CONTACT_SOLVER_PARALLEL_COLORED)
+	{
+		BuildContactGraph(contacts, numContacts);
+		ColorContacts(numContacts);
+		ResolveVelocitiesColored(contacts, deltaSeconds);
+		ResolvePenetrationsColored(contacts, numContacts);
+	}
+	else if (m_useContactGraph)
+	{
+		BuildContactGraph(contacts, numContacts);
+		ResolveVelocitiesWithGraph(contacts, numContacts, deltaSeconds);
+		ResolvePenetrationsWithGraph(contacts, numContacts);
+	}
+	else
+	{
+		ResolveVelocities(contacts, numContacts, m_maxVelocityIterations, m_velocityEpsilon, deltaSeconds);
+		ResolvePenetrations(contacts, numContacts, m_maxPenetrationIterations, m_penetrationEpsilon);
+	}
+}
+
+
+//-------------------------------------------------------------------------------------------------
+// Static bodies are left out - they never move, and linking them would make the ground adjacent to everything
+void ContactResolver::BuildContactGraph(const Contact* contacts, int numContacts)
+{
+	m_bodyLinks.clear();
+
+	for (int contactIndex = 0; contactIndex < numContacts; ++contactIndex)
+	{
+		for (int bodyIndex = 0; bodyIndex < 2; ++bodyIndex)
+		{
+			RigidBody* body = contacts[contactIndex].bodies[bodyIndex];
+			if (body != nullptr && !body->IsStatic())
+			{
+				ContactBodyLink link;
+				link.m_body = body;
+				link.m_contactIndex = contactIndex;
+				m_bodyLinks.push_back(link);
+			}
+		}
+	}
+
+	std::sort(m_bodyLinks.begin(), m_bodyLinks.end(), CompareContactBodyLinks);
+
+	m_contactLinkRanges.assign(2 * numContacts, ContactLinkRange());
+	m_contactBodySlots.assign(2 * numContacts, -1);
+	m_numBodySlots = 0;
+
+	int numLinks = (int)m_bodyLinks.size();
+	int firstLink = 0;
+	while (firstLink < numLinks)
+	{
+		RigidBody* body = m_bodyLinks[firstLink].m_body;
+
+		int endLink = firstLink + 1;
+		while (endLink < numLinks && m_bodyLinks[endLink].m_body == body)
+		{
+			endLink++;
+		}
+
+		for (int linkIndex = firstLink; linkIndex < endLink; ++linkIndex)
+		{
+			int contactIndex = m_bodyLinks[linkIndex].m_contactIndex;
+			for (int bodyIndex = 0; bodyIndex < 2; ++bodyIndex)
+			{
+				if (contacts[contactIndex].bodies[bodyIndex] == body)
+				{
+					m_contactLinkRanges[2 * contactIndex + bodyIndex].m_firstLink = firstLink;
+					m_contactLinkRanges[2 * contactIndex + bodyIndex].m_numLinks = endLink - firstLink;
+					m_contactBodySlots[2 * contactIndex + bodyIndex] = m_numBodySlots;
+				}
+			}
+		}
+
+		m_numBodySlots++;
+		firstLink = endLink;
+	}
+}
+
+
+//-------------------------------------------------------------------------------------------------
+// Fills m_neighborContacts with every contact sharing a dynamic body with the given one, including itself, each once
+void ContactResolver::GatherNeighborContacts(const Contact* contacts, int contactIndex)
+{
+	m_neighborContacts.clear();
+
+	const Contact& contact = contacts[contactIndex];
+	bool firstBodyLinked = (m_contactLinkRanges[2 * contactIndex].m_numLinks > 0);
+
+	for (int bodyIndex = 0; bodyIndex < 2; ++bodyIndex)
+	{
+		const ContactLinkRange& range = m_contactLinkRanges[2 * contactIndex + bodyIndex];
+
+		for (int linkIndex = range.m_firstLink; linkIndex < range.m_firstLink + range.m_numLinks; ++linkIndex)
+		{
+			int neighborIndex = m_bodyLinks[linkIndex].m_contactIndex;
+			const Contact& neighbor = contacts[neighborIndex];
+
+			// Contacts touching both bodies were already gathered from the first body's list
+			if (bodyIndex == 1 && firstBodyLinked && (neighbor.bodies[0] == contact.bodies[0] || neighbor.bodies[1] == contact.bodies[0]))
+				continue;
+
+			m_neighborContacts.push_back(neighborIndex);
+		}
+	}
+}
+
+
+//-------------------------------------------------------------------------------------------------
+void ContactResolver::ResolveVelocitiesWithGraph(Contact* contacts, int numContacts, float deltaSeconds)
+{
+	Vector3 linearVelocityChanges[2];
+	Vector3 angularVelocityChanges[2];
+
+	m_heapKeys.resize(numContacts);
+	for (int contactIndex = 0; contactIndex < numContacts; ++contactIndex)
+	{
+		m_heapKeys[contactIndex] = GetVelocityHeapKey(contacts[contactIndex], m_velocityEpsilon);
+	}
+
+	BuildHeap(numContacts);
+
+	for (int iteration = 0; iteration < m_maxVelocityIterations; ++iteration)
+	{
+		if (numContacts == 0 || m_heapKeys[m_heap[0]] == NO_HEAP_KEY)
+			break;
+
+		int contactIndex = m_heap[0];
+		Contact* contactToResolve = &contacts[contactIndex];
+
+		contactToResolve->CheckValuesAreReasonable();
+		contactToResolve->MatchAwakeState();
+
+		ResolveContactVelocity(contactToResolve, linearVelocityChanges, angularVelocityChanges);
+
+		// Waking a body only changes contacts that touch it, which are all neighbors here
+		GatherNeighborContacts(contacts, contactIndex);
+		for (int neighborIndex : m_neighborContacts)
+		{
+			UpdateContactVelocity(&contacts[neighborIndex], linearVelocityChanges, angularVelocityChanges, contactToResolve, deltaSeconds);
+			SetHeapKey(neighborIndex, GetVelocityHeapKey(contacts[neighborIndex], m_velocityEpsilon));
+		}
+	}
+}
+
+
+//-------------------------------------------------------------------------------------------------
+void ContactResolver::ResolvePenetrationsWithGraph(Contact* contacts, int numContacts)
+{
+	m_heapKeys.resize(numContacts);
+	for (int contactIndex = 0; contactIndex < numContacts; ++contactIndex)
+	{
+		m_heapKeys[contactIndex] = GetPenetrationHeapKey(contacts[contactIndex], m_penetrationEpsilon);
+	}
+
+	BuildHeap(numContacts);
+
+	for (int iteration = 0; iteration < m_maxPenetrationIterations; ++iteration)
+	{
+		if (numContacts == 0 || m_heapKeys[m_heap[0]] == NO_HEAP_KEY)
+			break;
+
+		int contactIndex = m_heap[0];
+		Contact* contactToResolve = &contacts[contactIndex];
+
+		Vector3 linearChanges[2];
+		Vector3 angularChanges[2];
+
+		contactToResolve->CheckValuesAreReasonable();
+		contactToResolve->MatchAwakeState();
+
+		ResolveContactPenetration(contactToResolve, linearChanges, angularChanges);
+
+		GatherNeighborContacts(contacts, contactIndex);
+		for (int neighborIndex : m_neighborContacts)
+		{
+			UpdateContactPenetration(&contacts[neighborIndex], linearChanges, angularChanges, contactToResolve);
+			SetHeapKey(neighborIndex, GetPenetrationHeapKey(contacts[neighborIndex], m_penetrationEpsilon));
+		}
+	}
+}
+
+
+//-------------------------------------------------------------------------------------------------
+// Expects m_heapKeys to already be filled in for every contact
+void ContactResolver::BuildHeap(int numContacts)
+{
+	m_heap.resize(numContacts);
+	m_heapPositions.resize(numContacts);
+
+	for (int contactIndex = 0; contactIndex < numContacts; ++contactIndex)
+	{
+		m_heap[contactIndex] = contactIndex;
+		m_heapPositions[contactIndex] = contactIndex;
+	}
+
+	for (int heapIndex = (numContacts / 2) - 1; heapIndex >= 0; --heapIndex)
+	{
+		SiftDown(heapIndex);
+	}
+}
+
+
+//-------------------------------------------------------------------------------------------------
+void ContactResolver::SetHeapKey(int contactIndex, float key)
+{
+	float oldKey = m_heapKeys[contactIndex];
+	m_heapKeys[contactIndex] = key;
+
+	if (key > oldKey)
+	{
+		SiftUp(m_heapPositions[contactIndex]);
+	}
+	else if (key < oldKey)
+	{
+		SiftDown(m_heapPositions[contactIndex]);
+	}
+}
+
+
+//-------------------------------------------------------------------------------------------------
+// Ties go to the lower contact index, which is what the linear scan picks
+bool ContactResolver::IsHigherPriority(int firstContactIndex, int secondContactIndex) const
+{
+	float firstKey = m_heapKeys[firstContactIndex];
+	float secondKey = m_heapKeys[secondContactIndex];
+
+	if (firstKey != secondKey)
+	{
+		return firstKey > secondKey;
+	}
+
+	return firstContactIndex < secondContactIndex;
+}
+
+
+//-------------------------------------------------------------------------------------------------
+void ContactResolver::SwapHeapEntries(int firstHeapIndex, int secondHeapIndex)
+{
+	int firstContactIndex = m_heap[firstHeapIndex];
+	int secondContactIndex = m_heap[secondHeapIndex];
+
+	m_heap[firstHeapIndex] = secondContactIndex;
+	m_heap[secondHeapIndex] = firstContactIndex;
+	m_heapPositions[firstContactIndex] = secondHeapIndex;
+	m_heapPositions[secondContactIndex] = firstHeapIndex;
+}
+
+
+//-------------------------------------------------------------------------------------------------
+void ContactResolver::SiftUp(int heapIndex)
+{
+	while (heapIndex > 0)
+	{
+		int parentIndex = (heapIndex - 1) / 2;
+		if (!IsHigherPriority(m_heap[heapIndex], m_heap[parentIndex]))
+			break;
+
+		SwapHeapEntries(heapIndex, parentIndex);
+		heapIndex = parentIndex;
+	}
+}
+
+
+//-------------------------------------------------------------------------------------------------
+void ContactResolver::SiftDown(int heapIndex)
+{
+	int heapSize = (int)m_heap.size();
+
+	while (true)
+	{
+		int bestIndex = heapIndex;
+		int leftIndex = 2 * heapIndex + 1;
+		int rightIndex = leftIndex + 1;
+
+		if (leftIndex < heapSize && IsHigherPriority(m_heap[leftIndex], m_heap[bestIndex]))
+		{
+			bestIndex = leftIndex;
+		}
+
+		if (rightIndex < heapSize && IsHigherPriority(m_heap[rightIndex], m_heap[bestIndex]))
+		{
+			bestIndex = rightIndex;
+		}
+
+		if (bestIndex == heapIndex)
+			break;
+
+		SwapHeapEntries(heapIndex, bestIndex);
+		heapIndex = bestIndex;
+	}
+}
+
+
+//-------------------------------------------------------------------------------------------------
+// Greedy coloring in contact order - it only depends on the contacts, so the solve comes out the same for any thread count
+void ContactResolver::ColorContacts(int numContacts)
+{
+	m_slotColorMasks.assign(m_numBodySlots, 0);
+	m_contactColors.resize(numContacts);
+	m_colorOffsets.assign(MAX_CONTACT_COLORS + 1, 0);
+	m_numColors = 0;
+
+	const int overflowColor = MAX_CONTACT_COLORS - 1;
+
+	for (int contactIndex = 0; contactIndex < numContacts; ++contactIndex)
+	{
+		int slotA = m_contactBodySlots[2 * contactIndex];
+		int slotB = m_contactBodySlots[2 * contactIndex + 1];
+
+		uint64 usedColors = 0;
+		if (slotA >= 0) { usedColors |= m_slotColorMasks[slotA]; }
+		if (slotB >= 0) { usedColors |= m_slotColorMasks[slotB]; }
+
+		int color = 0;
+		while (color < overflowColor && (usedColors & (1ULL << color)) != 0)
+		{
+			color++;
+		}
+
+		// The overflow color is solved on one thread, so it doesn't need to be marked as used
+		if (color < overflowColor)
+		{
+			if (slotA >= 0) { m_slotColorMasks[slotA] |= (1ULL << color); }
+			if (slotB >= 0) { m_slotColorMasks[slotB] |= (1ULL << color); }
+		}
+
+		m_contactColors[contactIndex] = color;
+		m_colorOffsets[color + 1]++;
+		m_numColors = Max(m_numColors, color + 1);
+	}
+
+	// Counting sort, keeping contact order within each color
+	for (int colorIndex = 0; colorIndex < MAX_CONTACT_COLORS; ++colorIndex)
+	{
+		m_colorOffsets[colorIndex + 1] += m_colorOffsets[colorIndex];
+	}
+
+	m_colorOrder.resize(numContacts);
+	m_colorWriteOffsets.assign(m_colorOffsets.begin(), m_colorOffsets.end() - 1);
+
+	for (int contactIndex = 0; contactIndex < numContacts; ++contactIndex)
+	{
+		m_colorOrder[m_colorWriteOffsets[m_contactColors[contactIndex]]++] = contactIndex;
+	}
+}
+
+
+//-------------------------------------------------------------------------------------------------
+void ContactResolver::ForEachContactInColor(int colorIndex, const std::function<void(int contactIndex)>& function)
+{
+	int firstContact = m_colorOffsets[colorIndex];
+	int numContacts = m_colorOffsets[colorIndex + 1] - firstContact;
+
+	auto processRange = [this, firstContact, &function](int startIndex, int endIndex)
+	{
+		for (int orderIndex = firstContact + startIndex; orderIndex < firstContact + endIndex; ++orderIndex)
+		{
+			function(m_colorOrder[orderIndex]);
+		}
+	};
+
+	bool isOverflowColor = (colorIndex == MAX_CONTACT_COLORS - 1);
+	if (m_useJobSystem && g_jobSystem != nullptr && !isOverflowColor)
+	{
+		g_jobSystem->ParallelFor(numContacts, MIN_CONTACTS_PER_BATCH, processRange);
+	}
+	else
+	{
+		processRange(0, numContacts);
+	}
+}
+
+
+//-------------------------------------------------------------------------------------------------
+// Each pass resolves every contact once, color by color, instead of only the worst one per iteration
+void ContactResolver::ResolveVelocitiesColored(Contact* contacts, float deltaSeconds)
+{
+	for (int pass = 0; pass < m_maxVelocityIterations; ++pass)
+	{
+		std::atomic<bool> anyResolved(false);
+
+		for (int colorIndex = 0; colorIndex < MAX_CONTACT_COLORS; ++colorIndex)
+		{
+			if (m_colorOffsets[colorIndex] == m_colorOffsets[colorIndex + 1])
+				continue;
+
+			ForEachContactInColor(colorIndex, [&](int contactIndex)
+			{
+				Contact* contact = &contacts[contactIndex];
+
+				if (!contact->ShouldBeResolved())
+					return;
+
+				// Earlier colors may have changed this contact's bodies, so start from their current velocities
+				contact->CalculateClosingVelocityInContactSpace(deltaSeconds);
+				contact->CalculateDesiredVelocityInContactSpace(deltaSeconds);
+
+				if (contact->desiredDeltaVelocityAlongNormal <= m_velocityEpsilon)
+					return;
+
+				Vector3 linearVelocityChanges[2];
+				Vector3 angularVelocityChanges[2];
+
+				contact->CheckValuesAreReasonable();
+				MatchAwakeStateDynamicOnly(contact);
+				ResolveContactVelocity(contact, linearVelocityChanges, angularVelocityChanges);
+
+				anyResolved.store(true, std::memory_order_relaxed);
+			});
+		}
+
+		if (!anyResolved.load())
+			break;
+	}
+}
+
+
+//-------------------------------------------------------------------------------------------------
+// Penetrations are tracked as the starting value plus the accumulated movement of each contact's bodies,
+// so a contact only ever reads the slots of its own bodies
+void ContactResolver::ResolvePenetrationsColored(Contact* contacts, int numContacts)
+{
+	m_initialPenetrations.resize(numContacts);
+	for (int contactIndex = 0; contactIndex < numContacts; ++contactIndex)
+	{
+		m_initialPenetrations[contactIndex] = contacts[contactIndex].penetration;
+	}
+
+	m_slotLinearChanges.assign(m_numBodySlots, Vector3::ZERO);
+	m_slotAngularChanges.assign(m_numBodySlots, Vector3::ZERO);
+
+	for (int pass = 0; pass < m_maxPenetrationIterations; ++pass)
+	{
+		std::atomic<bool> anyResolved(false);
+
+		for (int colorIndex = 0; colorIndex < MAX_CONTACT_COLORS; ++colorIndex)
+		{
+			if (m_colorOffsets[colorIndex] == m_colorOffsets[colorIndex + 1])
+				continue;
+
+			ForEachContactInColor(colorIndex, [&](int contactIndex)
+			{
+				Contact* contact = &contacts[contactIndex];
+
+				if (!contact->ShouldBeResolved())
+					return;
+
+				// Same sign convention as UpdateContactPenetration() - A moving along the normal reduces penetration, B moving along it adds to it
+				float penetration = m_initialPenetrations[contactIndex];
+				for (int bodyIndex = 0; bodyIndex < 2; ++bodyIndex)
+				{
+					int slot = m_contactBodySlots[2 * contactIndex + bodyIndex];
+					if (slot < 0)
+						continue;
+
+					Vector3 deltaPosition = m_slotLinearChanges[slot] + CrossProduct(m_slotAngularChanges[slot], contact->bodyToContact[bodyIndex]);
+					float sign = (bodyIndex == 1 ? 1.f : -1.0f);
+					penetration += sign * DotProduct(deltaPosition, contact->normal);
+				}
+
+				contact->penetration = penetration;
+
+				if (penetration <= m_penetrationEpsilon)
+					return;
+
+				Vector3 linearChanges[2];
+				Vector3 angularChanges[2];
+
+				contact->CheckValuesAreReasonable();
+				MatchAwakeStateDynamicOnly(contact);
+				ResolveContactPenetration(contact, linearChanges, angularChanges);
+
+				for (int bodyIndex = 0; bodyIndex < 2; ++bodyIndex)
+				{
+					int slot = m_contactBodySlots[2 * contactIndex + bodyIndex];
+					if (slot >= 0)
+					{
+						m_slotLinearChanges[slot] += linearChanges[bodyIndex];
+						m_slotAngularChanges[slot] += angularChanges[bodyIndex];
+					}
+				}
+
+				anyResolved.store(true, std::memory_order_relaxed);
+			});
+		}
+
+		if (!anyResolved.load())
+			break;
+	}
+}
+
+
+//-------------------------------------------------------------------------------------------------
+// Pins the contact point to each body, so later substeps can tell how far the bodies moved relative to each other
+void ContactResolver::BeginSubsteps(const Contact* contacts, int numContacts)
+{
+	m_substepInitialPenetrations.resize(numContacts);
+	m_substepInitialPositions.resize(numContacts);
+	m_substepContactPointsLs.resize(2 * numContacts);
+
+	for (int contactIndex = 0; contactIndex < numContacts; ++contactIndex)
+	{
+		const Contact& contact = contacts[contactIndex];
+		m_substepInitialPenetrations[contactIndex] = contact.penetration;
+		m_substepInitialPositions[contactIndex] = contact.position;
+
+		for (int bodyIndex = 0; bodyIndex < 2; ++bodyIndex)
+		{
+			RigidBody* body = contact.bodies[bodyIndex];
+			m_substepContactPointsLs[2 * contactIndex + bodyIndex] = (body != nullptr ? body->transform->InverseTransformPosition(contact.position) : contact.position);
+		}
+	}
+}
+
+
+//-------------------------------------------------------------------------------------------------
+// One velocity pass and one penetration pass, in contact order, each contact seeing the changes made by the ones before it
+// Meant to be called several times per step with a small dt and integration in between, instead of many iterations once
+void ContactResolver::ResolveContactsSubstep(Contact* contacts, int numContacts, float substepSeconds)
+{
+	ASSERT_OR_DIE((int)m_substepInitialPenetrations.size() >= numContacts, "Substepping contacts that weren't passed to BeginSubsteps()!");
+
+	for (int contactIndex = 0; contactIndex < numContacts; ++contactIndex)
+	{
+		ReevaluateSubstepContact(&contacts[contactIndex], contactIndex);
+	}
+
+	PrepareContacts(contacts, numContacts, substepSeconds);
+
+	for (int contactIndex = 0; contactIndex < numContacts; ++contactIndex)
+	{
+		Contact* contact = &contacts[contactIndex];
+
+		if (!contact->ShouldBeResolved())
+			continue;
+
+		contact->CalculateClosingVelocityInContactSpace(substepSeconds);
+		contact->CalculateDesiredVelocityInContactSpace(substepSeconds);
+
+		if (contact->desiredDeltaVelocityAlongNormal <= m_velocityEpsilon)
+			continue;
+
+		Vector3 linearVelocityChanges[2];
+		Vector3 angularVelocityChanges[2];
+
+		MatchAwakeStateDynamicOnly(contact);
+		ResolveContactVelocity(contact, linearVelocityChanges, angularVelocityChanges);
+	}
+
+	for (int contactIndex = 0; contactIndex < numContacts; ++contactIndex)
+	{
+		Contact* contact = &contacts[contactIndex];
+
+		if (!contact->ShouldBeResolved())
+			continue;
+
+		ReevaluateSubstepContact(contact, contactIndex);
+		contact->bodyToContact[0] = contact->position - contact->bodies[0]->GetCenterOfMassWs();
+		if (contact->bodies[1] != nullptr)
+		{
+			contact->bodyToContact[1] = contact->position - contact->bodies[1]->GetCenterOfMassWs();
+		}
+
+		if (contact->penetration <= m_penetrationEpsilon)
+			continue;
+
+		Vector3 linearChanges[2];
+		Vector3 angularChanges[2];
+
+		MatchAwakeStateDynamicOnly(contact);
+		ResolveContactPenetration(contact, linearChanges, angularChanges);
+	}
+}
+
+
+//-------------------------------------------------------------------------------------------------
+// Same sign convention as UpdateContactPenetration() - A moving along the normal reduces penetration, B moving along it adds to it
+// The normal is kept from generation, which holds up fine over the small motions of one step
+void ContactResolver::ReevaluateSubstepContact(Contact* contact, int contactIndex) const
+{
+	float penetration = m_substepInitialPenetrations[contactIndex];
+	Vector3 initialPosition = m_substepInitialPositions[contactIndex];
+	Vector3 averageDeltaPosition = Vector3::ZERO;
+
+	for (int bodyIndex = 0; bodyIndex < 2; ++bodyIndex)
+	{
+		RigidBody* body = contact->bodies[bodyIndex];
+		if (body == nullptr)
+			continue;
+
+		Vector3 deltaPosition = body->transform->TransformPosition(m_substepContactPointsLs[2 * contactIndex + bodyIndex]) - initialPosition;
+		float sign = (bodyIndex == 1 ? 1.f : -1.0f);
+		penetration += sign * DotProduct(deltaPosition, contact->normal);
+		averageDeltaPosition += 0.5f * deltaPosition;
+	}
+
+	contact->penetration = penetration;
+	contact->position = initialPosition + averageDeltaPosition;
 }
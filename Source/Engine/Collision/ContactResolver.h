@@ -8,6 +8,10 @@
 ///--------------------------------------------------------------------------------------------------------------------------------------------------
 /// INCLUDES
 ///--------------------------------------------------------------------------------------------------------------------------------------------------
+#include "Engine/Core/EngineCommon.h"
+#include "Engine/Math/Vector3.h"
+#include <functional>
+#include <vector>
 
 ///--------------------------------------------------------------------------------------------------------------------------------------------------
 /// DEFINES
@@ -18,6 +22,28 @@
 ///--------------------------------------------------------------------------------------------------------------------------------------------------
 class Contact;
 class Quaternion;
+class RigidBody;
+
+enum ContactSolverMode
+{
+	CONTACT_SOLVER_SEQUENTIAL,			// Resolves the worst contact each iteration, one at a time
+	CONTACT_SOLVER_PARALLEL_COLORED,	// Resolves every contact each pass, colors of body-disjoint contacts in parallel
+	CONTACT_SOLVER_SUBSTEPPED			// PhysicsScene splits the step into substeps, each integrating then making one pass over the contacts
+};
+
+// One entry per dynamic body per contact, sorted by body so each body's contacts are contiguous
+struct ContactBodyLink
+{
+	RigidBody*	m_body = nullptr;
+	int			m_contactIndex = -1;
+};
+
+// Run of links in ContactResolver::m_bodyLinks that share one of a contact's bodies
+struct ContactLinkRange
+{
+	int m_firstLink = 0;
+	int m_numLinks = 0;
+};
 
 ///--------------------------------------------------------------------------------------------------------------------------------------------------
 /// GLOBALS AND STATICS
@@ -35,10 +61,47 @@ public:
 
 	void SetMaxVelocityIterations(int maxIterations) { m_maxVelocityIterations = maxIterations; }
 	void SetMaxPenetrationIterations(int maxIterations) { m_maxPenetrationIterations = maxIterations; }
+	void SetUseContactGraph(bool useContactGraph) { m_useContactGraph = useContactGraph; }
+	void SetSolverMode(ContactSolverMode mode) { m_solverMode = mode; }
+	void SetUseJobSystem(bool useJobSystem) { m_useJobSystem = useJobSystem; }
 	void ResolveContacts(Contact* contacts, int numContacts, float deltaSeconds);
+	void BeginSubsteps(const Contact* contacts, int numContacts); // Call once per step after generating contacts, before the first substep
+	void ResolveContactsSubstep(Contact* contacts, int numContacts, float substepSeconds);
 
 	float GetPenetrationEpsilon() const { return m_penetrationEpsilon; }
 	float GetVelocityEpsilon() const { return m_velocityEpsilon; }
+	ContactSolverMode GetSolverMode() const { return m_solverMode; }
+	int GetNumContactColors() const { return m_numColors; }
+
+
+public:
+	//-----Public Data-----
+
+	static constexpr int MAX_CONTACT_COLORS = 64; // Last color takes every contact that didn't fit in the others, and is solved serially
+	static constexpr int MIN_CONTACTS_PER_BATCH = 64;
+
+
+private:
+	//-----Private Methods-----
+
+	void BuildContactGraph(const Contact* contacts, int numContacts);
+	void GatherNeighborContacts(const Contact* contacts, int contactIndex);
+	void ResolveVelocitiesWithGraph(Contact* contacts, int numContacts, float deltaSeconds);
+	void ResolvePenetrationsWithGraph(Contact* contacts, int numContacts);
+
+	void BuildHeap(int numContacts);
+	void SetHeapKey(int contactIndex, float key);
+	bool IsHigherPriority(int firstContactIndex, int secondContactIndex) const;
+	void SwapHeapEntries(int firstHeapIndex, int secondHeapIndex);
+	void SiftUp(int heapIndex);
+	void SiftDown(int heapIndex);
+
+	void ColorContacts(int numContacts);
+	void ForEachContactInColor(int colorIndex, const std::function<void(int contactIndex)>& function);
+	void ResolveVelocitiesColored(Contact* contacts, float deltaSeconds);
+	void ResolvePenetrationsColored(Contact* contacts, int numContacts);
+
+	void ReevaluateSubstepContact(Contact* contact, int contactIndex) const;
 
 
 private:
@@ -48,6 +111,37 @@ private:
 	int		m_maxPenetrationIterations = 10;
 	float	m_velocityEpsilon = 0.f; // For faster objects, use a use a larger value, for slow use a smaller value
 	float	m_penetrationEpsilon = 0.f; // For larger objects use a larger value, for small objects use a smaller value
+	bool	m_useContactGraph = true; // False falls back to scanning every contact per iteration, kept for comparison
+
+	// Body -> contacts adjacency, rebuilt each ResolveContacts() call
+	std::vector<ContactBodyLink>	m_bodyLinks;
+	std::vector<ContactLinkRange>	m_contactLinkRanges; // Two per contact, one for each body
+	std::vector<int>				m_neighborContacts;
+
+	// Indexed max-heap of contacts, ordered by penetration or desired velocity change
+	std::vector<int>				m_heap; // Contact indices
+	std::vector<int>				m_heapPositions; // Contact index -> index in m_heap
+	std::vector<float>				m_heapKeys; // Contact index -> key, NO_HEAP_KEY if it doesn't need resolving
+
+	// Colored solve - contacts of one color share no dynamic body, so a color can be resolved in any order on any thread
+	ContactSolverMode				m_solverMode = CONTACT_SOLVER_SEQUENTIAL;
+	bool							m_useJobSystem = true;
+	int								m_numBodySlots = 0;
+	int								m_numColors = 0;
+	std::vector<int>				m_contactBodySlots; // Two per contact, -1 for no body or a static body
+	std::vector<uint64>				m_slotColorMasks; // Colors already used by a slot's contacts
+	std::vector<int>				m_contactColors;
+	std::vector<int>				m_colorOffsets; // MAX_CONTACT_COLORS + 1 entries into m_colorOrder
+	std::vector<int>				m_colorOrder; // Contact indices grouped by color, ascending within each color
+	std::vector<int>				m_colorWriteOffsets; // Scratch for the counting sort into m_colorOrder
+	std::vector<float>				m_initialPenetrations;
+	std::vector<Vector3>			m_slotLinearChanges; // Accumulated over the penetration passes
+	std::vector<Vector3>			m_slotAngularChanges;
+
+	// Substepped solve - contacts are generated once per step, then re-evaluated from how their bodies moved since
+	std::vector<float>				m_substepInitialPenetrations;
+	std::vector<Vector3>			m_substepInitialPositions;
+	std::vector<Vector3>			m_substepContactPointsLs; // Two per contact, the contact point in each body's local space
 
 };
 
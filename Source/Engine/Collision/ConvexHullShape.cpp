@@ -0,0 +1,127 @@
+///--------------------------------------------------------------------------------------------------------------------------------------------------
+/// Author: Andrew Chase
+/// Date Created: October 18th, 2026
+/// Description:
+///--------------------------------------------------------------------------------------------------------------------------------------------------
+
+///--------------------------------------------------------------------------------------------------------------------------------------------------
+/// INCLUDES
+///--------------------------------------------------------------------------------------------------------------------------------------------------
+#include "Engine/Collision/ConvexHullShape.h"
+#include "Engine/Core/EngineCommon.h"
+#include "Engine/Math/MathUtils.h"
+#include "Engine/Utility/LockJanitor.h"
+#include <map>
+#include <mutex>
+
+///--------------------------------------------------------------------------------------------------------------------------------------------------
+/// DEFINES
+///--------------------------------------------------------------------------------------------------------------------------------------------------
+
+///--------------------------------------------------------------------------------------------------------------------------------------------------
+/// ENUMS, TYPEDEFS, STRUCTS, FORWARD DECLARATIONS
+///--------------------------------------------------------------------------------------------------------------------------------------------------
+
+///--------------------------------------------------------------------------------------------------------------------------------------------------
+/// GLOBALS AND STATICS
+///--------------------------------------------------------------------------------------------------------------------------------------------------
+static std::mutex s_namedShapesLock;
+
+///--------------------------------------------------------------------------------------------------------------------------------------------------
+/// C FUNCTIONS
+///--------------------------------------------------------------------------------------------------------------------------------------------------
+
+//-------------------------------------------------------------------------------------------------
+// Function static so it's destroyed before the SmartPointer refcount registry it releases into
+static std::map<StringID, R<ConvexHullShape>>& GetNamedShapes()
+{
+	static std::map<StringID, R<ConvexHullShape>> s_namedShapes;
+	return s_namedShapes;
+}
+
+///--------------------------------------------------------------------------------------------------------------------------------------------------
+/// CLASS IMPLEMENTATIONS
+///--------------------------------------------------------------------------------------------------------------------------------------------------
+
+//-------------------------------------------------------------------------------------------------
+R<ConvexHullShape> ConvexHullShape::Create(const Polyhedron& hullLs)
+{
+	return R<ConvexHullShape>(new ConvexHullShape(hullLs));
+}
+
+
+//-------------------------------------------------------------------------------------------------
+R<ConvexHullShape> ConvexHullShape::CreateOrGetNamed(StringID name, const Polyhedron& hullLs)
+{
+	LOCK_JANITOR(s_namedShapesLock);
+
+	std::map<StringID, R<ConvexHullShape>>& namedShapes = GetNamedShapes();
+	std::map<StringID, R<ConvexHullShape>>::iterator itr = namedShapes.find(name);
+
+	if (itr != namedShapes.end())
+	{
+		return itr->second;
+	}
+
+	R<ConvexHullShape> shape = Create(hullLs);
+	namedShapes[name] = shape;
+
+	return shape;
+}
+
+
+//-------------------------------------------------------------------------------------------------
+R<ConvexHullShape> ConvexHullShape::GetNamed(StringID name)
+{
+	LOCK_JANITOR(s_namedShapesLock);
+
+	std::map<StringID, R<ConvexHullShape>>& namedShapes = GetNamedShapes();
+	std::map<StringID, R<ConvexHullShape>>::iterator itr = namedShapes.find(name);
+
+	if (itr != namedShapes.end())
+	{
+		return itr->second;
+	}
+
+	return R<ConvexHullShape>();
+}
+
+
+//-------------------------------------------------------------------------------------------------
+// Shapes still used by colliders stay alive until those colliders are deleted
+void ConvexHullShape::ReleaseNamedShapes()
+{
+	LOCK_JANITOR(s_namedShapesLock);
+	GetNamedShapes().clear();
+}
+
+
+//-------------------------------------------------------------------------------------------------
+ConvexHullShape::ConvexHullShape(const Polyhedron& hullLs)
+	: m_hullLs(hullLs)
+{
+	ASSERT_OR_DIE(m_hullLs.GetNumVertices() > 0, "Convex hull shape has no vertices!");
+
+	// Done here so no collider using the shape ever has to
+	if (!m_hullLs.HasGeneratedHalfEdges())
+	{
+		m_hullLs.GenerateHalfEdgeStructure();
+	}
+
+	int numVertices = m_hullLs.GetNumVertices();
+	Vector3 center = Vector3::ZERO;
+	for (int vertexIndex = 0; vertexIndex < numVertices; ++vertexIndex)
+	{
+		center += m_hullLs.GetVertexPosition(vertexIndex);
+	}
+
+	center /= (float)numVertices;
+
+	float maxDistanceSquared = 0.f;
+	for (int vertexIndex = 0; vertexIndex < numVertices; ++vertexIndex)
+	{
+		maxDistanceSquared = Max(maxDistanceSquared, (m_hullLs.GetVertexPosition(vertexIndex) - center).GetLengthSquared());
+	}
+
+	m_boundingSphereLs = Sphere(center, Sqrt(maxDistanceSquared));
+}
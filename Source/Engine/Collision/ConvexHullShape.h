@@ -0,0 +1,67 @@
+///--------------------------------------------------------------------------------------------------------------------------------------------------
+/// Author: Andrew Chase
+/// Date Created: October 18th, 2026
+/// Description: Immutable convex hull shared by every ConvexHullCollider that uses it
+///--------------------------------------------------------------------------------------------------------------------------------------------------
+#pragma once
+
+///--------------------------------------------------------------------------------------------------------------------------------------------------
+/// INCLUDES
+///--------------------------------------------------------------------------------------------------------------------------------------------------
+#include "Engine/Math/Polyhedron.h"
+#include "Engine/Math/Sphere.h"
+#include "Engine/Utility/SmartPointer.h"
+#include "Engine/Utility/StringID.h"
+
+///--------------------------------------------------------------------------------------------------------------------------------------------------
+/// DEFINES
+///--------------------------------------------------------------------------------------------------------------------------------------------------
+
+///--------------------------------------------------------------------------------------------------------------------------------------------------
+/// ENUMS, TYPEDEFS, STRUCTS, FORWARD DECLARATIONS
+///--------------------------------------------------------------------------------------------------------------------------------------------------
+
+///--------------------------------------------------------------------------------------------------------------------------------------------------
+/// GLOBALS AND STATICS
+///--------------------------------------------------------------------------------------------------------------------------------------------------
+
+///--------------------------------------------------------------------------------------------------------------------------------------------------
+/// CLASS DECLARATIONS
+///--------------------------------------------------------------------------------------------------------------------------------------------------
+
+//-------------------------------------------------------------------------------------------------
+// Built once, then only read - hold it through R<ConvexHullShape> so it's freed with its last collider
+// Named shapes are also held by the registry until ReleaseNamedShapes()
+class ConvexHullShape
+{
+public:
+	//-----Public Methods-----
+
+	static R<ConvexHullShape>	Create(const Polyhedron& hullLs);
+	static R<ConvexHullShape>	CreateOrGetNamed(StringID name, const Polyhedron& hullLs); // hullLs is only used the first time the name is seen
+	static R<ConvexHullShape>	GetNamed(StringID name); // Invalid if no shape was made with that name
+	static void					ReleaseNamedShapes();
+
+	const Polyhedron&			GetHullLs() const { return m_hullLs; }
+	const Sphere&				GetBoundingSphereLs() const { return m_boundingSphereLs; }
+
+
+private:
+	//-----Private Methods-----
+
+	ConvexHullShape(const Polyhedron& hullLs);
+	ConvexHullShape(const ConvexHullShape& copy) = delete;
+
+
+private:
+	//-----Private Data-----
+
+	Polyhedron	m_hullLs;
+	Sphere		m_boundingSphereLs; // Around the vertex average, for cheap bounds in world space
+
+};
+
+
+///--------------------------------------------------------------------------------------------------------------------------------------------------
+/// C FUNCTIONS
+///--------------------------------------------------------------------------------------------------------------------------------------------------
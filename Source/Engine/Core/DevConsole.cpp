@@ -674,6 +674,22 @@ void DevConsole::RegisterEngineCommands()
 	ConsoleCommand::Register(SID("add"),			"Adds two numbers",							"add (first:float) (second:float)",		Command_Add,				true);
 	ConsoleCommand::Register(SID("help"),			"Prints out available console commands",	"help (type:string:OPTIONAL)",			Command_Help,				true);
 	ConsoleCommand::Register(SID("debugdrawaxes"),	"Prints out available console commands",	"debugdrawworldaxes <NO_PARAMS>",		Command_DebugDrawWorldAxes,	true);
+	ConsoleCommand::Register(SID("bvhcompare"),		"Compares incremental and bulk BVH builds",	"bvhcompare (count:int:OPTIONAL)",		Command_CompareBVHBuilds,	true);
+	ConsoleCommand::Register(SID("qbvhcompare"),	"Compares binary and 4-wide BVH queries",	"qbvhcompare (count:int:OPTIONAL)",		Command_CompareQBVH,		true);
+	ConsoleCommand::Register(SID("physicsdeterminism"),	"Checks re-simulating from a snapshot is exact",	"physicsdeterminism (steps:int:OPTIONAL)",	Command_CheckPhysicsDeterminism,	true);
+	ConsoleCommand::Register(SID("narrowphasebatchcheck"),	"Checks batched contacts match the scalar path",	"narrowphasebatchcheck (count:int:OPTIONAL)",	Command_CheckBatchedNarrowphase,	true);
+	ConsoleCommand::Register(SID("narrowphaseallocs"),		"Checks the narrowphase doesn't allocate after warm-up",	"narrowphaseallocs (count:int:OPTIONAL)",	Command_CheckNarrowphaseAllocations,	true);
+	ConsoleCommand::Register(SID("contactresolverbench"),	"Times the contact resolver at 100, 1k and 10k contacts",	"contactresolverbench (iterationsPerContact:float:OPTIONAL)",	Command_BenchmarkContactResolver,	true);
+	ConsoleCommand::Register(SID("contactsolvercolored"),	"Checks the colored contact solver gives the same result on any number of threads",	"contactsolvercolored (passes:int:OPTIONAL)",	Command_CheckColoredContactSolver,	true);
+	ConsoleCommand::Register(SID("integratebatched"),		"Checks batched rigidbody integration matches integrating bodies one at a time",	"integratebatched (bodies:int:OPTIONAL, steps:int:OPTIONAL)",	Command_CheckBatchedIntegration,	true);
+	ConsoleCommand::Register(SID("towersolvers"),			"Compares the iterated and substepped contact solvers on a 20-box tower",	"towersolvers (steps:int:OPTIONAL, substeps:int:OPTIONAL)",	Command_CompareTowerSolvers,	true);
+	ConsoleCommand::Register(SID("forceregistrybench"),	"Times batched spring forces against calling the generators one at a time",	"forceregistrybench (bodies:int:OPTIONAL)",	Command_BenchmarkForceRegistry,	true);
+	ConsoleCommand::Register(SID("particlebench"),		"Steps a cube of colliding particles and checks the spatial hash against testing every pair",	"particlebench (particles:int:OPTIONAL, steps:int:OPTIONAL)",	Command_BenchmarkParticleWorld,	true);
+	ConsoleCommand::Register(SID("pbdcheck"),				"Drapes a cloth over a sphere and swings a rope, checking stretch, penetration and that the job system matches",	"pbdcheck (steps:int:OPTIONAL, substeps:int:OPTIONAL)",	Command_CheckPBDRopeAndCloth,	true);
+	ConsoleCommand::Register(SID("fluidbench"),			"Drops a block of PBF fluid into a tank, reporting particles per ms, compression and that the job system matches",	"fluidbench (particles:int:OPTIONAL, steps:int:OPTIONAL)",	Command_BenchmarkFluid,	true);
+	ConsoleCommand::Register(SID("physicsbench"),		"Steps a box pyramid, hull pile, 10k sphere rain and spring chains, printing per phase ms per step as CSV",	"physicsbench (steps:int:OPTIONAL, csvPath:string:OPTIONAL)",	Command_BenchmarkPhysicsScenarios,	true);
+	ConsoleCommand::Register(SID("framestepcheck"),	"Checks FrameStep with uneven frame times matches plain fixed steps, and replays exactly from a snapshot",	"framestepcheck (frames:int:OPTIONAL)",	Command_CheckFrameStep,	true);
+	ConsoleCommand::Register(SID("meshcandidatecheck"),	"Rests a wide box on a fine triangle mesh, checking no triangles or contacts get dropped",	"meshcandidatecheck (cellsPerSide:int:OPTIONAL)",	Command_CheckMeshCandidates,	true);
 }	
 
 
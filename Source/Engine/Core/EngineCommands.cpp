@@ -7,10 +7,34 @@
 ///--------------------------------------------------------------------------------------------------------------------------------------------------
 /// INCLUDES
 ///--------------------------------------------------------------------------------------------------------------------------------------------------
+#include "Engine/Collision/BoundingVolumeHierarchy/BoundingVolume.h"
+#include "Engine/Collision/BoundingVolumeHierarchy/QBVH.h"
+#include "Engine/Collision/CollisionDetector.h"
+#include "Engine/Collision/CollisionScene.h"
+#include "Engine/Collision/Contact.h"
+#include "Engine/Collision/ContactResolver.h"
 #include "Engine/Core/EngineCommands.h"
 #include "Engine/Core/EngineCommon.h"
+#include "Engine/Core/Entity.h"
+#include "Engine/IO/File.h"
+#include "Engine/Job/JobSystem.h"
+#include "Engine/Physics/Fluid/FluidSystem.h"
+#include "Engine/Physics/Particle/Particle.h"
+#include "Engine/Physics/PBD/PBDSystem.h"
+#include "Engine/Physics/Particle/ParticleWorld.h"
+#include "Engine/Physics/Rigidbody/PhysicsScene.h"
+#include "Engine/Physics/Rigidbody/PhysicsSceneBenchmark.h"
+#include "Engine/Physics/Rigidbody/RigidBodyAnchoredSpring.h"
+#include "Engine/Physics/Rigidbody/RigidBodyForceRegistry.h"
+#include "Engine/Physics/Rigidbody/Rigidbody.h"
 #include "Engine/Render/Camera.h"
 #include "Engine/Render/Debug/DebugRenderSystem.h"
+#include "Engine/Render/Mesh/Mesh.h"
+#include "Engine/Time/Time.h"
+#include <thread>
+#if defined(_DEBUG)
+#include <crtdbg.h>
+#endif
 
 ///--------------------------------------------------------------------------------------------------------------------------------------------------
 /// DEFINES
@@ -23,6 +47,10 @@
 ///--------------------------------------------------------------------------------------------------------------------------------------------------
 /// GLOBALS AND STATICS
 ///--------------------------------------------------------------------------------------------------------------------------------------------------
+#if defined(_DEBUG)
+static int				s_numCountedAllocations = 0;
+static std::thread::id	s_allocationCountThread;
+#endif
 
 ///--------------------------------------------------------------------------------------------------------------------------------------------------
 /// C FUNCTIONS
@@ -139,3 +167,1707 @@ void Command_DebugDrawWorldAxes(CommandArgs& args)
 		ConsoleLogf("World axes draw disabled");
 	}
 }
+
+
+//-------------------------------------------------------------------------------------------------
+// Builds the same random spheres into one scene by inserting one at a time and another with the bulk build,
+// then compares build time, tree cost, and the time to find all overlapping pairs
+void Command_CompareBVHBuilds(CommandArgs& args)
+{
+	float countArg;
+	args.GetNextFloat(countArg, 10000.f);
+	int numEntities = (int)countArg;
+
+	if (numEntities < 2)
+	{
+		ConsoleLogErrorf("Need at least 2 entities to compare");
+		return;
+	}
+
+	// Keep the density the same regardless of count
+	float halfExtent = powf((float)numEntities, 1.f / 3.f);
+
+	std::vector<Entity*> entities;
+	entities.reserve(numEntities);
+
+	for (int entityIndex = 0; entityIndex < numEntities; ++entityIndex)
+	{
+		Entity* entity = new Entity();
+		entity->transform.position = Vector3(GetRandomFloatInRange(-halfExtent, halfExtent), GetRandomFloatInRange(-halfExtent, halfExtent), GetRandomFloatInRange(-halfExtent, halfExtent));
+		entity->rigidBody = new RigidBody(&entity->transform);
+		entity->collider = new SphereCollider(entity, Sphere(Vector3::ZERO, GetRandomFloatInRange(0.1f, 0.5f)));
+		entities.push_back(entity);
+	}
+
+	CollisionScene<BoundingVolumeSphere> incrementalScene;
+	CollisionScene<BoundingVolumeSphere> bulkScene;
+
+	uint64 start = GetPerformanceCounter();
+	for (Entity* entity : entities)
+	{
+		incrementalScene.AddEntity(entity);
+	}
+	double incrementalBuildMs = 1000.0 * TimeSystem::PerformanceCountToSeconds(GetPerformanceCounter() - start);
+
+	start = GetPerformanceCounter();
+	bulkScene.AddEntities(entities);
+	double bulkBuildMs = 1000.0 * TimeSystem::PerformanceCountToSeconds(GetPerformanceCounter() - start);
+
+	int pairLimit = 16 * numEntities;
+	PotentialCollision* pairs = (PotentialCollision*)malloc(sizeof(PotentialCollision) * pairLimit);
+
+	start = GetPerformanceCounter();
+	int incrementalPairs = incrementalScene.FindAllPotentialCollisions(pairs, pairLimit);
+	double incrementalQueryMs = 1000.0 * TimeSystem::PerformanceCountToSeconds(GetPerformanceCounter() - start);
+
+	start = GetPerformanceCounter();
+	int bulkPairs = bulkScene.FindAllPotentialCollisions(pairs, pairLimit);
+	double bulkQueryMs = 1000.0 * TimeSystem::PerformanceCountToSeconds(GetPerformanceCounter() - start);
+
+	ConsoleLogf(Rgba::CYAN, "-----BVH build comparison, %i spheres-----", numEntities);
+	ConsoleLogf("Incremental: build %.3f ms, cost %.3f, query %.3f ms (%i pairs)", incrementalBuildMs, incrementalScene.GetBVHCost(), incrementalQueryMs, incrementalPairs);
+	ConsoleLogf("Bulk:        build %.3f ms, cost %.3f, query %.3f ms (%i pairs)", bulkBuildMs, bulkScene.GetBVHCost(), bulkQueryMs, bulkPairs);
+
+	SAFE_FREE(pairs);
+	incrementalScene.RemoveAllEntities();
+	bulkScene.RemoveAllEntities();
+
+	for (Entity* entity : entities)
+	{
+		SAFE_DELETE(entity->collider);
+		SAFE_DELETE(entity->rigidBody);
+		SAFE_DELETE(entity);
+	}
+}
+
+
+//-------------------------------------------------------------------------------------------------
+// Builds random spheres into a scene, collapses the tree to a QBVH, and compares both on pair finding and raycasts
+void Command_CompareQBVH(CommandArgs& args)
+{
+	float countArg;
+	args.GetNextFloat(countArg, 10000.f);
+	int numEntities = (int)countArg;
+
+	if (numEntities < 2)
+	{
+		ConsoleLogErrorf("Need at least 2 entities to compare");
+		return;
+	}
+
+	float halfExtent = powf((float)numEntities, 1.f / 3.f);
+
+	std::vector<Entity*> entities;
+	entities.reserve(numEntities);
+
+	for (int entityIndex = 0; entityIndex < numEntities; ++entityIndex)
+	{
+		Entity* entity = new Entity();
+		entity->transform.position = Vector3(GetRandomFloatInRange(-halfExtent, halfExtent), GetRandomFloatInRange(-halfExtent, halfExtent), GetRandomFloatInRange(-halfExtent, halfExtent));
+		entity->rigidBody = new RigidBody(&entity->transform);
+		entity->collider = new SphereCollider(entity, Sphere(Vector3::ZERO, GetRandomFloatInRange(0.1f, 0.5f)));
+		entities.push_back(entity);
+	}
+
+	CollisionScene<BoundingVolumeSphere> scene;
+	scene.AddEntities(entities);
+
+	QBVH qbvh;
+	uint64 start = GetPerformanceCounter();
+	scene.BuildQBVH(qbvh);
+	double collapseMs = 1000.0 * TimeSystem::PerformanceCountToSeconds(GetPerformanceCounter() - start);
+
+	// Pairs
+	int pairLimit = 16 * numEntities;
+	PotentialCollision* pairs = (PotentialCollision*)malloc(sizeof(PotentialCollision) * pairLimit);
+
+	start = GetPerformanceCounter();
+	int binaryPairs = scene.FindAllPotentialCollisions(pairs, pairLimit);
+	double binaryPairMs = 1000.0 * TimeSystem::PerformanceCountToSeconds(GetPerformanceCounter() - start);
+
+	start = GetPerformanceCounter();
+	int qbvhPairs = qbvh.FindAllPotentialCollisions(pairs, pairLimit);
+	double qbvhPairMs = 1000.0 * TimeSystem::PerformanceCountToSeconds(GetPerformanceCounter() - start);
+
+	SAFE_FREE(pairs);
+
+	// Rays, same set for both
+	const int numRays = 1000;
+	std::vector<Vector3> rayStarts(numRays);
+	std::vector<Vector3> rayDirections(numRays);
+
+	for (int rayIndex = 0; rayIndex < numRays; ++rayIndex)
+	{
+		rayStarts[rayIndex] = Vector3(GetRandomFloatInRange(-halfExtent, halfExtent), GetRandomFloatInRange(-halfExtent, halfExtent), GetRandomFloatInRange(-halfExtent, halfExtent));
+		rayDirections[rayIndex] = Vector3(GetRandomFloatInRange(-1.f, 1.f), GetRandomFloatInRange(-1.f, 1.f), GetRandomFloatInRange(-1.f, 1.f)).GetNormalized();
+	}
+
+	int candidateLimit = numEntities;
+	const Collider** candidates = (const Collider**)malloc(sizeof(const Collider*) * candidateLimit);
+
+	int binaryCandidates = 0;
+	start = GetPerformanceCounter();
+	for (int rayIndex = 0; rayIndex < numRays; ++rayIndex)
+	{
+		binaryCandidates += scene.GetRaycastCandidates(rayStarts[rayIndex], rayDirections[rayIndex], halfExtent, candidates, candidateLimit);
+	}
+	double binaryRayMs = 1000.0 * TimeSystem::PerformanceCountToSeconds(GetPerformanceCounter() - start);
+
+	int qbvhCandidates = 0;
+	start = GetPerformanceCounter();
+	for (int rayIndex = 0; rayIndex < numRays; ++rayIndex)
+	{
+		qbvhCandidates += qbvh.GetRaycastCandidates(rayStarts[rayIndex], rayDirections[rayIndex], halfExtent, candidates, candidateLimit);
+	}
+	double qbvhRayMs = 1000.0 * TimeSystem::PerformanceCountToSeconds(GetPerformanceCounter() - start);
+
+	SAFE_FREE(candidates);
+
+	ConsoleLogf(Rgba::CYAN, "-----QBVH comparison, %i spheres, collapse took %.3f ms-----", numEntities, collapseMs);
+	ConsoleLogf("Binary: pairs %.3f ms (%i found), %i rays %.3f ms (%i candidates)", binaryPairMs, binaryPairs, numRays, binaryRayMs, binaryCandidates);
+	ConsoleLogf("QBVH:   pairs %.3f ms (%i found), %i rays %.3f ms (%i candidates)", qbvhPairMs, qbvhPairs, numRays, qbvhRayMs, qbvhCandidates);
+
+	scene.RemoveAllEntities();
+
+	for (Entity* entity : entities)
+	{
+		SAFE_DELETE(entity->collider);
+		SAFE_DELETE(entity->rigidBody);
+		SAFE_DELETE(entity);
+	}
+}
+
+
+//-------------------------------------------------------------------------------------------------
+// Only compares what the game can see, bit for bit
+static bool AreBodyStatesIdentical(const RigidBodyState& a, const RigidBodyState& b)
+{
+	return memcmp(&a.m_position, &b.m_position, sizeof(Vector3)) == 0
+		&& memcmp(&a.m_rotation, &b.m_rotation, sizeof(Quaternion)) == 0
+		&& memcmp(&a.m_velocityWs, &b.m_velocityWs, sizeof(Vector3)) == 0
+		&& memcmp(&a.m_angularVelocityRadiansWs, &b.m_angularVelocityRadiansWs, sizeof(Vector3)) == 0
+		&& a.m_isAwake == b.m_isAwake;
+}
+
+
+//-------------------------------------------------------------------------------------------------
+// Drops a box stack and some spheres onto a floor, snapshots partway, then checks stepping again from the
+// snapshot reproduces the original run exactly. The snapshot is restored from its bytes, not the one in memory
+void Command_CheckPhysicsDeterminism(CommandArgs& args)
+{
+	float stepsArg;
+	args.GetNextFloat(stepsArg, 120.f);
+	int numSteps = Max((int)stepsArg, 1);
+
+	const float deltaSeconds = 1.f / 60.f;
+	const int numBoxes = 10;
+	const int numSpheres = 10;
+
+	std::vector<Entity*> entities;
+
+	// Floor has no body, so it goes in the static tree
+	Entity* floor = new Entity();
+	floor->collider = new BoxCollider(floor, OBB3(Vector3::ZERO, Vector3(20.f, 0.5f, 20.f), Quaternion::IDENTITY));
+	entities.push_back(floor);
+
+	for (int boxIndex = 0; boxIndex < numBoxes; ++boxIndex)
+	{
+		Entity* box = new Entity();
+		box->transform.position = Vector3(GetRandomFloatInRange(-0.1f, 0.1f), 1.f + 1.05f * (float)boxIndex, GetRandomFloatInRange(-0.1f, 0.1f));
+		box->rigidBody = new RigidBody(&box->transform);
+		box->rigidBody->SetInertiaTensor_Box(Vector3(0.5f));
+		box->collider = new BoxCollider(box, OBB3(Vector3::ZERO, Vector3(0.5f), Quaternion::IDENTITY));
+		entities.push_back(box);
+	}
+
+	for (int sphereIndex = 0; sphereIndex < numSpheres; ++sphereIndex)
+	{
+		Entity* sphere = new Entity();
+		sphere->transform.position = Vector3(GetRandomFloatInRange(-3.f, 3.f), GetRandomFloatInRange(2.f, 8.f), GetRandomFloatInRange(-3.f, 3.f));
+		sphere->rigidBody = new RigidBody(&sphere->transform);
+		sphere->rigidBody->SetInertiaTensor_Sphere(0.5f);
+		sphere->collider = new SphereCollider(sphere, Sphere(Vector3::ZERO, 0.5f));
+		entities.push_back(sphere);
+	}
+
+	CollisionScene<BoundingVolumeSphere> collisionScene;
+	collisionScene.AddEntities(entities);
+
+	bool passed = false;
+	int firstMismatchStep = -1;
+	double saveUs = 0.0;
+	double restoreUs = 0.0;
+	std::vector<uint8> snapshotBytes;
+
+	{
+		// Scoped so the bodies are deleted here, as the physics scene owns them
+		PhysicsScene physicsScene(&collisionScene);
+		for (Entity* entity : entities)
+		{
+			if (entity->rigidBody != nullptr)
+			{
+				physicsScene.AddRigidbody(entity->rigidBody);
+			}
+		}
+
+		// Let things start colliding before saving
+		for (int stepIndex = 0; stepIndex < 30; ++stepIndex)
+		{
+			physicsScene.DoPhysicsStep(deltaSeconds);
+		}
+
+		PhysicsSnapshot snapshot;
+		uint64 start = GetPerformanceCounter();
+		physicsScene.SaveSnapshot(snapshot);
+		saveUs = 1000000.0 * TimeSystem::PerformanceCountToSeconds(GetPerformanceCounter() - start);
+		snapshot.WriteToBytes(snapshotBytes);
+
+		PhysicsSnapshot stepSnapshot;
+		std::vector<RigidBodyState> expectedStates;
+		expectedStates.reserve(numSteps * (numBoxes + numSpheres));
+
+		for (int stepIndex = 0; stepIndex < numSteps; ++stepIndex)
+		{
+			physicsScene.DoPhysicsStep(deltaSeconds);
+			physicsScene.SaveSnapshot(stepSnapshot);
+			expectedStates.insert(expectedStates.end(), stepSnapshot.m_bodyStates.begin(), stepSnapshot.m_bodyStates.end());
+		}
+
+		PhysicsSnapshot loadedSnapshot;
+		bool restored = loadedSnapshot.ReadFromBytes(snapshotBytes.data(), snapshotBytes.size());
+
+		start = GetPerformanceCounter();
+		restored = restored && physicsScene.RestoreSnapshot(loadedSnapshot);
+		restoreUs = 1000000.0 * TimeSystem::PerformanceCountToSeconds(GetPerformanceCounter() - start);
+
+		passed = restored;
+		for (int stepIndex = 0; passed && stepIndex < numSteps; ++stepIndex)
+		{
+			physicsScene.DoPhysicsStep(deltaSeconds);
+			physicsScene.SaveSnapshot(stepSnapshot);
+
+			for (int bodyIndex = 0; bodyIndex < (int)stepSnapshot.m_bodyStates.size(); ++bodyIndex)
+			{
+				if (!AreBodyStatesIdentical(stepSnapshot.m_bodyStates[bodyIndex], expectedStates[stepIndex * stepSnapshot.m_bodyStates.size() + bodyIndex]))
+				{
+					passed = false;
+					firstMismatchStep = stepIndex;
+					break;
+				}
+			}
+		}
+
+		collisionScene.RemoveAllEntities();
+	}
+
+	for (Entity* entity : entities)
+	{
+		SAFE_DELETE(entity->collider);
+		entity->rigidBody = nullptr;
+		SAFE_DELETE(entity);
+	}
+
+	if (passed)
+	{
+		ConsoleLogf(Rgba::GREEN, "Re-simulated %i steps from a snapshot bit-identically (%i bytes, save %.1f us, restore %.1f us)", numSteps, (int)snapshotBytes.size(), saveUs, restoreUs);
+	}
+	else
+	{
+		ConsoleLogErrorf("Re-simulation from a snapshot diverged at step %i", firstMismatchStep);
+	}
+}
+
+
+//-------------------------------------------------------------------------------------------------
+// Compares everything the resolver reads from a freshly generated contact, bit for bit
+static bool AreContactsIdentical(const Contact& a, const Contact& b)
+{
+	return memcmp(&a.position, &b.position, sizeof(Vector3)) == 0
+		&& memcmp(&a.normal, &b.normal, sizeof(Vector3)) == 0
+		&& memcmp(&a.penetration, &b.penetration, sizeof(float)) == 0
+		&& memcmp(&a.friction, &b.friction, sizeof(float)) == 0
+		&& memcmp(&a.restitution, &b.restitution, sizeof(float)) == 0
+		&& a.bodies[0] == b.bodies[0]
+		&& a.bodies[1] == b.bodies[1];
+}
+
+
+//-------------------------------------------------------------------------------------------------
+// Runs the same random sphere-sphere, sphere-box and box-box pairs through the scalar and batched narrowphase, and checks
+// the contacts match exactly
+void Command_CheckBatchedNarrowphase(CommandArgs& args)
+{
+	float countArg;
+	args.GetNextFloat(countArg, 10000.f);
+	int numPairs = Max((int)countArg, 1);
+
+	// Packed tight enough that roughly half the pairs touch
+	const float spread = 1.5f;
+
+	std::vector<Entity*> entities;
+	entities.reserve(4 * numPairs);
+
+	std::vector<const Collider*> colliders[CollisionDetector::NUM_BATCH_KERNELS][2];
+
+	for (int pairIndex = 0; pairIndex < numPairs; ++pairIndex)
+	{
+		for (int side = 0; side < 2; ++side)
+		{
+			Entity* sphere = new Entity();
+			sphere->transform.position = Vector3(GetRandomFloatInRange(-spread, spread), GetRandomFloatInRange(-spread, spread), GetRandomFloatInRange(-spread, spread));
+			sphere->rigidBody = new RigidBody(&sphere->transform);
+			sphere->collider = new SphereCollider(sphere, Sphere(Vector3::ZERO, GetRandomFloatInRange(0.25f, 1.f)));
+			entities.push_back(sphere);
+
+			Entity* box = new Entity();
+			box->transform.position = Vector3(GetRandomFloatInRange(-spread, spread), GetRandomFloatInRange(-spread, spread), GetRandomFloatInRange(-spread, spread));
+			box->transform.rotation = Quaternion::CreateFromEulerAnglesDegrees(GetRandomFloatInRange(0.f, 360.f), GetRandomFloatInRange(0.f, 360.f), GetRandomFloatInRange(0.f, 360.f));
+			box->rigidBody = new RigidBody(&box->transform);
+			box->collider = new BoxCollider(box, OBB3(Vector3::ZERO, Vector3(GetRandomFloatInRange(0.25f, 1.f), GetRandomFloatInRange(0.25f, 1.f), GetRandomFloatInRange(0.25f, 1.f)), Quaternion::IDENTITY));
+			entities.push_back(box);
+
+			colliders[CollisionDetector::GetBatchIndex(sphere->collider, sphere->collider)][side].push_back(sphere->collider);
+			colliders[CollisionDetector::GetBatchIndex(box->collider, box->collider)][side].push_back(box->collider);
+		}
+
+		// Pair the first side's sphere with the second side's box, alternating which comes first as the scene does
+		const Collider* sphereCol = entities[entities.size() - 4]->collider;
+		const Collider* boxCol = entities.back()->collider;
+		int sphereBoxIndex = CollisionDetector::GetBatchIndex(sphereCol, boxCol);
+		bool isSphereFirst = (pairIndex % 2 == 0);
+
+		colliders[sphereBoxIndex][0].push_back(isSphereFirst ? sphereCol : boxCol);
+		colliders[sphereBoxIndex][1].push_back(isSphereFirst ? boxCol : sphereCol);
+	}
+
+	CollisionDetector detector;
+	int contactLimit = 8 * numPairs;
+	std::vector<Contact> scalarContacts(contactLimit);
+	std::vector<Contact> batchedContacts(contactLimit);
+
+	ConsoleLogf(Rgba::CYAN, "-----Batched narrowphase check, %i pairs per kernel-----", numPairs);
+
+	bool allPassed = true;
+	for (int batchIndex = 0; batchIndex < CollisionDetector::NUM_BATCH_KERNELS; ++batchIndex)
+	{
+		const std::vector<const Collider*>& aColliders = colliders[batchIndex][0];
+		const std::vector<const Collider*>& bColliders = colliders[batchIndex][1];
+
+		int numScalarContacts = 0;
+		uint64 start = GetPerformanceCounter();
+		for (int pairIndex = 0; pairIndex < numPairs; ++pairIndex)
+		{
+			numScalarContacts += detector.GenerateContacts(aColliders[pairIndex], bColliders[pairIndex], &scalarContacts[numScalarContacts], contactLimit - numScalarContacts);
+		}
+		double scalarMs = 1000.0 * TimeSystem::PerformanceCountToSeconds(GetPerformanceCounter() - start);
+
+		start = GetPerformanceCounter();
+		int numBatchedContacts = detector.GenerateContactsBatch(batchIndex, aColliders.data(), bColliders.data(), numPairs, batchedContacts.data(), contactLimit);
+		double batchedMs = 1000.0 * TimeSystem::PerformanceCountToSeconds(GetPerformanceCounter() - start);
+
+		int firstMismatch = -1;
+		for (int contactIndex = 0; contactIndex < Min(numScalarContacts, numBatchedContacts); ++contactIndex)
+		{
+			if (!AreContactsIdentical(scalarContacts[contactIndex], batchedContacts[contactIndex]))
+			{
+				firstMismatch = contactIndex;
+				break;
+			}
+		}
+
+		bool passed = (numScalarContacts == numBatchedContacts && firstMismatch == -1);
+		allPassed = allPassed && passed;
+
+		const char* firstName = aColliders[0]->GetTypeAsString();
+		const char* secondName = bColliders[0]->GetTypeAsString();
+		if (passed)
+		{
+			ConsoleLogf(Rgba::GREEN, "%s-%s: %i contacts match, scalar %.3f ms, batched %.3f ms", firstName, secondName, numScalarContacts, scalarMs, batchedMs);
+		}
+		else
+		{
+			ConsoleLogErrorf("%s-%s: scalar made %i contacts, batched made %i, first mismatch at %i", firstName, secondName, numScalarContacts, numBatchedContacts, firstMismatch);
+		}
+	}
+
+	for (Entity* entity : entities)
+	{
+		SAFE_DELETE(entity->collider);
+		SAFE_DELETE(entity->rigidBody);
+		SAFE_DELETE(entity);
+	}
+
+	if (!allPassed)
+	{
+		ConsoleLogErrorf("Batched narrowphase doesn't match the scalar path!");
+	}
+}
+
+
+#if defined(_DEBUG)
+//-------------------------------------------------------------------------------------------------
+// Debug CRT hook, only counts allocations made on the thread being measured
+static int CountAllocationsHook(int allocType, void* userData, size_t size, int blockType, long requestNumber, const unsigned char* fileName, int lineNumber)
+{
+	UNUSED(userData);
+	UNUSED(size);
+	UNUSED(requestNumber);
+	UNUSED(fileName);
+	UNUSED(lineNumber);
+
+	if (blockType != _CRT_BLOCK && (allocType == _HOOK_ALLOC || allocType == _HOOK_REALLOC) && std::this_thread::get_id() == s_allocationCountThread)
+	{
+		s_numCountedAllocations++;
+	}
+
+	return TRUE;
+}
+#endif
+
+
+//-------------------------------------------------------------------------------------------------
+// Runs the narrowphase over a pile of mixed shapes twice - the first pass warms up the scratch storage,
+// the second must not touch the heap at all
+void Command_CheckNarrowphaseAllocations(CommandArgs& args)
+{
+#if defined(_DEBUG)
+	float countArg;
+	args.GetNextFloat(countArg, 200.f);
+	int numEntities = Max((int)countArg, 2);
+
+	const float spread = 2.f;
+	std::vector<Entity*> entities;
+	entities.reserve(numEntities + 1);
+
+	Entity* ground = new Entity();
+	ground->collider = new PlaneCollider(ground, Plane3(Vector3::Y_AXIS, 0.f));
+	entities.push_back(ground);
+
+	for (int entityIndex = 0; entityIndex < numEntities; ++entityIndex)
+	{
+		Entity* entity = new Entity();
+		entity->transform.position = Vector3(GetRandomFloatInRange(-spread, spread), GetRandomFloatInRange(-0.5f, spread), GetRandomFloatInRange(-spread, spread));
+		entity->transform.rotation = Quaternion::CreateFromEulerAnglesDegrees(GetRandomFloatInRange(0.f, 360.f), GetRandomFloatInRange(0.f, 360.f), GetRandomFloatInRange(0.f, 360.f));
+		entity->rigidBody = new RigidBody(&entity->transform);
+
+		Vector3 extents = Vector3(GetRandomFloatInRange(0.25f, 1.f), GetRandomFloatInRange(0.25f, 1.f), GetRandomFloatInRange(0.25f, 1.f));
+		switch (entityIndex % 4)
+		{
+		case 0: entity->collider = new SphereCollider(entity, Sphere(Vector3::ZERO, extents.x)); break;
+		case 1: entity->collider = new CapsuleCollider(entity, Capsule3(Vector3(0.f, -extents.y, 0.f), Vector3(0.f, extents.y, 0.f), extents.x)); break;
+		case 2: entity->collider = new BoxCollider(entity, OBB3(Vector3::ZERO, extents, Quaternion::IDENTITY)); break;
+		default: entity->collider = new ConvexHullCollider(entity, Polyhedron(OBB3(Vector3::ZERO, extents, Quaternion::IDENTITY))); break;
+		}
+
+		entities.push_back(entity);
+	}
+
+	CollisionDetector detector;
+	const int contactLimit = 64;
+	Contact contacts[contactLimit];
+
+	int numPasses = 2;
+	int numContacts = 0;
+	s_allocationCountThread = std::this_thread::get_id();
+
+	for (int passIndex = 0; passIndex < numPasses; ++passIndex)
+	{
+		bool isCountedPass = (passIndex == numPasses - 1);
+		if (isCountedPass)
+		{
+			s_numCountedAllocations = 0;
+			_CrtSetAllocHook(CountAllocationsHook);
+		}
+
+		numContacts = 0;
+		for (int aIndex = 0; aIndex < (int)entities.size(); ++aIndex)
+		{
+			for (int bIndex = aIndex + 1; bIndex < (int)entities.size(); ++bIndex)
+			{
+				numContacts += detector.GenerateContacts(entities[aIndex]->collider, entities[bIndex]->collider, contacts, contactLimit);
+			}
+		}
+
+		if (isCountedPass)
+		{
+			_CrtSetAllocHook(nullptr);
+		}
+	}
+
+	for (Entity* entity : entities)
+	{
+		SAFE_DELETE(entity->collider);
+		SAFE_DELETE(entity->rigidBody);
+		SAFE_DELETE(entity);
+	}
+
+	if (s_numCountedAllocations == 0)
+	{
+		ConsoleLogf(Rgba::GREEN, "Narrowphase made %i contacts with no heap allocations after warm-up", numContacts);
+	}
+	else
+	{
+		ConsoleLogErrorf("Narrowphase made %i heap allocations after warm-up (%i contacts)", s_numCountedAllocations, numContacts);
+	}
+#else
+	UNUSED(args);
+	ConsoleLogErrorf("Counting allocations needs the debug CRT, run this from a debug build");
+#endif
+}
+
+
+//-------------------------------------------------------------------------------------------------
+// Stacks of boxes resting on the ground and on each other, four corner contacts per face, all
+// moving down so both the velocity and penetration passes have work to do
+static void MakeContactResolverBenchmarkPile(int numContacts, std::vector<Entity*>& out_entities, std::vector<Contact>& out_contacts)
+{
+	const int boxesPerStack = 10;
+	const float overlap = 0.02f;
+	const float cornerOffset = 0.45f;
+	const Vector3 corners[4] = { Vector3(-cornerOffset, 0.f, -cornerOffset), Vector3(cornerOffset, 0.f, -cornerOffset), Vector3(-cornerOffset, 0.f, cornerOffset), Vector3(cornerOffset, 0.f, cornerOffset) };
+
+	int numStacks = (numContacts + 4 * boxesPerStack - 1) / (4 * boxesPerStack);
+	int stacksPerRow = Max((int)Sqrt((float)numStacks), 1);
+
+	for (int stackIndex = 0; stackIndex < numStacks; ++stackIndex)
+	{
+		Vector3 stackBase = Vector3(2.f * (float)(stackIndex % stacksPerRow), 0.f, 2.f * (float)(stackIndex / stacksPerRow));
+		Entity* below = nullptr;
+
+		for (int boxIndex = 0; boxIndex < boxesPerStack && (int)out_contacts.size() < numContacts; ++boxIndex)
+		{
+			Entity* box = new Entity();
+			box->transform.position = stackBase + Vector3(0.f, 0.5f - overlap + (float)boxIndex * (1.f - overlap), 0.f);
+			box->rigidBody = new RigidBody(&box->transform);
+			box->rigidBody->SetInertiaTensor_Box(Vector3(0.5f));
+			box->rigidBody->SetVelocityWs(Vector3(0.f, -1.f, 0.f));
+			box->rigidBody->CalculateDerivedData();
+			out_entities.push_back(box);
+
+			float faceHeight = box->transform.position.y - 0.5f + 0.5f * overlap;
+			for (int cornerIndex = 0; cornerIndex < 4 && (int)out_contacts.size() < numContacts; ++cornerIndex)
+			{
+				Contact contact;
+				contact.position = Vector3(stackBase.x, faceHeight, stackBase.z) + corners[cornerIndex];
+				contact.normal = Vector3::Y_AXIS;
+				contact.penetration = overlap;
+				contact.restitution = 0.f;
+				contact.friction = 0.5f;
+				contact.bodies[0] = box->rigidBody;
+				contact.bodies[1] = (below != nullptr ? below->rigidBody : nullptr);
+				out_contacts.push_back(contact);
+			}
+
+			below = box;
+		}
+	}
+}
+
+
+//-------------------------------------------------------------------------------------------------
+// Times the resolver picking and patching contacts by scanning all of them, against the body adjacency graph and heap
+void Command_BenchmarkContactResolver(CommandArgs& args)
+{
+	float iterationsArg;
+	args.GetNextFloat(iterationsArg, 1.f);
+	float iterationsPerContact = Max(iterationsArg, 0.f);
+
+	const float deltaSeconds = 1.f / 60.f;
+	const int contactCounts[3] = { 100, 1000, 10000 };
+
+	ConsoleLogf(Rgba::CYAN, "-----Contact resolver, %.1f iterations per contact-----", iterationsPerContact);
+
+	for (int countIndex = 0; countIndex < 3; ++countIndex)
+	{
+		std::vector<Entity*> entities;
+		std::vector<Contact> initialContacts;
+		MakeContactResolverBenchmarkPile(contactCounts[countIndex], entities, initialContacts);
+
+		int numContacts = (int)initialContacts.size();
+		int numIterations = (int)(iterationsPerContact * (float)numContacts);
+
+		std::vector<RigidBodyState> initialStates(entities.size());
+		for (int entityIndex = 0; entityIndex < (int)entities.size(); ++entityIndex)
+		{
+			entities[entityIndex]->rigidBody->SaveState(initialStates[entityIndex]);
+		}
+
+		double elapsedMs[2];
+		std::vector<RigidBodyState> finalStates[2];
+
+		for (int modeIndex = 0; modeIndex < 2; ++modeIndex)
+		{
+			for (int entityIndex = 0; entityIndex < (int)entities.size(); ++entityIndex)
+			{
+				entities[entityIndex]->rigidBody->RestoreState(initialStates[entityIndex]);
+			}
+
+			std::vector<Contact> contacts = initialContacts;
+
+			ContactResolver resolver;
+			resolver.SetUseContactGraph(modeIndex == 1);
+			resolver.SetMaxVelocityIterations(numIterations);
+			resolver.SetMaxPenetrationIterations(numIterations);
+
+			uint64 start = GetPerformanceCounter();
+			resolver.ResolveContacts(contacts.data(), numContacts, deltaSeconds);
+			elapsedMs[modeIndex] = 1000.0 * TimeSystem::PerformanceCountToSeconds(GetPerformanceCounter() - start);
+
+			finalStates[modeIndex].resize(entities.size());
+			for (int entityIndex = 0; entityIndex < (int)entities.size(); ++entityIndex)
+			{
+				entities[entityIndex]->rigidBody->SaveState(finalStates[modeIndex][entityIndex]);
+			}
+		}
+
+		bool statesMatch = true;
+		for (int entityIndex = 0; entityIndex < (int)entities.size() && statesMatch; ++entityIndex)
+		{
+			statesMatch = AreBodyStatesIdentical(finalStates[0][entityIndex], finalStates[1][entityIndex]);
+		}
+
+		if (statesMatch)
+		{
+			ConsoleLogf(Rgba::GREEN, "%i contacts, %i iterations: scan %.3f ms, graph %.3f ms (%.1fx), results identical", numContacts, numIterations, elapsedMs[0], elapsedMs[1], (elapsedMs[1] > 0.0 ? elapsedMs[0] / elapsedMs[1] : 0.0));
+		}
+		else
+		{
+			ConsoleLogErrorf("%i contacts, %i iterations: scan %.3f ms, graph %.3f ms, results differ!", numContacts, numIterations, elapsedMs[0], elapsedMs[1]);
+		}
+
+		for (Entity* entity : entities)
+		{
+			SAFE_DELETE(entity->rigidBody);
+			SAFE_DELETE(entity);
+		}
+	}
+}
+
+
+//-------------------------------------------------------------------------------------------------
+// Runs the colored solver on the job system and on this thread alone, which should match bit for bit,
+// and times both against the sequential solver with one iteration per contact
+void Command_CheckColoredContactSolver(CommandArgs& args)
+{
+	float passesArg;
+	args.GetNextFloat(passesArg, 10.f);
+	int numPasses = Max((int)passesArg, 1);
+
+	const float deltaSeconds = 1.f / 60.f;
+	const int contactCounts[3] = { 100, 1000, 10000 };
+	int numThreads = (g_jobSystem != nullptr ? g_jobSystem->GetNumWorkerThreads() + 1 : 1);
+
+	ConsoleLogf(Rgba::CYAN, "-----Colored contact solver, %i passes, %i threads-----", numPasses, numThreads);
+
+	for (int countIndex = 0; countIndex < 3; ++countIndex)
+	{
+		std::vector<Entity*> entities;
+		std::vector<Contact> initialContacts;
+		MakeContactResolverBenchmarkPile(contactCounts[countIndex], entities, initialContacts);
+
+		int numContacts = (int)initialContacts.size();
+
+		std::vector<RigidBodyState> initialStates(entities.size());
+		for (int entityIndex = 0; entityIndex < (int)entities.size(); ++entityIndex)
+		{
+			entities[entityIndex]->rigidBody->SaveState(initialStates[entityIndex]);
+		}
+
+		// Sequential, colored on one thread, colored on the job system
+		double elapsedMs[3];
+		int numColors = 0;
+		std::vector<RigidBodyState> finalStates[3];
+
+		for (int runIndex = 0; runIndex < 3; ++runIndex)
+		{
+			for (int entityIndex = 0; entityIndex < (int)entities.size(); ++entityIndex)
+			{
+				entities[entityIndex]->rigidBody->RestoreState(initialStates[entityIndex]);
+			}
+
+			std::vector<Contact> contacts = initialContacts;
+
+			ContactResolver resolver;
+			if (runIndex == 0)
+			{
+				resolver.SetMaxVelocityIterations(numContacts);
+				resolver.SetMaxPenetrationIterations(numContacts);
+			}
+			else
+			{
+				resolver.SetSolverMode(CONTACT_SOLVER_PARALLEL_COLORED);
+				resolver.SetUseJobSystem(runIndex == 2);
+				resolver.SetMaxVelocityIterations(numPasses);
+				resolver.SetMaxPenetrationIterations(numPasses);
+			}
+
+			uint64 start = GetPerformanceCounter();
+			resolver.ResolveContacts(contacts.data(), numContacts, deltaSeconds);
+			elapsedMs[runIndex] = 1000.0 * TimeSystem::PerformanceCountToSeconds(GetPerformanceCounter() - start);
+			numColors = Max(numColors, resolver.GetNumContactColors());
+
+			finalStates[runIndex].resize(entities.size());
+			for (int entityIndex = 0; entityIndex < (int)entities.size(); ++entityIndex)
+			{
+				entities[entityIndex]->rigidBody->SaveState(finalStates[runIndex][entityIndex]);
+			}
+		}
+
+		bool statesMatch = true;
+		for (int entityIndex = 0; entityIndex < (int)entities.size() && statesMatch; ++entityIndex)
+		{
+			statesMatch = AreBodyStatesIdentical(finalStates[1][entityIndex], finalStates[2][entityIndex]);
+		}
+
+		if (statesMatch)
+		{
+			ConsoleLogf(Rgba::GREEN, "%i contacts, %i colors: sequential %.3f ms, colored 1 thread %.3f ms, colored %i threads %.3f ms, threaded result identical", 
+				numContacts, numColors, elapsedMs[0], elapsedMs[1], numThreads, elapsedMs[2]);
+		}
+		else
+		{
+			ConsoleLogErrorf("%i contacts, %i colors: colored results differ between 1 and %i threads!", numContacts, numColors, numThreads);
+		}
+
+		for (Entity* entity : entities)
+		{
+			SAFE_DELETE(entity->rigidBody);
+			SAFE_DELETE(entity);
+		}
+	}
+}
+
+
+
+//-------------------------------------------------------------------------------------------------
+// Steps a crowd of bodies with assorted settings using both integration paths, checks they end up bit-identical and times them
+void Command_CheckBatchedIntegration(CommandArgs& args)
+{
+	float bodiesArg, stepsArg;
+	args.GetNextFloat(bodiesArg, 10000.f);
+	args.GetNextFloat(stepsArg, 60.f);
+	int numBodies = Max((int)bodiesArg, 1);
+	int numSteps = Max((int)stepsArg, 1);
+
+	const float deltaSeconds = 1.f / 60.f;
+
+	std::vector<Entity*> entities;
+	std::vector<Vector3> forces;
+	std::vector<RigidBodyState> initialStates(numBodies);
+	std::vector<RigidBodyState> finalStates[2];
+	double elapsedMs[2];
+
+	{
+		// Scoped so the bodies are deleted here, as the physics scene owns them
+		PhysicsScene physicsScene(nullptr);
+
+		for (int bodyIndex = 0; bodyIndex < numBodies; ++bodyIndex)
+		{
+			Entity* entity = new Entity();
+			entity->transform.position = Vector3(GetRandomFloatInRange(-50.f, 50.f), GetRandomFloatInRange(0.f, 50.f), GetRandomFloatInRange(-50.f, 50.f));
+			entity->rigidBody = new RigidBody(&entity->transform);
+
+			RigidBody* body = entity->rigidBody;
+			body->SetInertiaTensor_Box(Vector3(0.5f));
+			body->SetInverseMass(bodyIndex % 17 == 0 ? 0.f : GetRandomFloatInRange(0.1f, 2.f));
+			body->SetVelocityWs(Vector3(GetRandomFloatInRange(-5.f, 5.f), GetRandomFloatInRange(-5.f, 5.f), GetRandomFloatInRange(-5.f, 5.f)));
+			body->SetAngularVelocityRadiansWs(Vector3(GetRandomFloatInRange(-1.f, 1.f), GetRandomFloatInRange(-1.f, 1.f), GetRandomFloatInRange(-1.f, 1.f)));
+			body->SetAffectedByGravity(bodyIndex % 5 != 0);
+			body->SetGravityScale(GetRandomFloatInRange(0.5f, 2.f));
+			body->SetRotationLocked(bodyIndex % 7 == 0);
+			body->SetMaxLateralSpeed(bodyIndex % 3 == 0 ? 2.f : 1000.f);
+			body->SetMaxVerticalSpeed(bodyIndex % 4 == 0 ? 3.f : 1000.f);
+
+			if (bodyIndex % 9 == 0)
+			{
+				body->SetVelocityWs(Vector3::ZERO);
+				body->SetAngularVelocityRadiansWs(Vector3::ZERO);
+				body->SetAffectedByGravity(false);
+			}
+
+			physicsScene.AddRigidbody(body);
+			body->SaveState(initialStates[bodyIndex]);
+			entities.push_back(entity);
+			forces.push_back(bodyIndex % 2 == 0 ? Vector3(GetRandomFloatInRange(-10.f, 10.f), GetRandomFloatInRange(-10.f, 10.f), GetRandomFloatInRange(-10.f, 10.f)) : Vector3::ZERO);
+		}
+
+		// Individual bodies, then batched
+		for (int runIndex = 0; runIndex < 2; ++runIndex)
+		{
+			for (int bodyIndex = 0; bodyIndex < numBodies; ++bodyIndex)
+			{
+				entities[bodyIndex]->rigidBody->RestoreState(initialStates[bodyIndex]);
+			}
+
+			physicsScene.SetUseBatchedIntegration(runIndex == 1);
+			uint64 start = GetPerformanceCounter();
+
+			for (int stepIndex = 0; stepIndex < numSteps; ++stepIndex)
+			{
+				for (int bodyIndex = 0; bodyIndex < numBodies; bodyIndex += 2)
+				{
+					entities[bodyIndex]->rigidBody->AddWorldForceAtLocalPoint(forces[bodyIndex], Vector3(0.5f, 0.f, 0.f));
+				}
+
+				physicsScene.DoPhysicsStep(deltaSeconds);
+			}
+
+			elapsedMs[runIndex] = 1000.0 * TimeSystem::PerformanceCountToSeconds(GetPerformanceCounter() - start);
+
+			finalStates[runIndex].resize(numBodies);
+			for (int bodyIndex = 0; bodyIndex < numBodies; ++bodyIndex)
+			{
+				entities[bodyIndex]->rigidBody->SaveState(finalStates[runIndex][bodyIndex]);
+			}
+		}
+	}
+
+	int firstMismatch = -1;
+	for (int bodyIndex = 0; bodyIndex < numBodies && firstMismatch == -1; ++bodyIndex)
+	{
+		if (!AreBodyStatesIdentical(finalStates[0][bodyIndex], finalStates[1][bodyIndex])
+			|| memcmp(&finalStates[0][bodyIndex].m_lastFrameAccelerationWs, &finalStates[1][bodyIndex].m_lastFrameAccelerationWs, sizeof(Vector3)) != 0
+			|| memcmp(&finalStates[0][bodyIndex].m_motion, &finalStates[1][bodyIndex].m_motion, sizeof(float)) != 0)
+		{
+			firstMismatch = bodyIndex;
+		}
+	}
+
+	if (firstMismatch == -1)
+	{
+		ConsoleLogf(Rgba::GREEN, "%i bodies, %i steps: individual %.3f ms, batched %.3f ms, results identical", numBodies, numSteps, elapsedMs[0], elapsedMs[1]);
+	}
+	else
+	{
+		ConsoleLogErrorf("%i bodies, %i steps: batched integration differs from individual, first at body %i!", numBodies, numSteps, firstMismatch);
+	}
+
+	for (Entity* entity : entities)
+	{
+		entity->rigidBody = nullptr;
+		SAFE_DELETE(entity);
+	}
+}
+
+
+//-------------------------------------------------------------------------------------------------
+// Settles a 20-box tower with the default iterated resolver and with the substepped one, reporting cost and how well it stays standing
+void Command_CompareTowerSolvers(CommandArgs& args)
+{
+	float stepsArg, substepsArg;
+	args.GetNextFloat(stepsArg, 300.f);
+	args.GetNextFloat(substepsArg, 4.f);
+	int numSteps = Max((int)stepsArg, 1);
+	int numSubsteps = Max((int)substepsArg, 1);
+
+	const float deltaSeconds = 1.f / 60.f;
+	const int numBoxes = 20;
+	const int numJitterSteps = Min(60, numSteps); // Speeds are averaged over the last steps, a settled tower should be near 0
+	const char* modeNames[2] = { "Iterated (20/20)", "Substepped" };
+
+	ConsoleLogf(Rgba::CYAN, "-----%i box tower, %i steps, %i substeps-----", numBoxes, numSteps, numSubsteps);
+
+	for (int modeIndex = 0; modeIndex < 2; ++modeIndex)
+	{
+		std::vector<Entity*> entities;
+
+		Entity* floor = new Entity();
+		floor->collider = new BoxCollider(floor, OBB3(Vector3::ZERO, Vector3(20.f, 0.5f, 20.f), Quaternion::IDENTITY));
+		entities.push_back(floor);
+
+		std::vector<Vector3> startPositions;
+		for (int boxIndex = 0; boxIndex < numBoxes; ++boxIndex)
+		{
+			Entity* box = new Entity();
+			box->transform.position = Vector3(0.f, 1.01f + 1.01f * (float)boxIndex, 0.f);
+			box->rigidBody = new RigidBody(&box->transform);
+			box->rigidBody->SetInertiaTensor_Box(Vector3(0.5f));
+			box->collider = new BoxCollider(box, OBB3(Vector3::ZERO, Vector3(0.5f), Quaternion::IDENTITY));
+			entities.push_back(box);
+			startPositions.push_back(box->transform.position);
+		}
+
+		CollisionScene<BoundingVolumeSphere> collisionScene;
+		collisionScene.AddEntities(entities);
+		collisionScene.SetContactSolverMode(modeIndex == 0 ? CONTACT_SOLVER_SEQUENTIAL : CONTACT_SOLVER_SUBSTEPPED);
+
+		double elapsedMs = 0.0;
+		float maxDrift = 0.f;
+		float topDrop = 0.f;
+		float jitterSpeedSum = 0.f;
+
+		{
+			// Scoped so the bodies are deleted here, as the physics scene owns them
+			PhysicsScene physicsScene(&collisionScene);
+			physicsScene.SetNumSubsteps(numSubsteps);
+
+			for (Entity* entity : entities)
+			{
+				if (entity->rigidBody != nullptr)
+				{
+					physicsScene.AddRigidbody(entity->rigidBody);
+				}
+			}
+
+			for (int stepIndex = 0; stepIndex < numSteps; ++stepIndex)
+			{
+				uint64 start = GetPerformanceCounter();
+				physicsScene.DoPhysicsStep(deltaSeconds);
+				elapsedMs += 1000.0 * TimeSystem::PerformanceCountToSeconds(GetPerformanceCounter() - start);
+
+				if (stepIndex >= numSteps - numJitterSteps)
+				{
+					for (int boxIndex = 0; boxIndex < numBoxes; ++boxIndex)
+					{
+						jitterSpeedSum += entities[boxIndex + 1]->rigidBody->GetVelocityWs().GetLength();
+					}
+				}
+			}
+
+			for (int boxIndex = 0; boxIndex < numBoxes; ++boxIndex)
+			{
+				Vector3 offset = entities[boxIndex + 1]->transform.position - startPositions[boxIndex];
+				maxDrift = Max(maxDrift, Vector2(offset.x, offset.z).GetLength());
+			}
+
+			topDrop = startPositions[numBoxes - 1].y - entities[numBoxes]->transform.position.y;
+			collisionScene.RemoveAllEntities();
+		}
+
+		for (Entity* entity : entities)
+		{
+			SAFE_DELETE(entity->collider);
+			entity->rigidBody = nullptr;
+			SAFE_DELETE(entity);
+		}
+
+		float averageJitterSpeed = jitterSpeedSum / (float)(numJitterSteps * numBoxes);
+		bool isStanding = (maxDrift < 0.5f && topDrop < 0.5f);
+
+		ConsoleLogf((isStanding ? Rgba::GREEN : Rgba::RED), "%s: %.3f ms/step, max drift %.3f, top box dropped %.3f, end speed %.4f, %s",
+			modeNames[modeIndex], elapsedMs / (double)numSteps, maxDrift, topDrop, averageJitterSpeed, (isStanding ? "standing" : "collapsed"));
+	}
+}
+
+
+//-------------------------------------------------------------------------------------------------
+// Applies anchored springs to a crowd of bodies through the generators one at a time and through the registry's batch,
+// checking both give the same forces and timing each
+void Command_BenchmarkForceRegistry(CommandArgs& args)
+{
+	float bodiesArg;
+	args.GetNextFloat(bodiesArg, 10000.f);
+	int numBodies = Max((int)bodiesArg, 1);
+
+	const float deltaSeconds = 1.f / 60.f;
+
+	std::vector<Transform> transforms(numBodies);
+	std::vector<RigidBody*> bodies;
+	std::vector<RigidBodyAnchoredSpring*> springs;
+	RigidBodyForceRegistry registry;
+
+	for (int bodyIndex = 0; bodyIndex < numBodies; ++bodyIndex)
+	{
+		transforms[bodyIndex].position = Vector3(GetRandomFloatInRange(-50.f, 50.f), GetRandomFloatInRange(0.f, 50.f), GetRandomFloatInRange(-50.f, 50.f));
+		bodies.push_back(new RigidBody(&transforms[bodyIndex]));
+
+		Vector3 connectionPointLs = Vector3(GetRandomFloatInRange(-0.5f, 0.5f), 0.5f, 0.f);
+		springs.push_back(new RigidBodyAnchoredSpring(connectionPointLs, Vector3(0.f, 60.f, 0.f), GetRandomFloatInRange(1.f, 10.f), GetRandomFloatInRange(1.f, 20.f)));
+		registry.AddRegistration(bodies[bodyIndex], springs[bodyIndex]);
+	}
+
+	// Generators one at a time, batched on one thread, batched on the job system
+	double elapsedMs[3];
+	std::vector<Vector3> forces[3];
+	std::vector<Vector3> torques[3];
+
+	for (int runIndex = 0; runIndex < 3; ++runIndex)
+	{
+		for (RigidBody* body : bodies)
+		{
+			RigidBodyState state;
+			body->SaveState(state);
+			state.m_forceAccumWs = Vector3::ZERO;
+			state.m_torqueAccumWs = Vector3::ZERO;
+			body->RestoreState(state);
+		}
+
+		uint64 start = GetPerformanceCounter();
+
+		if (runIndex == 0)
+		{
+			for (int bodyIndex = 0; bodyIndex < numBodies; ++bodyIndex)
+			{
+				springs[bodyIndex]->GenerateAndAddForce(bodies[bodyIndex], deltaSeconds);
+			}
+		}
+		else
+		{
+			registry.SetUseJobSystem(runIndex == 2);
+			registry.GenerateAndAddForces(deltaSeconds);
+		}
+
+		elapsedMs[runIndex] = 1000.0 * TimeSystem::PerformanceCountToSeconds(GetPerformanceCounter() - start);
+
+		for (RigidBody* body : bodies)
+		{
+			RigidBodyState state;
+			body->SaveState(state);
+			forces[runIndex].push_back(state.m_forceAccumWs);
+			torques[runIndex].push_back(state.m_torqueAccumWs);
+		}
+	}
+
+	int numMismatches = 0;
+	for (int bodyIndex = 0; bodyIndex < numBodies; ++bodyIndex)
+	{
+		for (int runIndex = 1; runIndex < 3; ++runIndex)
+		{
+			// Relative, the SIMD math rounds a little differently
+			float forceError = (forces[0][bodyIndex] - forces[runIndex][bodyIndex]).GetLength();
+			float torqueError = (torques[0][bodyIndex] - torques[runIndex][bodyIndex]).GetLength();
+
+			if (forceError > 0.001f * (1.f + forces[0][bodyIndex].GetLength()) || torqueError > 0.001f * (1.f + torques[0][bodyIndex].GetLength()))
+			{
+				numMismatches++;
+			}
+		}
+	}
+
+	if (numMismatches == 0)
+	{
+		ConsoleLogf(Rgba::GREEN, "%i springs: one at a time %.3f ms, batched %.3f ms, batched on the job system %.3f ms, forces match", numBodies, elapsedMs[0], elapsedMs[1], elapsedMs[2]);
+	}
+	else
+	{
+		ConsoleLogErrorf("%i springs: %i batched forces differ from the generators'!", numBodies, numMismatches);
+	}
+
+	SafeDeleteVector(bodies);
+	SafeDeleteVector(springs);
+}
+
+
+//-------------------------------------------------------------------------------------------------
+void Command_BenchmarkParticleWorld(CommandArgs& args)
+{
+	float particlesArg, stepsArg;
+	args.GetNextFloat(particlesArg, 100000.f);
+	args.GetNextFloat(stepsArg, 60.f);
+	int numParticles = Max((int)particlesArg, 2);
+	int numSteps = Max((int)stepsArg, 1);
+
+	const float deltaSeconds = 1.f / 60.f;
+	const float radius = 0.5f;
+	const float spacing = 0.95f;
+
+	// Jittered cube of particles, just close enough to their neighbors to be touching, no gravity
+	ParticleWorld world(10, 16);
+	int particlesPerSide = (int)ceilf(powf((float)numParticles, 1.f / 3.f));
+	float halfExtent = 0.5f * spacing * (float)particlesPerSide;
+
+	for (int particleIndex = 0; particleIndex < numParticles; ++particleIndex)
+	{
+		int xIndex = particleIndex % particlesPerSide;
+		int yIndex = (particleIndex / particlesPerSide) % particlesPerSide;
+		int zIndex = particleIndex / (particlesPerSide * particlesPerSide);
+
+		Vector3 position = Vector3((float)xIndex, (float)yIndex, (float)zIndex) * spacing - Vector3(halfExtent);
+		position += Vector3(GetRandomFloatInRange(-0.05f, 0.05f), GetRandomFloatInRange(-0.05f, 0.05f), GetRandomFloatInRange(-0.05f, 0.05f));
+		Vector3 velocity = Vector3(GetRandomFloatInRange(-2.f, 2.f), GetRandomFloatInRange(-2.f, 2.f), GetRandomFloatInRange(-2.f, 2.f));
+
+		Particle* particle = new Particle(position, velocity);
+		particle->SetRadius(radius);
+		world.AddParticle(particle);
+	}
+
+	ConsoleLogf(Rgba::CYAN, "-----%i particles, %i steps-----", numParticles, numSteps);
+
+	// A zero-length step doesn't move anything, so the hashed contacts can be checked against testing every pair
+	// Only for small counts, the pairwise test is what the hash is replacing
+	if (numParticles <= 5000)
+	{
+		world.DoPhysicsStep(0.f);
+
+		int numPairwiseContacts = 0;
+		ParticleStorage& storage = ParticleStorage::Get();
+		std::vector<int> indices;
+
+		for (int slotIndex = 0; slotIndex < storage.GetCapacity(); ++slotIndex)
+		{
+			if (storage.m_owningWorlds[slotIndex] == &world)
+			{
+				indices.push_back(slotIndex);
+			}
+		}
+
+		for (int firstIndex = 0; firstIndex < (int)indices.size(); ++firstIndex)
+		{
+			for (int secondIndex = firstIndex + 1; secondIndex < (int)indices.size(); ++secondIndex)
+			{
+				float distanceSquared = (storage.m_position.Get(indices[firstIndex]) - storage.m_position.Get(indices[secondIndex])).GetLengthSquared();
+				if (distanceSquared < 4.f * radius * radius)
+				{
+					numPairwiseContacts++;
+				}
+			}
+		}
+
+		if (numPairwiseContacts == world.GetNumParticleContacts())
+		{
+			ConsoleLogf(Rgba::GREEN, "Spatial hash found all %i contacts", numPairwiseContacts);
+		}
+		else
+		{
+			ConsoleLogErrorf("Spatial hash found %i contacts, testing every pair found %i!", world.GetNumParticleContacts(), numPairwiseContacts);
+		}
+	}
+
+	double totalMs = 0.0;
+	double maxMs = 0.0;
+	int totalContacts = 0;
+
+	for (int stepIndex = 0; stepIndex < numSteps; ++stepIndex)
+	{
+		uint64 start = GetPerformanceCounter();
+		world.DoPhysicsStep(deltaSeconds);
+		double elapsedMs = 1000.0 * TimeSystem::PerformanceCountToSeconds(GetPerformanceCounter() - start);
+
+		totalMs += elapsedMs;
+		maxMs = Max(maxMs, elapsedMs);
+		totalContacts += world.GetNumParticleContacts();
+	}
+
+	double averageMs = totalMs / (double)numSteps;
+	int numThreads = (g_jobSystem != nullptr ? g_jobSystem->GetNumWorkerThreads() + 1 : 1);
+	Rgba color = (averageMs <= 1000.0 * deltaSeconds ? Rgba::GREEN : Rgba::YELLOW);
+
+	ConsoleLogf(color, "Average step %.3f ms, worst %.3f ms, %i contacts per step on %i threads (%.1f ms budget at 60 Hz)", averageMs, maxMs, totalContacts / numSteps, numThreads, 1000.0 * deltaSeconds);
+}
+
+
+//-------------------------------------------------------------------------------------------------
+// Drapes a cloth over a sphere onto the ground and swings a rope pinned at one end, once on this thread and
+// once on the job system - the colors make the two bit-identical, so any difference is a race
+void Command_CheckPBDRopeAndCloth(CommandArgs& args)
+{
+	float stepsArg, substepsArg;
+	args.GetNextFloat(stepsArg, 240.f);
+	args.GetNextFloat(substepsArg, (float)PBDSystem::DEFAULT_NUM_SUBSTEPS);
+	int numSteps = Max((int)stepsArg, 1);
+	int numSubsteps = Max((int)substepsArg, 1);
+
+	const float deltaSeconds = 1.f / 60.f;
+	const float particleRadius = 0.02f;
+	const Sphere ball = Sphere(Vector3(0.f, 1.f, 0.f), 1.f);
+
+	std::vector<Entity*> entities;
+
+	Entity* ground = new Entity();
+	ground->collider = new HalfSpaceCollider(ground, Plane3(Vector3::Y_AXIS, 0.f));
+	entities.push_back(ground);
+
+	Entity* ballEntity = new Entity();
+	ballEntity->collider = new SphereCollider(ballEntity, ball);
+	entities.push_back(ballEntity);
+
+	CollisionScene<BoundingVolumeSphere> collisionScene;
+	collisionScene.AddEntities(entities);
+	collisionScene.RebuildStaticBVH(); // Normally done by the first collision step
+
+	ConsoleLogf(Rgba::CYAN, "-----Cloth and rope, %i steps, %i substeps-----", numSteps, numSubsteps);
+
+	std::vector<Vector3> finalPositions[2];
+
+	for (int runIndex = 0; runIndex < 2; ++runIndex)
+	{
+		PBDSystem system;
+		system.SetCollisionScene(&collisionScene);
+		system.SetNumSubsteps(numSubsteps);
+		system.SetParticleRadius(particleRadius);
+		system.SetUseJobSystem(runIndex == 1);
+
+		int clothStart = system.CreateCloth(Vector3(-1.5f, 2.5f, -1.5f), Vector3(3.f, 0.f, 0.f), Vector3(0.f, 0.f, 3.f), 48, 48, 1.f, 0.01f);
+		int ropeStart = system.CreateRope(Vector3(3.f, 3.f, 0.f), Vector3(6.f, 3.f, 0.f), 60, 0.5f, 0.1f);
+		system.SetParticleInverseMass(ropeStart, 0.f);
+
+		double elapsedMs = 0.0;
+		for (int stepIndex = 0; stepIndex < numSteps; ++stepIndex)
+		{
+			uint64 start = GetPerformanceCounter();
+			system.Step(deltaSeconds);
+			elapsedMs += 1000.0 * TimeSystem::PerformanceCountToSeconds(GetPerformanceCounter() - start);
+		}
+
+		// Deepest any cloth particle ended up inside the ball or the ground
+		float maxPenetration = 0.f;
+		for (int particleIndex = clothStart; particleIndex < ropeStart; ++particleIndex)
+		{
+			Vector3 position = system.GetParticlePosition(particleIndex);
+			maxPenetration = Max(maxPenetration, ball.m_radius + particleRadius - (position - ball.m_center).GetLength(), particleRadius - position.y);
+		}
+
+		for (int particleIndex = 0; particleIndex < system.GetNumParticles(); ++particleIndex)
+		{
+			finalPositions[runIndex].push_back(system.GetParticlePosition(particleIndex));
+		}
+
+		float maxStretch = system.GetMaxConstraintError(PBD_CONSTRAINT_DISTANCE);
+		bool isGood = (maxStretch < 0.05f && maxPenetration < 0.5f * particleRadius);
+
+		ConsoleLogf((isGood ? Rgba::GREEN : Rgba::RED), "%s: %i particles, %i constraints in %i colors, %.3f ms/step, max stretch %.2f%%, max penetration %.4f",
+			(runIndex == 0 ? "This thread" : "Job system"), system.GetNumParticles(), system.GetNumConstraints(), system.GetNumColors(), elapsedMs / (double)numSteps, 100.f * maxStretch, maxPenetration);
+	}
+
+	int numMismatches = 0;
+	for (int particleIndex = 0; particleIndex < (int)finalPositions[0].size(); ++particleIndex)
+	{
+		if (finalPositions[0][particleIndex] != finalPositions[1][particleIndex])
+		{
+			numMismatches++;
+		}
+	}
+
+	if (numMismatches == 0)
+	{
+		ConsoleLogf(Rgba::GREEN, "Job system results are identical");
+	}
+	else
+	{
+		ConsoleLogErrorf("%i particles differ between this thread and the job system!", numMismatches);
+	}
+
+	collisionScene.RemoveAllEntities();
+
+	for (Entity* entity : entities)
+	{
+		SAFE_DELETE(entity->collider);
+		SAFE_DELETE(entity);
+	}
+}
+
+
+//-------------------------------------------------------------------------------------------------
+// Drops a cube of fluid into a tank with a ball in it, once on this thread and once on the job system
+void Command_BenchmarkFluid(CommandArgs& args)
+{
+	float particlesArg, stepsArg;
+	args.GetNextFloat(particlesArg, 16000.f);
+	args.GetNextFloat(stepsArg, 60.f);
+	int numSteps = Max((int)stepsArg, 1);
+	int numPerSide = Max((int)(powf(Max(particlesArg, 8.f), 1.f / 3.f) + 0.5f), 2);
+
+	const float deltaSeconds = 1.f / 60.f;
+	const float particleRadius = 0.025f;
+	const float blockSize = 2.f * particleRadius * (float)numPerSide;
+	const float tankWidth = 2.f * blockSize;
+	const Sphere ball = Sphere(Vector3(1.5f * blockSize, 0.f, 0.5f * blockSize), 0.25f * blockSize);
+
+	// Floor and four walls facing in, so the tank spans [0, tankWidth] in x and [0, blockSize] in z
+	std::vector<Entity*> entities;
+	const Plane3 tankPlanes[5] = { Plane3(Vector3::Y_AXIS, 0.f), Plane3(Vector3::X_AXIS, 0.f), Plane3(Vector3::MINUS_X_AXIS, -tankWidth), Plane3(Vector3::Z_AXIS, 0.f), Plane3(Vector3::MINUS_Z_AXIS, -blockSize) };
+
+	for (int planeIndex = 0; planeIndex < 5; ++planeIndex)
+	{
+		Entity* wall = new Entity();
+		wall->collider = new HalfSpaceCollider(wall, tankPlanes[planeIndex]);
+		entities.push_back(wall);
+	}
+
+	Entity* ballEntity = new Entity();
+	ballEntity->collider = new SphereCollider(ballEntity, ball);
+	entities.push_back(ballEntity);
+
+	CollisionScene<BoundingVolumeSphere> collisionScene;
+	collisionScene.AddEntities(entities);
+	collisionScene.RebuildStaticBVH(); // Normally done by the first collision step
+
+	ConsoleLogf(Rgba::CYAN, "-----Fluid dam break, %i particles, %i steps-----", numPerSide * numPerSide * numPerSide, numSteps);
+
+	std::vector<Vector3> finalPositions[2];
+
+	for (int runIndex = 0; runIndex < 2; ++runIndex)
+	{
+		FluidSystem fluid;
+		fluid.SetCollisionScene(&collisionScene);
+		fluid.SetParticleRadius(particleRadius);
+		fluid.SetUseJobSystem(runIndex == 1);
+		fluid.AddBlock(Vector3(particleRadius, particleRadius, particleRadius), IntVector3(numPerSide, numPerSide, numPerSide));
+
+		double elapsedMs = 0.0;
+		double worstMs = 0.0;
+		for (int stepIndex = 0; stepIndex < numSteps; ++stepIndex)
+		{
+			uint64 start = GetPerformanceCounter();
+			fluid.Step(deltaSeconds);
+			double stepMs = 1000.0 * TimeSystem::PerformanceCountToSeconds(GetPerformanceCounter() - start);
+
+			elapsedMs += stepMs;
+			worstMs = Max(worstMs, stepMs);
+		}
+
+		// Deepest any particle ended up past the tank or into the ball
+		float maxPenetration = 0.f;
+		for (int particleIndex = 0; particleIndex < fluid.GetNumParticles(); ++particleIndex)
+		{
+			Vector3 position = fluid.GetParticlePosition(particleIndex);
+			maxPenetration = Max(maxPenetration, ball.m_radius + particleRadius - (position - ball.m_center).GetLength());
+
+			for (int planeIndex = 0; planeIndex < 5; ++planeIndex)
+			{
+				maxPenetration = Max(maxPenetration, particleRadius - tankPlanes[planeIndex].GetDistanceFromPlane(position));
+			}
+
+			finalPositions[runIndex].push_back(position);
+		}
+
+		double averageMs = elapsedMs / (double)numSteps;
+		float densityError = fluid.GetAverageDensityError();
+		bool isGood = (densityError < 0.05f && maxPenetration < 0.5f * particleRadius);
+
+		ConsoleLogf((isGood ? Rgba::GREEN : Rgba::RED), "%s: %.3f ms/step (worst %.3f), %.1f particles/ms, average compression %.2f%%, max penetration %.4f",
+			(runIndex == 0 ? "This thread" : "Job system"), averageMs, worstMs, (double)fluid.GetNumParticles() / averageMs, 100.f * densityError, maxPenetration);
+
+		// Surface from the job system run, at the particle radius
+		if (runIndex == 1)
+		{
+			uint64 start = GetPerformanceCounter();
+			Vector3 gridOrigin;
+			Mesh* surface = fluid.CreateSurfaceMesh(particleRadius, gridOrigin);
+			double surfaceMs = 1000.0 * TimeSystem::PerformanceCountToSeconds(GetPerformanceCounter() - start);
+
+			ConsoleLogf(Rgba::WHITE, "Surface: %u triangles in %.3f ms", (surface != nullptr ? surface->GetDrawInstruction().m_elementCount / 3 : 0U), surfaceMs);
+			SAFE_DELETE(surface);
+		}
+	}
+
+	int numMismatches = 0;
+	for (int particleIndex = 0; particleIndex < (int)finalPositions[0].size(); ++particleIndex)
+	{
+		if (finalPositions[0][particleIndex] != finalPositions[1][particleIndex])
+		{
+			numMismatches++;
+		}
+	}
+
+	if (numMismatches == 0)
+	{
+		ConsoleLogf(Rgba::GREEN, "Job system results are identical");
+	}
+	else
+	{
+		ConsoleLogErrorf("%i particles differ between this thread and the job system!", numMismatches);
+	}
+
+	collisionScene.RemoveAllEntities();
+
+	for (Entity* entity : entities)
+	{
+		SAFE_DELETE(entity->collider);
+		SAFE_DELETE(entity);
+	}
+}
+
+
+//-------------------------------------------------------------------------------------------------
+// Runs the standard physics scenes, see RunPhysicsSceneBenchmarks()
+// Rows go to the console and to csvPath if one is given, so runs can be diffed and graphed
+void Command_BenchmarkPhysicsScenarios(CommandArgs& args)
+{
+	float stepsArg;
+	args.GetNextFloat(stepsArg, 120.f);
+	std::string csvPath = args.GetNextString(false);
+	int numSteps = Max((int)stepsArg, 1);
+
+	ConsoleLogf(Rgba::CYAN, "-----Physics scenarios, %i steps, times are ms per step-----", numSteps);
+	ConsoleLogf(Rgba::CYAN, "%s", PHYSICS_BENCHMARK_CSV_HEADER);
+
+	std::string csv;
+	bool allFit = RunPhysicsSceneBenchmarks(numSteps, csv);
+
+	if (!allFit)
+	{
+		ConsoleLogErrorf("A scenario ran into the pair or contact limit, its numbers are missing dropped work!");
+	}
+
+	if (csvPath.size() > 0)
+	{
+		if (FileWriteFromBuffer(csvPath.c_str(), csv.c_str(), (int)csv.size()))
+		{
+			ConsoleLogf(Rgba::GREEN, "Wrote results to %s", csvPath.c_str());
+		}
+		else
+		{
+			ConsoleLogErrorf("Couldn't write results to %s", csvPath.c_str());
+		}
+	}
+}
+
+
+//-------------------------------------------------------------------------------------------------
+// Frame deltas that don't line up with the fixed step, all under the per frame step cap
+static float GetFrameStepCheckDelta(int frameIndex)
+{
+	return 0.004f + 0.009f * (float)((frameIndex * 7) % 6);
+}
+
+
+//-------------------------------------------------------------------------------------------------
+// Runs a falling pile through FrameStep() with uneven frame deltas, then checks:
+// - The simulated state matches plain DoPhysicsStep() calls for the same number of steps
+// - Restoring a snapshot taken between frames and replaying the same deltas lands on the same state and interpolated poses
+void Command_CheckFrameStep(CommandArgs& args)
+{
+	float framesArg;
+	args.GetNextFloat(framesArg, 240.f);
+	int numFrames = Max((int)framesArg, 2);
+
+	const int numBoxes = 8;
+	const int numSpheres = 16;
+	std::vector<Entity*> entities;
+
+	Entity* floor = new Entity();
+	floor->collider = new BoxCollider(floor, OBB3(Vector3::ZERO, Vector3(20.f, 0.5f, 20.f), Quaternion::IDENTITY));
+	entities.push_back(floor);
+
+	for (int boxIndex = 0; boxIndex < numBoxes; ++boxIndex)
+	{
+		Entity* box = new Entity();
+		box->transform.position = Vector3(0.03f * (float)boxIndex, 1.f + 1.05f * (float)boxIndex, -0.02f * (float)boxIndex);
+		box->rigidBody = new RigidBody(&box->transform);
+		box->rigidBody->SetInertiaTensor_Box(Vector3(0.5f));
+		box->collider = new BoxCollider(box, OBB3(Vector3::ZERO, Vector3(0.5f), Quaternion::IDENTITY));
+		entities.push_back(box);
+	}
+
+	for (int sphereIndex = 0; sphereIndex < numSpheres; ++sphereIndex)
+	{
+		Entity* sphere = new Entity();
+		sphere->transform.position = Vector3(-3.f + 0.4f * (float)sphereIndex, 2.f + 0.5f * (float)(sphereIndex % 5), 2.f - 0.25f * (float)sphereIndex);
+		sphere->rigidBody = new RigidBody(&sphere->transform);
+		sphere->rigidBody->SetInertiaTensor_Sphere(0.4f);
+		sphere->collider = new SphereCollider(sphere, Sphere(Vector3::ZERO, 0.4f));
+		entities.push_back(sphere);
+	}
+
+	CollisionScene<BoundingVolumeSphere> collisionScene;
+	collisionScene.AddEntities(entities);
+
+	int numSteps = 0;
+	int numFixedMismatches = 0;
+	int numReplayMismatches = 0;
+	int numPoseMismatches = 0;
+	bool restored = false;
+
+	{
+		// Scoped so the bodies are deleted here, as the physics scene owns them
+		PhysicsScene physicsScene(&collisionScene);
+		std::vector<RigidBody*> bodies;
+
+		for (Entity* entity : entities)
+		{
+			if (entity->rigidBody != nullptr)
+			{
+				physicsScene.AddRigidbody(entity->rigidBody);
+				bodies.push_back(entity->rigidBody);
+			}
+		}
+
+		PhysicsSnapshot startSnapshot;
+		PhysicsSnapshot midSnapshot;
+		PhysicsSnapshot frameEndSnapshot;
+		PhysicsSnapshot checkSnapshot;
+		physicsScene.SaveSnapshot(startSnapshot);
+
+		int midFrame = numFrames / 2;
+		for (int frameIndex = 0; frameIndex < numFrames; ++frameIndex)
+		{
+			if (frameIndex == midFrame)
+			{
+				physicsScene.SaveSnapshot(midSnapshot);
+			}
+
+			physicsScene.FrameStep(GetFrameStepCheckDelta(frameIndex));
+			numSteps += physicsScene.GetNumStepsLastFrame();
+		}
+
+		physicsScene.SaveSnapshot(frameEndSnapshot);
+
+		std::vector<Transform> renderedTransforms;
+		for (RigidBody* body : bodies)
+		{
+			renderedTransforms.push_back(*body->transform);
+		}
+
+		// Same number of plain fixed steps from the start
+		restored = physicsScene.RestoreSnapshot(startSnapshot);
+		for (int stepIndex = 0; restored && stepIndex < numSteps; ++stepIndex)
+		{
+			physicsScene.DoPhysicsStep(physicsScene.GetFixedStepSeconds());
+		}
+
+		physicsScene.SaveSnapshot(checkSnapshot);
+		for (int bodyIndex = 0; bodyIndex < (int)bodies.size(); ++bodyIndex)
+		{
+			numFixedMismatches += (AreBodyStatesIdentical(checkSnapshot.m_bodyStates[bodyIndex], frameEndSnapshot.m_bodyStates[bodyIndex]) ? 0 : 1);
+		}
+
+		// Replay the second half of the frames from between two frames
+		restored = restored && physicsScene.RestoreSnapshot(midSnapshot);
+		for (int frameIndex = midFrame; restored && frameIndex < numFrames; ++frameIndex)
+		{
+			physicsScene.FrameStep(GetFrameStepCheckDelta(frameIndex));
+		}
+
+		physicsScene.SaveSnapshot(checkSnapshot);
+		for (int bodyIndex = 0; bodyIndex < (int)bodies.size(); ++bodyIndex)
+		{
+			numReplayMismatches += (AreBodyStatesIdentical(checkSnapshot.m_bodyStates[bodyIndex], frameEndSnapshot.m_bodyStates[bodyIndex]) ? 0 : 1);
+
+			const Transform& expected = renderedTransforms[bodyIndex];
+			bool posesMatch = memcmp(&expected.position, &bodies[bodyIndex]->transform->position, sizeof(Vector3)) == 0
+				&& memcmp(&expected.rotation, &bodies[bodyIndex]->transform->rotation, sizeof(Quaternion)) == 0;
+			numPoseMismatches += (posesMatch ? 0 : 1);
+		}
+
+		collisionScene.RemoveAllEntities();
+	}
+
+	for (Entity* entity : entities)
+	{
+		SAFE_DELETE(entity->collider);
+		entity->rigidBody = nullptr;
+		SAFE_DELETE(entity);
+	}
+
+	if (!restored)
+	{
+		ConsoleLogErrorf("Couldn't restore a snapshot!");
+	}
+	else if (numFixedMismatches == 0 && numReplayMismatches == 0 && numPoseMismatches == 0)
+	{
+		ConsoleLogf(Rgba::GREEN, "%i uneven frames ran %i fixed steps, bit-identical to plain stepping and to replaying from a mid-run snapshot", numFrames, numSteps);
+	}
+	else
+	{
+		ConsoleLogErrorf("%i bodies differ from plain fixed steps, %i differ after replaying from a snapshot (%i interpolated poses)", numFixedMismatches, numReplayMismatches, numPoseMismatches);
+	}
+}
+
+
+//-------------------------------------------------------------------------------------------------
+// Rests a box much wider than the triangles on a fine grid mesh, and checks the mesh query returns every triangle
+// under it and the contacts reach all four corners of its face - neither held when candidates were capped
+void Command_CheckMeshCandidates(CommandArgs& args)
+{
+	float cellsArg;
+	args.GetNextFloat(cellsArg, 64.f);
+	int numCellsPerSide = Max((int)cellsArg, 2);
+
+	// Two triangles per cell, wound so the normals point up
+	const float cellSize = 0.25f;
+	float halfWidth = 0.5f * cellSize * (float)numCellsPerSide;
+	int numVerticesPerSide = numCellsPerSide + 1;
+
+	std::vector<Vector3> positions;
+	std::vector<uint32> indices;
+	positions.reserve(numVerticesPerSide * numVerticesPerSide);
+	indices.reserve(6 * numCellsPerSide * numCellsPerSide);
+
+	for (int zIndex = 0; zIndex < numVerticesPerSide; ++zIndex)
+	{
+		for (int xIndex = 0; xIndex < numVerticesPerSide; ++xIndex)
+		{
+			positions.push_back(Vector3((float)xIndex * cellSize - halfWidth, 0.f, (float)zIndex * cellSize - halfWidth));
+		}
+	}
+
+	for (int zIndex = 0; zIndex < numCellsPerSide; ++zIndex)
+	{
+		for (int xIndex = 0; xIndex < numCellsPerSide; ++xIndex)
+		{
+			uint32 bottomLeft = zIndex * numVerticesPerSide + xIndex;
+			uint32 bottomRight = bottomLeft + 1;
+			uint32 topLeft = bottomLeft + numVerticesPerSide;
+			uint32 topRight = topLeft + 1;
+
+			indices.push_back(bottomLeft);
+			indices.push_back(topLeft);
+			indices.push_back(bottomRight);
+
+			indices.push_back(bottomRight);
+			indices.push_back(topLeft);
+			indices.push_back(topRight);
+		}
+	}
+
+	Entity* ground = new Entity();
+	TriangleMeshCollider* meshCol = new TriangleMeshCollider(ground, positions, indices);
+	ground->collider = meshCol;
+
+	Vector3 boxExtents = Vector3(0.4f * halfWidth, 0.5f, 0.4f * halfWidth);
+	Entity* box = new Entity();
+	box->transform.position = Vector3(0.f, boxExtents.y - 0.05f, 0.f);
+	box->rigidBody = new RigidBody(&box->transform);
+	box->collider = new BoxCollider(box, OBB3(Vector3::ZERO, boxExtents, Quaternion::IDENTITY));
+
+	// Every triangle whose bounds touch the box's footprint has to come back from the query
+	AABB3 queryLs = AABB3(Vector3(-boxExtents.x, -0.1f, -boxExtents.z), Vector3(boxExtents.x, 0.1f, boxExtents.z));
+	std::vector<int> foundTriangles;
+	meshCol->GetTrianglesOverlapping(queryLs, foundTriangles);
+
+	int numExpected = 0;
+	int numMissing = 0;
+	for (int triangleIndex = 0; triangleIndex < meshCol->GetNumTriangles(); ++triangleIndex)
+	{
+		Triangle3 triangleLs = meshCol->GetTriangleLs(triangleIndex);
+		Vector3 mins = Vector3(Min(triangleLs.m_a.x, Min(triangleLs.m_b.x, triangleLs.m_c.x)), Min(triangleLs.m_a.y, Min(triangleLs.m_b.y, triangleLs.m_c.y)), Min(triangleLs.m_a.z, Min(triangleLs.m_b.z, triangleLs.m_c.z)));
+		Vector3 maxs = Vector3(Max(triangleLs.m_a.x, Max(triangleLs.m_b.x, triangleLs.m_c.x)), Max(triangleLs.m_a.y, Max(triangleLs.m_b.y, triangleLs.m_c.y)), Max(triangleLs.m_a.z, Max(triangleLs.m_b.z, triangleLs.m_c.z)));
+
+		bool touchesQuery = (mins.x <= queryLs.maxs.x && maxs.x >= queryLs.mins.x && mins.y <= queryLs.maxs.y && maxs.y >= queryLs.mins.y && mins.z <= queryLs.maxs.z && maxs.z >= queryLs.mins.z);
+		if (!touchesQuery)
+			continue;
+
+		numExpected++;
+		if (std::find(foundTriangles.begin(), foundTriangles.end(), triangleIndex) == foundTriangles.end())
+		{
+			numMissing++;
+		}
+	}
+
+	// The reduced manifold should span the whole bottom face, not just the part under the first triangles found
+	CollisionDetector detector;
+	const int contactLimit = 16;
+	Contact contacts[contactLimit];
+	int numContacts = detector.GenerateContacts(box->collider, ground->collider, contacts, contactLimit);
+
+	Vector3 contactMins = Vector3(FLT_MAX);
+	Vector3 contactMaxs = Vector3(-FLT_MAX);
+	for (int contactIndex = 0; contactIndex < numContacts; ++contactIndex)
+	{
+		const Vector3& position = contacts[contactIndex].position;
+		contactMins = Vector3(Min(contactMins.x, position.x), Min(contactMins.y, position.y), Min(contactMins.z, position.z));
+		contactMaxs = Vector3(Max(contactMaxs.x, position.x), Max(contactMaxs.y, position.y), Max(contactMaxs.z, position.z));
+	}
+
+	float xCoverage = (numContacts > 0 ? (contactMaxs.x - contactMins.x) / (2.f * boxExtents.x) : 0.f);
+	float zCoverage = (numContacts > 0 ? (contactMaxs.z - contactMins.z) / (2.f * boxExtents.z) : 0.f);
+	bool coversFace = (xCoverage > 0.95f && zCoverage > 0.95f);
+
+	ConsoleLogf(Rgba::CYAN, "-----Mesh candidate check, %i triangles, %i under the box-----", meshCol->GetNumTriangles(), numExpected);
+
+	if (numMissing == 0 && coversFace)
+	{
+		ConsoleLogf(Rgba::GREEN, "Query found all %i triangles (%i with neighbors), %i contacts cover %.0f%% x %.0f%% of the box face", numExpected, (int)foundTriangles.size(), numContacts, 100.f * xCoverage, 100.f * zCoverage);
+	}
+	else
+	{
+		ConsoleLogErrorf("Query missed %i of %i triangles, %i contacts cover %.0f%% x %.0f%% of the box face", numMissing, numExpected, numContacts, 100.f * xCoverage, 100.f * zCoverage);
+	}
+
+	SAFE_DELETE(box->collider);
+	SAFE_DELETE(box->rigidBody);
+	SAFE_DELETE(box);
+	SAFE_DELETE(ground->collider);
+	SAFE_DELETE(ground);
+}
@@ -40,3 +40,19 @@ void Command_ClearLog(CommandArgs& args);
 void Command_Add(CommandArgs& args);
 void Command_Help(CommandArgs& args);
 void Command_DebugDrawWorldAxes(CommandArgs& args);
+void Command_CompareBVHBuilds(CommandArgs& args);
+void Command_CompareQBVH(CommandArgs& args);
+void Command_CheckPhysicsDeterminism(CommandArgs& args);
+void Command_CheckBatchedNarrowphase(CommandArgs& args);
+void Command_CheckNarrowphaseAllocations(CommandArgs& args);
+void Command_BenchmarkContactResolver(CommandArgs& args);
+void Command_CheckColoredContactSolver(CommandArgs& args);
+void Command_CheckBatchedIntegration(CommandArgs& args);
+void Command_CompareTowerSolvers(CommandArgs& args);
+void Command_BenchmarkForceRegistry(CommandArgs& args);
+void Command_BenchmarkParticleWorld(CommandArgs& args);
+void Command_CheckPBDRopeAndCloth(CommandArgs& args);
+void Command_BenchmarkFluid(CommandArgs& args);
+void Command_BenchmarkPhysicsScenarios(CommandArgs& args);
+void Command_CheckFrameStep(CommandArgs& args);
+void Command_CheckMeshCandidates(CommandArgs& args);
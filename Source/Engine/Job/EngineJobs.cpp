@@ -59,3 +59,32 @@ void SaveTextureJob::Execute()
 void SaveTextureJob::Finalize()
 {
 }
+
+
+//-------------------------------------------------------------------------------------------------
+ParallelForJob::ParallelForJob(const ParallelForFunction* function, int startIndex, int endIndex, std::atomic<int>* numBatchesRemaining)
+	: Job(true) // Auto finalizes
+	, m_function(function)
+	, m_startIndex(startIndex)
+	, m_endIndex(endIndex)
+	, m_numBatchesRemaining(numBatchesRemaining)
+{
+	m_jobType = PARALLEL_FOR_JOB_TYPE;
+	m_jobFlags = 0; // Any worker can run these
+}
+
+
+//-------------------------------------------------------------------------------------------------
+void ParallelForJob::Execute()
+{
+	(*m_function)(m_startIndex, m_endIndex);
+
+	// The caller may return as soon as this hits zero, so nothing it owns can be touched after
+	m_numBatchesRemaining->fetch_sub(1);
+}
+
+
+//-------------------------------------------------------------------------------------------------
+void ParallelForJob::Finalize()
+{
+}
@@ -5,6 +5,8 @@
 ///--------------------------------------------------------------------------------------------------------------------------------------------------
 #pragma once
 #include "Engine/Job/Job.h"
+#include "Engine/Job/JobSystem.h"
+#include <atomic>
 
 ///--------------------------------------------------------------------------------------------------------------------------------------------------
 /// INCLUDES
@@ -13,6 +15,7 @@
 ///--------------------------------------------------------------------------------------------------------------------------------------------------
 /// DEFINES
 ///--------------------------------------------------------------------------------------------------------------------------------------------------
+#define PARALLEL_FOR_JOB_TYPE (-2) // Game job types are expected to be non-negative
 
 ///--------------------------------------------------------------------------------------------------------------------------------------------------
 /// ENUMS, TYPEDEFS, STRUCTS, FORWARD DECLARATIONS
@@ -49,6 +52,30 @@ private:
 
 };
 
+
+//-------------------------------------------------------------------------------------------------
+// One batch of a JobSystem::ParallelFor() - the function and counter are owned by the caller, who waits on the counter
+class ParallelForJob : public Job
+{
+public:
+	//-----Public Methods-----
+
+	ParallelForJob(const ParallelForFunction* function, int startIndex, int endIndex, std::atomic<int>* numBatchesRemaining);
+
+	virtual void Execute() override;
+	virtual void Finalize() override;
+
+
+private:
+	//-----Private Data-----
+
+	const ParallelForFunction*	m_function = nullptr;
+	int							m_startIndex = 0;
+	int							m_endIndex = 0;
+	std::atomic<int>*			m_numBatchesRemaining = nullptr;
+
+};
+
 ///--------------------------------------------------------------------------------------------------------------------------------------------------
 /// C FUNCTIONS
 ///--------------------------------------------------------------------------------------------------------------------------------------------------
@@ -7,9 +7,11 @@
 ///--------------------------------------------------------------------------------------------------------------------------------------------------
 /// INCLUDES
 ///--------------------------------------------------------------------------------------------------------------------------------------------------
+#include "Engine/Job/EngineJobs.h"
 #include "Engine/Job/Job.h"
 #include "Engine/Job/JobSystem.h"
 #include "Engine/Job/JobWorkerThread.h"
+#include "Engine/Math/MathUtils.h"
 
 ///--------------------------------------------------------------------------------------------------------------------------------------------------
 /// DEFINES
@@ -28,6 +30,20 @@ JobSystem* g_jobSystem = nullptr;
 /// C FUNCTIONS
 ///--------------------------------------------------------------------------------------------------------------------------------------------------
 
+//-------------------------------------------------------------------------------------------------
+// For systems with their own switch to run on one thread, e.g. to check the job system gives the same results
+void ParallelForIfEnabled(bool useJobSystem, int count, int minBatchSize, const ParallelForFunction& function)
+{
+	if (useJobSystem && g_jobSystem != nullptr)
+	{
+		g_jobSystem->ParallelFor(count, minBatchSize, function);
+	}
+	else if (count > 0)
+	{
+		function(0, count);
+	}
+}
+
 ///--------------------------------------------------------------------------------------------------------------------------------------------------
 /// CLASS IMPLEMENTATIONS
 ///--------------------------------------------------------------------------------------------------------------------------------------------------
@@ -136,6 +152,56 @@ int JobSystem::QueueJob(Job* job)
 
 
 
+//-------------------------------------------------------------------------------------------------
+// Splits the range into one batch per thread (including this one), so this should be called with
+// enough work per batch to outweigh the queueing - use minBatchSize to keep small ranges on this thread
+void JobSystem::ParallelFor(int count, int minBatchSize, const ParallelForFunction& function)
+{
+	if (count <= 0)
+		return;
+
+	minBatchSize = Max(minBatchSize, 1);
+	int maxBatches = (count + minBatchSize - 1) / minBatchSize;
+	int numBatches = Min(GetNumWorkerThreads() + 1, maxBatches);
+
+	if (numBatches <= 1)
+	{
+		function(0, count);
+		return;
+	}
+
+	std::atomic<int> numBatchesRemaining(numBatches - 1);
+
+	for (int batchIndex = 1; batchIndex < numBatches; ++batchIndex)
+	{
+		int startIndex = (count * batchIndex) / numBatches;
+		int endIndex = (count * (batchIndex + 1)) / numBatches;
+
+		QueueJob(new ParallelForJob(&function, startIndex, endIndex, &numBatchesRemaining));
+	}
+
+	// First batch is ours
+	function(0, count / numBatches);
+
+	// Take back any batches the workers haven't picked up yet rather than waiting on them to wake up
+	while (numBatchesRemaining.load() > 0)
+	{
+		Job* job = DequeueJobOfType(PARALLEL_FOR_JOB_TYPE);
+
+		if (job != nullptr)
+		{
+			job->Execute();
+			job->Finalize();
+			delete job;
+		}
+		else
+		{
+			std::this_thread::yield();
+		}
+	}
+}
+
+
 //-------------------------------------------------------------------------------------------------
 // This is probably slow and will interfere heavily with workerthreads if called repeatedly
 JobStatus JobSystem::GetJobStatus(int jobID)
@@ -430,3 +496,29 @@ int JobSystem::GetNextJobID()
 {
 	return m_nextJobID++;
 }
+
+
+//-------------------------------------------------------------------------------------------------
+// Removes the first queued job of the type without running it, so the caller can run it themselves
+Job* JobSystem::DequeueJobOfType(int jobType)
+{
+	Job* job = nullptr;
+
+	m_queuedLock.lock();
+	{
+		int numQueued = (int)m_queuedJobs.size();
+
+		for (int queuedIndex = 0; queuedIndex < numQueued; ++queuedIndex)
+		{
+			if (m_queuedJobs[queuedIndex]->m_jobType == jobType)
+			{
+				job = m_queuedJobs[queuedIndex];
+				m_queuedJobs.erase(m_queuedJobs.begin() + queuedIndex);
+				break;
+			}
+		}
+	}
+	m_queuedLock.unlock();
+
+	return job;
+}
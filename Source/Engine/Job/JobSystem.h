@@ -9,6 +9,7 @@
 /// INCLUDES
 ///--------------------------------------------------------------------------------------------------------------------------------------------------
 #include "Engine/Core/EngineCommon.h"
+#include <functional>
 #include <shared_mutex>
 #include <vector>
 #include <thread>
@@ -22,6 +23,8 @@
 ///--------------------------------------------------------------------------------------------------------------------------------------------------
 class Job;
 
+typedef std::function<void(int startIndex, int endIndex)> ParallelForFunction; // Processes indices in [startIndex, endIndex)
+
 enum JobStatus
 {
 	JOB_STATUS_QUEUED,
@@ -61,6 +64,8 @@ public:
 	void				DestroyAllWorkerThreads();
 
 	int					QueueJob(Job* job);
+	void				ParallelFor(int count, int minBatchSize, const ParallelForFunction& function); // Blocks until done, calling thread works on batches too
+	int					GetNumWorkerThreads() const { return (int)m_workerThreads.size(); }
 
 	JobStatus			GetJobStatus(int jobID);
 	bool				IsJobFinished(int jobID);
@@ -81,6 +86,7 @@ private:
 
 	void				DestroyAllJobs();
 	int					GetNextJobID();
+	Job*				DequeueJobOfType(int jobType);
 
 
 private:
@@ -111,3 +117,4 @@ private:
 ///--------------------------------------------------------------------------------------------------------------------------------------------------
 /// C FUNCTIONS
 ///--------------------------------------------------------------------------------------------------------------------------------------------------
+void ParallelForIfEnabled(bool useJobSystem, int count, int minBatchSize, const ParallelForFunction& function); // On g_jobSystem if asked for and it exists, otherwise all on this thread
@@ -32,71 +32,82 @@ typedef std::pair<int, int> HalfEdgeKey;
 /// C FUNCTIONS
 ///--------------------------------------------------------------------------------------------------------------------------------------------------
 
-///--------------------------------------------------------------------------------------------------------------------------------------------------
-/// CLASS IMPLEMENTATIONS
-///--------------------------------------------------------------------------------------------------------------------------------------------------
+//-------------------------------------------------------------------------------------------------
+// One Sutherland-Hodgman pass, keeping the part of the polygon behind the plane
+// Returns the number of vertices written, never more than maxOutput
+static int ClipPolygonToPlane(const Vector3* input, int numInput, const Plane3& plane, Vector3* out_vertices, int maxOutput)
+{
+	int numOutput = 0;
+
+	for (int iCurrVertex = 0; iCurrVertex < numInput && numOutput < maxOutput; ++iCurrVertex)
+	{
+		int iPrevVertex = (iCurrVertex == 0 ? numInput - 1 : iCurrVertex - 1);
+
+		Vector3 curr = input[iCurrVertex];
+		Vector3 prev = input[iPrevVertex];
+
+		bool currInside = plane.GetDistanceFromPlane(curr) < 0.f;
+		bool prevInside = plane.GetDistanceFromPlane(prev) < 0.f;
+
+		if (currInside != prevInside)
+		{
+			Maybe<Vector3> intersectionPt = ComputeIntersection(LineSegment3(prev, curr), plane);
+			ASSERT_OR_DIE(intersectionPt.IsValid(), "Couldn't find clip point!");
+
+			out_vertices[numOutput++] = intersectionPt.Get();
+		}
+
+		if (currInside && numOutput < maxOutput)
+		{
+			out_vertices[numOutput++] = curr;
+		}
+	}
+
+	return numOutput;
+}
 
 
 //-------------------------------------------------------------------------------------------------
-Polyhedron::Polyhedron(const OBB3& box)
+// Same as above, with no limit on the output
+static void ClipPolygonToPlane(const std::vector<Vector3>& input, const Plane3& plane, std::vector<Vector3>& out_vertices)
 {
-	Vector3 points[8];
-	box.GetPoints(points);
+	out_vertices.clear();
+	int numInput = (int)input.size();
 
-	for (int i = 0; i < 8; ++i)
+	for (int iCurrVertex = 0; iCurrVertex < numInput; ++iCurrVertex)
 	{
-		m_vertices.push_back(PolyhedronVertex(points[i]));
+		int iPrevVertex = (iCurrVertex == 0 ? numInput - 1 : iCurrVertex - 1);
+
+		Vector3 curr = input[iCurrVertex];
+		Vector3 prev = input[iPrevVertex];
+
+		bool currInside = plane.GetDistanceFromPlane(curr) < 0.f;
+		bool prevInside = plane.GetDistanceFromPlane(prev) < 0.f;
+
+		if (currInside != prevInside)
+		{
+			Maybe<Vector3> intersectionPt = ComputeIntersection(LineSegment3(prev, curr), plane);
+			ASSERT_OR_DIE(intersectionPt.IsValid(), "Couldn't find clip point!");
+
+			out_vertices.push_back(intersectionPt.Get());
+		}
+
+		if (currInside)
+		{
+			out_vertices.push_back(curr);
+		}
 	}
+}
+
+///--------------------------------------------------------------------------------------------------------------------------------------------------
+/// CLASS IMPLEMENTATIONS
+///--------------------------------------------------------------------------------------------------------------------------------------------------
+
 
-	// Back
-	PolyhedronFace back;
-	back.m_indices.push_back(0);
-	back.m_indices.push_back(1);
-	back.m_indices.push_back(2);
-	back.m_indices.push_back(3);
-	m_faces.push_back(back);
-
-	// Front
-	PolyhedronFace front;
-	front.m_indices.push_back(4);
-	front.m_indices.push_back(5);
-	front.m_indices.push_back(6);
-	front.m_indices.push_back(7);
-	m_faces.push_back(front);
-
-	// Left
-	PolyhedronFace left;
-	left.m_indices.push_back(7);
-	left.m_indices.push_back(6);
-	left.m_indices.push_back(1);
-	left.m_indices.push_back(0);
-	m_faces.push_back(left);
-
-	// Right
-	PolyhedronFace right;
-	right.m_indices.push_back(3);
-	right.m_indices.push_back(2);
-	right.m_indices.push_back(5);
-	right.m_indices.push_back(4);
-	m_faces.push_back(right);
-
-	// Bottom
-	PolyhedronFace bottom;
-	bottom.m_indices.push_back(7);
-	bottom.m_indices.push_back(0);
-	bottom.m_indices.push_back(3);
-	bottom.m_indices.push_back(4);
-	m_faces.push_back(bottom);
-
-	// Top
-	PolyhedronFace top;
-	top.m_indices.push_back(1);
-	top.m_indices.push_back(6);
-	top.m_indices.push_back(5);
-	top.m_indices.push_back(2);
-	m_faces.push_back(top);
-
-	GenerateHalfEdgeStructure();
+//-------------------------------------------------------------------------------------------------
+Polyhedron::Polyhedron(const OBB3& box)
+{
+	SetFromBox(box);
 }
 
 
@@ -105,10 +116,27 @@ void Polyhedron::Clear()
 {
 	m_vertices.clear();
 	m_faces.clear();
+	m_faceIndices.clear();
 	m_edges.clear();
 }
 
 
+//-------------------------------------------------------------------------------------------------
+// Copies the shared box topology and only writes the positions, so an existing polyhedron's storage is reused
+void Polyhedron::SetFromBox(const OBB3& box)
+{
+	(*this) = GetBoxTopology();
+
+	Vector3 points[8];
+	box.GetPoints(points);
+
+	for (int i = 0; i < 8; ++i)
+	{
+		m_vertices[i].m_position = points[i];
+	}
+}
+
+
 //-------------------------------------------------------------------------------------------------
 void Polyhedron::GenerateHalfEdgeStructure()
 {
@@ -125,15 +153,15 @@ void Polyhedron::GenerateHalfEdgeStructure()
 	for (int faceIndex = 0; faceIndex < numFaces; ++faceIndex)
 	{
 		PolyhedronFace& face = m_faces[faceIndex];
-		int numIndices = (int)face.m_indices.size();
+		int numIndices = face.m_numIndices;
 		ASSERT_OR_DIE(numIndices > 2, "Not enough indices in face!");
 
 		for (int i = 0; i < numIndices; ++i)
 		{
 			int j = (i + 1) % numIndices;
 
-			int vertexIndex1 = face.m_indices[i];
-			int vertexIndex2 = face.m_indices[j];
+			int vertexIndex1 = m_faceIndices[face.m_firstIndex + i];
+			int vertexIndex2 = m_faceIndices[face.m_firstIndex + j];
 
 			HalfEdge halfEdge;
 			halfEdge.m_faceIndex = faceIndex;
@@ -155,14 +183,14 @@ void Polyhedron::GenerateHalfEdgeStructure()
 	for (int faceIndex = 0; faceIndex < numFaces; ++faceIndex)
 	{
 		PolyhedronFace& face = m_faces[faceIndex];
-		int numIndices = (int)face.m_indices.size();
+		int numIndices = face.m_numIndices;
 
 		for (int i = 0; i < numIndices; ++i)
 		{
 			int j = (i + 1) % numIndices;
 
-			int vertexIndexI = face.m_indices[i];
-			int vertexIndexJ = face.m_indices[j];
+			int vertexIndexI = m_faceIndices[face.m_firstIndex + i];
+			int vertexIndexJ = m_faceIndices[face.m_firstIndex + j];
 
 			HalfEdgeKey currEdgeKey(vertexIndexI, vertexIndexJ);
 			int currEdgeIndex = edgeIndexMap.at(currEdgeKey);
@@ -171,7 +199,7 @@ void Polyhedron::GenerateHalfEdgeStructure()
 			// Connect the next/prev edges
 			{
 				int k = (j + 1) % numIndices;
-				int vertexIndexK = face.m_indices[k];
+				int vertexIndexK = m_faceIndices[face.m_firstIndex + k];
 
 				HalfEdgeKey nextEdgeKey(vertexIndexJ, vertexIndexK);
 				int nextEdgeIndex = edgeIndexMap[nextEdgeKey];
@@ -239,10 +267,19 @@ int Polyhedron::AddVertex(const Vector3& vertex)
 
 //-------------------------------------------------------------------------------------------------
 int Polyhedron::AddFace(const std::vector<int>& indices)
+{
+	return AddFace(indices.data(), (int)indices.size());
+}
+
+
+//-------------------------------------------------------------------------------------------------
+int Polyhedron::AddFace(const int* indices, int numIndices)
 {
 	ASSERT_OR_DIE(!HasGeneratedHalfEdges(), "Cannot edit a Polygon3d after half edges are generated!");
 
-	m_faces.push_back(PolyhedronFace(indices));
+	m_faces.push_back(PolyhedronFace((int)m_faceIndices.size(), numIndices));
+	m_faceIndices.insert(m_faceIndices.end(), indices, indices + numIndices);
+
 	return (int)(m_faces.size() - 1);
 }
 
@@ -255,18 +292,20 @@ const PolyhedronVertex* Polyhedron::GetVertex(int vertexIndex) const
 
 
 //-------------------------------------------------------------------------------------------------
+// Assigns rather than clears so out_polygon keeps its capacity - calling this on a reused polyhedron doesn't allocate
 void Polyhedron::GetTransformed(const Matrix4& matrix, Polyhedron& out_polygon) const
 {
-	out_polygon.Clear();
-
 	int numVertices = (int)m_vertices.size();
+	out_polygon.m_vertices.resize(numVertices);
+
 	for (int vertexIndex = 0; vertexIndex < numVertices; ++vertexIndex)
 	{
 		Vector3 position = matrix.TransformPosition(m_vertices[vertexIndex].m_position);
-		out_polygon.m_vertices.push_back(PolyhedronVertex(position, m_vertices[vertexIndex].m_halfEdgeIndex));
+		out_polygon.m_vertices[vertexIndex] = PolyhedronVertex(position, m_vertices[vertexIndex].m_halfEdgeIndex);
 	}
 
 	out_polygon.m_faces = m_faces;
+	out_polygon.m_faceIndices = m_faceIndices;
 	out_polygon.m_edges = m_edges;
 }
 
@@ -294,6 +333,28 @@ void Polyhedron::GetAllVerticesInFace(int faceIndex, std::vector<Vector3>& out_v
 }
 
 
+//-------------------------------------------------------------------------------------------------
+// Same half edge order as above, returns the number of vertices written
+// Faces bigger than the buffer are cut short with a warning, use the std::vector version for those
+int Polyhedron::GetAllVerticesInFace(int faceIndex, Vector3* out_vertices, int maxVertices) const
+{
+	ASSERT_RECOVERABLE(GetNumVerticesInFace(faceIndex) <= maxVertices, "Face has too many vertices for the buffer!");
+
+	int startingEdge = GetFace(faceIndex)->m_halfEdgeIndex;
+	int edgeIndex = startingEdge;
+	int numVertices = 0;
+
+	do
+	{
+		const HalfEdge* edge = GetEdge(edgeIndex);
+		out_vertices[numVertices++] = GetVertexPosition(edge->m_vertexIndex);
+		edgeIndex = edge->m_nextEdgeIndex;
+	} while (edgeIndex != startingEdge && numVertices < maxVertices);
+
+	return numVertices;
+}
+
+
 //-------------------------------------------------------------------------------------------------
 const PolyhedronFace* Polyhedron::GetFace(int faceIndex) const
 {
@@ -306,12 +367,11 @@ void Polyhedron::GetFace(int faceIndex, Polygon3& out_face) const
 {
 	out_face.Clear();
 
-	const PolyhedronFace* face = GetFace(faceIndex);
-	int numIndices = (int)face->m_indices.size();
+	int numIndices = GetNumVerticesInFace(faceIndex);
 
 	for (int iIndex = 0; iIndex < numIndices; ++iIndex)
 	{
-		int iVertex = face->m_indices[iIndex];
+		int iVertex = GetFaceVertexIndex(faceIndex, iIndex);
 		Vector3 vertex = GetVertexPosition(iVertex);
 
 		out_face.m_vertices.push_back(vertex);
@@ -319,6 +379,24 @@ void Polyhedron::GetFace(int faceIndex, Polygon3& out_face) const
 }
 
 
+//-------------------------------------------------------------------------------------------------
+// Returns the number of vertices written, in index order
+// Faces bigger than the buffer are cut short with a warning, use the Polygon3 version for those
+int Polyhedron::GetFace(int faceIndex, Vector3* out_vertices, int maxVertices) const
+{
+	int numIndices = GetNumVerticesInFace(faceIndex);
+	ASSERT_RECOVERABLE(numIndices <= maxVertices, "Face has too many vertices for the buffer!");
+	numIndices = Min(numIndices, maxVertices);
+
+	for (int iIndex = 0; iIndex < numIndices; ++iIndex)
+	{
+		out_vertices[iIndex] = GetVertexPosition(GetFaceVertexIndex(faceIndex, iIndex));
+	}
+
+	return numIndices;
+}
+
+
 //-------------------------------------------------------------------------------------------------
 const PolyhedronFace* Polyhedron::GetFaceMostInDirection(const Vector3& direction) const
 {
@@ -354,13 +432,12 @@ int Polyhedron::GetIndexOfFaceMostInDirection(const Vector3& direction) const
 //-------------------------------------------------------------------------------------------------
 Vector3 Polyhedron::GetFaceNormal(int faceIndex) const
 {
-	const PolyhedronFace* face = GetFace(faceIndex);
-	ASSERT_OR_DIE(face->m_indices.size() > 2, "Not enough vertices!");
+	ASSERT_OR_DIE(GetNumVerticesInFace(faceIndex) > 2, "Not enough vertices!");
 
 	// Get the positions
-	Vector3 a = GetVertexPosition(face->m_indices[0]);
-	Vector3 b = GetVertexPosition(face->m_indices[1]);
-	Vector3 c = GetVertexPosition(face->m_indices[2]);
+	Vector3 a = GetVertexPosition(GetFaceVertexIndex(faceIndex, 0));
+	Vector3 b = GetVertexPosition(GetFaceVertexIndex(faceIndex, 1));
+	Vector3 c = GetVertexPosition(GetFaceVertexIndex(faceIndex, 2));
 
 	return CalculateNormalForTriangle(a, b, c);
 }
@@ -372,8 +449,7 @@ Plane3 Polyhedron::GetFaceSupportPlane(int faceIndex) const
 	Vector3 normal = GetFaceNormal(faceIndex);
 
 	// Get a position on the plane
-	const PolyhedronFace* face = GetFace(faceIndex);
-	Vector3 p = GetVertexPosition(face->m_indices[0]);
+	Vector3 p = GetVertexPosition(GetFaceVertexIndex(faceIndex, 0));
 
 	// Get the distance between origin and plane
 	float distance = DotProduct(normal, p);
@@ -493,10 +569,10 @@ bool Polyhedron::IsConvex() const
 			if (iPlane == iCheckFace)
 				continue;
 
-			const PolyhedronFace& face = m_faces[iCheckFace];
-			for (int iVertex : face.m_indices)
+			int numIndices = GetNumVerticesInFace(iCheckFace);
+			for (int iIndex = 0; iIndex < numIndices; ++iIndex)
 			{
-				Vector3 vertex = GetVertexPosition(iVertex);
+				Vector3 vertex = GetVertexPosition(GetFaceVertexIndex(iCheckFace, iIndex));
 
 				if (plane.GetDistanceFromPlane(vertex) > DEFAULT_EPSILON)
 					return false;
@@ -539,24 +615,51 @@ void Polyhedron::GetFaceSidePlanes(int faceIndex, std::vector<Plane3>& out_plane
 {
 	out_planes.clear();
 
+	Vector3 faceNormal = GetFaceNormal(faceIndex);
+	int startingEdgeIndex = GetFace(faceIndex)->m_halfEdgeIndex;
+	int edgeIndex = startingEdgeIndex;
+
+	do
+	{
+		out_planes.push_back(GetEdgeSidePlane(edgeIndex, faceNormal));
+		edgeIndex = GetEdge(edgeIndex)->m_nextEdgeIndex;
+	} while (edgeIndex != startingEdgeIndex);
+}
+
+
+//-------------------------------------------------------------------------------------------------
+// Returns the number of planes written
+// Faces with more edges than the buffer are cut short with a warning, use the std::vector version for those
+int Polyhedron::GetFaceSidePlanes(int faceIndex, Plane3* out_planes, int maxPlanes) const
+{
 	const PolyhedronFace* refFace = GetFace(faceIndex);
 	Vector3 refFaceNormal = GetFaceNormal(faceIndex);
+	ASSERT_RECOVERABLE(refFace->m_numIndices <= maxPlanes, "Face has too many edges for the buffer!");
 
 	int startingEdgeIndex = refFace->m_halfEdgeIndex;
 	int edgeIndex = startingEdgeIndex;
+	int numPlanes = 0;
 
 	do
 	{
-		Vector3 edgeDir = GetEdgeDirection(edgeIndex);
-		Vector3 refEdgeNormal = CrossProduct(edgeDir, refFaceNormal); // Outward pointing normal, assuming clockwise winding
-		refEdgeNormal.Normalize();
+		out_planes[numPlanes++] = GetEdgeSidePlane(edgeIndex, refFaceNormal);
+		edgeIndex = GetEdge(edgeIndex)->m_nextEdgeIndex;
+	} while (edgeIndex != startingEdgeIndex && numPlanes < maxPlanes);
 
-		const HalfEdge* edge = GetEdge(edgeIndex);
-		float d = DotProduct(refEdgeNormal, GetVertexPosition(edge->m_vertexIndex));
-		out_planes.push_back(Plane3(refEdgeNormal, d));
+	return numPlanes;
+}
 
-		edgeIndex = edge->m_nextEdgeIndex;
-	} while (edgeIndex != startingEdgeIndex);
+
+//-------------------------------------------------------------------------------------------------
+// Outward pointing plane through the edge, perpendicular to its face
+Plane3 Polyhedron::GetEdgeSidePlane(int edgeIndex, const Vector3& faceNormal) const
+{
+	Vector3 edgeDir = GetEdgeDirection(edgeIndex);
+	Vector3 edgeNormal = CrossProduct(edgeDir, faceNormal); // Outward pointing normal, assuming clockwise winding
+	edgeNormal.Normalize();
+
+	float d = DotProduct(edgeNormal, GetVertexPosition(GetEdge(edgeIndex)->m_vertexIndex));
+	return Plane3(edgeNormal, d);
 }
 
 
@@ -564,15 +667,16 @@ void Polyhedron::GetFaceSidePlanes(int faceIndex, std::vector<Plane3>& out_plane
 // Returns true if the segment is over the face and was even up for consideration for clipping
 bool Polyhedron::ClipEdgeToFace(int faceIndex, LineSegment3& inout_edge) const
 {
+	// Side planes are made as they're needed, so faces of any size work without a buffer
 	Vector3 faceNormal = GetFaceNormal(faceIndex);
-
-	std::vector<Plane3> sidePlanes;
-	GetFaceSidePlanes(faceIndex, sidePlanes);
+	int startingEdgeIndex = GetFace(faceIndex)->m_halfEdgeIndex;
+	int edgeIndex = startingEdgeIndex;
 
 	// Can't clip the segment if it never even crosses the face
-	for (int iSidePlane = 0; iSidePlane < (int)sidePlanes.size(); ++iSidePlane)
+	do
 	{
-		const Plane3& sidePlane = sidePlanes[iSidePlane];
+		Plane3 sidePlane = GetEdgeSidePlane(edgeIndex, faceNormal);
+		edgeIndex = GetEdge(edgeIndex)->m_nextEdgeIndex;
 
 		float aDistance = sidePlane.GetDistanceFromPlane(inout_edge.m_a);
 		float bDistance = sidePlane.GetDistanceFromPlane(inout_edge.m_b);
@@ -585,11 +689,12 @@ bool Polyhedron::ClipEdgeToFace(int faceIndex, LineSegment3& inout_edge) const
 		// Double positive means for certain it's not over the face
 		if (aDistance > 0.f && bDistance > 0.f)
 			return false;
-	}
+	} while (edgeIndex != startingEdgeIndex);
 
-	for (int iSidePlane = 0; iSidePlane < (int)sidePlanes.size(); ++iSidePlane)
+	do
 	{
-		const Plane3& sidePlane = sidePlanes[iSidePlane];
+		Plane3 sidePlane = GetEdgeSidePlane(edgeIndex, faceNormal);
+		edgeIndex = GetEdge(edgeIndex)->m_nextEdgeIndex;
 
 		for (int i = 0; i < 2; ++i)
 		{
@@ -611,7 +716,7 @@ bool Polyhedron::ClipEdgeToFace(int faceIndex, LineSegment3& inout_edge) const
 				}
 			}
 		}
-	}
+	} while (edgeIndex != startingEdgeIndex);
 
 	return true;
 }
@@ -620,56 +725,121 @@ bool Polyhedron::ClipEdgeToFace(int faceIndex, LineSegment3& inout_edge) const
 //-------------------------------------------------------------------------------------------------
 void Polyhedron::ClipFaceToFace(int faceIndex, Polygon3& inout_faceToClip) const
 {
-	std::vector<Plane3> edgePlanes;
-	GetFaceSidePlanes(faceIndex, edgePlanes);
+	static thread_local std::vector<Vector3> s_scratchVertices;
+	ClipPolygonToFace(faceIndex, inout_faceToClip.m_vertices, s_scratchVertices);
+}
 
-	for (Plane3 plane : edgePlanes)
+
+//-------------------------------------------------------------------------------------------------
+// Sutherland-Hodgman against the face's side planes, ping-ponging between the two vectors
+// No limit on the face or polygon size, and doesn't allocate once the vectors have grown to fit
+void Polyhedron::ClipPolygonToFace(int faceIndex, std::vector<Vector3>& inout_vertices, std::vector<Vector3>& scratchVertices) const
+{
+	Vector3 faceNormal = GetFaceNormal(faceIndex);
+	int startingEdgeIndex = GetFace(faceIndex)->m_halfEdgeIndex;
+	int edgeIndex = startingEdgeIndex;
+
+	do
 	{
-		std::vector<Vector3> input = inout_faceToClip.m_vertices;
-		inout_faceToClip.Clear();
+		ClipPolygonToPlane(inout_vertices, GetEdgeSidePlane(edgeIndex, faceNormal), scratchVertices);
+		inout_vertices.swap(scratchVertices);
+		edgeIndex = GetEdge(edgeIndex)->m_nextEdgeIndex;
+	} while (edgeIndex != startingEdgeIndex);
+}
+
 
-		int numVertices = (int)input.size();
-		for (int iCurrVertex = 0; iCurrVertex < numVertices; ++iCurrVertex)
+//-------------------------------------------------------------------------------------------------
+// Same as above, ping-ponging between two stack buffers when they're sure to be big enough
+// Each side plane adds at most one vertex to a convex polygon, anything bigger goes through the std::vector version
+// Returns the number of vertices written to out_clippedVertices, which is cut short with a warning if it's too small
+int Polyhedron::ClipPolygonToFace(int faceIndex, const Vector3* vertices, int numVertices, Vector3* out_clippedVertices, int maxClippedVertices) const
+{
+	int numSidePlanes = GetNumVerticesInFace(faceIndex);
+	const Vector3* clipped = nullptr;
+	int numClipped = 0;
+
+	Vector3 buffers[2][MAX_CLIP_VERTICES];
+
+	if (numVertices + numSidePlanes <= MAX_CLIP_VERTICES)
+	{
+		for (int i = 0; i < numVertices; ++i)
 		{
-			int iPrevVertex = (iCurrVertex == 0 ? numVertices - 1 : iCurrVertex - 1);
+			buffers[0][i] = vertices[i];
+		}
 
-			Vector3 curr = input[iCurrVertex];
-			Vector3 prev = input[iPrevVertex];
+		Vector3 faceNormal = GetFaceNormal(faceIndex);
+		int startingEdgeIndex = GetFace(faceIndex)->m_halfEdgeIndex;
+		int edgeIndex = startingEdgeIndex;
+		int inputBuffer = 0;
+		numClipped = numVertices;
 
-			bool currInside = plane.GetDistanceFromPlane(curr) < 0.f;
-			bool prevInside = plane.GetDistanceFromPlane(prev) < 0.f;
+		do
+		{
+			numClipped = ClipPolygonToPlane(buffers[inputBuffer], numClipped, GetEdgeSidePlane(edgeIndex, faceNormal), buffers[1 - inputBuffer], MAX_CLIP_VERTICES);
+			inputBuffer = 1 - inputBuffer;
+			edgeIndex = GetEdge(edgeIndex)->m_nextEdgeIndex;
+		} while (edgeIndex != startingEdgeIndex);
 
-			if (currInside)
-			{
-				if (!prevInside)
-				{
-					Maybe<Vector3> intersectionPt = ComputeIntersection(LineSegment3(prev, curr), plane);
-					if (!intersectionPt.IsValid())
-					{
-						int x = 0;
-						x = 4;
-					}
-					ASSERT_OR_DIE(intersectionPt.IsValid(), "Couldn't find clip point!");
-
-					inout_faceToClip.m_vertices.push_back(intersectionPt.Get());
-				}
+		clipped = buffers[inputBuffer];
+	}
+	else
+	{
+		static thread_local std::vector<Vector3> s_clipVertices[2];
+		s_clipVertices[0].assign(vertices, vertices + numVertices);
+		ClipPolygonToFace(faceIndex, s_clipVertices[0], s_clipVertices[1]);
 
-				inout_faceToClip.m_vertices.push_back(curr);
-			}
-			else if (prevInside)
-			{
-				Maybe<Vector3> intersectionPt = ComputeIntersection(LineSegment3(prev, curr), plane);
-				if (!intersectionPt.IsValid())
-				{
-					int x = 0;
-					x = 4;
-				}
-				ASSERT_OR_DIE(intersectionPt.IsValid(), "Couldn't find clip point!");
+		clipped = s_clipVertices[0].data();
+		numClipped = (int)s_clipVertices[0].size();
+	}
 
-				inout_faceToClip.m_vertices.push_back(intersectionPt.Get());
-			}
-		}
+	ASSERT_RECOVERABLE(numClipped <= maxClippedVertices, "Clipped polygon has %i vertices but the output buffer only holds %i!", numClipped, maxClippedVertices);
+	numClipped = Min(numClipped, maxClippedVertices);
+
+	for (int i = 0; i < numClipped; ++i)
+	{
+		out_clippedVertices[i] = clipped[i];
 	}
+
+	return numClipped;
+}
+
+
+//-------------------------------------------------------------------------------------------------
+// Shared topology for SetFromBox, built once - only the positions differ between boxes
+const Polyhedron& Polyhedron::GetBoxTopology()
+{
+	static const Polyhedron s_boxTopology = CreateBoxTopology();
+	return s_boxTopology;
+}
+
+
+//-------------------------------------------------------------------------------------------------
+Polyhedron Polyhedron::CreateBoxTopology()
+{
+	Polyhedron boxTopology;
+
+	for (int i = 0; i < 8; ++i)
+	{
+		boxTopology.AddVertex(Vector3::ZERO);
+	}
+
+	const int back[4] = { 0, 1, 2, 3 };
+	const int front[4] = { 4, 5, 6, 7 };
+	const int left[4] = { 7, 6, 1, 0 };
+	const int right[4] = { 3, 2, 5, 4 };
+	const int bottom[4] = { 7, 0, 3, 4 };
+	const int top[4] = { 1, 6, 5, 2 };
+
+	boxTopology.AddFace(back, 4);
+	boxTopology.AddFace(front, 4);
+	boxTopology.AddFace(left, 4);
+	boxTopology.AddFace(right, 4);
+	boxTopology.AddFace(bottom, 4);
+	boxTopology.AddFace(top, 4);
+
+	boxTopology.GenerateHalfEdgeStructure();
+
+	return boxTopology;
 }
 
 
@@ -689,15 +859,10 @@ const HalfEdge* UniqueHalfEdgeIterator::GetNext()
 		// Get the next edge
 		const HalfEdge* currEdge = m_polyhedron.GetEdge(m_currIndex);
 
-		// Check if this edge's mirror has been visited already
-		bool mirrorVisited = std::find(m_visitedList.begin(), m_visitedList.end(), currEdge->m_mirrorEdgeIndex) != m_visitedList.end();
-
-		if (!mirrorVisited)
+		// Edges are visited in index order, so the lower index of each mirror pair is always reached first
+		if (currEdge->m_edgeIndex < currEdge->m_mirrorEdgeIndex)
 		{
-			m_visitedList.push_back(m_currIndex);
-			m_visitedList.push_back(currEdge->m_mirrorEdgeIndex);
 			++m_currIndex;
-
 			return currEdge;
 		}
 	}
@@ -42,15 +42,17 @@ struct PolyhedronVertex
 
 
 //-------------------------------------------------------------------------------------------------
+// Indices live in one flat array on the Polyhedron so copies don't allocate per face
 struct PolyhedronFace
 {
 	PolyhedronFace() {}
-	PolyhedronFace(const std::vector<int> indices)
-		: m_indices(indices) {}
+	PolyhedronFace(int firstIndex, int numIndices)
+		: m_firstIndex(firstIndex), m_numIndices(numIndices) {}
 
 
-	std::vector<int>	m_indices;
-	int					m_halfEdgeIndex = -1;
+	int m_firstIndex = 0;
+	int m_numIndices = 0;
+	int m_halfEdgeIndex = -1;
 };
 
 
@@ -87,29 +89,38 @@ public:
 
 	void					Clear();
 	void					GenerateHalfEdgeStructure();
+	void					SetFromBox(const OBB3& box); // Reuses this polyhedron's storage
 
 	int						AddVertex(const Vector3& vertex);
 	int						AddFace(const std::vector<int>& indices);
+	int						AddFace(const int* indices, int numIndices);
 
 	// Vertices
 	int						GetNumVertices() const { return (int)m_vertices.size(); }
 	const PolyhedronVertex*	GetVertex(int vertexIndex) const;
 	Vector3					GetVertexPosition(int vertexIndex) const;
 	void					GetAllVerticesInFace(int faceIndex, std::vector<Vector3>& out_vertices) const;
+	int						GetAllVerticesInFace(int faceIndex, Vector3* out_vertices, int maxVertices) const;
 	int						GetSupportPoint(const Vector3& direction, Vector3& out_vertex) const;
 
 	// Faces
 	int						GetNumFaces() const { return (int)m_faces.size(); }
 	const PolyhedronFace*	GetFace(int faceIndex) const;
 	void					GetFace(int faceIndex, Polygon3& out_face) const;
+	int						GetFace(int faceIndex, Vector3* out_vertices, int maxVertices) const;
+	int						GetNumVerticesInFace(int faceIndex) const { return m_faces[faceIndex].m_numIndices; }
+	int						GetFaceVertexIndex(int faceIndex, int indexInFace) const { return m_faceIndices[m_faces[faceIndex].m_firstIndex + indexInFace]; }
 	const PolyhedronFace*	GetFaceMostInDirection(const Vector3& direction) const;
 	int						GetIndexOfFaceMostInDirection(const Vector3& direction) const;
 	Vector3					GetFaceNormal(int faceIndex) const;
 	Plane3					GetFaceSupportPlane(int faceIndex) const;
 	void					GetAllFacesAdjacentTo(int faceIndex, std::vector<const PolyhedronFace*>& out_faces) const;
 	void					GetFaceSidePlanes(int faceIndex, std::vector<Plane3>& out_planes) const;
+	int						GetFaceSidePlanes(int faceIndex, Plane3* out_planes, int maxPlanes) const;
 	bool					ClipEdgeToFace(int faceIndex, LineSegment3& inout_edge) const;
 	void					ClipFaceToFace(int faceIndex, Polygon3& inout_faceToClip) const;
+	void					ClipPolygonToFace(int faceIndex, std::vector<Vector3>& inout_vertices, std::vector<Vector3>& scratchVertices) const;
+	int						ClipPolygonToFace(int faceIndex, const Vector3* vertices, int numVertices, Vector3* out_clippedVertices, int maxClippedVertices) const;
 
 	// Edges
 	int						GetNumEdges() const { return (int)m_edges.size(); }
@@ -127,11 +138,26 @@ public:
 	bool					IsConcave() const { return !IsConvex(); }
 
 
+public:
+	//-----Public Data-----
+
+	static constexpr int MAX_CLIP_VERTICES = 64;
+
+
+private:
+	//-----Private Methods-----
+
+	static const Polyhedron&	GetBoxTopology();
+	static Polyhedron			CreateBoxTopology();
+	Plane3						GetEdgeSidePlane(int edgeIndex, const Vector3& faceNormal) const;
+
+
 private:
 	//-----Private Data-----
 
 	std::vector<PolyhedronVertex>	m_vertices;
 	std::vector<PolyhedronFace>		m_faces;
+	std::vector<int>				m_faceIndices;
 
 	// Additional formatting on the "soup" data above for better traversal
 	std::vector<HalfEdge>			m_edges;
@@ -155,7 +181,6 @@ private:
 
 	const Polyhedron&	m_polyhedron;
 	int					m_currIndex = 0;
-	std::vector<int>	m_visitedList;
 
 };
 
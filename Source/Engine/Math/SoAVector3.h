@@ -0,0 +1,45 @@
+///--------------------------------------------------------------------------------------------------------------------------------------------------
+/// Author: Andrew Chase
+/// Date Created: October 18th, 2026
+/// Description: 
+///--------------------------------------------------------------------------------------------------------------------------------------------------
+#pragma once
+
+///--------------------------------------------------------------------------------------------------------------------------------------------------
+/// INCLUDES
+///--------------------------------------------------------------------------------------------------------------------------------------------------
+#include "Engine/Math/Vector3.h"
+#include <vector>
+
+///--------------------------------------------------------------------------------------------------------------------------------------------------
+/// DEFINES
+///--------------------------------------------------------------------------------------------------------------------------------------------------
+
+///--------------------------------------------------------------------------------------------------------------------------------------------------
+/// ENUMS, TYPEDEFS, STRUCTS, FORWARD DECLARATIONS
+///--------------------------------------------------------------------------------------------------------------------------------------------------
+
+// One float array per component
+struct SoAVector3
+{
+	std::vector<float> x;
+	std::vector<float> y;
+	std::vector<float> z;
+
+	Vector3 Get(int index) const { return Vector3(x[index], y[index], z[index]); }
+	void	Set(int index, const Vector3& value) { x[index] = value.x; y[index] = value.y; z[index] = value.z; }
+	void	Add(int index, const Vector3& value) { x[index] += value.x; y[index] += value.y; z[index] += value.z; }
+	void	Resize(int size) { x.resize(size, 0.f); y.resize(size, 0.f); z.resize(size, 0.f); }
+};
+
+///--------------------------------------------------------------------------------------------------------------------------------------------------
+/// GLOBALS AND STATICS
+///--------------------------------------------------------------------------------------------------------------------------------------------------
+
+///--------------------------------------------------------------------------------------------------------------------------------------------------
+/// CLASS DECLARATIONS
+///--------------------------------------------------------------------------------------------------------------------------------------------------
+
+///--------------------------------------------------------------------------------------------------------------------------------------------------
+/// C FUNCTIONS
+///--------------------------------------------------------------------------------------------------------------------------------------------------
@@ -0,0 +1,689 @@
+///--------------------------------------------------------------------------------------------------------------------------------------------------
+/// Author: Andrew Chase
+/// Date Created: October 18th, 2026
+/// Description:
+///--------------------------------------------------------------------------------------------------------------------------------------------------
+
+///--------------------------------------------------------------------------------------------------------------------------------------------------
+/// INCLUDES
+///--------------------------------------------------------------------------------------------------------------------------------------------------
+#include "Engine/Core/DevConsole.h"
+#include "Engine/Core/EngineCommon.h"
+#include "Engine/Job/JobSystem.h"
+#include "Engine/Math/MathUtils.h"
+#include "Engine/Math/ScalarField3.h"
+#include "Engine/Physics/Fluid/FluidSystem.h"
+#include "Engine/Render/Mesh/MarchingCubes.h"
+#include <xmmintrin.h>
+
+///--------------------------------------------------------------------------------------------------------------------------------------------------
+/// DEFINES
+///--------------------------------------------------------------------------------------------------------------------------------------------------
+
+///--------------------------------------------------------------------------------------------------------------------------------------------------
+/// ENUMS, TYPEDEFS, STRUCTS, FORWARD DECLARATIONS
+///--------------------------------------------------------------------------------------------------------------------------------------------------
+
+///--------------------------------------------------------------------------------------------------------------------------------------------------
+/// GLOBALS AND STATICS
+///--------------------------------------------------------------------------------------------------------------------------------------------------
+
+// Surface is where the splatted density is half the rest density
+static constexpr float SURFACE_ISO_LEVEL = 0.5f;
+
+///--------------------------------------------------------------------------------------------------------------------------------------------------
+/// C FUNCTIONS
+///--------------------------------------------------------------------------------------------------------------------------------------------------
+
+//-------------------------------------------------------------------------------------------------
+// Lanes at or past numLanes are masked off, for the last partial group of neighbors
+static __m128 GetLaneMask(int numLanes)
+{
+	return _mm_cmplt_ps(_mm_set_ps(3.f, 2.f, 1.f, 0.f), _mm_set1_ps((float)numLanes));
+}
+
+
+//-------------------------------------------------------------------------------------------------
+// Always added in the same order, so the result doesn't depend on anything but the inputs
+static float SumLanes(const __m128& values)
+{
+	float lanes[4];
+	_mm_storeu_ps(lanes, values);
+
+	return (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+}
+
+
+//-------------------------------------------------------------------------------------------------
+// Loads 4 values from the array by index - padding lanes repeat the last valid index
+static __m128 GatherLanes(const std::vector<float>& values, const int* indices)
+{
+	return _mm_set_ps(values[indices[3]], values[indices[2]], values[indices[1]], values[indices[0]]);
+}
+
+
+//-------------------------------------------------------------------------------------------------
+// Copies up to 4 neighbor indices, padding the rest with the last one so gathers stay in bounds
+static int GetNeighborLanes(const int* neighbors, int numNeighbors, int firstNeighbor, int* out_indices)
+{
+	int numLanes = Min(FluidSystem::SIMD_WIDTH, numNeighbors - firstNeighbor);
+
+	for (int lane = 0; lane < FluidSystem::SIMD_WIDTH; ++lane)
+	{
+		out_indices[lane] = neighbors[firstNeighbor + Min(lane, numLanes - 1)];
+	}
+
+	return numLanes;
+}
+
+///--------------------------------------------------------------------------------------------------------------------------------------------------
+/// CLASS IMPLEMENTATIONS
+///--------------------------------------------------------------------------------------------------------------------------------------------------
+
+//-------------------------------------------------------------------------------------------------
+int FluidSystem::AddParticle(const Vector3& position, const Vector3& velocity /*= Vector3::ZERO*/)
+{
+	int particleIndex = m_numParticles++;
+
+	// Keep the arrays a multiple of SIMD_WIDTH, padding particles never move
+	int paddedSize = ((m_numParticles + SIMD_WIDTH - 1) / SIMD_WIDTH) * SIMD_WIDTH;
+	m_positions.Resize(paddedSize);
+	m_predictedPositions.Resize(paddedSize);
+	m_velocities.Resize(paddedSize);
+	m_scratch.Resize(paddedSize);
+	m_sortedPositions.Resize(paddedSize + SIMD_WIDTH); // Slack for neighbor search reading a full group past the last entry
+	m_densities.resize(paddedSize, 0.f);
+	m_lambdas.resize(paddedSize, 0.f);
+	m_neighborCounts.resize(paddedSize, 0);
+	m_neighbors.resize(paddedSize * m_maxNeighbors, 0);
+	m_gridIndices.push_back(particleIndex);
+
+	m_positions.Set(particleIndex, position);
+	m_predictedPositions.Set(particleIndex, position);
+	m_velocities.Set(particleIndex, velocity);
+
+	return particleIndex;
+}
+
+
+//-------------------------------------------------------------------------------------------------
+int FluidSystem::AddBlock(const Vector3& mins, const IntVector3& numParticles)
+{
+	int firstIndex = m_numParticles;
+	float spacing = 2.f * m_particleRadius;
+
+	for (int zIndex = 0; zIndex < numParticles.z; ++zIndex)
+	{
+		for (int yIndex = 0; yIndex < numParticles.y; ++yIndex)
+		{
+			for (int xIndex = 0; xIndex < numParticles.x; ++xIndex)
+			{
+				AddParticle(mins + spacing * Vector3((float)xIndex, (float)yIndex, (float)zIndex));
+			}
+		}
+	}
+
+	return firstIndex;
+}
+
+
+//-------------------------------------------------------------------------------------------------
+void FluidSystem::Step(float deltaSeconds)
+{
+	if (m_numParticles == 0 || deltaSeconds <= 0.f)
+		return;
+
+	if (m_areKernelConstantsDirty)
+	{
+		UpdateKernelConstants();
+	}
+
+	m_colliders.GatherAroundParticles(m_collisionScene, m_positions, m_velocities, m_numParticles, m_particleRadius, m_gravityAcc, deltaSeconds);
+
+	float substepSeconds = deltaSeconds / (float)m_numSubsteps;
+	for (int substepIndex = 0; substepIndex < m_numSubsteps; ++substepIndex)
+	{
+		DoSubstep(substepSeconds);
+	}
+}
+
+
+//-------------------------------------------------------------------------------------------------
+// Splats every particle's density into a grid around the fluid and polygonizes it
+// Splatting is serial since particles share samples - this is meant for occasional visualization, not every step
+Mesh* FluidSystem::CreateSurfaceMesh(float sampleSpacing, Vector3& out_gridOrigin) const
+{
+	ASSERT_OR_DIE(sampleSpacing > 0.f, "Invalid sample spacing!");
+
+	if (m_numParticles == 0 || m_restDensity <= 0.f)
+		return nullptr;
+
+	Vector3 mins = m_positions.Get(0);
+	Vector3 maxs = mins;
+
+	for (int particleIndex = 1; particleIndex < m_numParticles; ++particleIndex)
+	{
+		Vector3 position = m_positions.Get(particleIndex);
+		mins = Vector3(Min(mins.x, position.x), Min(mins.y, position.y), Min(mins.z, position.z));
+		maxs = Vector3(Max(maxs.x, position.x), Max(maxs.y, position.y), Max(maxs.z, position.z));
+	}
+
+	// Pad by a sample past the kernel so the surface is closed
+	Vector3 padding = Vector3(m_smoothingRadius + sampleSpacing, m_smoothingRadius + sampleSpacing, m_smoothingRadius + sampleSpacing);
+	mins -= padding;
+	maxs += padding;
+
+	IntVector3 dimensions = IntVector3(Ceiling((maxs.x - mins.x) / sampleSpacing) + 1, Ceiling((maxs.y - mins.y) / sampleSpacing) + 1, Ceiling((maxs.z - mins.z) / sampleSpacing) + 1);
+	ScalarField3 field(dimensions, 0.f);
+
+	const float h2 = m_smoothingRadius * m_smoothingRadius;
+	const float densityScale = m_poly6Coefficient / m_restDensity;
+	const int sampleRadius = Ceiling(m_smoothingRadius / sampleSpacing);
+
+	for (int particleIndex = 0; particleIndex < m_numParticles; ++particleIndex)
+	{
+		Vector3 position = m_positions.Get(particleIndex);
+		Vector3 samplePosition = (position - mins) / sampleSpacing;
+		IntVector3 centerSample = IntVector3(Floor(samplePosition.x), Floor(samplePosition.y), Floor(samplePosition.z));
+
+		for (int zSample = Max(centerSample.z - sampleRadius, 0); zSample <= Min(centerSample.z + sampleRadius + 1, dimensions.z - 1); ++zSample)
+		{
+			for (int ySample = Max(centerSample.y - sampleRadius, 0); ySample <= Min(centerSample.y + sampleRadius + 1, dimensions.y - 1); ++ySample)
+			{
+				for (int xSample = Max(centerSample.x - sampleRadius, 0); xSample <= Min(centerSample.x + sampleRadius + 1, dimensions.x - 1); ++xSample)
+				{
+					Vector3 offset = mins + sampleSpacing * Vector3((float)xSample, (float)ySample, (float)zSample) - position;
+					float distanceSquared = offset.GetLengthSquared();
+
+					if (distanceSquared < h2)
+					{
+						float difference = h2 - distanceSquared;
+						field.SetValue(xSample, ySample, zSample, field.GetValue(xSample, ySample, zSample) + densityScale * difference * difference * difference);
+					}
+				}
+			}
+		}
+	}
+
+	out_gridOrigin = mins;
+
+	return MarchingCubes::CreateMesh(field, SURFACE_ISO_LEVEL);
+}
+
+
+//-------------------------------------------------------------------------------------------------
+// Changing the radius changes the rest density, so only do it before particles are added
+void FluidSystem::SetParticleRadius(float radius)
+{
+	ASSERT_OR_DIE(radius > 0.f, "Invalid particle radius!");
+	ASSERT_OR_DIE(m_numParticles == 0, "Can't change the fluid's particle radius after adding particles!");
+
+	m_particleRadius = radius;
+	m_areKernelConstantsDirty = true;
+}
+
+
+//-------------------------------------------------------------------------------------------------
+float FluidSystem::GetAverageDensityError() const
+{
+	if (m_numParticles == 0 || m_restDensity <= 0.f)
+		return 0.f;
+
+	float totalError = 0.f;
+	for (int particleIndex = 0; particleIndex < m_numParticles; ++particleIndex)
+	{
+		totalError += Max(m_densities[particleIndex] / m_restDensity - 1.f, 0.f);
+	}
+
+	return totalError / (float)m_numParticles;
+}
+
+
+//-------------------------------------------------------------------------------------------------
+// Rest density is what a particle in a perfect lattice at the rest spacing sees, so a resting block starts at zero error
+// The relaxation epsilon is scaled off the same lattice's constraint gradient, so it means the same thing at any particle size
+void FluidSystem::UpdateKernelConstants()
+{
+	const float spacing = 2.f * m_particleRadius;
+	const float h = SMOOTHING_RADIUS_SCALE * spacing;
+	const float h2 = h * h;
+	const float h3 = h2 * h;
+	const float h6 = h3 * h3;
+
+	m_smoothingRadius = h;
+	m_poly6Coefficient = 315.f / (64.f * PI * h6 * h3);
+	m_spikyGradientCoefficient = -45.f / (PI * h6);
+
+	float density = 0.f;
+	float gradientLengthSquaredSum = 0.f;
+	const int latticeExtent = Ceiling(SMOOTHING_RADIUS_SCALE);
+
+	for (int zIndex = -latticeExtent; zIndex <= latticeExtent; ++zIndex)
+	{
+		for (int yIndex = -latticeExtent; yIndex <= latticeExtent; ++yIndex)
+		{
+			for (int xIndex = -latticeExtent; xIndex <= latticeExtent; ++xIndex)
+			{
+				float distanceSquared = spacing * spacing * (float)(xIndex * xIndex + yIndex * yIndex + zIndex * zIndex);
+				if (distanceSquared >= h2)
+					continue;
+
+				float difference = h2 - distanceSquared;
+				density += m_poly6Coefficient * difference * difference * difference;
+
+				if (distanceSquared > 0.f)
+				{
+					float gradientLength = m_spikyGradientCoefficient * (h - sqrtf(distanceSquared)) * (h - sqrtf(distanceSquared));
+					gradientLengthSquaredSum += gradientLength * gradientLength;
+				}
+			}
+		}
+	}
+
+	m_restDensity = density;
+	m_relaxationEpsilon = m_relaxation * gradientLengthSquaredSum / (m_restDensity * m_restDensity);
+	m_areKernelConstantsDirty = false;
+}
+
+
+//-------------------------------------------------------------------------------------------------
+void FluidSystem::DoSubstep(float substepSeconds)
+{
+	const int numBlocks = (m_numParticles + SIMD_WIDTH - 1) / SIMD_WIDTH;
+
+	ParallelForIfEnabled(m_useJobSystem, numBlocks, MIN_PARTICLES_PER_JOB / SIMD_WIDTH, [this, substepSeconds](int startBlock, int endBlock)
+	{
+		PredictPositionsInRange(startBlock * SIMD_WIDTH, endBlock * SIMD_WIDTH, substepSeconds);
+	});
+
+	// Neighbors are found once per substep, the iterations don't move particles far enough to change them
+	m_grid.Build(m_predictedPositions, m_gridIndices, m_smoothingRadius, m_useJobSystem);
+	ParallelForIfEnabled(m_useJobSystem, m_numParticles, MIN_PARTICLES_PER_JOB, [this](int startEntry, int endEntry)
+	{
+		for (int entryIndex = startEntry; entryIndex < endEntry; ++entryIndex)
+		{
+			m_sortedPositions.Set(entryIndex, m_predictedPositions.Get(m_grid.GetSortedIndex(entryIndex)));
+		}
+	});
+
+	FindNeighbors();
+
+	for (int iteration = 0; iteration < m_numIterations; ++iteration)
+	{
+		ParallelForIfEnabled(m_useJobSystem, m_numParticles, MIN_PARTICLES_PER_JOB, [this](int startIndex, int endIndex)
+		{
+			ComputeLambdasInRange(startIndex, endIndex);
+		});
+
+		ParallelForIfEnabled(m_useJobSystem, m_numParticles, MIN_PARTICLES_PER_JOB, [this](int startIndex, int endIndex)
+		{
+			ComputeCorrectionsInRange(startIndex, endIndex);
+		});
+
+		// Friction only on the last iteration, otherwise it would compound
+		float frictionScale = (iteration == m_numIterations - 1 ? 1.f : 0.f);
+		ParallelForIfEnabled(m_useJobSystem, m_numParticles, MIN_PARTICLES_PER_JOB, [this, frictionScale](int startIndex, int endIndex)
+		{
+			ApplyCorrectionsInRange(startIndex, endIndex, frictionScale);
+		});
+	}
+
+	ParallelForIfEnabled(m_useJobSystem, numBlocks, MIN_PARTICLES_PER_JOB / SIMD_WIDTH, [this, substepSeconds](int startBlock, int endBlock)
+	{
+		UpdateVelocitiesInRange(startBlock * SIMD_WIDTH, endBlock * SIMD_WIDTH, substepSeconds);
+	});
+
+	if (m_viscosity > 0.f)
+	{
+		ParallelForIfEnabled(m_useJobSystem, m_numParticles, MIN_PARTICLES_PER_JOB, [this](int startIndex, int endIndex)
+		{
+			ApplyViscosityInRange(startIndex, endIndex);
+		});
+
+		m_velocities.x.swap(m_scratch.x);
+		m_velocities.y.swap(m_scratch.y);
+		m_velocities.z.swap(m_scratch.z);
+	}
+
+	// Predicted positions are overwritten at the start of the next substep
+	m_positions.x.swap(m_predictedPositions.x);
+	m_positions.y.swap(m_predictedPositions.y);
+	m_positions.z.swap(m_predictedPositions.z);
+}
+
+
+//-------------------------------------------------------------------------------------------------
+// Range is in whole SIMD blocks, padding lanes past the last particle just carry zeroes along
+void FluidSystem::PredictPositionsInRange(int startIndex, int endIndex, float substepSeconds)
+{
+	const __m128 dt = _mm_set1_ps(substepSeconds);
+	const __m128 gravityX = _mm_set1_ps(m_gravityAcc.x * substepSeconds);
+	const __m128 gravityY = _mm_set1_ps(m_gravityAcc.y * substepSeconds);
+	const __m128 gravityZ = _mm_set1_ps(m_gravityAcc.z * substepSeconds);
+
+	for (int baseIndex = startIndex; baseIndex < endIndex; baseIndex += SIMD_WIDTH)
+	{
+		__m128 velX = _mm_add_ps(_mm_loadu_ps(&m_velocities.x[baseIndex]), gravityX);
+		__m128 velY = _mm_add_ps(_mm_loadu_ps(&m_velocities.y[baseIndex]), gravityY);
+		__m128 velZ = _mm_add_ps(_mm_loadu_ps(&m_velocities.z[baseIndex]), gravityZ);
+
+		_mm_storeu_ps(&m_velocities.x[baseIndex], velX);
+		_mm_storeu_ps(&m_velocities.y[baseIndex], velY);
+		_mm_storeu_ps(&m_velocities.z[baseIndex], velZ);
+
+		_mm_storeu_ps(&m_predictedPositions.x[baseIndex], _mm_add_ps(_mm_loadu_ps(&m_positions.x[baseIndex]), _mm_mul_ps(velX, dt)));
+		_mm_storeu_ps(&m_predictedPositions.y[baseIndex], _mm_add_ps(_mm_loadu_ps(&m_positions.y[baseIndex]), _mm_mul_ps(velY, dt)));
+		_mm_storeu_ps(&m_predictedPositions.z[baseIndex], _mm_add_ps(_mm_loadu_ps(&m_positions.z[baseIndex]), _mm_mul_ps(velZ, dt)));
+	}
+
+	// Start the solve outside of the colliders
+	if (m_colliders.GetNumShapes() == 0)
+		return;
+
+	for (int particleIndex = startIndex; particleIndex < Min(endIndex, m_numParticles); ++particleIndex)
+	{
+		Vector3 position = m_predictedPositions.Get(particleIndex);
+
+		if (m_colliders.CollideParticle(m_particleRadius, m_positions.Get(particleIndex), position, 0.f))
+		{
+			m_predictedPositions.Set(particleIndex, position);
+		}
+	}
+}
+
+
+//-------------------------------------------------------------------------------------------------
+// Particles squeezed past the list size (fast impacts, deep pools) would otherwise under-count their density,
+// so the per-particle lists are grown to fit and the search is run again
+void FluidSystem::FindNeighbors()
+{
+	ParallelForIfEnabled(m_useJobSystem, m_numParticles, MIN_PARTICLES_PER_JOB, [this](int startEntry, int endEntry)
+	{
+		FindNeighborsInRange(startEntry, endEntry);
+	});
+
+	int mostNeighbors = 0;
+	for (int particleIndex = 0; particleIndex < m_numParticles; ++particleIndex)
+	{
+		mostNeighbors = Max(mostNeighbors, m_neighborCounts[particleIndex]);
+	}
+
+	if (mostNeighbors > m_maxNeighbors)
+	{
+		m_maxNeighbors = ((mostNeighbors + 15) / 16) * 16 + 16; // Rounded up with some headroom, so it doesn't regrow every substep while compressing
+		m_neighbors.resize(m_neighborCounts.size() * m_maxNeighbors, 0);
+		ConsoleWarningf("FluidSystem neighbor lists grew to %i per particle", m_maxNeighbors);
+
+		ParallelForIfEnabled(m_useJobSystem, m_numParticles, MIN_PARTICLES_PER_JOB, [this](int startEntry, int endEntry)
+		{
+			FindNeighborsInRange(startEntry, endEntry);
+		});
+	}
+}
+
+
+//-------------------------------------------------------------------------------------------------
+// Range is over grid entries rather than particles, so consecutive queries look at the same cells
+// Candidates are read from the grid-sorted copy of the positions, so a bucket is scanned with contiguous 4-wide loads
+// Neighbors come out in grid order too, which keeps the gathers in the kernels roughly local
+void FluidSystem::FindNeighborsInRange(int startEntry, int endEntry)
+{
+	const __m128 smoothingRadiusSquared = _mm_set1_ps(m_smoothingRadius * m_smoothingRadius);
+	int buckets[ParticleSpatialHash::MAX_NEIGHBOR_BUCKETS];
+
+	for (int queryEntry = startEntry; queryEntry < endEntry; ++queryEntry)
+	{
+		const int particleIndex = m_grid.GetSortedIndex(queryEntry);
+		const Vector3 position = m_sortedPositions.Get(queryEntry);
+		const __m128 posX = _mm_set1_ps(position.x);
+		const __m128 posY = _mm_set1_ps(position.y);
+		const __m128 posZ = _mm_set1_ps(position.z);
+		int* neighbors = &m_neighbors[particleIndex * m_maxNeighbors];
+		int numNeighbors = 0;
+		int numBuckets = m_grid.GetNeighborBuckets(position, buckets);
+
+		for (int bucketIndex = 0; bucketIndex < numBuckets; ++bucketIndex)
+		{
+			const int bucketEnd = m_grid.GetBucketEnd(buckets[bucketIndex]);
+
+			// 4 candidates at a time - the sorted copy is padded, so the last group can read past the bucket and is masked instead
+			for (int firstEntry = m_grid.GetBucketStart(buckets[bucketIndex]); firstEntry < bucketEnd; firstEntry += SIMD_WIDTH)
+			{
+				__m128 offsetX = _mm_sub_ps(_mm_loadu_ps(&m_sortedPositions.x[firstEntry]), posX);
+				__m128 offsetY = _mm_sub_ps(_mm_loadu_ps(&m_sortedPositions.y[firstEntry]), posY);
+				__m128 offsetZ = _mm_sub_ps(_mm_loadu_ps(&m_sortedPositions.z[firstEntry]), posZ);
+				__m128 distanceSquared = _mm_add_ps(_mm_add_ps(_mm_mul_ps(offsetX, offsetX), _mm_mul_ps(offsetY, offsetY)), _mm_mul_ps(offsetZ, offsetZ));
+
+				int inRangeBits = _mm_movemask_ps(_mm_and_ps(GetLaneMask(bucketEnd - firstEntry), _mm_cmplt_ps(distanceSquared, smoothingRadiusSquared)));
+
+				for (int lane = 0; lane < SIMD_WIDTH; ++lane)
+				{
+					if ((inRangeBits & (1 << lane)) != 0 && firstEntry + lane != queryEntry)
+					{
+						// Keep counting past the end of the list, so FindNeighbors() knows how far to grow it
+						if (numNeighbors < m_maxNeighbors)
+						{
+							neighbors[numNeighbors] = m_grid.GetSortedIndex(firstEntry + lane);
+						}
+
+						numNeighbors++;
+					}
+				}
+			}
+		}
+
+		m_neighborCounts[particleIndex] = numNeighbors;
+	}
+}
+
+
+//-------------------------------------------------------------------------------------------------
+// Density constraint C = density / rest density - 1, clamped to only push apart so the free surface doesn't clump
+// lambda = -C / (sum of |grad C|^2 + epsilon), with poly6 for density and spiky for its gradient, 4 neighbors at a time
+void FluidSystem::ComputeLambdasInRange(int startIndex, int endIndex)
+{
+	const float h = m_smoothingRadius;
+	const float h2 = h * h;
+	const __m128 smoothingRadius = _mm_set1_ps(h);
+	const __m128 smoothingRadiusSquared = _mm_set1_ps(h2);
+	const __m128 poly6 = _mm_set1_ps(m_poly6Coefficient);
+	const __m128 spikyGradient = _mm_set1_ps(m_spikyGradientCoefficient);
+	const __m128 minDistanceSquared = _mm_set1_ps(1e-12f);
+	const __m128 zero = _mm_setzero_ps();
+	const float inverseRestDensity = 1.f / m_restDensity;
+
+	for (int particleIndex = startIndex; particleIndex < endIndex; ++particleIndex)
+	{
+		const int* neighbors = &m_neighbors[particleIndex * m_maxNeighbors];
+		const int numNeighbors = m_neighborCounts[particleIndex];
+		const __m128 posX = _mm_set1_ps(m_predictedPositions.x[particleIndex]);
+		const __m128 posY = _mm_set1_ps(m_predictedPositions.y[particleIndex]);
+		const __m128 posZ = _mm_set1_ps(m_predictedPositions.z[particleIndex]);
+
+		__m128 densitySum = zero;
+		__m128 gradientSumX = zero;
+		__m128 gradientSumY = zero;
+		__m128 gradientSumZ = zero;
+		__m128 gradientLengthSquaredSum = zero;
+
+		for (int firstNeighbor = 0; firstNeighbor < numNeighbors; firstNeighbor += SIMD_WIDTH)
+		{
+			int indices[SIMD_WIDTH];
+			int numLanes = GetNeighborLanes(neighbors, numNeighbors, firstNeighbor, indices);
+
+			__m128 offsetX = _mm_sub_ps(posX, GatherLanes(m_predictedPositions.x, indices));
+			__m128 offsetY = _mm_sub_ps(posY, GatherLanes(m_predictedPositions.y, indices));
+			__m128 offsetZ = _mm_sub_ps(posZ, GatherLanes(m_predictedPositions.z, indices));
+			__m128 distanceSquared = _mm_add_ps(_mm_add_ps(_mm_mul_ps(offsetX, offsetX), _mm_mul_ps(offsetY, offsetY)), _mm_mul_ps(offsetZ, offsetZ));
+
+			// Density - poly6 = c * (h^2 - r^2)^3
+			__m128 inRangeMask = _mm_and_ps(GetLaneMask(numLanes), _mm_cmplt_ps(distanceSquared, smoothingRadiusSquared));
+			__m128 difference = _mm_sub_ps(smoothingRadiusSquared, distanceSquared);
+			__m128 weight = _mm_mul_ps(poly6, _mm_mul_ps(difference, _mm_mul_ps(difference, difference)));
+			densitySum = _mm_add_ps(densitySum, _mm_and_ps(inRangeMask, weight));
+
+			// Gradient - spiky = c * (h - r)^2 * offset / r, not defined for coincident particles
+			__m128 gradientMask = _mm_and_ps(inRangeMask, _mm_cmpgt_ps(distanceSquared, minDistanceSquared));
+			__m128 distance = _mm_sqrt_ps(_mm_max_ps(distanceSquared, minDistanceSquared));
+			__m128 falloff = _mm_sub_ps(smoothingRadius, distance);
+			__m128 scale = _mm_and_ps(gradientMask, _mm_div_ps(_mm_mul_ps(spikyGradient, _mm_mul_ps(falloff, falloff)), distance));
+			__m128 gradientX = _mm_mul_ps(scale, offsetX);
+			__m128 gradientY = _mm_mul_ps(scale, offsetY);
+			__m128 gradientZ = _mm_mul_ps(scale, offsetZ);
+
+			gradientSumX = _mm_add_ps(gradientSumX, gradientX);
+			gradientSumY = _mm_add_ps(gradientSumY, gradientY);
+			gradientSumZ = _mm_add_ps(gradientSumZ, gradientZ);
+			gradientLengthSquaredSum = _mm_add_ps(gradientLengthSquaredSum, _mm_add_ps(_mm_add_ps(_mm_mul_ps(gradientX, gradientX), _mm_mul_ps(gradientY, gradientY)), _mm_mul_ps(gradientZ, gradientZ)));
+		}
+
+		// The particle's own contribution to its density
+		float density = SumLanes(densitySum) + m_poly6Coefficient * h2 * h2 * h2;
+		m_densities[particleIndex] = density;
+
+		float constraint = Max(density * inverseRestDensity - 1.f, 0.f);
+		if (constraint == 0.f)
+		{
+			m_lambdas[particleIndex] = 0.f;
+			continue;
+		}
+
+		// grad_j C = -gradient_j / rest density for neighbors, grad_i C = sum of gradients / rest density
+		Vector3 gradientSum = Vector3(SumLanes(gradientSumX), SumLanes(gradientSumY), SumLanes(gradientSumZ));
+		float denominator = (SumLanes(gradientLengthSquaredSum) + gradientSum.GetLengthSquared()) * inverseRestDensity * inverseRestDensity;
+
+		m_lambdas[particleIndex] = -constraint / (denominator + m_relaxationEpsilon);
+	}
+}
+
+
+//-------------------------------------------------------------------------------------------------
+// correction_i = sum of (lambda_i + lambda_j) * spiky gradient / rest density, written to m_scratch
+void FluidSystem::ComputeCorrectionsInRange(int startIndex, int endIndex)
+{
+	const __m128 smoothingRadius = _mm_set1_ps(m_smoothingRadius);
+	const __m128 smoothingRadiusSquared = _mm_set1_ps(m_smoothingRadius * m_smoothingRadius);
+	const __m128 spikyGradient = _mm_set1_ps(m_spikyGradientCoefficient / m_restDensity);
+	const __m128 minDistanceSquared = _mm_set1_ps(1e-12f);
+	const __m128 zero = _mm_setzero_ps();
+
+	for (int particleIndex = startIndex; particleIndex < endIndex; ++particleIndex)
+	{
+		const int* neighbors = &m_neighbors[particleIndex * m_maxNeighbors];
+		const int numNeighbors = m_neighborCounts[particleIndex];
+		const __m128 posX = _mm_set1_ps(m_predictedPositions.x[particleIndex]);
+		const __m128 posY = _mm_set1_ps(m_predictedPositions.y[particleIndex]);
+		const __m128 posZ = _mm_set1_ps(m_predictedPositions.z[particleIndex]);
+		const __m128 lambda = _mm_set1_ps(m_lambdas[particleIndex]);
+
+		__m128 correctionX = zero;
+		__m128 correctionY = zero;
+		__m128 correctionZ = zero;
+
+		for (int firstNeighbor = 0; firstNeighbor < numNeighbors; firstNeighbor += SIMD_WIDTH)
+		{
+			int indices[SIMD_WIDTH];
+			int numLanes = GetNeighborLanes(neighbors, numNeighbors, firstNeighbor, indices);
+
+			__m128 offsetX = _mm_sub_ps(posX, GatherLanes(m_predictedPositions.x, indices));
+			__m128 offsetY = _mm_sub_ps(posY, GatherLanes(m_predictedPositions.y, indices));
+			__m128 offsetZ = _mm_sub_ps(posZ, GatherLanes(m_predictedPositions.z, indices));
+			__m128 distanceSquared = _mm_add_ps(_mm_add_ps(_mm_mul_ps(offsetX, offsetX), _mm_mul_ps(offsetY, offsetY)), _mm_mul_ps(offsetZ, offsetZ));
+
+			__m128 mask = _mm_and_ps(GetLaneMask(numLanes), _mm_and_ps(_mm_cmplt_ps(distanceSquared, smoothingRadiusSquared), _mm_cmpgt_ps(distanceSquared, minDistanceSquared)));
+			__m128 distance = _mm_sqrt_ps(_mm_max_ps(distanceSquared, minDistanceSquared));
+			__m128 falloff = _mm_sub_ps(smoothingRadius, distance);
+			__m128 lambdaSum = _mm_add_ps(lambda, GatherLanes(m_lambdas, indices));
+			__m128 scale = _mm_and_ps(mask, _mm_div_ps(_mm_mul_ps(lambdaSum, _mm_mul_ps(spikyGradient, _mm_mul_ps(falloff, falloff))), distance));
+
+			correctionX = _mm_add_ps(correctionX, _mm_mul_ps(scale, offsetX));
+			correctionY = _mm_add_ps(correctionY, _mm_mul_ps(scale, offsetY));
+			correctionZ = _mm_add_ps(correctionZ, _mm_mul_ps(scale, offsetZ));
+		}
+
+		m_scratch.Set(particleIndex, Vector3(SumLanes(correctionX), SumLanes(correctionY), SumLanes(correctionZ)));
+	}
+}
+
+
+//-------------------------------------------------------------------------------------------------
+void FluidSystem::ApplyCorrectionsInRange(int startIndex, int endIndex, float frictionScale)
+{
+	const bool hasColliders = (m_colliders.GetNumShapes() > 0);
+
+	for (int particleIndex = startIndex; particleIndex < endIndex; ++particleIndex)
+	{
+		Vector3 position = m_predictedPositions.Get(particleIndex) + m_scratch.Get(particleIndex);
+
+		if (hasColliders)
+		{
+			m_colliders.CollideParticle(m_particleRadius, m_positions.Get(particleIndex), position, frictionScale);
+		}
+
+		m_predictedPositions.Set(particleIndex, position);
+	}
+}
+
+
+//-------------------------------------------------------------------------------------------------
+// Range is in whole SIMD blocks, like PredictPositionsInRange()
+void FluidSystem::UpdateVelocitiesInRange(int startIndex, int endIndex, float substepSeconds)
+{
+	const __m128 inverseDt = _mm_set1_ps(1.f / substepSeconds);
+
+	for (int baseIndex = startIndex; baseIndex < endIndex; baseIndex += SIMD_WIDTH)
+	{
+		_mm_storeu_ps(&m_velocities.x[baseIndex], _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(&m_predictedPositions.x[baseIndex]), _mm_loadu_ps(&m_positions.x[baseIndex])), inverseDt));
+		_mm_storeu_ps(&m_velocities.y[baseIndex], _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(&m_predictedPositions.y[baseIndex]), _mm_loadu_ps(&m_positions.y[baseIndex])), inverseDt));
+		_mm_storeu_ps(&m_velocities.z[baseIndex], _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(&m_predictedPositions.z[baseIndex]), _mm_loadu_ps(&m_positions.z[baseIndex])), inverseDt));
+	}
+}
+
+
+//-------------------------------------------------------------------------------------------------
+// XSPH - v_i += c * sum of (v_j - v_i) * poly6 / density_j, into m_scratch so neighbors all read the unblended velocities
+void FluidSystem::ApplyViscosityInRange(int startIndex, int endIndex)
+{
+	const __m128 smoothingRadiusSquared = _mm_set1_ps(m_smoothingRadius * m_smoothingRadius);
+	const __m128 poly6 = _mm_set1_ps(m_poly6Coefficient);
+	const __m128 zero = _mm_setzero_ps();
+
+	for (int particleIndex = startIndex; particleIndex < endIndex; ++particleIndex)
+	{
+		const int* neighbors = &m_neighbors[particleIndex * m_maxNeighbors];
+		const int numNeighbors = m_neighborCounts[particleIndex];
+		const __m128 posX = _mm_set1_ps(m_predictedPositions.x[particleIndex]);
+		const __m128 posY = _mm_set1_ps(m_predictedPositions.y[particleIndex]);
+		const __m128 posZ = _mm_set1_ps(m_predictedPositions.z[particleIndex]);
+		const __m128 velX = _mm_set1_ps(m_velocities.x[particleIndex]);
+		const __m128 velY = _mm_set1_ps(m_velocities.y[particleIndex]);
+		const __m128 velZ = _mm_set1_ps(m_velocities.z[particleIndex]);
+
+		__m128 blendX = zero;
+		__m128 blendY = zero;
+		__m128 blendZ = zero;
+
+		for (int firstNeighbor = 0; firstNeighbor < numNeighbors; firstNeighbor += SIMD_WIDTH)
+		{
+			int indices[SIMD_WIDTH];
+			int numLanes = GetNeighborLanes(neighbors, numNeighbors, firstNeighbor, indices);
+
+			__m128 offsetX = _mm_sub_ps(posX, GatherLanes(m_predictedPositions.x, indices));
+			__m128 offsetY = _mm_sub_ps(posY, GatherLanes(m_predictedPositions.y, indices));
+			__m128 offsetZ = _mm_sub_ps(posZ, GatherLanes(m_predictedPositions.z, indices));
+			__m128 distanceSquared = _mm_add_ps(_mm_add_ps(_mm_mul_ps(offsetX, offsetX), _mm_mul_ps(offsetY, offsetY)), _mm_mul_ps(offsetZ, offsetZ));
+
+			__m128 mask = _mm_and_ps(GetLaneMask(numLanes), _mm_cmplt_ps(distanceSquared, smoothingRadiusSquared));
+			__m128 difference = _mm_sub_ps(smoothingRadiusSquared, distanceSquared);
+			__m128 weight = _mm_div_ps(_mm_mul_ps(poly6, _mm_mul_ps(difference, _mm_mul_ps(difference, difference))), GatherLanes(m_densities, indices));
+			weight = _mm_and_ps(mask, weight);
+
+			blendX = _mm_add_ps(blendX, _mm_mul_ps(weight, _mm_sub_ps(GatherLanes(m_velocities.x, indices), velX)));
+			blendY = _mm_add_ps(blendY, _mm_mul_ps(weight, _mm_sub_ps(GatherLanes(m_velocities.y, indices), velY)));
+			blendZ = _mm_add_ps(blendZ, _mm_mul_ps(weight, _mm_sub_ps(GatherLanes(m_velocities.z, indices), velZ)));
+		}
+
+		Vector3 blend = Vector3(SumLanes(blendX), SumLanes(blendY), SumLanes(blendZ));
+		m_scratch.Set(particleIndex, m_velocities.Get(particleIndex) + m_viscosity * blend);
+	}
+}
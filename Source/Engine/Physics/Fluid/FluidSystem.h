@@ -0,0 +1,138 @@
+///--------------------------------------------------------------------------------------------------------------------------------------------------
+/// Author: Andrew Chase
+/// Date Created: October 18th, 2026
+/// Description: Position based fluids (Macklin and Muller) on SoA particles, with the density and pressure passes run across the JobSystem
+///--------------------------------------------------------------------------------------------------------------------------------------------------
+#pragma once
+
+///--------------------------------------------------------------------------------------------------------------------------------------------------
+/// INCLUDES
+///--------------------------------------------------------------------------------------------------------------------------------------------------
+#include "Engine/Collision/BoundingVolumeHierarchy/BoundingVolume.h"
+#include "Engine/Math/IntVector3.h"
+#include "Engine/Math/SoAVector3.h"
+#include "Engine/Physics/Particle/ParticleSpatialHash.h"
+#include "Engine/Physics/PBD/PBDColliderSet.h"
+#include <vector>
+
+///--------------------------------------------------------------------------------------------------------------------------------------------------
+/// DEFINES
+///--------------------------------------------------------------------------------------------------------------------------------------------------
+
+///--------------------------------------------------------------------------------------------------------------------------------------------------
+/// ENUMS, TYPEDEFS, STRUCTS, FORWARD DECLARATIONS
+///--------------------------------------------------------------------------------------------------------------------------------------------------
+class Mesh;
+
+///--------------------------------------------------------------------------------------------------------------------------------------------------
+/// GLOBALS AND STATICS
+///--------------------------------------------------------------------------------------------------------------------------------------------------
+
+///--------------------------------------------------------------------------------------------------------------------------------------------------
+/// CLASS DECLARATIONS
+///--------------------------------------------------------------------------------------------------------------------------------------------------
+
+//-------------------------------------------------------------------------------------------------
+// Each substep predicts positions, finds neighbors once through a ParticleSpatialHash, then iterates
+// density (lambda) and position correction passes before taking velocities from the motion and applying XSPH viscosity
+// Every pass writes only its own particles' data, so results don't depend on how the work is split across threads
+// Particles are pushed out of the spheres, capsules, boxes, planes and half spaces of an optional CollisionScene
+// All particles have unit mass - the rest density is derived from the particle spacing instead
+// Particles live in the system's own dense arrays rather than ParticleStorage, whose slots belong to individual Particle objects
+// and are shared with every ParticleWorld - the 4-wide kernels need each fluid's particles contiguous. The grid is ParticleSpatialHash
+class FluidSystem
+{
+public:
+	//-----Public Methods-----
+
+	int		AddParticle(const Vector3& position, const Vector3& velocity = Vector3::ZERO);
+	int		AddBlock(const Vector3& mins, const IntVector3& numParticles); // Packed at the rest spacing, returns the first particle's index
+
+	void	Step(float deltaSeconds);
+	Mesh*	CreateSurfaceMesh(float sampleSpacing, Vector3& out_gridOrigin) const; // Vertices are in samples, so scale by sampleSpacing and offset by out_gridOrigin. Caller deletes
+
+	void	SetCollisionScene(const CollisionScene<BoundingVolumeSphere>* scene) { m_collisionScene = scene; }
+	void	SetGravity(const Vector3& gravityAcc) { m_gravityAcc = gravityAcc; }
+	void	SetParticleRadius(float radius);
+	void	SetNumSubsteps(int numSubsteps) { m_numSubsteps = numSubsteps; }
+	void	SetNumIterations(int numIterations) { m_numIterations = numIterations; }
+	void	SetViscosity(float viscosity) { m_viscosity = viscosity; }
+	void	SetRelaxation(float relaxation) { m_relaxation = relaxation; }
+	void	SetUseJobSystem(bool useJobSystem) { m_useJobSystem = useJobSystem; }
+
+	int		GetNumParticles() const { return m_numParticles; }
+	Vector3	GetParticlePosition(int particleIndex) const { return m_positions.Get(particleIndex); }
+	Vector3	GetParticleVelocity(int particleIndex) const { return m_velocities.Get(particleIndex); }
+	float	GetParticleRadius() const { return m_particleRadius; }
+	float	GetSmoothingRadius() const { return m_smoothingRadius; }
+	float	GetRestDensity() const { return m_restDensity; }
+	float	GetAverageDensityError() const; // Mean compression (density / rest density - 1) from the last iteration, ignoring expansion
+
+
+public:
+	//-----Public Data-----
+
+	static constexpr int	SIMD_WIDTH = 4;
+	static constexpr int	INITIAL_MAX_NEIGHBORS = 64; // Grown as needed, see FindNeighbors()
+	static constexpr int	MIN_PARTICLES_PER_JOB = 256;
+	static constexpr float	SMOOTHING_RADIUS_SCALE = 2.2f; // Smoothing radius in rest spacings (particle diameters), ~33 neighbors at rest
+
+
+private:
+	//-----Private Methods-----
+
+	void	UpdateKernelConstants();
+	void	DoSubstep(float substepSeconds);
+	void	PredictPositionsInRange(int startIndex, int endIndex, float substepSeconds);
+	void	FindNeighbors();
+	void	FindNeighborsInRange(int startEntry, int endEntry);
+	void	ComputeLambdasInRange(int startIndex, int endIndex);
+	void	ComputeCorrectionsInRange(int startIndex, int endIndex);
+	void	ApplyCorrectionsInRange(int startIndex, int endIndex, float frictionScale);
+	void	UpdateVelocitiesInRange(int startIndex, int endIndex, float substepSeconds);
+	void	ApplyViscosityInRange(int startIndex, int endIndex);
+
+
+private:
+	//-----Private Data-----
+
+	int											m_numParticles = 0;
+	SoAVector3									m_positions; // Start of the substep
+	SoAVector3									m_predictedPositions;
+	SoAVector3									m_velocities;
+	SoAVector3									m_scratch; // Position corrections, then viscous velocities
+	std::vector<float>							m_densities;
+	std::vector<float>							m_lambdas;
+
+	ParticleSpatialHash							m_grid;
+	std::vector<int>							m_gridIndices; // 0 to N - 1, what the grid is built over
+	SoAVector3									m_sortedPositions; // Predicted positions in grid entry order
+	std::vector<int>							m_neighbors; // m_maxNeighbors per particle
+	int											m_maxNeighbors = INITIAL_MAX_NEIGHBORS;
+	std::vector<int>							m_neighborCounts;
+
+	const CollisionScene<BoundingVolumeSphere>*	m_collisionScene = nullptr;
+	PBDColliderSet								m_colliders;
+
+	Vector3										m_gravityAcc = Vector3(0.f, -9.8f, 0.f);
+	float										m_particleRadius = 0.05f;
+	int											m_numSubsteps = 2;
+	int											m_numIterations = 3;
+	float										m_viscosity = 0.01f; // XSPH blend towards the neighbors' velocity
+	float										m_relaxation = 0.01f; // Softens the constraint, as a fraction of a full particle's gradient
+	bool										m_useJobSystem = true;
+
+	// Derived from the particle radius
+	float										m_smoothingRadius = 0.f;
+	float										m_restDensity = 0.f;
+	float										m_poly6Coefficient = 0.f;
+	float										m_spikyGradientCoefficient = 0.f;
+	float										m_relaxationEpsilon = 0.f;
+	bool										m_areKernelConstantsDirty = true;
+
+};
+
+
+///--------------------------------------------------------------------------------------------------------------------------------------------------
+/// C FUNCTIONS
+///--------------------------------------------------------------------------------------------------------------------------------------------------
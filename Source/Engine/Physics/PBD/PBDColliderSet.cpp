@@ -0,0 +1,236 @@
+///--------------------------------------------------------------------------------------------------------------------------------------------------
+/// Author: Andrew Chase
+/// Date Created: October 18th, 2026
+/// Description:
+///--------------------------------------------------------------------------------------------------------------------------------------------------
+
+///--------------------------------------------------------------------------------------------------------------------------------------------------
+/// INCLUDES
+///--------------------------------------------------------------------------------------------------------------------------------------------------
+#include "Engine/Collision/Collider.h"
+#include "Engine/Collision/CollisionScene.h"
+#include "Engine/Core/EngineCommon.h"
+#include "Engine/Math/MathUtils.h"
+#include "Engine/Physics/PBD/PBDColliderSet.h"
+
+///--------------------------------------------------------------------------------------------------------------------------------------------------
+/// DEFINES
+///--------------------------------------------------------------------------------------------------------------------------------------------------
+
+///--------------------------------------------------------------------------------------------------------------------------------------------------
+/// ENUMS, TYPEDEFS, STRUCTS, FORWARD DECLARATIONS
+///--------------------------------------------------------------------------------------------------------------------------------------------------
+
+///--------------------------------------------------------------------------------------------------------------------------------------------------
+/// GLOBALS AND STATICS
+///--------------------------------------------------------------------------------------------------------------------------------------------------
+
+///--------------------------------------------------------------------------------------------------------------------------------------------------
+/// C FUNCTIONS
+///--------------------------------------------------------------------------------------------------------------------------------------------------
+
+///--------------------------------------------------------------------------------------------------------------------------------------------------
+/// CLASS IMPLEMENTATIONS
+///--------------------------------------------------------------------------------------------------------------------------------------------------
+
+//-------------------------------------------------------------------------------------------------
+// Takes every collider in the scene that overlaps the bounds, up to MAX_SHAPES
+void PBDColliderSet::Gather(const CollisionScene<BoundingVolumeSphere>* scene, const BoundingVolumeSphere& bounds)
+{
+	m_shapes.clear();
+
+	if (scene == nullptr)
+		return;
+
+	const Collider* candidates[MAX_SHAPES];
+	int numCandidates = scene->GetOverlapCandidates(bounds, candidates, MAX_SHAPES);
+
+	for (int candidateIndex = 0; candidateIndex < numCandidates; ++candidateIndex)
+	{
+		const Collider* collider = candidates[candidateIndex];
+		if (collider->m_isTrigger)
+			continue;
+
+		PBDCollisionShape shape;
+		shape.m_typeIndex = collider->GetTypeIndex();
+		shape.m_friction = (collider->m_ignoreFriction ? 0.f : Clamp(collider->m_friction, 0.f, 1.f));
+
+		switch (shape.m_typeIndex)
+		{
+		case HalfSpaceCollider::TYPE_INDEX:
+			shape.m_plane = collider->GetAsType<HalfSpaceCollider>()->GetDataInWorldSpace();
+			break;
+		case PlaneCollider::TYPE_INDEX:
+			shape.m_plane = collider->GetAsType<PlaneCollider>()->GetDataInWorldSpace();
+			break;
+		case SphereCollider::TYPE_INDEX:
+			shape.m_sphere = collider->GetAsType<SphereCollider>()->GetDataInWorldSpace();
+			break;
+		case CapsuleCollider::TYPE_INDEX:
+			shape.m_capsule = collider->GetAsType<CapsuleCollider>()->GetDataInWorldSpace();
+			break;
+		case BoxCollider::TYPE_INDEX:
+		{
+			OBB3 box = collider->GetAsType<BoxCollider>()->GetDataInWorldSpace();
+			shape.m_boxCenter = box.center;
+			shape.m_boxExtents = box.extents;
+			shape.m_boxAxes[0] = box.GetRightVector();
+			shape.m_boxAxes[1] = box.GetUpVector();
+			shape.m_boxAxes[2] = box.GetForwardVector();
+			break;
+		}
+		default:
+			// Hulls, cylinders, meshes etc. aren't supported yet - particles pass through them
+			continue;
+		}
+
+		m_shapes.push_back(shape);
+	}
+}
+
+
+//-------------------------------------------------------------------------------------------------
+// Bounds around all the particles, grown by how far the fastest one can travel - gravity can add to its speed during the step too
+void PBDColliderSet::GatherAroundParticles(const CollisionScene<BoundingVolumeSphere>* scene, const SoAVector3& positions, const SoAVector3& velocities, int numParticles, float particleRadius, const Vector3& gravityAcc, float deltaSeconds)
+{
+	if (scene == nullptr || numParticles == 0)
+	{
+		Clear();
+		return;
+	}
+
+	Vector3 mins = positions.Get(0);
+	Vector3 maxs = mins;
+	float maxSpeedSquared = 0.f;
+
+	for (int particleIndex = 0; particleIndex < numParticles; ++particleIndex)
+	{
+		Vector3 position = positions.Get(particleIndex);
+		mins = Vector3(Min(mins.x, position.x), Min(mins.y, position.y), Min(mins.z, position.z));
+		maxs = Vector3(Max(maxs.x, position.x), Max(maxs.y, position.y), Max(maxs.z, position.z));
+		maxSpeedSquared = Max(maxSpeedSquared, velocities.Get(particleIndex).GetLengthSquared());
+	}
+
+	float maxTravel = (sqrtf(maxSpeedSquared) + gravityAcc.GetLength() * deltaSeconds) * deltaSeconds;
+	Gather(scene, BoundingVolumeSphere(Sphere(0.5f * (mins + maxs), 0.5f * (maxs - mins).GetLength() + maxTravel + particleRadius)));
+}
+
+
+//-------------------------------------------------------------------------------------------------
+// frictionScale lets callers that collide more than once a substep apply friction only once
+bool PBDColliderSet::CollideParticle(float particleRadius, const Vector3& previousPosition, Vector3& inout_position, float frictionScale /*= 1.f*/) const
+{
+	bool collided = false;
+
+	for (const PBDCollisionShape& shape : m_shapes)
+	{
+		collided = CollideWithShape(shape, particleRadius, previousPosition, inout_position, frictionScale) || collided;
+	}
+
+	return collided;
+}
+
+
+//-------------------------------------------------------------------------------------------------
+// Pushes the position out of the shape if it's within the particle radius, and removes part of the
+// motion along the surface for friction. Returns true if the position was moved
+bool PBDColliderSet::CollideWithShape(const PBDCollisionShape& shape, float particleRadius, const Vector3& previousPosition, Vector3& inout_position, float frictionScale) const
+{
+	Vector3 normal;
+	float penetration = 0.f;
+
+	switch (shape.m_typeIndex)
+	{
+	case HalfSpaceCollider::TYPE_INDEX:
+	{
+		normal = shape.m_plane.m_normal;
+		penetration = particleRadius - shape.m_plane.GetDistanceFromPlane(inout_position);
+		break;
+	}
+	case PlaneCollider::TYPE_INDEX:
+	{
+		// Thin, so push back to whichever side the particle started the substep on
+		float side = (shape.m_plane.GetDistanceFromPlane(previousPosition) >= 0.f ? 1.f : -1.f);
+		normal = side * shape.m_plane.m_normal;
+		penetration = particleRadius - side * shape.m_plane.GetDistanceFromPlane(inout_position);
+		break;
+	}
+	case SphereCollider::TYPE_INDEX:
+	case CapsuleCollider::TYPE_INDEX:
+	{
+		Vector3 closestPoint = shape.m_sphere.m_center;
+		float radius = shape.m_sphere.m_radius;
+
+		if (shape.m_typeIndex == CapsuleCollider::TYPE_INDEX)
+		{
+			FindNearestPoint(inout_position, shape.m_capsule.start, shape.m_capsule.end, closestPoint);
+			radius = shape.m_capsule.radius;
+		}
+
+		Vector3 toPosition = inout_position - closestPoint;
+		float distance = toPosition.GetLength();
+		normal = (distance > 0.f ? toPosition / distance : Vector3::Y_AXIS);
+		penetration = radius + particleRadius - distance;
+		break;
+	}
+	case BoxCollider::TYPE_INDEX:
+	{
+		Vector3 toPosition = inout_position - shape.m_boxCenter;
+		float local[3] = { DotProduct(toPosition, shape.m_boxAxes[0]), DotProduct(toPosition, shape.m_boxAxes[1]), DotProduct(toPosition, shape.m_boxAxes[2]) };
+		float extents[3] = { shape.m_boxExtents.x, shape.m_boxExtents.y, shape.m_boxExtents.z };
+
+		bool isInside = true;
+		Vector3 outside = Vector3::ZERO;
+		for (int axisIndex = 0; axisIndex < 3; ++axisIndex)
+		{
+			float excess = Abs(local[axisIndex]) - extents[axisIndex];
+			if (excess > 0.f)
+			{
+				isInside = false;
+				outside += shape.m_boxAxes[axisIndex] * (local[axisIndex] > 0.f ? excess : -excess);
+			}
+		}
+
+		if (isInside)
+		{
+			// Out through the closest face
+			int closestAxis = 0;
+			float closestDistance = FLT_MAX;
+			for (int axisIndex = 0; axisIndex < 3; ++axisIndex)
+			{
+				float distanceToFace = extents[axisIndex] - Abs(local[axisIndex]);
+				if (distanceToFace < closestDistance)
+				{
+					closestDistance = distanceToFace;
+					closestAxis = axisIndex;
+				}
+			}
+
+			normal = shape.m_boxAxes[closestAxis] * (local[closestAxis] >= 0.f ? 1.f : -1.f);
+			penetration = closestDistance + particleRadius;
+		}
+		else
+		{
+			// outside is the offset from the closest point on the box
+			float distance = outside.GetLength();
+			normal = outside / distance;
+			penetration = particleRadius - distance;
+		}
+		break;
+	}
+	default:
+		return false;
+	}
+
+	if (penetration <= 0.f)
+		return false;
+
+	inout_position += normal * penetration;
+
+	// Friction - scale back the motion along the surface this substep
+	Vector3 motion = inout_position - previousPosition;
+	Vector3 tangentialMotion = motion - normal * DotProduct(motion, normal);
+	inout_position -= tangentialMotion * (shape.m_friction * frictionScale);
+
+	return true;
+}
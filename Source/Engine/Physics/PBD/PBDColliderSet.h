@@ -0,0 +1,88 @@
+///--------------------------------------------------------------------------------------------------------------------------------------------------
+/// Author: Andrew Chase
+/// Date Created: October 18th, 2026
+/// Description: World space copies of the colliders near a particle simulation, for projecting particles out of them
+///--------------------------------------------------------------------------------------------------------------------------------------------------
+#pragma once
+
+///--------------------------------------------------------------------------------------------------------------------------------------------------
+/// INCLUDES
+///--------------------------------------------------------------------------------------------------------------------------------------------------
+#include "Engine/Collision/BoundingVolumeHierarchy/BoundingVolume.h"
+#include "Engine/Math/Capsule3.h"
+#include "Engine/Math/OBB3.h"
+#include "Engine/Math/Plane3.h"
+#include "Engine/Math/SoAVector3.h"
+#include "Engine/Math/Sphere.h"
+#include <vector>
+
+///--------------------------------------------------------------------------------------------------------------------------------------------------
+/// DEFINES
+///--------------------------------------------------------------------------------------------------------------------------------------------------
+
+///--------------------------------------------------------------------------------------------------------------------------------------------------
+/// ENUMS, TYPEDEFS, STRUCTS, FORWARD DECLARATIONS
+///--------------------------------------------------------------------------------------------------------------------------------------------------
+template <class BoundingVolumeClass> class CollisionScene;
+
+// World space copy of a collider the particles might touch, taken once per step
+struct PBDCollisionShape
+{
+	int			m_typeIndex = -1; // The collider's TYPE_INDEX
+	Sphere		m_sphere;
+	Capsule3	m_capsule;
+	Plane3		m_plane;
+	Vector3		m_boxCenter = Vector3::ZERO;
+	Vector3		m_boxAxes[3];
+	Vector3		m_boxExtents = Vector3::ZERO;
+	float		m_friction = 0.f;
+};
+
+///--------------------------------------------------------------------------------------------------------------------------------------------------
+/// GLOBALS AND STATICS
+///--------------------------------------------------------------------------------------------------------------------------------------------------
+
+///--------------------------------------------------------------------------------------------------------------------------------------------------
+/// CLASS DECLARATIONS
+///--------------------------------------------------------------------------------------------------------------------------------------------------
+
+//-------------------------------------------------------------------------------------------------
+// Gathered once per step so the substeps/iterations never go back to the colliders, and so particles can be
+// collided from several threads at once
+// Supports spheres, capsules, boxes, planes and half spaces - other collider types are skipped
+class PBDColliderSet
+{
+public:
+	//-----Public Methods-----
+
+	void	Gather(const CollisionScene<BoundingVolumeSphere>* scene, const BoundingVolumeSphere& bounds);
+	void	GatherAroundParticles(const CollisionScene<BoundingVolumeSphere>* scene, const SoAVector3& positions, const SoAVector3& velocities, int numParticles, float particleRadius, const Vector3& gravityAcc, float deltaSeconds); // Everything the particles can reach in deltaSeconds
+	void	Clear() { m_shapes.clear(); }
+	bool	CollideParticle(float particleRadius, const Vector3& previousPosition, Vector3& inout_position, float frictionScale = 1.f) const; // Returns true if the position was moved
+
+	int		GetNumShapes() const { return (int)m_shapes.size(); }
+
+
+public:
+	//-----Public Data-----
+
+	static constexpr int MAX_SHAPES = 64;
+
+
+private:
+	//-----Private Methods-----
+
+	bool	CollideWithShape(const PBDCollisionShape& shape, float particleRadius, const Vector3& previousPosition, Vector3& inout_position, float frictionScale) const;
+
+
+private:
+	//-----Private Data-----
+
+	std::vector<PBDCollisionShape> m_shapes;
+
+};
+
+
+///--------------------------------------------------------------------------------------------------------------------------------------------------
+/// C FUNCTIONS
+///--------------------------------------------------------------------------------------------------------------------------------------------------
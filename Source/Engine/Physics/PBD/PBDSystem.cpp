@@ -0,0 +1,545 @@
+///--------------------------------------------------------------------------------------------------------------------------------------------------
+/// Author: Andrew Chase
+/// Date Created: October 18th, 2026
+/// Description:
+///--------------------------------------------------------------------------------------------------------------------------------------------------
+
+///--------------------------------------------------------------------------------------------------------------------------------------------------
+/// INCLUDES
+///--------------------------------------------------------------------------------------------------------------------------------------------------
+#include "Engine/Core/EngineCommon.h"
+#include "Engine/Job/JobSystem.h"
+#include "Engine/Math/MathUtils.h"
+#include "Engine/Physics/PBD/PBDSystem.h"
+#include <queue>
+
+///--------------------------------------------------------------------------------------------------------------------------------------------------
+/// DEFINES
+///--------------------------------------------------------------------------------------------------------------------------------------------------
+
+///--------------------------------------------------------------------------------------------------------------------------------------------------
+/// ENUMS, TYPEDEFS, STRUCTS, FORWARD DECLARATIONS
+///--------------------------------------------------------------------------------------------------------------------------------------------------
+
+///--------------------------------------------------------------------------------------------------------------------------------------------------
+/// GLOBALS AND STATICS
+///--------------------------------------------------------------------------------------------------------------------------------------------------
+
+///--------------------------------------------------------------------------------------------------------------------------------------------------
+/// C FUNCTIONS
+///--------------------------------------------------------------------------------------------------------------------------------------------------
+
+///--------------------------------------------------------------------------------------------------------------------------------------------------
+/// CLASS IMPLEMENTATIONS
+///--------------------------------------------------------------------------------------------------------------------------------------------------
+
+//-------------------------------------------------------------------------------------------------
+int PBDSystem::AddParticle(const Vector3& position, float inverseMass)
+{
+	int particleIndex = GetNumParticles();
+	int numParticles = particleIndex + 1;
+
+	m_positions.Resize(numParticles);
+	m_previousPositions.Resize(numParticles);
+	m_velocities.Resize(numParticles);
+	m_inverseMass.push_back(inverseMass);
+
+	m_positions.Set(particleIndex, position);
+	m_previousPositions.Set(particleIndex, position);
+	m_areTethersDirty = m_areTethersDirty || (inverseMass == 0.f);
+
+	return particleIndex;
+}
+
+
+//-------------------------------------------------------------------------------------------------
+void PBDSystem::AddDistanceConstraint(int particleA, int particleB, float compliance)
+{
+	AddConstraint(particleA, particleB, compliance, PBD_CONSTRAINT_DISTANCE);
+}
+
+
+//-------------------------------------------------------------------------------------------------
+void PBDSystem::AddBendingConstraint(int particleA, int particleB, float compliance)
+{
+	AddConstraint(particleA, particleB, compliance, PBD_CONSTRAINT_BENDING);
+}
+
+
+//-------------------------------------------------------------------------------------------------
+// Mass is spread evenly over the particles - pin the ends with SetParticleInverseMass()
+int PBDSystem::CreateRope(const Vector3& start, const Vector3& end, int numParticles, float totalMass, float bendingCompliance)
+{
+	ASSERT_OR_DIE(numParticles >= 2, "Rope needs at least two particles!");
+	ASSERT_OR_DIE(totalMass > 0.f, "Invalid rope mass!");
+
+	int firstIndex = GetNumParticles();
+	float inverseMass = (float)numParticles / totalMass;
+
+	for (int ropeIndex = 0; ropeIndex < numParticles; ++ropeIndex)
+	{
+		float t = (float)ropeIndex / (float)(numParticles - 1);
+		AddParticle(Interpolate(start, end, t), inverseMass);
+	}
+
+	for (int ropeIndex = 0; ropeIndex < numParticles - 1; ++ropeIndex)
+	{
+		AddDistanceConstraint(firstIndex + ropeIndex, firstIndex + ropeIndex + 1, 0.f);
+	}
+
+	for (int ropeIndex = 0; ropeIndex < numParticles - 2; ++ropeIndex)
+	{
+		AddBendingConstraint(firstIndex + ropeIndex, firstIndex + ropeIndex + 2, bendingCompliance);
+	}
+
+	return firstIndex;
+}
+
+
+//-------------------------------------------------------------------------------------------------
+// Structural constraints along rows and columns, shear constraints across each quad's diagonals,
+// and bending constraints skipping one particle along rows and columns
+int PBDSystem::CreateCloth(const Vector3& topLeft, const Vector3& right, const Vector3& down, int numWide, int numTall, float totalMass, float bendingCompliance)
+{
+	ASSERT_OR_DIE(numWide >= 2 && numTall >= 2, "Cloth needs at least 2x2 particles!");
+	ASSERT_OR_DIE(totalMass > 0.f, "Invalid cloth mass!");
+
+	int firstIndex = GetNumParticles();
+	float inverseMass = (float)(numWide * numTall) / totalMass;
+
+	for (int yIndex = 0; yIndex < numTall; ++yIndex)
+	{
+		for (int xIndex = 0; xIndex < numWide; ++xIndex)
+		{
+			Vector3 position = topLeft + right * ((float)xIndex / (float)(numWide - 1)) + down * ((float)yIndex / (float)(numTall - 1));
+			AddParticle(position, inverseMass);
+		}
+	}
+
+	auto getIndex = [firstIndex, numWide](int xIndex, int yIndex) { return firstIndex + yIndex * numWide + xIndex; };
+
+	for (int yIndex = 0; yIndex < numTall; ++yIndex)
+	{
+		for (int xIndex = 0; xIndex < numWide; ++xIndex)
+		{
+			if (xIndex + 1 < numWide)
+			{
+				AddDistanceConstraint(getIndex(xIndex, yIndex), getIndex(xIndex + 1, yIndex), 0.f);
+			}
+
+			if (yIndex + 1 < numTall)
+			{
+				AddDistanceConstraint(getIndex(xIndex, yIndex), getIndex(xIndex, yIndex + 1), 0.f);
+			}
+
+			if (xIndex + 1 < numWide && yIndex + 1 < numTall)
+			{
+				AddDistanceConstraint(getIndex(xIndex, yIndex), getIndex(xIndex + 1, yIndex + 1), 0.f);
+				AddDistanceConstraint(getIndex(xIndex + 1, yIndex), getIndex(xIndex, yIndex + 1), 0.f);
+			}
+
+			if (xIndex + 2 < numWide)
+			{
+				AddBendingConstraint(getIndex(xIndex, yIndex), getIndex(xIndex + 2, yIndex), bendingCompliance);
+			}
+
+			if (yIndex + 2 < numTall)
+			{
+				AddBendingConstraint(getIndex(xIndex, yIndex), getIndex(xIndex, yIndex + 2), bendingCompliance);
+			}
+		}
+	}
+
+	return firstIndex;
+}
+
+
+//-------------------------------------------------------------------------------------------------
+void PBDSystem::Step(float deltaSeconds)
+{
+	if (GetNumParticles() == 0 || deltaSeconds <= 0.f)
+		return;
+
+	if (m_isColoringDirty)
+	{
+		ColorConstraints();
+	}
+
+	if (m_areTethersDirty)
+	{
+		BuildTethers();
+	}
+
+	m_colliders.GatherAroundParticles(m_collisionScene, m_positions, m_velocities, GetNumParticles(), m_particleRadius, m_gravityAcc, deltaSeconds);
+
+	float substepSeconds = deltaSeconds / (float)m_numSubsteps;
+	for (int substepIndex = 0; substepIndex < m_numSubsteps; ++substepIndex)
+	{
+		DoSubstep(substepSeconds);
+	}
+}
+
+
+//-------------------------------------------------------------------------------------------------
+// Moves the particle without giving it any velocity
+void PBDSystem::SetParticlePosition(int particleIndex, const Vector3& position)
+{
+	m_positions.Set(particleIndex, position);
+	m_previousPositions.Set(particleIndex, position);
+}
+
+
+//-------------------------------------------------------------------------------------------------
+void PBDSystem::SetParticleInverseMass(int particleIndex, float inverseMass)
+{
+	// Pinning or unpinning changes which particles are anchors
+	if ((m_inverseMass[particleIndex] == 0.f) != (inverseMass == 0.f))
+	{
+		m_areTethersDirty = true;
+	}
+
+	m_inverseMass[particleIndex] = inverseMass;
+}
+
+
+//-------------------------------------------------------------------------------------------------
+float PBDSystem::GetMaxConstraintError(PBDConstraintType type) const
+{
+	float maxError = 0.f;
+
+	for (const PBDConstraint& constraint : m_constraints)
+	{
+		if (constraint.m_type != type || constraint.m_restLength <= 0.f)
+			continue;
+
+		float length = (m_positions.Get(constraint.m_particleA) - m_positions.Get(constraint.m_particleB)).GetLength();
+		maxError = Max(maxError, Abs(length - constraint.m_restLength) / constraint.m_restLength);
+	}
+
+	return maxError;
+}
+
+
+//-------------------------------------------------------------------------------------------------
+void PBDSystem::AddConstraint(int particleA, int particleB, float compliance, PBDConstraintType type)
+{
+	ASSERT_OR_DIE(particleA >= 0 && particleA < GetNumParticles() && particleB >= 0 && particleB < GetNumParticles() && particleA != particleB, "Invalid constraint particles!");
+
+	PBDConstraint constraint;
+	constraint.m_particleA = particleA;
+	constraint.m_particleB = particleB;
+	constraint.m_restLength = (m_positions.Get(particleA) - m_positions.Get(particleB)).GetLength();
+	constraint.m_compliance = compliance;
+	constraint.m_type = type;
+
+	m_constraints.push_back(constraint);
+	m_isColoringDirty = true;
+	m_areTethersDirty = m_areTethersDirty || (type == PBD_CONSTRAINT_DISTANCE);
+}
+
+
+//-------------------------------------------------------------------------------------------------
+// Greedy coloring - each constraint takes the lowest color neither of its particles is already in
+// Constraints are then counting sorted by color, keeping their relative order within a color
+// A hub particle with many constraints can run out of colors, so the last color is an overflow that can share particles
+void PBDSystem::ColorConstraints()
+{
+	const int numConstraints = (int)m_constraints.size();
+	std::vector<uint64> particleColorMasks(GetNumParticles(), 0);
+	std::vector<int> constraintColors(numConstraints);
+	int numColors = 0;
+
+	const int overflowColor = MAX_COLORS - 1;
+
+	for (int constraintIndex = 0; constraintIndex < numConstraints; ++constraintIndex)
+	{
+		const PBDConstraint& constraint = m_constraints[constraintIndex];
+		uint64 usedColors = particleColorMasks[constraint.m_particleA] | particleColorMasks[constraint.m_particleB];
+
+		int color = 0;
+		while (color < overflowColor && (usedColors & ((uint64)1 << color)) != 0)
+		{
+			color++;
+		}
+
+		// The overflow color is solved on one thread, so it doesn't need to be marked as used
+		if (color < overflowColor)
+		{
+			particleColorMasks[constraint.m_particleA] |= ((uint64)1 << color);
+			particleColorMasks[constraint.m_particleB] |= ((uint64)1 << color);
+		}
+
+		constraintColors[constraintIndex] = color;
+		numColors = Max(numColors, color + 1);
+	}
+
+	m_colorStarts.assign(numColors + 1, 0);
+	for (int constraintIndex = 0; constraintIndex < numConstraints; ++constraintIndex)
+	{
+		m_colorStarts[constraintColors[constraintIndex] + 1]++;
+	}
+
+	for (int colorIndex = 0; colorIndex < numColors; ++colorIndex)
+	{
+		m_colorStarts[colorIndex + 1] += m_colorStarts[colorIndex];
+	}
+
+	std::vector<int> cursors(m_colorStarts.begin(), m_colorStarts.end() - 1);
+	std::vector<PBDConstraint> sortedConstraints(numConstraints);
+
+	for (int constraintIndex = 0; constraintIndex < numConstraints; ++constraintIndex)
+	{
+		sortedConstraints[cursors[constraintColors[constraintIndex]]++] = m_constraints[constraintIndex];
+	}
+
+	m_constraints.swap(sortedConstraints);
+	m_isColoringDirty = false;
+}
+
+
+//-------------------------------------------------------------------------------------------------
+// Dijkstra out from every pinned particle at once over the distance constraints' rest lengths,
+// so each particle is tethered to the pinned particle it's closest to along the cloth or rope
+void PBDSystem::BuildTethers()
+{
+	const int numParticles = GetNumParticles();
+
+	// Particle adjacency, counting sorted by particle
+	std::vector<int> edgeStarts(numParticles + 1, 0);
+	for (const PBDConstraint& constraint : m_constraints)
+	{
+		if (constraint.m_type == PBD_CONSTRAINT_DISTANCE)
+		{
+			edgeStarts[constraint.m_particleA + 1]++;
+			edgeStarts[constraint.m_particleB + 1]++;
+		}
+	}
+
+	for (int particleIndex = 0; particleIndex < numParticles; ++particleIndex)
+	{
+		edgeStarts[particleIndex + 1] += edgeStarts[particleIndex];
+	}
+
+	std::vector<int> cursors(edgeStarts.begin(), edgeStarts.end() - 1);
+	std::vector<int> edgeParticles(edgeStarts[numParticles]);
+	std::vector<float> edgeLengths(edgeStarts[numParticles]);
+
+	for (const PBDConstraint& constraint : m_constraints)
+	{
+		if (constraint.m_type == PBD_CONSTRAINT_DISTANCE)
+		{
+			edgeParticles[cursors[constraint.m_particleA]] = constraint.m_particleB;
+			edgeLengths[cursors[constraint.m_particleA]++] = constraint.m_restLength;
+			edgeParticles[cursors[constraint.m_particleB]] = constraint.m_particleA;
+			edgeLengths[cursors[constraint.m_particleB]++] = constraint.m_restLength;
+		}
+	}
+
+	typedef std::pair<float, int> QueueEntry; // Distance, particle
+	std::priority_queue<QueueEntry, std::vector<QueueEntry>, std::greater<QueueEntry>> queue;
+	std::vector<float> distances(numParticles, FLT_MAX);
+	std::vector<int> anchors(numParticles, -1);
+
+	for (int particleIndex = 0; particleIndex < numParticles; ++particleIndex)
+	{
+		if (m_inverseMass[particleIndex] == 0.f)
+		{
+			distances[particleIndex] = 0.f;
+			anchors[particleIndex] = particleIndex;
+			queue.push(QueueEntry(0.f, particleIndex));
+		}
+	}
+
+	while (!queue.empty())
+	{
+		QueueEntry entry = queue.top();
+		queue.pop();
+
+		int particleIndex = entry.second;
+		if (entry.first > distances[particleIndex])
+			continue;
+
+		for (int edgeIndex = edgeStarts[particleIndex]; edgeIndex < edgeStarts[particleIndex + 1]; ++edgeIndex)
+		{
+			int otherIndex = edgeParticles[edgeIndex];
+			float distance = entry.first + edgeLengths[edgeIndex];
+
+			if (distance < distances[otherIndex])
+			{
+				distances[otherIndex] = distance;
+				anchors[otherIndex] = anchors[particleIndex];
+				queue.push(QueueEntry(distance, otherIndex));
+			}
+		}
+	}
+
+	m_tethers.clear();
+	for (int particleIndex = 0; particleIndex < numParticles; ++particleIndex)
+	{
+		if (m_inverseMass[particleIndex] != 0.f && anchors[particleIndex] >= 0)
+		{
+			PBDTether tether;
+			tether.m_particle = particleIndex;
+			tether.m_anchor = anchors[particleIndex];
+			tether.m_maxLength = distances[particleIndex];
+			m_tethers.push_back(tether);
+		}
+	}
+
+	m_areTethersDirty = false;
+}
+
+
+//-------------------------------------------------------------------------------------------------
+void PBDSystem::DoSubstep(float substepSeconds)
+{
+	const int numParticles = GetNumParticles();
+
+	// Predict
+	ParallelForIfEnabled(m_useJobSystem, numParticles, MIN_PARTICLES_PER_JOB, [this, substepSeconds](int startIndex, int endIndex)
+	{
+		for (int particleIndex = startIndex; particleIndex < endIndex; ++particleIndex)
+		{
+			Vector3 position = m_positions.Get(particleIndex);
+			m_previousPositions.Set(particleIndex, position);
+
+			if (m_inverseMass[particleIndex] == 0.f)
+				continue;
+
+			Vector3 velocity = m_velocities.Get(particleIndex) + m_gravityAcc * substepSeconds;
+			m_velocities.Set(particleIndex, velocity);
+			m_positions.Set(particleIndex, position + velocity * substepSeconds);
+		}
+	});
+
+	// Solve, with collisions projected as constraints between the color sweeps so the
+	// distance constraints see (and spread out) the corrections that pushed particles out of colliders
+	for (PBDConstraint& constraint : m_constraints)
+	{
+		constraint.m_lambda = 0.f;
+	}
+
+	const float alphaScale = 1.f / (substepSeconds * substepSeconds);
+	for (int iteration = 0; iteration < m_numIterations; ++iteration)
+	{
+		ParallelForIfEnabled(m_useJobSystem, numParticles, MIN_PARTICLES_PER_JOB, [this](int startIndex, int endIndex)
+		{
+			CollideParticlesInRange(startIndex, endIndex, 0.f);
+		});
+
+		// Each tether only moves its own particle, so they all go at once
+		ParallelForIfEnabled(m_useJobSystem, (int)m_tethers.size(), MIN_PARTICLES_PER_JOB, [this](int startIndex, int endIndex)
+		{
+			SolveTethersInRange(startIndex, endIndex);
+		});
+
+		for (int colorIndex = 0; colorIndex < GetNumColors(); ++colorIndex)
+		{
+			int colorStart = m_colorStarts[colorIndex];
+
+			// Overflow constraints can share particles
+			if (colorIndex == MAX_COLORS - 1)
+			{
+				SolveConstraintsInRange(colorStart, m_colorStarts[colorIndex + 1], alphaScale);
+				continue;
+			}
+
+			ParallelForIfEnabled(m_useJobSystem, m_colorStarts[colorIndex + 1] - colorStart, MIN_CONSTRAINTS_PER_JOB, [this, colorStart, alphaScale](int startIndex, int endIndex)
+			{
+				SolveConstraintsInRange(colorStart + startIndex, colorStart + endIndex, alphaScale);
+			});
+		}
+	}
+
+	// Last collision pass applies friction and leaves nothing inside a collider, then the velocity is taken from how far each particle ended up moving
+	const float damping = Pow(m_damping, substepSeconds);
+	ParallelForIfEnabled(m_useJobSystem, numParticles, MIN_PARTICLES_PER_JOB, [this, substepSeconds, damping](int startIndex, int endIndex)
+	{
+		CollideParticlesInRange(startIndex, endIndex, 1.f);
+
+		for (int particleIndex = startIndex; particleIndex < endIndex; ++particleIndex)
+		{
+			if (m_inverseMass[particleIndex] == 0.f)
+			{
+				m_velocities.Set(particleIndex, Vector3::ZERO);
+				continue;
+			}
+
+			Vector3 velocity = (m_positions.Get(particleIndex) - m_previousPositions.Get(particleIndex)) / substepSeconds;
+			m_velocities.Set(particleIndex, velocity * damping);
+		}
+	});
+}
+
+
+//-------------------------------------------------------------------------------------------------
+// XPBD distance constraint - compliance is scaled by 1 / dt^2 so stiffness doesn't depend on the substep count
+void PBDSystem::SolveConstraintsInRange(int startIndex, int endIndex, float alphaScale)
+{
+	for (int constraintIndex = startIndex; constraintIndex < endIndex; ++constraintIndex)
+	{
+		PBDConstraint& constraint = m_constraints[constraintIndex];
+		const float inverseMassA = m_inverseMass[constraint.m_particleA];
+		const float inverseMassB = m_inverseMass[constraint.m_particleB];
+		const float alpha = constraint.m_compliance * alphaScale;
+		const float denominator = inverseMassA + inverseMassB + alpha;
+
+		if (denominator <= 0.f)
+			continue;
+
+		Vector3 bToA = m_positions.Get(constraint.m_particleA) - m_positions.Get(constraint.m_particleB);
+		float length = bToA.GetLength();
+
+		if (length < 1e-6f)
+			continue;
+
+		float error = length - constraint.m_restLength;
+		float deltaLambda = (-error - alpha * constraint.m_lambda) / denominator;
+		constraint.m_lambda += deltaLambda;
+
+		Vector3 correction = bToA * (deltaLambda / length);
+		m_positions.Add(constraint.m_particleA, correction * inverseMassA);
+		m_positions.Add(constraint.m_particleB, correction * -inverseMassB);
+	}
+}
+
+
+//-------------------------------------------------------------------------------------------------
+// Tethers only pull in, a particle closer to its anchor than its rest distance is left alone
+void PBDSystem::SolveTethersInRange(int startIndex, int endIndex)
+{
+	for (int tetherIndex = startIndex; tetherIndex < endIndex; ++tetherIndex)
+	{
+		const PBDTether& tether = m_tethers[tetherIndex];
+		Vector3 anchorPosition = m_positions.Get(tether.m_anchor);
+		Vector3 anchorToParticle = m_positions.Get(tether.m_particle) - anchorPosition;
+		float length = anchorToParticle.GetLength();
+
+		if (length > tether.m_maxLength)
+		{
+			m_positions.Set(tether.m_particle, anchorPosition + anchorToParticle * (tether.m_maxLength / length));
+		}
+	}
+}
+
+
+//-------------------------------------------------------------------------------------------------
+// frictionScale of 0 only pushes particles out, for the passes inside the solver iterations
+void PBDSystem::CollideParticlesInRange(int startIndex, int endIndex, float frictionScale)
+{
+	if (m_colliders.GetNumShapes() == 0)
+		return;
+
+	for (int particleIndex = startIndex; particleIndex < endIndex; ++particleIndex)
+	{
+		if (m_inverseMass[particleIndex] == 0.f)
+			continue;
+
+		Vector3 position = m_positions.Get(particleIndex);
+
+		if (m_colliders.CollideParticle(m_particleRadius, m_previousPositions.Get(particleIndex), position, frictionScale))
+		{
+			m_positions.Set(particleIndex, position);
+		}
+	}
+}
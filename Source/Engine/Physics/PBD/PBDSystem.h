@@ -0,0 +1,148 @@
+///--------------------------------------------------------------------------------------------------------------------------------------------------
+/// Author: Andrew Chase
+/// Date Created: October 18th, 2026
+/// Description: Position-based (XPBD) simulation of ropes and cloth, with constraints solved in parallel by graph color
+///--------------------------------------------------------------------------------------------------------------------------------------------------
+#pragma once
+
+///--------------------------------------------------------------------------------------------------------------------------------------------------
+/// INCLUDES
+///--------------------------------------------------------------------------------------------------------------------------------------------------
+#include "Engine/Collision/BoundingVolumeHierarchy/BoundingVolume.h"
+#include "Engine/Math/SoAVector3.h"
+#include "Engine/Physics/PBD/PBDColliderSet.h"
+#include <vector>
+
+///--------------------------------------------------------------------------------------------------------------------------------------------------
+/// DEFINES
+///--------------------------------------------------------------------------------------------------------------------------------------------------
+
+///--------------------------------------------------------------------------------------------------------------------------------------------------
+/// ENUMS, TYPEDEFS, STRUCTS, FORWARD DECLARATIONS
+///--------------------------------------------------------------------------------------------------------------------------------------------------
+enum PBDConstraintType
+{
+	PBD_CONSTRAINT_DISTANCE,
+	PBD_CONSTRAINT_BENDING, // Distance between particles two links apart, so it resists folding without a dihedral angle
+	NUM_PBD_CONSTRAINT_TYPES
+};
+
+// Keeps two particles at their rest length - bending constraints are the same math with a softer compliance
+struct PBDConstraint
+{
+	int					m_particleA = -1;
+	int					m_particleB = -1;
+	float				m_restLength = 0.f;
+	float				m_compliance = 0.f; // Inverse stiffness, 0 is rigid
+	float				m_lambda = 0.f; // Accumulated over the iterations of a substep
+	PBDConstraintType	m_type = PBD_CONSTRAINT_DISTANCE;
+};
+
+// Long range attachment - keeps a particle within its rest distance, measured along the distance constraints, of the nearest pinned particle
+// Hanging ropes and cloth otherwise stretch, since each color sweep only carries a correction one link further from the pin
+struct PBDTether
+{
+	int					m_particle = -1;
+	int					m_anchor = -1; // Always pinned, so never moved by the tether
+	float				m_maxLength = 0.f;
+};
+
+///--------------------------------------------------------------------------------------------------------------------------------------------------
+/// GLOBALS AND STATICS
+///--------------------------------------------------------------------------------------------------------------------------------------------------
+
+///--------------------------------------------------------------------------------------------------------------------------------------------------
+/// CLASS DECLARATIONS
+///--------------------------------------------------------------------------------------------------------------------------------------------------
+
+//-------------------------------------------------------------------------------------------------
+// Each step is split into substeps of predict, solve and update velocity
+// Constraints are greedily colored so no two in a color share a particle - each color is then solved in
+// parallel (Gauss-Seidel across colors, since each color sees the previous colors' corrections). Constraints on
+// particles with too many constraints for the colors go in a last overflow color, which is solved serially
+// Particles collide with the spheres, capsules, boxes, planes and half spaces of an optional CollisionScene, one way,
+// as part of each solver iteration so the constraints work against the collision corrections rather than undoing them
+class PBDSystem
+{
+public:
+	//-----Public Methods-----
+
+	int		AddParticle(const Vector3& position, float inverseMass);
+	void	AddDistanceConstraint(int particleA, int particleB, float compliance); // Rest length is the current distance. No index is returned, coloring reorders the constraints
+	void	AddBendingConstraint(int particleA, int particleB, float compliance);
+	int		CreateRope(const Vector3& start, const Vector3& end, int numParticles, float totalMass, float bendingCompliance); // Returns the first particle's index
+	int		CreateCloth(const Vector3& topLeft, const Vector3& right, const Vector3& down, int numWide, int numTall, float totalMass, float bendingCompliance); // Row-major from topLeft
+
+	void	Step(float deltaSeconds);
+
+	void	SetCollisionScene(const CollisionScene<BoundingVolumeSphere>* scene) { m_collisionScene = scene; }
+	void	SetGravity(const Vector3& gravityAcc) { m_gravityAcc = gravityAcc; }
+	void	SetNumSubsteps(int numSubsteps) { m_numSubsteps = numSubsteps; }
+	void	SetNumIterations(int numIterations) { m_numIterations = numIterations; }
+	void	SetParticleRadius(float radius) { m_particleRadius = radius; }
+	void	SetDamping(float damping) { m_damping = damping; }
+	void	SetUseJobSystem(bool useJobSystem) { m_useJobSystem = useJobSystem; }
+	void	SetParticlePosition(int particleIndex, const Vector3& position);
+	void	SetParticleInverseMass(int particleIndex, float inverseMass); // 0 pins it in place
+
+	int		GetNumParticles() const { return (int)m_inverseMass.size(); }
+	int		GetNumConstraints() const { return (int)m_constraints.size(); }
+	int		GetNumColors() const { return (int)m_colorStarts.size() - 1; }
+	int		GetNumTethers() const { return (int)m_tethers.size(); }
+	Vector3	GetParticlePosition(int particleIndex) const { return m_positions.Get(particleIndex); }
+	Vector3	GetParticleVelocity(int particleIndex) const { return m_velocities.Get(particleIndex); }
+	float	GetMaxConstraintError(PBDConstraintType type) const; // Largest |length - rest length| as a fraction of rest length
+
+
+public:
+	//-----Public Data-----
+
+	static constexpr int DEFAULT_NUM_SUBSTEPS = 16;
+	static constexpr int MAX_COLORS = 64; // Last color takes every constraint that didn't fit in the others, and is solved serially
+	static constexpr int MIN_CONSTRAINTS_PER_JOB = 256;
+	static constexpr int MIN_PARTICLES_PER_JOB = 512;
+
+
+private:
+	//-----Private Methods-----
+
+	void	AddConstraint(int particleA, int particleB, float compliance, PBDConstraintType type);
+	void	ColorConstraints();
+	void	BuildTethers();
+	void	DoSubstep(float substepSeconds);
+	void	SolveConstraintsInRange(int startIndex, int endIndex, float alphaScale);
+	void	SolveTethersInRange(int startIndex, int endIndex);
+	void	CollideParticlesInRange(int startIndex, int endIndex, float frictionScale);
+
+
+private:
+	//-----Private Data-----
+
+	SoAVector3									m_positions;
+	SoAVector3									m_previousPositions; // Start of the current substep
+	SoAVector3									m_velocities;
+	std::vector<float>							m_inverseMass;
+
+	std::vector<PBDConstraint>					m_constraints; // Sorted by color once colored
+	std::vector<int>							m_colorStarts; // Color i is [m_colorStarts[i], m_colorStarts[i + 1])
+	bool										m_isColoringDirty = false;
+
+	std::vector<PBDTether>						m_tethers; // One per particle that can reach a pinned particle, rebuilt when constraints or pins change
+	bool										m_areTethersDirty = false;
+
+	const CollisionScene<BoundingVolumeSphere>*	m_collisionScene = nullptr;
+	PBDColliderSet								m_colliders;
+
+	Vector3										m_gravityAcc = Vector3(0.f, -9.8f, 0.f);
+	int											m_numSubsteps = DEFAULT_NUM_SUBSTEPS;
+	int											m_numIterations = 1; // Per substep, more substeps converge better than more iterations
+	float										m_particleRadius = 0.05f;
+	float										m_damping = 0.99f; // Fraction of velocity kept each second
+	bool										m_useJobSystem = true;
+
+};
+
+
+///--------------------------------------------------------------------------------------------------------------------------------------------------
+/// C FUNCTIONS
+///--------------------------------------------------------------------------------------------------------------------------------------------------
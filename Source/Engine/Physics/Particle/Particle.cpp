@@ -31,32 +31,55 @@
 ///--------------------------------------------------------------------------------------------------------------------------------------------------
 
 
+//-------------------------------------------------------------------------------------------------
+Particle::Particle()
+	: m_storage(&ParticleStorage::Get())
+{
+	m_storageIndex = m_storage->AllocateSlot(this);
+}
+
+
 //-------------------------------------------------------------------------------------------------
 Particle::Particle(const Vector3& position, const Vector3& velocity, float inverseMass /*= 1.f*/, float damping /*= 0.999f*/, const Vector3& acceleration /*= Vector3::ZERO*/)
-	: m_position(position)
-	, m_velocity(velocity)
-	, m_damping(damping)
-	, m_acceleration(acceleration)
+	: m_storage(&ParticleStorage::Get())
 {
+	m_storageIndex = m_storage->AllocateSlot(this);
+
+	SetPosition(position);
+	SetVelocity(velocity);
+	SetDamping(damping);
+	SetAcceleration(acceleration);
 	SetInverseMass(inverseMass);
 }
 
 
 //-------------------------------------------------------------------------------------------------
+Particle::~Particle()
+{
+	m_storage->FreeSlot(m_storageIndex);
+}
+
+
+//-------------------------------------------------------------------------------------------------
+// Single particle version, ParticleWorld integrates its particles 4 at a time directly on the storage
+// Any change here needs to be mirrored there (and vice versa)
 void Particle::Integrate(float deltaSeconds)
 {
 	// Don't move static things
-	if (m_iMass == 0.f)
+	if (GetInverseMass() == 0.f)
 		return;
 
+	Vector3 velocity = GetVelocity();
+
 	// Update position
-	m_position += m_velocity * deltaSeconds;
+	m_storage->m_position.Add(m_storageIndex, velocity * deltaSeconds);
 
 	// Update velocity
-	m_velocity += (m_acceleration + m_netForce * m_iMass) * deltaSeconds;
+	velocity += (GetAcceleration() + m_storage->m_netForce.Get(m_storageIndex) * GetInverseMass()) * deltaSeconds;
 
 	// Dampen it
-	m_velocity *= pow(m_damping, deltaSeconds);
+	velocity *= pow(GetDamping(), deltaSeconds);
+	SetVelocity(velocity);
 
 	ClearNetForce();
 }
@@ -66,12 +89,20 @@ void Particle::Integrate(float deltaSeconds)
 void Particle::SetMass(float newMass)
 {
 	ASSERT_RETURN(newMass > 0.f, NO_RETURN_VAL, "Invalid mass!");
-	m_iMass = (1.f / newMass);
+	SetInverseMass(1.f / newMass);
 }
 
 
 //-------------------------------------------------------------------------------------------------
 void Particle::SetInverseMass(float newIMass)
 {
-	m_iMass = newIMass;
+	m_storage->m_inverseMass[m_storageIndex] = newIMass;
+}
+
+
+//-------------------------------------------------------------------------------------------------
+void Particle::SetRadius(float radius)
+{
+	ASSERT_RETURN(radius >= 0.f, NO_RETURN_VAL, "Invalid radius!");
+	m_storage->m_radius[m_storageIndex] = radius;
 }
@@ -9,6 +9,7 @@
 /// INCLUDES
 ///--------------------------------------------------------------------------------------------------------------------------------------------------
 #include "Engine/Math/Vector3.h"
+#include "Engine/Physics/Particle/ParticleStorage.h"
 
 ///--------------------------------------------------------------------------------------------------------------------------------------------------
 /// DEFINES
@@ -27,42 +28,44 @@
 ///--------------------------------------------------------------------------------------------------------------------------------------------------
 
 //-------------------------------------------------------------------------------------------------
+// The state lives in ParticleStorage, this is a view onto the particle's slot
 class Particle
 {
 public:
 	//-----Public Methods-----
 
-	Particle() {}
+	Particle();
 	Particle(const Vector3& position, const Vector3& velocity, float inverseMass = 1.f, float damping = 0.999f, const Vector3& acceleration = Vector3::ZERO);
+	~Particle();
+	Particle(const Particle& copy) = delete;
 
 	void	Integrate(float deltaSeconds);
-	void	ClearNetForce() { m_netForce = Vector3::ZERO; }
+	void	ClearNetForce() { m_storage->m_netForce.Set(m_storageIndex, Vector3::ZERO); }
 
-	void	SetAcceleration(const Vector3& acceleration) { m_acceleration = acceleration; }
-	void	SetPosition(const Vector3& position) { m_position = position; }
-	void	SetVelocity(const Vector3& velocity) { m_velocity = velocity; }
-	void	AddForce(const Vector3& force) { m_netForce += force; }
-	void	SetDamping(float damping) { m_damping = damping; }
+	void	SetAcceleration(const Vector3& acceleration) { m_storage->m_acceleration.Set(m_storageIndex, acceleration); }
+	void	SetPosition(const Vector3& position) { m_storage->m_position.Set(m_storageIndex, position); }
+	void	SetVelocity(const Vector3& velocity) { m_storage->m_velocity.Set(m_storageIndex, velocity); }
+	void	AddForce(const Vector3& force) { m_storage->m_netForce.Add(m_storageIndex, force); }
+	void	SetDamping(float damping) { m_storage->m_damping[m_storageIndex] = damping; }
 	void	SetMass(float mass);
 	void	SetInverseMass(float iMass);
+	void	SetRadius(float radius); // > 0 to collide with the other particles in its world
 
-	Vector3 GetPosition() const { return m_position; }
-	Vector3 GetVelocity() const { return m_velocity; }
-	Vector3 GetAcceleration() const { return m_acceleration; }
-	float	GetDamping() const { return m_damping; }
-	float	GetMass() const { return (m_iMass > 0.f ? (1.f / m_iMass) : FLT_MAX); }
-	float	GetInverseMass() const { return m_iMass; }
+	Vector3 GetPosition() const { return m_storage->m_position.Get(m_storageIndex); }
+	Vector3 GetVelocity() const { return m_storage->m_velocity.Get(m_storageIndex); }
+	Vector3 GetAcceleration() const { return m_storage->m_acceleration.Get(m_storageIndex); }
+	float	GetDamping() const { return m_storage->m_damping[m_storageIndex]; }
+	float	GetMass() const { return (GetInverseMass() > 0.f ? (1.f / GetInverseMass()) : FLT_MAX); }
+	float	GetInverseMass() const { return m_storage->m_inverseMass[m_storageIndex]; }
+	float	GetRadius() const { return m_storage->m_radius[m_storageIndex]; }
+	int		GetStorageIndex() const { return m_storageIndex; }
 
 
 private:
 	//-----Private Data-----
 
-	Vector3 m_position		= Vector3::ZERO;
-	Vector3 m_velocity		= Vector3::ZERO;
-	Vector3 m_acceleration	= Vector3(0.f, -10.f, 0.f); // Default for gravity
-	Vector3 m_netForce		= Vector3::ZERO;
-	float	m_damping		= 0.999f; // Reduce energy in the system
-	float	m_iMass			= 1.f;
+	ParticleStorage*	m_storage = nullptr;
+	int					m_storageIndex = -1;
 
 };
 
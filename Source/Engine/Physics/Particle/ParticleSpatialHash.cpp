@@ -0,0 +1,139 @@
+///--------------------------------------------------------------------------------------------------------------------------------------------------
+/// Author: Andrew Chase
+/// Date Created: October 18th, 2026
+/// Description:
+///--------------------------------------------------------------------------------------------------------------------------------------------------
+
+///--------------------------------------------------------------------------------------------------------------------------------------------------
+/// INCLUDES
+///--------------------------------------------------------------------------------------------------------------------------------------------------
+#include "Engine/Core/EngineCommon.h"
+#include "Engine/Job/JobSystem.h"
+#include "Engine/Math/MathUtils.h"
+#include "Engine/Physics/Particle/ParticleSpatialHash.h"
+
+///--------------------------------------------------------------------------------------------------------------------------------------------------
+/// DEFINES
+///--------------------------------------------------------------------------------------------------------------------------------------------------
+
+///--------------------------------------------------------------------------------------------------------------------------------------------------
+/// ENUMS, TYPEDEFS, STRUCTS, FORWARD DECLARATIONS
+///--------------------------------------------------------------------------------------------------------------------------------------------------
+
+///--------------------------------------------------------------------------------------------------------------------------------------------------
+/// GLOBALS AND STATICS
+///--------------------------------------------------------------------------------------------------------------------------------------------------
+
+///--------------------------------------------------------------------------------------------------------------------------------------------------
+/// C FUNCTIONS
+///--------------------------------------------------------------------------------------------------------------------------------------------------
+
+///--------------------------------------------------------------------------------------------------------------------------------------------------
+/// CLASS IMPLEMENTATIONS
+///--------------------------------------------------------------------------------------------------------------------------------------------------
+
+//-------------------------------------------------------------------------------------------------
+// Rebuilds from scratch - finds every entry's bucket, counts the buckets, then scatters the entries by the counts' prefix sums
+// The sort is stable, so entries within a bucket stay in the order they were given
+void ParticleSpatialHash::Build(const SoAVector3& positions, const std::vector<int>& indices, float cellSize, bool useJobSystem /*= true*/)
+{
+	ASSERT_OR_DIE(cellSize > 0.f, "Invalid cell size!");
+
+	const int numEntries = (int)indices.size();
+	m_cellSize = cellSize;
+	m_inverseCellSize = 1.f / cellSize;
+
+	// Twice as many buckets as entries (rounded up to a power of two) keeps unrelated cells from sharing buckets too often
+	uint32 numBuckets = 64;
+	while (numBuckets < 2 * (uint32)numEntries)
+	{
+		numBuckets *= 2;
+	}
+
+	m_bucketMask = numBuckets - 1;
+	m_entryBuckets.resize(numEntries);
+	m_sortedIndices.resize(numEntries);
+
+	auto findBuckets = [this, &positions, &indices](int startIndex, int endIndex)
+	{
+		for (int entryIndex = startIndex; entryIndex < endIndex; ++entryIndex)
+		{
+			int index = indices[entryIndex];
+			m_entryBuckets[entryIndex] = GetBucket(Floor(positions.x[index] * m_inverseCellSize), Floor(positions.y[index] * m_inverseCellSize), Floor(positions.z[index] * m_inverseCellSize));
+		}
+	};
+
+	ParallelForIfEnabled(useJobSystem, numEntries, MIN_ENTRIES_PER_JOB, findBuckets);
+
+	// Count, offset by one so the prefix sum leaves each bucket's start in its own slot
+	m_bucketStarts.assign(numBuckets + 1, 0);
+	for (int entryIndex = 0; entryIndex < numEntries; ++entryIndex)
+	{
+		m_bucketStarts[m_entryBuckets[entryIndex] + 1]++;
+	}
+
+	for (uint32 bucketIndex = 0; bucketIndex < numBuckets; ++bucketIndex)
+	{
+		m_bucketStarts[bucketIndex + 1] += m_bucketStarts[bucketIndex];
+	}
+
+	// Scatter
+	m_bucketCursors.assign(m_bucketStarts.begin(), m_bucketStarts.end() - 1);
+	for (int entryIndex = 0; entryIndex < numEntries; ++entryIndex)
+	{
+		m_sortedIndices[m_bucketCursors[m_entryBuckets[entryIndex]]++] = indices[entryIndex];
+	}
+}
+
+
+//-------------------------------------------------------------------------------------------------
+// Returns the buckets of the 3x3x3 cells around the position's cell
+// Cells that hash to the same bucket only return it once, so callers don't visit any entry twice
+int ParticleSpatialHash::GetNeighborBuckets(const Vector3& position, int* out_buckets) const
+{
+	const int cellX = Floor(position.x * m_inverseCellSize);
+	const int cellY = Floor(position.y * m_inverseCellSize);
+	const int cellZ = Floor(position.z * m_inverseCellSize);
+	int numBuckets = 0;
+
+	for (int offsetZ = -1; offsetZ <= 1; ++offsetZ)
+	{
+		for (int offsetY = -1; offsetY <= 1; ++offsetY)
+		{
+			for (int offsetX = -1; offsetX <= 1; ++offsetX)
+			{
+				int bucketIndex = GetBucket(cellX + offsetX, cellY + offsetY, cellZ + offsetZ);
+
+				// Empty buckets don't need visiting at all
+				if (m_bucketStarts[bucketIndex] == m_bucketStarts[bucketIndex + 1])
+					continue;
+
+				bool alreadyAdded = false;
+				for (int addedIndex = 0; addedIndex < numBuckets; ++addedIndex)
+				{
+					if (out_buckets[addedIndex] == bucketIndex)
+					{
+						alreadyAdded = true;
+						break;
+					}
+				}
+
+				if (!alreadyAdded)
+				{
+					out_buckets[numBuckets++] = bucketIndex;
+				}
+			}
+		}
+	}
+
+	return numBuckets;
+}
+
+
+//-------------------------------------------------------------------------------------------------
+int ParticleSpatialHash::GetBucket(int cellX, int cellY, int cellZ) const
+{
+	// Large primes, so neighboring cells spread out over the table
+	uint32 hash = ((uint32)cellX * 73856093u) ^ ((uint32)cellY * 19349663u) ^ ((uint32)cellZ * 83492791u);
+	return (int)(hash & m_bucketMask);
+}
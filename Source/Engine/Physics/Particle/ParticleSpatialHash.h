@@ -0,0 +1,74 @@
+///--------------------------------------------------------------------------------------------------------------------------------------------------
+/// Author: Andrew Chase
+/// Date Created: October 18th, 2026
+/// Description: Uniform grid over particle positions, hashed into a fixed table and rebuilt from scratch with a counting sort
+///--------------------------------------------------------------------------------------------------------------------------------------------------
+#pragma once
+
+///--------------------------------------------------------------------------------------------------------------------------------------------------
+/// INCLUDES
+///--------------------------------------------------------------------------------------------------------------------------------------------------
+#include "Engine/Core/EngineCommon.h"
+#include "Engine/Math/SoAVector3.h"
+#include <vector>
+
+///--------------------------------------------------------------------------------------------------------------------------------------------------
+/// DEFINES
+///--------------------------------------------------------------------------------------------------------------------------------------------------
+
+///--------------------------------------------------------------------------------------------------------------------------------------------------
+/// ENUMS, TYPEDEFS, STRUCTS, FORWARD DECLARATIONS
+///--------------------------------------------------------------------------------------------------------------------------------------------------
+
+///--------------------------------------------------------------------------------------------------------------------------------------------------
+/// GLOBALS AND STATICS
+///--------------------------------------------------------------------------------------------------------------------------------------------------
+
+///--------------------------------------------------------------------------------------------------------------------------------------------------
+/// CLASS DECLARATIONS
+///--------------------------------------------------------------------------------------------------------------------------------------------------
+
+//-------------------------------------------------------------------------------------------------
+// Entries are sorted by bucket, so everything in a cell is contiguous - a bucket can also hold entries
+// from other cells that hash to it, so callers still need to check distances
+// With the cell size >= the largest interaction distance, all neighbors of a point are in its 3x3x3 block of cells
+class ParticleSpatialHash
+{
+public:
+	//-----Public Methods-----
+
+	void	Build(const SoAVector3& positions, const std::vector<int>& indices, float cellSize, bool useJobSystem = true);
+
+	int		GetNeighborBuckets(const Vector3& position, int* out_buckets) const; // Up to MAX_NEIGHBOR_BUCKETS, without duplicates
+	int		GetBucket(int cellX, int cellY, int cellZ) const;
+	int		GetBucketStart(int bucketIndex) const { return m_bucketStarts[bucketIndex]; }
+	int		GetBucketEnd(int bucketIndex) const { return m_bucketStarts[bucketIndex + 1]; }
+	int		GetSortedIndex(int entryIndex) const { return m_sortedIndices[entryIndex]; } // One of the indices passed to Build()
+	int		GetNumEntries() const { return (int)m_sortedIndices.size(); }
+	float	GetCellSize() const { return m_cellSize; }
+
+
+public:
+	//-----Public Data-----
+
+	static constexpr int MAX_NEIGHBOR_BUCKETS = 27;
+	static constexpr int MIN_ENTRIES_PER_JOB = 2048;
+
+
+private:
+	//-----Private Data-----
+
+	float				m_cellSize = 1.f;
+	float				m_inverseCellSize = 1.f;
+	uint32				m_bucketMask = 0;
+	std::vector<int>	m_bucketStarts; // Prefix sums, so bucket i is [m_bucketStarts[i], m_bucketStarts[i + 1])
+	std::vector<int>	m_bucketCursors;
+	std::vector<int>	m_entryBuckets;
+	std::vector<int>	m_sortedIndices;
+
+};
+
+
+///--------------------------------------------------------------------------------------------------------------------------------------------------
+/// C FUNCTIONS
+///--------------------------------------------------------------------------------------------------------------------------------------------------
@@ -0,0 +1,104 @@
+///--------------------------------------------------------------------------------------------------------------------------------------------------
+/// Author: Andrew Chase
+/// Date Created: October 18th, 2026
+/// Description:
+///--------------------------------------------------------------------------------------------------------------------------------------------------
+
+///--------------------------------------------------------------------------------------------------------------------------------------------------
+/// INCLUDES
+///--------------------------------------------------------------------------------------------------------------------------------------------------
+#include "Engine/Core/EngineCommon.h"
+#include "Engine/Physics/Particle/ParticleStorage.h"
+
+///--------------------------------------------------------------------------------------------------------------------------------------------------
+/// DEFINES
+///--------------------------------------------------------------------------------------------------------------------------------------------------
+
+///--------------------------------------------------------------------------------------------------------------------------------------------------
+/// ENUMS, TYPEDEFS, STRUCTS, FORWARD DECLARATIONS
+///--------------------------------------------------------------------------------------------------------------------------------------------------
+
+///--------------------------------------------------------------------------------------------------------------------------------------------------
+/// GLOBALS AND STATICS
+///--------------------------------------------------------------------------------------------------------------------------------------------------
+
+///--------------------------------------------------------------------------------------------------------------------------------------------------
+/// C FUNCTIONS
+///--------------------------------------------------------------------------------------------------------------------------------------------------
+
+///--------------------------------------------------------------------------------------------------------------------------------------------------
+/// CLASS IMPLEMENTATIONS
+///--------------------------------------------------------------------------------------------------------------------------------------------------
+
+//-------------------------------------------------------------------------------------------------
+ParticleStorage& ParticleStorage::Get()
+{
+	static ParticleStorage s_storage;
+	return s_storage;
+}
+
+
+//-------------------------------------------------------------------------------------------------
+// Slots are initialized to the same defaults Particle has always had
+int ParticleStorage::AllocateSlot(Particle* particle)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	if (m_freeSlots.size() == 0)
+	{
+		Grow();
+	}
+
+	int slotIndex = m_freeSlots.back();
+	m_freeSlots.pop_back();
+
+	m_position.Set(slotIndex, Vector3::ZERO);
+	m_velocity.Set(slotIndex, Vector3::ZERO);
+	m_acceleration.Set(slotIndex, Vector3(0.f, -10.f, 0.f)); // Default for gravity
+	m_netForce.Set(slotIndex, Vector3::ZERO);
+	m_damping[slotIndex] = 0.999f; // Reduce energy in the system
+	m_inverseMass[slotIndex] = 1.f;
+	m_radius[slotIndex] = 0.f;
+	m_particles[slotIndex] = particle;
+	m_owningWorlds[slotIndex] = nullptr;
+
+	return slotIndex;
+}
+
+
+//-------------------------------------------------------------------------------------------------
+// Leaves the slot's data alone, worlds skip it since it has no particle
+void ParticleStorage::FreeSlot(int slotIndex)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	ASSERT_OR_DIE(slotIndex >= 0 && slotIndex < m_capacity && m_particles[slotIndex] != nullptr, "Freeing an invalid particle slot!");
+
+	m_particles[slotIndex] = nullptr;
+	m_owningWorlds[slotIndex] = nullptr;
+	m_freeSlots.push_back(slotIndex);
+}
+
+
+//-------------------------------------------------------------------------------------------------
+// Doubles the capacity, so Particles must not hold pointers into the arrays across creating another particle
+void ParticleStorage::Grow()
+{
+	int oldCapacity = m_capacity;
+	m_capacity = (m_capacity > 0 ? 2 * m_capacity : 64 * SIMD_WIDTH);
+
+	m_position.Resize(m_capacity);
+	m_velocity.Resize(m_capacity);
+	m_acceleration.Resize(m_capacity);
+	m_netForce.Resize(m_capacity);
+	m_damping.resize(m_capacity, 0.f);
+	m_inverseMass.resize(m_capacity, 0.f);
+	m_radius.resize(m_capacity, 0.f);
+	m_particles.resize(m_capacity, nullptr);
+	m_owningWorlds.resize(m_capacity, nullptr);
+
+	// Pushed backwards so slots are handed out front to back
+	for (int slotIndex = m_capacity - 1; slotIndex >= oldCapacity; --slotIndex)
+	{
+		m_freeSlots.push_back(slotIndex);
+	}
+}
@@ -0,0 +1,87 @@
+///--------------------------------------------------------------------------------------------------------------------------------------------------
+/// Author: Andrew Chase
+/// Date Created: October 18th, 2026
+/// Description: Structure-of-arrays storage for particle state, so a ParticleWorld can integrate and collide its particles in bulk
+///--------------------------------------------------------------------------------------------------------------------------------------------------
+#pragma once
+
+///--------------------------------------------------------------------------------------------------------------------------------------------------
+/// INCLUDES
+///--------------------------------------------------------------------------------------------------------------------------------------------------
+#include "Engine/Core/EngineCommon.h"
+#include "Engine/Math/SoAVector3.h"
+#include <mutex>
+#include <vector>
+
+///--------------------------------------------------------------------------------------------------------------------------------------------------
+/// DEFINES
+///--------------------------------------------------------------------------------------------------------------------------------------------------
+
+///--------------------------------------------------------------------------------------------------------------------------------------------------
+/// ENUMS, TYPEDEFS, STRUCTS, FORWARD DECLARATIONS
+///--------------------------------------------------------------------------------------------------------------------------------------------------
+class Particle;
+class ParticleWorld;
+
+///--------------------------------------------------------------------------------------------------------------------------------------------------
+/// GLOBALS AND STATICS
+///--------------------------------------------------------------------------------------------------------------------------------------------------
+
+///--------------------------------------------------------------------------------------------------------------------------------------------------
+/// CLASS DECLARATIONS
+///--------------------------------------------------------------------------------------------------------------------------------------------------
+
+//-------------------------------------------------------------------------------------------------
+// Every Particle owns one slot here for its whole life, and reads/writes its state through it
+// Capacity is kept a multiple of SIMD_WIDTH so integration never needs a scalar tail
+class ParticleStorage
+{
+public:
+	//-----Public Methods-----
+
+	static ParticleStorage&		Get();
+
+	int							AllocateSlot(Particle* particle);
+	void						FreeSlot(int slotIndex);
+	int							GetCapacity() const { return m_capacity; }
+
+
+public:
+	//-----Public Data-----
+
+	static constexpr int SIMD_WIDTH = 4;
+
+	SoAVector3					m_position;
+	SoAVector3					m_velocity;
+	SoAVector3					m_acceleration;
+	SoAVector3					m_netForce;
+	std::vector<float>			m_damping;
+	std::vector<float>			m_inverseMass;
+	std::vector<float>			m_radius; // 0 for particles that don't collide with each other
+
+	std::vector<Particle*>		m_particles; // nullptr for free slots
+	std::vector<ParticleWorld*>	m_owningWorlds; // World that integrates the particle, if any
+
+
+private:
+	//-----Private Methods-----
+
+	ParticleStorage() {}
+	ParticleStorage(const ParticleStorage& copy) = delete;
+
+	void						Grow();
+
+
+private:
+	//-----Private Data-----
+
+	int							m_capacity = 0;
+	std::vector<int>			m_freeSlots;
+	std::mutex					m_mutex;
+
+};
+
+
+///--------------------------------------------------------------------------------------------------------------------------------------------------
+/// C FUNCTIONS
+///--------------------------------------------------------------------------------------------------------------------------------------------------
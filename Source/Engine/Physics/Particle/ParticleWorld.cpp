@@ -9,12 +9,15 @@
 ///--------------------------------------------------------------------------------------------------------------------------------------------------
 #include "Engine/Core/EngineCommon.h"
 #include "Engine/Core/Rgba.h"
+#include "Engine/Job/JobSystem.h"
 #include "Engine/Math/MathUtils.h"
 #include "Engine/Physics/Particle/Particle.h"
 #include "Engine/Physics/Particle/ParticleContact.h"
 #include "Engine/Physics/Particle/ParticleContactGenerator.h"
 #include "Engine/Physics/Particle/ParticleForceGenerator.h"
+#include "Engine/Physics/Particle/ParticleStorage.h"
 #include "Engine/Physics/Particle/ParticleWorld.h"
+#include <xmmintrin.h>
 
 ///--------------------------------------------------------------------------------------------------------------------------------------------------
 /// DEFINES
@@ -84,13 +87,16 @@ void ParticleWorld::DoPhysicsStep(float deltaSeconds)
 		m_resolver.SetMaxIterations(Max(m_defaultNumIterations, 2 * m_numContactsUsed));
 		m_resolver.ResolveContacts(m_contacts, m_numContactsUsed, deltaSeconds);
 	}
+
+	// Particles bumping into each other
+	CollideParticles();
 }
 
 
 //-------------------------------------------------------------------------------------------------
 void ParticleWorld::AddParticle(Particle* particle)
 {
-	m_particles.push_back(particle);
+	TakeOwnershipOfParticle(particle);
 }
 
 
@@ -112,7 +118,7 @@ void ParticleWorld::AddForceGenerator(ParticleForceGenerator* forceGen, Particle
 
 	if (std::find(m_particles.begin(), m_particles.end(), particleToApplyTo) == m_particles.end())
 	{
-		m_particles.push_back(particleToApplyTo);
+		TakeOwnershipOfParticle(particleToApplyTo);
 	}
 
 	m_forceRegistry.AddRegistration(particleToApplyTo, forceGen);
@@ -120,11 +126,136 @@ void ParticleWorld::AddForceGenerator(ParticleForceGenerator* forceGen, Particle
 
 
 //-------------------------------------------------------------------------------------------------
+void ParticleWorld::TakeOwnershipOfParticle(Particle* particle)
+{
+	ParticleStorage& storage = ParticleStorage::Get();
+	ASSERT_RETURN(storage.m_owningWorlds[particle->GetStorageIndex()] == nullptr, NO_RETURN_VAL, "Particle already belongs to a world!");
+
+	m_particles.push_back(particle);
+	m_particleSlots.push_back(particle->GetStorageIndex());
+	storage.m_owningWorlds[particle->GetStorageIndex()] = this;
+}
+
+
+//-------------------------------------------------------------------------------------------------
+// Integrates this world's slots straight on the storage, split into chunks across the JobSystem
+// Chunks are whole groups of SIMD_WIDTH particles, and every slot belongs to one particle, so no two jobs touch the same slot
 void ParticleWorld::Integrate(float deltaSeconds)
 {
-	for (Particle* particle : m_particles)
+	const int numParticles = (int)m_particleSlots.size();
+	const int numGroups = (numParticles + ParticleStorage::SIMD_WIDTH - 1) / ParticleStorage::SIMD_WIDTH;
+
+	auto integrateGroups = [this, numParticles, deltaSeconds](int startGroup, int endGroup)
+	{
+		IntegrateRange(startGroup * ParticleStorage::SIMD_WIDTH, Min(endGroup * ParticleStorage::SIMD_WIDTH, numParticles), deltaSeconds);
+	};
+
+	if (g_jobSystem != nullptr)
+	{
+		g_jobSystem->ParallelFor(numGroups, MIN_PARTICLES_PER_JOB / ParticleStorage::SIMD_WIDTH, integrateGroups);
+	}
+	else
+	{
+		integrateGroups(0, numGroups);
+	}
+}
+
+
+//-------------------------------------------------------------------------------------------------
+// 4-wide version of Particle::Integrate(), in the same order of operations
+// Any change here needs to be mirrored there (and vice versa)
+// Gathers each group of m_particleSlots into lanes and only writes back the lanes that were integrated
+void ParticleWorld::IntegrateRange(int startIndex, int endIndex, float deltaSeconds)
+{
+	ParticleStorage& storage = ParticleStorage::Get();
+	const __m128 dt = _mm_set1_ps(deltaSeconds);
+
+	for (int firstIndex = startIndex; firstIndex < endIndex; firstIndex += ParticleStorage::SIMD_WIDTH)
 	{
-		particle->Integrate(deltaSeconds);
+		// Skip static particles and the lanes past the end, inactive lanes stay zeroed and are never written back
+		int slotIndices[ParticleStorage::SIMD_WIDTH];
+		float iMassLanes[ParticleStorage::SIMD_WIDTH] = {};
+		float dampingLanes[ParticleStorage::SIMD_WIDTH] = {};
+		float positionLanes[3][ParticleStorage::SIMD_WIDTH] = {};
+		float velocityLanes[3][ParticleStorage::SIMD_WIDTH] = {};
+		float accelerationLanes[3][ParticleStorage::SIMD_WIDTH] = {};
+		float forceLanes[3][ParticleStorage::SIMD_WIDTH] = {};
+		bool anyActive = false;
+
+		for (int lane = 0; lane < ParticleStorage::SIMD_WIDTH; ++lane)
+		{
+			int particleIndex = firstIndex + lane;
+			int slotIndex = (particleIndex < endIndex ? m_particleSlots[particleIndex] : -1);
+
+			if (slotIndex >= 0 && storage.m_inverseMass[slotIndex] == 0.f)
+			{
+				slotIndex = -1;
+			}
+
+			slotIndices[lane] = slotIndex;
+			if (slotIndex < 0)
+				continue;
+
+			anyActive = true;
+			iMassLanes[lane] = storage.m_inverseMass[slotIndex];
+			dampingLanes[lane] = Pow(storage.m_damping[slotIndex], deltaSeconds);
+			positionLanes[0][lane] = storage.m_position.x[slotIndex];
+			positionLanes[1][lane] = storage.m_position.y[slotIndex];
+			positionLanes[2][lane] = storage.m_position.z[slotIndex];
+			velocityLanes[0][lane] = storage.m_velocity.x[slotIndex];
+			velocityLanes[1][lane] = storage.m_velocity.y[slotIndex];
+			velocityLanes[2][lane] = storage.m_velocity.z[slotIndex];
+			accelerationLanes[0][lane] = storage.m_acceleration.x[slotIndex];
+			accelerationLanes[1][lane] = storage.m_acceleration.y[slotIndex];
+			accelerationLanes[2][lane] = storage.m_acceleration.z[slotIndex];
+			forceLanes[0][lane] = storage.m_netForce.x[slotIndex];
+			forceLanes[1][lane] = storage.m_netForce.y[slotIndex];
+			forceLanes[2][lane] = storage.m_netForce.z[slotIndex];
+		}
+
+		if (!anyActive)
+			continue;
+
+		const __m128 iMass = _mm_loadu_ps(iMassLanes);
+		const __m128 damping = _mm_loadu_ps(dampingLanes);
+
+		const __m128 oldVelX = _mm_loadu_ps(velocityLanes[0]);
+		const __m128 oldVelY = _mm_loadu_ps(velocityLanes[1]);
+		const __m128 oldVelZ = _mm_loadu_ps(velocityLanes[2]);
+
+		// Update position
+		__m128 posX = _mm_add_ps(_mm_loadu_ps(positionLanes[0]), _mm_mul_ps(oldVelX, dt));
+		__m128 posY = _mm_add_ps(_mm_loadu_ps(positionLanes[1]), _mm_mul_ps(oldVelY, dt));
+		__m128 posZ = _mm_add_ps(_mm_loadu_ps(positionLanes[2]), _mm_mul_ps(oldVelZ, dt));
+
+		// Update velocity
+		__m128 accX = _mm_add_ps(_mm_loadu_ps(accelerationLanes[0]), _mm_mul_ps(_mm_loadu_ps(forceLanes[0]), iMass));
+		__m128 accY = _mm_add_ps(_mm_loadu_ps(accelerationLanes[1]), _mm_mul_ps(_mm_loadu_ps(forceLanes[1]), iMass));
+		__m128 accZ = _mm_add_ps(_mm_loadu_ps(accelerationLanes[2]), _mm_mul_ps(_mm_loadu_ps(forceLanes[2]), iMass));
+
+		// Dampen it
+		__m128 velX = _mm_mul_ps(_mm_add_ps(oldVelX, _mm_mul_ps(accX, dt)), damping);
+		__m128 velY = _mm_mul_ps(_mm_add_ps(oldVelY, _mm_mul_ps(accY, dt)), damping);
+		__m128 velZ = _mm_mul_ps(_mm_add_ps(oldVelZ, _mm_mul_ps(accZ, dt)), damping);
+
+		_mm_storeu_ps(positionLanes[0], posX);
+		_mm_storeu_ps(positionLanes[1], posY);
+		_mm_storeu_ps(positionLanes[2], posZ);
+		_mm_storeu_ps(velocityLanes[0], velX);
+		_mm_storeu_ps(velocityLanes[1], velY);
+		_mm_storeu_ps(velocityLanes[2], velZ);
+
+		// Write back and clear the net force, active lanes only
+		for (int lane = 0; lane < ParticleStorage::SIMD_WIDTH; ++lane)
+		{
+			int slotIndex = slotIndices[lane];
+			if (slotIndex < 0)
+				continue;
+
+			storage.m_position.Set(slotIndex, Vector3(positionLanes[0][lane], positionLanes[1][lane], positionLanes[2][lane]));
+			storage.m_velocity.Set(slotIndex, Vector3(velocityLanes[0][lane], velocityLanes[1][lane], velocityLanes[2][lane]));
+			storage.m_netForce.Set(slotIndex, Vector3::ZERO);
+		}
 	}
 }
 
@@ -145,3 +276,176 @@ void ParticleWorld::GenerateContacts()
 			break;
 	}
 }
+
+
+//-------------------------------------------------------------------------------------------------
+// Rebuilds the spatial hash over the particles with a radius, then only tests each against the particles in its neighboring cells
+void ParticleWorld::CollideParticles()
+{
+	ParticleStorage& storage = ParticleStorage::Get();
+
+	m_collidingIndices.clear();
+	m_particleContacts.clear();
+	float maxRadius = 0.f;
+
+	for (int slotIndex : m_particleSlots)
+	{
+		if (storage.m_radius[slotIndex] > 0.f)
+		{
+			m_collidingIndices.push_back(slotIndex);
+			maxRadius = Max(maxRadius, storage.m_radius[slotIndex]);
+		}
+	}
+
+	if (m_collidingIndices.size() < 2)
+		return;
+
+	// Cells as wide as the largest possible overlap distance, so a particle's neighbors are all in the 3x3x3 cells around it
+	m_spatialHash.Build(storage.m_position, m_collidingIndices, 2.f * maxRadius);
+
+	// Chunks over the sorted entries, so each chunk works on particles that are close together
+	// Contacts are gathered per chunk and then appended in chunk order, to keep the order the same regardless of threading
+	const int numEntries = m_spatialHash.GetNumEntries();
+	const int numChunks = (numEntries + CONTACT_CHUNK_SIZE - 1) / CONTACT_CHUNK_SIZE;
+
+	if ((int)m_contactsPerChunk.size() < numChunks)
+	{
+		m_contactsPerChunk.resize(numChunks);
+	}
+
+	auto generateChunks = [this](int startChunk, int endChunk)
+	{
+		for (int chunkIndex = startChunk; chunkIndex < endChunk; ++chunkIndex)
+		{
+			GenerateParticleContactsInChunk(chunkIndex);
+		}
+	};
+
+	if (g_jobSystem != nullptr)
+	{
+		g_jobSystem->ParallelFor(numChunks, 1, generateChunks);
+	}
+	else
+	{
+		generateChunks(0, numChunks);
+	}
+
+	for (int chunkIndex = 0; chunkIndex < numChunks; ++chunkIndex)
+	{
+		m_particleContacts.insert(m_particleContacts.end(), m_contactsPerChunk[chunkIndex].begin(), m_contactsPerChunk[chunkIndex].end());
+	}
+
+	ResolveParticleContacts();
+}
+
+
+//-------------------------------------------------------------------------------------------------
+// Each pair is only added by the particle with the lower storage index
+void ParticleWorld::GenerateParticleContactsInChunk(int chunkIndex)
+{
+	ParticleStorage& storage = ParticleStorage::Get();
+	std::vector<ParticlePairContact>& contacts = m_contactsPerChunk[chunkIndex];
+	contacts.clear();
+
+	const int startEntry = chunkIndex * CONTACT_CHUNK_SIZE;
+	const int endEntry = Min(startEntry + CONTACT_CHUNK_SIZE, m_spatialHash.GetNumEntries());
+	int neighborBuckets[ParticleSpatialHash::MAX_NEIGHBOR_BUCKETS];
+
+	for (int entryIndex = startEntry; entryIndex < endEntry; ++entryIndex)
+	{
+		const int indexA = m_spatialHash.GetSortedIndex(entryIndex);
+		const Vector3 positionA = storage.m_position.Get(indexA);
+		const float radiusA = storage.m_radius[indexA];
+		const bool isStaticA = (storage.m_inverseMass[indexA] == 0.f);
+
+		int numBuckets = m_spatialHash.GetNeighborBuckets(positionA, neighborBuckets);
+
+		for (int bucketIndex = 0; bucketIndex < numBuckets; ++bucketIndex)
+		{
+			const int bucketEnd = m_spatialHash.GetBucketEnd(neighborBuckets[bucketIndex]);
+
+			for (int otherEntryIndex = m_spatialHash.GetBucketStart(neighborBuckets[bucketIndex]); otherEntryIndex < bucketEnd; ++otherEntryIndex)
+			{
+				const int indexB = m_spatialHash.GetSortedIndex(otherEntryIndex);
+				if (indexB <= indexA)
+					continue;
+
+				if (isStaticA && storage.m_inverseMass[indexB] == 0.f)
+					continue;
+
+				Vector3 bToA = positionA - storage.m_position.Get(indexB);
+				float distanceSquared = bToA.GetLengthSquared();
+				float radiusSum = radiusA + storage.m_radius[indexB];
+
+				if (distanceSquared >= radiusSum * radiusSum)
+					continue;
+
+				ParticlePairContact contact;
+				contact.m_indexA = indexA;
+				contact.m_indexB = indexB;
+				contact.m_normal = (distanceSquared > 0.f ? bToA / sqrtf(distanceSquared) : Vector3::Y_AXIS); // Exactly on top of each other, just pick a direction
+				contacts.push_back(contact);
+			}
+		}
+	}
+}
+
+
+//-------------------------------------------------------------------------------------------------
+// Sequential passes over the contacts - all velocities, then all positions, same as the ParticleContactResolver
+// Doesn't search for the worst contact each iteration, which is what keeps this linear in the number of contacts
+void ParticleWorld::ResolveParticleContacts()
+{
+	ParticleStorage& storage = ParticleStorage::Get();
+	const int numContacts = (int)m_particleContacts.size();
+
+	// Velocities!
+	for (int iteration = 0; iteration < m_numCollisionIterations; ++iteration)
+	{
+		for (int contactIndex = 0; contactIndex < numContacts; ++contactIndex)
+		{
+			const ParticlePairContact& contact = m_particleContacts[contactIndex];
+			const float iMassA = storage.m_inverseMass[contact.m_indexA];
+			const float iMassB = storage.m_inverseMass[contact.m_indexB];
+			const float totalIMass = iMassA + iMassB;
+
+			// If > 0.f, then they're already moving apart, so no impulse needed
+			float separatingVelocity = DotProduct(storage.m_velocity.Get(contact.m_indexA) - storage.m_velocity.Get(contact.m_indexB), contact.m_normal);
+			if (separatingVelocity >= 0.f || totalIMass <= 0.f)
+				continue;
+
+			// Flip the separating velocity, scaled by restitution
+			float deltaVelocity = -separatingVelocity * (1.f + m_particleRestitution);
+			Vector3 impulsePerIMass = contact.m_normal * (deltaVelocity / totalIMass);
+
+			storage.m_velocity.Add(contact.m_indexA, impulsePerIMass * iMassA);
+			storage.m_velocity.Add(contact.m_indexB, impulsePerIMass * -iMassB);
+		}
+	}
+
+	// Positions! Penetrations are recalculated from the current positions, so earlier corrections are accounted for
+	for (int iteration = 0; iteration < m_numCollisionIterations; ++iteration)
+	{
+		for (int contactIndex = 0; contactIndex < numContacts; ++contactIndex)
+		{
+			const ParticlePairContact& contact = m_particleContacts[contactIndex];
+			const float iMassA = storage.m_inverseMass[contact.m_indexA];
+			const float iMassB = storage.m_inverseMass[contact.m_indexB];
+			const float totalIMass = iMassA + iMassB;
+
+			Vector3 bToA = storage.m_position.Get(contact.m_indexA) - storage.m_position.Get(contact.m_indexB);
+			float distanceSquared = bToA.GetLengthSquared();
+			float radiusSum = storage.m_radius[contact.m_indexA] + storage.m_radius[contact.m_indexB];
+
+			if (distanceSquared >= radiusSum * radiusSum || totalIMass <= 0.f)
+				continue;
+
+			float distance = sqrtf(distanceSquared);
+			Vector3 normal = (distance > 0.f ? bToA / distance : contact.m_normal);
+			Vector3 movePerIMass = normal * ((radiusSum - distance) / totalIMass);
+
+			storage.m_position.Add(contact.m_indexA, movePerIMass * iMassA);
+			storage.m_position.Add(contact.m_indexB, movePerIMass * -iMassB);
+		}
+	}
+}
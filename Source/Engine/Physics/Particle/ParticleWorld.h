@@ -9,8 +9,10 @@
 /// INCLUDES
 ///--------------------------------------------------------------------------------------------------------------------------------------------------
 #include <vector>
+#include "Engine/Math/Vector3.h"
 #include "Engine/Physics/Particle/ParticleContactResolver.h"
 #include "Engine/Physics/Particle/ParticleForceRegistry.h"
+#include "Engine/Physics/Particle/ParticleSpatialHash.h"
 
 ///--------------------------------------------------------------------------------------------------------------------------------------------------
 /// DEFINES
@@ -24,6 +26,14 @@ class ParticleContact;
 class ParticleContactGenerator;
 class ParticleForceGenerator;
 
+// Two overlapping particles found through the spatial hash, by storage index
+struct ParticlePairContact
+{
+	int		m_indexA = -1;
+	int		m_indexB = -1;
+	Vector3	m_normal = Vector3::ZERO; // From B to A
+};
+
 ///--------------------------------------------------------------------------------------------------------------------------------------------------
 /// GLOBALS AND STATICS
 ///--------------------------------------------------------------------------------------------------------------------------------------------------
@@ -33,6 +43,8 @@ class ParticleForceGenerator;
 ///--------------------------------------------------------------------------------------------------------------------------------------------------
 
 //-------------------------------------------------------------------------------------------------
+// Particles with a radius collide with each other through a spatial hash rebuilt every step, so only
+// particles in neighboring cells are ever tested against each other
 class ParticleWorld
 {
 public:
@@ -48,19 +60,36 @@ public:
 	void AddContactGenerator(ParticleContactGenerator* contactGen);
 	void AddForceGenerator(ParticleForceGenerator* forceGen, Particle* particleToApplyTo);
 
+	void SetParticleRestitution(float restitution) { m_particleRestitution = restitution; }
+	void SetNumCollisionIterations(int numIterations) { m_numCollisionIterations = numIterations; }
+	int	 GetNumParticles() const { return (int)m_particles.size(); }
+	int	 GetNumParticleContacts() const { return (int)m_particleContacts.size(); }
+
+
+public:
+	//-----Public Data-----
+
+	static constexpr int MIN_PARTICLES_PER_JOB = 1024;
+	static constexpr int CONTACT_CHUNK_SIZE = 512;
 
 
 private:
 	//-----Private Methods-----
 
+	void TakeOwnershipOfParticle(Particle* particle);
 	void Integrate(float deltaSeconds);
+	void IntegrateRange(int startIndex, int endIndex, float deltaSeconds); // Indices into m_particleSlots
 	void GenerateContacts();
+	void CollideParticles();
+	void GenerateParticleContactsInChunk(int chunkIndex);
+	void ResolveParticleContacts();
 
 
 private:
 	//-----Private Data-----
 
 	std::vector<Particle*> m_particles;
+	std::vector<int> m_particleSlots; // Storage slot of each particle in m_particles, what integration and collision walk
 	std::vector<ParticleForceGenerator*> m_forceGens;
 	ParticleForceRegistry m_forceRegistry;
 	std::vector<ParticleContactGenerator*> m_contactGens;
@@ -70,6 +99,14 @@ private:
 	ParticleContact* m_contacts = nullptr;
 	ParticleContactResolver m_resolver;
 
+	// Particle vs. particle collisions
+	ParticleSpatialHash m_spatialHash;
+	std::vector<int> m_collidingIndices;
+	std::vector<std::vector<ParticlePairContact>> m_contactsPerChunk;
+	std::vector<ParticlePairContact> m_particleContacts;
+	float m_particleRestitution = 0.5f;
+	int m_numCollisionIterations = 2;
+
 };
 
 ///--------------------------------------------------------------------------------------------------------------------------------------------------
@@ -8,9 +8,13 @@
 /// INCLUDES
 ///--------------------------------------------------------------------------------------------------------------------------------------------------
 #include "Engine/Core/EngineCommon.h"
+#include "Engine/Math/MathUtils.h"
 #include "Engine/Physics/RigidBody/RigidBody.h"
 #include "Engine/Physics/RigidBody/RigidBodyForceGenerator.h"
 #include "Engine/Physics/RigidBody/PhysicsScene.h"
+#include "Engine/Physics/RigidBody/RigidBodyStorage.h"
+#include "Engine/Time/Time.h"
+#include <xmmintrin.h>
 
 ///--------------------------------------------------------------------------------------------------------------------------------------------------
 /// DEFINES
@@ -30,10 +34,79 @@ const Vector3 PhysicsScene::DEFAULT_GRAVITY = Vector3(0.f, -10.f, 0.f);
 /// C FUNCTIONS
 ///--------------------------------------------------------------------------------------------------------------------------------------------------
 
+//-------------------------------------------------------------------------------------------------
+static RigidBodyPose GetBodyPose(const RigidBody* body)
+{
+	RigidBodyPose pose;
+	pose.m_position = body->transform->position;
+	pose.m_rotation = body->transform->rotation;
+
+	return pose;
+}
+
+
+//-------------------------------------------------------------------------------------------------
+static void SetBodyPose(RigidBody* body, const RigidBodyPose& pose)
+{
+	body->transform->position = pose.m_position;
+	body->transform->rotation = pose.m_rotation;
+}
+
+
+//-------------------------------------------------------------------------------------------------
+// Bitwise, since it's checking whether anything wrote to the transform at all
+static bool ArePosesIdentical(const RigidBodyPose& a, const RigidBodyPose& b)
+{
+	return memcmp(&a.m_position, &b.m_position, sizeof(Vector3)) == 0
+		&& memcmp(&a.m_rotation, &b.m_rotation, sizeof(Quaternion)) == 0;
+}
+
+
 ///--------------------------------------------------------------------------------------------------------------------------------------------------
 /// CLASS IMPLEMENTATIONS
 ///--------------------------------------------------------------------------------------------------------------------------------------------------
 
+//-------------------------------------------------------------------------------------------------
+// The state size goes in first, to catch bytes saved by a build where the structs differ
+void PhysicsSnapshot::WriteToBytes(std::vector<uint8>& out_bytes) const
+{
+	out_bytes.clear();
+	AppendBytes(out_bytes, (int)sizeof(RigidBodyState));
+	AppendBytes(out_bytes, m_numBodies);
+	AppendVectorBytes(out_bytes, m_bodyStates);
+	AppendVectorBytes(out_bytes, m_previousPoses);
+	AppendBytes(out_bytes, m_timeAccumulator);
+	AppendBytes(out_bytes, m_hasCollisionState);
+
+	if (m_hasCollisionState)
+	{
+		m_collisionState.WriteToBytes(out_bytes);
+	}
+}
+
+
+//-------------------------------------------------------------------------------------------------
+bool PhysicsSnapshot::ReadFromBytes(const uint8* bytes, size_t numBytes)
+{
+	size_t offset = 0;
+	int stateSize = 0;
+
+	bool success = ReadBytes(bytes, numBytes, offset, stateSize) && (stateSize == (int)sizeof(RigidBodyState));
+	success = success && ReadBytes(bytes, numBytes, offset, m_numBodies);
+	success = success && ReadVectorBytes(bytes, numBytes, offset, m_bodyStates);
+	success = success && ReadVectorBytes(bytes, numBytes, offset, m_previousPoses);
+	success = success && ReadBytes(bytes, numBytes, offset, m_timeAccumulator);
+	success = success && ReadBytes(bytes, numBytes, offset, m_hasCollisionState);
+
+	if (success && m_hasCollisionState)
+	{
+		success = m_collisionState.ReadFromBytes(bytes, numBytes, offset);
+	}
+
+	return success && (offset == numBytes) && ((int)m_bodyStates.size() == m_numBodies) && ((int)m_previousPoses.size() == m_numBodies);
+}
+
+
 //-------------------------------------------------------------------------------------------------
 PhysicsScene::PhysicsScene(CollisionScene<BoundingVolumeSphere>* collisionScene)
 	: m_collisionScene(collisionScene)
@@ -55,14 +128,69 @@ void PhysicsScene::BeginFrame()
 }
 
 
+//-------------------------------------------------------------------------------------------------
+// Steps at the fixed rate however long the frame was, so a hitch can't turn into one huge unstable step
+// Between frames the transforms hold a pose interpolated between the last two steps, so bodies move smoothly when
+// rendering faster than physics steps; the simulated pose is put back before stepping again
+void PhysicsScene::FrameStep(float frameSeconds)
+{
+	RestoreSimulatedPoses();
+
+	m_timeAccumulator += frameSeconds;
+	m_numStepsLastFrame = 0;
+	m_droppedSecondsLastFrame = 0.f;
+
+	int numBodies = (int)m_bodies.size();
+
+	while (m_timeAccumulator >= m_fixedStepSeconds && m_numStepsLastFrame < m_maxStepsPerFrame)
+	{
+		for (int bodyIndex = 0; bodyIndex < numBodies; ++bodyIndex)
+		{
+			m_previousPoses[bodyIndex] = GetBodyPose(m_bodies[bodyIndex]);
+		}
+
+		DoPhysicsStep(m_fixedStepSeconds);
+
+		m_timeAccumulator -= m_fixedStepSeconds;
+		m_numStepsLastFrame++;
+	}
+
+	for (int bodyIndex = 0; bodyIndex < numBodies; ++bodyIndex)
+	{
+		m_simulatedPoses[bodyIndex] = GetBodyPose(m_bodies[bodyIndex]);
+	}
+
+	// Drop whatever didn't fit under the cap instead of carrying it over, otherwise a slow frame makes the next one
+	// step more, which makes it slower still
+	if (m_timeAccumulator >= m_fixedStepSeconds)
+	{
+		float keptSeconds = fmodf(m_timeAccumulator, m_fixedStepSeconds);
+		m_droppedSecondsLastFrame = m_timeAccumulator - keptSeconds;
+		m_timeAccumulator = keptSeconds;
+	}
+
+	m_interpolationAlpha = Clamp(m_timeAccumulator / m_fixedStepSeconds, 0.f, 1.f);
+	WriteInterpolatedPoses();
+}
+
+
 //-------------------------------------------------------------------------------------------------
 void PhysicsScene::DoPhysicsStep(float deltaSeconds)
 {
+	if (m_collisionScene != nullptr && m_collisionScene->GetContactSolverMode() == CONTACT_SOLVER_SUBSTEPPED)
+	{
+		DoSubsteppedPhysicsStep(deltaSeconds);
+		return;
+	}
+
+	uint64 startHPC = GetPerformanceCounter();
+
 	// Apply all forces
 	m_forceRegistry.GenerateAndAddForces(deltaSeconds);
 
 	// Update positions and velocities
 	Integrate(deltaSeconds);
+	m_integrateSeconds += TimeSystem::PerformanceCountToSeconds(GetPerformanceCounter() - startHPC);
 
 	// Check for collisions, then correct
 	if (m_collisionScene != nullptr)
@@ -72,18 +200,56 @@ void PhysicsScene::DoPhysicsStep(float deltaSeconds)
 }
 
 
+//-------------------------------------------------------------------------------------------------
+// Several small integrate-then-resolve substeps with one solver pass each, rather than one big step and many passes
+// Contacts are only generated once, after the first substep's integration, and re-evaluated by the resolver after that
+void PhysicsScene::DoSubsteppedPhysicsStep(float deltaSeconds)
+{
+	float substepSeconds = deltaSeconds / (float)m_numSubsteps;
+
+	for (int substepIndex = 0; substepIndex < m_numSubsteps; ++substepIndex)
+	{
+		uint64 startHPC = GetPerformanceCounter();
+		m_forceRegistry.GenerateAndAddForces(substepSeconds);
+		Integrate(substepSeconds);
+		m_integrateSeconds += TimeSystem::PerformanceCountToSeconds(GetPerformanceCounter() - startHPC);
+
+		if (substepIndex == 0)
+		{
+			m_collisionScene->DetectContacts();
+		}
+
+		m_collisionScene->ResolveContactsSubstep(substepSeconds, substepIndex == 0);
+	}
+
+	m_collisionScene->FinishCollisionStep();
+}
+
+
+//-------------------------------------------------------------------------------------------------
+void PhysicsScene::ResetStepTimings()
+{
+	m_integrateSeconds = 0.0;
+
+	if (m_collisionScene != nullptr)
+	{
+		m_collisionScene->ResetStepTimings();
+	}
+}
+
+
 //-------------------------------------------------------------------------------------------------
 void PhysicsScene::AddRigidbody(RigidBody* body)
 {
 	if (std::find(m_bodies.begin(), m_bodies.end(), body) == m_bodies.end())
 	{
-		m_bodies.push_back(body);
+		TakeOwnershipOfBody(body);
 	}
 }
 
 
 //-------------------------------------------------------------------------------------------------
-void PhysicsScene::AddForceGenerator(RigidBodyForceGenerator* forceGen, RigidBody* body)
+RigidBodyForceHandle PhysicsScene::AddForceGenerator(RigidBodyForceGenerator* forceGen, RigidBody* body)
 {
 	// Add the generator and body of not already added
 	if (std::find(m_forceGens.begin(), m_forceGens.end(), forceGen) == m_forceGens.end())
@@ -93,15 +259,124 @@ void PhysicsScene::AddForceGenerator(RigidBodyForceGenerator* forceGen, RigidBod
 
 	if (std::find(m_bodies.begin(), m_bodies.end(), body) == m_bodies.end())
 	{
-		m_bodies.push_back(body);
+		TakeOwnershipOfBody(body);
+	}
+
+	return m_forceRegistry.AddRegistration(body, forceGen);
+}
+
+
+//-------------------------------------------------------------------------------------------------
+void PhysicsScene::SetFixedStepSeconds(float fixedStepSeconds)
+{
+	ASSERT_RETURN(fixedStepSeconds > 0.f, NO_RETURN_VAL, "Fixed step must be positive!");
+	m_fixedStepSeconds = fixedStepSeconds;
+}
+
+
+//-------------------------------------------------------------------------------------------------
+void PhysicsScene::SetNumSubsteps(int numSubsteps)
+{
+	ASSERT_RETURN(numSubsteps > 0, NO_RETURN_VAL, "Need at least one substep!");
+	m_numSubsteps = numSubsteps;
+}
+
+
+//-------------------------------------------------------------------------------------------------
+void PhysicsScene::SetMaxStepsPerFrame(int maxSteps)
+{
+	ASSERT_RETURN(maxSteps > 0, NO_RETURN_VAL, "Need at least one step per frame!");
+	m_maxStepsPerFrame = maxSteps;
+}
+
+
+//-------------------------------------------------------------------------------------------------
+// Reuses the snapshot's memory, so saving into the same snapshot every step doesn't allocate once warmed up
+// Between FrameStep() calls the transforms hold interpolated poses, so the simulated ones are saved instead
+void PhysicsScene::SaveSnapshot(PhysicsSnapshot& out_snapshot) const
+{
+	int numBodies = (int)m_bodies.size();
+	out_snapshot.m_numBodies = numBodies;
+	out_snapshot.m_bodyStates.resize(numBodies);
+	out_snapshot.m_previousPoses.resize(numBodies);
+	out_snapshot.m_timeAccumulator = m_timeAccumulator;
+
+	for (int bodyIndex = 0; bodyIndex < numBodies; ++bodyIndex)
+	{
+		RigidBody* body = m_bodies[bodyIndex];
+		RigidBodyState& state = out_snapshot.m_bodyStates[bodyIndex];
+		body->SaveState(state);
+
+		RigidBodyPose currentPose = GetBodyPose(body);
+
+		if (ArePosesIdentical(currentPose, m_renderedPoses[bodyIndex]))
+		{
+			state.m_position = m_simulatedPoses[bodyIndex].m_position;
+			state.m_rotation = m_simulatedPoses[bodyIndex].m_rotation;
+			out_snapshot.m_previousPoses[bodyIndex] = m_previousPoses[bodyIndex];
+		}
+		else
+		{
+			// Moved by game code (or stepped with DoPhysicsStep()), same as the teleport case in RestoreSimulatedPoses()
+			out_snapshot.m_previousPoses[bodyIndex] = currentPose;
+		}
+	}
+
+	out_snapshot.m_hasCollisionState = (m_collisionScene != nullptr);
+
+	if (m_collisionScene != nullptr)
+	{
+		m_collisionScene->SaveSnapshot(out_snapshot.m_collisionState);
 	}
+}
+
+
+//-------------------------------------------------------------------------------------------------
+// Leaves the simulated poses in the transforms, the next FrameStep() interpolates again
+bool PhysicsScene::RestoreSnapshot(const PhysicsSnapshot& snapshot)
+{
+	ASSERT_RETURN(snapshot.m_numBodies == (int)m_bodies.size(), false, "Snapshot has %i bodies but the scene has %i!", snapshot.m_numBodies, (int)m_bodies.size());
+	ASSERT_RETURN(snapshot.m_hasCollisionState == (m_collisionScene != nullptr), false, "Snapshot collision state doesn't match the scene!");
 
-	m_forceRegistry.AddRegistration(body, forceGen);
+	// Restore the collision scene first, it's the only part that can fail partway
+	if (m_collisionScene != nullptr && !m_collisionScene->RestoreSnapshot(snapshot.m_collisionState))
+		return false;
+
+	for (int bodyIndex = 0; bodyIndex < (int)m_bodies.size(); ++bodyIndex)
+	{
+		RigidBody* body = m_bodies[bodyIndex];
+		body->RestoreState(snapshot.m_bodyStates[bodyIndex]);
+
+		// The transform now holds the simulated pose, and counts as rendered so the next FrameStep() doesn't take it as a teleport
+		RigidBodyPose simulatedPose = GetBodyPose(body);
+		m_simulatedPoses[bodyIndex] = simulatedPose;
+		m_renderedPoses[bodyIndex] = simulatedPose;
+		m_previousPoses[bodyIndex] = snapshot.m_previousPoses[bodyIndex];
+	}
+
+	m_timeAccumulator = snapshot.m_timeAccumulator;
+	m_interpolationAlpha = Clamp(m_timeAccumulator / m_fixedStepSeconds, 0.f, 1.f);
+
+	return true;
 }
 
 
 //-------------------------------------------------------------------------------------------------
 void PhysicsScene::Integrate(float deltaSeconds)
+{
+	if (m_useBatchedIntegration)
+	{
+		IntegrateStorageBatched(deltaSeconds);
+	}
+	else
+	{
+		IntegrateBodiesIndividually(deltaSeconds);
+	}
+}
+
+
+//-------------------------------------------------------------------------------------------------
+void PhysicsScene::IntegrateBodiesIndividually(float deltaSeconds)
 {
 	for (RigidBody* body : m_bodies)
 	{
@@ -116,3 +391,255 @@ void PhysicsScene::Integrate(float deltaSeconds)
 		body->Integrate(deltaSeconds, gravityAcc);
 	}
 }
+
+
+//-------------------------------------------------------------------------------------------------
+// Same math as RigidBody::Integrate in the same order, so the results are bit-identical
+// Walks this scene's slots 4 at a time, gathering each group's state out of the storage and writing back only the
+// lanes that were integrated, so other scenes' bodies are never read or written
+// Linear velocity, damping, clamping and the sleep check run 4 wide; the rotation and anything reading the transform stays per body
+void PhysicsScene::IntegrateStorageBatched(float deltaSeconds)
+{
+	RigidBodyStorage& storage = RigidBodyStorage::Get();
+	const int numBodies = (int)m_bodySlots.size();
+	const __m128 zero = _mm_setzero_ps();
+	const __m128 dt = _mm_set1_ps(deltaSeconds);
+	const float bias = Pow(0.1f, deltaSeconds);
+
+	for (int firstIndex = 0; firstIndex < numBodies; firstIndex += RigidBodyStorage::SIMD_WIDTH)
+	{
+		// Figure out which lanes to integrate - skips sleeping/static bodies and the lanes past the last body
+		// Inactive lanes are left zeroed; whatever they compute is never written back
+		int slotIndices[RigidBodyStorage::SIMD_WIDTH];
+		RigidBody* bodies[RigidBodyStorage::SIMD_WIDTH];
+		float iMassLanes[RigidBodyStorage::SIMD_WIDTH] = {};
+		float accelerationLanes[3][RigidBodyStorage::SIMD_WIDTH] = {};
+		float forceLanes[3][RigidBodyStorage::SIMD_WIDTH] = {};
+		float velocityLanes[3][RigidBodyStorage::SIMD_WIDTH] = {};
+		float linearDampingLanes[RigidBodyStorage::SIMD_WIDTH] = {};
+		float maxVerticalSpeedLanes[RigidBodyStorage::SIMD_WIDTH] = {};
+		float sleepLanes[RigidBodyStorage::SIMD_WIDTH] = {};
+		bool anyActive = false;
+
+		for (int lane = 0; lane < RigidBodyStorage::SIMD_WIDTH; ++lane)
+		{
+			int bodyIndex = firstIndex + lane;
+			int slotIndex = (bodyIndex < numBodies ? m_bodySlots[bodyIndex] : -1);
+			bool isActive = (slotIndex >= 0 && storage.m_isAwake[slotIndex] != 0 && storage.m_inverseMass[slotIndex] > 0.f);
+
+			slotIndices[lane] = slotIndex;
+			bodies[lane] = (isActive ? m_bodies[bodyIndex] : nullptr);
+
+			if (!isActive)
+				continue;
+
+			anyActive = true;
+
+			// Calculate gravity acceleration
+			Vector3 gravityAcc = Vector3::ZERO;
+
+			if (storage.m_affectedByGravity[slotIndex] != 0 && m_gravityEnabled)
+			{
+				gravityAcc = m_gravityAcc * storage.m_gravityScale[slotIndex];
+			}
+
+			iMassLanes[lane] = storage.m_inverseMass[slotIndex];
+			accelerationLanes[0][lane] = storage.m_accelerationWs.x[slotIndex] + gravityAcc.x;
+			accelerationLanes[1][lane] = storage.m_accelerationWs.y[slotIndex] + gravityAcc.y;
+			accelerationLanes[2][lane] = storage.m_accelerationWs.z[slotIndex] + gravityAcc.z;
+			forceLanes[0][lane] = storage.m_forceAccumWs.x[slotIndex];
+			forceLanes[1][lane] = storage.m_forceAccumWs.y[slotIndex];
+			forceLanes[2][lane] = storage.m_forceAccumWs.z[slotIndex];
+			velocityLanes[0][lane] = storage.m_velocityWs.x[slotIndex];
+			velocityLanes[1][lane] = storage.m_velocityWs.y[slotIndex];
+			velocityLanes[2][lane] = storage.m_velocityWs.z[slotIndex];
+			linearDampingLanes[lane] = Pow(storage.m_linearDamping[slotIndex], deltaSeconds);
+			maxVerticalSpeedLanes[lane] = storage.m_maxVerticalSpeed[slotIndex];
+			sleepLanes[lane] = (storage.m_canSleep[slotIndex] != 0 ? 1.f : 0.f);
+
+			// Corrections after last frame's integrate (as well as any rotations applied during the game frame)
+			// will have changed the world moment of inertia - ensure that's up-to-date
+			bodies[lane]->CalculateDerivedData();
+		}
+
+		if (!anyActive)
+			continue;
+
+		const __m128 iMass = _mm_loadu_ps(iMassLanes);
+
+		// Calculate/apply linear acceleration
+		__m128 accX = _mm_add_ps(_mm_loadu_ps(accelerationLanes[0]), _mm_mul_ps(_mm_loadu_ps(forceLanes[0]), iMass));
+		__m128 accY = _mm_add_ps(_mm_loadu_ps(accelerationLanes[1]), _mm_mul_ps(_mm_loadu_ps(forceLanes[1]), iMass));
+		__m128 accZ = _mm_add_ps(_mm_loadu_ps(accelerationLanes[2]), _mm_mul_ps(_mm_loadu_ps(forceLanes[2]), iMass));
+
+		__m128 velX = _mm_add_ps(_mm_loadu_ps(velocityLanes[0]), _mm_mul_ps(accX, dt));
+		__m128 velY = _mm_add_ps(_mm_loadu_ps(velocityLanes[1]), _mm_mul_ps(accY, dt));
+		__m128 velZ = _mm_add_ps(_mm_loadu_ps(velocityLanes[2]), _mm_mul_ps(accZ, dt));
+
+		// Impose linear damping
+		const __m128 linearDamping = _mm_loadu_ps(linearDampingLanes);
+		velX = _mm_mul_ps(velX, linearDamping);
+		velY = _mm_mul_ps(velY, linearDamping);
+		velZ = _mm_mul_ps(velZ, linearDamping);
+
+		// Clamp vertical speed, keeping the sign
+		const __m128 maxVerticalSpeed = _mm_loadu_ps(maxVerticalSpeedLanes);
+		const __m128 signBit = _mm_set1_ps(-0.f);
+		__m128 overVerticalLimit = _mm_cmpgt_ps(_mm_andnot_ps(signBit, velY), maxVerticalSpeed);
+		__m128 isMovingUp = _mm_cmpgt_ps(velY, zero);
+		__m128 clampedVelY = _mm_or_ps(_mm_and_ps(isMovingUp, maxVerticalSpeed), _mm_andnot_ps(isMovingUp, _mm_xor_ps(signBit, maxVerticalSpeed)));
+		velY = _mm_or_ps(_mm_and_ps(overVerticalLimit, clampedVelY), _mm_andnot_ps(overVerticalLimit, velY));
+
+		_mm_storeu_ps(velocityLanes[0], velX);
+		_mm_storeu_ps(velocityLanes[1], velY);
+		_mm_storeu_ps(velocityLanes[2], velZ);
+		_mm_storeu_ps(accelerationLanes[0], accX);
+		_mm_storeu_ps(accelerationLanes[1], accY);
+		_mm_storeu_ps(accelerationLanes[2], accZ);
+
+		// Write back, then the lateral clamp, position and rotation per body
+		for (int lane = 0; lane < RigidBodyStorage::SIMD_WIDTH; ++lane)
+		{
+			RigidBody* body = bodies[lane];
+			if (body == nullptr)
+				continue;
+
+			int slotIndex = slotIndices[lane];
+			Vector3 velocityWs = Vector3(velocityLanes[0][lane], velocityLanes[1][lane], velocityLanes[2][lane]);
+			float maxLateralSpeed = storage.m_maxLateralSpeed[slotIndex];
+
+			// Remember what our acceleration was last frame
+			storage.m_lastFrameAccelerationWs.Set(slotIndex, Vector3(accelerationLanes[0][lane], accelerationLanes[1][lane], accelerationLanes[2][lane]));
+
+			Vector3 lateralVelocity = Vector3(velocityWs.x, 0.f, velocityWs.z);
+			if (lateralVelocity.GetLengthSquared() > maxLateralSpeed * maxLateralSpeed)
+			{
+				lateralVelocity.Normalize();
+				lateralVelocity *= maxLateralSpeed;
+				velocityWs.x = lateralVelocity.x;
+				velocityWs.z = lateralVelocity.z;
+			}
+
+			storage.m_velocityWs.Set(slotIndex, velocityWs);
+
+			body->transform->position += velocityWs * deltaSeconds;
+			body->IntegrateAngular(deltaSeconds);
+			body->CalculateDerivedData();
+
+			// Clear forces
+			storage.m_forceAccumWs.Set(slotIndex, Vector3::ZERO);
+			storage.m_torqueAccumWs.Set(slotIndex, Vector3::ZERO);
+		}
+
+		// Update the kinetic energy store, and possibly put the bodies to sleep
+		const __m128 sleepMask = _mm_cmpgt_ps(_mm_loadu_ps(sleepLanes), zero);
+		if (_mm_movemask_ps(sleepMask) == 0)
+			continue;
+
+		float angularVelocityLanes[3][RigidBodyStorage::SIMD_WIDTH] = {};
+		float motionLanes[RigidBodyStorage::SIMD_WIDTH] = {};
+
+		for (int lane = 0; lane < RigidBodyStorage::SIMD_WIDTH; ++lane)
+		{
+			if (sleepLanes[lane] == 0.f)
+				continue;
+
+			int slotIndex = slotIndices[lane];
+			velocityLanes[0][lane] = storage.m_velocityWs.x[slotIndex];
+			velocityLanes[1][lane] = storage.m_velocityWs.y[slotIndex];
+			velocityLanes[2][lane] = storage.m_velocityWs.z[slotIndex];
+			angularVelocityLanes[0][lane] = storage.m_angularVelocityRadiansWs.x[slotIndex];
+			angularVelocityLanes[1][lane] = storage.m_angularVelocityRadiansWs.y[slotIndex];
+			angularVelocityLanes[2][lane] = storage.m_angularVelocityRadiansWs.z[slotIndex];
+			motionLanes[lane] = storage.m_motion[slotIndex];
+		}
+
+		velX = _mm_loadu_ps(velocityLanes[0]);
+		velY = _mm_loadu_ps(velocityLanes[1]);
+		velZ = _mm_loadu_ps(velocityLanes[2]);
+		__m128 angX = _mm_loadu_ps(angularVelocityLanes[0]);
+		__m128 angY = _mm_loadu_ps(angularVelocityLanes[1]);
+		__m128 angZ = _mm_loadu_ps(angularVelocityLanes[2]);
+
+		__m128 linearMotion = _mm_add_ps(_mm_add_ps(_mm_mul_ps(velX, velX), _mm_mul_ps(velY, velY)), _mm_mul_ps(velZ, velZ));
+		__m128 angularMotion = _mm_add_ps(_mm_add_ps(_mm_mul_ps(angX, angX), _mm_mul_ps(angY, angY)), _mm_mul_ps(angZ, angZ));
+		__m128 currentMotion = _mm_add_ps(linearMotion, angularMotion);
+
+		// Recency weighted average, see RigidBody::Integrate
+		__m128 motion = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(bias), _mm_loadu_ps(motionLanes)), _mm_mul_ps(_mm_set1_ps(1.f - bias), currentMotion));
+		motion = _mm_min_ps(motion, _mm_set1_ps(10.f * RigidBody::SLEEP_EPSILON));
+		_mm_storeu_ps(motionLanes, motion);
+
+		// The min above can't drop motion below the epsilon, so this still matches the scalar check
+		int fallAsleepBits = _mm_movemask_ps(_mm_and_ps(sleepMask, _mm_cmplt_ps(motion, _mm_set1_ps(RigidBody::SLEEP_EPSILON))));
+
+		for (int lane = 0; lane < RigidBodyStorage::SIMD_WIDTH; ++lane)
+		{
+			if (sleepLanes[lane] == 0.f)
+				continue;
+
+			storage.m_motion[slotIndices[lane]] = motionLanes[lane];
+
+			if ((fallAsleepBits & (1 << lane)) != 0)
+			{
+				bodies[lane]->SetIsAwake(false);
+			}
+		}
+	}
+}
+
+
+//-------------------------------------------------------------------------------------------------
+void PhysicsScene::TakeOwnershipOfBody(RigidBody* body)
+{
+	m_bodies.push_back(body);
+	m_bodySlots.push_back(body->GetStorageIndex());
+	RigidBodyStorage::Get().m_owningScenes[body->GetStorageIndex()] = this;
+
+	RigidBodyPose pose = GetBodyPose(body);
+	m_previousPoses.push_back(pose);
+	m_simulatedPoses.push_back(pose);
+	m_renderedPoses.push_back(pose);
+}
+
+
+//-------------------------------------------------------------------------------------------------
+// If game code moved a body since the last frame, that's taken as a teleport and the new pose becomes the simulated one
+void PhysicsScene::RestoreSimulatedPoses()
+{
+	for (int bodyIndex = 0; bodyIndex < (int)m_bodies.size(); ++bodyIndex)
+	{
+		RigidBody* body = m_bodies[bodyIndex];
+		RigidBodyPose currentPose = GetBodyPose(body);
+
+		if (ArePosesIdentical(currentPose, m_renderedPoses[bodyIndex]))
+		{
+			SetBodyPose(body, m_simulatedPoses[bodyIndex]);
+		}
+		else
+		{
+			m_previousPoses[bodyIndex] = currentPose;
+			m_simulatedPoses[bodyIndex] = currentPose;
+		}
+	}
+}
+
+
+//-------------------------------------------------------------------------------------------------
+void PhysicsScene::WriteInterpolatedPoses()
+{
+	for (int bodyIndex = 0; bodyIndex < (int)m_bodies.size(); ++bodyIndex)
+	{
+		RigidBodyPose renderedPose = m_simulatedPoses[bodyIndex];
+
+		if (m_interpolationEnabled)
+		{
+			const RigidBodyPose& previousPose = m_previousPoses[bodyIndex];
+			renderedPose.m_position = Interpolate(previousPose.m_position, renderedPose.m_position, m_interpolationAlpha);
+			renderedPose.m_rotation = Quaternion::Slerp(previousPose.m_rotation, renderedPose.m_rotation, m_interpolationAlpha);
+		}
+
+		SetBodyPose(m_bodies[bodyIndex], renderedPose);
+		m_renderedPoses[bodyIndex] = renderedPose;
+	}
+}
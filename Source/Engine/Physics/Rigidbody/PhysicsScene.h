@@ -10,6 +10,7 @@
 ///--------------------------------------------------------------------------------------------------------------------------------------------------
 #include "Engine/Collision/BoundingVolumeHierarchy/BoundingVolume.h"
 #include "Engine/Collision/CollisionScene.h"
+#include "Engine/Physics/RigidBody/RigidBody.h"
 #include "Engine/Physics/RigidBody/RigidBodyForceRegistry.h"
 #include <vector>
 
@@ -23,6 +24,29 @@
 class RigidBody;
 class RigidBodyForceGenerator;
 
+// Where a body was at the end of a physics step
+struct RigidBodyPose
+{
+	Vector3		m_position;
+	Quaternion	m_rotation;
+};
+
+// Full simulation state of a PhysicsScene and its CollisionScene, for rollback and replays
+// Restoring and stepping with the same inputs gives bit-identical results on the same build
+// Bodies are referred to by the order they were added, so a snapshot can be restored into a scene set up the same way
+struct PhysicsSnapshot
+{
+	void WriteToBytes(std::vector<uint8>& out_bytes) const; // Clears first, raw copies of the arrays so only readable by the same build
+	bool ReadFromBytes(const uint8* bytes, size_t numBytes); // Returns false if the bytes are cut short or don't hold a snapshot
+
+	int												m_numBodies = 0; // Only used to check the snapshot still matches the scene
+	std::vector<RigidBodyState>						m_bodyStates; // Simulated poses, not the interpolated ones FrameStep() leaves in the transforms
+	std::vector<RigidBodyPose>						m_previousPoses; // Parallel to m_bodyStates, for interpolation
+	float											m_timeAccumulator = 0.f;
+	CollisionSceneSnapshot<BoundingVolumeSphere>	m_collisionState;
+	bool											m_hasCollisionState = false;
+};
+
 ///--------------------------------------------------------------------------------------------------------------------------------------------------
 /// GLOBALS AND STATICS
 ///--------------------------------------------------------------------------------------------------------------------------------------------------
@@ -40,37 +64,86 @@ public:
 	PhysicsScene(CollisionScene<BoundingVolumeSphere>* collisionScene);
 	~PhysicsScene();
 
+	// The game loop should call FrameStep() once a frame with the frame's delta. DoPhysicsStep() is one raw step for tools
+	// and tests that step manually; it doesn't touch the accumulator or interpolation, so don't mix the two on one scene
 	void BeginFrame();
+	void FrameStep(float frameSeconds); // Runs as many fixed steps as fit in the accumulated time, then interpolates the transforms
 	void DoPhysicsStep(float deltaSeconds);
 
 	void SetGravityAcceleration(const Vector3& gravityAcc) { m_gravityAcc = gravityAcc; }
 	void SetGravityEnabled(bool enabled) { m_gravityEnabled = enabled; }
+	void SetUseBatchedIntegration(bool useBatched) { m_useBatchedIntegration = useBatched; }
+	void SetFixedStepSeconds(float fixedStepSeconds);
+	void SetMaxStepsPerFrame(int maxSteps);
+	void SetInterpolationEnabled(bool enabled) { m_interpolationEnabled = enabled; }
+	void SetNumSubsteps(int numSubsteps); // Only used with CONTACT_SOLVER_SUBSTEPPED
 	void AddRigidbody(RigidBody* body);
-	void AddForceGenerator(RigidBodyForceGenerator* forceGen, RigidBody* body);
+	RigidBodyForceHandle AddForceGenerator(RigidBodyForceGenerator* forceGen, RigidBody* body);
+	bool RemoveForceRegistration(const RigidBodyForceHandle& handle) { return m_forceRegistry.RemoveRegistration(handle); }
+	RigidBodyForceRegistry& GetForceRegistry() { return m_forceRegistry; } // For adding batched forces directly, to bodies already in the scene
+
+	void SaveSnapshot(PhysicsSnapshot& out_snapshot) const;
+	bool RestoreSnapshot(const PhysicsSnapshot& snapshot); // Returns false if bodies were added or removed since the save
+
+	float	GetFixedStepSeconds() const { return m_fixedStepSeconds; }
+	float	GetInterpolationAlpha() const { return m_interpolationAlpha; }
+	int		GetNumStepsLastFrame() const { return m_numStepsLastFrame; }
+	float	GetDroppedSecondsLastFrame() const { return m_droppedSecondsLastFrame; }
+	double	GetIntegrateSeconds() const { return m_integrateSeconds; } // Forces and integration, summed over every step since the last reset
+	void	ResetStepTimings(); // Also resets the collision scene's timings
 
 
 private:
 	//-----Private Methods-----
 
+	void DoSubsteppedPhysicsStep(float deltaSeconds);
 	void Integrate(float deltaSeconds);
+	void IntegrateBodiesIndividually(float deltaSeconds);
+	void IntegrateStorageBatched(float deltaSeconds);
+	void TakeOwnershipOfBody(RigidBody* body);
+	void RestoreSimulatedPoses();
+	void WriteInterpolatedPoses();
 
 
 public:
 	//-----Public Methods-----
 
 	static const Vector3 DEFAULT_GRAVITY;
+	static constexpr float DEFAULT_FIXED_STEP_SECONDS = (1.f / 60.f);
+	static constexpr int DEFAULT_MAX_STEPS_PER_FRAME = 5;
+	static constexpr int DEFAULT_NUM_SUBSTEPS = 4;
 
 
 private:
 	//-----Private Data-----
 
 	bool									m_gravityEnabled = true;
+	bool									m_useBatchedIntegration = true;
+	int										m_numSubsteps = DEFAULT_NUM_SUBSTEPS;
 	Vector3									m_gravityAcc = DEFAULT_GRAVITY;
 	std::vector<RigidBody*>					m_bodies;
+	std::vector<int>						m_bodySlots; // Storage slot of each body in m_bodies, what batched integration walks
 	std::vector<RigidBodyForceGenerator*>	m_forceGens;
 	RigidBodyForceRegistry					m_forceRegistry;
 	CollisionScene<BoundingVolumeSphere>*	m_collisionScene = nullptr;
 
+	// Fixed stepping
+	float									m_fixedStepSeconds = DEFAULT_FIXED_STEP_SECONDS;
+	int										m_maxStepsPerFrame = DEFAULT_MAX_STEPS_PER_FRAME;
+	float									m_timeAccumulator = 0.f;
+	float									m_interpolationAlpha = 1.f;
+	int										m_numStepsLastFrame = 0;
+	float									m_droppedSecondsLastFrame = 0.f;
+	bool									m_interpolationEnabled = true;
+
+	// Profiling
+	double									m_integrateSeconds = 0.0;
+
+	// Parallel to m_bodies
+	std::vector<RigidBodyPose>				m_previousPoses; // Pose before the last step
+	std::vector<RigidBodyPose>				m_simulatedPoses; // Pose after the last step
+	std::vector<RigidBodyPose>				m_renderedPoses; // Interpolated pose written to the transform, to detect game code moving the body
+
 };
 
 ///--------------------------------------------------------------------------------------------------------------------------------------------------
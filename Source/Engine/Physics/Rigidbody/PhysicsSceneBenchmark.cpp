@@ -0,0 +1,338 @@
+///--------------------------------------------------------------------------------------------------------------------------------------------------
+/// Author: Andrew Chase
+/// Date Created: October 18th, 2026
+/// Description:
+///--------------------------------------------------------------------------------------------------------------------------------------------------
+
+///--------------------------------------------------------------------------------------------------------------------------------------------------
+/// INCLUDES
+///--------------------------------------------------------------------------------------------------------------------------------------------------
+#include "Engine/Collision/BoundingVolumeHierarchy/BoundingVolume.h"
+#include "Engine/Collision/Collider.h"
+#include "Engine/Collision/CollisionScene.h"
+#include "Engine/Core/DevConsole.h"
+#include "Engine/Core/EngineCommon.h"
+#include "Engine/Core/Entity.h"
+#include "Engine/Math/MathUtils.h"
+#include "Engine/Math/Polyhedron.h"
+#include "Engine/Physics/Rigidbody/PhysicsScene.h"
+#include "Engine/Physics/Rigidbody/PhysicsSceneBenchmark.h"
+#include "Engine/Physics/Rigidbody/RigidBodyForceRegistry.h"
+#include "Engine/Physics/Rigidbody/Rigidbody.h"
+#include "Engine/Time/Time.h"
+#include "Engine/Utility/StringUtils.h"
+
+///--------------------------------------------------------------------------------------------------------------------------------------------------
+/// DEFINES
+///--------------------------------------------------------------------------------------------------------------------------------------------------
+
+///--------------------------------------------------------------------------------------------------------------------------------------------------
+/// ENUMS, TYPEDEFS, STRUCTS, FORWARD DECLARATIONS
+///--------------------------------------------------------------------------------------------------------------------------------------------------
+
+///--------------------------------------------------------------------------------------------------------------------------------------------------
+/// GLOBALS AND STATICS
+///--------------------------------------------------------------------------------------------------------------------------------------------------
+
+///--------------------------------------------------------------------------------------------------------------------------------------------------
+/// C FUNCTIONS
+///--------------------------------------------------------------------------------------------------------------------------------------------------
+
+//-------------------------------------------------------------------------------------------------
+// Dynamic entity for the physics scenarios, the physics scene takes the body
+static Entity* MakePhysicsBenchmarkBody(const Vector3& position, const Quaternion& rotation, std::vector<Entity*>& out_entities)
+{
+	Entity* entity = new Entity();
+	entity->transform.position = position;
+	entity->transform.rotation = rotation;
+	entity->rigidBody = new RigidBody(&entity->transform);
+	out_entities.push_back(entity);
+
+	return entity;
+}
+
+
+//-------------------------------------------------------------------------------------------------
+// Half space floor, plus four walls facing in when halfWidth is positive
+static void MakePhysicsBenchmarkTank(float halfWidth, std::vector<Entity*>& out_entities)
+{
+	std::vector<Plane3> planes;
+	planes.push_back(Plane3(Vector3::Y_AXIS, 0.f));
+
+	if (halfWidth > 0.f)
+	{
+		planes.push_back(Plane3(Vector3::X_AXIS, -halfWidth));
+		planes.push_back(Plane3(Vector3::MINUS_X_AXIS, -halfWidth));
+		planes.push_back(Plane3(Vector3::Z_AXIS, -halfWidth));
+		planes.push_back(Plane3(Vector3::MINUS_Z_AXIS, -halfWidth));
+	}
+
+	for (const Plane3& plane : planes)
+	{
+		Entity* wall = new Entity();
+		wall->collider = new HalfSpaceCollider(wall, plane);
+		out_entities.push_back(wall);
+	}
+}
+
+
+//-------------------------------------------------------------------------------------------------
+// Hexagonal prism along y, faces wound like Polyhedron's box topology
+static Polyhedron MakePhysicsBenchmarkHull(float radius, float halfHeight)
+{
+	Polyhedron hull;
+
+	for (int ringIndex = 0; ringIndex < 2; ++ringIndex)
+	{
+		float y = (ringIndex == 0 ? -halfHeight : halfHeight);
+
+		for (int sideIndex = 0; sideIndex < 6; ++sideIndex)
+		{
+			float angleDegrees = 60.f * (float)sideIndex;
+			hull.AddVertex(Vector3(radius * CosDegrees(angleDegrees), y, radius * SinDegrees(angleDegrees)));
+		}
+	}
+
+	const int bottom[6] = { 0, 1, 2, 3, 4, 5 };
+	const int top[6] = { 11, 10, 9, 8, 7, 6 };
+	hull.AddFace(bottom, 6);
+	hull.AddFace(top, 6);
+
+	for (int sideIndex = 0; sideIndex < 6; ++sideIndex)
+	{
+		int nextIndex = (sideIndex + 1) % 6;
+		const int side[4] = { sideIndex, sideIndex + 6, nextIndex + 6, nextIndex };
+		hull.AddFace(side, 4);
+	}
+
+	hull.GenerateHalfEdgeStructure();
+
+	return hull;
+}
+
+
+//-------------------------------------------------------------------------------------------------
+// Steps one scenario and appends its CSV row, returns false if a step ran into the pair or contact limit
+// Consecutive runs of chainLength bodies are linked end to end with springs, as there are no joints to build ragdolls from
+static bool RunPhysicsBenchmarkScenario(const char* name, std::vector<Entity*>& entities, int chainLength, int numSteps, std::string& inout_csv)
+{
+	const float deltaSeconds = 1.f / 60.f;
+	const float chainSpringConstant = 200.f;
+
+	std::vector<RigidBody*> bodies;
+	for (Entity* entity : entities)
+	{
+		if (entity->rigidBody != nullptr)
+		{
+			bodies.push_back(entity->rigidBody);
+		}
+	}
+
+	int numBodies = (int)bodies.size();
+	int maxPotentialCollisions = Max(8 * numBodies, 64);
+	int maxContacts = Max(8 * numBodies, 128);
+
+	CollisionScene<BoundingVolumeSphere> collisionScene;
+	collisionScene.SetCollisionLimits(maxPotentialCollisions, maxContacts);
+	collisionScene.AddEntities(entities);
+
+	double totalSeconds = 0.0;
+	double worstStepSeconds = 0.0;
+	int64 pairSum = 0;
+	int64 contactSum = 0;
+	int peakPairs = 0;
+	int peakContacts = 0;
+	CollisionStepTimings timings;
+	double integrateSeconds = 0.0;
+
+	{
+		// Scoped so the bodies are deleted here, as the physics scene owns them
+		PhysicsScene physicsScene(&collisionScene);
+
+		for (RigidBody* body : bodies)
+		{
+			physicsScene.AddRigidbody(body);
+		}
+
+		if (chainLength > 1)
+		{
+			RigidBodyForceRegistry& registry = physicsScene.GetForceRegistry();
+
+			for (int bodyIndex = 0; bodyIndex + 1 < numBodies; ++bodyIndex)
+			{
+				if ((bodyIndex + 1) % chainLength == 0)
+					continue;
+
+				// Each link's end is pulled to its neighbor's center, both ways so the pair stays balanced
+				RigidBody* link = bodies[bodyIndex];
+				RigidBody* nextLink = bodies[bodyIndex + 1];
+				float restLength = 0.5f * (nextLink->GetCenterOfMassWs() - link->GetCenterOfMassWs()).GetLength();
+
+				registry.AddSpring(link, Vector3(restLength, 0.f, 0.f), nextLink, chainSpringConstant, restLength);
+				registry.AddSpring(nextLink, Vector3(-restLength, 0.f, 0.f), link, chainSpringConstant, restLength);
+			}
+		}
+
+		physicsScene.ResetStepTimings();
+
+		for (int stepIndex = 0; stepIndex < numSteps; ++stepIndex)
+		{
+			uint64 start = GetPerformanceCounter();
+			physicsScene.DoPhysicsStep(deltaSeconds);
+			double stepSeconds = TimeSystem::PerformanceCountToSeconds(GetPerformanceCounter() - start);
+
+			totalSeconds += stepSeconds;
+			worstStepSeconds = Max(worstStepSeconds, stepSeconds);
+			pairSum += collisionScene.GetNumPotentialCollisions();
+			contactSum += collisionScene.GetNumContacts();
+			peakPairs = Max(peakPairs, collisionScene.GetNumPotentialCollisions());
+			peakContacts = Max(peakContacts, collisionScene.GetNumContacts());
+		}
+
+		timings = collisionScene.GetStepTimings();
+		integrateSeconds = physicsScene.GetIntegrateSeconds();
+		collisionScene.RemoveAllEntities();
+	}
+
+	for (Entity* entity : entities)
+	{
+		SAFE_DELETE(entity->collider);
+		entity->rigidBody = nullptr;
+		SAFE_DELETE(entity);
+	}
+
+	entities.clear();
+
+	// Per step averages
+	double msPerStep = 1000.0 / (double)numSteps;
+	bool isSaturated = (peakPairs >= maxPotentialCollisions || peakContacts >= maxContacts);
+
+	std::string row = Stringf("%s,%i,%i,%.4f,%.4f,%.4f,%.4f,%.4f,%.4f,%.1f,%.1f,%i,%i,%i",
+		name, numBodies, numSteps,
+		timings.m_broadphaseSeconds * msPerStep, timings.m_narrowphaseSeconds * msPerStep, timings.m_solveSeconds * msPerStep, integrateSeconds * msPerStep,
+		totalSeconds * msPerStep, worstStepSeconds * 1000.0,
+		(double)pairSum / (double)numSteps, (double)contactSum / (double)numSteps, peakPairs, peakContacts, (isSaturated ? 1 : 0));
+
+	ConsoleLogf((isSaturated ? Rgba::RED : Rgba::WHITE), "%s", row.c_str());
+	inout_csv += row + "\n";
+
+	return !isSaturated;
+}
+
+
+
+//-------------------------------------------------------------------------------------------------
+// Standard scenes stepped straight through PhysicsScene and CollisionScene, one CSV row of per step phase timings each
+// Shared by the physicsbench command and the standalone PhysicsBench executable, so both produce the same numbers
+bool RunPhysicsSceneBenchmarks(int numSteps, std::string& out_csv)
+{
+	out_csv = PHYSICS_BENCHMARK_CSV_HEADER;
+	out_csv += "\n";
+
+	bool allFit = true;
+	std::vector<Entity*> entities;
+
+	// Box pyramid, 20 on the bottom row
+	{
+		const int baseWidth = 20;
+		const Vector3 boxExtents = Vector3(0.5f);
+		MakePhysicsBenchmarkTank(0.f, entities);
+
+		for (int rowIndex = 0; rowIndex < baseWidth; ++rowIndex)
+		{
+			int numInRow = baseWidth - rowIndex;
+			float startX = -0.505f * (float)(numInRow - 1);
+
+			for (int boxIndex = 0; boxIndex < numInRow; ++boxIndex)
+			{
+				Vector3 position = Vector3(startX + 1.01f * (float)boxIndex, 0.5f + 1.01f * (float)rowIndex, 0.f);
+				Entity* box = MakePhysicsBenchmarkBody(position, Quaternion::IDENTITY, entities);
+				box->rigidBody->SetInertiaTensor_Box(boxExtents);
+				box->collider = new BoxCollider(box, OBB3(Vector3::ZERO, boxExtents, Quaternion::IDENTITY));
+			}
+		}
+
+		allFit = RunPhysicsBenchmarkScenario("box_pyramid", entities, 0, numSteps, out_csv) && allFit;
+	}
+
+	// Hull pile, a block of hexagonal prisms sharing one shape dropped into a tank
+	{
+		const int numPerSide = 8;
+		const float spacing = 1.3f;
+		Polyhedron hullLs = MakePhysicsBenchmarkHull(0.5f, 0.3f);
+		R<ConvexHullShape> hullShape = ConvexHullShape::Create(hullLs);
+		MakePhysicsBenchmarkTank(0.5f * spacing * (float)numPerSide + 1.f, entities);
+
+		for (int index = 0; index < numPerSide * numPerSide * numPerSide; ++index)
+		{
+			int xIndex = index % numPerSide;
+			int yIndex = index / (numPerSide * numPerSide);
+			int zIndex = (index / numPerSide) % numPerSide;
+
+			Vector3 position = Vector3(spacing * ((float)xIndex - 0.5f * (float)(numPerSide - 1)), 1.f + spacing * (float)yIndex, spacing * ((float)zIndex - 0.5f * (float)(numPerSide - 1)));
+			Quaternion rotation = Quaternion::CreateFromEulerAnglesDegrees(Vector3(17.f * (float)(index % 5), 23.f * (float)(index % 7), 0.f));
+
+			Entity* hull = MakePhysicsBenchmarkBody(position, rotation, entities);
+			hull->rigidBody->SetInertiaTensor_Polygon(hullLs);
+			hull->collider = new ConvexHullCollider(hull, hullShape);
+		}
+
+		allFit = RunPhysicsBenchmarkScenario("hull_pile", entities, 0, numSteps, out_csv) && allFit;
+	}
+
+	// Sphere rain, 10k spheres falling into a tank
+	{
+		const int numPerSide = 25;
+		const int numLayers = 16;
+		const float radius = 0.25f;
+		const float spacing = 0.75f;
+		MakePhysicsBenchmarkTank(0.5f * spacing * (float)numPerSide + 0.5f, entities);
+
+		for (int index = 0; index < numPerSide * numPerSide * numLayers; ++index)
+		{
+			int xIndex = index % numPerSide;
+			int yIndex = index / (numPerSide * numPerSide);
+			int zIndex = (index / numPerSide) % numPerSide;
+
+			// Layers are staggered so spheres don't land exactly on top of each other
+			float stagger = (yIndex % 2 == 0 ? 0.f : 0.5f * spacing - 0.05f);
+			Vector3 position = Vector3(spacing * ((float)xIndex - 0.5f * (float)(numPerSide - 1)) + stagger, 2.f + spacing * (float)yIndex, spacing * ((float)zIndex - 0.5f * (float)(numPerSide - 1)) + stagger);
+
+			Entity* sphere = MakePhysicsBenchmarkBody(position, Quaternion::IDENTITY, entities);
+			sphere->rigidBody->SetInertiaTensor_Sphere(radius);
+			sphere->collider = new SphereCollider(sphere, Sphere(Vector3::ZERO, radius));
+		}
+
+		allFit = RunPhysicsBenchmarkScenario("sphere_rain", entities, 0, numSteps, out_csv) && allFit;
+	}
+
+	// Chains of capsules linked with springs, laid in crossing layers so they fall and tangle
+	{
+		const int numChains = 24;
+		const int chainLength = 10;
+		const float linkHalfLength = 0.3f;
+		const float linkRadius = 0.15f;
+		const float linkSpacing = 2.f * (linkHalfLength + linkRadius) + 0.05f;
+		MakePhysicsBenchmarkTank(0.f, entities);
+
+		for (int chainIndex = 0; chainIndex < numChains; ++chainIndex)
+		{
+			int layerIndex = chainIndex / 4;
+			float yawDegrees = (layerIndex % 2 == 0 ? 0.f : 90.f);
+			Quaternion rotation = Quaternion::CreateFromEulerAnglesDegrees(Vector3(0.f, yawDegrees, 0.f));
+			Vector3 chainStart = Vector3(-0.5f * linkSpacing * (float)(chainLength - 1), 1.f + 0.8f * (float)layerIndex, 1.2f * ((float)(chainIndex % 4) - 1.5f));
+
+			for (int linkIndex = 0; linkIndex < chainLength; ++linkIndex)
+			{
+				Vector3 position = rotation.RotatePosition(chainStart + Vector3(linkSpacing * (float)linkIndex, 0.f, 0.f));
+				Entity* link = MakePhysicsBenchmarkBody(position, rotation, entities);
+				link->rigidBody->SetInertiaTensor_Box(Vector3(linkHalfLength + linkRadius, linkRadius, linkRadius));
+				link->collider = new CapsuleCollider(link, Capsule3(Vector3(-linkHalfLength, 0.f, 0.f), Vector3(linkHalfLength, 0.f, 0.f), linkRadius));
+			}
+		}
+
+		allFit = RunPhysicsBenchmarkScenario("spring_chains", entities, chainLength, numSteps, out_csv) && allFit;
+	}
+
+	return allFit;
+}
@@ -60,3 +60,10 @@ void RigidBodyAnchoredSpring::GenerateAndAddForce(RigidBody* body, float deltaSe
 		body->AddWorldForceAtLocalPoint(forceDir * -currLength, m_connectionPointLs);
 	}
 }
+
+
+//-------------------------------------------------------------------------------------------------
+RigidBodyForceHandle RigidBodyAnchoredSpring::AddToRegistry(RigidBodyForceRegistry& registry, RigidBody* body)
+{
+	return registry.AddAnchoredSpring(body, m_connectionPointLs, m_anchorPositionWs, m_springConstant, m_restLength);
+}
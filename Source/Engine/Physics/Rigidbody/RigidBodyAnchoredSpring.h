@@ -35,6 +35,7 @@ public:
 
 	RigidBodyAnchoredSpring(const Vector3& connectionPointLs, const Vector3& anchorPositionWs, float springConstant, float restLength);
 	virtual void GenerateAndAddForce(RigidBody* body, float deltaSeconds) const override;
+	virtual RigidBodyForceHandle AddToRegistry(RigidBodyForceRegistry& registry, RigidBody* body) override;
 
 
 private:
@@ -8,8 +8,13 @@
 /// INCLUDES
 ///--------------------------------------------------------------------------------------------------------------------------------------------------
 #include "Engine/Core/EngineCommon.h"
+#include "Engine/Job/JobSystem.h"
+#include "Engine/Math/MathUtils.h"
+#include "Engine/Physics/RigidBody/RigidBody.h"
 #include "Engine/Physics/RigidBody/RigidBodyForceGenerator.h"
 #include "Engine/Physics/RigidBody/RigidBodyForceRegistry.h"
+#include "Engine/Physics/RigidBody/RigidBodyStorage.h"
+#include <xmmintrin.h>
 
 ///--------------------------------------------------------------------------------------------------------------------------------------------------
 /// DEFINES
@@ -27,22 +32,418 @@
 /// C FUNCTIONS
 ///--------------------------------------------------------------------------------------------------------------------------------------------------
 
+//-------------------------------------------------------------------------------------------------
+template <typename T>
+static void SwapRemove(std::vector<T>& values, int index)
+{
+	values[index] = values.back();
+	values.pop_back();
+}
+
+
+//-------------------------------------------------------------------------------------------------
+// F = m * g, only for awake dynamic bodies so gravity never keeps a body from sleeping
+static void ComputeGravityForces(const RigidBodyForceBatch& batch, int firstIndex, int numLanes, float* out_forceX, float* out_forceY, float* out_forceZ)
+{
+	const RigidBodyStorage& storage = RigidBodyStorage::Get();
+	float masses[4] = { 0.f, 0.f, 0.f, 0.f };
+
+	for (int lane = 0; lane < numLanes; ++lane)
+	{
+		int slotIndex = batch.m_bodies[firstIndex + lane]->GetStorageIndex();
+		float iMass = storage.m_inverseMass[slotIndex];
+		masses[lane] = (storage.m_isAwake[slotIndex] != 0 && iMass > 0.f ? 1.f / iMass : 0.f);
+	}
+
+	float accelerations[3][4] = {};
+	for (int lane = 0; lane < numLanes; ++lane)
+	{
+		accelerations[0][lane] = batch.m_paramsX[firstIndex + lane];
+		accelerations[1][lane] = batch.m_paramsY[firstIndex + lane];
+		accelerations[2][lane] = batch.m_paramsZ[firstIndex + lane];
+	}
+
+	__m128 mass = _mm_loadu_ps(masses);
+	_mm_storeu_ps(out_forceX, _mm_mul_ps(_mm_loadu_ps(accelerations[0]), mass));
+	_mm_storeu_ps(out_forceY, _mm_mul_ps(_mm_loadu_ps(accelerations[1]), mass));
+	_mm_storeu_ps(out_forceZ, _mm_mul_ps(_mm_loadu_ps(accelerations[2]), mass));
+}
+
+
+//-------------------------------------------------------------------------------------------------
+// F = -v * (k1 + k2 * |v|), i.e. k1 * |v| + k2 * |v|^2 against the direction of motion
+static void ComputeDragForces(const RigidBodyForceBatch& batch, int firstIndex, int numLanes, float* out_forceX, float* out_forceY, float* out_forceZ)
+{
+	const RigidBodyStorage& storage = RigidBodyStorage::Get();
+	float velocities[3][4] = {};
+	float k1s[4] = {};
+	float k2s[4] = {};
+
+	for (int lane = 0; lane < numLanes; ++lane)
+	{
+		int slotIndex = batch.m_bodies[firstIndex + lane]->GetStorageIndex();
+		if (storage.m_isAwake[slotIndex] == 0 || storage.m_inverseMass[slotIndex] <= 0.f)
+			continue;
+
+		velocities[0][lane] = storage.m_velocityWs.x[slotIndex];
+		velocities[1][lane] = storage.m_velocityWs.y[slotIndex];
+		velocities[2][lane] = storage.m_velocityWs.z[slotIndex];
+		k1s[lane] = batch.m_paramsX[firstIndex + lane];
+		k2s[lane] = batch.m_paramsY[firstIndex + lane];
+	}
+
+	__m128 velX = _mm_loadu_ps(velocities[0]);
+	__m128 velY = _mm_loadu_ps(velocities[1]);
+	__m128 velZ = _mm_loadu_ps(velocities[2]);
+	__m128 speed = _mm_sqrt_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(velX, velX), _mm_mul_ps(velY, velY)), _mm_mul_ps(velZ, velZ)));
+	__m128 negCoefficient = _mm_sub_ps(_mm_setzero_ps(), _mm_add_ps(_mm_loadu_ps(k1s), _mm_mul_ps(_mm_loadu_ps(k2s), speed)));
+
+	_mm_storeu_ps(out_forceX, _mm_mul_ps(velX, negCoefficient));
+	_mm_storeu_ps(out_forceY, _mm_mul_ps(velY, negCoefficient));
+	_mm_storeu_ps(out_forceZ, _mm_mul_ps(velZ, negCoefficient));
+}
+
+
+//-------------------------------------------------------------------------------------------------
+// Hooke's law along the line from the anchor to the connection point, 0 if they coincide
+// Anchored springs anchor to a fixed point, body springs to the other body's position
+// Connection points come from m_connectionPointsWs, so nothing here touches a Transform's cached matrices
+static void ComputeSpringForces(const RigidBodyForceBatch& batch, bool isAnchored, int firstIndex, int numLanes, float* out_forceX, float* out_forceY, float* out_forceZ)
+{
+	float connectionPoints[3][4] = {};
+	float anchors[3][4] = {};
+	float springConstants[4] = {};
+	float restLengths[4] = {};
+
+	for (int lane = 0; lane < numLanes; ++lane)
+	{
+		int index = firstIndex + lane;
+		const Vector3& connectionPointWs = batch.m_connectionPointsWs[index];
+		Vector3 anchorWs = (isAnchored ? Vector3(batch.m_anchorsX[index], batch.m_anchorsY[index], batch.m_anchorsZ[index]) : batch.m_otherBodies[index]->transform->position);
+
+		connectionPoints[0][lane] = connectionPointWs.x;
+		connectionPoints[1][lane] = connectionPointWs.y;
+		connectionPoints[2][lane] = connectionPointWs.z;
+		anchors[0][lane] = anchorWs.x;
+		anchors[1][lane] = anchorWs.y;
+		anchors[2][lane] = anchorWs.z;
+		springConstants[lane] = batch.m_paramsX[index];
+		restLengths[lane] = batch.m_paramsY[index];
+	}
+
+	__m128 dirX = _mm_sub_ps(_mm_loadu_ps(connectionPoints[0]), _mm_loadu_ps(anchors[0]));
+	__m128 dirY = _mm_sub_ps(_mm_loadu_ps(connectionPoints[1]), _mm_loadu_ps(anchors[1]));
+	__m128 dirZ = _mm_sub_ps(_mm_loadu_ps(connectionPoints[2]), _mm_loadu_ps(anchors[2]));
+	__m128 length = _mm_sqrt_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(dirX, dirX), _mm_mul_ps(dirY, dirY)), _mm_mul_ps(dirZ, dirZ)));
+	__m128 hasLength = _mm_cmpgt_ps(length, _mm_setzero_ps());
+
+	// Divide in the masked-off lanes too, the result is thrown away
+	__m128 oneOverLength = _mm_div_ps(_mm_set1_ps(1.f), _mm_or_ps(_mm_and_ps(hasLength, length), _mm_andnot_ps(hasLength, _mm_set1_ps(1.f))));
+	__m128 magnitude = _mm_mul_ps(_mm_sub_ps(length, _mm_loadu_ps(restLengths)), _mm_loadu_ps(springConstants));
+	__m128 scale = _mm_and_ps(hasLength, _mm_sub_ps(_mm_setzero_ps(), _mm_mul_ps(magnitude, oneOverLength)));
+
+	_mm_storeu_ps(out_forceX, _mm_mul_ps(dirX, scale));
+	_mm_storeu_ps(out_forceY, _mm_mul_ps(dirY, scale));
+	_mm_storeu_ps(out_forceZ, _mm_mul_ps(dirZ, scale));
+}
+
 ///--------------------------------------------------------------------------------------------------------------------------------------------------
 /// CLASS IMPLEMENTATIONS
 ///--------------------------------------------------------------------------------------------------------------------------------------------------
 
+//-------------------------------------------------------------------------------------------------
+// Every array gets an entry, whether the type uses it or not, so removal can treat them all the same
+int RigidBodyForceBatch::Add(int id, RigidBody* body)
+{
+	m_ids.push_back(id);
+	m_bodies.push_back(body);
+	m_forceX.push_back(0.f);
+	m_forceY.push_back(0.f);
+	m_forceZ.push_back(0.f);
+	m_paramsX.push_back(0.f);
+	m_paramsY.push_back(0.f);
+	m_paramsZ.push_back(0.f);
+	m_anchorsX.push_back(0.f);
+	m_anchorsY.push_back(0.f);
+	m_anchorsZ.push_back(0.f);
+	m_otherBodies.push_back(nullptr);
+	m_connectionPointsLs.push_back(Vector3::ZERO);
+	m_generators.push_back(nullptr);
+
+	return GetSize() - 1;
+}
+
+
+//-------------------------------------------------------------------------------------------------
+void RigidBodyForceBatch::RemoveAt(int index)
+{
+	SwapRemove(m_ids, index);
+	SwapRemove(m_bodies, index);
+	SwapRemove(m_forceX, index);
+	SwapRemove(m_forceY, index);
+	SwapRemove(m_forceZ, index);
+	SwapRemove(m_paramsX, index);
+	SwapRemove(m_paramsY, index);
+	SwapRemove(m_paramsZ, index);
+	SwapRemove(m_anchorsX, index);
+	SwapRemove(m_anchorsY, index);
+	SwapRemove(m_anchorsZ, index);
+	SwapRemove(m_otherBodies, index);
+	SwapRemove(m_connectionPointsLs, index);
+	SwapRemove(m_generators, index);
+}
+
+
 //-------------------------------------------------------------------------------------------------
 void RigidBodyForceRegistry::GenerateAndAddForces(float deltaSeconds)
 {
-	for (RigidbodyForceRegistration reg : m_registrations)
+	for (int typeIndex = 0; typeIndex < NUM_FORCE_TYPES; ++typeIndex)
 	{
-		reg.generator->GenerateAndAddForce(reg.body, deltaSeconds);
+		RigidBodyForceType type = (RigidBodyForceType)typeIndex;
+
+		if (m_batches[type].GetSize() == 0)
+			continue;
+
+		if (type == FORCE_TYPE_CUSTOM)
+		{
+			RigidBodyForceBatch& batch = m_batches[type];
+			for (int index = 0; index < batch.GetSize(); ++index)
+			{
+				batch.m_generators[index]->GenerateAndAddForce(batch.m_bodies[index], deltaSeconds);
+			}
+		}
+		else
+		{
+			ComputeForces(type, deltaSeconds);
+			AddComputedForces(type);
+		}
 	}
 }
 
 
 //-------------------------------------------------------------------------------------------------
-void RigidBodyForceRegistry::AddRegistration(RigidBody* body, RigidBodyForceGenerator* generator)
+RigidBodyForceHandle RigidBodyForceRegistry::AddRegistration(RigidBody* body, RigidBodyForceGenerator* generator)
+{
+	return generator->AddToRegistry(*this, body);
+}
+
+
+//-------------------------------------------------------------------------------------------------
+RigidBodyForceHandle RigidBodyForceRegistry::AddGravity(RigidBody* body, const Vector3& gravityAcc)
+{
+	int batchIndex;
+	RigidBodyForceHandle handle = AddToBatch(FORCE_TYPE_GRAVITY, body, batchIndex);
+
+	RigidBodyForceBatch& batch = m_batches[FORCE_TYPE_GRAVITY];
+	batch.m_paramsX[batchIndex] = gravityAcc.x;
+	batch.m_paramsY[batchIndex] = gravityAcc.y;
+	batch.m_paramsZ[batchIndex] = gravityAcc.z;
+
+	return handle;
+}
+
+
+//-------------------------------------------------------------------------------------------------
+RigidBodyForceHandle RigidBodyForceRegistry::AddDrag(RigidBody* body, float k1, float k2)
 {
-	m_registrations.push_back(RigidbodyForceRegistration(body, generator));
+	int batchIndex;
+	RigidBodyForceHandle handle = AddToBatch(FORCE_TYPE_DRAG, body, batchIndex);
+
+	RigidBodyForceBatch& batch = m_batches[FORCE_TYPE_DRAG];
+	batch.m_paramsX[batchIndex] = k1;
+	batch.m_paramsY[batchIndex] = k2;
+
+	return handle;
+}
+
+
+//-------------------------------------------------------------------------------------------------
+RigidBodyForceHandle RigidBodyForceRegistry::AddAnchoredSpring(RigidBody* body, const Vector3& connectionPointLs, const Vector3& anchorPositionWs, float springConstant, float restLength)
+{
+	int batchIndex;
+	RigidBodyForceHandle handle = AddToBatch(FORCE_TYPE_ANCHORED_SPRING, body, batchIndex);
+
+	RigidBodyForceBatch& batch = m_batches[FORCE_TYPE_ANCHORED_SPRING];
+	batch.m_paramsX[batchIndex] = springConstant;
+	batch.m_paramsY[batchIndex] = restLength;
+	batch.m_anchorsX[batchIndex] = anchorPositionWs.x;
+	batch.m_anchorsY[batchIndex] = anchorPositionWs.y;
+	batch.m_anchorsZ[batchIndex] = anchorPositionWs.z;
+	batch.m_connectionPointsLs[batchIndex] = connectionPointLs;
+
+	return handle;
+}
+
+
+//-------------------------------------------------------------------------------------------------
+RigidBodyForceHandle RigidBodyForceRegistry::AddSpring(RigidBody* body, const Vector3& connectionPointLs, RigidBody* otherBody, float springConstant, float restLength)
+{
+	int batchIndex;
+	RigidBodyForceHandle handle = AddToBatch(FORCE_TYPE_SPRING, body, batchIndex);
+
+	RigidBodyForceBatch& batch = m_batches[FORCE_TYPE_SPRING];
+	batch.m_paramsX[batchIndex] = springConstant;
+	batch.m_paramsY[batchIndex] = restLength;
+	batch.m_otherBodies[batchIndex] = otherBody;
+	batch.m_connectionPointsLs[batchIndex] = connectionPointLs;
+
+	return handle;
+}
+
+
+//-------------------------------------------------------------------------------------------------
+RigidBodyForceHandle RigidBodyForceRegistry::AddCustom(RigidBody* body, RigidBodyForceGenerator* generator)
+{
+	int batchIndex;
+	RigidBodyForceHandle handle = AddToBatch(FORCE_TYPE_CUSTOM, body, batchIndex);
+	m_batches[FORCE_TYPE_CUSTOM].m_generators[batchIndex] = generator;
+
+	return handle;
+}
+
+
+//-------------------------------------------------------------------------------------------------
+// O(1) - the batch's last registration is moved into the hole
+bool RigidBodyForceRegistry::RemoveRegistration(const RigidBodyForceHandle& handle)
+{
+	if (!handle.IsValid() || handle.m_id >= (int)m_slots.size())
+		return false;
+
+	RegistrationSlot& slot = m_slots[handle.m_id];
+	if (slot.m_type < 0 || slot.m_generation != handle.m_generation)
+		return false;
+
+	RigidBodyForceBatch& batch = m_batches[slot.m_type];
+	int movedId = batch.m_ids.back();
+	batch.RemoveAt(slot.m_batchIndex);
+
+	if (movedId != handle.m_id)
+	{
+		m_slots[movedId].m_batchIndex = slot.m_batchIndex;
+	}
+
+	slot.m_type = -1;
+	slot.m_batchIndex = -1;
+	slot.m_generation++;
+	m_freeIds.push_back(handle.m_id);
+
+	return true;
+}
+
+
+//-------------------------------------------------------------------------------------------------
+RigidBodyForceHandle RigidBodyForceRegistry::AddToBatch(RigidBodyForceType type, RigidBody* body, int& out_batchIndex)
+{
+	int id;
+	if (m_freeIds.size() > 0)
+	{
+		id = m_freeIds.back();
+		m_freeIds.pop_back();
+	}
+	else
+	{
+		id = (int)m_slots.size();
+		m_slots.push_back(RegistrationSlot());
+	}
+
+	out_batchIndex = m_batches[type].Add(id, body);
+
+	RegistrationSlot& slot = m_slots[id];
+	slot.m_type = type;
+	slot.m_batchIndex = out_batchIndex;
+
+	RigidBodyForceHandle handle;
+	handle.m_id = id;
+	handle.m_generation = slot.m_generation;
+
+	return handle;
+}
+
+
+//-------------------------------------------------------------------------------------------------
+// Only writes the batch's force arrays, so ranges can run on any thread
+// Spring connection points go through Transform, which rebuilds its cached matrices on read, so they're done here first
+void RigidBodyForceRegistry::ComputeForces(RigidBodyForceType type, float deltaSeconds)
+{
+	RigidBodyForceBatch& batch = m_batches[type];
+	int batchSize = batch.GetSize();
+
+	if (type == FORCE_TYPE_ANCHORED_SPRING || type == FORCE_TYPE_SPRING)
+	{
+		batch.m_connectionPointsWs.resize(batchSize);
+		for (int index = 0; index < batchSize; ++index)
+		{
+			batch.m_connectionPointsWs[index] = batch.m_bodies[index]->transform->TransformPosition(batch.m_connectionPointsLs[index]);
+		}
+	}
+
+	if (m_useJobSystem && g_jobSystem != nullptr && batchSize >= 2 * MIN_FORCES_PER_JOB)
+	{
+		g_jobSystem->ParallelFor(batchSize, MIN_FORCES_PER_JOB, [this, type, deltaSeconds](int startIndex, int endIndex)
+		{
+			ComputeForcesInRange(type, startIndex, endIndex, deltaSeconds);
+		});
+	}
+	else
+	{
+		ComputeForcesInRange(type, 0, batchSize, deltaSeconds);
+	}
+}
+
+
+//-------------------------------------------------------------------------------------------------
+void RigidBodyForceRegistry::ComputeForcesInRange(RigidBodyForceType type, int startIndex, int endIndex, float deltaSeconds)
+{
+	UNUSED(deltaSeconds);
+	RigidBodyForceBatch& batch = m_batches[type];
+
+	for (int firstIndex = startIndex; firstIndex < endIndex; firstIndex += 4)
+	{
+		int numLanes = Min(4, endIndex - firstIndex);
+		float forces[3][4];
+
+		switch (type)
+		{
+		case FORCE_TYPE_GRAVITY:			ComputeGravityForces(batch, firstIndex, numLanes, forces[0], forces[1], forces[2]); break;
+		case FORCE_TYPE_DRAG:				ComputeDragForces(batch, firstIndex, numLanes, forces[0], forces[1], forces[2]); break;
+		case FORCE_TYPE_ANCHORED_SPRING:	ComputeSpringForces(batch, true, firstIndex, numLanes, forces[0], forces[1], forces[2]); break;
+		case FORCE_TYPE_SPRING:				ComputeSpringForces(batch, false, firstIndex, numLanes, forces[0], forces[1], forces[2]); break;
+		default:
+			ERROR_AND_DIE("Force type isn't batched!");
+			break;
+		}
+
+		for (int lane = 0; lane < numLanes; ++lane)
+		{
+			batch.m_forceX[firstIndex + lane] = forces[0][lane];
+			batch.m_forceY[firstIndex + lane] = forces[1][lane];
+			batch.m_forceZ[firstIndex + lane] = forces[2][lane];
+		}
+	}
+}
+
+
+//-------------------------------------------------------------------------------------------------
+// Single threaded and in batch order, as several registrations can share a body
+void RigidBodyForceRegistry::AddComputedForces(RigidBodyForceType type)
+{
+	RigidBodyForceBatch& batch = m_batches[type];
+	RigidBodyStorage& storage = RigidBodyStorage::Get();
+
+	for (int index = 0; index < batch.GetSize(); ++index)
+	{
+		Vector3 force = Vector3(batch.m_forceX[index], batch.m_forceY[index], batch.m_forceZ[index]);
+		if (force == Vector3::ZERO)
+			continue;
+
+		if (type == FORCE_TYPE_GRAVITY || type == FORCE_TYPE_DRAG)
+		{
+			// Goes straight to the accumulator, so applying them doesn't wake the body
+			storage.m_forceAccumWs.Add(batch.m_bodies[index]->GetStorageIndex(), force);
+		}
+		else
+		{
+			batch.m_bodies[index]->AddWorldForceAtLocalPoint(force, batch.m_connectionPointsLs[index]);
+		}
+	}
 }
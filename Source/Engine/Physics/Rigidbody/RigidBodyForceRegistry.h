@@ -8,6 +8,8 @@
 ///--------------------------------------------------------------------------------------------------------------------------------------------------
 /// INCLUDES
 ///--------------------------------------------------------------------------------------------------------------------------------------------------
+#include "Engine/Core/EngineCommon.h"
+#include "Engine/Math/Vector3.h"
 #include <vector>
 
 ///--------------------------------------------------------------------------------------------------------------------------------------------------
@@ -20,13 +22,53 @@
 class RigidBody;
 class RigidBodyForceGenerator;
 
-struct RigidbodyForceRegistration
+enum RigidBodyForceType
 {
-	RigidbodyForceRegistration(RigidBody* body, RigidBodyForceGenerator* generator)
-		: body(body), generator(generator) {}
+	FORCE_TYPE_GRAVITY,
+	FORCE_TYPE_DRAG,
+	FORCE_TYPE_ANCHORED_SPRING,
+	FORCE_TYPE_SPRING,
+	FORCE_TYPE_CUSTOM,			// Any other RigidBodyForceGenerator, called one registration at a time
+	NUM_FORCE_TYPES
+};
+
+// Identifies one registration, going stale once it's removed
+struct RigidBodyForceHandle
+{
+	int		m_id = -1;
+	uint32	m_generation = 0;
 
-	RigidBody* body = nullptr;
-	RigidBodyForceGenerator* generator = nullptr;
+	bool IsValid() const { return m_id >= 0; }
+};
+
+// Per-type registration data, all arrays parallel and kept dense by swapping the last entry into removed ones
+// Forces are computed into m_forceX/Y/Z, then added to the bodies (at m_connectionPointsLs for springs)
+struct RigidBodyForceBatch
+{
+	std::vector<int>		m_ids; // Back to the registration id, to fix up the moved entry on removal
+	std::vector<RigidBody*>	m_bodies;
+	std::vector<float>		m_forceX;
+	std::vector<float>		m_forceY;
+	std::vector<float>		m_forceZ;
+
+	// Gravity - acceleration; Drag - k1 and k2 in x and y; Springs - spring constant and rest length in x and y
+	std::vector<float>		m_paramsX;
+	std::vector<float>		m_paramsY;
+	std::vector<float>		m_paramsZ;
+
+	// Springs only
+	std::vector<float>		m_anchorsX; // Anchored spring only
+	std::vector<float>		m_anchorsY;
+	std::vector<float>		m_anchorsZ;
+	std::vector<RigidBody*>	m_otherBodies;
+	std::vector<Vector3>	m_connectionPointsLs;
+	std::vector<Vector3>	m_connectionPointsWs; // Filled on the calling thread each step before the forces are computed
+
+	std::vector<RigidBodyForceGenerator*> m_generators; // Custom only
+
+	int		GetSize() const { return (int)m_bodies.size(); }
+	int		Add(int id, RigidBody* body);
+	void	RemoveAt(int index);
 };
 
 ///--------------------------------------------------------------------------------------------------------------------------------------------------
@@ -38,22 +80,61 @@ struct RigidbodyForceRegistration
 ///--------------------------------------------------------------------------------------------------------------------------------------------------
 
 //-------------------------------------------------------------------------------------------------
+// Registrations are grouped by force type, each type computed in one 4-wide pass over its batch
+// Large batches are computed across the JobSystem, then added to the bodies on the calling thread in registration order
 class RigidBodyForceRegistry
 {
 public:
 	//-----Public Methods-----
 
 	void GenerateAndAddForces(float deltaSeconds);
-	void AddRegistration(RigidBody* body, RigidBodyForceGenerator* generator);
+
+	RigidBodyForceHandle AddRegistration(RigidBody* body, RigidBodyForceGenerator* generator); // Built-in generators go in their type's batch
+	RigidBodyForceHandle AddGravity(RigidBody* body, const Vector3& gravityAcc);
+	RigidBodyForceHandle AddDrag(RigidBody* body, float k1, float k2);
+	RigidBodyForceHandle AddAnchoredSpring(RigidBody* body, const Vector3& connectionPointLs, const Vector3& anchorPositionWs, float springConstant, float restLength);
+	RigidBodyForceHandle AddSpring(RigidBody* body, const Vector3& connectionPointLs, RigidBody* otherBody, float springConstant, float restLength);
+	RigidBodyForceHandle AddCustom(RigidBody* body, RigidBodyForceGenerator* generator);
+	bool				 RemoveRegistration(const RigidBodyForceHandle& handle); // Returns false if the handle is stale
+
+	void SetUseJobSystem(bool useJobSystem) { m_useJobSystem = useJobSystem; }
+	int	 GetNumRegistrations(RigidBodyForceType type) const { return m_batches[type].GetSize(); }
+
+
+public:
+	//-----Public Data-----
+
+	static constexpr int MIN_FORCES_PER_JOB = 256;
+
+
+private:
+	//-----Private Methods-----
+
+	RigidBodyForceHandle	AddToBatch(RigidBodyForceType type, RigidBody* body, int& out_batchIndex);
+	void					ComputeForces(RigidBodyForceType type, float deltaSeconds);
+	void					ComputeForcesInRange(RigidBodyForceType type, int startIndex, int endIndex, float deltaSeconds);
+	void					AddComputedForces(RigidBodyForceType type);
 
 
 private:
 	//-----Private Data-----
 
-	std::vector<RigidbodyForceRegistration> m_registrations;
+	// Id -> where the registration currently is
+	struct RegistrationSlot
+	{
+		int		m_type = -1;
+		int		m_batchIndex = -1;
+		uint32	m_generation = 0;
+	};
+
+	RigidBodyForceBatch				m_batches[NUM_FORCE_TYPES];
+	std::vector<RegistrationSlot>	m_slots;
+	std::vector<int>				m_freeIds;
+	bool							m_useJobSystem = true;
 
 };
 
+
 ///--------------------------------------------------------------------------------------------------------------------------------------------------
 /// C FUNCTIONS
 ///--------------------------------------------------------------------------------------------------------------------------------------------------
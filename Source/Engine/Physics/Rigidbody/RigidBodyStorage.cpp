@@ -0,0 +1,124 @@
+///--------------------------------------------------------------------------------------------------------------------------------------------------
+/// Author: Andrew Chase
+/// Date Created: October 18th, 2026
+/// Description:
+///--------------------------------------------------------------------------------------------------------------------------------------------------
+
+///--------------------------------------------------------------------------------------------------------------------------------------------------
+/// INCLUDES
+///--------------------------------------------------------------------------------------------------------------------------------------------------
+#include "Engine/Core/EngineCommon.h"
+#include "Engine/Physics/RigidBody/RigidBodyStorage.h"
+
+///--------------------------------------------------------------------------------------------------------------------------------------------------
+/// DEFINES
+///--------------------------------------------------------------------------------------------------------------------------------------------------
+
+///--------------------------------------------------------------------------------------------------------------------------------------------------
+/// ENUMS, TYPEDEFS, STRUCTS, FORWARD DECLARATIONS
+///--------------------------------------------------------------------------------------------------------------------------------------------------
+
+///--------------------------------------------------------------------------------------------------------------------------------------------------
+/// GLOBALS AND STATICS
+///--------------------------------------------------------------------------------------------------------------------------------------------------
+
+///--------------------------------------------------------------------------------------------------------------------------------------------------
+/// C FUNCTIONS
+///--------------------------------------------------------------------------------------------------------------------------------------------------
+
+///--------------------------------------------------------------------------------------------------------------------------------------------------
+/// CLASS IMPLEMENTATIONS
+///--------------------------------------------------------------------------------------------------------------------------------------------------
+
+//-------------------------------------------------------------------------------------------------
+RigidBodyStorage& RigidBodyStorage::Get()
+{
+	static RigidBodyStorage s_storage;
+	return s_storage;
+}
+
+
+//-------------------------------------------------------------------------------------------------
+// Slots are initialized to the same defaults RigidBody has always had
+int RigidBodyStorage::AllocateSlot(RigidBody* body)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	if (m_freeSlots.size() == 0)
+	{
+		Grow();
+	}
+
+	int slotIndex = m_freeSlots.back();
+	m_freeSlots.pop_back();
+
+	m_velocityWs.Set(slotIndex, Vector3::ZERO);
+	m_angularVelocityRadiansWs.Set(slotIndex, Vector3::ZERO);
+	m_accelerationWs.Set(slotIndex, Vector3::ZERO);
+	m_lastFrameAccelerationWs.Set(slotIndex, Vector3::ZERO);
+	m_forceAccumWs.Set(slotIndex, Vector3::ZERO);
+	m_torqueAccumWs.Set(slotIndex, Vector3::ZERO);
+	m_inverseMass[slotIndex] = 1.f;
+	m_linearDamping[slotIndex] = 0.9f;
+	m_angularDamping[slotIndex] = 0.9f;
+	m_motion[slotIndex] = 0.f;
+	m_gravityScale[slotIndex] = 1.f;
+	m_maxLateralSpeed[slotIndex] = 1000.f;
+	m_maxVerticalSpeed[slotIndex] = 1000.f;
+	m_isAwake[slotIndex] = 1;
+	m_canSleep[slotIndex] = 1;
+	m_affectedByGravity[slotIndex] = 1;
+	m_rotationLocked[slotIndex] = 0;
+	m_bodies[slotIndex] = body;
+	m_owningScenes[slotIndex] = nullptr;
+
+	return slotIndex;
+}
+
+
+//-------------------------------------------------------------------------------------------------
+// Leaves the slot's data alone, integration skips it since it has no body
+void RigidBodyStorage::FreeSlot(int slotIndex)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	ASSERT_OR_DIE(slotIndex >= 0 && slotIndex < m_capacity && m_bodies[slotIndex] != nullptr, "Freeing an invalid rigidbody slot!");
+
+	m_bodies[slotIndex] = nullptr;
+	m_owningScenes[slotIndex] = nullptr;
+	m_freeSlots.push_back(slotIndex);
+}
+
+
+//-------------------------------------------------------------------------------------------------
+// Doubles the capacity, so RigidBodies must not hold pointers into the arrays across creating another body
+void RigidBodyStorage::Grow()
+{
+	int oldCapacity = m_capacity;
+	m_capacity = (m_capacity > 0 ? 2 * m_capacity : 16 * SIMD_WIDTH);
+
+	m_velocityWs.Resize(m_capacity);
+	m_angularVelocityRadiansWs.Resize(m_capacity);
+	m_accelerationWs.Resize(m_capacity);
+	m_lastFrameAccelerationWs.Resize(m_capacity);
+	m_forceAccumWs.Resize(m_capacity);
+	m_torqueAccumWs.Resize(m_capacity);
+	m_inverseMass.resize(m_capacity, 0.f);
+	m_linearDamping.resize(m_capacity, 0.f);
+	m_angularDamping.resize(m_capacity, 0.f);
+	m_motion.resize(m_capacity, 0.f);
+	m_gravityScale.resize(m_capacity, 0.f);
+	m_maxLateralSpeed.resize(m_capacity, 0.f);
+	m_maxVerticalSpeed.resize(m_capacity, 0.f);
+	m_isAwake.resize(m_capacity, 0);
+	m_canSleep.resize(m_capacity, 0);
+	m_affectedByGravity.resize(m_capacity, 0);
+	m_rotationLocked.resize(m_capacity, 0);
+	m_bodies.resize(m_capacity, nullptr);
+	m_owningScenes.resize(m_capacity, nullptr);
+
+	// Pushed backwards so slots are handed out front to back
+	for (int slotIndex = m_capacity - 1; slotIndex >= oldCapacity; --slotIndex)
+	{
+		m_freeSlots.push_back(slotIndex);
+	}
+}
@@ -0,0 +1,98 @@
+///--------------------------------------------------------------------------------------------------------------------------------------------------
+/// Author: Andrew Chase
+/// Date Created: October 18th, 2026
+/// Description: Structure-of-arrays storage for the per-step rigidbody state, so integration can work on several bodies at once
+///--------------------------------------------------------------------------------------------------------------------------------------------------
+#pragma once
+
+///--------------------------------------------------------------------------------------------------------------------------------------------------
+/// INCLUDES
+///--------------------------------------------------------------------------------------------------------------------------------------------------
+#include "Engine/Core/EngineCommon.h"
+#include "Engine/Math/SoAVector3.h"
+#include "Engine/Math/Vector3.h"
+#include <mutex>
+#include <vector>
+
+///--------------------------------------------------------------------------------------------------------------------------------------------------
+/// DEFINES
+///--------------------------------------------------------------------------------------------------------------------------------------------------
+
+///--------------------------------------------------------------------------------------------------------------------------------------------------
+/// ENUMS, TYPEDEFS, STRUCTS, FORWARD DECLARATIONS
+///--------------------------------------------------------------------------------------------------------------------------------------------------
+class PhysicsScene;
+class RigidBody;
+
+///--------------------------------------------------------------------------------------------------------------------------------------------------
+/// GLOBALS AND STATICS
+///--------------------------------------------------------------------------------------------------------------------------------------------------
+
+///--------------------------------------------------------------------------------------------------------------------------------------------------
+/// CLASS DECLARATIONS
+///--------------------------------------------------------------------------------------------------------------------------------------------------
+
+//-------------------------------------------------------------------------------------------------
+// Every RigidBody owns one slot here for its whole life, and reads/writes its hot state through it
+// Capacity is kept a multiple of SIMD_WIDTH so integration never needs a scalar tail
+class RigidBodyStorage
+{
+public:
+	//-----Public Methods-----
+
+	static RigidBodyStorage&	Get();
+
+	int							AllocateSlot(RigidBody* body);
+	void						FreeSlot(int slotIndex);
+	int							GetCapacity() const { return m_capacity; }
+
+
+public:
+	//-----Public Data-----
+
+	static constexpr int SIMD_WIDTH = 4;
+
+	SoAVector3					m_velocityWs;
+	SoAVector3					m_angularVelocityRadiansWs;
+	SoAVector3					m_accelerationWs;
+	SoAVector3					m_lastFrameAccelerationWs;
+	SoAVector3					m_forceAccumWs;
+	SoAVector3					m_torqueAccumWs;
+	std::vector<float>			m_inverseMass;
+	std::vector<float>			m_linearDamping;
+	std::vector<float>			m_angularDamping;
+	std::vector<float>			m_motion;
+	std::vector<float>			m_gravityScale;
+	std::vector<float>			m_maxLateralSpeed;
+	std::vector<float>			m_maxVerticalSpeed;
+	std::vector<uint8>			m_isAwake;
+	std::vector<uint8>			m_canSleep;
+	std::vector<uint8>			m_affectedByGravity;
+	std::vector<uint8>			m_rotationLocked;
+
+	std::vector<RigidBody*>		m_bodies; // nullptr for free slots
+	std::vector<PhysicsScene*>	m_owningScenes; // Scene that integrates the body, if any
+
+
+private:
+	//-----Private Methods-----
+
+	RigidBodyStorage() {}
+	RigidBodyStorage(const RigidBodyStorage& copy) = delete;
+
+	void						Grow();
+
+
+private:
+	//-----Private Data-----
+
+	int							m_capacity = 0;
+	std::vector<int>			m_freeSlots;
+	std::mutex					m_mutex;
+
+};
+
+
+///--------------------------------------------------------------------------------------------------------------------------------------------------
+/// C FUNCTIONS
+///--------------------------------------------------------------------------------------------------------------------------------------------------
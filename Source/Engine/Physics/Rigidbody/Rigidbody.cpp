@@ -24,6 +24,7 @@
 ///--------------------------------------------------------------------------------------------------------------------------------------------------
 /// GLOBALS AND STATICS
 ///--------------------------------------------------------------------------------------------------------------------------------------------------
+uint32 RigidBody::s_staticChangeCount = 0;
 
 ///--------------------------------------------------------------------------------------------------------------------------------------------------
 /// C FUNCTIONS
@@ -37,8 +38,8 @@
 //-------------------------------------------------------------------------------------------------
 void RigidBody::AddWorldForce(const Vector3& forceWs)
 {
-	m_forceAccumWs += forceWs;
-	m_isAwake = true;
+	m_storage->m_forceAccumWs.Add(m_storageIndex, forceWs);
+	m_storage->m_isAwake[m_storageIndex] = 1;
 }
 
 
@@ -54,9 +55,9 @@ void RigidBody::AddLocalForce(const Vector3& forceLs)
 void RigidBody::AddWorldForceAtWorldPoint(const Vector3& forceWs, const Vector3& pointWs)
 {
 	Vector3 centerToPoint = pointWs - transform->position;
-	m_forceAccumWs += forceWs;
-	m_torqueAccumWs += CrossProduct(centerToPoint, forceWs);
-	m_isAwake = true;
+	m_storage->m_forceAccumWs.Add(m_storageIndex, forceWs);
+	m_storage->m_torqueAccumWs.Add(m_storageIndex, CrossProduct(centerToPoint, forceWs));
+	m_storage->m_isAwake[m_storageIndex] = 1;
 }
 
 
@@ -88,7 +89,7 @@ void RigidBody::AddLocalForceAtWorldPoint(const Vector3& forceLs, const Vector3&
 //-------------------------------------------------------------------------------------------------
 void RigidBody::SetInertiaTensor_Capsule(float h, float r)
 {
-	if (m_iMass == 0.f)
+	if (GetInverseMass() == 0.f)
 	{
 		ConsoleWarningf("Attempting to set the inertia tensor of an immovable object to that of a capsule. Ignoring...");
 		return;
@@ -98,7 +99,7 @@ void RigidBody::SetInertiaTensor_Capsule(float h, float r)
 	float vhs = (2.f / 3.f) * (r * r * r) * PI; // Hemisphere
 	float volume = vcyl + 2.f * vhs; // 2 half spheres, on top and bottom of cylinder
 
-	float mass = (1.f / m_iMass);
+	float mass = (1.f / GetInverseMass());
 	float density = (mass / volume);
 
 	float mcyl = vcyl * density; // Cylinder mass
@@ -116,13 +117,13 @@ void RigidBody::SetInertiaTensor_Capsule(float h, float r)
 //-------------------------------------------------------------------------------------------------
 void RigidBody::SetInertiaTensor_Cylinder(float h, float r)
 {
-	if (m_iMass == 0.f)
+	if (GetInverseMass() == 0.f)
 	{
 		ConsoleWarningf("Attempting to set the inertia tensor of an immovable object to that of a cylinder. Ignoring...");
 		return;
 	}
 
-	float mass = (1.f / m_iMass);
+	float mass = (1.f / GetInverseMass());
 
 	Matrix3 inertiaTensor = Matrix3::IDENTITY;
 	inertiaTensor.Ix = (1.f / 12.f) * mass * (3 * (r * r) + (h * h));
@@ -136,13 +137,13 @@ void RigidBody::SetInertiaTensor_Cylinder(float h, float r)
 //-------------------------------------------------------------------------------------------------
 void RigidBody::SetInertiaTensor_Box(const Vector3& extents)
 {
-	if (m_iMass == 0.f)
+	if (GetInverseMass() == 0.f)
 	{
 		ConsoleWarningf("Attempting to set the inertia tensor of an immovable object to that of a box. Ignoring...");
 		return;
 	}
 
-	float mass = (1.f / m_iMass);
+	float mass = (1.f / GetInverseMass());
 	float w = 2.f * extents.x;
 	float h = 2.f * extents.y;
 	float l = 2.f * extents.z;
@@ -159,13 +160,13 @@ void RigidBody::SetInertiaTensor_Box(const Vector3& extents)
 //-------------------------------------------------------------------------------------------------
 void RigidBody::SetInertiaTensor_Sphere(float radius)
 {
-	if (m_iMass == 0.f)
+	if (GetInverseMass() == 0.f)
 	{
 		ConsoleWarningf("Attempting to set the inertia tensor of an immovable object to that of a sphere. Ignoring...");
 		return;
 	}
 
-	float mass = (1.f / m_iMass);
+	float mass = (1.f / GetInverseMass());
 	float moment = (2.f / 5.f) * mass * (radius * radius);
 
 	Matrix3 inertiaTensor = Matrix3::IDENTITY;
@@ -180,13 +181,13 @@ void RigidBody::SetInertiaTensor_Sphere(float radius)
 //-------------------------------------------------------------------------------------------------
 void RigidBody::SetInertiaTensor_Polygon(const Polyhedron& polyLs)
 {
-	if (m_iMass == 0.f)
+	if (GetInverseMass() == 0.f)
 	{
 		ConsoleWarningf("Attempting to set the inertia tensor of an immovable object to that of a polygon. Ignoring...");
 		return;
 	}
 
-	double mass = 1.0 / static_cast<double>(m_iMass);
+	double mass = 1.0 / static_cast<double>(GetInverseMass());
 
 	Matrix3 inertiaTensor;
 	Vector3 centerOfMass = ComputeCenterOfMassAndInteriaTensor(polyLs, inertiaTensor, mass);
@@ -213,10 +214,16 @@ void RigidBody::SetAngularVelocityDegreesWs(const Vector3& angularVelocityDegree
 //-------------------------------------------------------------------------------------------------
 void RigidBody::SetInverseMass(float iMass)
 {
-	m_iMass = iMass;
+	bool wasStatic = IsStatic();
+	m_storage->m_inverseMass[m_storageIndex] = iMass;
+
+	if (IsStatic() != wasStatic)
+	{
+		s_staticChangeCount++;
+	}
 
 	// Ensure we can't rotate
-	if (m_iMass <= 0.f)
+	if (iMass <= 0.f)
 	{
 		m_inverseInertiaTensorLocal = Matrix3::ZERO;
 		m_inverseInertiaTensorWorld = Matrix3::ZERO;
@@ -227,17 +234,17 @@ void RigidBody::SetInverseMass(float iMass)
 //-------------------------------------------------------------------------------------------------
 void RigidBody::SetIsAwake(bool isAwake)
 {
-	m_isAwake = isAwake;
+	m_storage->m_isAwake[m_storageIndex] = (isAwake ? 1 : 0);
 
-	if (m_isAwake)
+	if (isAwake)
 	{
-		m_motion += 2.f * SLEEP_EPSILON; // Add motion now to prevent it from immediately falling asleep
+		m_storage->m_motion[m_storageIndex] += 2.f * SLEEP_EPSILON; // Add motion now to prevent it from immediately falling asleep
 	}
 	else
 	{
 		// Clear so when we wake up again we start from no movement
-		m_velocityWs = Vector3::ZERO;
-		m_angularVelocityRadiansWs = Vector3::ZERO;
+		m_storage->m_velocityWs.Set(m_storageIndex, Vector3::ZERO);
+		m_storage->m_angularVelocityRadiansWs.Set(m_storageIndex, Vector3::ZERO);
 	}
 }
 
@@ -245,10 +252,10 @@ void RigidBody::SetIsAwake(bool isAwake)
 //-------------------------------------------------------------------------------------------------
 void RigidBody::SetCanSleep(bool canSleep)
 {
-	m_canSleep = canSleep;
+	m_storage->m_canSleep[m_storageIndex] = (canSleep ? 1 : 0);
 
 	// Wake me up if I'm asleep and am not allowed to be
-	if (!m_canSleep && !m_isAwake)
+	if (!canSleep && !IsAwake())
 	{
 		SetIsAwake(true);
 	}
@@ -258,7 +265,42 @@ void RigidBody::SetCanSleep(bool canSleep)
 //-------------------------------------------------------------------------------------------------
 void RigidBody::SetRotationLocked(bool lockRotation)
 {
-	m_rotationLocked = lockRotation;
+	m_storage->m_rotationLocked[m_storageIndex] = (lockRotation ? 1 : 0);
+}
+
+
+//-------------------------------------------------------------------------------------------------
+void RigidBody::SaveState(RigidBodyState& out_state) const
+{
+	out_state.m_position = transform->position;
+	out_state.m_rotation = transform->rotation;
+	out_state.m_velocityWs = m_storage->m_velocityWs.Get(m_storageIndex);
+	out_state.m_accelerationWs = m_storage->m_accelerationWs.Get(m_storageIndex);
+	out_state.m_lastFrameAccelerationWs = m_storage->m_lastFrameAccelerationWs.Get(m_storageIndex);
+	out_state.m_angularVelocityRadiansWs = m_storage->m_angularVelocityRadiansWs.Get(m_storageIndex);
+	out_state.m_forceAccumWs = m_storage->m_forceAccumWs.Get(m_storageIndex);
+	out_state.m_torqueAccumWs = m_storage->m_torqueAccumWs.Get(m_storageIndex);
+	out_state.m_inverseInertiaTensorWorld = m_inverseInertiaTensorWorld;
+	out_state.m_motion = m_storage->m_motion[m_storageIndex];
+	out_state.m_isAwake = IsAwake();
+}
+
+
+//-------------------------------------------------------------------------------------------------
+// Sets everything directly instead of going through the setters, which have side effects (waking adds motion, etc.)
+void RigidBody::RestoreState(const RigidBodyState& state)
+{
+	transform->position = state.m_position;
+	transform->rotation = state.m_rotation;
+	m_storage->m_velocityWs.Set(m_storageIndex, state.m_velocityWs);
+	m_storage->m_accelerationWs.Set(m_storageIndex, state.m_accelerationWs);
+	m_storage->m_lastFrameAccelerationWs.Set(m_storageIndex, state.m_lastFrameAccelerationWs);
+	m_storage->m_angularVelocityRadiansWs.Set(m_storageIndex, state.m_angularVelocityRadiansWs);
+	m_storage->m_forceAccumWs.Set(m_storageIndex, state.m_forceAccumWs);
+	m_storage->m_torqueAccumWs.Set(m_storageIndex, state.m_torqueAccumWs);
+	m_inverseInertiaTensorWorld = state.m_inverseInertiaTensorWorld;
+	m_storage->m_motion[m_storageIndex] = state.m_motion;
+	m_storage->m_isAwake[m_storageIndex] = (state.m_isAwake ? 1 : 0);
 }
 
 
@@ -279,14 +321,26 @@ void RigidBody::GetWorldInverseInertiaTensor(Matrix3& out_inverseInertiaTensor)
 //-------------------------------------------------------------------------------------------------
 RigidBody::RigidBody(Transform* transform)
 	: transform(transform)
+	, m_storage(&RigidBodyStorage::Get())
 {
+	m_storageIndex = m_storage->AllocateSlot(this);
+	m_storage->m_motion[m_storageIndex] = 2.f * SLEEP_EPSILON;
 }
 
 
 //-------------------------------------------------------------------------------------------------
+RigidBody::~RigidBody()
+{
+	m_storage->FreeSlot(m_storageIndex);
+}
+
+
+//-------------------------------------------------------------------------------------------------
+// Single body version, PhysicsScene integrates its bodies 4 at a time directly on the storage
+// Any change here needs to be mirrored there (and vice versa) to keep the two bit-identical
 void RigidBody::Integrate(float deltaSeconds, const Vector3& gravityAcc)
 {
-	if (!m_isAwake || IsStatic())
+	if (!IsAwake() || IsStatic())
 		return;
 
 	// Corrections after last frame's integrate (as well as any rotations applied during the game frame)
@@ -294,78 +348,97 @@ void RigidBody::Integrate(float deltaSeconds, const Vector3& gravityAcc)
 	CalculateDerivedData();
 
 	// Calculate/apply linear acceleration
-	Vector3 acceleration = m_accelerationWs + gravityAcc;
-	acceleration += (m_forceAccumWs * m_iMass);
-	m_velocityWs += acceleration * deltaSeconds;
+	Vector3 acceleration = m_storage->m_accelerationWs.Get(m_storageIndex) + gravityAcc;
+	acceleration += (m_storage->m_forceAccumWs.Get(m_storageIndex) * GetInverseMass());
+
+	Vector3 velocityWs = GetVelocityWs();
+	velocityWs += acceleration * deltaSeconds;
 
 	// Impose linear damping
-	m_velocityWs *= Pow(m_linearDamping, deltaSeconds);
+	velocityWs *= Pow(m_storage->m_linearDamping[m_storageIndex], deltaSeconds);
 
 	// Clamp to speed limits
-	Vector3 lateralVelocity = Vector3(m_velocityWs.x, 0.f, m_velocityWs.z);
-	if (lateralVelocity.GetLengthSquared() > m_maxLateralSpeed * m_maxLateralSpeed)
+	float maxLateralSpeed = m_storage->m_maxLateralSpeed[m_storageIndex];
+	float maxVerticalSpeed = m_storage->m_maxVerticalSpeed[m_storageIndex];
+
+	Vector3 lateralVelocity = Vector3(velocityWs.x, 0.f, velocityWs.z);
+	if (lateralVelocity.GetLengthSquared() > maxLateralSpeed * maxLateralSpeed)
 	{
 		lateralVelocity.Normalize();
-		lateralVelocity *= m_maxLateralSpeed;
-		m_velocityWs.x = lateralVelocity.x;
-		m_velocityWs.z = lateralVelocity.z;
+		lateralVelocity *= maxLateralSpeed;
+		velocityWs.x = lateralVelocity.x;
+		velocityWs.z = lateralVelocity.z;
 	}
 
-	if (Abs(m_velocityWs.y) > m_maxVerticalSpeed)
+	if (Abs(velocityWs.y) > maxVerticalSpeed)
 	{
-		m_velocityWs.y = (m_velocityWs.y > 0.f ? m_maxVerticalSpeed : -m_maxVerticalSpeed);
+		velocityWs.y = (velocityWs.y > 0.f ? maxVerticalSpeed : -maxVerticalSpeed);
 	}
 
-	transform->position += m_velocityWs * deltaSeconds;
+	SetVelocityWs(velocityWs);
+	transform->position += velocityWs * deltaSeconds;
 
-	// Calculate/apply angular acceleration
-	if (!m_rotationLocked)
-	{
-		Vector3 angularAcceleration = m_inverseInertiaTensorWorld * m_torqueAccumWs;
-		m_angularVelocityRadiansWs += angularAcceleration * deltaSeconds;
-		m_angularVelocityRadiansWs *= Pow(m_angularDamping, deltaSeconds);
-
-		Quaternion deltaRotation = Quaternion::CreateFromEulerAnglesRadians(m_angularVelocityRadiansWs * deltaSeconds);
-
-		transform->Translate(m_centerOfMassLs, RELATIVE_TO_SELF);
-		transform->Rotate(deltaRotation, RELATIVE_TO_WORLD); // Forces/torques are world space, so velocity/angular velocity is ws....so this is a rotation about the world axes
-		transform->Translate(-1.0f * m_centerOfMassLs, RELATIVE_TO_SELF);
-	}
-	else
-	{
-		// Clear this to prevent accumulation
-		m_angularVelocityRadiansWs = Vector3::ZERO;
-	}
+	IntegrateAngular(deltaSeconds);
 
 	// Remember what our acceleration was last frame
-	m_lastFrameAccelerationWs = acceleration;
+	m_storage->m_lastFrameAccelerationWs.Set(m_storageIndex, acceleration);
 
 	CalculateDerivedData();
 	ClearForces();
 
 	// Update the kinetic energy store, and possibly put the body to sleep.
-	if (m_canSleep) 
+	if (CanSleep()) 
 	{
-		float currentMotion = DotProduct(m_velocityWs, m_velocityWs) + DotProduct(m_angularVelocityRadiansWs, m_angularVelocityRadiansWs);
+		Vector3 angularVelocityRadiansWs = GetAngularVelocityRadiansWs();
+		float currentMotion = DotProduct(velocityWs, velocityWs) + DotProduct(angularVelocityRadiansWs, angularVelocityRadiansWs);
 
 		// Do a recency weighted average - this way quickly moving objects that suddenly stop won't sleep immediately
+		float& motion = m_storage->m_motion[m_storageIndex];
 		float bias = Pow(0.1f, deltaSeconds);
-		m_motion = bias * m_motion + (1.f - bias) * currentMotion;
+		motion = bias * motion + (1.f - bias) * currentMotion;
 
-		if (m_motion < SLEEP_EPSILON)
+		if (motion < SLEEP_EPSILON)
 		{
 			SetIsAwake(false);
 		}
-		else if (m_motion > 10.f * SLEEP_EPSILON)
+		else if (motion > 10.f * SLEEP_EPSILON)
 		{
 			// Keep motion from growing too much
 			// Since we're using RWA, a sudden burst of speed will make this skyrocket and take a while to come back down if it suddenly stops
-			m_motion = 10.f * SLEEP_EPSILON;
+			motion = 10.f * SLEEP_EPSILON;
 		}
 	}
 }
 
 
+//-------------------------------------------------------------------------------------------------
+// Shared by both integration paths, the rotation update doesn't vectorize well across bodies
+void RigidBody::IntegrateAngular(float deltaSeconds)
+{
+	// Calculate/apply angular acceleration
+	if (!IsRotationLocked())
+	{
+		Vector3 angularAcceleration = m_inverseInertiaTensorWorld * m_storage->m_torqueAccumWs.Get(m_storageIndex);
+
+		Vector3 angularVelocityRadiansWs = GetAngularVelocityRadiansWs();
+		angularVelocityRadiansWs += angularAcceleration * deltaSeconds;
+		angularVelocityRadiansWs *= Pow(m_storage->m_angularDamping[m_storageIndex], deltaSeconds);
+		SetAngularVelocityRadiansWs(angularVelocityRadiansWs);
+
+		Quaternion deltaRotation = Quaternion::CreateFromEulerAnglesRadians(angularVelocityRadiansWs * deltaSeconds);
+
+		transform->Translate(m_centerOfMassLs, RELATIVE_TO_SELF);
+		transform->Rotate(deltaRotation, RELATIVE_TO_WORLD); // Forces/torques are world space, so velocity/angular velocity is ws....so this is a rotation about the world axes
+		transform->Translate(-1.0f * m_centerOfMassLs, RELATIVE_TO_SELF);
+	}
+	else
+	{
+		// Clear this to prevent accumulation
+		SetAngularVelocityRadiansWs(Vector3::ZERO);
+	}
+}
+
+
 //-------------------------------------------------------------------------------------------------
 void RigidBody::CalculateDerivedData()
 {
@@ -385,6 +458,6 @@ void RigidBody::CalculateDerivedData()
 //-------------------------------------------------------------------------------------------------
 void RigidBody::ClearForces()
 {
-	m_forceAccumWs = Vector3::ZERO;
-	m_torqueAccumWs = Vector3::ZERO;
+	m_storage->m_forceAccumWs.Set(m_storageIndex, Vector3::ZERO);
+	m_storage->m_torqueAccumWs.Set(m_storageIndex, Vector3::ZERO);
 }
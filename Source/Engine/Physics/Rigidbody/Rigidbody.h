@@ -10,6 +10,7 @@
 ///--------------------------------------------------------------------------------------------------------------------------------------------------
 #include "Engine/Math/Matrix3.h"
 #include "Engine/Math/Transform.h"
+#include "Engine/Physics/RigidBody/RigidBodyStorage.h"
 
 ///--------------------------------------------------------------------------------------------------------------------------------------------------
 /// DEFINES
@@ -20,6 +21,23 @@
 ///--------------------------------------------------------------------------------------------------------------------------------------------------
 class Polyhedron;
 
+// Everything about a body that changes while simulating, plain data so it can be copied around freely
+// Properties that are only set by game code (mass, damping, etc.) aren't included
+struct RigidBodyState
+{
+	Vector3		m_position;
+	Quaternion	m_rotation;
+	Vector3		m_velocityWs;
+	Vector3		m_accelerationWs;
+	Vector3		m_lastFrameAccelerationWs;
+	Vector3		m_angularVelocityRadiansWs;
+	Vector3		m_forceAccumWs;
+	Vector3		m_torqueAccumWs;
+	Matrix3		m_inverseInertiaTensorWorld;
+	float		m_motion;
+	bool		m_isAwake;
+};
+
 ///--------------------------------------------------------------------------------------------------------------------------------------------------
 /// GLOBALS AND STATICS
 ///--------------------------------------------------------------------------------------------------------------------------------------------------
@@ -29,6 +47,7 @@ class Polyhedron;
 ///--------------------------------------------------------------------------------------------------------------------------------------------------
 
 //-------------------------------------------------------------------------------------------------
+// The per-step state lives in RigidBodyStorage, this is a view onto the body's slot plus the data integration doesn't touch per body
 class RigidBody
 {
 	friend class PhysicsScene;
@@ -37,6 +56,8 @@ public:
 	//-----Public Methods-----
 
 	RigidBody(Transform* transform);
+	~RigidBody();
+	RigidBody(const RigidBody& copy) = delete;
 
 	void CalculateDerivedData();
 	void Integrate(float deltaSeconds, const Vector3& gravityAcc);
@@ -47,8 +68,8 @@ public:
 	void AddWorldForceAtLocalPoint(const Vector3& forceWs, const Vector3& pointLs);
 	void AddLocalForceAtLocalPoint(const Vector3& forceLs, const Vector3& pointLs);
 	void AddLocalForceAtWorldPoint(const Vector3& forceLs, const Vector3& pointWs);
-	void AddWorldVelocity(const Vector3& velocity) { m_velocityWs += velocity; }
-	void AddWorldAngularVelocityRadians(const Vector3& angularVelocityRadians) { m_angularVelocityRadiansWs += angularVelocityRadians; }
+	void AddWorldVelocity(const Vector3& velocity) { m_storage->m_velocityWs.Add(m_storageIndex, velocity); }
+	void AddWorldAngularVelocityRadians(const Vector3& angularVelocityRadians) { m_storage->m_angularVelocityRadiansWs.Add(m_storageIndex, angularVelocityRadians); }
 
 	void SetInertiaTensor_Capsule(float cylinderHeight, float radius);
 	void SetInertiaTensor_Cylinder(float height, float radius);
@@ -57,34 +78,40 @@ public:
 	void SetInertiaTensor_Polygon(const Polyhedron& polyLs);
 	void SetInverseInertiaTensor(const Matrix3& inverseInertiaTensor, const Vector3& centerOfMassLs);
 
-	void SetVelocityWs(const Vector3& velocityWs) { m_velocityWs = velocityWs; }
-	void SetAngularVelocityRadiansWs(const Vector3& angularVelocityRadiansWs) { m_angularVelocityRadiansWs = angularVelocityRadiansWs; }
+	void SetVelocityWs(const Vector3& velocityWs) { m_storage->m_velocityWs.Set(m_storageIndex, velocityWs); }
+	void SetAngularVelocityRadiansWs(const Vector3& angularVelocityRadiansWs) { m_storage->m_angularVelocityRadiansWs.Set(m_storageIndex, angularVelocityRadiansWs); }
 	void SetAngularVelocityDegreesWs(const Vector3& angularVelocityDegreesWs);
-	void SetAcceleration(const Vector3& acceleration) { m_accelerationWs = acceleration; }
+	void SetAcceleration(const Vector3& acceleration) { m_storage->m_accelerationWs.Set(m_storageIndex, acceleration); }
 	void SetInverseMass(float iMass);
-	void SetLinearDamping(float linearDamping) { m_linearDamping = linearDamping; }
-	void SetAngularDamping(float angularDamping) { m_angularDamping = angularDamping; }
+	void SetLinearDamping(float linearDamping) { m_storage->m_linearDamping[m_storageIndex] = linearDamping; }
+	void SetAngularDamping(float angularDamping) { m_storage->m_angularDamping[m_storageIndex] = angularDamping; }
 	void SetIsAwake(bool isAwake);
 	void SetCanSleep(bool canSleep);
-	void SetAffectedByGravity(bool affectedByGravity) { m_affectedByGravity = affectedByGravity; }
-	void SetGravityScale(float scale) { m_gravityScale = scale; }
+	void SetAffectedByGravity(bool affectedByGravity) { m_storage->m_affectedByGravity[m_storageIndex] = (affectedByGravity ? 1 : 0); }
+	void SetGravityScale(float scale) { m_storage->m_gravityScale[m_storageIndex] = scale; }
 	void SetRotationLocked(bool lockRotation);
-	void SetMaxLateralSpeed(float maxLateralSpeed) { m_maxLateralSpeed = maxLateralSpeed; }
-	void SetMaxVerticalSpeed(float maxVerticalSpeed) { m_maxVerticalSpeed = maxVerticalSpeed; }
+	void SetMaxLateralSpeed(float maxLateralSpeed) { m_storage->m_maxLateralSpeed[m_storageIndex] = maxLateralSpeed; }
+	void SetMaxVerticalSpeed(float maxVerticalSpeed) { m_storage->m_maxVerticalSpeed[m_storageIndex] = maxVerticalSpeed; }
+
+	void SaveState(RigidBodyState& out_state) const;
+	void RestoreState(const RigidBodyState& state);
 
 	Vector3 GetCenterOfMassLs() const { return m_centerOfMassLs; }
 	Vector3	GetCenterOfMassWs() const;
-	Vector3 GetLastFrameAcceleration() const { return m_lastFrameAccelerationWs; }
-	float	GetInverseMass() const { return m_iMass; }
+	Vector3 GetLastFrameAcceleration() const { return m_storage->m_lastFrameAccelerationWs.Get(m_storageIndex); }
+	float	GetInverseMass() const { return m_storage->m_inverseMass[m_storageIndex]; }
 	void	GetWorldInverseInertiaTensor(Matrix3& out_inverseInertiaTensor) const;
-	Vector3 GetVelocityWs() const { return m_velocityWs; }
-	Vector3	GetAngularVelocityRadiansWs() const { return m_angularVelocityRadiansWs; }
-	float	GetGravityScale() const { return m_gravityScale; }
-	bool	IsAwake() const { return m_isAwake; }
-	bool	CanSleep() const { return m_canSleep; }
-	bool	IsAffectedByGravity() const { return m_affectedByGravity; }
-	bool	IsRotationLocked() const { return m_rotationLocked; }
-	bool	IsStatic() const { return m_iMass <= 0.f; }
+	Vector3 GetVelocityWs() const { return m_storage->m_velocityWs.Get(m_storageIndex); }
+	Vector3	GetAngularVelocityRadiansWs() const { return m_storage->m_angularVelocityRadiansWs.Get(m_storageIndex); }
+	float	GetGravityScale() const { return m_storage->m_gravityScale[m_storageIndex]; }
+	bool	IsAwake() const { return m_storage->m_isAwake[m_storageIndex] != 0; }
+	bool	CanSleep() const { return m_storage->m_canSleep[m_storageIndex] != 0; }
+	bool	IsAffectedByGravity() const { return m_storage->m_affectedByGravity[m_storageIndex] != 0; }
+	bool	IsRotationLocked() const { return m_storage->m_rotationLocked[m_storageIndex] != 0; }
+	bool	IsStatic() const { return m_storage->m_inverseMass[m_storageIndex] <= 0.f; }
+	int		GetStorageIndex() const { return m_storageIndex; }
+
+	static uint32 GetStaticChangeCount() { return s_staticChangeCount; }
 
 
 public:
@@ -97,38 +124,24 @@ private:
 	//-----Private Methods-----
 
 	void ClearForces();
+	void IntegrateAngular(float deltaSeconds);
 
 
 private:
 	//-----Private Static Data-----
 
 	static constexpr float SLEEP_EPSILON = 0.1f;
+	static uint32 s_staticChangeCount; // Bumped whenever a body becomes static or stops being static, so collision scenes only reclassify after one does
 
 
 private:
 	//-----Private Data-----
 
-	Vector3		m_centerOfMassLs = Vector3::ZERO;
-	Vector3		m_velocityWs = Vector3::ZERO;
-	Vector3		m_accelerationWs = Vector3::ZERO;
-	Vector3		m_lastFrameAccelerationWs = Vector3::ZERO;
-	Vector3		m_angularVelocityRadiansWs = Vector3::ZERO;
-	Vector3		m_forceAccumWs = Vector3::ZERO;
-	Vector3		m_torqueAccumWs = Vector3::ZERO;
-	float		m_iMass = 1.f;
-	float		m_linearDamping = 0.9f;
-	float		m_angularDamping = 0.9f;
-	Matrix3		m_inverseInertiaTensorLocal;
-	Matrix3		m_inverseInertiaTensorWorld;
-	bool		m_isAwake = true;
-	bool		m_canSleep = true;
-	float		m_motion = 2.f * SLEEP_EPSILON;
-
-	bool		m_affectedByGravity = true;
-	float		m_gravityScale = 1.0f;
-	bool		m_rotationLocked = false;
-	float		m_maxLateralSpeed = 1000.f;
-	float		m_maxVerticalSpeed = 1000.f;
+	RigidBodyStorage*	m_storage = nullptr;
+	int					m_storageIndex = -1;
+	Vector3				m_centerOfMassLs = Vector3::ZERO;
+	Matrix3				m_inverseInertiaTensorLocal;
+	Matrix3				m_inverseInertiaTensorWorld;
 };
 
 ///--------------------------------------------------------------------------------------------------------------------------------------------------
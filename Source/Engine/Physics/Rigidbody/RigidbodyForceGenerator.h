@@ -8,6 +8,7 @@
 ///--------------------------------------------------------------------------------------------------------------------------------------------------
 /// INCLUDES
 ///--------------------------------------------------------------------------------------------------------------------------------------------------
+#include "Engine/Physics/RigidBody/RigidBodyForceRegistry.h"
 
 ///--------------------------------------------------------------------------------------------------------------------------------------------------
 /// DEFINES
@@ -34,6 +35,9 @@ public:
 
 	virtual void GenerateAndAddForce(RigidBody* body, float deltaSeconds) const = 0;
 
+	// Generators the registry has a batched type for override this to register as that type instead
+	virtual RigidBodyForceHandle AddToRegistry(RigidBodyForceRegistry& registry, RigidBody* body) { return registry.AddCustom(body, this); }
+
 
 private:
 	//-----Private Data-----
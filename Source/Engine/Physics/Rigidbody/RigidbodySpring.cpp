@@ -61,3 +61,10 @@ void RigidBodySpring::GenerateAndAddForce(RigidBody* body, float deltaSeconds) c
 		body->AddWorldForceAtLocalPoint(forceDir * -magnitude, m_connectionPointLs);
 	}
 }
+
+
+//-------------------------------------------------------------------------------------------------
+RigidBodyForceHandle RigidBodySpring::AddToRegistry(RigidBodyForceRegistry& registry, RigidBody* body)
+{
+	return registry.AddSpring(body, m_connectionPointLs, m_otherBody, m_springConstant, m_restLength);
+}
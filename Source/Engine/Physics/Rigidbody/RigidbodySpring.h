@@ -35,6 +35,7 @@ public:
 
 	RigidBodySpring(const Vector3& connectionPointLs, RigidBody* otherBody, const Vector3& otherConnectionPointLs, float springConstant, float restLength);
 	virtual void GenerateAndAddForce(RigidBody* body, float deltaSeconds) const override;
+	virtual RigidBodyForceHandle AddToRegistry(RigidBodyForceRegistry& registry, RigidBody* body) override;
 
 
 private:
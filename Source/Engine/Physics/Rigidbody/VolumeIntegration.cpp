@@ -267,14 +267,12 @@ static void ConvertEnginePolyToThirdPartyPoly(const Polyhedron& enginePoly, POLY
 	for (int i = 0; i < tpPoly.numFaces; ++i)
 	{
 		FACE* tpFace = &tpPoly.faces[i];
-		const PolyhedronFace* engineFace = enginePoly.GetFace(i);
-
-		tpFace->numVerts = static_cast<int>(engineFace->m_indices.size());
+		tpFace->numVerts = enginePoly.GetNumVerticesInFace(i);
 		ASSERT_OR_DIE(tpFace->numVerts <= MAX_POLYGON_SZ, "Too many vertices in face!");
 
 		for (int j = 0; j < tpFace->numVerts; ++j)
 		{
-			tpFace->verts[j] = engineFace->m_indices[j];
+			tpFace->verts[j] = enginePoly.GetFaceVertexIndex(i, j);
 		}
 
 		Plane3 facePlane = enginePoly.GetFaceSupportPlane(i);
@@ -1118,13 +1118,12 @@ void MeshBuilder::PushPolyhedron(const Polyhedron& poly, const Rgba& color /*= R
 
 	for (int iFace = 0; iFace < numFaces; ++iFace)
 	{
-		const PolyhedronFace* face = poly.GetFace(iFace);
-		int numVertsInFace = (int)face->m_indices.size();
+		int numVertsInFace = poly.GetNumVerticesInFace(iFace);
 		int vertOffset = (int)m_vertices.size();
 
 		for (int iVertex = 0; iVertex < numVertsInFace; ++iVertex)
 		{
-			PushVertex(poly.GetVertexPosition(face->m_indices[iVertex]));
+			PushVertex(poly.GetVertexPosition(poly.GetFaceVertexIndex(iFace, iVertex)));
 		}
 
 		// Push indices to triangulate - make triangles using the first vertex and a set of edge vertices
@@ -97,8 +97,12 @@ public:
 	void		PushDisc(const Vector3& center, float radius, const Vector3& normal, const Vector3& tangent, const Rgba& color = Rgba::WHITE, int numUSteps = 10, float startV = 0.f, float endV = (1.f / 3.f));
 	void		PushCylinder(const Vector3& bottom, const Vector3& top, float radius, const Rgba& color = Rgba::WHITE, int numUSteps = 10);
 
-	uint32		GetVertexCount() const { return (uint32)m_vertices.size(); }
-	uint32		GetIndexCount() const { return (uint32)m_indices.size(); }
+	uint32					GetVertexCount() const { return (uint32)m_vertices.size(); }
+	uint32					GetIndexCount() const { return (uint32)m_indices.size(); }
+	const VertexMaster&		GetVertex(uint32 vertexIndex) const { return m_vertices[vertexIndex]; }
+	uint32					GetIndex(uint32 indexIndex) const { return m_indices[indexIndex]; }
+	const DrawInstruction&	GetDrawInstruction() const { return m_instruction; }
+	bool					IsBuilding() const { return m_isBuilding; }
 
 	//-------------------------------------------------------------------------------------------------
 	template <typename VERT_TYPE>
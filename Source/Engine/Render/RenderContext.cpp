@@ -581,16 +581,14 @@ void RenderContext::DrawWirePolygon3D(const Polyhedron& polygon, const Rgba& col
 
 	for (int faceIndex = 0; faceIndex < numFaces; ++faceIndex)
 	{
-		const PolyhedronFace* face = polygon.GetFace(faceIndex);
-
-		int numVertsInFace = (int)face->m_indices.size();
+		int numVertsInFace = polygon.GetNumVerticesInFace(faceIndex);
 
 		for (int faceVertexIndex = 0; faceVertexIndex < numVertsInFace; ++faceVertexIndex)
 		{
 			int nextVertexIndex = (faceVertexIndex + 1) % numVertsInFace;
 
-			Vector3 pos1 = polygon.GetVertexPosition(face->m_indices[faceVertexIndex]);
-			Vector3 pos2 = polygon.GetVertexPosition(face->m_indices[nextVertexIndex]);
+			Vector3 pos1 = polygon.GetVertexPosition(polygon.GetFaceVertexIndex(faceIndex, faceVertexIndex));
+			Vector3 pos2 = polygon.GetVertexPosition(polygon.GetFaceVertexIndex(faceIndex, nextVertexIndex));
 
 			vertices.push_back(Vertex3D_PCU(pos1, color, Vector2::ZERO));
 			vertices.push_back(Vertex3D_PCU(pos2, color, Vector2::ZERO));
@@ -8,6 +8,8 @@
 ///--------------------------------------------------------------------------------------------------------------------------------------------------
 /// INCLUDES
 ///--------------------------------------------------------------------------------------------------------------------------------------------------
+#include "Engine/Core/EngineCommon.h"
+#include <string.h>
 
 ///--------------------------------------------------------------------------------------------------------------------------------------------------
 /// DEFINES
@@ -37,3 +39,67 @@ void Swap(T& first, T& second)
 	first = second;
 	second = temp;
 }
+
+
+//-------------------------------------------------------------------------------------------------
+// Raw bytes, so only for plain data, and only readable by the same build
+template <typename T>
+void AppendBytes(std::vector<uint8>& out_bytes, const T& value)
+{
+	const uint8* valueBytes = reinterpret_cast<const uint8*>(&value);
+	out_bytes.insert(out_bytes.end(), valueBytes, valueBytes + sizeof(T));
+}
+
+
+//-------------------------------------------------------------------------------------------------
+// Count first, then the elements
+template <typename T>
+void AppendVectorBytes(std::vector<uint8>& out_bytes, const std::vector<T>& values)
+{
+	AppendBytes(out_bytes, (int)values.size());
+
+	if (values.size() > 0)
+	{
+		const uint8* valueBytes = reinterpret_cast<const uint8*>(values.data());
+		out_bytes.insert(out_bytes.end(), valueBytes, valueBytes + values.size() * sizeof(T));
+	}
+}
+
+
+//-------------------------------------------------------------------------------------------------
+// Returns false without advancing if there aren't enough bytes left
+template <typename T>
+bool ReadBytes(const uint8* bytes, size_t numBytes, size_t& inout_offset, T& out_value)
+{
+	if (inout_offset + sizeof(T) > numBytes)
+		return false;
+
+	memcpy(&out_value, bytes + inout_offset, sizeof(T));
+	inout_offset += sizeof(T);
+	return true;
+}
+
+
+//-------------------------------------------------------------------------------------------------
+// Reuses the vector's memory
+template <typename T>
+bool ReadVectorBytes(const uint8* bytes, size_t numBytes, size_t& inout_offset, std::vector<T>& out_values)
+{
+	int numValues = 0;
+	if (!ReadBytes(bytes, numBytes, inout_offset, numValues) || numValues < 0)
+		return false;
+
+	size_t valuesSize = (size_t)numValues * sizeof(T);
+	if (inout_offset + valuesSize > numBytes)
+		return false;
+
+	out_values.resize(numValues);
+
+	if (numValues > 0)
+	{
+		memcpy(out_values.data(), bytes + inout_offset, valuesSize);
+	}
+
+	inout_offset += valuesSize;
+	return true;
+}
@@ -69,8 +69,10 @@ public:
 
 	bool	IsValid() const { return m_pointer != nullptr; }
 
-	T&		operator*()		{ return *m_pointer; }
-	T*		operator->()	{ return m_pointer; }
+	T&			operator*()				{ return *m_pointer; }
+	T*			operator->()			{ return m_pointer; }
+	const T&	operator*() const		{ return *m_pointer; }
+	const T*	operator->() const		{ return m_pointer; }
 
 	void	operator=(const SmartPointer<T>& copy);
 	void	operator=(T* pointer);
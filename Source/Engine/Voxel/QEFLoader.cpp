@@ -7,6 +7,7 @@
 ///--------------------------------------------------------------------------------------------------------------------------------------------------
 /// INCLUDES
 ///--------------------------------------------------------------------------------------------------------------------------------------------------
+#include "Engine/Collision/Collider.h"
 #include "Engine/Core/EngineCommon.h"
 #include "Engine/Core/Rgba.h"
 #include "Engine/IO/File.h"
@@ -357,6 +358,9 @@ Mesh* QEFLoader::CreateMesh()
 {
 	ASSERT_RETURN(m_file != nullptr, nullptr, "QEFLoader can't make a mesh without loading a file first!");
 
+	// In case the collider was made from this file first
+	m_file->ResetMemoryReadHead();
+
 	std::string currLine;
 
 	// Qubicle Exchange Format
@@ -512,6 +516,61 @@ Mesh* QEFLoader::CreateMesh()
 }
 
 
+//-------------------------------------------------------------------------------------------------
+VoxelGridCollider* QEFLoader::CreateCollider(Entity* owningEntity)
+{
+	ASSERT_RETURN(m_file != nullptr, nullptr, "QEFLoader can't make a collider without loading a file first!");
+
+	// In case the mesh was made from this file first
+	m_file->ResetMemoryReadHead();
+
+	std::string currLine;
+
+	// Header, version, and website lines
+	m_file->GetNextLine(currLine);
+	ASSERT_RECOVERABLE(currLine == "Qubicle Exchange Format", "Bad QEF header?");
+	m_file->GetNextLine(currLine);
+	m_file->GetNextLine(currLine);
+
+	std::string dimensionsText;
+	m_file->GetNextLine(dimensionsText);
+	IntVector3 dimensions = ParseAsIntVector3(dimensionsText.c_str(), IntVector3::ZERO);
+
+	// Colors don't matter for collision, just skip them
+	std::string colorCountText;
+	m_file->GetNextLine(colorCountText);
+	int numColors = ParseAsInt(colorCountText.c_str(), 0);
+
+	for (int i = 0; i < numColors; ++i)
+	{
+		m_file->GetNextLine(currLine);
+	}
+
+	VoxelGridCollider* collider = new VoxelGridCollider(owningEntity, dimensions, VOXEL_SIZE);
+
+	m_file->GetNextLine(currLine);
+	while (!m_file->IsAtEndOfFile())
+	{
+		std::vector<std::string> voxelTokens;
+		Tokenize(currLine, ' ', voxelTokens);
+
+		// Should always have x, y, z, color index, visibility mask
+		ASSERT_OR_DIE(voxelTokens.size() == 5, "Invalid voxel line!");
+
+		IntVector3 position;
+		position.x = ParseAsInt(voxelTokens[0].c_str(), 0);
+		position.y = ParseAsInt(voxelTokens[1].c_str(), 0);
+		position.z = ParseAsInt(voxelTokens[2].c_str(), 0);
+
+		collider->SetCellOccupied(position, true);
+
+		m_file->GetNextLine(currLine);
+	}
+
+	return collider;
+}
+
+
 //-------------------------------------------------------------------------------------------------
 void QEFLoader::Clear()
 {
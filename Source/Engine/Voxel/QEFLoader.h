@@ -19,6 +19,8 @@
 ///--------------------------------------------------------------------------------------------------------------------------------------------------
 class Mesh;
 class File;
+class Entity;
+class VoxelGridCollider;
 
 ///--------------------------------------------------------------------------------------------------------------------------------------------------
 /// GLOBALS AND STATICS
@@ -34,11 +36,12 @@ class QEFLoader
 public:
 	//-----Public Methods-----
 
-	bool	LoadFile(const char* filepath);
-	Mesh*	CreateMesh();
-	void	Clear();
+	bool				LoadFile(const char* filepath);
+	Mesh*				CreateMesh();
+	VoxelGridCollider*	CreateCollider(Entity* owningEntity); // Collides against the voxels directly, no need to make boxes or hulls for them
+	void				Clear();
 
-	bool	HasFileLoaded() const { return m_file != nullptr; }
+	bool				HasFileLoaded() const { return m_file != nullptr; }
 
 
 private:
@@ -0,0 +1,87 @@
+///--------------------------------------------------------------------------------------------------------------------------------------------------
+/// Author: Andrew Chase
+/// Date Created: October 18th, 2026
+/// Description: Windowless runner for the physics scene benchmarks, so CI can track step times without a game
+///--------------------------------------------------------------------------------------------------------------------------------------------------
+
+///--------------------------------------------------------------------------------------------------------------------------------------------------
+/// INCLUDES
+///--------------------------------------------------------------------------------------------------------------------------------------------------
+#include "Engine/Core/EngineCommon.h"
+#include "Engine/IO/File.h"
+#include "Engine/Job/JobSystem.h"
+#include "Engine/Math/MathUtils.h"
+#include "Engine/Physics/Rigidbody/PhysicsSceneBenchmark.h"
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+
+///--------------------------------------------------------------------------------------------------------------------------------------------------
+/// DEFINES
+///--------------------------------------------------------------------------------------------------------------------------------------------------
+
+///--------------------------------------------------------------------------------------------------------------------------------------------------
+/// ENUMS, TYPEDEFS, STRUCTS, FORWARD DECLARATIONS
+///--------------------------------------------------------------------------------------------------------------------------------------------------
+
+///--------------------------------------------------------------------------------------------------------------------------------------------------
+/// GLOBALS AND STATICS
+///--------------------------------------------------------------------------------------------------------------------------------------------------
+static const int DEFAULT_NUM_STEPS = 120;
+
+///--------------------------------------------------------------------------------------------------------------------------------------------------
+/// C FUNCTIONS
+///--------------------------------------------------------------------------------------------------------------------------------------------------
+
+//-------------------------------------------------------------------------------------------------
+// Worker per spare core, like a game would have, so the job system paths in the step get measured too
+static void StartupJobSystem()
+{
+	JobSystem::Initialize();
+
+	int numCores = (int)std::thread::hardware_concurrency();
+	for (int workerIndex = 2; workerIndex < numCores; ++workerIndex)
+	{
+		g_jobSystem->CreateWorkerThread(Stringf("WORKER_%i", workerIndex).c_str(), WORKER_FLAGS_ALL_BUT_DISK);
+	}
+}
+
+
+//-------------------------------------------------------------------------------------------------
+// Usage: PhysicsBench [steps] [csvPath]
+// Without a path the CSV goes to stdout. Exits non zero if a scene hit the pair or contact limit, or the file couldn't be written
+int main(int argc, char** argv)
+{
+	int numSteps = (argc > 1 ? Max(atoi(argv[1]), 1) : DEFAULT_NUM_STEPS);
+	const char* csvPath = (argc > 2 ? argv[2] : nullptr);
+
+	StartupJobSystem();
+
+	std::string csv;
+	bool allFit = RunPhysicsSceneBenchmarks(numSteps, csv);
+
+	JobSystem::Shutdown();
+
+	int exitCode = EXIT_SUCCESS;
+
+	if (!allFit)
+	{
+		fprintf(stderr, "A scenario ran into the pair or contact limit, its numbers are missing dropped work!\n");
+		exitCode = EXIT_FAILURE;
+	}
+
+	if (csvPath != nullptr)
+	{
+		if (!FileWriteFromBuffer(csvPath, csv.c_str(), (int)csv.size()))
+		{
+			fprintf(stderr, "Couldn't write results to %s\n", csvPath);
+			exitCode = EXIT_FAILURE;
+		}
+	}
+	else
+	{
+		fputs(csv.c_str(), stdout);
+	}
+
+	return exitCode;
+}